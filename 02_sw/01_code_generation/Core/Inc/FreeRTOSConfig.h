@@ -59,7 +59,9 @@
 #define configSUPPORT_STATIC_ALLOCATION          1
 #define configSUPPORT_DYNAMIC_ALLOCATION         1
 #define configUSE_IDLE_HOOK                      0
+#define configUSE_TICKLESS_IDLE                  1
 #define configUSE_TICK_HOOK                      0
+#define configCHECK_FOR_STACK_OVERFLOW           2
 #define configCPU_CLOCK_HZ                       ( SystemCoreClock )
 #define configTICK_RATE_HZ                       ((TickType_t)1000)
 #define configMAX_PRIORITIES                     ( 7 )
@@ -70,6 +72,11 @@
 #define configUSE_MUTEXES                        1
 #define configQUEUE_REGISTRY_SIZE                8
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION  1
+/* Software timer definitions. */
+#define configUSE_TIMERS                         1
+#define configTIMER_TASK_PRIORITY                ( 6 )
+#define configTIMER_QUEUE_LENGTH                 4
+#define configTIMER_TASK_STACK_DEPTH             288
 /* USER CODE BEGIN MESSAGE_BUFFER_LENGTH_TYPE */
 /* Defaults to size_t for backward compatibility, but can be changed
    if lengths will always be less than the number of bytes in a size_t. */
@@ -134,6 +141,26 @@ standard names. */
 
 /* USER CODE BEGIN Defines */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
+/* I2C transfers notify the task that started them */
+#define INCLUDE_xTaskGetCurrentTaskHandle    1
+/* Run time statistics and stack high-water marks are collected by MONITOR, TIM5 of TIMEB is the clock because the DWT cycle counter stops in WFI */
+#define configGENERATE_RUN_TIME_STATS        1
+#define configUSE_TRACE_FACILITY             1
+#define INCLUDE_uxTaskGetStackHighWaterMark  1
+#define INCLUDE_xTaskGetIdleTaskHandle       1
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+void MONITOR_v_Init(void);
+uint32_t MONITOR_u_RunTimeCounter(void);
+#endif
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() MONITOR_v_Init()
+#define portGET_RUN_TIME_COUNTER_VALUE()         MONITOR_u_RunTimeCounter()
+/* Tickless idle suspends the HAL tick and measures the time spent in WFI */
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+void PreSleepProcessing(uint32_t *ulExpectedIdleTime);
+void PostSleepProcessing(uint32_t *ulExpectedIdleTime);
+#endif
+#define configPRE_SLEEP_PROCESSING(x)            PreSleepProcessing(&(x))
+#define configPOST_SLEEP_PROCESSING(x)           PostSleepProcessing(&(x))
 /* USER CODE END Defines */
 
 #endif /* FREERTOS_CONFIG_H */
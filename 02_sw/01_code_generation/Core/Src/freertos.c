@@ -31,6 +31,8 @@
 #include "I2C.h"
 #include "MCP23017.h"
 #include "MONITOR.h"
+#include "FIXLOG.h"
+#include "UBX.h"
 #include "SIM.h"
 #include "WDTIM.h"
 #include "tim.h"
@@ -42,7 +44,19 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-
+/* Stack depths in words. Worst case is the deepest call chain of the task from -fstack-usage and
+ * -fcallgraph-info at -O0, plus 51 words for the exception frame and the FreeRTOS context with FPU registers.
+ * Depth keeps at least a third free, uxTaskGetStackHighWaterMark in the MONITOR dump shows the margin left on the
+ * target and configCHECK_FOR_STACK_OVERFLOW traps an overrun.
+ *
+ *   Task          Deepest chain                                            Worst  Depth  Margin
+ *   TSK_Led       MONITOR_v_Service > MONITOR_v_Dump > vTaskGetInfo          167    256     89
+ *   TSK_Com       MSGM_v_StateMachine > NMEA_v_ExtractGLL > FIXLOG_v_Record  187    288    101
+ *   TSK_SIM       SIM_v_AtProcess > v_HandleLine > v_AtFinish > v_TxSend     207    320    113
+ *   TSK_MCP23017  MCP23017_v_TurnLEDviaCoordinates > I2C_e_Transfer          179    288    109
+ *   TSK_Log       FIXLOG_v_Service > FLASHM_e_EraseSector                    151    224     73
+ *   Tmr Svc       prvProcessTimerOrBlockTask, v_DebounceExpired callback     191    288     97
+ */
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -52,13 +66,12 @@
 
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN Variables */
-SemaphoreHandle_t xSemaphore;
 /* USER CODE END Variables */
-osThreadId TSK_IdleHandle;
 osThreadId TSK_LedHandle;
 osThreadId TSK_ComHandle;
 osThreadId TSK_SIMHandle;
 osThreadId TSK_MCP23017Handle;
+osThreadId TSK_LogHandle;
 osSemaphoreId BinSemHandle;
 
 /* Private function prototypes -----------------------------------------------*/
@@ -66,14 +79,30 @@ osSemaphoreId BinSemHandle;
 //osSemaphoreId * FREERTOS_p_GetSemaphore(void);
 /* USER CODE END FunctionPrototypes */
 
-void TSK_IdleFun(void const * argument);
 void TSK_LedFun(void const * argument);
 void TSK_ComFun(void const * argument);
 void TSK_SIMFun(void const * argument);
 void TSK_MCP23017Fun(void const * argument);
+void TSK_LogFun(void const * argument);
 
 void MX_FREERTOS_Init(void); /* (MISRA C 2004 rule 8.1) */
 
+/* Hook prototypes */
+void vApplicationStackOverflowHook(xTaskHandle xTask, signed char *pcTaskName);
+
+/* USER CODE BEGIN 4 */
+/* Name of the task whose stack overflowed, kept for the debugger */
+static signed char * volatile FREERTOS_p_OverflowTask = NULL;
+
+void vApplicationStackOverflowHook(xTaskHandle xTask, signed char *pcTaskName)
+{
+  /* Stack of pcTaskName passed its end, memory behind it can not be trusted. The watchdog is no longer
+     reloaded and resets the unit */
+  FREERTOS_p_OverflowTask = pcTaskName;
+  Error_Handler();
+}
+/* USER CODE END 4 */
+
 /* GetIdleTaskMemory prototype (linked to static allocation support) */
 void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, uint32_t *pulIdleTaskStackSize );
 
@@ -90,6 +119,39 @@ void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer, StackTy
 }
 /* USER CODE END GET_IDLE_TASK_MEMORY */
 
+/* GetTimerTaskMemory prototype (linked to static allocation support) */
+void vApplicationGetTimerTaskMemory( StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer, uint32_t *pulTimerTaskStackSize );
+
+/* USER CODE BEGIN GET_TIMER_TASK_MEMORY */
+static StaticTask_t xTimerTaskTCBBuffer;
+static StackType_t xTimerStack[configTIMER_TASK_STACK_DEPTH];
+
+void vApplicationGetTimerTaskMemory( StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer, uint32_t *pulTimerTaskStackSize )
+{
+  *ppxTimerTaskTCBBuffer = &xTimerTaskTCBBuffer;
+  *ppxTimerTaskStackBuffer = &xTimerStack[0];
+  *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+  /* place for user code */
+}
+/* USER CODE END GET_TIMER_TASK_MEMORY */
+
+/* USER CODE BEGIN PREPOSTSLEEP */
+void PreSleepProcessing(uint32_t *ulExpectedIdleTime)
+{
+  /* The HAL tick on TIM1 would wake the core every millisecond, timeouts use TIMEB which keeps running */
+  HAL_SuspendTick();
+  /* Sleep mode, not STOP: USART, DMA and EXTI keep running and any of their interrupts ends the WFI */
+  SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+  MONITOR_v_SleepEnter();
+}
+
+void PostSleepProcessing(uint32_t *ulExpectedIdleTime)
+{
+  MONITOR_v_SleepExit();
+  HAL_ResumeTick();
+}
+/* USER CODE END PREPOSTSLEEP */
+
 /**
   * @brief  FreeRTOS initialization
   * @param  None
@@ -111,10 +173,6 @@ void MX_FREERTOS_Init(void) {
 
   /* USER CODE BEGIN RTOS_SEMAPHORES */
   /* add semaphores, ... */
-  xSemaphore = xSemaphoreCreateBinary();
-  // The semaphore is created in the 'empty' state, meaning the semaphore must first be given
-  xSemaphoreGive(xSemaphore);
-  xSemaphoreTake(xSemaphore, osWaitForever);
   /* USER CODE END RTOS_SEMAPHORES */
 
   /* USER CODE BEGIN RTOS_TIMERS */
@@ -126,50 +184,41 @@ void MX_FREERTOS_Init(void) {
   /* USER CODE END RTOS_QUEUES */
 
   /* Create the thread(s) */
-  /* definition and creation of TSK_Idle */
-  osThreadDef(TSK_Idle, TSK_IdleFun, osPriorityIdle, 0, 128);
-  TSK_IdleHandle = osThreadCreate(osThread(TSK_Idle), NULL);
-
   /* definition and creation of TSK_Led */
-  osThreadDef(TSK_Led, TSK_LedFun, osPriorityBelowNormal, 0, 128);
+  osThreadDef(TSK_Led, TSK_LedFun, osPriorityBelowNormal, 0, 256);
   TSK_LedHandle = osThreadCreate(osThread(TSK_Led), NULL);
 
   /* definition and creation of TSK_Com */
-  osThreadDef(TSK_Com, TSK_ComFun, osPriorityNormal, 0, 128);
+  osThreadDef(TSK_Com, TSK_ComFun, osPriorityNormal, 0, 288);
   TSK_ComHandle = osThreadCreate(osThread(TSK_Com), NULL);
 
   /* definition and creation of TSK_SIM */
-  osThreadDef(TSK_SIM, TSK_SIMFun, osPriorityRealtime, 0, 128);
+  osThreadDef(TSK_SIM, TSK_SIMFun, osPriorityRealtime, 0, 320);
   TSK_SIMHandle = osThreadCreate(osThread(TSK_SIM), NULL);
 
   /* definition and creation of TSK_MCP23017 */
-  osThreadDef(TSK_MCP23017, TSK_MCP23017Fun, osPriorityRealtime, 0, 128);
+  osThreadDef(TSK_MCP23017, TSK_MCP23017Fun, osPriorityRealtime, 0, 288);
   TSK_MCP23017Handle = osThreadCreate(osThread(TSK_MCP23017), NULL);
 
+  /* definition and creation of TSK_Log */
+  osThreadDef(TSK_Log, TSK_LogFun, osPriorityLow, 0, 224);
+  TSK_LogHandle = osThreadCreate(osThread(TSK_Log), NULL);
+
   /* USER CODE BEGIN RTOS_THREADS */
   /* add threads, ... */
+  // TSK_Com is woken by the GPS receive interrupt when a sentence is complete
+  MSGM_v_SetConsumer(RING_BUFFER1, TSK_ComHandle);
+  // TSK_Log is woken by TSK_Com when a fix waits to be logged
+  FIXLOG_v_SetWriter(TSK_LogHandle);
+  MONITOR_v_RegisterTask(MONITOR_TASK_LED, TSK_LedHandle);
+  MONITOR_v_RegisterTask(MONITOR_TASK_COM, TSK_ComHandle);
+  MONITOR_v_RegisterTask(MONITOR_TASK_SIM, TSK_SIMHandle);
+  MONITOR_v_RegisterTask(MONITOR_TASK_MCP23017, TSK_MCP23017Handle);
+  MONITOR_v_RegisterTask(MONITOR_TASK_LOG, TSK_LogHandle);
   /* USER CODE END RTOS_THREADS */
 
 }
 
-/* USER CODE BEGIN Header_TSK_IdleFun */
-/**
-  * @brief  Function implementing the TSK_Idle thread.
-  * @param  argument: Not used
-  * @retval None
-  */
-/* USER CODE END Header_TSK_IdleFun */
-void TSK_IdleFun(void const * argument)
-{
-  /* USER CODE BEGIN TSK_IdleFun */
-  /* Infinite loop */
-  for(;;)
-  {
-//  osDelay(1);
-  }
-  /* USER CODE END TSK_IdleFun */
-}
-
 /* USER CODE BEGIN Header_TSK_LedFun */
 /**
 * @brief Function implementing the TSK_Led thread.
@@ -185,7 +234,11 @@ void TSK_LedFun(void const * argument)
   for(;;)
   {
 	Task_LED_CP_Start();
+	MONITOR_v_TaskStart(MONITOR_TASK_LED);
 	LEDM_v_Main();
+	// Statistics leave on SWO when the debugger requests them or the dump period passes
+	MONITOR_v_Service();
+	MONITOR_v_TaskEnd(MONITOR_TASK_LED, xLastWakeTime, (const TickType_t)PERIOD_TSK_LED);
 	vTaskDelayUntil(&xLastWakeTime, (const TickType_t)PERIOD_TSK_LED);
 	Task_LED_CP_End();
   }
@@ -202,14 +255,17 @@ void TSK_LedFun(void const * argument)
 void TSK_ComFun(void const * argument)
 {
   /* USER CODE BEGIN TSK_ComFun */
-	TickType_t xLastWakeTime = xTaskGetTickCount();
+  // GPS module is switched to UBX binary output, NMEA stays in use if it never answers in UBX
+  UBX_v_Start();
   /* Infinite loop */
   for(;;)
   {
-	// If xTicksToWait is zero, then xSemaphoreTake() will return immediately if the semaphore is not available.
-	xSemaphoreTake(xSemaphore, osWaitForever);
+	// Block until the receive interrupt reports a complete sentence, PERIOD_TSK_COM is only a fallback
+	ulTaskNotifyTake(pdTRUE, (const TickType_t)PERIOD_TSK_COM);
+	MONITOR_v_TaskStart(MONITOR_TASK_COM);
+	// Drain the whole ring buffer, SIM works on its own copy of the position so parsing never waits for it
 	MSGM_v_StateMachine();
-	vTaskDelayUntil(&xLastWakeTime, (const TickType_t)PERIOD_TSK_COM);
+	MONITOR_v_TaskEnd(MONITOR_TASK_COM, 0u, 0u);
   }
   /* USER CODE END TSK_ComFun */
 }
@@ -225,22 +281,25 @@ void TSK_SIMFun(void const * argument)
 {
   /* USER CODE BEGIN TSK_SIMFun */
 	TickType_t xLastWakeTime = xTaskGetTickCount();
+	t_MCP23017_ButtonEvent t_Event;
   /* Infinite loop */
   for(;;)
   {
-	// Task should enter critical section in order to call the number and receive coordinates without rewriting them
-	taskENTER_CRITICAL();
-	// Set flag indicates that the SIM module is in any function other than idle
-	boolean b_SemFlag = SIM_b_GetFlag();
-	do
+	MONITOR_v_TaskStart(MONITOR_TASK_SIM);
+	// Pressing the call button starts a call
+	while(MCP23017_b_GetButtonEvent(&t_Event, 0u) == b_TRUE)
 	{
-	  SIM_v_StateMachine();
-	  b_SemFlag = SIM_b_GetFlag();
+	  // Call is started only when no call or message is in progress
+	  if((t_Event.e_Action == MCP23017_BUTTON_PRESS) && ((t_Event.u_Pins & MCP23017_BUTTON_PIN) != 0u) &&
+	     (SIM_b_SwitchFunction(IdleFunction, MakeCall) == b_FALSE))
+	  {
+	    (void)SIM_b_SwitchFunction(ReadMessage, MakeCall);
+	  }
 	}
-	while(b_SemFlag == b_TRUE);
-	xSemaphoreGive(xSemaphore);
-	// SIM task should exit critical section when SIM state machine reaches Read function because the next function is idle
-	taskEXIT_CRITICAL();
+	// State changes only queue AT commands and the engine never waits, so the task can be preempted at any point
+	SIM_v_StateMachine();
+	SIM_v_AtProcess();
+	MONITOR_v_TaskEnd(MONITOR_TASK_SIM, xLastWakeTime, (const TickType_t)PERIOD_TSK_SIM);
 	vTaskDelayUntil(&xLastWakeTime, (const TickType_t)PERIOD_TSK_SIM);
   }
   /* USER CODE END TSK_SIMFun */
@@ -256,16 +315,40 @@ void TSK_SIMFun(void const * argument)
 void TSK_MCP23017Fun(void const * argument)
 {
   /* USER CODE BEGIN TSK_MCP23017Fun */
-	TickType_t xLastWakeTime = xTaskGetTickCount();
   /* Infinite loop */
   for(;;)
   {
+	// Sleep until INTA or the debounce timer wakes the task, PERIOD_TSK_COM bounds the LED refresh
+	MCP23017_v_ProcessButton((const TickType_t)PERIOD_TSK_COM);
+	MONITOR_v_TaskStart(MONITOR_TASK_MCP23017);
 	MCP23017_v_TurnLEDviaCoordinates();
-	vTaskDelayUntil(&xLastWakeTime, (const TickType_t)PERIOD_TSK_COM);
+	MONITOR_v_TaskEnd(MONITOR_TASK_MCP23017, 0u, 0u);
   }
   /* USER CODE END TSK_MCP23017Fun */
 }
 
+/* USER CODE BEGIN Header_TSK_LogFun */
+/**
+* @brief Function implementing the TSK_Log thread.
+* @param argument: Not used
+* @retval None
+*/
+/* USER CODE END Header_TSK_LogFun */
+void TSK_LogFun(void const * argument)
+{
+  /* USER CODE BEGIN TSK_LogFun */
+  /* Infinite loop */
+  for(;;)
+  {
+	// Sleep until TSK_Com hands a fix over, a sector erase blocks only this task
+	ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+	MONITOR_v_TaskStart(MONITOR_TASK_LOG);
+	FIXLOG_v_Service();
+	MONITOR_v_TaskEnd(MONITOR_TASK_LOG, 0u, 0u);
+  }
+  /* USER CODE END TSK_LogFun */
+}
+
 /* Private application code --------------------------------------------------*/
 /* USER CODE BEGIN Application */
 /* USER CODE END Application */
@@ -29,7 +29,11 @@
 #include "UARTM.h"
 #include "MSGM.h"
 #include "SIM.h"
+#include "TIMEB.h"
 #include "WDTIM.h"
+#include "FLASHM.h"
+#include "CALLR.h"
+#include "FIXLOG.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -99,9 +103,15 @@ int main(void)
   /* USER CODE BEGIN 2 */
   // Start timer
   HAL_TIM_Base_Start_IT(&htim2);
-  HAL_TIM_Base_Start(&htim10);
+  // Microsecond timebase used by all peripheral timeouts
+  TIMEB_v_Init();
 
   MCP23017_v_Init();
+  // Authorised callers are loaded from flash before the SIM module can report a call
+  FLASHM_v_Init();
+  CALLR_v_Init();
+  // Last logged fix is the position until the GPS reports a new one
+  FIXLOG_v_Init();
   SIM_v_Setup();
 
   /* USER CODE END 2 */
@@ -3,407 +3,699 @@
 /// @author Aleksandra Petrovic
 
 #include "CALCM.h"
-#include "SIM.h"
+#include "TRACK.h"
+#include <stdlib.h>
 
-// Used as buffer where calculated coordinates will be written into
-static volatile t_CALCM_Cooridnates t_Cooridnates = {0u};
+// Result of the last target parsing, the target itself is kept in MSGM
+static volatile e_CALCM_ParseStatus CALCM_e_Status = CALCM_PARSE_OK;
 
-/// @brief Function used to convert longitude and latitude from characters to numbers
+e_CALCM_ParseStatus CALCM_e_ParseCoordinate(const uint8_t *p_Text, uint8_t *p_Index, uint8_t u_MaxIndex, uint32_t u_Limit, int32_t *p_MicroDegrees)
+{
+  uint8_t  u_Index          = *p_Index;
+  // Digits before the dot in ddmm or dddmm format
+  uint32_t u_Integer        = 0u;
+  uint8_t  u_IntegerDigits  = 0u;
+  // Fraction of minutes in micro-minutes
+  uint32_t u_Fraction       = 0u;
+  uint8_t  u_FractionDigits = 0u;
+  uint8_t  u_Dot            = 0u;
+
+  while((u_Index < u_MaxIndex) && (p_Text[u_Index] != ',') && (p_Text[u_Index] != '\0'))
+  {
+    // Characters below '0' wrap around, so one comparison checks the whole digit range
+    uint32_t u_Digit = (uint32_t)p_Text[u_Index] - (uint32_t)'0';
+    if(u_Digit <= 9u)
+    {
+      if(u_Dot == 0u)
+      {
+        u_Integer = u_Integer * 10u + u_Digit;
+        u_IntegerDigits++;
+        if(u_IntegerDigits > CALCM_MAX_INTEGER_DIGITS)
+        {
+          *p_Index = u_Index;
+          return CALCM_PARSE_INVALID_FORMAT;
+        }
+      }
+      else if(u_FractionDigits < CALCM_MINUTE_FRACTION_DIGITS)
+      {
+        // Digits beyond micro-minutes are below the resolution and are ignored
+        u_Fraction = u_Fraction * 10u + u_Digit;
+        u_FractionDigits++;
+      }
+    }
+    else if((p_Text[u_Index] == '.') && (u_Dot == 0u))
+    {
+      u_Dot = 1u;
+    }
+    else
+    {
+      *p_Index = u_Index;
+      return CALCM_PARSE_INVALID_CHARACTER;
+    }
+    u_Index++;
+  }
+  *p_Index = u_Index;
+
+  if((u_IntegerDigits == 0u) && (u_Dot == 0u))
+  {
+    return CALCM_PARSE_EMPTY;
+  }
+  // At least one digit of degrees and two digits of minutes are needed
+  if((u_Dot == 0u) || (u_IntegerDigits < 3u))
+  {
+    return CALCM_PARSE_INVALID_FORMAT;
+  }
+  // Missing fraction digits are padded so the fraction is always in micro-minutes
+  while(u_FractionDigits < CALCM_MINUTE_FRACTION_DIGITS)
+  {
+    u_Fraction *= 10u;
+    u_FractionDigits++;
+  }
+
+  uint32_t u_Degrees = u_Integer / DERIVATION_CONST;
+  uint32_t u_Minutes = u_Integer - u_Degrees * DERIVATION_CONST;
+  if(u_Minutes >= CALCM_MINUTES_PER_DEGREE)
+  {
+    return CALCM_PARSE_OUT_OF_RANGE;
+  }
+
+  // Minutes and their fraction fit into 32 bits as micro-minutes, division rounds to the nearest micro-degree
+  uint32_t u_MicroMinutes = u_Minutes * CALCM_MICRODEGREES + u_Fraction;
+  uint32_t u_MicroDegrees = u_Degrees * CALCM_MICRODEGREES + (u_MicroMinutes + CALCM_MINUTES_PER_DEGREE / 2u) / CALCM_MINUTES_PER_DEGREE;
+  if(u_MicroDegrees > u_Limit * CALCM_MICRODEGREES)
+  {
+    return CALCM_PARSE_OUT_OF_RANGE;
+  }
+  *p_MicroDegrees = (int32_t)u_MicroDegrees;
+  return CALCM_PARSE_OK;
+}
+
+e_CALCM_ParseStatus CALCM_e_ParsePosition(const uint8_t *p_Text, uint8_t u_MaxIndex, int32_t *p_Latitude, int32_t *p_Longitude)
+{
+  uint8_t u_Cnt = 0;
+  int32_t i_Latitude = 0;
+  int32_t i_Longitude = 0;
+
+  // Latitude is followed by ',' and its direction
+  e_CALCM_ParseStatus e_Status = CALCM_e_ParseCoordinate(p_Text, &u_Cnt, u_MaxIndex, LATITUDE_HIGH_RANGE, &i_Latitude);
+  if(e_Status == CALCM_PARSE_OK)
+  {
+    // Skip ',' to get to the latitude direction
+    u_Cnt++;
+    // Check if latitude direction is North or South
+    if(u_Cnt >= u_MaxIndex)
+    {
+      e_Status = CALCM_PARSE_INVALID_FORMAT;
+    }
+    else if(p_Text[u_Cnt] == 'S')
+    {
+      // South side of latitude has negative value
+      i_Latitude = -i_Latitude;
+    }
+    else if(p_Text[u_Cnt] != 'N')
+    {
+      e_Status = CALCM_PARSE_INVALID_DIRECTION;
+    }
+  }
+
+  if(e_Status == CALCM_PARSE_OK)
+  {
+    // Skip direction and ',' to get to longitude part
+    u_Cnt += 2u;
+    e_Status = CALCM_e_ParseCoordinate(p_Text, &u_Cnt, u_MaxIndex, LONGITUDE_HIGH_RANGE, &i_Longitude);
+  }
+
+  if(e_Status == CALCM_PARSE_OK)
+  {
+    u_Cnt++;
+    // Check if longitude direction is East or West
+    if(u_Cnt >= u_MaxIndex)
+    {
+      e_Status = CALCM_PARSE_INVALID_FORMAT;
+    }
+    else if(p_Text[u_Cnt] == 'W')
+    {
+      // West side of longitude has negative value
+      i_Longitude = -i_Longitude;
+    }
+    else if(p_Text[u_Cnt] != 'E')
+    {
+      e_Status = CALCM_PARSE_INVALID_DIRECTION;
+    }
+  }
+
+  // Position is written only as a whole
+  if(e_Status == CALCM_PARSE_OK)
+  {
+    *p_Latitude = i_Latitude;
+    *p_Longitude = i_Longitude;
+  }
+  return e_Status;
+}
+
+/// @brief Function used to write an angle in the NMEA degrees and minutes form
+///
+/// @pre p_Text has room for u_DegreeDigits + 8 characters
+/// @post p_Text holds "ddmm.mmmmm" or "dddmm.mmmmm", not NULL terminated
+/// @param uint32_t u_Angle absolute value in micro-degrees, uint8_t u_DegreeDigits 2 or 3, uint8_t *p_Text
 ///
-/// @pre MSGM state machine reads and processes data read from GPS module
-/// @post Bearing calculation
-/// @param uint8_t *aTempBuffer, double f_LowLimit, double f_HighLimit
-/// @return double f_Num
+/// @return uint8_t number of written characters
 ///
 /// @globals None
 ///
-/// @InOutCorelation Function converts characters to double number values.
+/// @InOutCorelation Micro-degrees times 60 are micro-minutes, divided by 10 they are minutes with five decimals.
 /// @callsequence
-///   @startuml "v_ConvertToNumbers.png"
-///     title "Sequence diagram for function v_ConvertToNumbers"
-///     -> CALCM: v_ConvertToNumbers(uint8_t *u_TempBuffer, double f_LowLimit, double f_HighLimit)
+///   @startuml "u_FormatAngle.png"
+///     title "Sequence diagram for function u_FormatAngle"
+///     -> CALCM: u_FormatAngle(uint32_t u_Angle, uint8_t u_DegreeDigits, uint8_t *p_Text)
 ///     CALCM++
-///       loop Used to skip zero values.
-///         rnote over CALCM: Increment index until non zero value is reached.
-///       end
-///       loop Searches for dot character because of the message format.
-///         rnote over CALCM: Length counter increments for each passing trough the loop to determine the length of whole number.
-///       end
-///       loop Goes through the temporary buffer and checks if read elements are number characters using ASCII table.
-///         opt if elements are inside the range from '0' to '9'
-///           rnote over CALCM: Correct elements are converted into number values.
-///           loop Until u_Length reaches 1 decrease its value
-///           rnote over CALCM: Multiply each element with correct multiplication of 10 and add it to value that will be returned.
-///           end
-///         else else
-///           rnote over CALCM: Incorrect elements are deleted by writing 0 values to their places.
-///       end
-///       rnote over CALCM: Dot characters is written into temporary buffer and index is incremented to skip to fractioned part.
-///       loop Goes through the remaining elements to read fraction part of the coordinates.
-///         opt If read values are corresponding with ASCII values for digits, convert them to numbers.
-///           rnote over CALCM: Derive each element with correct multiplication of 10 and add it to value that will be returned.
-///         else else If incorrect data occurred, all written data gets deleted.
-///         end
-///       end
-///       opt if number is not inside the correct range
-///         loop Go through elements of temporary buffer
-///           rnote over CALCM: Write 0s into each buffer element.
-///          end
-///       end
-///     <- CALCM:// Returns a double value of coordinates.//
+///     <- CALCM: Returns length
 ///     CALCM--
 ///   @enduml
 
-static double v_ConvertToNumbers(uint8_t *u_TempBuffer, double f_LowLimit, double f_HighLimit);
+static uint8_t u_FormatAngle(uint32_t u_Angle, uint8_t u_DegreeDigits, uint8_t *p_Text);
 
-static double v_ConvertToNumbers(uint8_t *u_TempBuffer, double f_LowLimit, double f_HighLimit)
+static uint8_t u_FormatAngle(uint32_t u_Angle, uint8_t u_DegreeDigits, uint8_t *p_Text)
 {
-  double f_Num = 0;
-  // Used for going through u_TempBuffer array
-  uint8_t u_Index = 0u;
-  // Used to store whole number part
-  uint8_t u_Buffer[COORDINATES_LENGTH];
-  // Variable used to determine length of whole number part
-  uint8_t u_Length = 0u;
-  uint8_t u_TmpCntr = 0u;
-
-  // Until non zero value is reached or index reaches the last element, keep going through the array
-  while((u_TempBuffer[u_Index] == 0) && (u_Index != COORDINATES_LENGTH))
+  uint32_t u_Degrees = u_Angle / CALCM_MICRODEGREES;
+  uint32_t u_Minutes = (u_Angle % CALCM_MICRODEGREES) * 6u;        // Minutes in 1e-5, below 6000000
+  uint8_t  u_Length  = (uint8_t)(u_DegreeDigits + 3u + CALCM_FORMAT_FRACTION_DIGITS);
+
+  // Written from the last digit backwards, so each value is taken apart by repeated division
+  for(uint8_t u_Index = u_Length; u_Index > 0u; u_Index--)
   {
-    u_Index++;
+    if((u_Index - 1u) == (u_DegreeDigits + 2u))
+    {
+      p_Text[u_Index - 1u] = '.';
+    }
+    else if((u_Index - 1u) >= u_DegreeDigits)
+    {
+      p_Text[u_Index - 1u] = (uint8_t)('0' + (u_Minutes % 10u));
+      u_Minutes /= 10u;
+    }
+    else
+    {
+      p_Text[u_Index - 1u] = (uint8_t)('0' + (u_Degrees % 10u));
+      u_Degrees /= 10u;
+    }
+  }
+  return u_Length;
+}
+
+uint8_t CALCM_u_FormatPosition(int32_t i_Latitude, int32_t i_Longitude, uint8_t *p_Text)
+{
+  uint8_t u_Cnt = u_FormatAngle((i_Latitude < 0) ? (uint32_t)(-(int64_t)i_Latitude) : (uint32_t)i_Latitude, 2u, p_Text);
+
+  p_Text[u_Cnt++] = ',';
+  p_Text[u_Cnt++] = (i_Latitude < 0) ? 'S' : 'N';
+  p_Text[u_Cnt++] = ',';
+  u_Cnt = (uint8_t)(u_Cnt + u_FormatAngle((i_Longitude < 0) ? (uint32_t)(-(int64_t)i_Longitude) : (uint32_t)i_Longitude,
+                                          3u, &p_Text[u_Cnt]));
+  p_Text[u_Cnt++] = ',';
+  p_Text[u_Cnt++] = (i_Longitude < 0) ? 'W' : 'E';
+  p_Text[u_Cnt] = '\0';
+  return u_Cnt;
+}
+
+e_CALCM_ParseStatus CALCM_e_SetTarget(const uint8_t *p_Text, uint8_t u_MaxIndex)
+{
+  t_MSGM_Fix t_Target = {0};
+  t_TRACK_Header t_Header;
+  e_CALCM_ParseStatus e_Status;
+
+  // Newest fix of a packed track is the target, the older ones are only checked
+  if((u_MaxIndex != 0u) && (p_Text[0] == TRACK_MARKER))
+  {
+    e_Status = TRACK_e_Decode(p_Text, u_MaxIndex, &t_Target, 1u, &t_Header);
+  }
+  else
+  {
+    e_Status = CALCM_e_ParsePosition(p_Text, u_MaxIndex, &t_Target.i_Latitude, &t_Target.i_Longitude);
   }
-  // Index of first non zero character
-  uint8_t u_Start = u_Index;
-
-  // . character represents the end of whole digit part of the coordinate
-  while(u_TempBuffer[u_Index] != '.' && (u_Index != COORDINATES_LENGTH))
-  {
-	u_Buffer[u_TmpCntr] = u_TempBuffer[u_Index];
-	u_TmpCntr++;
-	u_Index++;
-	u_Length++;
-  }
-  // Write a . character into a buffer
-  u_Buffer[u_TmpCntr] = u_TempBuffer[u_Index];
-  // Increment u_TmpCntr so u_FractionStart gets its right value
-  u_TmpCntr++;
-  // Index of last whole number digit
-  uint8_t u_FractionStart = u_TmpCntr;
-  // Used to store length value so when it decreases it can be read again
-  uint8_t u_LenTmp = u_Length;
-  // Number of elements for fraction part of coordinates
-  uint8_t u_NumofRemainigElements = COORDINATES_LENGTH - u_Length - 1;
-  uint8_t u_Cnt = 0u;
-  // Start from first non zero character and go through all the elements before '.' character
-  while(u_Start < u_Index && u_Cnt < u_TmpCntr - 1)
-  {
-	double u_Tmp = (double)u_Buffer[u_Cnt];
-	// ASCII range for 0-9 digits
-	if(u_Tmp >= '0' && u_Tmp <= '9')
-	{
-      // ASCII value for 0, used to convert character to number
-	  u_Tmp -= '0';
-	  while(u_Length != 1)
-	  {
-	    // u_Length is used to realize 10^u_Length
-	    u_Tmp *= 10;
-		u_Length--;
-	  }
-	  // Derivation with 100 needs to be done because of the format of the number that is read from GPS module
-	  u_Tmp /= DERIVATION_CONST;
-	  // Add u_Tmp number to f_Num which will be returned
-	  f_Num += u_Tmp;
-	}
-	else
-	{
-      // In case of incorrect data format clear all the elements
-	  u_Length = 0u;
-	  for(uint8_t u_Count = 0; u_Count < u_FractionStart; u_Count++)
-	  {
-		u_Buffer[u_Count] = 0;
-	  }
-	}
-	u_Start++;
-	// u_LenTmp needs to be decremented so next passing through loop will provide lesser length for 10^u_Length
-	u_LenTmp--;
-	u_Length = u_LenTmp;
-	u_Cnt++;
-  }
-
-  u_Cnt = 0u;
-  // When array reaches '.' character, skip to fraction part
-  u_Index++;
-  // Values need to be derived by position compared to . character multiplied by derivation format constant
-  double u_Deriv = 10 * DERIVATION_CONST;
-  // Loop goes through remaining elements in longitude/latitude buffer
-  while((u_Cnt < u_NumofRemainigElements) && (u_TempBuffer[u_Index] != 0))
-  {
-	double u_Tmp = (double)u_TempBuffer[u_Index];
-	if(u_Tmp >= '0' && u_Tmp <= '9')
-	{
-	  u_Tmp -= '0';
-	  u_Tmp /= u_Deriv;
-	  // Add each digit of fractioned part to the number
-	  f_Num += u_Tmp;
-	}
-	// Multiply derivation variable so each next element gets derived 10 times more
-	u_Deriv *= 10;
-	u_Index++;
-	u_Cnt++;
-  }
-  // Check if calculated number is inside the range for longitude/latitude
-  if(!(f_Num >= f_LowLimit && f_Num <= f_HighLimit))
-  {
-	// Clear everything if non number values appear
-	f_Num = 0;
-	for(uint8_t u_Count = 0u; u_Count < u_Index; u_Count++)
-	{
-	  u_Buffer[u_Count] = 0u;
-	}
-  }
-  return f_Num;
+  // A broken message keeps the last valid target
+  if(e_Status == CALCM_PARSE_OK)
+  {
+    MSGM_v_PublishFix(MSGM_FIX_TARGET, &t_Target);
+  }
+  CALCM_e_Status = e_Status;
+  return e_Status;
+}
+
+e_CALCM_ParseStatus CALCM_e_GetParseStatus(void)
+{
+  return CALCM_e_Status;
 }
 
-/// @brief Function used for getting coordinates from a buffer
+/// Bearing formula arguments with the longitude distance folded into [-90, 90] degrees
+typedef struct {
+  int32_t i_CosStart;   ///< 90 degrees minus |starting latitude|, its sine is the cosine of the starting latitude
+  int32_t i_Latitudes;  ///< Starting minus car latitude (their sum when the distance was folded), moved into [-90, 90]
+  int32_t i_Distance;   ///< Folded longitude distance, its sine is the sine of the distance
+  int32_t i_Fold;       ///< 1 when the distance is within 90 degrees, -1 when it was folded around 180 degrees
+} t_CALCM_Fold;
+
+#if (CALCM_BEARING_KERNEL != CALCM_KERNEL_DOUBLE) || defined(HOST_BUILD)
+/// @brief Function used to prepare the arguments of the well conditioned bearing formula
 ///
-/// @pre Getter must have the coordinates ready
-/// @post Coordinates are converted to number values and properly stored into correct elements of the structure
-/// @param None
+/// @pre None
+/// @post None
+/// @param int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance angles in micro-degrees,
+///        t_CALCM_Fold *p_Fold folded arguments
 ///
-/// @return t_CALCM_Cooridnates * t_Cooridnates
+/// @return None
 ///
-/// @globals static volatile t_CALCM_Cooridnates t_Cooridnates
+/// @globals None
 ///
-/// @InOutCorelation Function reads coordinates from SIM800L getter and then converts them in correct format.
+/// @InOutCorelation y = cos(C) * sin(S) - sin(C) * cos(S) * cos(D) cancels to almost nothing for points close
+///                  together or nearly antipodal, where the bearing is most sensitive. Written as
+///                  y = sin(S - C) + 2 * sin(C) * cos(S) * sin^2(D / 2), or for |D| > 90 degrees with D' = 180 - |D| as
+///                  y = sin(S + C) - 2 * sin(C) * cos(S) * sin^2(D' / 2), every term is small there as well. The
+///                  differences are taken in integer micro-degrees, so they are exact, and every angle is brought
+///                  into [-90, 90] degrees, where the single precision sine keeps its relative accuracy.
 /// @callsequence
-///   @startuml "p_SetCoordinates.png"
-///     title "Sequence diagram for function p_SetCoordinates"
-///     -> CALCM: p_SetCoordinates()
+///   @startuml "v_Fold.png"
+///     title "Sequence diagram for function v_Fold"
+///     -> CALCM: v_Fold(int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance, t_CALCM_Fold *p_Fold)
 ///     CALCM++
-///       SIM -> CALCM: SIM_v_ReceiveCoordinates()
-///       loop Goes through read elements until latitude direction is reached.
-///         rnote over CALCM: Write elements in temporary buffer.
-///       end
-///       CALCM -> CALCM: v_ConvertToNumbers(u_TmpLat, LATITUDE_LOW_RANGE, LATITUDE_HIGH_RANGE)
-///       opt if latitude is North
-///         rnote over CALCM: Set latitude to North
-///       else else
-///         rnote over CALCM: Set latitude to South
+///       rnote over CALCM: Distance is wrapped into (-180, 180] degrees.
+///       opt if distance is greater than 90 degrees
+///         rnote over CALCM: Distance is folded around 180 degrees and latitudes are added.
 ///       end
-///       loop Goes through read elements until longitude direction is reached.
-///         rnote over CALCM: Write elements in temporary buffer.
-///       end
-///       CALCM -> CALCM: v_ConvertToNumbers(u_TmpLon, LONGITUDE_LOW_RANGE, LONGITUDE_HIGH_RANGE)
-///       opt if longitude is West
-///         rnote over CALCM: Set longitude to West
-///       else else
-///         rnote over CALCM: Set longitude to East
-///       end
-///     <- CALCM:// Returns t_CALCM_Cooridnates * value of a structure with coordinates converted into usable values.//
+///       rnote over CALCM: Angles whose sine is used are brought into [-90, 90] degrees.
+///     <- CALCM
 ///     CALCM--
 ///   @enduml
 
-static volatile t_CALCM_Cooridnates * p_SetCoordinates();
+static void v_Fold(int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance, t_CALCM_Fold *p_Fold);
 
-static volatile t_CALCM_Cooridnates * p_SetCoordinates()
+static void v_Fold(int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance, t_CALCM_Fold *p_Fold)
 {
-  uint8_t * u_Coordinates = SIM_p_ReceiveCoordinates();
-  uint8_t u_Cnt = 0;
-  uint8_t u_Count = 0;
-  uint8_t u_TmpLon[COORDINATES_LENGTH] = {0};
-  uint8_t u_TmpLat[COORDINATES_LENGTH] = {0};
+  int32_t i_AbsStart = (i_StartingLatitude < 0) ? -i_StartingLatitude : i_StartingLatitude;
 
-  // Go through elements that represent the latitude part of the coordinates
-  while(u_Coordinates[u_Cnt] != ',' && u_Cnt < COORDINATES_LENGTH)
+  if (i_Distance > CALCM_MICRODEGREES_PER_HALF_TURN)
   {
-	u_TmpLat[u_Cnt] = u_Coordinates[u_Cnt];
-	u_Cnt++;
+    i_Distance -= CALCM_MICRODEGREES_PER_TURN;
   }
-  u_Cnt++;
+  else if (i_Distance <= -CALCM_MICRODEGREES_PER_HALF_TURN)
+  {
+    i_Distance += CALCM_MICRODEGREES_PER_TURN;
+  }
+  // cos(S) = sin(90 - |S|), the argument stays within [0, 90] degrees
+  p_Fold -> i_CosStart = CALCM_MICRODEGREES_PER_QUARTER_TURN - i_AbsStart;
+  p_Fold -> i_Latitudes = i_StartingLatitude - i_CarLatitude;
+  p_Fold -> i_Distance = i_Distance;
+  p_Fold -> i_Fold = 1;
 
-  // Convert the latitude part into double numbers for further calculations
-  t_Cooridnates.d_Latitude = v_ConvertToNumbers(u_TmpLat, LATITUDE_LOW_RANGE, LATITUDE_HIGH_RANGE);
-  // Check if latitude direction is North or South
-  if(u_Coordinates[u_Cnt] == 'N')
+  // cos(D) = -cos(180 - |D|) and sin(D) keeps its sign with 180 - |D|
+  if (i_Distance > CALCM_MICRODEGREES_PER_QUARTER_TURN)
   {
-    t_Cooridnates.t_LatitudeDirection = CALCM_NORTH_SIDE;
+    p_Fold -> i_Latitudes = i_StartingLatitude + i_CarLatitude;
+    p_Fold -> i_Distance = CALCM_MICRODEGREES_PER_HALF_TURN - i_Distance;
+    p_Fold -> i_Fold = -1;
   }
-  else if(u_Coordinates[u_Cnt] == 'S')
+  else if (i_Distance < -CALCM_MICRODEGREES_PER_QUARTER_TURN)
   {
-  	t_Cooridnates.t_LatitudeDirection = CALCM_SOUTH_SIDE;
+    p_Fold -> i_Latitudes = i_StartingLatitude + i_CarLatitude;
+    p_Fold -> i_Distance = -CALCM_MICRODEGREES_PER_HALF_TURN - i_Distance;
+    p_Fold -> i_Fold = -1;
   }
 
-  // Increment u_Cnt to get to longitude part
-  u_Cnt+= 2;
+  // Only the sine of the latitudes is used, sin(180 - L) = sin(L) keeps it within [-90, 90] degrees as well
+  if (p_Fold -> i_Latitudes > CALCM_MICRODEGREES_PER_QUARTER_TURN)
+  {
+    p_Fold -> i_Latitudes = CALCM_MICRODEGREES_PER_HALF_TURN - p_Fold -> i_Latitudes;
+  }
+  else if (p_Fold -> i_Latitudes < -CALCM_MICRODEGREES_PER_QUARTER_TURN)
+  {
+    p_Fold -> i_Latitudes = -CALCM_MICRODEGREES_PER_HALF_TURN - p_Fold -> i_Latitudes;
+  }
+}
+#endif
+
+#if (CALCM_BEARING_KERNEL == CALCM_KERNEL_Q31) || defined(HOST_BUILD)
+/// @brief Function used to convert micro-degrees to Q31 half turns
+///
+/// @pre None
+/// @post None
+/// @param int32_t i_MicroDegrees
+///
+/// @return int32_t angle in Q31 half turns
+///
+/// @globals None
+///
+/// @InOutCorelation Function scales the angle in 64-bit integers, 180 degrees wraps to -180 degrees.
+/// @callsequence
+///   @startuml "i_MicroDegreesToQ31.png"
+///     title "Sequence diagram for function i_MicroDegreesToQ31"
+///     -> CALCM: i_MicroDegreesToQ31(int32_t i_MicroDegrees)
+///     CALCM++
+///     <- CALCM:// Returns int32_t angle in Q31 half turns.//
+///     CALCM--
+///   @enduml
+
+static int32_t i_MicroDegreesToQ31(int32_t i_MicroDegrees);
 
-  // Go through elements that represent the longitude part of the coordinates
-  while(u_Coordinates[u_Cnt] != ',' && u_Cnt < COORDINATES_LENGTH)
+static int32_t i_MicroDegreesToQ31(int32_t i_MicroDegrees)
+{
+  return (int32_t)(uint32_t)(((int64_t)i_MicroDegrees * CALCM_Q31_HALF_TURN) / CALCM_MICRODEGREES_PER_HALF_TURN);
+}
+
+/// @brief Function used to calculate sine of a Q31 angle
+///
+/// @pre None
+/// @post None
+/// @param int32_t i_Angle angle in Q31 half turns
+///
+/// @return int32_t sine in Q31
+///
+/// @globals None
+///
+/// @InOutCorelation Function folds the angle into [-90, 90] degrees and evaluates an odd polynomial of 9th order,
+///                  whose relative error is below 6e-9.
+/// @callsequence
+///   @startuml "i_SinQ31.png"
+///     title "Sequence diagram for function i_SinQ31"
+///     -> CALCM: i_SinQ31(int32_t i_Angle)
+///     CALCM++
+///       opt if angle is outside of [-90, 90] degrees
+///         rnote over CALCM: Mirror the angle around 90 or -90 degrees.
+///       end
+///       rnote over CALCM: Evaluate the polynomial with Horner's scheme in 64-bit integers.
+///     <- CALCM:// Returns int32_t sine in Q31.//
+///     CALCM--
+///   @enduml
+
+static int32_t i_SinQ31(int32_t i_Angle);
+
+static int32_t i_SinQ31(int32_t i_Angle)
+{
+  int64_t i_X = i_Angle;
+
+  // sin(180 - a) = sin(a), only [-90, 90] degrees is covered by the polynomial
+  if (i_X > CALCM_Q31_QUARTER_TURN)
+  {
+    i_X = CALCM_Q31_HALF_TURN - i_X;
+  }
+  else if (i_X < -CALCM_Q31_QUARTER_TURN)
   {
-  	u_TmpLon[u_Count] = u_Coordinates[u_Cnt];
-  	u_Cnt++;
-  	u_Count++;
+    i_X = -CALCM_Q31_HALF_TURN - i_X;
   }
 
-  u_Cnt++;
+  int64_t i_X2 = (i_X * i_X) >> 31;
+  int64_t i_P = CALCM_Q28_SIN_C9;
+  i_P = CALCM_Q28_SIN_C7 - ((i_X2 * i_P) >> 31);
+  i_P = CALCM_Q28_SIN_C5 - ((i_X2 * i_P) >> 31);
+  i_P = CALCM_Q28_SIN_C3 - ((i_X2 * i_P) >> 31);
+  i_P = CALCM_Q28_SIN_C1 - ((i_X2 * i_P) >> 31);
+  i_P = (i_X * i_P) >> 28;
 
-  // Convert longitude part into double numbers for further calculations
-  t_Cooridnates.d_Longitude = v_ConvertToNumbers(u_TmpLon, LONGITUDE_LOW_RANGE, LONGITUDE_HIGH_RANGE);
-  // Check if longitude direction is East or West
-  if(u_Coordinates[u_Cnt] == 'E')
+  // Result of +-90 degrees slightly exceeds the Q31 range
+  if (i_P > CALCM_Q31_ONE)
   {
-    t_Cooridnates.t_LongitudeDirection = CALCM_EAST_SIDE;
+    i_P = CALCM_Q31_ONE;
   }
-  else if(u_Coordinates[u_Cnt] == 'W')
+  else if (i_P < -CALCM_Q31_ONE)
   {
-    t_Cooridnates.t_LongitudeDirection = CALCM_WEST_SIDE;
+    i_P = -CALCM_Q31_ONE;
   }
-  return &t_Cooridnates;
+  return (int32_t)i_P;
 }
 
-/// @brief Function used for calculating the absolute value of the distance between two points.
+/// @brief Function used to calculate the angle of a vector in Q31
 ///
-/// @pre Values for each coordinate must be known
-/// @post Further calculation based on the absolute distance can be performed
-/// @param double f_CarLongitude, double f_StartingLongitude
+/// @pre None
+/// @post None
+/// @param int64_t i_Y, int64_t i_X components of the vector in Q31
 ///
-/// @return double f_DeltaL
+/// @return int32_t angle in Q31 half turns
 ///
 /// @globals None
 ///
-/// @InOutCorelation Function calculates the absolute value of the distance between two points.
+/// @InOutCorelation Function reduces the ratio of components to [0, 1]. Above tan(22.5 degrees) it uses
+///                  atan(r) = 45 degrees + atan((r - 1) / (r + 1)), so the polynomial only covers
+///                  |r| <= tan(22.5 degrees), where its error is below 3e-9 half turns.
 /// @callsequence
-///   @startuml "f_CalculateDistance.png"
-///     title "Sequence diagram for function f_CalculateDistance"
-///     -> CALCM: f_CalculateDistance(double f_CarLongitude, double f_StartingLongitude)
+///   @startuml "i_Atan2Q31.png"
+///     title "Sequence diagram for function i_Atan2Q31"
+///     -> CALCM: i_Atan2Q31(int64_t i_Y, int64_t i_X)
 ///     CALCM++
-///       opt Check if car longitude is positive.
-///         opt Check if our current longitude is positive.
-///           opt If car longitude is greater than current longitude.
-///             rnote over CALCM: Subtract current longitude from car longitude.
-///           else else If current longitude is greater than car longitude.
-///             rnote over CALCM: Subtract car longitude from current longitude.
-///           end
-///         else else If current longitude is negative.
-///           rnote over CALCM: Add car longitude to current longitude multiplied by negative value of 1.
-///         end
-///       else else If car longitude is negative.
-///         rnote over CALCM: Car longitude is multiplied by negative value of 1 and saved into temporary variable.
-///         opt If current longitude is positive.
-///           rnote over CALCM: Add current longitude to value in temporary variable.
-///         else else If current longitude is negative.
-///           rnote over CALCM: Current longitude is multiplied by negative value of 1. and saved into temporary variable.
-///           opt If car longitude multiplied by negative value of 1 is greater than current longitude multiplied by negative value of 1.
-///             rnote over CALCM: Subtract current longitude multiplied by negative value of 1 form car longitude multiplied by negative value of 1.
-///           else else If current longitude multiplied by negative value of 1 is greater than car longitude multiplied by negative value of 1.
-///             rnote over CALCM: Subtract car longitude multiplied by negative value of 1 from current longitude multiplied by negative value of 1.
-///           end
-///         end
+///       rnote over CALCM: Order the absolute components.
+///       alt if ratio is above tan(22.5 degrees)
+///         rnote over CALCM: Ratio is (small - large) / (small + large), 45 degrees is added.
+///       else
+///         rnote over CALCM: Ratio is small / large.
+///       end
+///       rnote over CALCM: Evaluate the polynomial, which returns half turns.
+///       opt if |y| > |x|
+///         rnote over CALCM: Angle is 90 degrees minus the result.
+///       end
+///       opt if x is negative
+///         rnote over CALCM: Angle is 180 degrees minus the result.
+///       end
+///       opt if y is negative
+///         rnote over CALCM: Negate the angle.
 ///       end
-///     <- CALCM: //Returns double value of absolute value of distance.
+///     <- CALCM:// Returns int32_t angle in Q31 half turns.//
 ///     CALCM--
 ///   @enduml
 
-static double f_CalculateDistance(double f_CarLongitude, double f_StartingLongitude);
+static int32_t i_Atan2Q31(int64_t i_Y, int64_t i_X);
 
-static double f_CalculateDistance(double f_CarLongitude, double f_StartingLongitude)
+static int32_t i_Atan2Q31(int64_t i_Y, int64_t i_X)
 {
-  double f_DeltaL;
-  // Check if car longitude coordinate is positive
-  if(f_CarLongitude >= 0)
+  int64_t i_AbsY = (i_Y < 0) ? -i_Y : i_Y;
+  int64_t i_AbsX = (i_X < 0) ? -i_X : i_X;
+  int64_t i_Small = (i_AbsY > i_AbsX) ? i_AbsX : i_AbsY;
+  int64_t i_Large = (i_AbsY > i_AbsX) ? i_AbsY : i_AbsX;
+  int64_t i_Base = 0;
+  int64_t i_Ratio;
+
+  if (i_Large == 0)
   {
-	// Check if current longitude coordinate is positive
-    if(f_StartingLongitude >= 0)
-    {
-      // Check if car longitude coordinate is greater than current longitude coordinate
-      if(f_CarLongitude > f_StartingLongitude)
-      {
-    	// Calculate absolute distance between coordinates when both values are positive
-        f_DeltaL = f_CarLongitude - f_StartingLongitude;
-       }
-      else
-      {
-        // Calculate absolute distance between coordinates when both values are positive
-        f_DeltaL = f_StartingLongitude - f_CarLongitude;
-      }
-    }
-    else
-    {
-      // Calculate absolute distance between coordinates when car longitude is positive and current longitude is negative
-      f_DeltaL = f_CarLongitude + f_StartingLongitude * (-1);
-    }
+    return 0;
+  }
+  if ((i_Small * CALCM_Q31_HALF_TURN) > (i_Large * CALCM_Q31_TAN_EIGHTH_TURN))
+  {
+    i_Ratio = ((i_Small - i_Large) * CALCM_Q31_HALF_TURN) / (i_Small + i_Large);
+    i_Base = CALCM_Q31_EIGHTH_TURN;
   }
   else
   {
-    // Temporary variable used when value of car longitude is negative
-    double f_CarLongitude_tmp = f_CarLongitude * (-1);
-    // Check if current longitude is positive
-    if(f_StartingLongitude >= 0)
-    {
-      // Calculate absolute distance between coordinates when current longitude is positive and car longitude is negative
-      f_DeltaL = f_CarLongitude_tmp + f_StartingLongitude;
-    }
-    else
-    {
-      // Temporary variable used when value of current longitude is negative
-      double f_StartingLongitude_tmp = f_StartingLongitude * (-1);
-      if(f_CarLongitude_tmp > f_StartingLongitude_tmp)
-      {
-        // Calculate absolute distance between coordinates when both values are negative
-        f_DeltaL = f_CarLongitude_tmp - f_StartingLongitude_tmp;
-      }
-      else
-      {
-        // Calculate absolute distance between coordinates when both values are negative
-        f_DeltaL = f_StartingLongitude_tmp - f_CarLongitude_tmp;
-      }
-    }
+    i_Ratio = (i_Small * CALCM_Q31_HALF_TURN) / i_Large;
   }
-  // Returns absolute value of distance
-  return f_DeltaL;
-}
 
-uint16_t CALCM_u_CalculateBearing()
-{
-  // Starting latitude and latitude are 0 in our project (pointing N)
-  double f_StartingLatitude = 0;
-
-  volatile t_CALCM_Cooridnates * p_GetCoordinates = p_SetCoordinates();
+  int64_t i_R2 = (i_Ratio * i_Ratio) >> 31;
+  int64_t i_P = CALCM_Q31_ATAN_A9;
+  i_P = CALCM_Q31_ATAN_A7 + ((i_R2 * i_P) >> 31);
+  i_P = CALCM_Q31_ATAN_A5 + ((i_R2 * i_P) >> 31);
+  i_P = CALCM_Q31_ATAN_A3 + ((i_R2 * i_P) >> 31);
+  i_P = CALCM_Q31_ATAN_A1 + ((i_R2 * i_P) >> 31);
+  i_P = i_Base + ((i_Ratio * i_P) >> 31);
 
-  // Read car latitude gotten from GPS module
-  double f_CarLatitude = p_GetCoordinates -> d_Latitude;
-  // South side of latitude has negative value
-  if(p_GetCoordinates -> t_LatitudeDirection == CALCM_SOUTH_SIDE)
+  if (i_AbsY > i_AbsX)
   {
-    f_CarLatitude *= (-1);
+    i_P = CALCM_Q31_QUARTER_TURN - i_P;
   }
-
-  // Read car longitude gotten from GPS module
-  double f_CarLongitude = p_GetCoordinates -> d_Longitude;
-  // West side of longitude has negative value
-  if(p_GetCoordinates -> t_LongitudeDirection == CALCM_WEST_SIDE)
+  if (i_X < 0)
   {
-    f_CarLongitude *= (-1);
+    i_P = CALCM_Q31_HALF_TURN - i_P;
   }
+  if (i_Y < 0)
+  {
+    i_P = -i_P;
+  }
+  // 180 degrees wraps to -180 degrees, which is the same direction
+  return (int32_t)(uint32_t)i_P;
+}
+
+/// @brief Function used to calculate bearing in Q31 fixed point
+///
+/// @pre None
+/// @post None
+/// @param int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance angles in micro-degrees
+///
+/// @return int32_t bearing in Q31 half turns
+///
+/// @globals None
+///
+/// @InOutCorelation Function evaluates the folded bearing formula of v_Fold without any floating point operation.
+/// @callsequence
+///   @startuml "i_BearingKernelQ31.png"
+///     title "Sequence diagram for function i_BearingKernelQ31"
+///     -> CALCM: i_BearingKernelQ31(int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance)
+///     CALCM++
+///       CALCM -> CALCM: v_Fold(...)
+///       CALCM -> CALCM: i_MicroDegreesToQ31(...), i_SinQ31(...)
+///       CALCM -> CALCM: i_Atan2Q31(i_x, i_y)
+///     <- CALCM:// Returns int32_t bearing in Q31 half turns.//
+///     CALCM--
+///   @enduml
+
+static int32_t i_BearingKernelQ31(int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance);
+
+static int32_t i_BearingKernelQ31(int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance)
+{
+  t_CALCM_Fold t_Fold;
+
+  v_Fold(i_StartingLatitude, i_CarLatitude, i_Distance, &t_Fold);
+
+  int32_t i_Distance_q31 = i_MicroDegreesToQ31(t_Fold.i_Distance);
+  int64_t i_CosStart = i_SinQ31(i_MicroDegreesToQ31(t_Fold.i_CosStart));
+  int64_t i_SinCar   = i_SinQ31(i_MicroDegreesToQ31(i_CarLatitude));
+  int64_t i_Half     = i_SinQ31(i_Distance_q31 / 2);
+
+  int64_t i_x = (i_CosStart * i_SinQ31(i_Distance_q31)) >> 31;
+  // 2 * sin(C) * cos(S) * sin^2(D / 2), the factor of 2 is the shift by 30
+  int64_t i_Term = ((((i_SinCar * i_CosStart) >> 31) * ((i_Half * i_Half) >> 31)) >> 30);
+  int64_t i_y = i_SinQ31(i_MicroDegreesToQ31(t_Fold.i_Latitudes)) + (t_Fold.i_Fold * i_Term);
+
+  return i_Atan2Q31(i_x, i_y);
+}
+#endif
+
+#if (CALCM_BEARING_KERNEL == CALCM_KERNEL_FLOAT) || defined(HOST_BUILD)
+/// @brief Function used to calculate bearing in single precision
+///
+/// @pre None
+/// @post None
+/// @param int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance angles in micro-degrees
+///
+/// @return float bearing in degrees in [-180, 180]
+///
+/// @globals None
+///
+/// @InOutCorelation Function evaluates the folded bearing formula of v_Fold on the FPU.
+/// @callsequence
+///   @startuml "f_BearingKernelFloat.png"
+///     title "Sequence diagram for function f_BearingKernelFloat"
+///     -> CALCM: f_BearingKernelFloat(int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance)
+///     CALCM++
+///       CALCM -> CALCM: v_Fold(...)
+///       CALCM -> CALCM: RADIANS_CONVERTOR_F()
+///       math.h -> CALCM: Uses sinf() and atan2f() functions from math.h library
+///       CALCM -> CALCM: DEGREES_CONVERTOR_F()
+///     <- CALCM:// Returns float bearing in degrees.//
+///     CALCM--
+///   @enduml
+
+static float f_BearingKernelFloat(int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance);
+
+static float f_BearingKernelFloat(int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance)
+{
+  t_CALCM_Fold t_Fold;
+
+  v_Fold(i_StartingLatitude, i_CarLatitude, i_Distance, &t_Fold);
+
+  // Converting coordinates to radians because math.h functions use radians
+  float f_Distance_rad = RADIANS_CONVERTOR_F((float)t_Fold.i_Distance / (float)CALCM_MICRODEGREES);
+  float f_CosStart = sinf(RADIANS_CONVERTOR_F((float)t_Fold.i_CosStart / (float)CALCM_MICRODEGREES));
+  float f_SinCar = sinf(RADIANS_CONVERTOR_F((float)i_CarLatitude / (float)CALCM_MICRODEGREES));
+  float f_Half = sinf(f_Distance_rad * 0.5f);
+
+  float f_x = f_CosStart * sinf(f_Distance_rad);
+  float f_y = sinf(RADIANS_CONVERTOR_F((float)t_Fold.i_Latitudes / (float)CALCM_MICRODEGREES)) +
+              ((float)t_Fold.i_Fold * 2.0f * f_SinCar * f_CosStart * f_Half * f_Half);
+
+  return DEGREES_CONVERTOR_F(atan2f(f_x, f_y));
+}
+#endif
 
-  // Calculate the absolute value of distance
-  double f_Distance = f_CalculateDistance(f_CarLongitude, f_StartingLatitude);
+#if (CALCM_BEARING_KERNEL == CALCM_KERNEL_DOUBLE) || defined(HOST_BUILD)
+/// @brief Function used to calculate bearing in double precision, used as the reference of the other kernels
+///
+/// @pre None
+/// @post None
+/// @param int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance angles in micro-degrees
+///
+/// @return double bearing in degrees in [-180, 180]
+///
+/// @globals None
+///
+/// @InOutCorelation Function evaluates the bearing formula as it is, with double precision library functions.
+/// @callsequence
+///   @startuml "d_BearingKernelDouble.png"
+///     title "Sequence diagram for function d_BearingKernelDouble"
+///     -> CALCM: d_BearingKernelDouble(int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance)
+///     CALCM++
+///       CALCM -> CALCM: RADIANS_CONVERTOR()
+///       math.h -> CALCM: Uses sin(), cos() and atan2() functions from math.h library
+///       CALCM -> CALCM: DEGREES_CONVERTOR()
+///     <- CALCM:// Returns double bearing in degrees.//
+///     CALCM--
+///   @enduml
+
+static double d_BearingKernelDouble(int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance);
 
+static double d_BearingKernelDouble(int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance)
+{
   // Converting coordinates to radians because math.h functions use radians
-  double f_CarLatitude_rad = RADIANS_CONVERTOR(f_CarLatitude);
-  double f_StartingLatitude_rad = RADIANS_CONVERTOR(f_StartingLatitude);
-  double f_Distance_rad = RADIANS_CONVERTOR(f_Distance);
+  double f_CarLatitude_rad = RADIANS_CONVERTOR((double)i_CarLatitude / CALCM_MICRODEGREES);
+  double f_StartingLatitude_rad = RADIANS_CONVERTOR((double)i_StartingLatitude / CALCM_MICRODEGREES);
+  double f_Distance_rad = RADIANS_CONVERTOR((double)i_Distance / CALCM_MICRODEGREES);
 
   double f_x = cos(f_StartingLatitude_rad) * sin(f_Distance_rad);
   double f_y = cos(f_CarLatitude_rad) * sin(f_StartingLatitude_rad) - sin(f_CarLatitude_rad) * cos(f_StartingLatitude_rad) * cos(f_Distance_rad);
 
-  double f_Bearing = atan2(f_x, f_y);
+  return DEGREES_CONVERTOR(atan2(f_x, f_y));
+}
+#endif
 
-  // Convert bearing to degrees
-  f_Bearing = DEGREES_CONVERTOR(f_Bearing);
+#if defined(HOST_BUILD)
+double CALCM_d_BearingKernel(uint8_t u_Kernel, int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance)
+{
+  if (u_Kernel == CALCM_KERNEL_Q31)
+  {
+    return ((double)i_BearingKernelQ31(i_StartingLatitude, i_CarLatitude, i_Distance) * (FULL_CIRCLE / 2)) /
+           (double)CALCM_Q31_HALF_TURN;
+  }
+  if (u_Kernel == CALCM_KERNEL_FLOAT)
+  {
+    return (double)f_BearingKernelFloat(i_StartingLatitude, i_CarLatitude, i_Distance);
+  }
+  return d_BearingKernelDouble(i_StartingLatitude, i_CarLatitude, i_Distance);
+}
+#endif
+
+uint16_t CALCM_u_CalculateBearing()
+{
+  // Starting latitude and longitude are 0 in our project (pointing N)
+  int32_t i_StartingLatitude = 0;
+  int32_t i_StartingLongitude = 0;
+
+  t_MSGM_Fix t_Target;
+
+  // Target is copied as a whole, without it the bearing points along the reference meridian
+  if(MSGM_b_ReadFix(MSGM_FIX_TARGET, &t_Target) != b_TRUE)
+  {
+    t_Target.i_Latitude = 0;
+    t_Target.i_Longitude = 0;
+  }
+  int32_t i_CarLatitude = t_Target.i_Latitude;
+  int32_t i_CarLongitude = t_Target.i_Longitude;
+
+  // Absolute value of the longitude distance, both longitudes are within +-180 degrees so the difference cannot overflow
+  int32_t i_Distance = abs(i_CarLongitude - i_StartingLongitude);
+
+#if (CALCM_BEARING_KERNEL == CALCM_KERNEL_Q31)
+  int32_t i_Bearing = i_BearingKernelQ31(i_StartingLatitude, i_CarLatitude, i_Distance);
+  // Signed half turns read as unsigned are full turns in [0, 2^32), which maps directly to [0, 360)
+  uint16_t u_Bearing = (uint16_t)(((uint64_t)(uint32_t)i_Bearing * FULL_CIRCLE) >> 32);
+#else
+#if (CALCM_BEARING_KERNEL == CALCM_KERNEL_FLOAT)
+  float f_Bearing = f_BearingKernelFloat(i_StartingLatitude, i_CarLatitude, i_Distance);
+#else
+  double f_Bearing = d_BearingKernelDouble(i_StartingLatitude, i_CarLatitude, i_Distance);
+#endif
+  // atan2 returns [-180, 180] degrees, negative bearing is moved to the same direction in [0, 360)
+  if(f_Bearing < 0)
+  {
+    f_Bearing += FULL_CIRCLE;
+  }
 
   uint16_t u_Bearing = (uint16_t)f_Bearing;
+#endif
   // Check if bearing is in correct range
-  if(u_Bearing > FULL_CIRCLE)
+  if(u_Bearing >= FULL_CIRCLE)
   {
     u_Bearing %= FULL_CIRCLE;
   }
@@ -12,6 +12,50 @@
 #define RADIANS_CONVERTOR(x) (x * 0.0174532925)
 /// Function that converts radians to degrees
 #define DEGREES_CONVERTOR(x) (x * 57.2957795)
+/// Function that converts degrees to radians in single precision
+#define RADIANS_CONVERTOR_F(x) ((x) * 0.0174532925f)
+/// Function that converts radians to degrees in single precision
+#define DEGREES_CONVERTOR_F(x) ((x) * 57.2957795f)
+
+/// Bearing kernel computed in double precision (software floating point on the single precision FPU)
+#define CALCM_KERNEL_DOUBLE (0u)
+/// Bearing kernel computed in single precision with sinf(), cosf() and atan2f()
+#define CALCM_KERNEL_FLOAT (1u)
+/// Bearing kernel computed in Q31 fixed point with polynomial sine and arctangent
+#define CALCM_KERNEL_Q31 (2u)
+/// Selected bearing kernel, the host build compiles all kernels for the accuracy test
+#define CALCM_BEARING_KERNEL (CALCM_KERNEL_FLOAT)
+
+/// Half turn (180 degrees) in Q31 angle format, angles are stored as fractions of a half turn
+#define CALCM_Q31_HALF_TURN (2147483648LL)
+/// Quarter turn (90 degrees) in Q31 angle format
+#define CALCM_Q31_QUARTER_TURN (1073741824LL)
+/// Eighth of a turn (45 degrees) in Q31 angle format
+#define CALCM_Q31_EIGHTH_TURN (536870912LL)
+/// tan(22.5 degrees) in Q31, above it the arctangent is taken of the vector rotated by 45 degrees
+#define CALCM_Q31_TAN_EIGHTH_TURN (889516852LL)
+/// Largest value of a Q31 number
+#define CALCM_Q31_ONE (2147483647LL)
+/// Half turn (180 degrees) in micro-degrees
+#define CALCM_MICRODEGREES_PER_HALF_TURN (180000000)
+/// Quarter turn (90 degrees) in micro-degrees
+#define CALCM_MICRODEGREES_PER_QUARTER_TURN (90000000)
+/// Full turn (360 degrees) in micro-degrees
+#define CALCM_MICRODEGREES_PER_TURN (360000000)
+/// Coefficients of sin(pi * x) = x * (C1 - x^2 * (C3 - x^2 * (C5 - x^2 * (C7 - x^2 * C9)))) in Q28, |x| <= 0.5,
+/// fitted for the smallest relative error
+#define CALCM_Q28_SIN_C1 (843314852LL)
+#define CALCM_Q28_SIN_C3 (1387196506LL)
+#define CALCM_Q28_SIN_C5 (684529130LL)
+#define CALCM_Q28_SIN_C7 (160589397LL)
+#define CALCM_Q28_SIN_C9 (20819955LL)
+/// Coefficients of atan(r) / pi = r * (A1 + r^2 * (A3 + r^2 * (A5 + r^2 * (A7 + r^2 * A9)))) in Q31,
+/// |r| <= tan(22.5 degrees), the result is in half turns
+#define CALCM_Q31_ATAN_A1 (683565263LL)
+#define CALCM_Q31_ATAN_A3 (-227851441LL)
+#define CALCM_Q31_ATAN_A5 (136538542LL)
+#define CALCM_Q31_ATAN_A7 (-94688053LL)
+#define CALCM_Q31_ATAN_A9 (54594517LL)
 
 /// Defines value of full circle in degrees
 #define FULL_CIRCLE 360
@@ -25,24 +69,170 @@
 #define LATITUDE_HIGH_RANGE 90
 /// Derivation constant used to correct format of data read from GPS module
 #define DERIVATION_CONST 100
+/// Number of micro-degrees in one degree
+#define CALCM_MICRODEGREES (1000000u)
+/// Number of fraction digits of minutes kept by the parser (micro-minutes)
+#define CALCM_MINUTE_FRACTION_DIGITS (6u)
+/// Number of minutes in one degree
+#define CALCM_MINUTES_PER_DEGREE (60u)
+/// Greatest number of digits before the dot (dddmm)
+#define CALCM_MAX_INTEGER_DIGITS (5u)
+/// Number of fraction digits of minutes written by CALCM_u_FormatPosition, micro-degrees times 6 are 1e-5 minutes
+#define CALCM_FORMAT_FRACTION_DIGITS (5u)
+/// Size of the text written by CALCM_u_FormatPosition, "ddmm.mmmmm,N,dddmm.mmmmm,E" and the NULL character
+#define CALCM_POSITION_TEXT_LENGTH (27u)
 
-/// Enum used to define sides of the world
+/// Enum used to report the result of parsing a coordinate
 typedef enum
 {
-  CALCM_NORTH_SIDE = 0u,							///< North side
-  CALCM_WEST_SIDE  = 1u,							///< West side
-  CALCM_EAST_SIDE  = 2u,							///< East side
-  CALCM_SOUTH_SIDE = 3u								///< South side
-} t_CALCM_WorldDirection;
-
-/// Structure used for coordinates in format that is needed for further calculations
-typedef struct
-{
-  double d_Latitude;								///< Value of latitude coordinate
-  double d_Longitude;								///< Value of longitude coordinate
-  t_CALCM_WorldDirection t_LatitudeDirection;		///< Direction for a latitude coordinate
-  t_CALCM_WorldDirection t_LongitudeDirection;		///< Direction for a longitude coordinate
-} t_CALCM_Cooridnates;
+  CALCM_PARSE_OK                = 0u,				///< Coordinate was parsed
+  CALCM_PARSE_EMPTY             = 1u,				///< Field has no characters
+  CALCM_PARSE_INVALID_CHARACTER = 2u,				///< Field has a character that is not a digit or a single dot
+  CALCM_PARSE_INVALID_FORMAT    = 3u,				///< Field has no dot or a wrong number of digits before it
+  CALCM_PARSE_OUT_OF_RANGE      = 4u,				///< Minutes are not below 60 or degrees exceed the limit
+  CALCM_PARSE_INVALID_DIRECTION = 5u				///< Direction is not N, S, E or W
+} e_CALCM_ParseStatus;
+
+/// @brief Function used to convert a coordinate in ddmm.mmmm or dddmm.mmmm format to micro-degrees
+///
+/// @pre None
+/// @post *p_Index points to the character that ended the field (',' or NULL character)
+/// @param const uint8_t *p_Text text with the field, uint8_t *p_Index position of the field start,
+///        uint8_t u_MaxIndex position at which parsing stops, uint32_t u_Limit greatest value in degrees,
+///        int32_t *p_MicroDegrees result, written only when parsing succeeds
+/// @return e_CALCM_ParseStatus status of parsing
+///
+/// @globals None
+///
+/// @InOutCorelation Function reads each character once, accumulates digits before the dot as ddmm and the
+///                  minute fraction as micro-minutes, then splits degrees and minutes with one division.
+/// @callsequence
+///   @startuml "CALCM_e_ParseCoordinate.png"
+///     title "Sequence diagram for function CALCM_e_ParseCoordinate"
+///     -> CALCM: CALCM_e_ParseCoordinate(...)
+///     CALCM++
+///       loop until ',' or NULL character or u_MaxIndex
+///         opt if character is a digit
+///           rnote over CALCM: Accumulate it into the integer part or the minute fraction.
+///         else else if character is the first dot
+///           rnote over CALCM: Switch to the minute fraction.
+///         else else
+///           <- CALCM:// Returns CALCM_PARSE_INVALID_CHARACTER//
+///         end
+///       end
+///       opt if format or range is wrong
+///         <- CALCM:// Returns the error//
+///       end
+///       rnote over CALCM: micro-degrees = degrees * 10^6 + micro-minutes / 60
+///     <- CALCM:// Returns CALCM_PARSE_OK//
+///     CALCM--
+///   @enduml
+e_CALCM_ParseStatus CALCM_e_ParseCoordinate(const uint8_t *p_Text, uint8_t *p_Index, uint8_t u_MaxIndex, uint32_t u_Limit, int32_t *p_MicroDegrees);
+
+/// @brief Function used to convert a position in "ddmm.mmmm,N,dddmm.mmmm,E" format to signed micro-degrees
+///
+/// @pre None
+/// @post None
+/// @param const uint8_t *p_Text text with the position, uint8_t u_MaxIndex position at which parsing stops,
+///        int32_t *p_Latitude, int32_t *p_Longitude results, written only when parsing succeeds
+/// @return e_CALCM_ParseStatus status of parsing
+///
+/// @globals None
+///
+/// @InOutCorelation Latitude and longitude are parsed with CALCM_e_ParseCoordinate, South and West are negative.
+/// @callsequence
+///   @startuml "CALCM_e_ParsePosition.png"
+///     title "Sequence diagram for function CALCM_e_ParsePosition"
+///     -> CALCM: CALCM_e_ParsePosition(...)
+///     CALCM++
+///       CALCM -> CALCM: CALCM_e_ParseCoordinate(p_Text, &u_Cnt, u_MaxIndex, LATITUDE_HIGH_RANGE, ...)
+///       opt if latitude is South
+///         rnote over CALCM: Negate latitude
+///       end
+///       CALCM -> CALCM: CALCM_e_ParseCoordinate(p_Text, &u_Cnt, u_MaxIndex, LONGITUDE_HIGH_RANGE, ...)
+///       opt if longitude is West
+///         rnote over CALCM: Negate longitude
+///       end
+///       opt if every part is valid
+///         rnote over CALCM: Store the position
+///       end
+///     <- CALCM:// Returns e_CALCM_ParseStatus//
+///     CALCM--
+///   @enduml
+e_CALCM_ParseStatus CALCM_e_ParsePosition(const uint8_t *p_Text, uint8_t u_MaxIndex, int32_t *p_Latitude, int32_t *p_Longitude);
+
+/// @brief Function used to write signed micro-degrees as a position in "ddmm.mmmmm,N,dddmm.mmmmm,E" format
+///
+/// @pre p_Text has room for CALCM_POSITION_TEXT_LENGTH characters, the position is within the valid ranges
+/// @post p_Text holds the position followed by a NULL character
+/// @param int32_t i_Latitude, int32_t i_Longitude in micro-degrees, uint8_t *p_Text
+/// @return uint8_t number of written characters without the NULL character
+///
+/// @globals None
+///
+/// @InOutCorelation Inverse of CALCM_e_ParsePosition, five decimals of minutes hold a micro-degree exactly, so the
+///                  text is parsed back to the same values.
+/// @callsequence
+///   @startuml "CALCM_u_FormatPosition.png"
+///     title "Sequence diagram for function CALCM_u_FormatPosition"
+///     -> CALCM: CALCM_u_FormatPosition(...)
+///     CALCM++
+///       CALCM -> CALCM: u_FormatAngle(|i_Latitude|, 2, ...)
+///       CALCM -> CALCM: u_FormatAngle(|i_Longitude|, 3, ...)
+///     <- CALCM:// Returns the length//
+///     CALCM--
+///   @enduml
+uint8_t CALCM_u_FormatPosition(int32_t i_Latitude, int32_t i_Longitude, uint8_t *p_Text);
+
+/// @brief Function used to set the position the bearing points to
+///
+/// @pre Called by TSK_SIM only, it is the single writer of MSGM_FIX_TARGET
+/// @post Valid position is published as MSGM_FIX_TARGET, on error the previous target is kept and the error is stored
+/// @param const uint8_t *p_Text text with the position, uint8_t u_MaxIndex position at which parsing stops
+/// @return e_CALCM_ParseStatus status of parsing
+///
+/// @globals static volatile e_CALCM_ParseStatus CALCM_e_Status
+///
+/// @InOutCorelation Text is parsed once when it is received, CALCM_u_CalculateBearing reads the binary record. Text
+///                  which starts with TRACK_MARKER is a packed track, its newest fix is the target.
+/// @callsequence
+///   @startuml "CALCM_e_SetTarget.png"
+///     title "Sequence diagram for function CALCM_e_SetTarget"
+///     -> CALCM: CALCM_e_SetTarget(...)
+///     CALCM++
+///       opt if text is a packed track
+///         CALCM -> TRACK: TRACK_e_Decode(p_Text, u_MaxIndex, &t_Target, 1, ...)
+///       else else
+///         CALCM -> CALCM: CALCM_e_ParsePosition(...)
+///       end
+///       opt if position is valid
+///         CALCM -> MSGM: MSGM_v_PublishFix(MSGM_FIX_TARGET, ...)
+///       end
+///       rnote over CALCM: Store the status
+///     <- CALCM:// Returns e_CALCM_ParseStatus//
+///     CALCM--
+///   @enduml
+e_CALCM_ParseStatus CALCM_e_SetTarget(const uint8_t *p_Text, uint8_t u_MaxIndex);
+
+/// @brief Function used to get the result of the last coordinate parsing
+///
+/// @pre None
+/// @post None
+/// @param None
+/// @return e_CALCM_ParseStatus status of the last parsing
+///
+/// @globals static volatile e_CALCM_ParseStatus CALCM_e_Status
+///
+/// @InOutCorelation Function returns the status stored by CALCM_e_SetTarget.
+/// @callsequence
+///   @startuml "CALCM_e_GetParseStatus.png"
+///     title "Sequence diagram for function CALCM_e_GetParseStatus"
+///     -> CALCM: CALCM_e_GetParseStatus()
+///     CALCM++
+///     <- CALCM:// Returns e_CALCM_ParseStatus.//
+///     CALCM--
+///   @enduml
+e_CALCM_ParseStatus CALCM_e_GetParseStatus(void);
 
 /// @brief Function used to calculate bearing based on parsed coordinates
 ///
@@ -51,29 +241,26 @@ typedef struct
 /// @param None
 /// @return uint16_t u_Bearing
 ///
-/// @globals None
+/// @globals MSGM_a_Fixes
 ///
-/// @InOutCorelation Function calculates bearing based on coordinates.
+/// @InOutCorelation Function calculates bearing based on the target published by CALCM_e_SetTarget.
 /// @callsequence
 ///   @startuml "CALCM_u_CalculateBearing.png"
 ///     title "Sequence diagram for function CALCM_u_CalculateBearing"
 ///     -> CALCM: CALCM_u_CalculateBearing()
 ///     CALCM++
-///       CALCM -> CALCM: CALCM_p_SetCoordinates()
-///       opt if latitude is South side
-///         rnote over CALCM: Multiply latitude by -1 (South side of latitude has negative value)
-///       end
-///       opt if longitude is West side
-///         rnote over CALCM: Multiply longitude by -1 (West side of longitude has negative value)
+///       CALCM -> MSGM: MSGM_b_ReadFix(MSGM_FIX_TARGET, ...)
+///       rnote over CALCM: Longitude distance is the absolute value of car minus starting longitude.
+///       opt if CALCM_BEARING_KERNEL is CALCM_KERNEL_Q31
+///         CALCM -> CALCM: i_BearingKernelQ31(...)
+///         rnote over CALCM: Q31 half turns are converted to degrees in [0, 360).
+///       else else CALCM_KERNEL_FLOAT
+///         CALCM -> CALCM: f_BearingKernelFloat(...)
+///       else else CALCM_KERNEL_DOUBLE
+///         CALCM -> CALCM: d_BearingKernelDouble(...)
 ///       end
-///       math.h -> CALCM: Uses sin(), cos() and tan2() functions from math.h library
-///       CALCM -> CALCM: f_CalculateDistance(f_CarLongitude, f_StartingLatitude)
-///       rnote over CALCM: Read values from MSGM must be converted to radians for further calculations.
-///       CALCM -> CALCM: RADIANS_CONVERTOR()
-///       rnote over CALCM: After the calculations are done, value of bearing must be converted to degrees.
-///       CALCM -> CALCM: DEGREES_CONVERTOR(f_Bearing_dbl)
-///       opt if check if the bearing is less than a full circle
-///         rnote over CALCM: Perform modulo derivation so bearing doesn't exceed the maximum value.
+///       opt if bearing is negative
+///         rnote over CALCM: Add a full circle so bearing is in [0, 360).
 ///       end
 ///     <- CALCM:// Returns a uint16_t value of direction.//
 ///     CALCM--
@@ -81,4 +268,37 @@ typedef struct
 
 uint16_t CALCM_u_CalculateBearing(void);
 
+#if defined(HOST_BUILD)
+/// @brief Function used by the host accuracy test to call one of the bearing kernels
+///
+/// @pre None
+/// @post None
+/// @param uint8_t u_Kernel CALCM_KERNEL_DOUBLE, CALCM_KERNEL_FLOAT or CALCM_KERNEL_Q31,
+///        int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance angles in micro-degrees
+///
+/// @return double bearing in degrees in [-180, 180]
+///
+/// @globals None
+///
+/// @InOutCorelation Function passes the arguments as CALCM_u_CalculateBearing does, Q31 half turns are converted
+///                  to degrees. The kernels stay static in the target build.
+/// @callsequence
+///   @startuml "CALCM_d_BearingKernel.png"
+///     title "Sequence diagram for function CALCM_d_BearingKernel"
+///     -> CALCM: CALCM_d_BearingKernel(...)
+///     CALCM++
+///       alt if u_Kernel is CALCM_KERNEL_Q31
+///         CALCM -> CALCM: i_BearingKernelQ31(...)
+///       else else CALCM_KERNEL_FLOAT
+///         CALCM -> CALCM: f_BearingKernelFloat(...)
+///       else else CALCM_KERNEL_DOUBLE
+///         CALCM -> CALCM: d_BearingKernelDouble(...)
+///       end
+///     <- CALCM:// Returns double bearing in degrees.//
+///     CALCM--
+///   @enduml
+
+double CALCM_d_BearingKernel(uint8_t u_Kernel, int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance);
+#endif
+
 #endif /* CALCM_H_ */
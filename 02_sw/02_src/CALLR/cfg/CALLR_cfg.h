@@ -0,0 +1,47 @@
+/// @file CALLR_cfg.h
+/// @brief Contains configuration data used for the table of authorised callers
+/// @author Aleksandra Petrovic
+
+#ifndef CALLR_CFG_H_
+#define CALLR_CFG_H_
+
+#include "CALLR.h"
+#include <stddef.h>
+
+/// Number of slots in the index, power of two and twice CALLR_CAPACITY so probe sequences stay short
+#define CALLR_INDEX_LENGTH (512u)
+/// Largest number of digits of an E.164 number
+#define CALLR_MAX_DIGITS (15u)
+/// Country code added to national numbers which start with a single '0'
+#define CALLR_COUNTRY_CODE "381"
+/// Sector which holds the table, the last sector of bank 2
+#define CALLR_FLASH_SECTOR (23u)
+/// Address of CALLR_FLASH_SECTOR, it is left out of FLASH in the linker script
+#define CALLR_FLASH_ADDRESS (0x081E0000UL)
+/// Marks a stored table, "CLLR" read as a little endian word
+#define CALLR_IMAGE_MAGIC (0x524C4C43UL)
+/// Layout of the stored table, a stored table of another version is not loaded
+#define CALLR_IMAGE_VERSION (1u)
+/// Offset basis of the 32-bit FNV-1a hash
+#define CALLR_FNV_OFFSET (2166136261UL)
+/// Prime of the 32-bit FNV-1a hash
+#define CALLR_FNV_PRIME (16777619UL)
+/// Reflected polynomial of CRC-32 protecting the stored table
+#define CALLR_CRC_POLYNOMIAL (0xEDB88320UL)
+
+/// This struct is used for describing a caller known when no table is stored in flash
+typedef struct {
+  const char *p_Number;         ///< Number in any accepted format
+  e_CALLR_Route e_Route;        ///< Where the coordinates are sent
+  const char *p_Reply;          ///< Number used with CALLR_ROUTE_NUMBER, NULL otherwise
+} t_CALLR_Default;
+
+/// Callers used until a table is saved
+const t_CALLR_Default CALLR_t_Defaults[] = {
+    { "+381605074705",  CALLR_ROUTE_CALLER,   NULL },
+    { "+381611753295",  CALLR_ROUTE_CALLER,   NULL }
+};
+/// Used to determine the length of CALLR_t_Defaults array
+const uint16_t CALLR_u_DefaultsLength = sizeof(CALLR_t_Defaults) / sizeof(CALLR_t_Defaults[0]);
+
+#endif /* CALLR_CFG_H_ */
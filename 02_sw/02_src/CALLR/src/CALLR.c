@@ -0,0 +1,358 @@
+/// @file CALLR.c
+/// @brief Main file used for the table of authorised callers and the routing of their replies
+/// @author Aleksandra Petrovic
+
+#include "CALLR_cfg.h"
+#include "FLASHM.h"
+#include <string.h>
+
+/// This struct is used for the header which precedes the records in flash
+typedef struct {
+  uint32_t u_Magic;         ///< CALLR_IMAGE_MAGIC when a table is stored
+  uint16_t u_Version;       ///< CALLR_IMAGE_VERSION of the stored table
+  uint16_t u_Count;         ///< Number of records after the header
+  uint32_t u_Crc;           ///< CRC-32 of the records
+} t_CALLR_Image;
+
+/// Records of the known callers, the first CALLR_u_Callers are used
+static t_CALLR_Caller CALLR_a_Callers[CALLR_CAPACITY];
+/// Number of records in CALLR_a_Callers
+static uint16_t CALLR_u_Callers = 0u;
+/// Index of the records, a slot holds the record number plus one and 0 when it is empty
+static uint16_t CALLR_a_Index[CALLR_INDEX_LENGTH];
+
+/// @brief Function used for hashing a normalised number
+///
+/// @pre None
+/// @post None
+/// @param const uint8_t *p_Number NUL terminated
+///
+/// @return uint32_t FNV-1a hash, 0 is replaced with 1 so it never looks like an empty record
+///
+/// @globals None
+///
+/// @InOutCorelation None
+/// @callsequence
+///   @startuml "u_Hash.png"
+///     title "Sequence diagram for function u_Hash"
+///     -> CALLR: u_Hash(const uint8_t *p_Number)
+///     CALLR++
+///     <- CALLR: Returns hash
+///     CALLR--
+///   @enduml
+
+static uint32_t u_Hash(const uint8_t *p_Number);
+
+static uint32_t u_Hash(const uint8_t *p_Number)
+{
+  uint32_t u_Value = CALLR_FNV_OFFSET;
+
+  while(*p_Number != 0u)
+  {
+    u_Value ^= *p_Number++;
+    u_Value *= CALLR_FNV_PRIME;
+  }
+  return (u_Value == 0u) ? 1u : u_Value;
+}
+
+/// @brief Function used for calculating the CRC-32 of the records
+///
+/// @pre None
+/// @post None
+/// @param const uint8_t *p_Data, uint32_t u_Length
+///
+/// @return uint32_t CRC-32
+///
+/// @globals None
+///
+/// @InOutCorelation Bitwise calculation, it runs only when the table is loaded or saved.
+/// @callsequence
+///   @startuml "u_Crc32.png"
+///     title "Sequence diagram for function u_Crc32"
+///     -> CALLR: u_Crc32(const uint8_t *p_Data, uint32_t u_Length)
+///     CALLR++
+///     <- CALLR: Returns CRC-32
+///     CALLR--
+///   @enduml
+
+static uint32_t u_Crc32(const uint8_t *p_Data, uint32_t u_Length);
+
+static uint32_t u_Crc32(const uint8_t *p_Data, uint32_t u_Length)
+{
+  uint32_t u_Crc = 0xFFFFFFFFUL;
+
+  for(uint32_t u_Cnt = 0u; u_Cnt < u_Length; u_Cnt++)
+  {
+    u_Crc ^= p_Data[u_Cnt];
+    for(uint8_t u_Bit = 0u; u_Bit < 8u; u_Bit++)
+    {
+      u_Crc = ((u_Crc & 1u) != 0u) ? ((u_Crc >> 1u) ^ CALLR_CRC_POLYNOMIAL) : (u_Crc >> 1u);
+    }
+  }
+  return ~u_Crc;
+}
+
+/// @brief Function used for finding the slot of a number in the index
+///
+/// @pre None
+/// @post None
+/// @param uint32_t u_Value hash of p_Number, const uint8_t *p_Number normalised
+///
+/// @return uint16_t slot which holds the record of the number, or the empty slot where it would be written
+///
+/// @globals CALLR_a_Callers, CALLR_a_Index
+///
+/// @InOutCorelation Index has twice as many slots as the table can hold records, so an empty slot always ends the
+///                  probe sequence.
+/// @callsequence
+///   @startuml "u_Probe.png"
+///     title "Sequence diagram for function u_Probe"
+///     -> CALLR: u_Probe(uint32_t u_Value, const uint8_t *p_Number)
+///     CALLR++
+///       loop while slot is used by another number
+///         rnote over CALLR: Next slot is taken.
+///       end
+///     <- CALLR: Returns slot
+///     CALLR--
+///   @enduml
+
+static uint16_t u_Probe(uint32_t u_Value, const uint8_t *p_Number);
+
+static uint16_t u_Probe(uint32_t u_Value, const uint8_t *p_Number)
+{
+  uint16_t u_Slot = (uint16_t)(u_Value & (CALLR_INDEX_LENGTH - 1u));
+
+  while(CALLR_a_Index[u_Slot] != 0u)
+  {
+    const t_CALLR_Caller *p_Caller = &CALLR_a_Callers[CALLR_a_Index[u_Slot] - 1u];
+
+    if((p_Caller -> u_Hash == u_Value) && (strcmp((const char *)p_Caller -> a_Number, (const char *)p_Number) == 0))
+    {
+      break;
+    }
+    u_Slot = (uint16_t)((u_Slot + 1u) & (CALLR_INDEX_LENGTH - 1u));
+  }
+  return u_Slot;
+}
+
+/// @brief Function used for writing every record into the index
+///
+/// @pre Records must be unique
+/// @post Every record can be found
+/// @param None
+///
+/// @return None
+///
+/// @globals CALLR_a_Callers, CALLR_u_Callers, CALLR_a_Index
+///
+/// @InOutCorelation None
+/// @callsequence
+///   @startuml "v_BuildIndex.png"
+///     title "Sequence diagram for function v_BuildIndex"
+///     -> CALLR: v_BuildIndex()
+///     CALLR++
+///       loop for each record
+///         CALLR -> CALLR: u_Probe(...)
+///       end
+///     <- CALLR
+///     CALLR--
+///   @enduml
+
+static void v_BuildIndex(void);
+
+static void v_BuildIndex(void)
+{
+  memset(CALLR_a_Index, 0, sizeof(CALLR_a_Index));
+  for(uint16_t u_Cnt = 0u; u_Cnt < CALLR_u_Callers; u_Cnt++)
+  {
+    uint16_t u_Slot = u_Probe(CALLR_a_Callers[u_Cnt].u_Hash, CALLR_a_Callers[u_Cnt].a_Number);
+
+    CALLR_a_Index[u_Slot] = (uint16_t)(u_Cnt + 1u);
+  }
+}
+
+void CALLR_v_Init()
+{
+  const t_CALLR_Image *p_Image = (const t_CALLR_Image *)(uintptr_t)CALLR_FLASH_ADDRESS;
+  const uint8_t *p_Records = (const uint8_t *)(uintptr_t)(CALLR_FLASH_ADDRESS + sizeof(t_CALLR_Image));
+
+  CALLR_u_Callers = 0u;
+  if((p_Image -> u_Magic == CALLR_IMAGE_MAGIC) && (p_Image -> u_Version == CALLR_IMAGE_VERSION) &&
+     (p_Image -> u_Count <= CALLR_CAPACITY) &&
+     (p_Image -> u_Crc == u_Crc32(p_Records, (uint32_t)p_Image -> u_Count * sizeof(t_CALLR_Caller))))
+  {
+    memcpy(CALLR_a_Callers, p_Records, (size_t)p_Image -> u_Count * sizeof(t_CALLR_Caller));
+    CALLR_u_Callers = p_Image -> u_Count;
+    v_BuildIndex();
+    return;
+  }
+
+  memset(CALLR_a_Index, 0, sizeof(CALLR_a_Index));
+  for(uint16_t u_Cnt = 0u; u_Cnt < CALLR_u_DefaultsLength; u_Cnt++)
+  {
+    (void)CALLR_e_Add((const uint8_t *)CALLR_t_Defaults[u_Cnt].p_Number, CALLR_t_Defaults[u_Cnt].e_Route,
+                      (const uint8_t *)CALLR_t_Defaults[u_Cnt].p_Reply);
+  }
+}
+
+uint8_t CALLR_u_Normalize(const uint8_t *p_Text, uint32_t u_Length, uint8_t *p_Number)
+{
+  // Two more digits than E.164 allows, "00" may precede a full number
+  uint8_t a_Digits[CALLR_MAX_DIGITS + 2u];
+  const uint8_t *p_Digits = a_Digits;
+  const uint8_t u_CodeLength = (uint8_t)(sizeof(CALLR_COUNTRY_CODE) - 1u);
+  uint8_t u_Found = 0u;
+  uint8_t u_Size = 0u;
+  uint8_t u_Plus = 0u;
+
+  for(uint32_t u_Cnt = 0u; u_Cnt < u_Length; u_Cnt++)
+  {
+    uint8_t u_Char = p_Text[u_Cnt];
+
+    if((u_Char == ' ') || (u_Char == '-') || (u_Char == '.') || (u_Char == '(') || (u_Char == ')'))
+    {
+      continue;
+    }
+    if((u_Char == '+') && (u_Found == 0u) && (u_Plus == 0u))
+    {
+      u_Plus = 1u;
+      continue;
+    }
+    if((u_Char < '0') || (u_Char > '9') || (u_Found >= sizeof(a_Digits)))
+    {
+      return 0u;
+    }
+    a_Digits[u_Found++] = u_Char;
+  }
+
+  p_Number[u_Size++] = '+';
+  if((u_Plus == 0u) && (u_Found >= 2u) && (a_Digits[0] == '0') && (a_Digits[1] == '0'))
+  {
+    p_Digits += 2u;
+    u_Found = (uint8_t)(u_Found - 2u);
+  }
+  else if((u_Plus == 0u) && (u_Found >= 1u) && (a_Digits[0] == '0'))
+  {
+    if((u_Found - 1u + u_CodeLength) > CALLR_MAX_DIGITS)
+    {
+      return 0u;
+    }
+    memcpy(&p_Number[u_Size], CALLR_COUNTRY_CODE, u_CodeLength);
+    u_Size = (uint8_t)(u_Size + u_CodeLength);
+    p_Digits++;
+    u_Found--;
+  }
+  if((u_Found == 0u) || ((u_Size - 1u + u_Found) > CALLR_MAX_DIGITS))
+  {
+    return 0u;
+  }
+  memcpy(&p_Number[u_Size], p_Digits, u_Found);
+  u_Size = (uint8_t)(u_Size + u_Found);
+  p_Number[u_Size] = 0u;
+  return u_Size;
+}
+
+const t_CALLR_Caller *CALLR_p_Find(const uint8_t *p_Text, uint32_t u_Length)
+{
+  uint8_t a_Number[CALLR_NUMBER_SIZE];
+  uint16_t u_Slot = 0u;
+
+  if(CALLR_u_Normalize(p_Text, u_Length, a_Number) == 0u)
+  {
+    return NULL;
+  }
+  u_Slot = u_Probe(u_Hash(a_Number), a_Number);
+  if(CALLR_a_Index[u_Slot] == 0u)
+  {
+    return NULL;
+  }
+  return &CALLR_a_Callers[CALLR_a_Index[u_Slot] - 1u];
+}
+
+e_CALLR_Status CALLR_e_Add(const uint8_t *p_Number, e_CALLR_Route e_Route, const uint8_t *p_Reply)
+{
+  t_CALLR_Caller t_Caller;
+  uint16_t u_Slot = 0u;
+
+  // Padding is cleared too, the record is protected by the CRC as it is in memory
+  memset(&t_Caller, 0, sizeof(t_Caller));
+  if(CALLR_u_Normalize(p_Number, (uint32_t)strlen((const char *)p_Number), t_Caller.a_Number) == 0u)
+  {
+    return CALLR_ERROR_NUMBER;
+  }
+  if((e_Route == CALLR_ROUTE_NUMBER) &&
+     ((p_Reply == NULL) || (CALLR_u_Normalize(p_Reply, (uint32_t)strlen((const char *)p_Reply), t_Caller.a_Reply) == 0u)))
+  {
+    return CALLR_ERROR_NUMBER;
+  }
+  t_Caller.u_Hash = u_Hash(t_Caller.a_Number);
+  t_Caller.u_Route = (uint8_t)e_Route;
+
+  u_Slot = u_Probe(t_Caller.u_Hash, t_Caller.a_Number);
+  if(CALLR_a_Index[u_Slot] != 0u)
+  {
+    // Known caller gets the new route
+    CALLR_a_Callers[CALLR_a_Index[u_Slot] - 1u] = t_Caller;
+    return CALLR_OK;
+  }
+  if(CALLR_u_Callers >= CALLR_CAPACITY)
+  {
+    return CALLR_ERROR_FULL;
+  }
+  CALLR_a_Callers[CALLR_u_Callers] = t_Caller;
+  CALLR_u_Callers++;
+  CALLR_a_Index[u_Slot] = CALLR_u_Callers;
+  return CALLR_OK;
+}
+
+e_CALLR_Status CALLR_e_Remove(const uint8_t *p_Number)
+{
+  const t_CALLR_Caller *p_Caller = CALLR_p_Find(p_Number, (uint32_t)strlen((const char *)p_Number));
+
+  if(p_Caller == NULL)
+  {
+    return CALLR_ERROR_NOT_FOUND;
+  }
+  CALLR_u_Callers--;
+  CALLR_a_Callers[p_Caller - CALLR_a_Callers] = CALLR_a_Callers[CALLR_u_Callers];
+  v_BuildIndex();
+  return CALLR_OK;
+}
+
+e_CALLR_Status CALLR_e_Save()
+{
+  t_CALLR_Image t_Image;
+  uint32_t u_Length = (uint32_t)CALLR_u_Callers * sizeof(t_CALLR_Caller);
+
+  memset(&t_Image, 0, sizeof(t_Image));
+  t_Image.u_Magic = CALLR_IMAGE_MAGIC;
+  t_Image.u_Version = CALLR_IMAGE_VERSION;
+  t_Image.u_Count = CALLR_u_Callers;
+  t_Image.u_Crc = u_Crc32((const uint8_t *)CALLR_a_Callers, u_Length);
+
+  if((FLASHM_e_EraseSector(CALLR_FLASH_SECTOR) != FLASHM_OK) ||
+     (FLASHM_e_Program(CALLR_FLASH_ADDRESS + sizeof(t_CALLR_Image), (const uint8_t *)CALLR_a_Callers, u_Length) != FLASHM_OK) ||
+     (FLASHM_e_Program(CALLR_FLASH_ADDRESS, (const uint8_t *)&t_Image, sizeof(t_Image)) != FLASHM_OK))
+  {
+    return CALLR_ERROR_FLASH;
+  }
+  return CALLR_OK;
+}
+
+uint16_t CALLR_u_Count()
+{
+  return CALLR_u_Callers;
+}
+
+const uint8_t *CALLR_p_ReplyNumber(const t_CALLR_Caller *p_Caller)
+{
+  switch((e_CALLR_Route)p_Caller -> u_Route)
+  {
+    case CALLR_ROUTE_CALLER:
+        return p_Caller -> a_Number;
+    case CALLR_ROUTE_NUMBER:
+        return p_Caller -> a_Reply;
+    default:
+        return NULL;
+  }
+}
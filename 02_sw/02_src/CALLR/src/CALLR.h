@@ -0,0 +1,251 @@
+/// @file CALLR.h
+/// @brief Header file used for the table of authorised callers and the routing of their replies
+/// @author Aleksandra Petrovic
+///
+/// Numbers are kept in normalised E.164 form ("+" and up to 15 digits). A record is found through an open addressed
+/// index keyed by the FNV-1a hash of the normalised number, so looking up the number of a +CLIP line takes the same
+/// time for two callers or for CALLR_CAPACITY of them. The table is stored in a data sector of flash and loaded at
+/// start up, the callers of CALLR_cfg.h are used until a table is saved. SIM changes and saves the table when
+/// SIM800L_ADMIN_NUMBER sends an SMS starting with SIM800L_PROVISION_PREFIX.
+
+#ifndef CALLR_H_
+#define CALLR_H_
+
+#include <stdint.h>
+
+/// Largest number of callers in the table
+#define CALLR_CAPACITY (256u)
+/// Size of a buffer holding a normalised number, '+', 15 digits and NUL
+#define CALLR_NUMBER_SIZE (17u)
+
+/// This enum is used for selecting where the coordinates go when a caller rings
+typedef enum {
+  CALLR_ROUTE_CALLER,       ///< Coordinates are sent back to the number which rang
+  CALLR_ROUTE_NUMBER,       ///< Coordinates are sent to the reply number of the record
+  CALLR_ROUTE_NONE          ///< Caller is known but the call is ignored
+} e_CALLR_Route;
+
+/// This enum is used for reporting the result of a change of the table
+typedef enum {
+  CALLR_OK,                 ///< Table was changed or saved
+  CALLR_ERROR_NUMBER,       ///< Number or reply number can not be normalised
+  CALLR_ERROR_FULL,         ///< Table already holds CALLR_CAPACITY callers
+  CALLR_ERROR_NOT_FOUND,    ///< Number is not in the table
+  CALLR_ERROR_FLASH         ///< Sector could not be erased or programmed
+} e_CALLR_Status;
+
+/// This struct is used for one caller, it is also the layout of a record in flash
+typedef struct {
+  uint32_t u_Hash;                          ///< FNV-1a hash of a_Number, never 0
+  uint8_t a_Number[CALLR_NUMBER_SIZE];      ///< Normalised number of the caller
+  uint8_t a_Reply[CALLR_NUMBER_SIZE];       ///< Normalised reply number used with CALLR_ROUTE_NUMBER
+  uint8_t u_Route;                          ///< e_CALLR_Route stored in one byte
+} t_CALLR_Caller;
+
+/// @brief Function used for loading the table and building its index
+///
+/// @pre Flash must be readable, on the host SIMR_v_Init must be done
+/// @post CALLR_p_Find can be used
+/// @param None
+///
+/// @return None
+///
+/// @globals CALLR_a_Callers, CALLR_u_Callers, CALLR_a_Index
+///
+/// @InOutCorelation Table stored in CALLR_FLASH_SECTOR is used when its magic, version, count and CRC-32 are
+///                  correct, otherwise the callers of CALLR_t_Defaults are added.
+/// @callsequence
+///   @startuml "CALLR_v_Init.png"
+///     title "Sequence diagram for function CALLR_v_Init"
+///     -> CALLR: CALLR_v_Init()
+///     CALLR++
+///       opt if stored table is valid
+///         rnote over CALLR: Records are copied from flash.
+///         CALLR -> CALLR: v_BuildIndex()
+///       else else
+///         loop for each default caller
+///           CALLR -> CALLR: CALLR_e_Add(...)
+///         end
+///       end
+///     <- CALLR
+///     CALLR--
+///   @enduml
+
+void CALLR_v_Init(void);
+
+/// @brief Function used for bringing a number to the E.164 form used by the table
+///
+/// @pre None
+/// @post None
+/// @param const uint8_t *p_Text number as dialled or as reported by +CLIP, uint32_t u_Length,
+///        uint8_t *p_Number buffer of CALLR_NUMBER_SIZE bytes for the result
+///
+/// @return uint8_t length of the normalised number, 0 when p_Text is not a number
+///
+/// @globals None
+///
+/// @InOutCorelation Spaces, '-', '.', '(' and ')' are skipped. "+" and "00" start an international number, a single
+///                  leading '0' is replaced with CALLR_COUNTRY_CODE and other digits are taken as international.
+/// @callsequence
+///   @startuml "CALLR_u_Normalize.png"
+///     title "Sequence diagram for function CALLR_u_Normalize"
+///     -> CALLR: CALLR_u_Normalize(const uint8_t *p_Text, uint32_t u_Length, uint8_t *p_Number)
+///     CALLR++
+///       rnote over CALLR: Prefix is read, digits are copied after '+'.
+///     <- CALLR: Returns length
+///     CALLR--
+///   @enduml
+
+uint8_t CALLR_u_Normalize(const uint8_t *p_Text, uint32_t u_Length, uint8_t *p_Number);
+
+/// @brief Function used for finding a caller
+///
+/// @pre CALLR_v_Init must be done
+/// @post None
+/// @param const uint8_t *p_Text number in any format accepted by CALLR_u_Normalize, uint32_t u_Length
+///
+/// @return const t_CALLR_Caller * record of the caller, NULL when the caller is not known
+///
+/// @globals CALLR_a_Callers, CALLR_a_Index
+///
+/// @InOutCorelation Index is probed linearly from the slot selected by the hash until the record or an empty slot
+///                  is found. Records are compared only when their hashes are equal.
+/// @callsequence
+///   @startuml "CALLR_p_Find.png"
+///     title "Sequence diagram for function CALLR_p_Find"
+///     -> CALLR: CALLR_p_Find(const uint8_t *p_Text, uint32_t u_Length)
+///     CALLR++
+///       CALLR -> CALLR: CALLR_u_Normalize(...)
+///       CALLR -> CALLR: u_Hash(...)
+///       CALLR -> CALLR: u_Probe(...)
+///     <- CALLR: Returns record or NULL
+///     CALLR--
+///   @enduml
+
+const t_CALLR_Caller *CALLR_p_Find(const uint8_t *p_Text, uint32_t u_Length);
+
+/// @brief Function used for adding a caller or changing the route of a known one
+///
+/// @pre CALLR_v_Init must be done, called from the task which handles calls
+/// @post Caller is in the table, CALLR_e_Save keeps it after a reset
+/// @param const uint8_t *p_Number, e_CALLR_Route e_Route, const uint8_t *p_Reply NUL terminated, used with
+///        CALLR_ROUTE_NUMBER only
+///
+/// @return e_CALLR_Status result of the change
+///
+/// @globals CALLR_a_Callers, CALLR_u_Callers, CALLR_a_Index
+///
+/// @InOutCorelation Record is appended to the table and its slot is written into the index.
+/// @callsequence
+///   @startuml "CALLR_e_Add.png"
+///     title "Sequence diagram for function CALLR_e_Add"
+///     -> CALLR: CALLR_e_Add(const uint8_t *p_Number, e_CALLR_Route e_Route, const uint8_t *p_Reply)
+///     CALLR++
+///       CALLR -> CALLR: CALLR_u_Normalize(...)
+///       CALLR -> CALLR: u_Probe(...)
+///       opt if caller is not known
+///         rnote over CALLR: Record is appended and its slot is written.
+///       end
+///     <- CALLR: Returns e_CALLR_Status
+///     CALLR--
+///   @enduml
+
+e_CALLR_Status CALLR_e_Add(const uint8_t *p_Number, e_CALLR_Route e_Route, const uint8_t *p_Reply);
+
+/// @brief Function used for removing a caller
+///
+/// @pre CALLR_v_Init must be done, called from the task which handles calls
+/// @post Caller is not in the table
+/// @param const uint8_t *p_Number NUL terminated
+///
+/// @return e_CALLR_Status CALLR_OK or CALLR_ERROR_NOT_FOUND
+///
+/// @globals CALLR_a_Callers, CALLR_u_Callers, CALLR_a_Index
+///
+/// @InOutCorelation Last record takes the place of the removed one and the index is built again, so the table stays
+///                  dense and no deleted markers are left in the index.
+/// @callsequence
+///   @startuml "CALLR_e_Remove.png"
+///     title "Sequence diagram for function CALLR_e_Remove"
+///     -> CALLR: CALLR_e_Remove(const uint8_t *p_Number)
+///     CALLR++
+///       CALLR -> CALLR: u_Probe(...)
+///       rnote over CALLR: Last record is moved into the free place.
+///       CALLR -> CALLR: v_BuildIndex()
+///     <- CALLR: Returns e_CALLR_Status
+///     CALLR--
+///   @enduml
+
+e_CALLR_Status CALLR_e_Remove(const uint8_t *p_Number);
+
+/// @brief Function used for storing the table in flash
+///
+/// @pre FLASHM_v_Init must be done
+/// @post Table is loaded by CALLR_v_Init after a reset
+/// @param None
+///
+/// @return e_CALLR_Status CALLR_OK or CALLR_ERROR_FLASH
+///
+/// @globals CALLR_a_Callers, CALLR_u_Callers
+///
+/// @InOutCorelation Sector is erased, the records are programmed and the header with the CRC-32 is programmed last,
+///                  so a save cut by a reset leaves no valid table and the defaults are used.
+/// @callsequence
+///   @startuml "CALLR_e_Save.png"
+///     title "Sequence diagram for function CALLR_e_Save"
+///     -> CALLR: CALLR_e_Save()
+///     CALLR++
+///       CALLR -> FLASHM: FLASHM_e_EraseSector(CALLR_FLASH_SECTOR)
+///       CALLR -> FLASHM: FLASHM_e_Program(records)
+///       CALLR -> FLASHM: FLASHM_e_Program(header)
+///     <- CALLR: Returns e_CALLR_Status
+///     CALLR--
+///   @enduml
+
+e_CALLR_Status CALLR_e_Save(void);
+
+/// @brief Function used for reading the number of callers
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return uint16_t number of callers in the table
+///
+/// @globals CALLR_u_Callers
+///
+/// @InOutCorelation None
+/// @callsequence
+///   @startuml "CALLR_u_Count.png"
+///     title "Sequence diagram for function CALLR_u_Count"
+///     -> CALLR: CALLR_u_Count()
+///     CALLR++
+///     <- CALLR: Returns CALLR_u_Callers
+///     CALLR--
+///   @enduml
+
+uint16_t CALLR_u_Count(void);
+
+/// @brief Function used for selecting the number which gets the coordinates of a caller
+///
+/// @pre p_Caller must be returned by CALLR_p_Find
+/// @post None
+/// @param const t_CALLR_Caller *p_Caller
+///
+/// @return const uint8_t * number to send the coordinates to, NULL when the call is ignored
+///
+/// @globals None
+///
+/// @InOutCorelation Route of the record selects the number of the caller, the reply number or none.
+/// @callsequence
+///   @startuml "CALLR_p_ReplyNumber.png"
+///     title "Sequence diagram for function CALLR_p_ReplyNumber"
+///     -> CALLR: CALLR_p_ReplyNumber(const t_CALLR_Caller *p_Caller)
+///     CALLR++
+///     <- CALLR: Returns number or NULL
+///     CALLR--
+///   @enduml
+
+const uint8_t *CALLR_p_ReplyNumber(const t_CALLR_Caller *p_Caller);
+
+#endif /* CALLR_H_ */
@@ -25,8 +25,18 @@
 #define GPIOA_OSPEEDER (GPIOA_BASE + 0x0008UL)
 /// GPIOA->AFR register
 #define GPIOA_AFR0 (GPIOA_BASE + 0x0020UL)
+#if defined(HOST_BUILD)
+#include "SIMR.h"
+/// Definition of 32-bit registers, on the host every access goes through the simulated register file
+#define REG32(address) (*SIMR_p_Access((uint32_t)(address)))
+/// Definition of 8-bit registers, written through the simulated register file like REG32
+#define REG8(address) (*((volatile uint8_t *)SIMR_p_Access((uint32_t)(address))))
+#else
 /// Definition of 32-bit registers
 #define REG32(address) (*((volatile uint32_t *)address))
+/// Definition of 8-bit registers
+#define REG8(address) (*((volatile uint8_t *)(address)))
+#endif
 /// Definition of 16-bit registers
 #define REG16(address) (*((volatile uint16_t *) (address) ))
 /// Peripheral base address in the alias region
@@ -57,6 +67,8 @@
 #define GPIOD_OSPEEDER (GPIOD_BASE + 0x0008UL)
 /// GPIOD->AFR1 register
 #define GPIOD_AFR1 (GPIOD_BASE + 0x0024UL)
+/// GPIOB->IDR register
+#define GPIOB_IDR (GPIOB_BASE + 0x0010UL)
 /// GPIOB->ODR register
 #define GPIOB_ODR (GPIOB_BASE + 0x0014UL)
 /// GPIOD->AFR0 register
@@ -113,6 +125,66 @@
 #define EXTI_SWIER (EXTI_BASE + 0x0010UL)
 /// EXTI->PR register
 #define EXTI_PR (EXTI_BASE + 0x0014UL)
+/// USART2->CR3 register
+#define USART2_CR3 (USART2_BASE + 0x0014UL)
+/// USART3->CR3 register
+#define USART3_CR3 (USART3_BASE + 0x0014UL)
+/// DMA1->LISR register
+#define DMA1_LISR (DMA1_BASE + 0x0000UL)
+/// DMA1->HISR register
+#define DMA1_HISR (DMA1_BASE + 0x0004UL)
+/// DMA1->LIFCR register
+#define DMA1_LIFCR (DMA1_BASE + 0x0008UL)
+/// DMA1->HIFCR register
+#define DMA1_HIFCR (DMA1_BASE + 0x000CUL)
+/// DMA1_Stream1->CR register (USART3_RX)
+#define DMA1_S1CR (DMA1_BASE + 0x0028UL)
+/// DMA1_Stream1->NDTR register
+#define DMA1_S1NDTR (DMA1_BASE + 0x002CUL)
+/// DMA1_Stream1->PAR register
+#define DMA1_S1PAR (DMA1_BASE + 0x0030UL)
+/// DMA1_Stream1->M0AR register
+#define DMA1_S1M0AR (DMA1_BASE + 0x0034UL)
+/// DMA1_Stream5->CR register (USART2_RX)
+#define DMA1_S5CR (DMA1_BASE + 0x0088UL)
+/// DMA1_Stream5->NDTR register
+#define DMA1_S5NDTR (DMA1_BASE + 0x008CUL)
+/// DMA1_Stream5->PAR register
+#define DMA1_S5PAR (DMA1_BASE + 0x0090UL)
+/// DMA1_Stream5->M0AR register
+#define DMA1_S5M0AR (DMA1_BASE + 0x0094UL)
+/// TIM5 base of APB1 peripheral (32-bit timer)
+#define TIM5_BASE (APB1PERIPH_BASE + 0x0C00UL)
+/// TIM5->CR1 register
+#define TIM5_CR1 (TIM5_BASE + 0x0000UL)
+/// TIM5->EGR register
+#define TIM5_EGR (TIM5_BASE + 0x0014UL)
+/// TIM5->CNT register
+#define TIM5_CNT (TIM5_BASE + 0x0024UL)
+/// TIM5->PSC register
+#define TIM5_PSC (TIM5_BASE + 0x0028UL)
+/// TIM5->ARR register
+#define TIM5_ARR (TIM5_BASE + 0x002CUL)
+/// FLASH->ACR register
+#define FLASH_ACR (FLASH_R_BASE + 0x0000UL)
+/// FLASH->KEYR register
+#define FLASH_KEYR (FLASH_R_BASE + 0x0004UL)
+/// FLASH->SR register
+#define FLASH_SR (FLASH_R_BASE + 0x000CUL)
+/// FLASH->CR register
+#define FLASH_CR (FLASH_R_BASE + 0x0010UL)
+/// CoreDebug->DEMCR register
+#define COREDEBUG_DEMCR (0xE000EDFCUL)
+/// DWT->CTRL register
+#define DWT_CTRL (0xE0001000UL)
+/// DWT->CYCCNT register
+#define DWT_CYCCNT (0xE0001004UL)
+/// ITM->PORT[0] register, stimulus port n is 4 * n bytes further
+#define ITM_STIM0 (0xE0000000UL)
+/// ITM->TER register
+#define ITM_TER (0xE0000E00UL)
+/// ITM->TCR register
+#define ITM_TCR (0xE0000E80UL)
 
 //#else
 //#error "Platform configuration not defined!"
@@ -0,0 +1,31 @@
+/// @file FIXLOG_cfg.h
+/// @brief Contains configuration data used for the log of the last known fixes
+/// @author Aleksandra Petrovic
+
+#ifndef FIXLOG_CFG_H_
+#define FIXLOG_CFG_H_
+
+#include "FIXLOG.h"
+
+/// First of the sectors which hold the log, sector 23 holds the table of authorised callers
+#define FIXLOG_FIRST_SECTOR (21u)
+/// Number of sectors the log alternates between, one of them is kept erased for the next switch
+#define FIXLOG_SECTOR_COUNT (2u)
+/// Address of FIXLOG_FIRST_SECTOR, the sectors are left out of FLASH in the linker script
+#define FIXLOG_FLASH_ADDRESS (0x081A0000UL)
+/// Size of one sector of the log
+#define FIXLOG_SECTOR_SIZE (0x00020000UL)
+/// Number of records in a sector, the log switches to the other sector after every FIXLOG_SLOT_COUNT records
+#define FIXLOG_SLOT_COUNT ((uint32_t)(FIXLOG_SECTOR_SIZE / sizeof(t_FIXLOG_Record)))
+/// Sequence number read from a slot which was never programmed
+#define FIXLOG_ERASED (0xFFFFFFFFUL)
+/// Used when the log holds no valid record
+#define FIXLOG_NO_SLOT (0xFFFFFFFFUL)
+/// Shortest time in ms between two records, with 4096 records in a sector one is erased about once in 68 hours
+#define FIXLOG_PERIOD_MS (60000u)
+/// Initial value of CRC-16/CCITT protecting a record
+#define FIXLOG_CRC_INIT (0xFFFFu)
+/// Polynomial of CRC-16/CCITT
+#define FIXLOG_CRC_POLYNOMIAL (0x1021u)
+
+#endif /* FIXLOG_CFG_H_ */
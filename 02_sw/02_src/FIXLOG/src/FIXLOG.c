@@ -0,0 +1,350 @@
+/// @file FIXLOG.c
+/// @brief Main file used for the log of the last known fixes kept in flash
+/// @author Aleksandra Petrovic
+
+#include "FIXLOG_cfg.h"
+#include "FLASHM.h"
+#include <stddef.h>
+#include <string.h>
+
+/// Sector the log is appended to, counted from FIXLOG_FIRST_SECTOR
+static uint32_t FIXLOG_u_Sector = 0u;
+/// Flag that indicates the other sector is erased and the log can switch to it
+static boolean FIXLOG_b_SpareErased = b_FALSE;
+/// Slot in FIXLOG_u_Sector which is programmed next
+static uint32_t FIXLOG_u_NextSlot = 0u;
+/// Slot of the latest valid record counted over both sectors, FIXLOG_NO_SLOT when there is none
+static volatile uint32_t FIXLOG_u_LatestSlot = FIXLOG_NO_SLOT;
+/// Sequence number of the next record
+static uint32_t FIXLOG_u_Sequence = 0u;
+/// Fix handed over by TSK_Com
+static t_MSGM_Fix FIXLOG_t_Pending;
+/// Flag that indicates FIXLOG_t_Pending waits to be programmed
+static volatile boolean FIXLOG_b_Pending = b_FALSE;
+/// Task which programs the log, NULL when FIXLOG_v_Service is polled
+static TaskHandle_t FIXLOG_t_Writer = NULL;
+/// Sequence number of the MSGM_FIX_OWN record restored from the log, 0 when none was restored
+static uint32_t FIXLOG_u_RestoredSequence = 0u;
+/// Flag that indicates a fix was recorded since start up
+static boolean FIXLOG_b_Recorded = b_FALSE;
+/// Tick at which the last record was handed over
+static TickType_t FIXLOG_u_LastTick = 0u;
+
+/// @brief Function used for calculating the CRC of a record
+///
+/// @pre None
+/// @post None
+/// @param const t_FIXLOG_Record *p_Record
+///
+/// @return uint16_t CRC-16/CCITT of the fields before u_Crc
+///
+/// @globals None
+///
+/// @InOutCorelation None
+/// @callsequence
+///   @startuml "u_Crc16.png"
+///     title "Sequence diagram for function u_Crc16"
+///     -> FIXLOG: u_Crc16(const t_FIXLOG_Record *p_Record)
+///     FIXLOG++
+///     <- FIXLOG: Returns CRC
+///     FIXLOG--
+///   @enduml
+
+static uint16_t u_Crc16(const t_FIXLOG_Record *p_Record);
+
+static uint16_t u_Crc16(const t_FIXLOG_Record *p_Record)
+{
+  const uint8_t *p_Data = (const uint8_t *)p_Record;
+  uint16_t u_Crc = FIXLOG_CRC_INIT;
+
+  for(uint32_t u_Cnt = 0u; u_Cnt < offsetof(t_FIXLOG_Record, u_Crc); u_Cnt++)
+  {
+    u_Crc ^= (uint16_t)((uint16_t)p_Data[u_Cnt] << 8u);
+    for(uint8_t u_Bit = 0u; u_Bit < 8u; u_Bit++)
+    {
+      u_Crc = ((u_Crc & 0x8000u) != 0u) ? (uint16_t)((u_Crc << 1u) ^ FIXLOG_CRC_POLYNOMIAL) : (uint16_t)(u_Crc << 1u);
+    }
+  }
+  return u_Crc;
+}
+
+/// @brief Function used for getting the address of a slot
+///
+/// @pre None
+/// @post None
+/// @param uint32_t u_Slot slot counted over both sectors
+///
+/// @return uint32_t address of the slot in flash
+///
+/// @globals None
+///
+/// @InOutCorelation None
+/// @callsequence
+///   @startuml "u_Address.png"
+///     title "Sequence diagram for function u_Address"
+///     -> FIXLOG: u_Address(uint32_t u_Slot)
+///     FIXLOG++
+///     <- FIXLOG: Returns address
+///     FIXLOG--
+///   @enduml
+
+static uint32_t u_Address(uint32_t u_Slot);
+
+static uint32_t u_Address(uint32_t u_Slot)
+{
+  return (uint32_t)(FIXLOG_FLASH_ADDRESS + ((u_Slot / FIXLOG_SLOT_COUNT) * FIXLOG_SECTOR_SIZE) +
+                    ((u_Slot % FIXLOG_SLOT_COUNT) * sizeof(t_FIXLOG_Record)));
+}
+
+/// @brief Function used for reading a slot
+///
+/// @pre None
+/// @post p_Record holds a copy of the slot
+/// @param uint32_t u_Slot, t_FIXLOG_Record *p_Record
+///
+/// @return boolean b_TRUE when the slot holds a complete record
+///
+/// @globals None
+///
+/// @InOutCorelation Slot is copied first and the copy is checked, so an erase running in another task can not change
+///                  it between the check and the use.
+/// @callsequence
+///   @startuml "b_Valid.png"
+///     title "Sequence diagram for function b_Valid"
+///     -> FIXLOG: b_Valid(uint32_t u_Slot, t_FIXLOG_Record *p_Record)
+///     FIXLOG++
+///       FIXLOG -> FIXLOG: u_Address(u_Slot)
+///       FIXLOG -> FIXLOG: u_Crc16(p_Record)
+///     <- FIXLOG: Returns boolean
+///     FIXLOG--
+///   @enduml
+
+static boolean b_Valid(uint32_t u_Slot, t_FIXLOG_Record *p_Record);
+
+static boolean b_Valid(uint32_t u_Slot, t_FIXLOG_Record *p_Record)
+{
+  memcpy(p_Record, (const void *)(uintptr_t)u_Address(u_Slot), sizeof(t_FIXLOG_Record));
+  if((p_Record -> u_Sequence == FIXLOG_ERASED) || (p_Record -> u_Crc != u_Crc16(p_Record)))
+  {
+    return b_FALSE;
+  }
+  return b_TRUE;
+}
+
+/// @brief Function used for checking if a sector is erased
+///
+/// @pre None
+/// @post None
+/// @param uint32_t u_Sector counted from FIXLOG_FIRST_SECTOR
+///
+/// @return boolean b_TRUE when every word of the sector reads erased
+///
+/// @globals None
+///
+/// @InOutCorelation An erase cut by a reset leaves some words programmed, the whole sector is read so such a
+///                  sector is erased again before the log switches to it.
+/// @callsequence
+///   @startuml "b_Blank.png"
+///     title "Sequence diagram for function b_Blank"
+///     -> FIXLOG: b_Blank(uint32_t u_Sector)
+///     FIXLOG++
+///     <- FIXLOG: Returns boolean
+///     FIXLOG--
+///   @enduml
+
+static boolean b_Blank(uint32_t u_Sector);
+
+static boolean b_Blank(uint32_t u_Sector)
+{
+  const volatile uint32_t *p_Word =
+    (const volatile uint32_t *)(uintptr_t)(FIXLOG_FLASH_ADDRESS + (u_Sector * FIXLOG_SECTOR_SIZE));
+
+  for(uint32_t u_Cnt = 0u; u_Cnt < (FIXLOG_SECTOR_SIZE / sizeof(uint32_t)); u_Cnt++)
+  {
+    if(p_Word[u_Cnt] != FIXLOG_ERASED)
+    {
+      return b_FALSE;
+    }
+  }
+  return b_TRUE;
+}
+
+/// @brief Function used for putting a logged fix back into MSGM
+///
+/// @pre Scheduler is not started
+/// @post MSGM_FIX_OWN record holds the logged fix, FIXLOG_u_RestoredSequence is the sequence number of that record
+/// @param const t_FIXLOG_Record *p_Record
+///
+/// @return None
+///
+/// @globals MSGM_a_Fixes, FIXLOG_u_RestoredSequence
+///
+/// @InOutCorelation Logged fix is published as it is, only its sequence number is given by MSGM. The first fix of
+///                  the GPS publishes a newer record, which ends the staleness without a flag shared between tasks.
+/// @callsequence
+///   @startuml "v_Restore.png"
+///     title "Sequence diagram for function v_Restore"
+///     -> FIXLOG: v_Restore(const t_FIXLOG_Record *p_Record)
+///     FIXLOG++
+///       FIXLOG -> MSGM: MSGM_v_PublishFix(MSGM_FIX_OWN, ...)
+///       FIXLOG -> MSGM: MSGM_b_ReadFix(MSGM_FIX_OWN, ...)
+///     <- FIXLOG
+///     FIXLOG--
+///   @enduml
+
+static void v_Restore(const t_FIXLOG_Record *p_Record);
+
+static void v_Restore(const t_FIXLOG_Record *p_Record)
+{
+  t_MSGM_Fix t_Fix;
+
+  MSGM_v_PublishFix(MSGM_FIX_OWN, &p_Record -> t_Fix);
+  (void)MSGM_b_ReadFix(MSGM_FIX_OWN, &t_Fix);
+  FIXLOG_u_RestoredSequence = t_Fix.u_Sequence;
+}
+
+void FIXLOG_v_Init()
+{
+  t_FIXLOG_Record t_Record;
+  t_FIXLOG_Record t_Latest;
+  uint32_t a_Used[FIXLOG_SECTOR_COUNT];
+
+  FIXLOG_u_Sector = 0u;
+  FIXLOG_u_LatestSlot = FIXLOG_NO_SLOT;
+  FIXLOG_u_Sequence = 0u;
+  FIXLOG_u_RestoredSequence = 0u;
+  for(uint32_t u_Sector = 0u; u_Sector < FIXLOG_SECTOR_COUNT; u_Sector++)
+  {
+    a_Used[u_Sector] = 0u;
+    // Records are appended in order, the first slot which was never programmed ends the sector
+    for(uint32_t u_Cnt = 0u; u_Cnt < FIXLOG_SLOT_COUNT; u_Cnt++)
+    {
+      uint32_t u_Slot = (u_Sector * FIXLOG_SLOT_COUNT) + u_Cnt;
+
+      if(b_Valid(u_Slot, &t_Record) == b_TRUE)
+      {
+        if((FIXLOG_u_LatestSlot == FIXLOG_NO_SLOT) || (t_Record.u_Sequence >= FIXLOG_u_Sequence))
+        {
+          FIXLOG_u_Sector = u_Sector;
+          FIXLOG_u_LatestSlot = u_Slot;
+          FIXLOG_u_Sequence = t_Record.u_Sequence + 1u;
+          t_Latest = t_Record;
+        }
+      }
+      else if(t_Record.u_Sequence == FIXLOG_ERASED)
+      {
+        break;
+      }
+      a_Used[u_Sector] = u_Cnt + 1u;
+    }
+  }
+  FIXLOG_u_NextSlot = a_Used[FIXLOG_u_Sector];
+  FIXLOG_b_SpareErased = b_Blank((FIXLOG_u_Sector + 1u) % FIXLOG_SECTOR_COUNT);
+
+  if(FIXLOG_u_LatestSlot != FIXLOG_NO_SLOT)
+  {
+    v_Restore(&t_Latest);
+  }
+}
+
+void FIXLOG_v_SetWriter(TaskHandle_t t_Task)
+{
+  FIXLOG_t_Writer = t_Task;
+}
+
+void FIXLOG_v_Record(const t_MSGM_Fix *p_Fix)
+{
+  TickType_t u_Now = xTaskGetTickCount();
+
+  if((FIXLOG_b_Recorded == b_TRUE) && ((TickType_t)(u_Now - FIXLOG_u_LastTick) < pdMS_TO_TICKS(FIXLOG_PERIOD_MS)))
+  {
+    return;
+  }
+  FIXLOG_b_Recorded = b_TRUE;
+  FIXLOG_u_LastTick = u_Now;
+
+  // TSK_Log may be copying the previous record
+  taskENTER_CRITICAL();
+  FIXLOG_t_Pending = *p_Fix;
+  FIXLOG_b_Pending = b_TRUE;
+  taskEXIT_CRITICAL();
+  if(FIXLOG_t_Writer != NULL)
+  {
+    xTaskNotifyGive(FIXLOG_t_Writer);
+  }
+}
+
+void FIXLOG_v_Service()
+{
+  t_FIXLOG_Record t_Record;
+  uint32_t u_Slot = 0u;
+  uint32_t u_Spare = (FIXLOG_u_Sector + 1u) % FIXLOG_SECTOR_COUNT;
+
+  if(FIXLOG_b_Pending != b_TRUE)
+  {
+    return;
+  }
+  // Padding is programmed too, it is cleared so equal fixes give equal slots
+  memset(&t_Record, 0, sizeof(t_Record));
+  taskENTER_CRITICAL();
+  t_Record.t_Fix = FIXLOG_t_Pending;
+  FIXLOG_b_Pending = b_FALSE;
+  taskEXIT_CRITICAL();
+
+  if(FIXLOG_u_NextSlot >= FIXLOG_SLOT_COUNT)
+  {
+    // Spare is normally erased already, the full sector keeps the latest record either way
+    if((FIXLOG_b_SpareErased != b_TRUE) && (FLASHM_e_EraseSector((uint8_t)(FIXLOG_FIRST_SECTOR + u_Spare)) != FLASHM_OK))
+    {
+      return;
+    }
+    u_Spare = FIXLOG_u_Sector;
+    FIXLOG_u_Sector = (FIXLOG_u_Sector + 1u) % FIXLOG_SECTOR_COUNT;
+    FIXLOG_u_NextSlot = 0u;
+    FIXLOG_b_SpareErased = b_FALSE;
+  }
+  u_Slot = (FIXLOG_u_Sector * FIXLOG_SLOT_COUNT) + FIXLOG_u_NextSlot++;
+  t_Record.u_Sequence = FIXLOG_u_Sequence++;
+  t_Record.u_Crc = u_Crc16(&t_Record);
+  if(FLASHM_e_Program(u_Address(u_Slot), (const uint8_t *)&t_Record, sizeof(t_Record)) == FLASHM_OK)
+  {
+    FIXLOG_u_LatestSlot = u_Slot;
+  }
+
+  // Sector left behind is erased only once the latest record is in the sector the log continues in
+  if((FIXLOG_b_SpareErased != b_TRUE) && (FIXLOG_u_LatestSlot != FIXLOG_NO_SLOT) &&
+     ((FIXLOG_u_LatestSlot / FIXLOG_SLOT_COUNT) == FIXLOG_u_Sector) &&
+     (FLASHM_e_EraseSector((uint8_t)(FIXLOG_FIRST_SECTOR + u_Spare)) == FLASHM_OK))
+  {
+    FIXLOG_b_SpareErased = b_TRUE;
+  }
+}
+
+boolean FIXLOG_b_Get(uint16_t u_Age, t_FIXLOG_Record *p_Record)
+{
+  uint32_t u_Slot = FIXLOG_u_LatestSlot;
+
+  if(u_Slot == FIXLOG_NO_SLOT)
+  {
+    return b_FALSE;
+  }
+  // Slots before the first one of a sector continue at the end of the other sector
+  for(uint32_t u_Cnt = 0u; u_Cnt < (FIXLOG_SECTOR_COUNT * FIXLOG_SLOT_COUNT); u_Cnt++)
+  {
+    if(b_Valid(u_Slot, p_Record) == b_TRUE)
+    {
+      if(u_Age == 0u)
+      {
+        return b_TRUE;
+      }
+      u_Age--;
+    }
+    u_Slot = ((u_Slot == 0u) ? (FIXLOG_SECTOR_COUNT * FIXLOG_SLOT_COUNT) : u_Slot) - 1u;
+  }
+  return b_FALSE;
+}
+
+boolean FIXLOG_b_IsStale(const t_MSGM_Fix *p_Fix)
+{
+  return ((FIXLOG_u_RestoredSequence != 0u) && (p_Fix -> u_Sequence == FIXLOG_u_RestoredSequence)) ? b_TRUE : b_FALSE;
+}
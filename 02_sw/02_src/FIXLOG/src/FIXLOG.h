@@ -0,0 +1,194 @@
+/// @file FIXLOG.h
+/// @brief Header file used for the log of the last known fixes kept in flash
+/// @author Aleksandra Petrovic
+///
+/// A fix is recorded at most once in FIXLOG_PERIOD_MS. TSK_Com only hands the published fix over and wakes TSK_Log,
+/// the lowest priority task, which programs it, so neither parsing nor the LED refresh waits for flash. Records are appended to one of two data sectors until it is full,
+/// then the log continues in the other one, which spreads the wear over both sectors. A sector is erased only after
+/// the first record is in the other one, so the latest record stays in flash through every erase. At start up the
+/// latest record is put back as the current position and marked stale until the GPS reports a new fix.
+
+#ifndef FIXLOG_H_
+#define FIXLOG_H_
+
+#include "MSGM.h"
+
+/// This struct is used for one logged fix, it is also the layout of a slot in flash
+typedef struct {
+  uint32_t   u_Sequence;                      ///< Number of the record, FIXLOG_ERASED in an empty slot
+  t_MSGM_Fix t_Fix;                           ///< Fix as it was published, its u_Sequence is set again when restored
+  uint16_t   u_Crc;                           ///< CRC-16/CCITT of the fields before it
+} t_FIXLOG_Record;
+
+/// @brief Function used for finding the latest record and restoring the position from it
+///
+/// @pre Called before the scheduler is started
+/// @post MSGM_FIX_OWN record holds the latest logged fix, FIXLOG_b_IsStale returns b_TRUE for that record
+/// @param None
+///
+/// @return None
+///
+/// @globals FIXLOG_u_Sector, FIXLOG_b_SpareErased, FIXLOG_u_NextSlot, FIXLOG_u_LatestSlot, FIXLOG_u_Sequence,
+///          FIXLOG_u_RestoredSequence
+///
+/// @InOutCorelation Slots of each sector are scanned up to the first one which was never programmed. A slot with a
+///                  wrong CRC was cut by a reset while it was programmed, it is skipped. The sector holding the
+///                  latest record is continued, the other one is checked for a finished erase.
+/// @callsequence
+///   @startuml "FIXLOG_v_Init.png"
+///     title "Sequence diagram for function FIXLOG_v_Init"
+///     -> FIXLOG: FIXLOG_v_Init()
+///     FIXLOG++
+///       loop for each programmed slot of both sectors
+///         FIXLOG -> FIXLOG: b_Valid(...)
+///       end
+///       FIXLOG -> FIXLOG: b_Blank(...)
+///       opt if a valid record is found
+///         FIXLOG -> FIXLOG: v_Restore(...)
+///       end
+///     <- FIXLOG
+///     FIXLOG--
+///   @enduml
+
+void FIXLOG_v_Init(void);
+
+/// @brief Function used for setting the task which programs the log
+///
+/// @pre None
+/// @post FIXLOG_v_Record wakes t_Task when a record waits
+/// @param TaskHandle_t t_Task task calling FIXLOG_v_Service, NULL if the caller polls FIXLOG_v_Service
+///
+/// @return None
+///
+/// @globals FIXLOG_t_Writer
+///
+/// @InOutCorelation None
+/// @callsequence
+///   @startuml "FIXLOG_v_SetWriter.png"
+///     title "Sequence diagram for function FIXLOG_v_SetWriter"
+///     -> FIXLOG: FIXLOG_v_SetWriter(TaskHandle_t t_Task)
+///     FIXLOG++
+///     <- FIXLOG
+///     FIXLOG--
+///   @enduml
+
+void FIXLOG_v_SetWriter(TaskHandle_t t_Task);
+
+/// @brief Function used for handing a new fix over to the log
+///
+/// @pre Called by NMEA or UBX in TSK_Com with the fix just published into MSGM_FIX_OWN
+/// @post Record waits for FIXLOG_v_Service when FIXLOG_PERIOD_MS has passed since the last one
+/// @param const t_MSGM_Fix *p_Fix
+///
+/// @return None
+///
+/// @globals FIXLOG_t_Pending, FIXLOG_b_Pending, FIXLOG_t_Writer
+///
+/// @InOutCorelation The first fix after start up is always recorded. Flash is not touched, a record still waiting is
+///                  replaced by the newer one and the writer task is notified.
+/// @callsequence
+///   @startuml "FIXLOG_v_Record.png"
+///     title "Sequence diagram for function FIXLOG_v_Record"
+///     -> FIXLOG: FIXLOG_v_Record(const t_MSGM_Fix *p_Fix)
+///     FIXLOG++
+///       opt if FIXLOG_PERIOD_MS has passed
+///         rnote over FIXLOG: Fix is copied into FIXLOG_t_Pending.
+///         opt if a writer task is set
+///           FIXLOG -> FreeRTOS: xTaskNotifyGive(FIXLOG_t_Writer)
+///         end
+///       end
+///     <- FIXLOG
+///     FIXLOG--
+///   @enduml
+
+void FIXLOG_v_Record(const t_MSGM_Fix *p_Fix);
+
+/// @brief Function used for programming the record waiting in FIXLOG_t_Pending
+///
+/// @pre FLASHM_v_Init must be done, called from TSK_Log, the lowest priority task
+/// @post Record is in flash
+/// @param None
+///
+/// @return None
+///
+/// @globals FIXLOG_t_Pending, FIXLOG_b_Pending, FIXLOG_u_Sector, FIXLOG_b_SpareErased, FIXLOG_u_NextSlot,
+///          FIXLOG_u_LatestSlot, FIXLOG_u_Sequence
+///
+/// @InOutCorelation When the sector is full the record goes to the other sector, which was erased after the first
+///                  record of the full one. The sector left behind is erased once the record is programmed, the caller
+///                  sleeps during the erase. A failed erase is repeated with the next record. A slot which could not be
+///                  programmed is not used again until the next erase of its sector.
+/// @callsequence
+///   @startuml "FIXLOG_v_Service.png"
+///     title "Sequence diagram for function FIXLOG_v_Service"
+///     -> FIXLOG: FIXLOG_v_Service()
+///     FIXLOG++
+///       opt if a record is waiting
+///         opt if sector is full
+///           opt if the other sector is not erased
+///             FIXLOG -> FLASHM: FLASHM_e_EraseSector(...)
+///           end
+///           rnote over FIXLOG: Log continues in the other sector.
+///         end
+///         FIXLOG -> FIXLOG: u_Crc16(...)
+///         FIXLOG -> FLASHM: FLASHM_e_Program(...)
+///         opt if the record is the first one in the sector
+///           FIXLOG -> FLASHM: FLASHM_e_EraseSector(...)
+///         end
+///       end
+///     <- FIXLOG
+///     FIXLOG--
+///   @enduml
+
+void FIXLOG_v_Service(void);
+
+/// @brief Function used for reading a logged fix
+///
+/// @pre FIXLOG_v_Init must be done
+/// @post None
+/// @param uint16_t u_Age 0 for the latest record, 1 for the one before it..., t_FIXLOG_Record *p_Record
+///
+/// @return boolean b_TRUE when the record exists
+///
+/// @globals FIXLOG_u_LatestSlot
+///
+/// @InOutCorelation Slots are read backwards from the latest record into the other sector, invalid slots are
+///                  skipped. Only records since the last switch between the sectors can be read.
+/// @callsequence
+///   @startuml "FIXLOG_b_Get.png"
+///     title "Sequence diagram for function FIXLOG_b_Get"
+///     -> FIXLOG: FIXLOG_b_Get(uint16_t u_Age, t_FIXLOG_Record *p_Record)
+///     FIXLOG++
+///       loop until u_Age valid records are skipped
+///         FIXLOG -> FIXLOG: b_Valid(...)
+///       end
+///     <- FIXLOG: Returns boolean
+///     FIXLOG--
+///   @enduml
+
+boolean FIXLOG_b_Get(uint16_t u_Age, t_FIXLOG_Record *p_Record);
+
+/// @brief Function used for checking if an own fix was restored from the log
+///
+/// @pre None
+/// @post None
+/// @param const t_MSGM_Fix *p_Fix record read from MSGM_FIX_OWN
+///
+/// @return boolean b_TRUE when the record is the one restored at start up, so the GPS reported no fix since
+///
+/// @globals FIXLOG_u_RestoredSequence
+///
+/// @InOutCorelation Staleness is a property of the record itself, a reader which got the record from MSGM_b_ReadFix
+///                  needs no lock to match it with the flag.
+/// @callsequence
+///   @startuml "FIXLOG_b_IsStale.png"
+///     title "Sequence diagram for function FIXLOG_b_IsStale"
+///     -> FIXLOG: FIXLOG_b_IsStale(const t_MSGM_Fix *p_Fix)
+///     FIXLOG++
+///     <- FIXLOG: Returns b_TRUE if u_Sequence of the record is FIXLOG_u_RestoredSequence
+///     FIXLOG--
+///   @enduml
+
+boolean FIXLOG_b_IsStale(const t_MSGM_Fix *p_Fix);
+
+#endif /* FIXLOG_H_ */
@@ -0,0 +1,58 @@
+/// @file FLASHM_cfg.h
+/// @brief Contains configuration data used for erasing and programming the internal flash
+/// @author Aleksandra Petrovic
+
+#ifndef FLASHM_CFG_H_
+#define FLASHM_CFG_H_
+
+#include "Registers.h"
+#include "FLASHM.h"
+
+/// First key written to FLASH_KEYR to unlock FLASH_CR
+#define FLASHM_KEY1 (0x45670123UL)
+/// Second key written to FLASH_KEYR to unlock FLASH_CR
+#define FLASHM_KEY2 (0xCDEF89ABUL)
+
+/// FLASH_CR programming bit
+#define FLASHM_CR_PG (1UL << 0u)
+/// FLASH_CR sector erase bit
+#define FLASHM_CR_SER (1UL << 1u)
+/// Position of the sector number in FLASH_CR
+#define FLASHM_CR_SNB_POS (3u)
+/// Bit of the sector number which selects bank 2 (sectors 12 to 23)
+#define FLASHM_CR_SNB_BANK2 (0x10UL)
+/// FLASH_CR program size of one byte, usable at any supply voltage
+#define FLASHM_CR_PSIZE_X8 (0UL << 8u)
+/// FLASH_CR program size of 32 bits, erase is fastest with it at 2.7 V to 3.6 V (NUCLEO runs at 3.3 V)
+#define FLASHM_CR_PSIZE_X32 (2UL << 8u)
+/// FLASH_CR start bit of an erase
+#define FLASHM_CR_STRT (1UL << 16u)
+/// FLASH_CR lock bit, set by writing 1 and cleared by the key sequence
+#define FLASHM_CR_LOCK (1UL << 31u)
+
+/// FLASH_SR end of operation
+#define FLASHM_SR_EOP (1UL << 0u)
+/// FLASH_SR write protection error
+#define FLASHM_SR_WRPERR (1UL << 4u)
+/// FLASH_SR programming alignment error
+#define FLASHM_SR_PGAERR (1UL << 5u)
+/// FLASH_SR programming parallelism error
+#define FLASHM_SR_PGPERR (1UL << 6u)
+/// FLASH_SR programming sequence error
+#define FLASHM_SR_PGSERR (1UL << 7u)
+/// FLASH_SR busy flag
+#define FLASHM_SR_BSY (1UL << 16u)
+/// FLASH_SR flags of a failed operation, cleared by writing 1
+#define FLASHM_SR_ERRORS (FLASHM_SR_WRPERR | FLASHM_SR_PGAERR | FLASHM_SR_PGPERR | FLASHM_SR_PGSERR)
+
+/// FLASH_ACR data cache enable
+#define FLASHM_ACR_DCEN (1u << 10u)
+/// FLASH_ACR data cache reset, only while the data cache is disabled
+#define FLASHM_ACR_DCRST (1u << 12u)
+
+/// Number of sectors of STM32F439ZI (two banks of 12)
+#define FLASHM_SECTOR_COUNT (24u)
+/// Number of sectors in one bank
+#define FLASHM_BANK_SECTORS (12u)
+
+#endif /* FLASHM_CFG_H_ */
@@ -0,0 +1,232 @@
+/// @file FLASHM.c
+/// @brief Main file used for erasing and programming sectors of the internal flash that hold data
+/// @author Aleksandra Petrovic
+
+#include "FLASHM_cfg.h"
+#include "MSGM.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/// Mutex which keeps erase and programming of different tasks apart
+static SemaphoreHandle_t FLASHM_t_Mutex = NULL;
+/// Memory of FLASHM_t_Mutex
+static StaticSemaphore_t FLASHM_t_MutexBuffer;
+
+/// @brief Function used for taking the flash interface and unlocking FLASH_CR
+///
+/// @pre None
+/// @post FLASH_CR can be written, error flags of an earlier operation are cleared
+/// @param None
+///
+/// @return None
+///
+/// @globals FLASHM_t_Mutex
+///
+/// @InOutCorelation Before the scheduler is started there is nothing to lock against, the key sequence is written
+///                  only when FLASH_CR is locked because a wrong sequence locks it until reset.
+/// @callsequence
+///   @startuml "v_Unlock.png"
+///     title "Sequence diagram for function v_Unlock"
+///     -> FLASHM: v_Unlock()
+///     FLASHM++
+///       opt if scheduler is running
+///         FLASHM -> FreeRTOS: xSemaphoreTake(FLASHM_t_Mutex, portMAX_DELAY)
+///       end
+///       opt if FLASH_CR is locked
+///         rnote over FLASHM: FLASHM_KEY1 and FLASHM_KEY2 are written to FLASH_KEYR.
+///       end
+///     <- FLASHM
+///     FLASHM--
+///   @enduml
+
+static void v_Unlock(void);
+
+static void v_Unlock(void)
+{
+  if((FLASHM_t_Mutex != NULL) && (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING))
+  {
+    (void)xSemaphoreTake(FLASHM_t_Mutex, portMAX_DELAY);
+  }
+  if((REG32(FLASH_CR) & FLASHM_CR_LOCK) != 0u)
+  {
+    REG32(FLASH_KEYR) = FLASHM_KEY1;
+    REG32(FLASH_KEYR) = FLASHM_KEY2;
+  }
+  REG32(FLASH_SR) = FLASHM_SR_ERRORS | FLASHM_SR_EOP;                // Flags are cleared by writing 1
+}
+
+/// @brief Function used for locking FLASH_CR and giving the flash interface back
+///
+/// @pre v_Unlock must be called by the same task
+/// @post FLASH_CR is locked
+/// @param None
+///
+/// @return None
+///
+/// @globals FLASHM_t_Mutex
+///
+/// @InOutCorelation A stray write can not start an erase once FLASH_CR is locked again.
+/// @callsequence
+///   @startuml "v_Lock.png"
+///     title "Sequence diagram for function v_Lock"
+///     -> FLASHM: v_Lock()
+///     FLASHM++
+///       rnote over FLASHM: FLASH_CR is cleared and locked.
+///       opt if scheduler is running
+///         FLASHM -> FreeRTOS: xSemaphoreGive(FLASHM_t_Mutex)
+///       end
+///     <- FLASHM
+///     FLASHM--
+///   @enduml
+
+static void v_Lock(void);
+
+static void v_Lock(void)
+{
+  REG32(FLASH_CR) = FLASHM_CR_LOCK;
+  if((FLASHM_t_Mutex != NULL) && (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING))
+  {
+    (void)xSemaphoreGive(FLASHM_t_Mutex);
+  }
+}
+
+/// @brief Function used for waiting until the flash interface finishes an operation
+///
+/// @pre Operation was started
+/// @post BSY is clear
+/// @param boolean b_Sleep b_TRUE to sleep a tick between the polls while the scheduler runs
+///
+/// @return e_FLASHM_Status result taken from the error flags
+///
+/// @globals None
+///
+/// @InOutCorelation Erase takes long enough to give the processor to other tasks, programming of a byte does not.
+/// @callsequence
+///   @startuml "e_WaitReady.png"
+///     title "Sequence diagram for function e_WaitReady"
+///     -> FLASHM: e_WaitReady(boolean b_Sleep)
+///     FLASHM++
+///       loop while BSY is set
+///         opt if b_Sleep and scheduler is running
+///           FLASHM -> FreeRTOS: vTaskDelay(1)
+///         end
+///       end
+///     <- FLASHM: Returns e_FLASHM_Status
+///     FLASHM--
+///   @enduml
+
+static e_FLASHM_Status e_WaitReady(boolean b_Sleep);
+
+static e_FLASHM_Status e_WaitReady(boolean b_Sleep)
+{
+  uint32_t u_Status = 0u;
+
+  while(((u_Status = REG32(FLASH_SR)) & FLASHM_SR_BSY) != 0u)
+  {
+    if((b_Sleep == b_TRUE) && (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING))
+    {
+      vTaskDelay(1u);
+    }
+  }
+  if((u_Status & FLASHM_SR_WRPERR) != 0u)
+  {
+    return FLASHM_ERROR_PROTECTED;
+  }
+  if((u_Status & FLASHM_SR_ERRORS) != 0u)
+  {
+    return FLASHM_ERROR_PROGRAM;
+  }
+  return FLASHM_OK;
+}
+
+/// @brief Function used for resetting the data cache of the flash interface
+///
+/// @pre No flash operation is running
+/// @post Data cache holds no line of the erased sector
+/// @param None
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Cache can only be reset while it is disabled, it is enabled again when it was enabled before.
+/// @callsequence
+///   @startuml "v_FlushDataCache.png"
+///     title "Sequence diagram for function v_FlushDataCache"
+///     -> FLASHM: v_FlushDataCache()
+///     FLASHM++
+///       opt if data cache is enabled
+///         rnote over FLASHM: DCEN is cleared, DCRST is pulsed and DCEN is set.
+///       end
+///     <- FLASHM
+///     FLASHM--
+///   @enduml
+
+static void v_FlushDataCache(void);
+
+static void v_FlushDataCache(void)
+{
+  if((REG32(FLASH_ACR) & FLASHM_ACR_DCEN) != 0u)
+  {
+    REG32(FLASH_ACR) &= ~FLASHM_ACR_DCEN;
+    REG32(FLASH_ACR) |= FLASHM_ACR_DCRST;
+    REG32(FLASH_ACR) &= ~FLASHM_ACR_DCRST;
+    REG32(FLASH_ACR) |= FLASHM_ACR_DCEN;
+  }
+}
+
+void FLASHM_v_Init()
+{
+  FLASHM_t_Mutex = xSemaphoreCreateMutexStatic(&FLASHM_t_MutexBuffer);
+}
+
+e_FLASHM_Status FLASHM_e_EraseSector(uint8_t u_Sector)
+{
+  uint32_t u_Snb = u_Sector;
+  e_FLASHM_Status e_Status = FLASHM_OK;
+
+  if(u_Sector >= FLASHM_SECTOR_COUNT)
+  {
+    return FLASHM_ERROR_SECTOR;
+  }
+  // Sectors of bank 2 are numbered 0 to 11 with the bank bit set
+  if(u_Sector >= FLASHM_BANK_SECTORS)
+  {
+    u_Snb = FLASHM_CR_SNB_BANK2 | (uint32_t)(u_Sector - FLASHM_BANK_SECTORS);
+  }
+
+  v_Unlock();
+  REG32(FLASH_CR) = FLASHM_CR_PSIZE_X32 | FLASHM_CR_SER | (u_Snb << FLASHM_CR_SNB_POS);
+  REG32(FLASH_CR) |= FLASHM_CR_STRT;
+  e_Status = e_WaitReady(b_TRUE);
+  v_FlushDataCache();
+  v_Lock();
+  return e_Status;
+}
+
+e_FLASHM_Status FLASHM_e_Program(uint32_t u_Address, const uint8_t *p_Data, uint32_t u_Length)
+{
+  e_FLASHM_Status e_Status = FLASHM_OK;
+
+  if((u_Address < FLASH_BASE) || (u_Length > ((FLASH_END + 1u) - u_Address)))
+  {
+    return FLASHM_ERROR_SECTOR;
+  }
+
+  v_Unlock();
+  REG32(FLASH_CR) = FLASHM_CR_PSIZE_X8 | FLASHM_CR_PG;
+  for(uint32_t u_Cnt = 0u; (u_Cnt < u_Length) && (e_Status == FLASHM_OK); u_Cnt++)
+  {
+    volatile uint8_t *p_Flash = (volatile uint8_t *)(uintptr_t)(u_Address + u_Cnt);
+
+    *p_Flash = p_Data[u_Cnt];
+    e_Status = e_WaitReady(b_FALSE);
+    if((e_Status == FLASHM_OK) && (*p_Flash != p_Data[u_Cnt]))
+    {
+      e_Status = FLASHM_ERROR_VERIFY;
+    }
+  }
+  v_Lock();
+  return e_Status;
+}
@@ -0,0 +1,104 @@
+/// @file FLASHM.h
+/// @brief Header file used for erasing and programming sectors of the internal flash that hold data
+/// @author Aleksandra Petrovic
+///
+/// Data sectors are in bank 2 and the program runs from bank 1, so the CPU keeps fetching code while a sector of
+/// bank 2 is erased or programmed. The sectors used for data are left out of FLASH in the linker script.
+
+#ifndef FLASHM_H_
+#define FLASHM_H_
+
+#include "stm32f439xx.h"
+
+/// This enum is used for reporting the result of a flash operation
+typedef enum {
+  FLASHM_OK,                ///< Operation finished and the data reads back
+  FLASHM_ERROR_SECTOR,      ///< Sector number or address range is not valid
+  FLASHM_ERROR_PROTECTED,   ///< Sector is write protected
+  FLASHM_ERROR_PROGRAM,     ///< Flash interface reported an alignment, parallelism or sequence error
+  FLASHM_ERROR_VERIFY       ///< Programmed data does not read back, the bytes were not erased before
+} e_FLASHM_Status;
+
+/// @brief Function used for creating the lock of the flash interface
+///
+/// @pre None
+/// @post FLASHM_e_EraseSector and FLASHM_e_Program can be used from several tasks
+/// @param None
+///
+/// @return None
+///
+/// @globals FLASHM_t_Mutex
+///
+/// @InOutCorelation Function creates a statically allocated mutex, it is called before the scheduler is started.
+/// @callsequence
+///   @startuml "FLASHM_v_Init.png"
+///     title "Sequence diagram for function FLASHM_v_Init"
+///     -> FLASHM: FLASHM_v_Init()
+///     FLASHM++
+///       FLASHM -> FreeRTOS: xSemaphoreCreateMutexStatic(...)
+///     <- FLASHM
+///     FLASHM--
+///   @enduml
+
+void FLASHM_v_Init(void);
+
+/// @brief Function used for erasing one sector
+///
+/// @pre Sector must not hold code
+/// @post Every byte of the sector reads 0xFF
+/// @param uint8_t u_Sector sector number 0 to 23
+///
+/// @return e_FLASHM_Status result of the erase
+///
+/// @globals FLASHM_t_Mutex
+///
+/// @InOutCorelation Function unlocks FLASH_CR, starts the sector erase and waits for BSY to clear. A 128 KB sector
+///                  takes up to 2 s, while the scheduler runs the caller sleeps a tick between the polls. The data
+///                  cache is reset afterwards so old contents are not read from it.
+/// @callsequence
+///   @startuml "FLASHM_e_EraseSector.png"
+///     title "Sequence diagram for function FLASHM_e_EraseSector"
+///     -> FLASHM: FLASHM_e_EraseSector(uint8_t u_Sector)
+///     FLASHM++
+///       FLASHM -> FLASHM: v_Unlock()
+///       rnote over FLASHM: SER, SNB and PSIZE are set, then STRT.
+///       FLASHM -> FLASHM: e_WaitReady(b_TRUE)
+///       FLASHM -> FLASHM: v_FlushDataCache()
+///       FLASHM -> FLASHM: v_Lock()
+///     <- FLASHM: Returns e_FLASHM_Status
+///     FLASHM--
+///   @enduml
+
+e_FLASHM_Status FLASHM_e_EraseSector(uint8_t u_Sector);
+
+/// @brief Function used for programming erased flash
+///
+/// @pre Bytes at u_Address must be erased
+/// @post Data is stored at u_Address
+/// @param uint32_t u_Address first byte in flash, const uint8_t *p_Data, uint32_t u_Length number of bytes
+///
+/// @return e_FLASHM_Status result of the programming
+///
+/// @globals FLASHM_t_Mutex
+///
+/// @InOutCorelation Function programs one byte at a time, which has no alignment rules and works at any supply
+///                  voltage. A byte takes about 16 us, so the caller polls BSY without sleeping. Every byte is read
+///                  back after it is programmed.
+/// @callsequence
+///   @startuml "FLASHM_e_Program.png"
+///     title "Sequence diagram for function FLASHM_e_Program"
+///     -> FLASHM: FLASHM_e_Program(uint32_t u_Address, const uint8_t *p_Data, uint32_t u_Length)
+///     FLASHM++
+///       FLASHM -> FLASHM: v_Unlock()
+///       loop for each byte
+///         rnote over FLASHM: Byte is written with PG set.
+///         FLASHM -> FLASHM: e_WaitReady(b_FALSE)
+///       end
+///       FLASHM -> FLASHM: v_Lock()
+///     <- FLASHM: Returns e_FLASHM_Status
+///     FLASHM--
+///   @enduml
+
+e_FLASHM_Status FLASHM_e_Program(uint32_t u_Address, const uint8_t *p_Data, uint32_t u_Length);
+
+#endif /* FLASHM_H_ */
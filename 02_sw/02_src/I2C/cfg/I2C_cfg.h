@@ -61,6 +61,28 @@
 #define I2C1_SR1_BTF (1u << 2u)
 /// Data register not empty
 #define I2C1_SR1_RXNE (1u << 6u)
+/// Error interrupt enable
+#define I2C1_CR2_ITERREN (1u << 8u)
+/// Event interrupt enable
+#define I2C1_CR2_ITEVTEN (1u << 9u)
+/// Buffer interrupt enable (TXE and RXNE)
+#define I2C1_CR2_ITBUFEN (1u << 10u)
+/// Arbitration lost flag
+#define I2C1_SR1_ARLO (1u << 9u)
+/// Overrun/underrun flag
+#define I2C1_SR1_OVR (1u << 11u)
+/// All error flags handled by the error interrupt
+#define I2C1_SR1_ERRORS (I2C1_SR_BERR | I2C1_SR1_ARLO | I2C1_SR1_AF | I2C1_SR1_OVR)
+/// Read bit added to the device address
+#define I2C_READ_BIT (1u << 0u)
+/// NVIC priority of I2C1 interrupts, numerically not below configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY because they notify tasks
+#define I2C_IRQ_PRIORITY (6u)
+/// Number of transactions that can wait for the bus
+#define I2C_QUEUE_LENGTH (8u)
+/// Time in milliseconds after which a transaction is aborted
+#define I2C_TRANSFER_TIMEOUT_MS (10u)
+/// Longest wait in microseconds for the STOP bit before the next transaction is started
+#define I2C_STOP_WAIT_US (20u)
 /// System configuration controller clock enable
 #define RCC_APB2ENR_SYSCFGEN_ENABLE (1u << 14u)
 /// GPIOB PB1 set as input
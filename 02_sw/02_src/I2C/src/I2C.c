@@ -3,14 +3,72 @@
 /// @author Aleksandra Petrovic
 
 #include "I2C.h"
-#include "tim.h"
+#include "stm32f4xx_hal.h"
+#include "TIMEB.h"
+
+// Transactions waiting for the bus, the one at I2C_u_QueueHead is on the bus
+static t_I2C_Transaction * volatile I2C_a_Queue[I2C_QUEUE_LENGTH] = {NULL};
+// Position of the active transaction in the queue
+static volatile uint8_t I2C_u_QueueHead = 0u;
+// Number of queued transactions including the active one
+static volatile uint8_t I2C_u_QueueCount = 0u;
+// Position of the next byte of the active phase
+static volatile uint8_t I2C_u_Index = 0u;
+// 1 while the active transaction is reading, 0 while it is writing
+static volatile uint8_t I2C_u_ReadPhase = 0u;
+
+/// @brief Function used for resetting and configuring the I2C1 peripheral
+///
+/// @pre Clocks and pins are configured
+/// @post I2C1 is enabled, its interrupts are enabled in NVIC
+/// @param None
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Function resets I2C1 and programs timings, used at start up and to recover a stuck bus.
+/// @callsequence
+///   @startuml "v_ConfigurePeripheral.png"
+///     title "Sequence diagram for function v_ConfigurePeripheral"
+///     -> I2C: v_ConfigurePeripheral()
+///     I2C++
+///       rnote over I2C: Reset I2C1, program clock, rise time and enable it.
+///       rnote over I2C: Set priority of event and error interrupts and enable them.
+///     <- I2C
+///     I2C--
+///   @enduml
+
+static void v_ConfigurePeripheral(void);
+
+static void v_ConfigurePeripheral(void)
+{
+  // 3. Reset the I2C
+  // Reset the I2C
+  REG32(I2C1_CR1) |= I2C1_CR1_I2C_RESET;
+  // Normal operation
+  REG32(I2C1_CR1) &= ~I2C1_CR1_I2C_RESET;
 
-// Variable used for storing timer value when entering the function
-static uint32_t u_StartAddress = 0u;
-// Variable used for exiting function if max time has passed
-static uint32_t u_DelayedValue = 0u;
-// Variable used for exiting function if max time has passed and timer max value overflowed
-static uint32_t u_DelayedOverflowValue = 0u;
+  // 4. Program the peripheral input clock in I2C_CR2 register in order to generate correct timings
+  // PCLK1 frequency in MHz
+  REG32(I2C1_CR2) |= I2C1_PCLK1_FREQ;
+
+  // 5. Configure the clock control registers
+  REG32(I2C1_CCR) = I2C1_CCR_CONFIG;
+
+  // 6. Configure the rise time register
+  REG32(I2C1_TRISE) = I2C1_TRISE_CONFIG;
+
+  // 7. Program the I2C_CR1 register to enable the peripheral
+  // Enable I2C
+  REG32(I2C1_CR1) |= I2C1_CR1_PE;
+
+  // 8. Event and error interrupts notify tasks, so they must be below the FreeRTOS syscall priority
+  NVIC_SetPriority(I2C1_EV_IRQn, I2C_IRQ_PRIORITY);
+  NVIC_SetPriority(I2C1_ER_IRQn, I2C_IRQ_PRIORITY);
+  NVIC_EnableIRQ(I2C1_EV_IRQn);
+  NVIC_EnableIRQ(I2C1_ER_IRQn);
+}
 
 void I2C_v_Configure()
 {
@@ -38,300 +96,364 @@ void I2C_v_Configure()
   // Bits (7:6:5:4) = 0:1:0:0 --> AF4 for pin PB9
   REG32(GPIOB_AFR1) |= GPIOB_AFR_PIN_PB9;
 
-  // 3. Reset the I2C
-  // Reset the I2C
-  REG32(I2C1_CR1) |= I2C1_CR1_I2C_RESET;
-  // Normal operation
-  REG32(I2C1_CR1) &= ~I2C1_CR1_I2C_RESET;
-
-  // 4. Program the peripheral input clock in I2C_CR2 register in order to generate correct timings
-  // PCLK1 frequency in MHz
-  REG32(I2C1_CR2) |= I2C1_PCLK1_FREQ;
-
-  // 5. Configure the clock control registers
- REG32(I2C1_CCR) = I2C1_CCR_CONFIG;
-
-  // 6. Configure the rise time register
-  REG32(I2C1_TRISE) = I2C1_TRISE_CONFIG;
-
-  // 7. Program the I2C_CR1 register to enable the peripheral
-  // Enable I2C
-  REG32(I2C1_CR1) |= I2C1_CR1_PE;
+  v_ConfigurePeripheral();
 }
 
-void I2C_v_Start()
+/// @brief Function used for starting the transaction at the head of the queue
+///
+/// @pre Interrupts are disabled or function is called from I2C1 interrupt
+/// @post START condition is requested, the rest is done by I2C1 interrupts
+/// @param None
+///
+/// @return None
+///
+/// @globals I2C_a_Queue, I2C_u_Index, I2C_u_ReadPhase
+///
+/// @InOutCorelation Function prepares the phase of the transaction and enables I2C1 interrupts.
+/// @callsequence
+///   @startuml "v_StartNext.png"
+///     title "Sequence diagram for function v_StartNext"
+///     -> I2C: v_StartNext()
+///     I2C++
+///       opt if queue is not empty
+///         rnote over I2C: Read only transactions start in read phase.
+///         rnote over I2C: Enable ACK, interrupts and generate START.
+///       end
+///     <- I2C
+///     I2C--
+///   @enduml
+
+static void v_StartNext(void);
+
+static void v_StartNext(void)
 {
-  // Generate start condition
-  REG32(I2C1_CR1) |= I2C1_CR1_START;
-
-  u_StartAddress = __HAL_TIM_GET_COUNTER(&htim10);
-  u_DelayedValue = u_StartAddress + I2C_MAX_DELAY;
-  u_DelayedOverflowValue = TIMER_MAX_TIME - u_StartAddress + I2C_MAX_DELAY;
-
-  if(u_StartAddress <= TIMER_MAX_TIME - I2C_MAX_DELAY)
-  {
-	// Wait for SB (start bit) bit to set or max time to pass
-    while (!((REG32(I2C1_SR1) & I2C1_SR1_SB) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedValue)));
-  }
-  else
+  if(I2C_u_QueueCount == 0u)
   {
-	// Wait for SB (start bit) bit to set or max time to pass
-    while (!((REG32(I2C1_SR1) & I2C1_SR1_SB) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedOverflowValue)));
+    return;
   }
-}
+  t_I2C_Transaction *p_Transaction = I2C_a_Queue[I2C_u_QueueHead];
 
-void I2C_v_Stop()
-{
-  // Stop I2C
-  REG32(I2C1_CR1) |= I2C1_CR1_STOP;
+  I2C_u_Index = 0u;
+  I2C_u_ReadPhase = (p_Transaction -> u_TxLength == 0u) ? 1u : 0u;
+  // Enable the ACK
+  REG32(I2C1_CR1) |= I2C1_CR1_ACK;
+  // Enable event, buffer and error interrupts
+  REG32(I2C1_CR2) |= I2C1_CR2_ITEVTEN | I2C1_CR2_ITBUFEN | I2C1_CR2_ITERREN;
+  // Generate start condition
+  REG32(I2C1_CR1) |= I2C1_CR1_START;
 }
 
-uint8_t I2C_u_SendAddress(uint8_t u_Address)
+/// @brief Function used for finishing the active transaction and starting the next one
+///
+/// @pre Queue is not empty, interrupts are disabled or function is called from I2C1 interrupt
+/// @post Active transaction is removed from the queue, next one is started
+/// @param e_I2C_Status e_Status final state, BaseType_t *p_Woken NULL if the waiting task must not be notified
+///
+/// @return None
+///
+/// @globals I2C_a_Queue, I2C_u_QueueHead, I2C_u_QueueCount
+///
+/// @InOutCorelation Function stores the state, calls the callback, notifies the task and keeps the bus busy with the next transaction.
+/// @callsequence
+///   @startuml "v_Complete.png"
+///     title "Sequence diagram for function v_Complete"
+///     -> I2C: v_Complete(...)
+///     I2C++
+///       rnote over I2C: Disable I2C1 interrupts and remove the transaction from the queue.
+///       opt if callback is set
+///         I2C -> I2C: p_Callback(...)
+///       end
+///       opt if task is set
+///         I2C -> FreeRTOS: vTaskNotifyGiveFromISR(...)
+///       end
+///       loop until STOP is generated or I2C_STOP_WAIT_US passes
+///       end
+///       I2C -> I2C: v_StartNext()
+///     <- I2C
+///     I2C--
+///   @enduml
+
+static void v_Complete(e_I2C_Status e_Status, BaseType_t *p_Woken);
+
+static void v_Complete(e_I2C_Status e_Status, BaseType_t *p_Woken)
 {
-  // Send the address
-  REG32(I2C1_DR) = u_Address;
-  // Clear the BERR flag
-  REG32(I2C1_SR1) &= ~I2C1_SR_BERR;
+  t_I2C_Transaction *p_Transaction = I2C_a_Queue[I2C_u_QueueHead];
+  t_TIMEB_Deadline t_Deadline;
 
-  u_StartAddress = __HAL_TIM_GET_COUNTER(&htim10);
-  u_DelayedValue = u_StartAddress + I2C_MAX_DELAY;
-  u_DelayedOverflowValue = TIMER_MAX_TIME - u_StartAddress + I2C_MAX_DELAY;
+  // Disable I2C1 interrupts until the next transaction starts
+  REG32(I2C1_CR2) &= ~(I2C1_CR2_ITEVTEN | I2C1_CR2_ITBUFEN | I2C1_CR2_ITERREN);
+  I2C_a_Queue[I2C_u_QueueHead] = NULL;
+  I2C_u_QueueHead = (uint8_t)((I2C_u_QueueHead + 1u) % I2C_QUEUE_LENGTH);
+  I2C_u_QueueCount--;
 
-  if(u_StartAddress <= TIMER_MAX_TIME - I2C_MAX_DELAY)
+  p_Transaction -> e_Status = e_Status;
+  if(p_Transaction -> p_Callback != NULL)
   {
-	// Wait for ADDR bit to set or max time to pass
-    while (!((REG32(I2C1_SR1) & I2C1_SR1_ADDR) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedValue)));
+    p_Transaction -> p_Callback(p_Transaction);
   }
-  else
+  if((p_Woken != NULL) && (p_Transaction -> t_Task != NULL))
   {
-	// Wait for ADDR bit to set or max time to pass
-    while (!((REG32(I2C1_SR1) & I2C1_SR1_ADDR) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedOverflowValue)));
+    vTaskNotifyGiveFromISR(p_Transaction -> t_Task, p_Woken);
   }
-  // Clear the AF bit if it sets
-  REG32(I2C1_SR1) &= ~I2C1_SR1_AF;
-  // Read SR1 and SR2 to clear the ADDR bit
-  uint8_t u_Temp = REG32(I2C1_SR1) | REG32(I2C1_SR2);
-  // Enable the ACK
-  REG32(I2C1_CR1) |= I2C1_CR1_ACK;
-  return u_Temp;
+
+  // START must not be requested before the STOP of the previous transaction is on the bus, this takes a few microseconds
+  t_Deadline = TIMEB_t_DeadlineInUs(I2C_STOP_WAIT_US);
+  while(((REG32(I2C1_CR1) & I2C1_CR1_STOP) != 0u) && (TIMEB_b_DeadlineExpired(t_Deadline) == b_FALSE))
+  {
+  }
+  v_StartNext();
 }
 
-void I2C_v_Write(uint8_t u_Data)
+/// @brief Function used for removing a transaction that did not finish in time
+///
+/// @pre None
+/// @post Transaction is no longer referenced by the driver
+/// @param t_I2C_Transaction *p_Transaction
+///
+/// @return None
+///
+/// @globals I2C_a_Queue, I2C_u_QueueHead, I2C_u_QueueCount
+///
+/// @InOutCorelation Active transaction is stopped and I2C1 is reset, a queued one is taken out of the queue.
+/// @callsequence
+///   @startuml "v_Abort.png"
+///     title "Sequence diagram for function v_Abort"
+///     -> I2C: v_Abort(...)
+///     I2C++
+///       rnote over I2C: Interrupts are disabled while the queue is changed.
+///       opt if transaction is still pending
+///         opt if transaction is active
+///           rnote over I2C: Generate STOP and reset I2C1.
+///           I2C -> I2C: v_ConfigurePeripheral()
+///           I2C -> I2C: v_Complete(I2C_ERROR_TIMEOUT, NULL)
+///         else else
+///           rnote over I2C: Remove the transaction and move the ones behind it.
+///         end
+///       end
+///     <- I2C
+///     I2C--
+///   @enduml
+
+static void v_Abort(t_I2C_Transaction *p_Transaction);
+
+static void v_Abort(t_I2C_Transaction *p_Transaction)
 {
-  u_StartAddress = __HAL_TIM_GET_COUNTER(&htim10);
-  u_DelayedValue = u_StartAddress + I2C_MAX_DELAY;
-  u_DelayedOverflowValue = TIMER_MAX_TIME - u_StartAddress + I2C_MAX_DELAY;
+  uint32_t u_Primask = __get_PRIMASK();
+  __disable_irq();
 
-  if(u_StartAddress <= TIMER_MAX_TIME - I2C_MAX_DELAY)
+  if(p_Transaction -> e_Status == I2C_PENDING)
   {
-	// Wait for TXE bit to set or max time to pass
-    while (!((REG32(I2C1_SR1) & I2C1_SR1_TXE) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedValue)));
+    if((I2C_u_QueueCount != 0u) && (I2C_a_Queue[I2C_u_QueueHead] == p_Transaction))
+    {
+      // Release the bus and start from a clean peripheral state
+      REG32(I2C1_CR1) |= I2C1_CR1_STOP;
+      v_ConfigurePeripheral();
+      v_Complete(I2C_ERROR_TIMEOUT, NULL);
+    }
+    else
+    {
+      uint8_t u_Found = 0u;
+      for(uint8_t u_Cnt = 1u; u_Cnt < I2C_u_QueueCount; u_Cnt++)
+      {
+        uint8_t u_Slot = (uint8_t)((I2C_u_QueueHead + u_Cnt) % I2C_QUEUE_LENGTH);
+        if(I2C_a_Queue[u_Slot] == p_Transaction)
+        {
+          u_Found = 1u;
+        }
+        if((u_Found == 1u) && (u_Cnt + 1u < I2C_u_QueueCount))
+        {
+          I2C_a_Queue[u_Slot] = I2C_a_Queue[(u_Slot + 1u) % I2C_QUEUE_LENGTH];
+        }
+      }
+      if(u_Found == 1u)
+      {
+        I2C_u_QueueCount--;
+        I2C_a_Queue[(I2C_u_QueueHead + I2C_u_QueueCount) % I2C_QUEUE_LENGTH] = NULL;
+      }
+      p_Transaction -> e_Status = I2C_ERROR_TIMEOUT;
+    }
   }
-  else
+  __set_PRIMASK(u_Primask);
+}
+
+e_I2C_Status I2C_e_Submit(t_I2C_Transaction *p_Transaction)
+{
+  if((p_Transaction -> u_TxLength == 0u) && (p_Transaction -> u_RxLength == 0u))
   {
-	// Wait for TXE bit to set or max time to pass
-    while (!((REG32(I2C1_SR1) & I2C1_SR1_TXE) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedOverflowValue)));
+    p_Transaction -> e_Status = I2C_ERROR_INVALID;
+    return I2C_ERROR_INVALID;
   }
-  // Clear the AF bit if it sets
-  REG32(I2C1_SR1) &= ~I2C1_SR1_AF;
-  REG32(I2C1_DR) = u_Data;
-  // Clear the BERR flag
-  REG32(I2C1_SR1) &= ~I2C1_SR_BERR;
 
-  u_StartAddress = __HAL_TIM_GET_COUNTER(&htim10);
-  u_DelayedValue = u_StartAddress + I2C_MAX_DELAY;
-  u_DelayedOverflowValue = TIMER_MAX_TIME - u_StartAddress + I2C_MAX_DELAY;
+  // PRIMASK is used instead of a FreeRTOS critical section so transactions also work before the scheduler starts
+  uint32_t u_Primask = __get_PRIMASK();
+  __disable_irq();
 
-  if(u_StartAddress <= TIMER_MAX_TIME - I2C_MAX_DELAY)
+  if(I2C_u_QueueCount == I2C_QUEUE_LENGTH)
   {
-	// Wait for BTF(byte transfer finished) bit to set or max time to pass
-    while (!((REG32(I2C1_SR1) & I2C1_SR1_BTF) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedValue)));
+    __set_PRIMASK(u_Primask);
+    p_Transaction -> e_Status = I2C_ERROR_QUEUE_FULL;
+    return I2C_ERROR_QUEUE_FULL;
   }
-  else
+  p_Transaction -> e_Status = I2C_PENDING;
+  I2C_a_Queue[(I2C_u_QueueHead + I2C_u_QueueCount) % I2C_QUEUE_LENGTH] = p_Transaction;
+  I2C_u_QueueCount++;
+  // Bus is free, otherwise the transaction is started when the one before it finishes
+  if(I2C_u_QueueCount == 1u)
   {
-	// Wait for BTF(byte transfer finished) bit to set or max time to pass
-    while (!((REG32(I2C1_SR1) & I2C1_SR1_BTF) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedOverflowValue)));
+    v_StartNext();
   }
-  // Clear the AF bit if it sets
-  REG32(I2C1_SR1) &= ~I2C1_SR1_AF;
+
+  __set_PRIMASK(u_Primask);
+  return I2C_PENDING;
 }
 
-uint8_t I2C_u_Read(uint8_t u_Address, uint8_t *u_Buffer, uint8_t u_Size)
+e_I2C_Status I2C_e_Wait(t_I2C_Transaction *p_Transaction, uint32_t u_TimeoutMs)
 {
-  uint8_t u_Remaining = u_Size;
-  uint8_t u_Temp;
-  // 1. If only 1 byte needs to be read
-  if(u_Size == 1)
+  if((xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) && (p_Transaction -> t_Task != NULL))
   {
-    // 1.a) Write the slave address, and wait for the ADDR bit (bit 1 in SR1) to be set
-    // Send the address
-    REG32(I2C1_DR) = u_Address;
-    // Clear the BERR flag
-    REG32(I2C1_SR1) &= ~I2C1_SR_BERR;
+    TickType_t u_Start   = xTaskGetTickCount();
+    TickType_t u_Timeout = pdMS_TO_TICKS(u_TimeoutMs);
+    TickType_t u_Elapsed = 0u;
 
-    u_StartAddress = __HAL_TIM_GET_COUNTER(&htim10);
-    u_DelayedValue = u_StartAddress + I2C_MAX_DELAY;
-    u_DelayedOverflowValue = TIMER_MAX_TIME - u_StartAddress + I2C_MAX_DELAY;
-
-    if(u_StartAddress <= TIMER_MAX_TIME - I2C_MAX_DELAY)
+    // Notification can be left from an earlier transaction, so the state is checked after each wake up
+    while((p_Transaction -> e_Status == I2C_PENDING) && (u_Elapsed < u_Timeout))
     {
-      // Wait for ADDR bit to set or max time to pass
-      while(!((REG32(I2C1_SR1) & I2C1_SR1_ADDR) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedValue)));
+      (void)ulTaskNotifyTake(pdTRUE, u_Timeout - u_Elapsed);
+      u_Elapsed = xTaskGetTickCount() - u_Start;
     }
-    else
-    {
-      // Wait for ADDR bit to set or max time to pass
-      while(!((REG32(I2C1_SR1) & I2C1_SR1_ADDR) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedOverflowValue)));
-    }
-    // Clear the AF bit if it sets
-    REG32(I2C1_SR1) &= ~I2C1_SR1_AF;
-
-    // 1.b) the Acknowledge disable is made during EV6 (before ADDR flag is cleared) and the stop condition generation is made after EV6
-    // Clear the ACK bit
-    REG32(I2C1_CR1) &= ~I2C1_CR1_ACK;
-    // Read SR1 and SR2 to clear the ADDR bit.... EV6 condition
-    u_Temp = REG32(I2C1_SR1) | REG32(I2C1_SR2);
-    // Stop I2C
-    REG32(I2C1_CR1) |= I2C1_CR1_STOP;
-
-    // 1.c) Wait for the RxNE (receive buffer not empty) bit to set
-    u_StartAddress = __HAL_TIM_GET_COUNTER(&htim10);
-    u_DelayedValue = u_StartAddress + I2C_MAX_DELAY;
-    u_DelayedOverflowValue = TIMER_MAX_TIME - u_StartAddress + I2C_MAX_DELAY;
+  }
+  else
+  {
+    t_TIMEB_Deadline t_Deadline = TIMEB_t_DeadlineInUs(u_TimeoutMs * 1000u);
 
-    if(u_StartAddress <= TIMER_MAX_TIME - I2C_MAX_DELAY)
+    // Before the scheduler starts there is nothing else to run, so the state is polled
+    while((p_Transaction -> e_Status == I2C_PENDING) && (TIMEB_b_DeadlineExpired(t_Deadline) == b_FALSE))
     {
-      // Wait for RxNE to set or max time to pass
-      while(!((REG32(I2C1_SR1) & I2C1_SR1_RXNE) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedValue)));
     }
-    else
-    {
-      // Wait for RxNE to set or max time to pass
-      while(!((REG32(I2C1_SR1) & I2C1_SR1_RXNE) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedOverflowValue)));
-    }
-    // Clear the AF bit if it sets
-    REG32(I2C1_SR1) &= ~I2C1_SR1_AF;
-
-    // 1.d) Read the data from the DR
-    // Read the data from the data register
-    u_Buffer[u_Size - u_Remaining] = REG32(I2C1_DR);
-    // Clear the BERR flag
-    REG32(I2C1_SR1) &= ~I2C1_SR_BERR;
   }
-  // 2. If multiple bytes needs to be read
-  else
+
+  if(p_Transaction -> e_Status == I2C_PENDING)
+  {
+    v_Abort(p_Transaction);
+  }
+  return p_Transaction -> e_Status;
+}
+
+e_I2C_Status I2C_e_Transfer(t_I2C_Transaction *p_Transaction)
+{
+  p_Transaction -> t_Task = (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) ? xTaskGetCurrentTaskHandle() : NULL;
+
+  e_I2C_Status e_Status = I2C_e_Submit(p_Transaction);
+  if(e_Status == I2C_PENDING)
   {
-    // 2.a) Write the slave address, and wait for the ADDR bit (bit 1 in SR1) to be set
-    // Send the address
-    REG32(I2C1_DR) = u_Address;
-    // Clear the BERR flag
-    REG32(I2C1_SR1) &= ~I2C1_SR_BERR;
+    e_Status = I2C_e_Wait(p_Transaction, I2C_TRANSFER_TIMEOUT_MS);
+  }
+  return e_Status;
+}
 
-    u_StartAddress = __HAL_TIM_GET_COUNTER(&htim10);
-    u_DelayedValue = u_StartAddress + I2C_MAX_DELAY;
-    u_DelayedOverflowValue = TIMER_MAX_TIME - u_StartAddress + I2C_MAX_DELAY;
+void I2C1_EV_IRQHandler(void)
+{
+  BaseType_t x_HigherPriorityTaskWoken = pdFALSE;
+  uint32_t u_Status = REG32(I2C1_SR1);
+
+  if(I2C_u_QueueCount == 0u)
+  {
+    // Nothing is active, interrupts are left enabled only by an abort
+    REG32(I2C1_CR2) &= ~(I2C1_CR2_ITEVTEN | I2C1_CR2_ITBUFEN | I2C1_CR2_ITERREN);
+    return;
+  }
+  t_I2C_Transaction *p_Transaction = I2C_a_Queue[I2C_u_QueueHead];
 
-    if(u_StartAddress <= TIMER_MAX_TIME - I2C_MAX_DELAY)
+  if((u_Status & I2C1_SR1_SB) != 0u)
+  {
+    // Sending the address clears SB
+    REG32(I2C1_DR) = (uint32_t)(p_Transaction -> u_Address | I2C_u_ReadPhase);
+  }
+  else if((u_Status & I2C1_SR1_ADDR) != 0u)
+  {
+    if((I2C_u_ReadPhase == 1u) && (p_Transaction -> u_RxLength == 1u))
     {
-      // Wait for ADDR bit to set or max time to pass
-      while(!((REG32(I2C1_SR1) & I2C1_SR1_ADDR) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedValue)));
+      // Single byte is not acknowledged, ACK must be cleared before ADDR and STOP set right after it
+      REG32(I2C1_CR1) &= ~I2C1_CR1_ACK;
+      (void)REG32(I2C1_SR2);
+      REG32(I2C1_CR1) |= I2C1_CR1_STOP;
     }
     else
     {
-      // Wait for ADDR bit to set or max time to pass
-      while(!((REG32(I2C1_SR1) & I2C1_SR1_ADDR) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedOverflowValue)));
+      // Read SR2 after SR1 to clear the ADDR bit
+      (void)REG32(I2C1_SR2);
     }
-    // Clear the AF bit if it sets
-    REG32(I2C1_SR1) &= ~I2C1_SR1_AF;
-
-    //2. b) Clear the ADDR bit by reading the SR1 and SR2 Registers
-    REG32(I2C1_CR1) &= I2C1_CR1_ACK;
-    // Read SR1 and SR2 to clear the ADDR bit
-    u_Temp = REG32(I2C1_SR1) | REG32(I2C1_SR2);
-
-    while(u_Remaining > 2)
+  }
+  else if(I2C_u_ReadPhase == 0u)
+  {
+    if((u_Status & I2C1_SR1_TXE) != 0u)
     {
-      // 2.c) Wait for the RXNE (receive buffer not empty) bit to set
-      u_StartAddress = __HAL_TIM_GET_COUNTER(&htim10);
-      u_DelayedValue = u_StartAddress + I2C_MAX_DELAY;
-      u_DelayedOverflowValue = TIMER_MAX_TIME - u_StartAddress + I2C_MAX_DELAY;
-
-      if(u_StartAddress <= TIMER_MAX_TIME - I2C_MAX_DELAY)
+      if(I2C_u_Index < p_Transaction -> u_TxLength)
       {
-        // Wait for RxNE to set or max time to pass
-        while(!((REG32(I2C1_SR1) & I2C1_SR1_RXNE) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedValue)));
+        REG32(I2C1_DR) = p_Transaction -> p_TxData[I2C_u_Index];
+        I2C_u_Index++;
+      }
+      else if((u_Status & I2C1_SR1_BTF) != 0u)
+      {
+        if(p_Transaction -> u_RxLength != 0u)
+        {
+          // Repeated start for the read phase
+          I2C_u_ReadPhase = 1u;
+          I2C_u_Index = 0u;
+          REG32(I2C1_CR1) |= I2C1_CR1_ACK;
+          REG32(I2C1_CR2) |= I2C1_CR2_ITBUFEN;
+          REG32(I2C1_CR1) |= I2C1_CR1_START;
+        }
+        else
+        {
+          REG32(I2C1_CR1) |= I2C1_CR1_STOP;
+          v_Complete(I2C_OK, &x_HigherPriorityTaskWoken);
+        }
       }
       else
       {
-        // Wait for RxNE to set or max time to pass
-        while(!((REG32(I2C1_SR1) & I2C1_SR1_RXNE) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedOverflowValue)));
+        // Last byte is in the shift register, TXE would fire until BTF so only the event interrupt is kept
+        REG32(I2C1_CR2) &= ~I2C1_CR2_ITBUFEN;
       }
-      // Clear the AF bit if it sets
-      REG32(I2C1_SR1) &= ~I2C1_SR1_AF;
-
-      // 2.d) Read the data from the DR
-      // Copy the data into the buffer
-      u_Buffer[u_Size - u_Remaining] = REG32(I2C1_DR);
-      // Clear the BERR flag
-      REG32(I2C1_SR1) &= ~I2C1_SR_BERR;
-
-      // 2.e) Generate the acknowledgment by setting the ACK (bit 10 in CR1)
-      // Set the ACK bit to acknowledge the data received
-      REG32(I2C1_CR1) |= I2C1_CR1_ACK;
-      u_Remaining--;
     }
-
-    // Read the second last byte
-    u_StartAddress = __HAL_TIM_GET_COUNTER(&htim10);
-    u_DelayedValue = u_StartAddress + I2C_MAX_DELAY;
-    u_DelayedOverflowValue = TIMER_MAX_TIME - u_StartAddress + I2C_MAX_DELAY;
-
-    if(u_StartAddress <= TIMER_MAX_TIME - I2C_MAX_DELAY)
+  }
+  else if((u_Status & I2C1_SR1_RXNE) != 0u)
+  {
+    p_Transaction -> p_RxData[I2C_u_Index] = (uint8_t)REG32(I2C1_DR);
+    I2C_u_Index++;
+    if((uint8_t)(p_Transaction -> u_RxLength - I2C_u_Index) == 1u)
     {
-      // Wait for RxNE to set or max time to pass
-      while(!((REG32(I2C1_SR1) & I2C1_SR1_RXNE) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedValue)));
+      // Last byte is being received, it is not acknowledged and STOP follows it
+      REG32(I2C1_CR1) &= ~I2C1_CR1_ACK;
+      REG32(I2C1_CR1) |= I2C1_CR1_STOP;
     }
-    else
+    else if(I2C_u_Index == p_Transaction -> u_RxLength)
     {
-      // Wait for RxNE to set or max time to pass
-      while(!((REG32(I2C1_SR1) & I2C1_SR1_RXNE) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedOverflowValue)));
+      v_Complete(I2C_OK, &x_HigherPriorityTaskWoken);
     }
-    // Clear the AF bit if it sets
-    REG32(I2C1_SR1) &= ~I2C1_SR1_AF;
-    u_Buffer[u_Size - u_Remaining] = REG32(I2C1_DR);
-    // Clear the BERR flag
-    REG32(I2C1_SR1) &= ~I2C1_SR_BERR;
-
-    // 2.f) To generate the nonacknowledge pulse after the last received data byte, the ACK bit must be cleared just after reading the second last data byte (after second last RxNE event)
-    // Clear the ACK bit
-    REG32(I2C1_CR1) &= ~I2C1_CR1_ACK;
-
-    // 2.g) In order to generate the stop/restart condition, software must set the stop/start bit after reading the second last data byte (after the second last RxNE event)
-    // Stop I2C
-    REG32(I2C1_CR1) |= I2C1_CR1_STOP;
-    u_Remaining--;
+  }
 
-    // Read the last byte
-    u_StartAddress = __HAL_TIM_GET_COUNTER(&htim10);
-    u_DelayedValue = u_StartAddress + I2C_MAX_DELAY;
-    u_DelayedOverflowValue = TIMER_MAX_TIME - u_StartAddress + I2C_MAX_DELAY;
+  portYIELD_FROM_ISR(x_HigherPriorityTaskWoken);
+}
 
-    if(u_StartAddress <= TIMER_MAX_TIME - I2C_MAX_DELAY)
-    {
-      // Wait for RxNE to set or max time to pass
-      while(!((REG32(I2C1_SR1) & I2C1_SR1_RXNE) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedValue)));
-    }
-    else
-    {
-      // Wait for RxNE to set or max time to pass
-      while(!((REG32(I2C1_SR1) & I2C1_SR1_RXNE) || (__HAL_TIM_GET_COUNTER(&htim10) >= u_DelayedOverflowValue)));
-    }
-    // Clear the AF bit if it sets
-    REG32(I2C1_SR1) &= ~I2C1_SR1_AF;
-    // Copy the data into the buffer
-    u_Buffer[u_Size - u_Remaining] = REG32(I2C1_DR);
-    // Clear the BERR flag
-    REG32(I2C1_SR1) &= ~I2C1_SR_BERR;
+void I2C1_ER_IRQHandler(void)
+{
+  BaseType_t x_HigherPriorityTaskWoken = pdFALSE;
+  uint32_t u_Status = REG32(I2C1_SR1);
+
+  // Clear the error flags
+  REG32(I2C1_SR1) &= ~I2C1_SR1_ERRORS;
+
+  if(I2C_u_QueueCount != 0u)
+  {
+    // Release the bus
+    REG32(I2C1_CR1) |= I2C1_CR1_STOP;
+    v_Complete(((u_Status & I2C1_SR1_AF) != 0u) ? I2C_ERROR_NACK : I2C_ERROR_BUS, &x_HigherPriorityTaskWoken);
   }
-  return u_Temp;
+  else
+  {
+    REG32(I2C1_CR2) &= ~(I2C1_CR2_ITEVTEN | I2C1_CR2_ITBUFEN | I2C1_CR2_ITERREN);
+  }
+
+  portYIELD_FROM_ISR(x_HigherPriorityTaskWoken);
 }
@@ -7,16 +7,43 @@
 
 #include "stm32f439xx.h"
 #include "I2C_cfg.h"
-
-/// Maximum value timer can count
-#define TIMER_MAX_TIME 65536u
-/// Value of maximum delay
-#define I2C_MAX_DELAY  300u
+#include "FreeRTOS.h"
+#include "task.h"
+
+/// This enum is used for the state of a transaction
+typedef enum
+{
+  I2C_OK,                  ///< Transaction finished
+  I2C_PENDING,             ///< Transaction is queued or in progress
+  I2C_ERROR_NACK,          ///< Device did not acknowledge its address or data
+  I2C_ERROR_BUS,           ///< Bus error, arbitration lost or overrun
+  I2C_ERROR_TIMEOUT,       ///< Transaction did not finish in time and was aborted
+  I2C_ERROR_QUEUE_FULL,    ///< There was no free slot in the transaction queue
+  I2C_ERROR_INVALID        ///< Transaction has nothing to write or read
+} e_I2C_Status;
+
+struct t_I2C_Transaction_s;
+
+/// Function type of completion callbacks, called from interrupt context
+typedef void (*t_I2C_Callback)(struct t_I2C_Transaction_s *p_Transaction);
+
+/// Structure used to describe one transaction, it must stay valid until it is finished
+typedef struct t_I2C_Transaction_s
+{
+  uint8_t                u_Address;    ///< Address of the device shifted left by one (write address)
+  const uint8_t *        p_TxData;     ///< Bytes written first, usually register address followed by data
+  uint8_t                u_TxLength;   ///< Number of bytes to write, 0 for a read only transaction
+  uint8_t *              p_RxData;     ///< Buffer for bytes read after a repeated start
+  uint8_t                u_RxLength;   ///< Number of bytes to read, 0 for a write only transaction
+  t_I2C_Callback         p_Callback;   ///< Called when the transaction finishes, can be NULL
+  TaskHandle_t           t_Task;       ///< Task notified when the transaction finishes, can be NULL
+  volatile e_I2C_Status  e_Status;     ///< State of the transaction
+} t_I2C_Transaction;
 
 /// @brief Function used for configuring I2C protocol
 ///
 /// @pre None
-/// @post I2C1 is set for I2C communication
+/// @post I2C1 is set for I2C communication and its interrupts are enabled in NVIC
 /// @param None
 ///
 /// @return None
@@ -29,213 +56,103 @@
 ///     title "Sequence diagram for function I2C_v_Configure"
 ///     -> I2C: I2C_v_Configure()
 ///     I2C++
-///       rnote over I2C: Registers configured for I2C communication.
+///       rnote over I2C: Clocks and pins configured for I2C communication.
+///       I2C -> I2C: v_ConfigurePeripheral()
 ///     <- I2C
 ///     I2C--
 ///   @enduml
 
 void I2C_v_Configure();
 
-/// @brief Function used for starting I2C protocol
+/// @brief Function used for adding a transaction to the queue without waiting for it
 ///
 /// @pre I2C is configured
-/// @post I2C1 is ready for read and write operations
-/// @param None
+/// @post Transaction is started at once if the bus is free, otherwise right after the transactions before it
+/// @param t_I2C_Transaction *p_Transaction
 ///
-/// @return None
+/// @return e_I2C_Status I2C_PENDING if the transaction is queued, error otherwise
 ///
-/// @globals None
+/// @globals I2C_a_Queue transaction queue
 ///
-/// @InOutCorelation Function sets SB bit so START condition is generated.
+/// @InOutCorelation Function stores the descriptor, bytes are moved by I2C1 interrupts.
 /// @callsequence
-///   @startuml "I2C_v_Start.png"
-///     title "Sequence diagram for function I2C_v_Start"
-///     -> I2C: I2C_v_Start()
+///   @startuml "I2C_e_Submit.png"
+///     title "Sequence diagram for function I2C_e_Submit"
+///     -> I2C: I2C_e_Submit(...)
 ///     I2C++
-///       rnote over I2C: Generate start condition.
-///       opt if start time of the function is smaller than max counter time - value for delay
-///         loop Stay in loop until START bit sets or enough time passes.
-///         end
-///       else else
-///         loop Stay in loop until START bit sets or enough time passes.
-///         end
+///       opt if transaction is empty
+///         <- I2C: Returns I2C_ERROR_INVALID
 ///       end
-///     <- I2C
-///     I2C--
-///   @enduml
-
-void I2C_v_Start();
-
-/// @brief Function used for stopping I2C protocol
-///
-/// @pre I2C is started
-/// @post I2C1 is disabled for read and write operations
-/// @param None
-///
-/// @return None
-///
-/// @globals None
-///
-/// @InOutCorelation Function sets STOP bit to disable I2C protocol.
-/// @callsequence
-///   @startuml "I2C_v_Stop.png"
-///     title "Sequence diagram for function I2C_v_Stop"
-///     -> I2C: I2C_v_Stop()
-///     I2C++
-///       rnote over I2C: Sets STOP bit.
-///     <- I2C
-///     I2C--
-///   @enduml
-
-void I2C_v_Stop();
-
-/// @brief Function used for writing data into DR
-///
-/// @pre I2C is configured
-/// @post None
-/// @param uint8_t u_Data
-///
-/// @return None
-///
-/// @globals None
-///
-/// @InOutCorelation Function writes data into DR.
-/// @callsequence
-///   @startuml "I2C_v_Write.png"
-///     title "Sequence diagram for function I2C_v_Write"
-///     -> I2C: I2C_v_Write()
-///     I2C++
-///       opt if start time of the function is smaller than max counter time - value for delay
-///         loop Stay in loop until TXE bit sets or enough time passes.
-///         end
-///       else else
-///         loop Stay in loop until TXE bit sets or enough time passes.
-///         end
+///       rnote over I2C: Interrupts are disabled while the queue is changed.
+///       opt if queue is full
+///         <- I2C: Returns I2C_ERROR_QUEUE_FULL
 ///       end
-///       rnote over I2C: Clear AF and BERR bits and write data into DR.
-///       opt if start time of the function is smaller than max counter time - value for delay
-///         loop Stay in loop until BTF bit sets or enough time passes.
-///         end
-///       else else
-///         loop Stay in loop until BTF bit sets or enough time passes.
-///         end
+///       opt if bus is free
+///         I2C -> I2C: v_StartNext()
 ///       end
-///       rnote over I2C: Clear AF bit.
-///     <- I2C
+///     <- I2C: Returns I2C_PENDING
 ///     I2C--
 ///   @enduml
 
-void I2C_v_Write(uint8_t u_Data);
+e_I2C_Status I2C_e_Submit(t_I2C_Transaction *p_Transaction);
 
-/// @brief Function used for sending the address of slave devices or registers used for read and write operations
+/// @brief Function used for waiting until a submitted transaction finishes
 ///
-/// @pre I2C is configured
-/// @post I2C1 is ready for read and write operations
-/// @param uint8_t u_Address
+/// @pre Transaction is submitted, t_Task of the transaction is the calling task or NULL
+/// @post Transaction is finished or aborted, it can be reused
+/// @param t_I2C_Transaction *p_Transaction, uint32_t u_TimeoutMs
 ///
-/// @return uint8_t u_Temp
+/// @return e_I2C_Status final state of the transaction
 ///
-/// @globals None
+/// @globals I2C_a_Queue transaction queue
 ///
-/// @InOutCorelation Function sends address where data should be written to or read from.
+/// @InOutCorelation Task sleeps on its notification while the scheduler is running, before that the state is polled.
+///                  The task must not receive other direct to task notifications while it waits.
 /// @callsequence
-///   @startuml "I2C_v_SendAddress.png"
-///     title "Sequence diagram for function I2C_v_SendAddress"
-///     -> I2C: I2C_v_SendAddress()
+///   @startuml "I2C_e_Wait.png"
+///     title "Sequence diagram for function I2C_e_Wait"
+///     -> I2C: I2C_e_Wait(...)
 ///     I2C++
-///       rnote over I2C: Address is written into DR register.
-///       opt if start time of the function is smaller than max counter time - value for delay
-///         loop Stay in loop until ADDR bit sets or enough time passes.
-///         end
-///       else else
-///         loop Stay in loop until ADDR bit sets or enough time passes.
+///       loop while transaction is pending and time is left
+///         opt if scheduler is running and task is set
+///           I2C -> FreeRTOS: ulTaskNotifyTake(...)
+///         else else
+///           rnote over I2C: Poll the state against HAL tick
 ///         end
 ///       end
-///       rnote over I2C: Clear AF and ADDR bits and enable ACK.
-///     <- I2C:// Returns a uint8_t value that is read for clearing the ADDR bit.//
+///       opt if transaction is still pending
+///         I2C -> I2C: v_Abort(...)
+///       end
+///     <- I2C: Returns e_I2C_Status
 ///     I2C--
 ///   @enduml
 
-uint8_t I2C_u_SendAddress(uint8_t u_Address);
+e_I2C_Status I2C_e_Wait(t_I2C_Transaction *p_Transaction, uint32_t u_TimeoutMs);
 
-/// @brief Function used for reading data from DR
+/// @brief Function used for executing a transaction while the calling task sleeps
 ///
 /// @pre I2C is configured
-/// @post None
-/// @param uint8_t u_Address, uint8_t *u_Buffer, uint8_t u_Size
+/// @post Transaction is finished or aborted
+/// @param t_I2C_Transaction *p_Transaction
 ///
-/// @return u_Temp
+/// @return e_I2C_Status final state of the transaction
 ///
 /// @globals None
 ///
-/// @InOutCorelation Function reads data from DR.
+/// @InOutCorelation Function sets the calling task as the one to notify, submits the transaction and waits for it.
 /// @callsequence
-///   @startuml "I2C_v_Read.png"
-///     title "Sequence diagram for function I2C_v_Read"
-///     -> I2C: I2C_v_Read()
+///   @startuml "I2C_e_Transfer.png"
+///     title "Sequence diagram for function I2C_e_Transfer"
+///     -> I2C: I2C_e_Transfer(...)
 ///     I2C++
-///       rnote over I2C: u_Remainig gets value from u_Size
-///       opt if u_Size is 1
-///         rnote over I2C: Address written into DR register and BERR flag cleared.
-///         opt if start time of the function is smaller than max counter time - value for delay
-///           loop Stay in loop until ADDR bit sets or enough time passes.
-///           end
-///         else else
-///           loop Stay in loop until ADDR bit sets or enough time passes.
-///           end
-///         end
-///         rnote over I2C: Clear AF, ACK and ADDR bits and stop I2C.
-///         opt if start time of the function is smaller than max counter time - value for delay
-///           loop Stay in loop until RxNE bit sets or enough time passes.
-///           end
-///         else else
-///           loop Stay in loop until RxNE bit sets or enough time passes.
-///           end
-///         end
-///         rnote over I2C: Clear AF bit, read data from DR and clear BERR flag.
-///       else else
-///         rnote over I2C: Address written into DR register and BERR flag cleared.
-///         opt if start time of the function is smaller than max counter time - value for delay
-///           loop Stay in loop until ADDR bit sets or enough time passes.
-///           end
-///         else else
-///           loop Stay in loop until ADDR bit sets or enough time passes.
-///           end
-///         end
-///         rnote over I2C: Clear AF and ADDR bits and stop I2C.
-///         loop Stay in loop while u_Remaining is greater than 2
-///           opt if start time of the function is smaller than max counter time - value for delay
-///             loop Stay in loop until RxNE bit sets or enough time passes.
-///             end
-///           else else
-///             loop Stay in loop until RxNE bit sets or enough time passes.
-///             end
-///           end
-///           rnote over I2C: Copy the data into the buffer, clear BERR and ACK flags and decrement u_Remaining.
-///         end
-///         rnote over I2C: Read the second last byte
-///         opt if start time of the function is smaller than max counter time - value for delay
-///           loop Stay in loop until RxNE bit sets or enough time passes.
-///           end
-///         else else
-///           loop Stay in loop until RxNE bit sets or enough time passes.
-///           end
-///         end
-///         rnote over I2C: Clear AF, ACK and ADDR bits and stop I2C.
-///         rnote over I2C: Decrement u_Remaining to reach the last byte.
-///         opt if start time of the function is smaller than max counter time - value for delay
-///           loop Stay in loop until RxNE bit sets or enough time passes.
-///           end
-///         else else
-///           loop Stay in loop until RxNE bit sets or enough time passes.
-///           end
-///         end
-///         rnote over I2C: Clear AF, copy data into the buffer and clear BERR flag.
+///       I2C -> I2C: I2C_e_Submit(...)
+///       opt if transaction is queued
+///         I2C -> I2C: I2C_e_Wait(p_Transaction, I2C_TRANSFER_TIMEOUT_MS)
 ///       end
-///     <- I2C:// Returns a uint8_t value that is read for clearing the ADDR bit.//
+///     <- I2C: Returns e_I2C_Status
 ///     I2C--
 ///   @enduml
 
-uint8_t I2C_u_Read(uint8_t u_Address, uint8_t *u_Buffer, uint8_t u_Size);
+e_I2C_Status I2C_e_Transfer(t_I2C_Transaction *p_Transaction);
 
 #endif
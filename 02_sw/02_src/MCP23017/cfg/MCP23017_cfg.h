@@ -17,8 +17,12 @@
 #define MCP23017_GPIOA_INTERRUP_ENABLE 0xFF
 /// Sets default value which indicates if interrupt has occurred
 #define MCP23017_GPIOA_DEFVAL 0xFF
-/// Value used for initial configuration of GPIOA register
-#define MCP23017_GPIOA_IOCON 0x68
+/// Interrupt-on-change compares pins with their previous value, so both press and release raise INTA
+#define MCP23017_GPIOA_INTCON_PREVIOUS 0x00
+/// Value used for initial configuration of IOCON register (MIRROR, HAEN, SEQOP = 0 so the address pointer increments)
+#define MCP23017_GPIOA_IOCON 0x48
+/// Port B pins without interrupt, pull-up and inverted polarity
+#define MCP23017_GPIOB_NONE 0x00
 /// EXTI IMR value for PB1 pin
 #define EXTI_IMR_PB1 (1u << 1u)
 /// EXTI RTSR value for PB1 pin
@@ -27,6 +31,14 @@
 #define EXTI_FTSR_PB1 (1u << 1u)
 /// EXTI PR value set for PB1
 #define EXTI_PR_PB1 (1u << 1u)
+/// GPIOB IDR value of PB1 (INTA is asserted while it is low)
+#define GPIOB_IDR_PB1 (1u << 1u)
+/// NVIC priority of EXTI1, numerically not below configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY because it gives a semaphore
+#define MCP23017_EXTI_IRQ_PRIORITY 14u
+/// Time pins must be left to settle after INTA before they are sampled again, in milliseconds
+#define MCP23017_BUTTON_DEBOUNCE_MS 20u
+/// Number of button events that can wait in the queue
+#define MCP23017_BUTTON_QUEUE_LENGTH 4u
 
 /// Value that turns all LEDs off
 #define LEDS_OFF 0x00
@@ -66,6 +78,24 @@ t_LED_Range MCP23017_t_Ranges[] = {
 			{ 285, 345, LED8_ON, b_FALSE },
 };
 
+/// Values of registers IODIRA to GPPUB written in one burst at start up
+const uint8_t MCP23017_a_InitBlock[] = {
+    MCP23017_GPIOA_INPUT,            // IODIRA: GPIOA is input
+    MCP23017_GPIOB_OUTPUT,           // IODIRB: GPIOB is output
+    MCP23017_GPIOB_NONE,             // IPOLA
+    MCP23017_GPIOB_NONE,             // IPOLB
+    MCP23017_GPIOA_INTERRUP_ENABLE,  // GPINTENA: GPIOA input pins raise interrupt-on-change
+    MCP23017_GPIOB_NONE,             // GPINTENB
+    MCP23017_GPIOA_DEFVAL,           // DEFVALA: not used while INTCONA compares with the previous value
+    MCP23017_GPIOB_NONE,             // DEFVALB
+    MCP23017_GPIOA_INTCON_PREVIOUS,  // INTCONA: pin values are compared with their previous value
+    MCP23017_GPIOB_NONE,             // INTCONB
+    MCP23017_GPIOA_IOCON,            // IOCON
+    MCP23017_GPIOA_IOCON,            // IOCON (same register)
+    MCP23017_GPIOA_PULLUP,           // GPPUA: pull-up on GPIOA
+    MCP23017_GPIOB_NONE              // GPPUB
+};
+
 /// Used to determine the length of MCP23017_t_Ranges array
 uint16_t MCP23017_u_Length = sizeof(MCP23017_t_Ranges) / sizeof(MCP23017_t_Ranges[0]);
 
@@ -5,14 +5,44 @@
 #include "cmsis_os.h"
 #include "MCP23017_cfg.h"
 #include "SIM.h"
-#include "tim.h"
+#include "timers.h"
+#include "MONITOR.h"
+#include <string.h>
+
+/// States of the deferred button handling
+typedef enum {
+  MCP23017_BUTTON_IDLE,      ///< Waiting for INTA, EXTI line is enabled
+  MCP23017_BUTTON_SETTLING   ///< INTCAPA has been read, EXTI line is masked until the debounce timer expires
+} e_MCP23017_ButtonState;
 
 /// Counter of button presses
 static volatile uint32_t u_ButtonPressed_count   = 0;
 /// Counter of button releases
 static volatile uint32_t u_ButtonReleased_count  = 0;
-/// Flag that indicates if button is pressed
-static volatile boolean b_PressedButton		  	 = b_FALSE;
+/// Last debounced state of GPIOA, pins are active low
+static uint8_t MCP23017_u_StablePins             = MCP23017_GPIOA_DEFVAL;
+/// GPIOA captured by the expander at the interrupt, pins are active low
+static uint8_t MCP23017_u_CapturedPins           = MCP23017_GPIOA_DEFVAL;
+/// Current state of the deferred button handling
+static e_MCP23017_ButtonState MCP23017_e_ButtonState = MCP23017_BUTTON_IDLE;
+/// Given by EXTI1 interrupt and by the debounce timer
+static SemaphoreHandle_t MCP23017_t_ButtonSignal = NULL;
+/// Memory of MCP23017_t_ButtonSignal
+static StaticSemaphore_t MCP23017_t_ButtonSignalBuffer;
+/// One-shot timer which ends the debounce interval
+static TimerHandle_t MCP23017_t_DebounceTimer    = NULL;
+/// Memory of MCP23017_t_DebounceTimer
+static StaticTimer_t MCP23017_t_DebounceTimerBuffer;
+/// Queue of published button events
+static QueueHandle_t MCP23017_t_ButtonQueue      = NULL;
+/// Memory of MCP23017_t_ButtonQueue
+static StaticQueue_t MCP23017_t_ButtonQueueBuffer;
+/// Storage of MCP23017_t_ButtonQueue items
+static uint8_t MCP23017_a_ButtonQueueStorage[MCP23017_BUTTON_QUEUE_LENGTH * sizeof(t_MCP23017_ButtonEvent)];
+/// Copy of register values last written to the expander
+static uint8_t MCP23017_a_Shadow[MCP23017_REGISTER_COUNT] = {0u};
+/// Bit per register, set when its shadow value matches the expander
+static uint32_t MCP23017_u_ShadowValid = 0u;
 
 void MCP23017_v_EXTI1_Configuration()
 {
@@ -32,24 +62,59 @@ void MCP23017_v_EXTI1_Configuration()
   REG32(EXTI_RTSR) &= ~EXTI_RTSR_PB1;
   // Falling trigger event configuration bit of line 1 - enabled
   REG32(EXTI_FTSR) |= EXTI_FTSR_PB1;
-  // Setting NVIC interrupt priority
-  NVIC_SetPriority(EXTI1_IRQn, 14);
+  // Setting NVIC interrupt priority, it gives a semaphore so it must not be above configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+  NVIC_SetPriority(EXTI1_IRQn, MCP23017_EXTI_IRQ_PRIORITY);
   // Enable interrupt service routine
   NVIC_EnableIRQ(EXTI1_IRQn);
 }
 
 void EXTI1_IRQHandler(void)
 {
-  if(REG32(EXTI_PR) && EXTI_PR_PB1)
+  uint32_t u_Start = MONITOR_u_IsrEnter();
+  BaseType_t x_Woken = pdFALSE;
+
+  if((REG32(EXTI_PR) & EXTI_PR_PB1) != 0u)
   {
-	// Set SIM function as MakeCall when button has been pressed
-    t_SIM_Function * t_func = SIM_p_Function();
-  	t_func -> e_CurrentFunction = MakeCall;
-  	// Reset the button flag
-    b_PressedButton = b_FALSE;
-    // Clear the interrupt
-    REG32(EXTI_PR) &= EXTI_PR_PB1;
+    // Clear the interrupt, pending bits are cleared by writing 1
+    REG32(EXTI_PR) = EXTI_PR_PB1;
+    // Bounces are ignored until the task has read INTCAPA and the debounce timer expired
+    REG32(EXTI_IMR) &= ~EXTI_IMR_PB1;
+    if(MCP23017_t_ButtonSignal != NULL)
+    {
+      (void)xSemaphoreGiveFromISR(MCP23017_t_ButtonSignal, &x_Woken);
+    }
   }
+  MONITOR_v_IsrExit(MONITOR_ISR_EXTI1, u_Start);
+  portYIELD_FROM_ISR(x_Woken);
+}
+
+/// @brief Function called by the timer service task when the debounce interval ends
+///
+/// @pre Debounce timer must be started by MCP23017_v_ProcessButton
+/// @post TSK_MCP23017 is woken to sample the settled pins
+/// @param TimerHandle_t t_Timer
+///
+/// @return None
+///
+/// @globals MCP23017_t_ButtonSignal
+///
+/// @InOutCorelation Function gives the button semaphore, no bus access is done in the timer service task.
+/// @callsequence
+///   @startuml "v_DebounceExpired.png"
+///     title "Sequence diagram for function v_DebounceExpired"
+///     -> MCP23017: v_DebounceExpired(TimerHandle_t t_Timer)
+///     MCP23017++
+///       MCP23017 -> FreeRTOS: xSemaphoreGive(MCP23017_t_ButtonSignal)
+///     <- MCP23017
+///     MCP23017--
+///   @enduml
+
+static void v_DebounceExpired(TimerHandle_t t_Timer);
+
+static void v_DebounceExpired(TimerHandle_t t_Timer)
+{
+  (void)t_Timer;
+  (void)xSemaphoreGive(MCP23017_t_ButtonSignal);
 }
 
 /// @brief Function used for writing data
@@ -60,20 +125,16 @@ void EXTI1_IRQHandler(void)
 ///
 /// @return None
 ///
-/// @globals None
+/// @globals MCP23017_a_Shadow, MCP23017_u_ShadowValid
 ///
-/// @InOutCorelation MCP23017 function for writing data.
+/// @InOutCorelation MCP23017 function for writing data, shadow copy of the register is updated.
 /// @callsequence
 ///   @startuml "v_Write.png"
 ///     title "Sequence diagram for function v_Write"
 ///     -> MCP23017: v_Write(uint8_t u_Address, uint8_t u_Reg, uint8_t u_Data)
 ///     MCP23017++
-///       I2C -> MCP23017: I2C_v_Start()
-///       I2C -> MCP23017: I2C_u_SendAddress(u_Address)
-///       I2C -> MCP23017: I2C_v_Write(u_Reg)
-///       I2C -> MCP23017: I2C_v_Write(u_Data)
-///       I2C -> MCP23017: I2C_v_Stop()
-///       rnote over MCP23017: Parsed data is written into the register.
+///       MCP23017 -> I2C: I2C_e_Transfer(...)
+///       rnote over MCP23017: Task sleeps while register address and data are written by I2C interrupts.
 ///     <- MCP23017
 ///     MCP23017--
 ///   @enduml
@@ -82,16 +143,19 @@ static void v_Write(uint8_t u_Address, uint8_t u_Reg, uint8_t u_Data);
 
 static void v_Write(uint8_t u_Address, uint8_t u_Reg, uint8_t u_Data)
 {
-  // Start the I2C
-  I2C_v_Start();
-  // Send the address of the device
-  I2C_u_SendAddress(u_Address);
-  // Send the address of the register where data will be written to
-  I2C_v_Write(u_Reg);
-  // Send the data
-  I2C_v_Write(u_Data);
-  // Stop the I2C
-  I2C_v_Stop();
+  // Register address is followed by the data
+  uint8_t a_Data[2u] = {u_Reg, u_Data};
+  t_I2C_Transaction t_Transaction = {u_Address, a_Data, 2u, NULL, 0u, NULL, NULL, I2C_OK};
+
+  if((I2C_e_Transfer(&t_Transaction) == I2C_OK) && (u_Reg < MCP23017_REGISTER_COUNT))
+  {
+    MCP23017_a_Shadow[u_Reg] = u_Data;
+    MCP23017_u_ShadowValid |= (1u << u_Reg);
+  }
+  else if(u_Reg < MCP23017_REGISTER_COUNT)
+  {
+    MCP23017_u_ShadowValid &= ~(1u << u_Reg);
+  }
 }
 
 /// @brief Function used for reading the data
@@ -110,13 +174,8 @@ static void v_Write(uint8_t u_Address, uint8_t u_Reg, uint8_t u_Data)
 ///     title "Sequence diagram for function v_Read"
 ///     -> MCP23017: v_Read(uint8_t u_Address, uint8_t u_Reg, uint8_t *u_Buffer, uint8_t u_Size)
 ///     MCP23017++
-///       I2C -> MCP23017: I2C_v_Start()
-///       I2C -> MCP23017: I2C_u_SendAddress(u_Address)
-///       I2C -> MCP23017: I2C_v_Write(u_Reg)
-///       I2C -> MCP23017: I2C_v_Start()
-///       I2C -> MCP23017: I2C_u_Read(u_Address + 0x01, u_Buffer, u_Size)
-///       I2C -> MCP23017: I2C_v_Stop()
-///       rnote over MCP23017: Read data is stored into u_Bufer.
+///       MCP23017 -> I2C: I2C_e_Transfer(...)
+///       rnote over MCP23017: Task sleeps while register address is written and data is read after a repeated start.
 ///     <- MCP23017
 ///     MCP23017--
 ///   @enduml
@@ -125,37 +184,78 @@ static void v_Read(uint8_t u_Address, uint8_t u_Reg, uint8_t *u_Buffer, uint8_t
 
 static void v_Read(uint8_t u_Address, uint8_t u_Reg, uint8_t *u_Buffer, uint8_t u_Size)
 {
-  // Start the I2C
-  I2C_v_Start();
-  // Send the address of the device
-  I2C_u_SendAddress(u_Address);
-  // Send the address of the register where data will be read from
-  I2C_v_Write(u_Reg);
-  // Send the restart condition
-  I2C_v_Start();
-  // Read the data
-  I2C_u_Read(u_Address + 0x01, u_Buffer, u_Size);
-  // Stop the I2C
-  I2C_v_Stop();
+  // Register address is written, data is read after a repeated start
+  t_I2C_Transaction t_Transaction = {u_Address, &u_Reg, 1u, u_Buffer, u_Size, NULL, NULL, I2C_OK};
+
+  (void)I2C_e_Transfer(&t_Transaction);
 }
 
 void MCP23017_v_Init()
 {
-  // Set GPIOA as input
-  v_Write(MCP23017_ADDRESS << 1, MCP23017_IODIRA, MCP23017_GPIOA_INPUT);
-  // Enable pull-up on GPIOA
-  v_Write(MCP23017_ADDRESS << 1, MCP23017_GPPUA, MCP23017_GPIOA_PULLUP);
-  // Set GPIOB as output
-  v_Write(MCP23017_ADDRESS << 1, MCP23017_IODIRB, MCP23017_GPIOB_OUTPUT);
-
-  // Interrupt configuration
+  uint8_t u_Pins = MCP23017_GPIOA_DEFVAL;
+
+  // Objects are static so they can be created before the scheduler starts
+  MCP23017_t_ButtonSignal = xSemaphoreCreateBinaryStatic(&MCP23017_t_ButtonSignalBuffer);
+  MCP23017_t_DebounceTimer = xTimerCreateStatic("MCP23017", pdMS_TO_TICKS(MCP23017_BUTTON_DEBOUNCE_MS), pdFALSE, NULL,
+                                                v_DebounceExpired, &MCP23017_t_DebounceTimerBuffer);
+  MCP23017_t_ButtonQueue = xQueueCreateStatic(MCP23017_BUTTON_QUEUE_LENGTH, sizeof(t_MCP23017_ButtonEvent),
+                                              MCP23017_a_ButtonQueueStorage, &MCP23017_t_ButtonQueueBuffer);
+  // IOCON is written alone first, after an MCU reset the expander can still have sequential addressing disabled
   v_Write(MCP23017_ADDRESS << 1, MCP23017_IOCONA, MCP23017_GPIOA_IOCON);
-  // Write 1s into GPINTENA register to enable GPIO input pin for interrupt-on-change event
-  v_Write(MCP23017_ADDRESS << 1, MCP23017_GPINTENA, MCP23017_GPIOA_INTERRUP_ENABLE);
-  // Write 1s indicate that associated pin value is compared for interrupt-on-change
-  v_Write(MCP23017_ADDRESS << 1, MCP23017_INTCONA, MCP23017_GPIOA_INTERRUP_ENABLE);
-  // If value on pin differs from MCP23017_GPIOA_DEFVAL, an interrupt occurred
-  v_Write(MCP23017_ADDRESS << 1, MCP23017_DEFVALA, MCP23017_GPIOA_DEFVAL);
+  // Direction, polarity, interrupt-on-change and pull-up registers are one contiguous block
+  (void)MCP23017_e_WriteBlock(MCP23017_IODIRA, MCP23017_a_InitBlock, (uint8_t)sizeof(MCP23017_a_InitBlock));
+  // Reading GPIOA releases INTA if it was asserted during start up and gives the initial stable state
+  v_Read(MCP23017_ADDRESS << 1, MCP23017_GPIOA, &u_Pins, 1u);
+  MCP23017_u_StablePins = u_Pins;
+  REG32(EXTI_PR) = EXTI_PR_PB1;
+}
+
+e_I2C_Status MCP23017_e_WriteBlock(uint8_t u_Reg, const uint8_t *p_Data, uint8_t u_Length)
+{
+  uint8_t a_Buffer[MCP23017_REGISTER_COUNT + 1u];
+  uint8_t u_First = 0u;
+  uint8_t u_Last  = u_Length;
+
+  if(((uint16_t)u_Reg + u_Length) > MCP23017_REGISTER_COUNT)
+  {
+    return I2C_ERROR_INVALID;
+  }
+  // Registers at both ends which already hold the value are not sent
+  while((u_First < u_Last) && ((MCP23017_u_ShadowValid & (1u << (u_Reg + u_First))) != 0u) &&
+        (MCP23017_a_Shadow[u_Reg + u_First] == p_Data[u_First]))
+  {
+    u_First++;
+  }
+  while((u_Last > u_First) && ((MCP23017_u_ShadowValid & (1u << (u_Reg + u_Last - 1u))) != 0u) &&
+        (MCP23017_a_Shadow[u_Reg + u_Last - 1u] == p_Data[u_Last - 1u]))
+  {
+    u_Last--;
+  }
+  if(u_First == u_Last)
+  {
+    return I2C_OK;
+  }
+
+  // Address pointer increments after each byte, so one register address is followed by all values
+  a_Buffer[0] = (uint8_t)(u_Reg + u_First);
+  memcpy(&a_Buffer[1], &p_Data[u_First], u_Last - u_First);
+  t_I2C_Transaction t_Transaction = {(uint8_t)(MCP23017_ADDRESS << 1), a_Buffer, (uint8_t)(u_Last - u_First + 1u), NULL, 0u, NULL, NULL, I2C_OK};
+  e_I2C_Status e_Status = I2C_e_Transfer(&t_Transaction);
+
+  for(uint8_t u_Cnt = u_First; u_Cnt < u_Last; u_Cnt++)
+  {
+    if(e_Status == I2C_OK)
+    {
+      MCP23017_a_Shadow[u_Reg + u_Cnt] = p_Data[u_Cnt];
+      MCP23017_u_ShadowValid |= (1u << (u_Reg + u_Cnt));
+    }
+    else
+    {
+      // Part of the block may have been written, the registers are unknown until the next write
+      MCP23017_u_ShadowValid &= ~(1u << (u_Reg + u_Cnt));
+    }
+  }
+  return e_Status;
 }
 
 /// @brief Function used for reading button and turning LED on
@@ -174,8 +274,8 @@ void MCP23017_v_Init()
 ///     title "Sequence diagram for function v_TurnLED"
 ///     -> MCP23017: v_TurnLED(uint8_t u_Value)
 ///     MCP23017++
-///       MCP23017 -> MCP23017:v_Write(MCP23017_ADDRESS << 1, MCP23017_GPIOB, u_Value)
-///       rnote over MCP23017: Turns LED which values is passed.
+///       MCP23017 -> MCP23017: MCP23017_e_WriteBlock(MCP23017_GPIOB, &u_Value, 1u)
+///       rnote over MCP23017: Turns LED which values is passed, unchanged value is not sent.
 ///     <- MCP23017
 ///     MCP23017--
 ///   @enduml
@@ -184,57 +284,110 @@ static void v_TurnLED(uint8_t u_Value);
 
 static void v_TurnLED(uint8_t u_Value)
 {
-  // Write 1s for bits where LEDs should be turned on
-  v_Write(MCP23017_ADDRESS << 1, MCP23017_GPIOB, u_Value);
+  // Write 1s for bits where LEDs should be turned on, nothing is sent if the LEDs are already in that state
+  (void)MCP23017_e_WriteBlock(MCP23017_GPIOB, &u_Value, 1u);
 }
 
-/// @brief Function used for reading button
+/// @brief Function used for publishing debounced pin changes
 ///
-/// @pre Button must be configured
-/// @post None
-/// @param None
+/// @pre MCP23017_v_Init must be done
+/// @post One event per changed pin is in the button queue
+/// @param uint8_t u_Pins settled GPIOA value
 ///
-/// @return uint8_t u_Value
+/// @return None
 ///
-/// @globals None
+/// @globals MCP23017_u_StablePins, MCP23017_t_ButtonQueue, u_ButtonPressed_count, u_ButtonReleased_count
 ///
-/// @InOutCorelation Function reads the button and returns its value.
+/// @InOutCorelation Function compares settled pins with the last stable state. Pins are active low, so a cleared
+///                  bit is a press and a set bit is a release. When the queue is full the event is dropped.
 /// @callsequence
-///   @startuml "u_Button_Read.png"
-///     title "Sequence diagram for function u_Button_Read"
-///     -> MCP23017: u_Button_Read()
+///   @startuml "v_PublishChanges.png"
+///     title "Sequence diagram for function v_PublishChanges"
+///     -> MCP23017: v_PublishChanges(uint8_t u_Pins)
 ///     MCP23017++
-///       MCP23017 -> MCP23017: v_Read(MCP23017_ADDRESS << 1, MCP23017_GPIOA, &u_Value, 1);
-///       rnote over MCP23017: Read values are written into u_Value.
-///     <- MCP23017:// Returns a uint8_t value that is read.//
+///       loop for each pin that changed
+///         MCP23017 -> FreeRTOS: xQueueSend(MCP23017_t_ButtonQueue, ...)
+///       end
+///       rnote over MCP23017: u_Pins becomes the stable state.
+///     <- MCP23017
 ///     MCP23017--
 ///   @enduml
 
-static uint8_t u_Button_Read(void);
+static void v_PublishChanges(uint8_t u_Pins);
 
-static uint8_t u_Button_Read()
+static void v_PublishChanges(uint8_t u_Pins)
 {
-  // u_Value is used as buffer where read data will be written into
-  uint8_t u_Value = 0;
-  v_Read(MCP23017_ADDRESS << 1, MCP23017_GPIOA, &u_Value, 1);
-  return u_Value;
+  uint8_t u_Changed = u_Pins ^ MCP23017_u_StablePins;
+  t_MCP23017_ButtonEvent t_Event;
+
+  t_Event.u_Tick = xTaskGetTickCount();
+  for(uint8_t u_Pin = 1u; u_Pin != 0u; u_Pin <<= 1u)
+  {
+    if((u_Changed & u_Pin) != 0u)
+    {
+      t_Event.u_Pins = u_Pin;
+      if((u_Pins & u_Pin) == 0u)
+      {
+        t_Event.e_Action = MCP23017_BUTTON_PRESS;
+        u_ButtonPressed_count++;
+      }
+      else
+      {
+        t_Event.e_Action = MCP23017_BUTTON_RELEASE;
+        u_ButtonReleased_count++;
+      }
+      (void)xQueueSend(MCP23017_t_ButtonQueue, &t_Event, 0u);
+    }
+  }
+  MCP23017_u_StablePins = u_Pins;
 }
 
-void MCP23017_v_TurnLEDviaCoordinates()
+void MCP23017_v_ProcessButton(TickType_t u_Timeout)
 {
-  // Button is active low so here is only GPA7 active
-  uint8_t u_ButtonState = u_Button_Read();
-  t_SIM_Function * t_func = SIM_p_Function();
-  // When button has been pressed calculate bearing and turn correct LED on
-  if(u_ButtonState == BUTTON_PRESSED)
+  uint8_t u_Pins = 0u;
+
+  if(xSemaphoreTake(MCP23017_t_ButtonSignal, u_Timeout) != pdTRUE)
+  {
+    return;
+  }
+  if(MCP23017_e_ButtonState == MCP23017_BUTTON_IDLE)
   {
-    b_PressedButton = b_TRUE;
+    // Reading INTCAPA releases INTA, pins are sampled again when they settle
+    v_Read(MCP23017_ADDRESS << 1, MCP23017_INTCAPA, &MCP23017_u_CapturedPins, 1u);
+    MCP23017_e_ButtonState = MCP23017_BUTTON_SETTLING;
+    (void)xTimerStart(MCP23017_t_DebounceTimer, 0u);
   }
   else
   {
-    b_PressedButton = b_FALSE;
+    // Reading GPIOA also releases INTA asserted by bounces during the interval
+    v_Read(MCP23017_ADDRESS << 1, MCP23017_GPIOA, &u_Pins, 1u);
+    // A press already released when the pins settled is low only in INTCAPA, it is published as press and release
+    v_PublishChanges(MCP23017_u_CapturedPins & u_Pins);
+    v_PublishChanges(u_Pins);
+    MCP23017_e_ButtonState = MCP23017_BUTTON_IDLE;
+    REG32(EXTI_PR) = EXTI_PR_PB1;
+    REG32(EXTI_IMR) |= EXTI_IMR_PB1;
+    // A change after the GPIOA read holds INTA low without a new falling edge
+    if((REG32(GPIOB_IDR) & GPIOB_IDR_PB1) == 0u)
+    {
+      (void)xSemaphoreGive(MCP23017_t_ButtonSignal);
+    }
   }
-  if(t_func -> e_CurrentFunction == ReadMessage)
+}
+
+boolean MCP23017_b_GetButtonEvent(t_MCP23017_ButtonEvent *p_Event, TickType_t u_Timeout)
+{
+  if((MCP23017_t_ButtonQueue != NULL) && (xQueueReceive(MCP23017_t_ButtonQueue, p_Event, u_Timeout) == pdTRUE))
+  {
+    return b_TRUE;
+  }
+  return b_FALSE;
+}
+
+void MCP23017_v_TurnLEDviaCoordinates()
+{
+  // When coordinates have been received calculate bearing and turn correct LED on, SIM waits in idle afterwards
+  if(SIM_b_SwitchFunction(ReadMessage, IdleFunction) == b_TRUE)
   {
     // Used to calculate direction of the car
     uint16_t u_Bearing = CALCM_u_CalculateBearing();
@@ -252,13 +405,13 @@ void MCP23017_v_TurnLEDviaCoordinates()
         uint8_t u_LEDnum = MCP23017_t_Ranges[u_Count].u_LED;
         // Add value of LEDs with set flag to turn on all of them
         u_LEDs += u_LEDnum;
-        v_TurnLED(u_LEDs);
       }
       else
       {
         MCP23017_t_Ranges[u_Count].b_TurnedON = b_FALSE;
       }
     }
-    t_func -> e_CurrentFunction = IdleFunction;
+    // All matching LEDs are written at once
+    v_TurnLED(u_LEDs);
   }
 }
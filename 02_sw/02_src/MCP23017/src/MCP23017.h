@@ -35,10 +35,18 @@
 #define MCP23017_INTCONA 0x08
 /// IOCON register address
 #define MCP23017_IOCONA 0x0A
+/// GPPUB register address
+#define MCP23017_GPPUB 0x0D
+/// INTCAPA register address (GPIOA value captured when the interrupt occurred)
+#define MCP23017_INTCAPA 0x10
+/// Number of registers in BANK = 0 mode (IODIRA to OLATB)
+#define MCP23017_REGISTER_COUNT 0x16
 /// Value for MCP23017_u_delay
 #define MCP23017_DELAY 400u
 /// Value of pressed button
 #define BUTTON_PRESSED 0x7F
+/// GPIOA pin of the call button (GPA7)
+#define MCP23017_BUTTON_PIN 0x80
 
 /// This structure is used to connect proper LED with its range of coordinates
 typedef struct {
@@ -48,6 +56,19 @@ typedef struct {
   boolean b_TurnedON;	///< Field used for flag that indicates if the LED should be turned on
 } t_LED_Range;
 
+/// Kind of a button event
+typedef enum {
+  MCP23017_BUTTON_PRESS,    ///< Pin went low
+  MCP23017_BUTTON_RELEASE   ///< Pin went high
+} e_MCP23017_ButtonAction;
+
+/// Debounced change of one GPIOA pin
+typedef struct {
+  e_MCP23017_ButtonAction e_Action;  ///< Press or release
+  uint8_t u_Pins;                    ///< Mask of the pin which changed
+  TickType_t u_Tick;                 ///< Tick count when the change was confirmed
+} t_MCP23017_ButtonEvent;
+
 /// @brief Function used for configuring EXTI interrupt on line 1
 ///
 /// @pre MCP23017 GPIO expander must be configured
@@ -79,28 +100,117 @@ void MCP23017_v_EXTI1_Configuration(void);
 ///
 /// @return None
 ///
-/// @globals None
+/// @globals MCP23017_t_ButtonSignal, MCP23017_t_DebounceTimer, MCP23017_t_ButtonQueue, MCP23017_u_StablePins
 ///
-/// @InOutCorelation Function sets up registers for MCP23017 GPIO expander.
+/// @InOutCorelation Function creates button handling objects, sets up registers for MCP23017 GPIO expander and reads
+///                  GPIOA to release INTA and get the initial pin state.
 /// @callsequence
 ///   @startuml "MCP23017_v_Init.png"
 ///     title "Sequence diagram for function MCP23017_v_Init"
 ///     -> MCP23017: MCP23017_v_Init()
 ///     MCP23017++
-///       MCP23017 -> MCP23017: v_Write(MCP23017_ADDRESS << 1, MCP23017_IODIRA, MCP23017_GPIOA_INPUT)
-///       MCP23017 -> MCP23017: v_Write(MCP23017_ADDRESS << 1, MCP23017_GPPUA, MCP23017_GPIOA_PULLUP)
-///       MCP23017 -> MCP23017: v_Write(MCP23017_ADDRESS << 1, MCP23017_IODIRB, MCP23017_GPIOB_OUTPUT)
 ///       MCP23017 -> MCP23017: v_Write(MCP23017_ADDRESS << 1, MCP23017_IOCONA, MCP23017_GPIOA_IOCON)
-///       MCP23017 -> MCP23017: v_Write(MCP23017_ADDRESS << 1, MCP23017_GPINTENA, MCP23017_GPIOA_INTERRUP_ENABLE)
-///       MCP23017 -> MCP23017: v_Write(MCP23017_ADDRESS << 1, MCP23017_INTCONA, MCP23017_GPIOA_INTERRUP_ENABLE)
-///       MCP23017 -> MCP23017: v_Write(MCP23017_ADDRESS << 1, MCP23017_DEFVALA, MCP23017_GPIOA_DEFVAL)
-///       rnote over MCP23017: MCP23017 register configured for input and output and interrupt configuration is done via v_Write() function.
+///       rnote over MCP23017: Sequential addressing is enabled, the rest of the configuration is one burst.
+///       MCP23017 -> MCP23017: MCP23017_e_WriteBlock(MCP23017_IODIRA, MCP23017_a_InitBlock, ...)
+///       MCP23017 -> MCP23017: v_Read(MCP23017_ADDRESS << 1, MCP23017_GPIOA, &u_Pins, 1u)
 ///     <- MCP23017
 ///     MCP23017--
 ///   @enduml
 
 void MCP23017_v_Init(void);
 
+/// @brief Function used for writing a block of consecutive registers in one transaction
+///
+/// @pre MCP23017_v_Init must be done so sequential addressing (IOCON.SEQOP = 0) is enabled
+/// @post Registers hold the values, shadow copy is updated
+/// @param uint8_t u_Reg first register, const uint8_t *p_Data values, uint8_t u_Length number of registers
+///
+/// @return e_I2C_Status I2C_OK also when nothing had to be written
+///
+/// @globals MCP23017_a_Shadow copy of register values last written
+///
+/// @InOutCorelation Function compares the block with the shadow copy, unchanged registers at both ends are not
+///                  sent and a block without changes is not sent at all. Registers in between are sent in one burst.
+/// @callsequence
+///   @startuml "MCP23017_e_WriteBlock.png"
+///     title "Sequence diagram for function MCP23017_e_WriteBlock"
+///     -> MCP23017: MCP23017_e_WriteBlock(...)
+///     MCP23017++
+///       rnote over MCP23017: Skip registers at both ends whose shadow value is known and equal.
+///       opt if no register changed
+///         <- MCP23017: Returns I2C_OK
+///       end
+///       MCP23017 -> I2C: I2C_e_Transfer(...)
+///       opt if transfer succeeded
+///         rnote over MCP23017: Update the shadow copy.
+///       else else
+///         rnote over MCP23017: Mark the registers as unknown.
+///       end
+///     <- MCP23017: Returns e_I2C_Status
+///     MCP23017--
+///   @enduml
+
+e_I2C_Status MCP23017_e_WriteBlock(uint8_t u_Reg, const uint8_t *p_Data, uint8_t u_Length);
+
+/// @brief Function used for the deferred handling of MCP23017 interrupt-on-change
+///
+/// @pre MCP23017_v_Init and MCP23017_v_EXTI1_Configuration must be done
+/// @post Debounced pin changes are published in the button queue
+/// @param TickType_t u_Timeout longest time the caller is blocked
+///
+/// @return None
+///
+/// @globals MCP23017_t_ButtonSignal, MCP23017_e_ButtonState, MCP23017_u_CapturedPins
+///
+/// @InOutCorelation EXTI1 interrupt masks its line and wakes the caller, which reads INTCAPA once and starts the
+///                  debounce timer. When the timer expires GPIOA is read, changed pins are published and the EXTI
+///                  line is enabled again. A pin pressed in INTCAPA but released in GPIOA is published as a press
+///                  followed by a release, so a press shorter than the debounce interval is not lost. The I2C bus is
+///                  not used while no pin changes.
+/// @callsequence
+///   @startuml "MCP23017_v_ProcessButton.png"
+///     title "Sequence diagram for function MCP23017_v_ProcessButton"
+///     -> MCP23017: MCP23017_v_ProcessButton(TickType_t u_Timeout)
+///     MCP23017++
+///       MCP23017 -> FreeRTOS: xSemaphoreTake(MCP23017_t_ButtonSignal, u_Timeout)
+///       opt if interrupt was signalled
+///         MCP23017 -> MCP23017: v_Read(MCP23017_ADDRESS << 1, MCP23017_INTCAPA, ...)
+///         MCP23017 -> FreeRTOS: xTimerStart(MCP23017_t_DebounceTimer, 0)
+///       else if debounce timer expired
+///         MCP23017 -> MCP23017: v_Read(MCP23017_ADDRESS << 1, MCP23017_GPIOA, ...)
+///         MCP23017 -> MCP23017: v_PublishChanges(MCP23017_u_CapturedPins & u_Pins)
+///         MCP23017 -> MCP23017: v_PublishChanges(u_Pins)
+///         rnote over MCP23017: EXTI line 1 is enabled again.
+///       end
+///     <- MCP23017
+///     MCP23017--
+///   @enduml
+
+void MCP23017_v_ProcessButton(TickType_t u_Timeout);
+
+/// @brief Function used for receiving a published button event
+///
+/// @pre MCP23017_v_Init must be done
+/// @post Event is removed from the queue
+/// @param t_MCP23017_ButtonEvent *p_Event, TickType_t u_Timeout
+///
+/// @return boolean b_TRUE if an event was received
+///
+/// @globals MCP23017_t_ButtonQueue
+///
+/// @InOutCorelation Function waits up to u_Timeout for the next button event.
+/// @callsequence
+///   @startuml "MCP23017_b_GetButtonEvent.png"
+///     title "Sequence diagram for function MCP23017_b_GetButtonEvent"
+///     -> MCP23017: MCP23017_b_GetButtonEvent(t_MCP23017_ButtonEvent *p_Event, TickType_t u_Timeout)
+///     MCP23017++
+///       MCP23017 -> FreeRTOS: xQueueReceive(MCP23017_t_ButtonQueue, p_Event, u_Timeout)
+///     <- MCP23017: Returns boolean
+///     MCP23017--
+///   @enduml
+
+boolean MCP23017_b_GetButtonEvent(t_MCP23017_ButtonEvent *p_Event, TickType_t u_Timeout);
+
 /// @brief Function used for turning on the LED based on read coordinates
 ///
 /// @pre MCP23017 GPIO expander must be configured
@@ -111,32 +221,24 @@ void MCP23017_v_Init(void);
 ///
 /// @globals None
 ///
-/// @InOutCorelation Function reads the button state and based on coordinates turns the correct LED on.
+/// @InOutCorelation Function turns the correct LED on based on coordinates.
 /// @callsequence
 ///   @startuml "MCP23017_v_TurnLEDviaCoordinates.png"
 ///     title "Sequence diagram for function MCP23017_v_TurnLEDviaCoordinates"
 ///     -> MCP23017: MCP23017_v_TurnLEDviaCoordinates()
 ///     MCP23017++
-///       MCP23017 -> MCP23017: u_Button_Read()
-///       SIM -> MCP23017: SIM_t_Flag()
-///       opt if button is pressed
-///         rnote over MCP23017: Set b_PressedButton flag
-///       else else
-///         rnote over MCP23017: Reset b_PressedButton flag
-///       end
-///       opt if t_flag -> e_CurrentFunction is ReadMessage
+///       SIM -> MCP23017: SIM_b_SwitchFunction(ReadMessage, IdleFunction)
+///       opt if function was ReadMessage
 ///         CALCM -> MCP23017:  CALCM_u_CalculateBearing()
 ///         loop Goes through LED structure
 ///           opt if bearing is inside the range
 ///             rnote over MCP23017: Sets a flag and its LED value is added to local variable u_LEDs in order to turn all correct LEDs on.
-///             MCP23017 -> MCP23017: v_TurnLED(u_LEDs)
 ///         else else
 ///           rnote over MCP23017: Resets a flag which indicates if the LED is turned on
 ///         end
 ///         rnote over MCP23017: If bearing is not inside the range, its flag is set to false value.
 ///         end
-///       else else
-///         rnote over MCP23017: Sets t_flag -> e_CurrentFunction as IdleFunction
+///         MCP23017 -> MCP23017: v_TurnLED(u_LEDs)
 ///       end
 ///     MCP23017--
 ///     <- MCP23017
@@ -3,11 +3,37 @@
 /// @author Aleksandra Petrovic
 
 #include "MONITOR.h"
+#include "TIMEB.h"
 
 /// Counter of deactivations of on board LED
-uint8_t numberOfDetections  = 0u;
+uint32_t numberOfDetections  = 0u;
 /// Counter of activations of on board LED
-uint8_t numberOfActivations = 0u;
+uint32_t numberOfActivations = 0u;
+/// Statistics of the measured tasks
+static t_MONITOR_TaskStats MONITOR_a_Tasks[MONITOR_TASK_COUNT] = {0};
+/// Statistics of the measured interrupts
+static volatile t_MONITOR_IsrStats MONITOR_a_Isrs[MONITOR_ISR_COUNT] = {0};
+/// Buffer in which the binary dump is built
+static uint8_t MONITOR_a_Dump[MONITOR_DUMP_LENGTH];
+/// Time of the next periodic dump
+static t_TIMEB_Deadline MONITOR_t_DumpDeadline = {0u};
+/// b_TRUE when the code requested a dump
+static volatile boolean MONITOR_b_DumpRequest = b_FALSE;
+/// Character written by the debugger, the name is the one CMSIS and the debuggers use
+volatile int32_t ITM_RxBuffer = MONITOR_ITM_RX_EMPTY;
+/// Microsecond time at which the current sleep started
+static uint32_t MONITOR_u_SleepStart = 0u;
+/// Total time spent in WFI in microseconds, wraps
+static volatile uint32_t MONITOR_u_SleepUs = 0u;
+
+/// Values at the start of the residency measurement window
+static struct {
+  uint32_t u_Idle;     ///< Idle task run time
+  uint32_t u_Us;       ///< Microsecond time
+  uint32_t u_SleepUs;  ///< Total sleep time
+} MONITOR_t_Window = {0u, 0u, 0u};
+/// Trace of the interrupt latency
+static volatile t_MONITOR_LatencyTrace MONITOR_t_Latency = {0};
 
 void Task_LED_CP_Start()
 {
@@ -18,3 +44,370 @@ void Task_LED_CP_End()
 {
   numberOfDetections++;
 }
+
+void MONITOR_v_LatencySample(uint32_t u_Ticks)
+{
+  uint16_t u_Sample = (u_Ticks > 0xFFFFu) ? 0xFFFFu : (uint16_t)u_Ticks;
+
+  MONITOR_t_Latency.a_Samples[MONITOR_t_Latency.u_Index] = u_Sample;
+  MONITOR_t_Latency.u_Index = (MONITOR_t_Latency.u_Index + 1u) % MONITOR_LATENCY_TRACE_LENGTH;
+  MONITOR_t_Latency.u_Count++;
+  if(u_Sample > MONITOR_t_Latency.u_Max)
+  {
+    MONITOR_t_Latency.u_Max = u_Sample;
+  }
+}
+
+const t_MONITOR_LatencyTrace * MONITOR_p_GetLatencyTrace()
+{
+  return (const t_MONITOR_LatencyTrace *)&MONITOR_t_Latency;
+}
+
+void MONITOR_v_ResetLatency()
+{
+  NVIC_DisableIRQ(TIM2_IRQn);
+  MONITOR_t_Latency.u_Index = 0u;
+  MONITOR_t_Latency.u_Count = 0u;
+  MONITOR_t_Latency.u_Max = 0u;
+  NVIC_EnableIRQ(TIM2_IRQn);
+}
+
+void MONITOR_v_Init()
+{
+  REG32(COREDEBUG_DEMCR) |= DEMCR_TRCENA;                                    // Enable the DWT unit
+  REG32(DWT_CYCCNT) = 0u;
+  REG32(DWT_CTRL) |= DWT_CTRL_CYCCNTENA;                           // Start counting core cycles
+}
+
+uint32_t MONITOR_u_RunTimeCounter()
+{
+  // CYCCNT stops while the core is in WFI, TIM5 keeps counting so the sleep is charged to the idle task
+  return TIMEB_u_NowUs();
+}
+
+void MONITOR_v_RegisterTask(e_MONITOR_Task e_Task, TaskHandle_t t_Handle)
+{
+  MONITOR_a_Tasks[e_Task].t_Handle = t_Handle;
+}
+
+void MONITOR_v_TaskStart(e_MONITOR_Task e_Task)
+{
+  MONITOR_a_Tasks[e_Task].u_Start = REG32(DWT_CYCCNT);
+}
+
+/// @brief Function used for finding the histogram bucket of an execution time
+///
+/// @pre None
+/// @post None
+/// @param uint32_t u_Cycles
+///
+/// @return uint32_t index of the bucket
+///
+/// @globals None
+///
+/// @InOutCorelation Bucket is the position of the highest set bit, counted from MONITOR_HISTOGRAM_FIRST_LOG2 and
+///                  limited to the last bucket.
+/// @callsequence
+///   @startuml "u_Bucket.png"
+///     title "Sequence diagram for function u_Bucket"
+///     -> MONITOR: u_Bucket(uint32_t u_Cycles)
+///     MONITOR++
+///     <- MONITOR: Returns uint32_t
+///     MONITOR--
+///   @enduml
+
+static uint32_t u_Bucket(uint32_t u_Cycles);
+
+static uint32_t u_Bucket(uint32_t u_Cycles)
+{
+  uint32_t u_Log2;
+
+  if(u_Cycles == 0u)
+  {
+    return 0u;
+  }
+  u_Log2 = 31u - __CLZ(u_Cycles);
+  if(u_Log2 < MONITOR_HISTOGRAM_FIRST_LOG2)
+  {
+    return 0u;
+  }
+  u_Log2 = u_Log2 - MONITOR_HISTOGRAM_FIRST_LOG2 + 1u;
+  return (u_Log2 < MONITOR_HISTOGRAM_BUCKETS) ? u_Log2 : (MONITOR_HISTOGRAM_BUCKETS - 1u);
+}
+
+void MONITOR_v_TaskEnd(e_MONITOR_Task e_Task, TickType_t u_LastWake, TickType_t u_Period)
+{
+  t_MONITOR_TaskStats *p_Stats = &MONITOR_a_Tasks[e_Task];
+  uint32_t u_Cycles = REG32(DWT_CYCCNT) - p_Stats -> u_Start;
+  uint32_t u_Index  = u_Bucket(u_Cycles);
+
+  p_Stats -> u_Runs++;
+  if(u_Cycles > p_Stats -> u_MaxCycles)
+  {
+    p_Stats -> u_MaxCycles = u_Cycles;
+  }
+  if(p_Stats -> a_Histogram[u_Index] < 0xFFFFu)
+  {
+    p_Stats -> a_Histogram[u_Index]++;
+  }
+  // vTaskDelayUntil wakes at u_LastWake + u_Period, when that time has passed the task can not keep its period
+  if((u_Period != 0u) && ((TickType_t)(xTaskGetTickCount() - u_LastWake) >= u_Period))
+  {
+    p_Stats -> u_DeadlineMisses++;
+  }
+}
+
+uint32_t MONITOR_u_IsrEnter()
+{
+  return REG32(DWT_CYCCNT);
+}
+
+void MONITOR_v_IsrExit(e_MONITOR_Isr e_Isr, uint32_t u_Start)
+{
+  uint32_t u_Cycles = REG32(DWT_CYCCNT) - u_Start;
+
+  MONITOR_a_Isrs[e_Isr].u_Count++;
+  MONITOR_a_Isrs[e_Isr].u_Cycles += u_Cycles;                      // 64 bits, a 32-bit sum wrapped every 24 s
+  if(u_Cycles > MONITOR_a_Isrs[e_Isr].u_MaxCycles)
+  {
+    MONITOR_a_Isrs[e_Isr].u_MaxCycles = u_Cycles;
+  }
+}
+
+/// @brief Function used for writing a little endian value into the dump
+///
+/// @pre None
+/// @post None
+/// @param uint16_t u_Index position in MONITOR_a_Dump, uint32_t u_Value, uint8_t u_Size number of bytes
+///
+/// @return uint16_t position after the value
+///
+/// @globals MONITOR_a_Dump
+///
+/// @InOutCorelation Function writes the lowest u_Size bytes of u_Value, the least significant first.
+/// @callsequence
+///   @startuml "u_PutValue.png"
+///     title "Sequence diagram for function u_PutValue"
+///     -> MONITOR: u_PutValue(uint16_t u_Index, uint32_t u_Value, uint8_t u_Size)
+///     MONITOR++
+///     <- MONITOR: Returns uint16_t
+///     MONITOR--
+///   @enduml
+
+static uint16_t u_PutValue(uint16_t u_Index, uint32_t u_Value, uint8_t u_Size);
+
+static uint16_t u_PutValue(uint16_t u_Index, uint32_t u_Value, uint8_t u_Size)
+{
+  for(uint8_t u_Cnt = 0u; u_Cnt < u_Size; u_Cnt++)
+  {
+    MONITOR_a_Dump[u_Index++] = (uint8_t)(u_Value >> (8u * u_Cnt));
+  }
+  return u_Index;
+}
+
+void MONITOR_v_SleepEnter()
+{
+  MONITOR_u_SleepStart = TIMEB_u_NowUs();
+}
+
+void MONITOR_v_SleepExit()
+{
+  MONITOR_u_SleepUs += TIMEB_u_NowUs() - MONITOR_u_SleepStart;
+}
+
+/// @brief Function used for expressing a part of a whole in percent
+///
+/// @pre None
+/// @post None
+/// @param uint32_t u_Part, uint32_t u_Whole
+///
+/// @return uint8_t percent, 0 when u_Whole is 0
+///
+/// @globals None
+///
+/// @InOutCorelation Function divides in 64 bits so large run time values do not overflow.
+/// @callsequence
+///   @startuml "u_Percent.png"
+///     title "Sequence diagram for function u_Percent"
+///     -> MONITOR: u_Percent(uint32_t u_Part, uint32_t u_Whole)
+///     MONITOR++
+///     <- MONITOR: Returns uint8_t
+///     MONITOR--
+///   @enduml
+
+static uint8_t u_Percent(uint32_t u_Part, uint32_t u_Whole);
+
+static uint8_t u_Percent(uint32_t u_Part, uint32_t u_Whole)
+{
+  if(u_Whole == 0u)
+  {
+    return 0u;
+  }
+  if(u_Part >= u_Whole)
+  {
+    return 100u;
+  }
+  return (uint8_t)(((uint64_t)u_Part * 100u) / u_Whole);
+}
+
+t_MONITOR_Residency MONITOR_t_GetResidency()
+{
+  t_MONITOR_Residency t_Residency;
+  uint32_t u_Idle    = ulTaskGetIdleRunTimeCounter();
+  uint32_t u_Us      = MONITOR_u_RunTimeCounter();
+  uint32_t u_SleepUs = MONITOR_u_SleepUs;
+
+  // Run time counter is the microsecond time, so both shares are taken of the same elapsed time. Differences are
+  // taken modulo 2^32, so counters may wrap once within the window
+  t_Residency.u_IdlePercent  = u_Percent(u_Idle - MONITOR_t_Window.u_Idle, u_Us - MONITOR_t_Window.u_Us);
+  t_Residency.u_SleepPercent = u_Percent(u_SleepUs - MONITOR_t_Window.u_SleepUs, u_Us - MONITOR_t_Window.u_Us);
+  MONITOR_t_Window.u_Idle    = u_Idle;
+  MONITOR_t_Window.u_Us      = u_Us;
+  MONITOR_t_Window.u_SleepUs = u_SleepUs;
+  return t_Residency;
+}
+
+/// @brief Function used for writing bytes to the stimulus port of the dump
+///
+/// @pre None
+/// @post None
+/// @param const uint8_t *p_Data, uint16_t u_Length
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Bytes are written one by one, each as soon as the ITM FIFO is ready. Function returns at once
+///                  when the ITM or the port is disabled, which is the state without a debugger.
+/// @callsequence
+///   @startuml "v_ItmSend.png"
+///     title "Sequence diagram for function v_ItmSend"
+///     -> MONITOR: v_ItmSend(const uint8_t *p_Data, uint16_t u_Length)
+///     MONITOR++
+///       opt if ITM and port MONITOR_DUMP_ITM_PORT are enabled
+///         loop for each byte
+///           rnote over MONITOR: Waits for FIFOREADY, byte is written to the port.
+///         end
+///       end
+///     <- MONITOR
+///     MONITOR--
+///   @enduml
+
+static void v_ItmSend(const uint8_t *p_Data, uint16_t u_Length);
+
+static void v_ItmSend(const uint8_t *p_Data, uint16_t u_Length)
+{
+  uint32_t u_Port = ITM_STIM0 + (4u * MONITOR_DUMP_ITM_PORT);
+
+  if(((REG32(ITM_TCR) & ITM_TCR_ITMENA) == 0u) || ((REG32(ITM_TER) & (1u << MONITOR_DUMP_ITM_PORT)) == 0u))
+  {
+    return;
+  }
+  for(uint16_t u_Cnt = 0u; u_Cnt < u_Length; u_Cnt++)
+  {
+    while((REG32(u_Port) & ITM_STIM_FIFOREADY) == 0u)
+    {
+    }
+    REG8(u_Port) = p_Data[u_Cnt];                                  // Byte write gives a one byte SWIT packet
+  }
+}
+
+void MONITOR_v_Dump()
+{
+  t_MONITOR_Residency t_Residency = MONITOR_t_GetResidency();
+  t_MONITOR_IsrStats a_Isrs[MONITOR_ISR_COUNT];
+  TaskStatus_t t_Status;
+  uint16_t u_Index = 0u;
+  uint8_t u_CkA = 0u;
+  uint8_t u_CkB = 0u;
+
+  u_Index = u_PutValue(u_Index, MONITOR_DUMP_SYNC1, 1u);
+  u_Index = u_PutValue(u_Index, MONITOR_DUMP_SYNC2, 1u);
+  u_Index = u_PutValue(u_Index, MONITOR_DUMP_VERSION, 1u);
+  u_Index = u_PutValue(u_Index, MONITOR_TASK_COUNT, 1u);
+  u_Index = u_PutValue(u_Index, MONITOR_ISR_COUNT, 1u);
+  u_Index = u_PutValue(u_Index, MONITOR_HISTOGRAM_BUCKETS, 1u);
+  u_Index = u_PutValue(u_Index, MONITOR_u_RunTimeCounter(), 4u);
+  u_Index = u_PutValue(u_Index, ulTaskGetIdleRunTimeCounter(), 4u);
+  u_Index = u_PutValue(u_Index, t_Residency.u_IdlePercent, 1u);
+  u_Index = u_PutValue(u_Index, t_Residency.u_SleepPercent, 1u);
+
+  for(uint32_t u_Task = 0u; u_Task < MONITOR_TASK_COUNT; u_Task++)
+  {
+    t_MONITOR_TaskStats *p_Stats = &MONITOR_a_Tasks[u_Task];
+
+    t_Status.ulRunTimeCounter = 0u;
+    t_Status.usStackHighWaterMark = 0u;
+    if(p_Stats -> t_Handle != NULL)
+    {
+      vTaskGetInfo(p_Stats -> t_Handle, &t_Status, pdTRUE, eInvalid);
+    }
+    u_Index = u_PutValue(u_Index, p_Stats -> u_Runs, 4u);
+    u_Index = u_PutValue(u_Index, p_Stats -> u_MaxCycles, 4u);
+    u_Index = u_PutValue(u_Index, p_Stats -> u_DeadlineMisses, 4u);
+    u_Index = u_PutValue(u_Index, t_Status.ulRunTimeCounter, 4u);
+    u_Index = u_PutValue(u_Index, t_Status.usStackHighWaterMark, 2u);
+    for(uint32_t u_Cnt = 0u; u_Cnt < MONITOR_HISTOGRAM_BUCKETS; u_Cnt++)
+    {
+      u_Index = u_PutValue(u_Index, p_Stats -> a_Histogram[u_Cnt], 2u);
+    }
+  }
+
+  // 64-bit sums are copied with the interrupts masked, so no half updated value is sent
+  taskENTER_CRITICAL();
+  for(uint32_t u_Isr = 0u; u_Isr < MONITOR_ISR_COUNT; u_Isr++)
+  {
+    a_Isrs[u_Isr] = MONITOR_a_Isrs[u_Isr];
+  }
+  taskEXIT_CRITICAL();
+  for(uint32_t u_Isr = 0u; u_Isr < MONITOR_ISR_COUNT; u_Isr++)
+  {
+    u_Index = u_PutValue(u_Index, a_Isrs[u_Isr].u_Count, 4u);
+    u_Index = u_PutValue(u_Index, (uint32_t)a_Isrs[u_Isr].u_Cycles, 4u);
+    u_Index = u_PutValue(u_Index, (uint32_t)(a_Isrs[u_Isr].u_Cycles >> 32u), 4u);
+    u_Index = u_PutValue(u_Index, a_Isrs[u_Isr].u_MaxCycles, 4u);
+  }
+  u_Index = u_PutValue(u_Index, MONITOR_t_Latency.u_Count, 4u);
+  u_Index = u_PutValue(u_Index, MONITOR_t_Latency.u_Max, 2u);
+
+  // 8-bit Fletcher checksum over everything after the sync bytes
+  for(uint16_t u_Cnt = 2u; u_Cnt < u_Index; u_Cnt++)
+  {
+    u_CkA = (uint8_t)(u_CkA + MONITOR_a_Dump[u_Cnt]);
+    u_CkB = (uint8_t)(u_CkB + u_CkA);
+  }
+  u_Index = u_PutValue(u_Index, u_CkA, 1u);
+  u_Index = u_PutValue(u_Index, u_CkB, 1u);
+
+  // USART2 carries the commands to the GPS, the dump leaves on SWO
+  v_ItmSend(MONITOR_a_Dump, u_Index);
+}
+
+void MONITOR_v_RequestDump()
+{
+  MONITOR_b_DumpRequest = b_TRUE;
+}
+
+void MONITOR_v_Service()
+{
+  boolean b_Dump = MONITOR_b_DumpRequest;
+
+  if(ITM_RxBuffer != MONITOR_ITM_RX_EMPTY)
+  {
+    if(ITM_RxBuffer == (int32_t)MONITOR_DUMP_COMMAND)
+    {
+      b_Dump = b_TRUE;
+    }
+    ITM_RxBuffer = MONITOR_ITM_RX_EMPTY;                           // Debugger may send the next character
+  }
+  if((MONITOR_DUMP_PERIOD_MS != 0u) && (TIMEB_b_DeadlineExpired(MONITOR_t_DumpDeadline) == b_TRUE))
+  {
+    MONITOR_t_DumpDeadline = TIMEB_t_DeadlineInUs(MONITOR_DUMP_PERIOD_MS * 1000u);
+    b_Dump = b_TRUE;
+  }
+  if(b_Dump == b_TRUE)
+  {
+    MONITOR_b_DumpRequest = b_FALSE;
+    MONITOR_v_Dump();
+  }
+}
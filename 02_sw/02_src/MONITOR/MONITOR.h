@@ -6,6 +6,97 @@
 #define MONITOR_H_
 
 #include "stm32f439xx.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "Registers.h"
+
+/// Number of latency samples kept in the trace
+#define MONITOR_LATENCY_TRACE_LENGTH (64u)
+/// Length of one TIM2 tick in nanoseconds (90 MHz timer clock divided by 96)
+#define MONITOR_LATENCY_TICK_NS (1067u)
+
+/// This structure is used for tracing the interrupt latency
+typedef struct {
+  uint16_t a_Samples[MONITOR_LATENCY_TRACE_LENGTH];  ///< Last latencies in TIM2 ticks, the oldest one is overwritten
+  uint32_t u_Index;                                  ///< Index of the next sample in a_Samples
+  uint32_t u_Count;                                  ///< Number of samples taken since the reset
+  uint16_t u_Max;                                    ///< Worst latency in TIM2 ticks since the reset
+} t_MONITOR_LatencyTrace;
+
+/// Enable trace blocks, DWT included
+#define DEMCR_TRCENA (1u << 24u)
+/// Enable the cycle counter
+#define DWT_CTRL_CYCCNTENA (1u << 0u)
+/// Number of buckets in an execution time histogram
+#define MONITOR_HISTOGRAM_BUCKETS (12u)
+/// First bucket holds executions shorter than 2^MONITOR_HISTOGRAM_FIRST_LOG2 cycles (5.7 us), each next one doubles
+#define MONITOR_HISTOGRAM_FIRST_LOG2 (10u)
+/// Enable the ITM
+#define ITM_TCR_ITMENA (1u << 0u)
+/// Stimulus port which is ready for the next write
+#define ITM_STIM_FIFOREADY (1u << 0u)
+/// Stimulus port of the binary dump, port 0 stays free for text
+#define MONITOR_DUMP_ITM_PORT (1u)
+/// Period of the binary dump in milliseconds, 0 sends it only on request
+#define MONITOR_DUMP_PERIOD_MS (0u)
+/// Character which requests a dump when the debugger writes it into ITM_RxBuffer
+#define MONITOR_DUMP_COMMAND ('D')
+/// Value of ITM_RxBuffer when no character is waiting, same as ITM_RXBUFFER_EMPTY of CMSIS
+#define MONITOR_ITM_RX_EMPTY ((int32_t)0x5AA55AA5)
+/// First byte of the binary dump
+#define MONITOR_DUMP_SYNC1 (0xA5u)
+/// Second byte of the binary dump
+#define MONITOR_DUMP_SYNC2 (0x5Au)
+/// Version of the binary dump layout
+#define MONITOR_DUMP_VERSION (4u)
+
+/// Tasks which are measured
+typedef enum {
+  MONITOR_TASK_LED,       ///< TSK_Led
+  MONITOR_TASK_COM,       ///< TSK_Com
+  MONITOR_TASK_SIM,       ///< TSK_SIM
+  MONITOR_TASK_MCP23017,  ///< TSK_MCP23017
+  MONITOR_TASK_LOG,       ///< TSK_Log
+  MONITOR_TASK_COUNT      ///< Number of measured tasks
+} e_MONITOR_Task;
+
+/// Interrupts which are measured
+typedef enum {
+  MONITOR_ISR_USART2,     ///< USART2 (GPS)
+  MONITOR_ISR_USART3,     ///< USART3 (SIM800L)
+  MONITOR_ISR_EXTI1,      ///< EXTI1 (MCP23017 INTA)
+  MONITOR_ISR_COUNT       ///< Number of measured interrupts
+} e_MONITOR_Isr;
+
+/// This structure is used for the execution statistics of one task
+typedef struct {
+  TaskHandle_t t_Handle;                                ///< Task handle, used for the stack and run time
+  uint32_t u_Start;                                     ///< Cycle counter when the current execution started
+  uint32_t u_Runs;                                      ///< Number of executions
+  uint32_t u_MaxCycles;                                 ///< Longest execution in cycles
+  uint32_t u_DeadlineMisses;                            ///< Executions which did not end within their period
+  uint16_t a_Histogram[MONITOR_HISTOGRAM_BUCKETS];      ///< Executions per time bucket, saturated at 0xFFFF
+} t_MONITOR_TaskStats;
+
+/// This structure is used for the statistics of one interrupt
+typedef struct {
+  uint32_t u_Count;                                     ///< Number of entries
+  uint64_t u_Cycles;                                    ///< Sum of durations in cycles, wraps after 3000 years
+  uint32_t u_MaxCycles;                                 ///< Longest duration in cycles
+} t_MONITOR_IsrStats;
+
+/// This structure is used for the share of time the core was idle and asleep
+typedef struct {
+  uint8_t u_IdlePercent;   ///< Run time of the FreeRTOS idle task in percent
+  uint8_t u_SleepPercent;  ///< Time spent in WFI in percent
+} t_MONITOR_Residency;
+
+/// Length of the binary dump: header, run times, residency, tasks, interrupts, latency and checksum
+#define MONITOR_DUMP_LENGTH (6u + 8u + 2u + (MONITOR_TASK_COUNT * (18u + (2u * MONITOR_HISTOGRAM_BUCKETS))) + \
+                             (MONITOR_ISR_COUNT * 16u) + 6u + 2u)
+
+/// Character sent by the debugger through the ITM, MONITOR_ITM_RX_EMPTY when there is none
+extern volatile int32_t ITM_RxBuffer;
 
 /// @brief Function used for monitoring on board LED
 ///
@@ -15,7 +106,7 @@
 ///
 /// @return None
 ///
-/// @globals uint8_t numberOfActivations
+/// @globals uint32_t numberOfActivations
 ///
 /// @InOutCorelation Function counts how many times did the on board LED turn on.
 /// @callsequence
@@ -38,7 +129,7 @@ void Task_LED_CP_Start(void);
 ///
 /// @return None
 ///
-/// @globals uint8_t numberOfDetections
+/// @globals uint32_t numberOfDetections
 ///
 /// @InOutCorelation Function counts how many times did the on board LED turn off.
 /// @callsequence
@@ -53,6 +144,400 @@ void Task_LED_CP_Start(void);
 
 void Task_LED_CP_End(void);
 
+/// @brief Function used for tracing the interrupt latency
+///
+/// @pre TIM2 update interrupt must be enabled
+/// @post Sample is in the trace and the worst latency is updated
+/// @param uint32_t u_Ticks value of TIM2 counter at the entry of its interrupt
+///
+/// @return None
+///
+/// @globals t_MONITOR_LatencyTrace MONITOR_t_Latency
+///
+/// @InOutCorelation TIM2 counter starts from 0 at the update event, so its value at the entry of the interrupt is
+///                  the time the interrupt waited. TIM2 has priority 5, it is masked by FreeRTOS critical sections
+///                  and shows how long interrupts were blocked. Blocking longer than the TIM2 period (21 ms) wraps.
+/// @callsequence
+///   @startuml "MONITOR_v_LatencySample.png"
+///     title "Sequence diagram for function MONITOR_v_LatencySample"
+///     -> MONITOR: MONITOR_v_LatencySample(uint32_t u_Ticks)
+///     MONITOR++
+///       rnote over MONITOR: Sample is stored in the trace and compared with the worst one.
+///     <- MONITOR
+///     MONITOR--
+///   @enduml
+
+void MONITOR_v_LatencySample(uint32_t u_Ticks);
+
+/// @brief Function used for reading the interrupt latency trace
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return const t_MONITOR_LatencyTrace * MONITOR_t_Latency
+///
+/// @globals t_MONITOR_LatencyTrace MONITOR_t_Latency
+///
+/// @InOutCorelation Function returns a pointer to the trace, it can also be read with a debugger.
+/// @callsequence
+///   @startuml "MONITOR_p_GetLatencyTrace.png"
+///     title "Sequence diagram for function MONITOR_p_GetLatencyTrace"
+///     -> MONITOR: MONITOR_p_GetLatencyTrace()
+///     MONITOR++
+///     <- MONITOR://Returns a const t_MONITOR_LatencyTrace * to MONITOR_t_Latency//
+///     MONITOR--
+///   @enduml
+
+const t_MONITOR_LatencyTrace * MONITOR_p_GetLatencyTrace(void);
+
+/// @brief Function used for starting a new latency measurement
+///
+/// @pre None
+/// @post Trace is empty
+/// @param None
+///
+/// @return None
+///
+/// @globals t_MONITOR_LatencyTrace MONITOR_t_Latency
+///
+/// @InOutCorelation Function clears the trace and the worst latency.
+/// @callsequence
+///   @startuml "MONITOR_v_ResetLatency.png"
+///     title "Sequence diagram for function MONITOR_v_ResetLatency"
+///     -> MONITOR: MONITOR_v_ResetLatency()
+///     MONITOR++
+///       rnote over MONITOR: Trace is cleared with TIM2 interrupt disabled.
+///     <- MONITOR
+///     MONITOR--
+///   @enduml
+
+void MONITOR_v_ResetLatency(void);
+
+/// @brief Function used for starting the cycle counter
+///
+/// @pre None
+/// @post DWT cycle counter runs
+/// @param None
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Function enables the trace block and the DWT cycle counter, which times task executions and
+///                  interrupts. FreeRTOS calls it through portCONFIGURE_TIMER_FOR_RUN_TIME_STATS when the scheduler
+///                  starts.
+/// @callsequence
+///   @startuml "MONITOR_v_Init.png"
+///     title "Sequence diagram for function MONITOR_v_Init"
+///     -> MONITOR: MONITOR_v_Init()
+///     MONITOR++
+///       rnote over MONITOR: TRCENA in COREDEBUG_DEMCR and CYCCNTENA in DWT_CTRL are set.
+///     <- MONITOR
+///     MONITOR--
+///   @enduml
+
+void MONITOR_v_Init(void);
+
+/// @brief Function used as the FreeRTOS run time counter
+///
+/// @pre TIMEB_v_Init must be done
+/// @post None
+/// @param None
+///
+/// @return uint32_t microsecond time
+///
+/// @globals None
+///
+/// @InOutCorelation Run time is counted by TIM5, not by the DWT cycle counter, which stops while the core is in WFI.
+///                  Tickless sleep happens in the idle task, so its run time includes the sleep and the idle share
+///                  is right. Counter wraps after about 71 minutes.
+/// @callsequence
+///   @startuml "MONITOR_u_RunTimeCounter.png"
+///     title "Sequence diagram for function MONITOR_u_RunTimeCounter"
+///     -> MONITOR: MONITOR_u_RunTimeCounter()
+///     MONITOR++
+///       MONITOR -> TIMEB: TIMEB_u_NowUs()
+///     <- MONITOR: Returns uint32_t
+///     MONITOR--
+///   @enduml
+
+uint32_t MONITOR_u_RunTimeCounter(void);
+
+/// @brief Function used for connecting a measured task with its handle
+///
+/// @pre Task must be created
+/// @post Stack high-water mark and run time of the task are in the dump
+/// @param e_MONITOR_Task e_Task, TaskHandle_t t_Handle
+///
+/// @return None
+///
+/// @globals MONITOR_a_Tasks
+///
+/// @InOutCorelation Function stores the handle in the statistics of the task.
+/// @callsequence
+///   @startuml "MONITOR_v_RegisterTask.png"
+///     title "Sequence diagram for function MONITOR_v_RegisterTask"
+///     -> MONITOR: MONITOR_v_RegisterTask(e_MONITOR_Task e_Task, TaskHandle_t t_Handle)
+///     MONITOR++
+///     <- MONITOR
+///     MONITOR--
+///   @enduml
+
+void MONITOR_v_RegisterTask(e_MONITOR_Task e_Task, TaskHandle_t t_Handle);
+
+/// @brief Function used for marking the start of a task execution
+///
+/// @pre Called by the task itself after it wakes up
+/// @post None
+/// @param e_MONITOR_Task e_Task
+///
+/// @return None
+///
+/// @globals MONITOR_a_Tasks
+///
+/// @InOutCorelation Function stores the cycle counter.
+/// @callsequence
+///   @startuml "MONITOR_v_TaskStart.png"
+///     title "Sequence diagram for function MONITOR_v_TaskStart"
+///     -> MONITOR: MONITOR_v_TaskStart(e_MONITOR_Task e_Task)
+///     MONITOR++
+///     <- MONITOR
+///     MONITOR--
+///   @enduml
+
+void MONITOR_v_TaskStart(e_MONITOR_Task e_Task);
+
+/// @brief Function used for marking the end of a task execution
+///
+/// @pre MONITOR_v_TaskStart must be called first, called before vTaskDelayUntil
+/// @post Histogram, longest execution and deadline misses are updated
+/// @param e_MONITOR_Task e_Task, TickType_t u_LastWake value passed to vTaskDelayUntil, TickType_t u_Period 0 for
+///        tasks which are not periodic
+///
+/// @return None
+///
+/// @globals MONITOR_a_Tasks
+///
+/// @InOutCorelation Execution time includes preemption by other tasks and interrupts. A deadline is missed when the
+///                  next wake up time has already passed, vTaskDelayUntil then returns without blocking.
+/// @callsequence
+///   @startuml "MONITOR_v_TaskEnd.png"
+///     title "Sequence diagram for function MONITOR_v_TaskEnd"
+///     -> MONITOR: MONITOR_v_TaskEnd(e_MONITOR_Task e_Task, TickType_t u_LastWake, TickType_t u_Period)
+///     MONITOR++
+///       MONITOR -> MONITOR: u_Bucket(u_Cycles)
+///       opt if period is set and it has passed
+///         rnote over MONITOR: Deadline miss is counted.
+///       end
+///     <- MONITOR
+///     MONITOR--
+///   @enduml
+
+void MONITOR_v_TaskEnd(e_MONITOR_Task e_Task, TickType_t u_LastWake, TickType_t u_Period);
+
+/// @brief Function used at the entry of a measured interrupt
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return uint32_t cycle counter at the entry
+///
+/// @globals None
+///
+/// @InOutCorelation Function reads the cycle counter, the value is passed to MONITOR_v_IsrExit.
+/// @callsequence
+///   @startuml "MONITOR_u_IsrEnter.png"
+///     title "Sequence diagram for function MONITOR_u_IsrEnter"
+///     -> MONITOR: MONITOR_u_IsrEnter()
+///     MONITOR++
+///     <- MONITOR: Returns DWT_CYCCNT
+///     MONITOR--
+///   @enduml
+
+uint32_t MONITOR_u_IsrEnter(void);
+
+/// @brief Function used at the exit of a measured interrupt
+///
+/// @pre MONITOR_u_IsrEnter must be called at the entry
+/// @post Count, total and longest duration of the interrupt are updated
+/// @param e_MONITOR_Isr e_Isr, uint32_t u_Start
+///
+/// @return None
+///
+/// @globals MONITOR_a_Isrs
+///
+/// @InOutCorelation Each interrupt writes only its own statistics, so no locking is needed.
+/// @callsequence
+///   @startuml "MONITOR_v_IsrExit.png"
+///     title "Sequence diagram for function MONITOR_v_IsrExit"
+///     -> MONITOR: MONITOR_v_IsrExit(e_MONITOR_Isr e_Isr, uint32_t u_Start)
+///     MONITOR++
+///     <- MONITOR
+///     MONITOR--
+///   @enduml
+
+void MONITOR_v_IsrExit(e_MONITOR_Isr e_Isr, uint32_t u_Start);
+
+/// @brief Function used at the start of a tickless sleep
+///
+/// @pre Called from PreSleepProcessing with interrupts disabled
+/// @post None
+/// @param None
+///
+/// @return None
+///
+/// @globals MONITOR_u_SleepStart
+///
+/// @InOutCorelation Function stores the microsecond time at which WFI is entered.
+/// @callsequence
+///   @startuml "MONITOR_v_SleepEnter.png"
+///     title "Sequence diagram for function MONITOR_v_SleepEnter"
+///     -> MONITOR: MONITOR_v_SleepEnter()
+///     MONITOR++
+///       MONITOR -> TIMEB: TIMEB_u_NowUs()
+///     <- MONITOR
+///     MONITOR--
+///   @enduml
+
+void MONITOR_v_SleepEnter(void);
+
+/// @brief Function used at the end of a tickless sleep
+///
+/// @pre MONITOR_v_SleepEnter must be called before WFI
+/// @post Sleep time is added to the total
+/// @param None
+///
+/// @return None
+///
+/// @globals MONITOR_u_SleepStart, MONITOR_u_SleepUs
+///
+/// @InOutCorelation Time is measured with TIMEB, TIM5 keeps counting while the core sleeps.
+/// @callsequence
+///   @startuml "MONITOR_v_SleepExit.png"
+///     title "Sequence diagram for function MONITOR_v_SleepExit"
+///     -> MONITOR: MONITOR_v_SleepExit()
+///     MONITOR++
+///       MONITOR -> TIMEB: TIMEB_u_NowUs()
+///     <- MONITOR
+///     MONITOR--
+///   @enduml
+
+void MONITOR_v_SleepExit(void);
+
+/// @brief Function used for reading the idle and sleep residency
+///
+/// @pre Scheduler must be running
+/// @post New measurement window is started
+/// @param None
+///
+/// @return t_MONITOR_Residency percentages since the previous call
+///
+/// @globals MONITOR_u_SleepUs, MONITOR_t_Window
+///
+/// @InOutCorelation Idle residency is the idle task run time divided by the elapsed time, sleep residency is the
+///                  time in WFI divided by the elapsed time. Both are measured since the previous call with TIMEB, the
+///                  idle task run time includes its time in WFI.
+/// @callsequence
+///   @startuml "MONITOR_t_GetResidency.png"
+///     title "Sequence diagram for function MONITOR_t_GetResidency"
+///     -> MONITOR: MONITOR_t_GetResidency()
+///     MONITOR++
+///       MONITOR -> FreeRTOS: ulTaskGetIdleRunTimeCounter()
+///       MONITOR -> TIMEB: TIMEB_u_NowUs()
+///     <- MONITOR: Returns t_MONITOR_Residency
+///     MONITOR--
+///   @enduml
+
+t_MONITOR_Residency MONITOR_t_GetResidency(void);
+
+/// @brief Function used for sending all statistics through the ITM
+///
+/// @pre Scheduler must be running
+/// @post Binary dump is written to stimulus port MONITOR_DUMP_ITM_PORT, when the debugger enabled it
+/// @param None
+///
+/// @return None
+///
+/// @globals MONITOR_a_Tasks, MONITOR_a_Isrs, MONITOR_t_Latency, MONITOR_a_Dump
+///
+/// @InOutCorelation All values are little endian. Layout:
+///                  sync A5 5A, version, task count, interrupt count, bucket count,
+///                  total run time u32 in us, idle run time u32 in us, idle percent u8, sleep percent u8,
+///                  per task: runs u32, longest cycles u32, deadline misses u32, run time u32 in us, free stack words u16,
+///                  histogram u16 x bucket count,
+///                  per interrupt: count u32, cycles u64, longest cycles u32,
+///                  latency samples u32, worst latency u16, Fletcher checksum CK_A CK_B over all previous bytes
+///                  after the sync.
+///                  Dump leaves on SWO, so it does not share USART2 with the commands to the GPS. Nothing is sent
+///                  while no debugger has enabled the ITM and the port.
+/// @callsequence
+///   @startuml "MONITOR_v_Dump.png"
+///     title "Sequence diagram for function MONITOR_v_Dump"
+///     -> MONITOR: MONITOR_v_Dump()
+///     MONITOR++
+///       loop for each task
+///         MONITOR -> FreeRTOS: vTaskGetInfo(...)
+///       end
+///       MONITOR -> MONITOR: MONITOR_t_GetResidency()
+///       rnote over MONITOR: Statistics are written into MONITOR_a_Dump.
+///       MONITOR -> MONITOR: v_ItmSend(MONITOR_a_Dump, MONITOR_DUMP_LENGTH)
+///     <- MONITOR
+///     MONITOR--
+///   @enduml
+
+void MONITOR_v_Dump(void);
+
+/// @brief Function used for requesting a dump from the code
+///
+/// @pre None
+/// @post Dump is sent by the next MONITOR_v_Service
+/// @param None
+///
+/// @return None
+///
+/// @globals MONITOR_b_DumpRequest
+///
+/// @InOutCorelation Function only sets the request, so it can be called from any task.
+/// @callsequence
+///   @startuml "MONITOR_v_RequestDump.png"
+///     title "Sequence diagram for function MONITOR_v_RequestDump"
+///     -> MONITOR: MONITOR_v_RequestDump()
+///     MONITOR++
+///     <- MONITOR
+///     MONITOR--
+///   @enduml
+
+void MONITOR_v_RequestDump(void);
+
+/// @brief Function used for sending the dump on request or periodically
+///
+/// @pre Called periodically from a task
+/// @post None
+/// @param None
+///
+/// @return None
+///
+/// @globals MONITOR_t_DumpDeadline, MONITOR_b_DumpRequest, ITM_RxBuffer
+///
+/// @InOutCorelation Function calls MONITOR_v_Dump when MONITOR_DUMP_COMMAND arrived from the debugger, when
+///                  MONITOR_v_RequestDump was called, or every MONITOR_DUMP_PERIOD_MS when it is not 0. Other
+///                  characters from the debugger are dropped.
+/// @callsequence
+///   @startuml "MONITOR_v_Service.png"
+///     title "Sequence diagram for function MONITOR_v_Service"
+///     -> MONITOR: MONITOR_v_Service()
+///     MONITOR++
+///       opt if dump is requested or its period has passed
+///         MONITOR -> MONITOR: MONITOR_v_Dump()
+///       end
+///     <- MONITOR
+///     MONITOR--
+///   @enduml
+
+void MONITOR_v_Service(void);
+
 
 
 
@@ -66,15 +551,12 @@ void Task_LED_CP_End(void);
 ///
 /// @return None
 ///
-/// @globals uint8_t numberOfDetections
+/// @globals uint32_t numberOfDetections
 ///
 /// @InOutCorelation Function counts how many times did the on board LED turn off.
 /// @callsequence
 ///   @startuml "Task_LED_CP_End.png"
 ///     title "Sequence diagram for function Task_LED_CP_End"
-///     TSK_Idle++
-///       rnote over TSK_Idle: Other tasks are not active.
-///     TSK_Idle--
 ///     TSK_Led++
 ///       rnote over TSK_Led: Blink LED every 500 ms.
 ///       -> TSK_Led: LEDM_v_Main()
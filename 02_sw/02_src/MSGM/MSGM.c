@@ -7,37 +7,38 @@
 #include "UARTM_cfg.h"
 #include "CALCM.h"
 #include "SIM.h"
+#include "NMEA.h"
+#include "UBX.h"
 #include "FreeRTOS.h"
 #include "projdefs.h"
 #include <stdio.h>
+#include <string.h>
 
-uint8_t                u_data                                           = 0u;          // Initiate data in state machine to 0
-uint8_t                a_TempBuffer[50u]                                = {0u};        // Set all the elements of a temporary buffer, used to store coordinates, to 0
 t_MessageElement       MSGM_t_MessageBuffer[MSGM_MESSAGE_BUFFER_LENGTH] = {0u};        // Set message buffer elements to 0 used to sort messages
-t_CoordinatesStructure MSGM_t_Coordinates                               = {0u};        // Structure that saves final, parsed coordinates is initiated to 0
-uint8_t 			   u_RawMessageBuffer[50u]							= {0u};        // Set raw message buffer to 0
 
-t_CircularBuffer t_RingBuffer =
-{
-  {0u},                                                                                // Set all of the elements in the ring buffer to 0
-  0u,                                                                                  // Set write pointer to 0
-  0u,                                                                                  // Set read pointer to 0
-  0u                                                                                   // Set counter of processed elements to 0
-};
+/// Storage of the ring buffer used by USART2 (GPS module)
+static uint8_t MSGM_a_GpsStorage[MSGM_GPS_RING_LENGTH] = {0u};
+/// Storage of the ring buffer used by USART3 (SIM800L module)
+static uint8_t MSGM_a_SimStorage[MSGM_SIM_RING_LENGTH] = {0u};
 
-t_CircularBuffer t_SIM_RingBuffer =
-{
-		{0u},
-		0u,
-		0u,
-		0u
-};
+_Static_assert(RINGB_IS_POWER_OF_TWO(MSGM_GPS_RING_LENGTH), "MSGM_GPS_RING_LENGTH must be a power of two");
+_Static_assert(RINGB_IS_POWER_OF_TWO(MSGM_SIM_RING_LENGTH), "MSGM_SIM_RING_LENGTH must be a power of two");
 
-t_CircularBuffer *MSGM_a_RingBuffers[NUM_OF_RING_BUFFERS] =
+/// Ingest channels of the system indexed by e_RingBuffers, each with its own sizing and overflow policy
+static t_MSGM_Channel MSGM_a_Channels[NUM_OF_RING_BUFFERS] =
 {
-  &t_RingBuffer
+  // GPS: the NMEA framer drops a broken sentence by its checksum and resynchronises on '$', only sentences NMEA
+  // extracts are stored
+  { RINGB_INIT(MSGM_a_GpsStorage, MSGM_GPS_RING_LENGTH), MSGM_SENTENCE_END, MSGM_GPS_NOTIFY_THRESHOLD,
+    MSGM_OVERFLOW_DROP_BYTES, NULL, b_FALSE, 0u, NMEA_b_Admit, MSGM_FILTER_DROP, {0u}, 0u, 0u },
+  // SIM800L: responses carry no checksum, a cut line must not run into the next one
+  { RINGB_INIT(MSGM_a_SimStorage, MSGM_SIM_RING_LENGTH), MSGM_LINE_END, MSGM_SIM_NOTIFY_THRESHOLD,
+    MSGM_OVERFLOW_DROP_FRAME, NULL, b_FALSE, 0u, NULL, MSGM_FILTER_DROP, {0u}, 0u, 0u }
 };
 
+/// Positions of the system indexed by e_MSGM_FixSource
+static t_MSGM_FixSlot MSGM_a_Fixes[NUM_OF_FIXES] = {0u};
+
 t_MessageElement MSGM_t_Dictionary[MSGM_DICTIONARY_LENGTH] = {
     {
       (uint8_t*) "LED_ON____",
@@ -127,171 +128,368 @@ e_Message MSGM_e_MessageRetrieve(e_ReceiverID e_ID)
   return e_MessageReturn;
 }
 
-boolean MSGM_b_CircularBufferIsEmpty(e_RingBuffers e_BufferID)
+/// @brief Function used to write received bytes into a channel
+///
+/// @pre Must be called from the receive interrupt of the channel
+/// @post Bytes are stored or dropped according to the overflow policy of the channel, p_FrameEnd is b_TRUE if a
+///       frame end byte was stored and is left unchanged otherwise
+/// @param t_MSGM_Channel *p_Channel, const uint8_t *p_Data, uint32_t u_Length, boolean *p_FrameEnd
+///
+/// @return uint32_t number of stored bytes
+///
+/// @globals None
+///
+/// @InOutCorelation Block which fits while no frame is being dropped is copied at once. Otherwise the bytes are stored
+///                  one by one: with MSGM_OVERFLOW_DROP_FRAME a byte which does not fit starts dropping, which ends
+///                  with the first frame end byte that fits, so the cut frame is kept apart from the next one. Only
+///                  stored bytes are checked for the frame end, a dropped one does not wake the consumer.
+/// @callsequence
+///   @startuml "u_ChannelPush.png"
+///     title "Sequence diagram for function u_ChannelPush"
+///     -> MSGM: u_ChannelPush(t_MSGM_Channel *p_Channel, const uint8_t *p_Data, uint32_t u_Length, boolean *p_FrameEnd)
+///     MSGM++
+///       alt if not dropping and the block fits
+///         MSGM -> RINGB: RINGB_u_PushN(...)
+///       else else
+///         loop for each byte
+///           MSGM -> RINGB: RINGB_u_Push(...)
+///         end
+///       end
+///     <- MSGM: Returns number of stored bytes
+///     MSGM--
+///   @enduml
+
+static uint32_t u_ChannelPush(t_MSGM_Channel *p_Channel, const uint8_t *p_Data, uint32_t u_Length, boolean *p_FrameEnd);
+
+static uint32_t u_ChannelPush(t_MSGM_Channel *p_Channel, const uint8_t *p_Data, uint32_t u_Length, boolean *p_FrameEnd)
 {
-  return (t_RingBuffer.u_head == t_RingBuffer.u_tail);          // Check if the ring buffer is empty of data
+  uint32_t u_Stored = 0u;
+
+  if ((p_Channel -> b_Discarding == b_FALSE) && (u_Length <= RINGB_u_Free(&p_Channel -> t_Ring)))
+  {
+    if (memchr(p_Data, p_Channel -> u_FrameEnd, u_Length) != NULL)
+    {
+      *p_FrameEnd = b_TRUE;
+    }
+    return RINGB_u_PushN(&p_Channel -> t_Ring, p_Data, u_Length);                    // Usual case, nothing is dropped
+  }
+
+  for (uint32_t u_Cnt = 0u; u_Cnt < u_Length; u_Cnt++)
+  {
+    if ((p_Channel -> b_Discarding == b_TRUE) && (p_Data[u_Cnt] != p_Channel -> u_FrameEnd))
+    {
+      p_Channel -> u_Dropped++;                                                      // Rest of an overflowed frame
+    }
+    else if (RINGB_u_Push(&p_Channel -> t_Ring, p_Data[u_Cnt]) == 1u)
+    {
+      p_Channel -> b_Discarding = b_FALSE;                                           // Next frame starts clean
+      if (p_Data[u_Cnt] == p_Channel -> u_FrameEnd)
+      {
+        *p_FrameEnd = b_TRUE;
+      }
+      u_Stored++;
+    }
+    else
+    {
+      p_Channel -> u_Dropped++;
+      if (p_Channel -> e_Overflow == MSGM_OVERFLOW_DROP_FRAME)
+      {
+        p_Channel -> b_Discarding = b_TRUE;
+      }
+    }
+  }
+  return u_Stored;
 }
 
-uint8_t MSGM_u_CircularBufferPush(e_RingBuffers e_BufferID, uint8_t UARTM_u_data)
+/// @brief Function used to write received bytes into a channel through its ingress filter
+///
+/// @pre Must be called from the receive interrupt of the channel
+/// @post Bytes of admitted sentences are passed to u_ChannelPush, the others are counted as filtered, p_FrameEnd is
+///       b_TRUE if a frame end byte was stored and is left unchanged otherwise
+/// @param t_MSGM_Channel *p_Channel, const uint8_t *p_Data, uint32_t u_Length, boolean *p_FrameEnd
+///
+/// @return uint32_t number of stored bytes
+///
+/// @globals None
+///
+/// @InOutCorelation Sentence start and address field are held in the channel until the address is complete, so a
+///                  sentence split between two calls is filtered the same way. Bytes of an admitted sentence are
+///                  passed on in runs, a DMA block costs one u_ChannelPush per admitted sentence.
+/// @callsequence
+///   @startuml "u_FilterPush.png"
+///     title "Sequence diagram for function u_FilterPush"
+///     -> MSGM: u_FilterPush(t_MSGM_Channel *p_Channel, const uint8_t *p_Data, uint32_t u_Length, boolean *p_FrameEnd)
+///     MSGM++
+///       alt if channel has no filter
+///         MSGM -> MSGM: u_ChannelPush(...)
+///       else else
+///         loop for each byte
+///           opt if byte is MSGM_SENTENCE_START
+///             MSGM -> MSGM: u_ChannelPush(...) run of the previous sentence if it was admitted
+///           end
+///           opt if address field is complete
+///             MSGM -> MSGM: p_Admit(...)
+///             opt if sentence is admitted
+///               MSGM -> MSGM: u_ChannelPush(...) held characters
+///             end
+///           end
+///         end
+///         MSGM -> MSGM: u_ChannelPush(...) run of an admitted sentence at the end of the block
+///       end
+///     <- MSGM: Returns number of stored bytes
+///     MSGM--
+///   @enduml
+
+static uint32_t u_FilterPush(t_MSGM_Channel *p_Channel, const uint8_t *p_Data, uint32_t u_Length, boolean *p_FrameEnd);
+
+static uint32_t u_FilterPush(t_MSGM_Channel *p_Channel, const uint8_t *p_Data, uint32_t u_Length, boolean *p_FrameEnd)
 {
+  t_MSGM_Admit p_Admit  = p_Channel -> p_Admit;                                      // Read once, may be changed by a task
+  uint32_t     u_Stored = 0u;
+  uint32_t     u_Run    = 0u;                                                        // First byte of an admitted sentence not yet stored
 
-  if (e_BufferID <= NUM_OF_RING_BUFFERS)
+  if (p_Admit == NULL)
   {
-    t_RingBuffer = *MSGM_a_RingBuffers[e_BufferID];
+    p_Channel -> e_Filter = MSGM_FILTER_DROP;                                        // Filter starts at a sentence when it is set again
+    return u_ChannelPush(p_Channel, p_Data, u_Length, p_FrameEnd);
   }
 
-  if (t_RingBuffer.u_count == MSGM_RING_BUFFER_LENGTH)                                              // Checks if the ring buffer is full
+  for (uint32_t u_Cnt = 0u; u_Cnt < u_Length; u_Cnt++)
   {
-    return 0;
+    if (p_Data[u_Cnt] == MSGM_SENTENCE_START)
+    {
+      if (p_Channel -> e_Filter == MSGM_FILTER_PASS)
+      {
+        u_Stored += u_ChannelPush(p_Channel, &p_Data[u_Run], u_Cnt - u_Run, p_FrameEnd);
+      }
+      else if (p_Channel -> e_Filter == MSGM_FILTER_ADDRESS)
+      {
+        p_Channel -> u_Filtered += p_Channel -> u_Held;                              // Address was cut, NMEA would reject it
+      }
+      p_Channel -> u_Held = 0u;
+      p_Channel -> e_Filter = MSGM_FILTER_ADDRESS;
+    }
+
+    if (p_Channel -> e_Filter == MSGM_FILTER_ADDRESS)
+    {
+      p_Channel -> a_Header[p_Channel -> u_Held++] = p_Data[u_Cnt];
+      if (p_Channel -> u_Held == MSGM_HEADER_LENGTH)
+      {
+        if (p_Admit(&p_Channel -> a_Header[1u]) == b_TRUE)
+        {
+          u_Stored += u_ChannelPush(p_Channel, p_Channel -> a_Header, MSGM_HEADER_LENGTH, p_FrameEnd);
+          p_Channel -> e_Filter = MSGM_FILTER_PASS;
+          u_Run = u_Cnt + 1u;
+        }
+        else
+        {
+          p_Channel -> u_Filtered += MSGM_HEADER_LENGTH;
+          p_Channel -> e_Filter = MSGM_FILTER_DROP;
+        }
+      }
+    }
+    else if (p_Channel -> e_Filter == MSGM_FILTER_DROP)
+    {
+      p_Channel -> u_Filtered++;
+    }
   }
 
-  if ((t_RingBuffer.u_head + 1u) == (t_RingBuffer.u_tail))                                          // Checks for unintended behavior if read pointer is ahead of write pointer
+  if ((p_Channel -> e_Filter == MSGM_FILTER_PASS) && (u_Run < u_Length))
   {
-    return 0xFF;
+    u_Stored += u_ChannelPush(p_Channel, &p_Data[u_Run], u_Length - u_Run, p_FrameEnd); // Sentence continues in the next call
   }
+  return u_Stored;
+}
 
-  t_RingBuffer.u_buffer[t_RingBuffer.u_head] = UARTM_u_data;                                        // Push the data from interrupt to ring buffer
-  t_RingBuffer.u_head                        = (t_RingBuffer.u_head + 1) % MSGM_RING_BUFFER_LENGTH; // Check if the end of a ring buffer is being reached
-  t_RingBuffer.u_count++;                                                                           // Push the count ahead to signalize the data is being transfered to the ring buffer
+/// @brief Function used to wake the task that consumes a ring buffer
+///
+/// @pre Must be called from interrupt context after data was pushed
+/// @post Consumer task is notified if a frame ended or the buffer is filling up
+/// @param t_MSGM_Channel *p_Channel, boolean b_FrameEnd
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Function gives a direct to task notification and requests a context switch if needed.
+/// @callsequence
+///   @startuml "v_NotifyConsumer.png"
+///     title "Sequence diagram for function v_NotifyConsumer"
+///     -> MSGM: v_NotifyConsumer(t_MSGM_Channel *p_Channel, boolean b_FrameEnd)
+///     MSGM++
+///       opt if consumer is registered and frame ended or threshold is reached
+///         MSGM -> FreeRTOS: vTaskNotifyGiveFromISR(...)
+///         MSGM -> FreeRTOS: portYIELD_FROM_ISR(...)
+///       end
+///     <- MSGM
+///     MSGM--
+///   @enduml
+
+static void v_NotifyConsumer(t_MSGM_Channel *p_Channel, boolean b_FrameEnd);
+
+static void v_NotifyConsumer(t_MSGM_Channel *p_Channel, boolean b_FrameEnd)
+{
+  TaskHandle_t t_Task = p_Channel -> t_Consumer;
 
-  return 1;
+  if ((t_Task != NULL) &&
+      ((b_FrameEnd == b_TRUE) || (RINGB_u_Count(&p_Channel -> t_Ring) >= p_Channel -> u_NotifyThreshold)))
+  {
+    BaseType_t x_HigherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(t_Task, &x_HigherPriorityTaskWoken);                      // Wake the task blocked on the ring buffer
+    portYIELD_FROM_ISR(x_HigherPriorityTaskWoken);                                   // Switch to it as soon as the interrupt returns
+  }
 }
 
-uint8_t MSGM_u_CircularBufferPop(e_RingBuffers e_BufferID)
+void MSGM_v_SetConsumer(e_RingBuffers e_BufferID, TaskHandle_t t_Task)
 {
+  if (e_BufferID < NUM_OF_RING_BUFFERS)
+  {
+    MSGM_a_Channels[e_BufferID].t_Consumer = t_Task;
+  }
+}
 
-  uint8_t u_pop_data = 0u;
+boolean MSGM_b_CircularBufferIsEmpty(e_RingBuffers e_BufferID)
+{
+  if ((e_BufferID < NUM_OF_RING_BUFFERS) && (RINGB_u_Count(&MSGM_a_Channels[e_BufferID].t_Ring) != 0u))
+  {
+    return b_FALSE;
+  }
+  return b_TRUE;                                                                     // Unknown buffers are reported as empty
+}
 
-  if (e_BufferID <= NUM_OF_RING_BUFFERS)
+uint8_t MSGM_u_CircularBufferPush(e_RingBuffers e_BufferID, uint8_t UARTM_u_data)
+{
+  if (e_BufferID >= NUM_OF_RING_BUFFERS)
   {
-    t_RingBuffer = *MSGM_a_RingBuffers[e_BufferID];
+    return 0u;
   }
+  t_MSGM_Channel *p_Channel = &MSGM_a_Channels[e_BufferID];
+  boolean b_FrameEnd = b_FALSE;
+  uint8_t u_Stored = (uint8_t)u_FilterPush(p_Channel, &UARTM_u_data, 1u, &b_FrameEnd); // 0 if the byte was filtered or dropped
+  v_NotifyConsumer(p_Channel, b_FrameEnd);
+  return u_Stored;
+}
 
-  if (t_RingBuffer.u_count == 0u)                                              // if the u_head == u_tail, we don't have any data
+uint16_t MSGM_u_CircularBufferPushBlock(e_RingBuffers e_BufferID, const uint8_t *p_Data, uint16_t u_Length)
+{
+  if (e_BufferID >= NUM_OF_RING_BUFFERS)
   {
-    return 0xFF;
+    return 0u;
   }
+  t_MSGM_Channel *p_Channel = &MSGM_a_Channels[e_BufferID];
+  boolean b_FrameEnd = b_FALSE;
+  uint16_t u_Stored = (uint16_t)u_FilterPush(p_Channel, p_Data, u_Length, &b_FrameEnd); // Each admitted run is copied and published at once if it fits
+  v_NotifyConsumer(p_Channel, b_FrameEnd);                                           // Frame end counts only if it was stored
+  return u_Stored;
+}
 
-  u_pop_data = t_RingBuffer.u_buffer[t_RingBuffer.u_tail];                    // Fetch the data from ring buffer and save it into a temporary variable
-  t_RingBuffer.u_tail = (t_RingBuffer.u_tail + 1) % MSGM_RING_BUFFER_LENGTH;  // Checks if the end of a ring buffer is reached
-  t_RingBuffer.u_count--;                                                     // Lower the count variable that signalizes data is successfully popped
-  t_RingBuffer.u_buffer[t_RingBuffer.u_tail - 1u] = 0u;                       // Removes the popped data out of ring buffer
-  return u_pop_data;                                                          // Returns the value of the data being read
+void MSGM_v_SetNotifyThreshold(e_RingBuffers e_BufferID, uint32_t u_Threshold)
+{
+  if (e_BufferID < NUM_OF_RING_BUFFERS)
+  {
+    MSGM_a_Channels[e_BufferID].u_NotifyThreshold = u_Threshold;
+  }
 }
 
-void MSGM_t_GetCoordinates(uint8_t *TempBuffer)
+uint32_t MSGM_u_Dropped(e_RingBuffers e_BufferID)
 {
-  uint8_t u_index = 0u;
-  uint8_t u_start = 1u;
+  if (e_BufferID >= NUM_OF_RING_BUFFERS)
+  {
+    return 0u;
+  }
+  return MSGM_a_Channels[e_BufferID].u_Dropped;
+}
 
-  while (TempBuffer[u_start] != ',')                                   // Searches for ',' because of a message format
+void MSGM_v_SetAdmission(e_RingBuffers e_BufferID, t_MSGM_Admit p_Admit)
+{
+  if (e_BufferID < NUM_OF_RING_BUFFERS)
   {
-    MSGM_t_Coordinates.a_Latitude[u_index++] = TempBuffer[u_start++];  // Transfer the latitude portion of a message from temporary buffer to coordinates structure
+    MSGM_a_Channels[e_BufferID].p_Admit = p_Admit;
   }
-  u_start++;
-  MSGM_t_Coordinates.u_LatDirection = TempBuffer[u_start];             // Transfer the latitude direction portion of a message from temporary buffer to coordinates structure
+}
 
-  u_start += 2u;
-  u_index = 0u;
-  while (TempBuffer[u_start] != ',')                                   // Searches for ',' because of a message format
+uint32_t MSGM_u_Filtered(e_RingBuffers e_BufferID)
+{
+  if (e_BufferID >= NUM_OF_RING_BUFFERS)
   {
-    MSGM_t_Coordinates.a_Longitude[u_index++] = TempBuffer[u_start++]; // Transfer the longitude portion of a message from temporary buffer to coordinates structure
+    return 0u;
   }
-  u_start++;
+  return MSGM_a_Channels[e_BufferID].u_Filtered;
+}
 
-  MSGM_t_Coordinates.u_LonDirection = TempBuffer[u_start];             // Transfer the longitude direction portion of a message from temporary buffer to coordinates structure
+uint8_t MSGM_u_CircularBufferPop(e_RingBuffers e_BufferID)
+{
+  uint8_t u_pop_data = 0xFFu;                                                        // Value returned if there is no data
+
+  if (e_BufferID < NUM_OF_RING_BUFFERS)
+  {
+    (void)RINGB_u_Pop(&MSGM_a_Channels[e_BufferID].t_Ring, &u_pop_data);
+  }
+  return u_pop_data;                                                                 // Returns the value of the data being read
 }
 
 void MSGM_v_StateMachine()
 {
-  static e_SystemState  e_NextState = Idle_State;
-  static uint8_t u_Index     = 0u;
-  uint8_t u_RawStart = 1u;
-  uint8_t u_RawEnd = 0u;
+  t_RINGB_Ring *p_Ring = &MSGM_a_Channels[RING_BUFFER1].t_Ring;
 
-  for (uint8_t u_idx = 0u; u_idx < COORDINATES_BUFFER_LENGTH; u_idx++)
+  if (UBX_b_IsActive() == b_TRUE)
   {
-    switch (e_NextState)
-    {
-    case Idle_State:
-      if (MSGM_b_CircularBufferIsEmpty(RING_BUFFER1))
-      {
-      }
-      else
-      {
-        u_data = MSGM_u_CircularBufferPop(RING_BUFFER1);  // Fetch the data from circular buffer
-        if (u_data == '$')                                // Checks for '$' sign that signalizes beginning of the message
-        {
-          e_NextState = GPS_State;                        // Go to GPS state
-        }
-      }
-      break;
+    UBX_v_Process(p_Ring);                            // Fixed layout binary frames, no field scanning
+  }
+  else
+  {
+    NMEA_v_Process(p_Ring);                           // Frames, validates and dispatches every complete sentence in place
+  }
+}
 
-    case GPS_State:
-      u_data = MSGM_u_CircularBufferPop(RING_BUFFER1);    // Fetch the data from circular buffer
-      // There are two valid formats, GPGLL and GPRMC
-      if (u_data == 'L')//if (u_data == 'M')//if (u_data == 'L')
-      {
-        u_data = MSGM_u_CircularBufferPop(RING_BUFFER1);
-        // Letter A indicates valid coordinates
-        if (u_data == 'L')//if (u_data == 'A')  //if (u_data == 'L')                                // If this statement is true the message about to be received contains coordinates
-        {
-          e_NextState = Message_State;                    // Go to Message state
-        }
-        else
-        {
-          e_NextState = Idle_State;                       // Go to Idle state
-        }
-      }
-      break;
+void MSGM_v_PublishFix(e_MSGM_FixSource e_Source, const t_MSGM_Fix *p_Fix)
+{
+  if (e_Source >= NUM_OF_FIXES)
+  {
+    return;
+  }
+  t_MSGM_FixSlot *p_Slot = &MSGM_a_Fixes[e_Source];
+  uint32_t u_Sequence = p_Slot -> t_Fix.u_Sequence + 1u;
+
+  p_Slot -> u_Lock++;                                                                // Odd, readers overlapping the write read again
+  MSGM_FIX_BARRIER();
+  p_Slot -> t_Fix = *p_Fix;
+  p_Slot -> t_Fix.u_Sequence = (u_Sequence != 0u) ? u_Sequence : 1u;                 // 0 stays reserved for an empty slot
+  MSGM_FIX_BARRIER();
+  p_Slot -> u_Lock++;
+}
 
-    case Message_State:
-      u_data = MSGM_u_CircularBufferPop(RING_BUFFER1);    // Fetch the data from circular buffer
-      if (u_data == '*')                                  // Sign '*' signalizes the end of a message
-      {
-        uint8_t u_Cnt = 0;
-        // Save the raw message in order to send it via SIM800L module
-        while(u_RawStart != u_RawEnd)
-        {
-          u_RawMessageBuffer[u_Cnt] = a_TempBuffer[u_RawStart];
-          u_RawStart++;
-          u_Cnt++;
-        }
-        e_NextState = Transfer_State;                     // Go to Transfer state
-      }
-      else
+boolean MSGM_b_ReadFix(e_MSGM_FixSource e_Source, t_MSGM_Fix *p_Fix)
+{
+  if (e_Source >= NUM_OF_FIXES)
+  {
+    return b_FALSE;
+  }
+  const t_MSGM_FixSlot *p_Slot = &MSGM_a_Fixes[e_Source];
+
+  for (uint32_t u_Delay = 0u; u_Delay <= MSGM_FIX_READ_DELAYS; u_Delay++)
+  {
+    for (uint32_t u_Attempt = 0u; u_Attempt < MSGM_FIX_READ_ATTEMPTS; u_Attempt++)
+    {
+      uint32_t u_Lock = p_Slot -> u_Lock;
+
+      MSGM_FIX_BARRIER();
+      if ((u_Lock & 1u) == 0u)
       {
-        if (u_Index < COORDINATES_BUFFER_LENGTH)          // Checks if the message is valid and temporary buffer isn't overflowed
-        {
-          if (u_data != 255)                              // Checks for empty character if every character from the ring buffer is already popped
-          {
-            a_TempBuffer[u_Index++] = u_data;             // Fills the buffer with relevant data
-            u_RawEnd++;
-          }
-        }
-        else
+        *p_Fix = p_Slot -> t_Fix;
+        MSGM_FIX_BARRIER();
+        if (p_Slot -> u_Lock == u_Lock)
         {
-          e_NextState = Idle_State;                       // Go to Idle state
-          u_Index = 0u;
+          return (p_Fix -> u_Sequence != 0u) ? b_TRUE : b_FALSE;
         }
       }
-      break;
-
-    case Transfer_State:
-      u_Index = 0u;
-      MSGM_t_GetCoordinates(a_TempBuffer);                // Calls for function that parses the string from temporary buffer and formats it into coordinates
-      e_NextState = Idle_State;                           // Go back to Idle state
+    }
+    // Writer was preempted inside the write by this task, it finishes only when this task sleeps
+    if ((u_Delay == MSGM_FIX_READ_DELAYS) || (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING))
+    {
       break;
     }
+    vTaskDelay(1u);
   }
-}
-
-t_CoordinatesStructure * MSGM_p_GetCoordinates()
-{
-  return &MSGM_t_Coordinates;
-}
-
-uint8_t * MSGM_p_GetRawMessage()
-{
-  return u_RawMessageBuffer;
+  return b_FALSE;                                                                    // Slot kept changing, treated as empty
 }
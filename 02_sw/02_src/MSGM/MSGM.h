@@ -5,6 +5,9 @@
 #define MSGM_H_
 
 #include "UARTM.h"
+#include "RINGB.h"
+#include "FreeRTOS.h"
+#include "task.h"
 
 /// Used to define number of words in a dictionary
 #define MSGM_DICTIONARY_LENGTH (2u)
@@ -12,12 +15,34 @@
 #define MSGM_MESSAGE_BUFFER_LENGTH (10u)
 /// Used as a last slot of a temporary message buffer
 #define MSGM_MESSAGE_BUFFER_SLOT (9u)
-/// Defines the size of a ring buffer used to receive the data from the GPS module
-#define MSGM_RING_BUFFER_LENGTH (512u)
+/// Defines the size of the ring buffer used to receive the data from the GPS module, a power of two
+#define MSGM_GPS_RING_LENGTH (512u)
+/// Defines the size of the ring buffer used to receive the responses of the SIM800L module, a power of two
+#define MSGM_SIM_RING_LENGTH (256u)
 /// Used for size of an array that stores latitude and longitude
 #define COORDINATES_LENGTH (20u)
 /// Used as a size of a temporary buffer that stores coordinates from interrupt service routine
 #define COORDINATES_BUFFER_LENGTH (50u)
+/// Character that starts an NMEA sentence
+#define MSGM_SENTENCE_START ('$')
+/// Character that ends the data part of an NMEA sentence and wakes the consumer task
+#define MSGM_SENTENCE_END ('*')
+/// Number of characters of an NMEA address field, talker and sentence ID
+#define MSGM_ADDRESS_LENGTH (5u)
+/// Number of characters the ingress filter holds back until it decides, sentence start and address field
+#define MSGM_HEADER_LENGTH (1u + MSGM_ADDRESS_LENGTH)
+/// Character that ends a response line of the SIM800L module
+#define MSGM_LINE_END ('\n')
+/// Number of stored GPS bytes after which the consumer task is woken even without a sentence end
+#define MSGM_GPS_NOTIFY_THRESHOLD (MSGM_GPS_RING_LENGTH / 4u)
+/// Number of stored SIM800L bytes after which the consumer task is woken even without a line end
+#define MSGM_SIM_NOTIFY_THRESHOLD (MSGM_SIM_RING_LENGTH / 4u)
+/// Number of attempts to read a fix before the reader sleeps for a tick, so a preempted writer can finish
+#define MSGM_FIX_READ_ATTEMPTS (2u)
+/// Number of ticks a reader sleeps at most before it gives up on a slot, a writer finishes within one
+#define MSGM_FIX_READ_DELAYS (4u)
+/// Memory barrier placed between the sequence lock of a fix and its fields
+#define MSGM_FIX_BARRIER() __DMB()
 
 /// This enum is used for different types of messages sent to modules from UART
 typedef enum {
@@ -40,14 +65,6 @@ typedef enum
   b_FALSE  ///< Value used when the condition is false
 } boolean;
 
-typedef enum
-{
-  Idle_State,     ///< State in which the system is waiting for a '$' sign
-  GPS_State,      ///< State in which coordinates from the module are detected and to be extracted in the next state
-  Message_State,  ///< State in which message is being transfered to temporary buffer until the '*' sign
-  Transfer_State,  ///< State in which the extraction of relevant data is parsed from the string
-} e_SystemState;
-
 /// This structure is used as a buffer in a function that sorts messages
 typedef struct {
   uint8_t * u_RawMessage;  ///< Field used to receive a raw message from UART manager
@@ -56,28 +73,75 @@ typedef struct {
   uint8_t u_Length;        ///< Field used to store a length of a message
 } t_MessageElement;
 
-/// Structure used as a ring buffer
-typedef struct {
-  uint8_t  u_buffer[MSGM_RING_BUFFER_LENGTH]; ///< Ring buffer that stores the messages from GPS module
-  uint16_t u_head;                            ///< Variable used as a tracker of data being stored into a ring buffer
-  uint16_t u_tail;                            ///< Variable used as a tracker of data being popped out of a ring buffer
-  uint16_t u_count;                           ///< Tracks the difference between two trackers to check if data is being manipulated properly
-} t_CircularBuffer;
-
-typedef struct {
-  uint8_t a_Latitude [COORDINATES_LENGTH];    ///< Array with size of 20 to store latitude from GPS
-  uint8_t a_Longitude[COORDINATES_LENGTH];    ///< Array with size of 20 to store longitude from GPS
-  uint8_t u_LatDirection;                     ///< Direction for a latitude coordinate
-  uint8_t u_LonDirection;                     ///< Direction for a longitude coordinate
-} t_CoordinatesStructure;
-
 typedef enum
 {
-  RING_BUFFER1,                               ///< Enum of a ring buffers in a system
+  RING_BUFFER1,                               ///< Ring buffer of USART2 (GPS module)
+  RING_BUFFER2,                               ///< Ring buffer of USART3 (SIM800L module)
   NUM_OF_RING_BUFFERS                         ///< Number of buffers in a system
 } e_RingBuffers;
 
-t_CoordinatesStructure * MSGM_p_GetCoordinates();
+/// Function type which decides from the MSGM_ADDRESS_LENGTH characters of an address field if a sentence is stored
+typedef boolean (*t_MSGM_Admit)(const uint8_t *p_Address);
+
+/// This enum is used for the states of the ingress filter of a channel
+typedef enum
+{
+  MSGM_FILTER_DROP,                           ///< Bytes are dropped until a sentence start
+  MSGM_FILTER_ADDRESS,                        ///< Sentence start and address field are held until the address is complete
+  MSGM_FILTER_PASS                            ///< Bytes of an admitted sentence are stored
+} e_MSGM_FilterState;
+
+/// This enum is used for selecting what a channel does with bytes which do not fit into its ring buffer
+typedef enum
+{
+  MSGM_OVERFLOW_DROP_BYTES,                   ///< Bytes which do not fit are dropped, the consumer resynchronises itself
+  MSGM_OVERFLOW_DROP_FRAME                    ///< Rest of the frame is dropped too, its end byte is kept as a separator
+} e_MSGM_Overflow;
+
+/// This structure is used as an ingest channel, one per UART, written only by its ISR and read only by its task
+typedef struct
+{
+  t_RINGB_Ring      t_Ring;                   ///< Ring buffer of the channel
+  uint8_t           u_FrameEnd;               ///< Byte which ends a frame and wakes the consumer
+  volatile uint32_t u_NotifyThreshold;        ///< Number of stored bytes which wakes the consumer without a frame end
+  e_MSGM_Overflow   e_Overflow;               ///< What is done with bytes which do not fit
+  TaskHandle_t      t_Consumer;               ///< Task notified from the ISR, NULL if the task polls the channel
+  boolean           b_Discarding;             ///< b_TRUE while the rest of an overflowed frame is dropped
+  volatile uint32_t u_Dropped;                ///< Number of dropped bytes, written only by the ISR
+  volatile t_MSGM_Admit p_Admit;             ///< Ingress filter on the address field, NULL stores every byte
+  e_MSGM_FilterState e_Filter;                ///< State of the ingress filter, used only by the ISR
+  uint8_t           a_Header[MSGM_HEADER_LENGTH]; ///< Sentence start and address field held by the ingress filter
+  uint8_t           u_Held;                   ///< Number of held characters
+  volatile uint32_t u_Filtered;               ///< Number of bytes of sentences the filter did not admit, written only by the ISR
+} t_MSGM_Channel;
+
+/// This enum is used for the positions kept by the system, each in its own slot
+typedef enum
+{
+  MSGM_FIX_OWN,                               ///< Position of this device, written by the GPS decoders and the fix log
+  MSGM_FIX_TARGET,                            ///< Position the bearing points to, written by CALCM for SIM
+  NUM_OF_FIXES                                ///< Number of positions in a system
+} e_MSGM_FixSource;
+
+/// This structure is used as the canonical binary record of a position
+typedef struct
+{
+  int32_t           i_Latitude;               ///< Latitude in micro-degrees, north is positive
+  int32_t           i_Longitude;              ///< Longitude in micro-degrees, east is positive
+  uint32_t          u_Date;                   ///< UTC date as ddmmyy, 0 when it is not known
+  uint32_t          u_Time;                   ///< UTC time as hhmmss
+  uint16_t          u_Hdop;                   ///< Horizontal dilution of precision in 0.01
+  uint8_t           u_Quality;                ///< GGA fix quality, 0 when it is not known
+  uint8_t           u_Satellites;             ///< Number of satellites in use
+  uint32_t          u_Sequence;               ///< Number of records published into the slot, 0 while there is none
+} t_MSGM_Fix;
+
+/// This structure is used as a slot of a position, published through a sequence lock
+typedef struct
+{
+  volatile uint32_t u_Lock;                   ///< Odd while the writer changes t_Fix, readers retry when it changed
+  t_MSGM_Fix        t_Fix;                    ///< Last published record
+} t_MSGM_FixSlot;
 
 /// @brief Function used to sort a message taken from UART serial communication
 ///
@@ -185,26 +249,162 @@ e_Message MSGM_e_MessageRetrieve(e_ReceiverID e_ID);
 ///
 /// @return None
 ///
-/// @globals t_RingBuffer structure used as a ring buffer
+/// @globals MSGM_a_Channels table of ingest channels
 ///
-/// @InOutCorelation Function receives the data from interrupt routine and writes it into the ring buffer
+/// @InOutCorelation Function receives the data from interrupt routine, writes it into the ring buffer and wakes the consumer task.
+///                  A byte of a sentence the ingress filter does not admit is not stored, a byte which does not fit is
+///                  handled by the overflow policy of the channel.
 /// @callsequence
 ///   @startuml "MSGM_u_CircularBufferPush.png"
 ///     title "Sequence diagram for function MSGM_u_CircularBufferPush"
 ///     -> MSGM: MSGM_u_CircularBufferPush()
 ///     MSGM++
 ///         opt if Correct ring buffer is selected to store data
+///           MSGM -> MSGM: u_FilterPush(...)
+///           MSGM -> MSGM: v_NotifyConsumer(...)
 ///         end
-///         opt if Ring buffer is not full
-///         end
-///         opt if Reading pointer is ahead of a write pointer
-///         end
-///         rnote over MSGM: Stores the data inside of a ring buffer,\n checks if buffer is full and moves to next slot
 ///     <- MSGM
 ///        MSGM--
 ///   @enduml
 uint8_t MSGM_u_CircularBufferPush (e_RingBuffers e_BufferID, uint8_t UARTM_u_data);
 
+/// @brief Function used to write a block of received data into the ring buffer
+///
+/// @pre None
+/// @post As many bytes as fit are written into the ring buffer
+/// @param e_RingBuffers e_BufferID to send an ID of adequate buffer, const uint8_t *p_Data pointer to the block, uint16_t u_Length length of the block
+///
+/// @return Returns the number of bytes that were stored
+///
+/// @globals MSGM_a_Channels table of ingest channels
+///
+/// @InOutCorelation Function receives a block of data from the DMA receive path, writes it into the ring buffer and wakes the consumer task.
+///                  Sentences the ingress filter does not admit are skipped, bytes which do not fit are handled by the
+///                  overflow policy of the channel.
+/// @callsequence
+///   @startuml "MSGM_u_CircularBufferPushBlock.png"
+///     title "Sequence diagram for function MSGM_u_CircularBufferPushBlock"
+///     -> MSGM: MSGM_u_CircularBufferPushBlock()
+///     MSGM++
+///         opt if Correct ring buffer is selected to store data
+///           MSGM -> MSGM: u_FilterPush(...)
+///           MSGM -> MSGM: v_NotifyConsumer(...)
+///         end
+///     <- MSGM: Returns uint16_t with the number of stored bytes
+///        MSGM--
+///   @enduml
+uint16_t MSGM_u_CircularBufferPushBlock (e_RingBuffers e_BufferID, const uint8_t *p_Data, uint16_t u_Length);
+
+/// @brief Function used to register the task that consumes a ring buffer
+///
+/// @pre Task must be created
+/// @post Task is notified from the receive interrupts when a frame ends or the buffer fills up
+/// @param e_RingBuffers e_BufferID to send an ID of adequate buffer, TaskHandle_t t_Task task which reads the buffer
+///
+/// @return None
+///
+/// @globals MSGM_a_Channels table of ingest channels
+///
+/// @InOutCorelation Function connects a ring buffer with the task that drains it
+/// @callsequence
+///   @startuml "MSGM_v_SetConsumer.png"
+///     title "Sequence diagram for function MSGM_v_SetConsumer"
+///     -> MSGM: MSGM_v_SetConsumer()
+///     MSGM++
+///         rnote over MSGM: Stores the task handle for the ring buffer
+///     <- MSGM
+///        MSGM--
+///   @enduml
+void MSGM_v_SetConsumer (e_RingBuffers e_BufferID, TaskHandle_t t_Task);
+
+/// @brief Function used to change the number of stored bytes which wakes the consumer of a channel
+///
+/// @pre None
+/// @post Consumer is woken when u_Threshold bytes are stored even without a frame end
+/// @param e_RingBuffers e_BufferID, uint32_t u_Threshold
+///
+/// @return None
+///
+/// @globals MSGM_a_Channels table of ingest channels
+///
+/// @InOutCorelation Used when a protocol without a frame end byte takes over a channel, the threshold is a single
+///                  word which the receive interrupt reads atomically
+/// @callsequence
+///   @startuml "MSGM_v_SetNotifyThreshold.png"
+///     title "Sequence diagram for function MSGM_v_SetNotifyThreshold"
+///     -> MSGM: MSGM_v_SetNotifyThreshold()
+///     MSGM++
+///         rnote over MSGM: Stores the threshold of the channel
+///     <- MSGM
+///        MSGM--
+///   @enduml
+void MSGM_v_SetNotifyThreshold (e_RingBuffers e_BufferID, uint32_t u_Threshold);
+
+/// @brief Function used to read the number of bytes a channel has dropped
+///
+/// @pre None
+/// @post None
+/// @param e_RingBuffers e_BufferID
+///
+/// @return uint32_t number of bytes dropped since start up, 0 for an unknown buffer
+///
+/// @globals MSGM_a_Channels table of ingest channels
+///
+/// @InOutCorelation Counter is written only by the receive interrupt of the channel, so the other channel never adds to it
+/// @callsequence
+///   @startuml "MSGM_u_Dropped.png"
+///     title "Sequence diagram for function MSGM_u_Dropped"
+///     -> MSGM: MSGM_u_Dropped()
+///     MSGM++
+///     <- MSGM: Returns uint32_t with the number of dropped bytes
+///     MSGM--
+///   @enduml
+uint32_t MSGM_u_Dropped (e_RingBuffers e_BufferID);
+
+/// @brief Function used to change the ingress filter of a channel
+///
+/// @pre None
+/// @post Sentences starting after the change are stored only if p_Admit accepts their address field
+/// @param e_RingBuffers e_BufferID, t_MSGM_Admit p_Admit NULL to store every byte
+///
+/// @return None
+///
+/// @globals MSGM_a_Channels table of ingest channels
+///
+/// @InOutCorelation Function is called with the address field from the receive interrupt, so it must be short and
+///                  must not block. The pointer is a single word which the receive interrupt reads once per call.
+/// @callsequence
+///   @startuml "MSGM_v_SetAdmission.png"
+///     title "Sequence diagram for function MSGM_v_SetAdmission"
+///     -> MSGM: MSGM_v_SetAdmission()
+///     MSGM++
+///         rnote over MSGM: Stores the filter of the channel
+///     <- MSGM
+///        MSGM--
+///   @enduml
+void MSGM_v_SetAdmission (e_RingBuffers e_BufferID, t_MSGM_Admit p_Admit);
+
+/// @brief Function used to read the number of bytes the ingress filter of a channel has not stored
+///
+/// @pre None
+/// @post None
+/// @param e_RingBuffers e_BufferID
+///
+/// @return uint32_t number of filtered bytes since start up, 0 for an unknown buffer
+///
+/// @globals MSGM_a_Channels table of ingest channels
+///
+/// @InOutCorelation Filtered bytes are not counted by MSGM_u_Dropped, they never competed for space in the ring buffer
+/// @callsequence
+///   @startuml "MSGM_u_Filtered.png"
+///     title "Sequence diagram for function MSGM_u_Filtered"
+///     -> MSGM: MSGM_u_Filtered()
+///     MSGM++
+///     <- MSGM: Returns uint32_t with the number of filtered bytes
+///     MSGM--
+///   @enduml
+uint32_t MSGM_u_Filtered (e_RingBuffers e_BufferID);
+
 /// @brief Function used to read messages from the ring buffer
 ///
 /// @pre Buffer has the data that is not yet processed
@@ -213,19 +413,17 @@ uint8_t MSGM_u_CircularBufferPush (e_RingBuffers e_BufferID, uint8_t UARTM_u_dat
 ///
 /// @return Returns the data of type uint8_t that is being read
 ///
-/// @globals t_RingBuffer structure used as a ring buffer
+/// @globals MSGM_a_Channels table of ingest channels
 ///
-/// @InOutCorelation Function reads the data from the ring buffer and clears it
+/// @InOutCorelation Function reads the data from the ring buffer
 /// @callsequence
 ///   @startuml "MSGM_u_CircularBufferPop.png"
 ///     title "Sequence diagram for function MSGM_u_CircularBufferPop"
 ///     -> MSGM: MSGM_u_CircularBufferPop()
 ///     MSGM++
 ///         opt if Correct ring buffer is selected to store data
+///           MSGM -> RINGB: RINGB_u_Pop(...)
 ///         end
-///         opt if All of the data is popped
-///         end
-///         rnote over MSGM: Pops the data out of the ring buffer,\n moves to the next slot and clears the previous one
 ///     <- MSGM: Returns uint8_t with the data that was read most recently
 ///        MSGM--
 ///   @enduml
@@ -239,7 +437,7 @@ uint8_t MSGM_u_CircularBufferPop (e_RingBuffers e_BufferID);
 ///
 /// @return Boolean value that is true if the buffer is empty
 ///
-/// @globals t_RingBuffer structure with write and read pointers
+/// @globals MSGM_a_Channels table of ingest channels
 ///
 /// @InOutCorelation Function checks if the ring buffer is empty and returns the status of it
 /// @callsequence
@@ -252,145 +450,97 @@ uint8_t MSGM_u_CircularBufferPop (e_RingBuffers e_BufferID);
 ///   @enduml
 boolean MSGM_b_CircularBufferIsEmpty (e_RingBuffers e_BufferID);
 
-/// @brief Function used to go through a state machine and parse the part of a string for coordinates
+/// @brief Function used to parse coordinates out of the sentences received from the GPS module
 ///
 /// @pre Raw message must be stored into a ring buffer
-/// @post None
+/// @post Complete sentences are consumed from the ring buffer
 /// @param None
 ///
 /// @return None
 ///
-/// @globals e_SystemState type of a variable to set a state machine in an initial state,
-///          uint8_t data variable used to manipulate with the data from the ring buffer,
-///          t_RingBuffer structure that represents a ring buffer
+/// @globals MSGM_a_Channels table of ingest channels
 ///
-/// @InOutCorelation Function receives the data from the ring buffer through the pop function and parses coordinates from it
+/// @InOutCorelation Function hands the GPS ring buffer to the UBX framer once the module was switched to binary
+///                  output, otherwise to the NMEA framer. Both validate each frame and publish the position of a
+///                  valid fix as MSGM_FIX_OWN
 /// @callsequence
 ///   @startuml "MSGM_v_StateMachine.png"
 ///     title "Sequence diagram for function MSGM_v_StateMachine"
 ///     -> MSGM: MSGM_v_StateMachine(...)
 ///     MSGM++
-///     loop goes through the loop for a specific number of times to catch as many characters through interrupt routine
-///       rnote over MSGM: Goes through state machine cases
-///         opt switch Idle state
-///           opt if Checks if the buffer is empty
-///              MSGM -> MSGM: MSGM_b_CircularBufferIsEmpty(...)
-///           else else
-///              MSGM -> MSGM: MSGM_u_CircularBufferPop(...)
-///              opt if Checks if the data is equal to '$' sign
-///                rnote over MSGM: Goes to GPS state
-///              end
-///           end
-///     else else GPS state
-///         MSGM -> MSGM: MSGM_u_CircularBufferPop(...)
-///         opt if Data is equal to the sign 'L'
-///           MSGM -> MSGM: MSGM_u_CircularBufferPop(...)
-///           opt if Data is equal to the sign 'L'
-///             rnote over MSGM: Goes to Message state
-///           else else
-///             rnote over MSGM: Goes to Idle state
-///           end
-///         end
-///     else else Message state
-///         MSGM -> MSGM: MSGM_u_CircularBufferPop(...)
-///         opt if Data is equal to the sign '*'
-///           rnote over MSGM: u_RawEnd gets value of current index
-///           rnote over MSGM: Goes to Transfer State
-///           else else
-///             opt if Temporary buffer for data is full
-///               opt if System doesn't pop out of ring buffer while it's empty
-///                 rnote over MSGM: Goes to Transfer state
-///               end
-///             else else
-///               rnote over MSGM: Goes to Idle state and resets the position of a temporary buffer
-///             end
+///       alt if UBX_b_IsActive()
+///         MSGM -> UBX: UBX_v_Process(...)
+///       else else
+///         MSGM -> NMEA: NMEA_v_Process(...)
+///         NMEA++
+///         loop for each complete sentence
+///           rnote over NMEA: Checks the checksum and calls the extractor from the dispatch table
+///           NMEA -> MSGM: MSGM_v_PublishFix(MSGM_FIX_OWN, ...)
 ///         end
-///     else else Transfer state
-///        loop While counter reacher u_RawEnd
-///          rnote over MSGM: Writes values of a_TempBuffer in u_RawMessageBuffer
-///        end
-///        MSGM -> MSGM: MSGM_t_GetCoordinates(...)
-///        rnote over MSGM: Resets the position of temporary buffer and goes to Idle state
-///      end
-///     end
-///       <- MSGM
-///       MSGM--
+///         NMEA -> MSGM
+///         NMEA--
+///       end
+///     <- MSGM
+///     MSGM--
 ///   @enduml
 void MSGM_v_StateMachine ();
 
-/// @brief Function used to retrieve the coordinates
+/// @brief Function used for publishing a position into its slot
 ///
-/// @pre String with coordinates information is parsed and stored into the temporary buffer
-/// @post Stores the data into the coordinates structure
-/// @param uint8_t *TempBuffer that points to the buffer with the stored string with coordinates
+/// @pre Each slot is written by one task only: MSGM_FIX_OWN by TSK_Com and by FIXLOG before the scheduler is
+///      started, MSGM_FIX_TARGET by TSK_SIM
+/// @post Readers get the new record, u_Sequence of the slot is incremented
+/// @param e_MSGM_FixSource e_Source, const t_MSGM_Fix *p_Fix u_Sequence is not used
 ///
 /// @return None
 ///
-/// @globals t_Coordinates structure in which important data is stored, temporary buffer array from which the data is stored
+/// @globals MSGM_a_Fixes
 ///
-/// @InOutCorelation Function receives the data from temporary buffer, parses it and sends parts to structure
+/// @InOutCorelation Lock of the slot is odd while the record is written, so a reader which overlaps the write sees a
+///                  changed lock and reads again. The writer takes no lock and never waits for readers.
 /// @callsequence
-///   @startuml "MSGM_t_GetCoordinates.png"
-///     title "Sequence diagram for function MSGM_t_GetCoordinates"
-///     -> MSGM: MSGM_t_GetCoordinates()
+///   @startuml "MSGM_v_PublishFix.png"
+///     title "Sequence diagram for function MSGM_v_PublishFix"
+///     -> MSGM: MSGM_v_PublishFix(...)
 ///     MSGM++
-///         loop Goes through the temporary buffer until it reaches ',' sign
-///           rnote over MSGM: Stores the latitude coordinate from the buffer to structure field
-///         end
-///           rnote over MSGM: Stores the latitude direction from the buffer to structure field
-///          loop Goes through the temporary buffer again until it reaches ',' sign
-///             rnote over MSGM: Stores the longitude coordinate from the buffer to structure field
-///           end
-///             rnote over MSGM: Stores the longitude direction from the buffer to structure field
-///     <- MSGM
-///        MSGM--
-///   @enduml
-void MSGM_t_GetCoordinates (uint8_t* TempBuffer);
-
-/// @brief Function used for parsing a pointer to a buffer where processed message gotten through UART is written
-///
-/// @pre UART must be configured
-/// @post None
-/// @param  None
-///
-/// @return t_CoordinatesStructure MSGM_t_Coordinates
-///
-/// @globals t_CoordinatesStructure MSGM_t_Coordinates
-///
-/// @InOutCorelation Function sends pointer to MSGM_t_Coordinates buffer.
-/// @callsequence
-///   @startuml "MSGM_p_GetCoordinates.png"
-///     title "Sequence diagram for function MSGM_p_GetCoordinates"
-///     -> MSGM: MSGM_p_GetCoordinates()
-///     MSGM++
-///     rnote over MSGM: Coordinates are read from the buffer and sent as a pointer to a buffer.
+///       rnote over MSGM: Lock is made odd, memory barrier, record is written, memory barrier, lock is made even.
 ///     MSGM--
-///     <- MSGM://Returns a t_CoordinatesStructure * to a MSGM_t_Coordinates//
+///     <- MSGM
 ///   @enduml
 
-t_CoordinatesStructure * MSGM_p_GetCoordinates(void);
+void MSGM_v_PublishFix(e_MSGM_FixSource e_Source, const t_MSGM_Fix *p_Fix);
 
-/// @brief Function used for parsing a pointer to a buffer where raw message gotten through UART is written
+/// @brief Function used for reading a position from its slot
 ///
-/// @pre UART must be configured
-/// @post None
-/// @param  None
+/// @pre None
+/// @post p_Fix holds a record which was published as a whole
+/// @param e_MSGM_FixSource e_Source, t_MSGM_Fix *p_Fix
 ///
-/// @return uint8_t * u_RawMessageBuffer
+/// @return boolean b_TRUE if a record was published into the slot and read as a whole
 ///
-/// @globals uint8_t u_RawMessageBuffer[50u]
+/// @globals MSGM_a_Fixes
 ///
-/// @InOutCorelation Function sends pointer to u_RawMessageBuffer buffer.
+/// @InOutCorelation Record is copied without a lock and kept if the lock of the slot was even and did not change.
+///                  After MSGM_FIX_READ_ATTEMPTS overlapping writes the writer was preempted by this task, which may
+///                  have a higher priority, so the reader sleeps for a tick to let the writer finish and tries again.
+///                  After MSGM_FIX_READ_DELAYS ticks, or at once when the scheduler does not run, the reader gives up
+///                  and reports no record, as if nothing was published yet.
 /// @callsequence
-///   @startuml "MSGM_p_GetRawMessage.png"
-///     title "Sequence diagram for function MSGM_p_GetRawMessage"
-///     -> MSGM: MSGM_p_GetRawMessage()
+///   @startuml "MSGM_b_ReadFix.png"
+///     title "Sequence diagram for function MSGM_b_ReadFix"
+///     -> MSGM: MSGM_b_ReadFix(...)
 ///     MSGM++
-///       rnote over MSGM: Coordinates are read from the buffer and sent as a pointer to a buffer.
+///       loop up to MSGM_FIX_READ_ATTEMPTS
+///         rnote over MSGM: Lock is read, memory barrier, record is copied, memory barrier, lock is compared.
+///       end
+///       loop up to MSGM_FIX_READ_DELAYS while every attempt overlapped a write
+///         MSGM -> FreeRTOS: vTaskDelay(1)
+///         rnote over MSGM: Attempts are repeated.
+///       end
 ///     MSGM--
-///     <- MSGM://Returns a unit8_t * to a u_RawMessageBuffer//
+///     <- MSGM: Returns b_TRUE if there is a record
 ///   @enduml
 
-uint8_t * MSGM_p_GetRawMessage(void);
+boolean MSGM_b_ReadFix(e_MSGM_FixSource e_Source, t_MSGM_Fix *p_Fix);
 
 #endif /* MSGM_H_ */
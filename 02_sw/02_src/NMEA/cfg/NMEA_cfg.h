@@ -0,0 +1,24 @@
+/// @file NMEA_cfg.h
+/// @brief Contains configuration data used for framing and dispatching NMEA sentences
+/// @author Aleksandra Petrovic
+
+#ifndef NMEA_CFG_H_
+#define NMEA_CFG_H_
+
+#include "NMEA.h"
+
+/// Talker value in the dispatch table which accepts any talker (GP, GL, GN...)
+#define NMEA_ANY_TALKER ((const uint8_t *)"--")
+
+/// Table used to dispatch valid sentences to field extractors by talker and sentence ID
+const t_NMEA_Handler NMEA_t_Handlers[] = {
+		{ NMEA_ANY_TALKER,	(const uint8_t *)"GGA",	NMEA_v_ExtractGGA },
+		{ NMEA_ANY_TALKER,	(const uint8_t *)"RMC",	NMEA_v_ExtractRMC },
+		{ NMEA_ANY_TALKER,	(const uint8_t *)"GLL",	NMEA_v_ExtractGLL },
+		{ NMEA_ANY_TALKER,	(const uint8_t *)"VTG",	NMEA_v_ExtractVTG },
+		{ NMEA_ANY_TALKER,	(const uint8_t *)"GSA",	NMEA_v_ExtractGSA }
+};
+/// Used to determine the length of NMEA_t_Handlers array
+const uint16_t NMEA_u_HandlersLength = sizeof(NMEA_t_Handlers) / sizeof(NMEA_t_Handlers[0]);
+
+#endif /* NMEA_CFG_H_ */
@@ -0,0 +1,603 @@
+/// @file NMEA.c
+/// @brief Main file used for framing NMEA sentences in place inside a ring buffer and extracting their fields
+/// @author Aleksandra Petrovic
+
+#include "NMEA.h"
+#include "NMEA_cfg.h"
+#include "MSGM.h"
+#include "FIXLOG.h"
+#include "CALCM.h"
+
+/// This enum is used for the states of the sentence framer
+typedef enum
+{
+  NMEA_HUNT_STATE,           ///< State in which bytes are dropped until a '$' sign
+  NMEA_BODY_STATE,           ///< State in which the checksum is computed until a '*' sign
+  NMEA_CHECKSUM_HIGH_STATE,  ///< State in which the first checksum character is expected
+  NMEA_CHECKSUM_LOW_STATE    ///< State in which the second checksum character is expected
+} e_NMEA_FramerState;
+
+static e_NMEA_FramerState NMEA_e_State       = NMEA_HUNT_STATE;  // Framer waits for the beginning of a sentence
+static uint32_t           NMEA_u_Scanned     = 0u;               // Bytes of the current sentence already scanned, '$' is at offset 0
+static uint32_t           NMEA_u_BodyLength  = 0u;               // Characters between '$' and '*' of the current sentence
+static uint8_t            NMEA_u_Checksum    = 0u;               // XOR of the characters scanned so far
+static uint8_t            NMEA_u_Received    = 0u;               // Checksum received after '*'
+static t_NMEA_Info        NMEA_t_Info        = {0u};             // Navigation data filled by the extractors
+static t_NMEA_Statistics  NMEA_t_Statistics  = {0u};             // Framer counters
+static volatile uint32_t  NMEA_u_Admitted    = NMEA_ADMIT_ALL;   // Bit n admits the sentences of NMEA_t_Handlers[n] at ingress
+static uint8_t            NMEA_a_Position[COORDINATES_BUFFER_LENGTH] = {0u}; // Position fields in "latitude,N,longitude,E" format, parsed once
+
+_Static_assert(NMEA_ADDRESS_LENGTH == MSGM_ADDRESS_LENGTH, "MSGM filters on the NMEA address field");
+_Static_assert((sizeof(NMEA_t_Handlers) / sizeof(NMEA_t_Handlers[0])) <= 32u, "NMEA_u_Admitted has a bit per handler");
+
+/// @brief Function used to convert a hexadecimal character of the checksum
+///
+/// @pre None
+/// @post None
+/// @param uint8_t u_Char
+///
+/// @return uint8_t value of the character, 0xFF if it is not an upper case hexadecimal digit
+///
+/// @globals None
+///
+/// @InOutCorelation Function maps '0'-'9' and 'A'-'F' to their values.
+/// @callsequence
+///   @startuml "u_HexValue.png"
+///     title "Sequence diagram for function u_HexValue"
+///     -> NMEA: u_HexValue(...)
+///     NMEA++
+///     <- NMEA: Returns the value of the character
+///     NMEA--
+///   @enduml
+
+static uint8_t u_HexValue(uint8_t u_Char);
+
+static uint8_t u_HexValue(uint8_t u_Char)
+{
+  if ((u_Char >= '0') && (u_Char <= '9'))
+  {
+    return (uint8_t)(u_Char - '0');
+  }
+  if ((u_Char >= 'A') && (u_Char <= 'F'))
+  {
+    return (uint8_t)(u_Char - 'A' + 10u);
+  }
+  return 0xFFu;
+}
+
+/// @brief Function used to drop the scanned part of the current sentence and start hunting for the next one
+///
+/// @pre None
+/// @post Framer is in hunt state
+/// @param t_RINGB_Ring *p_Ring
+///
+/// @return uint32_t number of dropped bytes
+///
+/// @globals Framer state, t_NMEA_Statistics
+///
+/// @InOutCorelation Function releases the bytes scanned so far, the current byte stays so a '$' can start a new sentence.
+/// @callsequence
+///   @startuml "u_Reject.png"
+///     title "Sequence diagram for function u_Reject"
+///     -> NMEA: u_Reject(...)
+///     NMEA++
+///       NMEA -> RINGB: RINGB_u_Skip(...)
+///     <- NMEA: Returns the number of dropped bytes
+///     NMEA--
+///   @enduml
+
+static uint32_t u_Reject(t_RINGB_Ring *p_Ring);
+
+static uint32_t u_Reject(t_RINGB_Ring *p_Ring)
+{
+  uint32_t u_Dropped = RINGB_u_Skip(p_Ring, NMEA_u_Scanned);
+
+  NMEA_t_Statistics.u_DroppedBytes += u_Dropped;
+  NMEA_u_Scanned = 0u;
+  NMEA_e_State = NMEA_HUNT_STATE;
+  return u_Dropped;
+}
+
+/// @brief Function used to find the dispatch table entry of an address field
+///
+/// @pre None
+/// @post None
+/// @param const uint8_t *p_Address NMEA_ADDRESS_LENGTH characters
+///
+/// @return uint16_t index of the first matching handler, NMEA_u_HandlersLength if there is none
+///
+/// @globals NMEA_t_Handlers
+///
+/// @InOutCorelation Function compares the sentence ID first, the talker only if the handler names one.
+/// @callsequence
+///   @startuml "u_FindHandler.png"
+///     title "Sequence diagram for function u_FindHandler"
+///     -> NMEA: u_FindHandler(...)
+///     NMEA++
+///     <- NMEA: Returns the index of the handler
+///     NMEA--
+///   @enduml
+
+static uint16_t u_FindHandler(const uint8_t *p_Address);
+
+static uint16_t u_FindHandler(const uint8_t *p_Address)
+{
+  uint16_t u_Cnt = 0u;
+
+  for (u_Cnt = 0u; u_Cnt < NMEA_u_HandlersLength; u_Cnt++)
+  {
+    const t_NMEA_Handler *p_Handler = &NMEA_t_Handlers[u_Cnt];
+
+    if ((p_Handler -> u_SentenceId[0] != p_Address[2]) ||
+        (p_Handler -> u_SentenceId[1] != p_Address[3]) ||
+        (p_Handler -> u_SentenceId[2] != p_Address[4]))
+    {
+      continue;
+    }
+    if ((p_Handler -> u_Talker[0] != '-') &&
+        ((p_Handler -> u_Talker[0] != p_Address[0]) || (p_Handler -> u_Talker[1] != p_Address[1])))
+    {
+      continue;
+    }
+    break;
+  }
+  return u_Cnt;
+}
+
+/// @brief Function used to call the extractor of a valid sentence
+///
+/// @pre Sentence checksum must be valid
+/// @post Extractor from NMEA_t_Handlers is called if the address matches
+/// @param const t_NMEA_Sentence *p_Sentence
+///
+/// @return None
+///
+/// @globals NMEA_t_Handlers, t_NMEA_Statistics
+///
+/// @InOutCorelation Function compares the address field with the dispatch table and calls the first matching extractor.
+/// @callsequence
+///   @startuml "v_Dispatch.png"
+///     title "Sequence diagram for function v_Dispatch"
+///     -> NMEA: v_Dispatch(...)
+///     NMEA++
+///       NMEA -> NMEA: u_FindHandler(...)
+///       opt if talker and sentence ID match
+///         NMEA -> NMEA: p_Extractor(...)
+///       end
+///     <- NMEA
+///     NMEA--
+///   @enduml
+
+static void v_Dispatch(const t_NMEA_Sentence *p_Sentence);
+
+static void v_Dispatch(const t_NMEA_Sentence *p_Sentence)
+{
+  t_NMEA_Field t_Address;
+  uint8_t      a_Address[NMEA_ADDRESS_LENGTH];
+  uint16_t     u_Cnt   = 0u;
+  uint8_t      u_Index = 0u;
+
+  NMEA_v_FirstField(p_Sentence, &t_Address);
+  if (t_Address.u_Length != NMEA_ADDRESS_LENGTH)
+  {
+    return;                                                          // Proprietary or broken address, nothing to extract
+  }
+  for (u_Index = 0u; u_Index < NMEA_ADDRESS_LENGTH; u_Index++)
+  {
+    a_Address[u_Index] = NMEA_u_FieldChar(&t_Address, u_Index);
+  }
+
+  u_Cnt = u_FindHandler(a_Address);
+  if (u_Cnt < NMEA_u_HandlersLength)
+  {
+    NMEA_t_Statistics.u_Dispatched++;
+    NMEA_t_Handlers[u_Cnt].p_Extractor(p_Sentence);
+  }
+}
+
+void NMEA_v_Process(t_RINGB_Ring *p_Ring)
+{
+  uint32_t u_Count = RINGB_u_Count(p_Ring);                          // Snapshot, bytes arriving meanwhile are handled on the next wake up
+
+  while (NMEA_u_Scanned < u_Count)
+  {
+    uint8_t u_Char   = RINGB_u_PeekAt(p_Ring, NMEA_u_Scanned);
+    uint8_t u_Nibble = 0u;
+
+    switch (NMEA_e_State)
+    {
+    case NMEA_HUNT_STATE:
+      if (u_Char == '$')                                             // Beginning of a sentence stays in the ring buffer
+      {
+        NMEA_u_Checksum = 0u;
+        NMEA_u_Scanned = 1u;
+        NMEA_e_State = NMEA_BODY_STATE;
+      }
+      else
+      {
+        u_Count -= RINGB_u_Skip(p_Ring, 1u);
+        NMEA_t_Statistics.u_DroppedBytes++;
+      }
+      break;
+
+    case NMEA_BODY_STATE:
+      if (u_Char == '*')
+      {
+        NMEA_u_BodyLength = NMEA_u_Scanned - 1u;
+        NMEA_u_Scanned++;
+        NMEA_e_State = NMEA_CHECKSUM_HIGH_STATE;
+      }
+      else if ((u_Char == '$') || (u_Char == '\r') || (u_Char == '\n') || (NMEA_u_Scanned > NMEA_MAX_SENTENCE_LENGTH))
+      {
+        NMEA_t_Statistics.u_FramingErrors++;                         // Sentence was cut, a '$' here starts the next one
+        u_Count -= u_Reject(p_Ring);
+      }
+      else
+      {
+        NMEA_u_Checksum ^= u_Char;                                   // Checksum is computed while scanning, no second pass
+        NMEA_u_Scanned++;
+      }
+      break;
+
+    case NMEA_CHECKSUM_HIGH_STATE:
+      u_Nibble = u_HexValue(u_Char);
+      if (u_Nibble == 0xFFu)
+      {
+        NMEA_t_Statistics.u_FramingErrors++;
+        u_Count -= u_Reject(p_Ring);
+      }
+      else
+      {
+        NMEA_u_Received = (uint8_t)(u_Nibble << 4u);
+        NMEA_u_Scanned++;
+        NMEA_e_State = NMEA_CHECKSUM_LOW_STATE;
+      }
+      break;
+
+    case NMEA_CHECKSUM_LOW_STATE:
+      u_Nibble = u_HexValue(u_Char);
+      if (u_Nibble == 0xFFu)
+      {
+        NMEA_t_Statistics.u_FramingErrors++;
+        u_Count -= u_Reject(p_Ring);
+      }
+      else
+      {
+        NMEA_u_Scanned++;
+        if ((NMEA_u_Received | u_Nibble) == NMEA_u_Checksum)
+        {
+          t_NMEA_Sentence t_Sentence = { p_Ring, NMEA_u_BodyLength };
+
+          NMEA_t_Statistics.u_Sentences++;
+          v_Dispatch(&t_Sentence);                                   // Fields are read while the sentence is still in the ring buffer
+        }
+        else
+        {
+          NMEA_t_Statistics.u_ChecksumErrors++;
+        }
+        u_Count -= RINGB_u_Skip(p_Ring, NMEA_u_Scanned);             // Release the whole sentence at once
+        NMEA_u_Scanned = 0u;
+        NMEA_e_State = NMEA_HUNT_STATE;
+      }
+      break;
+    }
+  }
+}
+
+void NMEA_v_FirstField(const t_NMEA_Sentence *p_Sentence, t_NMEA_Field *p_Field)
+{
+  uint32_t u_End = 0u;
+
+  while ((u_End < p_Sentence -> u_Length) && (RINGB_u_PeekAt(p_Sentence -> p_Ring, u_End + 1u) != ','))
+  {
+    u_End++;
+  }
+  p_Field -> p_Sentence = p_Sentence;
+  p_Field -> u_Offset = 0u;
+  p_Field -> u_Length = u_End;
+  p_Field -> u_Index = 0u;
+}
+
+uint8_t NMEA_u_SeekField(t_NMEA_Field *p_Field, uint8_t u_Index)
+{
+  const t_NMEA_Sentence *p_Sentence = p_Field -> p_Sentence;
+
+  while (p_Field -> u_Index < u_Index)
+  {
+    uint32_t u_Start = p_Field -> u_Offset + p_Field -> u_Length;    // Position of the ',' that ends the current field
+    uint32_t u_End   = 0u;
+
+    if (u_Start >= p_Sentence -> u_Length)
+    {
+      return 0u;                                                     // Sentence has less fields than requested
+    }
+    u_Start++;
+    u_End = u_Start;
+    while ((u_End < p_Sentence -> u_Length) && (RINGB_u_PeekAt(p_Sentence -> p_Ring, u_End + 1u) != ','))
+    {
+      u_End++;
+    }
+    p_Field -> u_Offset = u_Start;
+    p_Field -> u_Length = u_End - u_Start;
+    p_Field -> u_Index++;
+  }
+  return (p_Field -> u_Index == u_Index) ? 1u : 0u;
+}
+
+uint8_t NMEA_u_FieldChar(const t_NMEA_Field *p_Field, uint32_t u_Position)
+{
+  return RINGB_u_PeekAt(p_Field -> p_Sentence -> p_Ring, p_Field -> u_Offset + u_Position + 1u);  // +1 skips the '$' sign
+}
+
+uint32_t NMEA_u_CopyField(const t_NMEA_Field *p_Field, uint8_t *p_Destination, uint32_t u_Size)
+{
+  uint32_t u_Cnt = 0u;
+
+  if (u_Size == 0u)
+  {
+    return 0u;
+  }
+  while ((u_Cnt < p_Field -> u_Length) && (u_Cnt < (u_Size - 1u)))
+  {
+    p_Destination[u_Cnt] = NMEA_u_FieldChar(p_Field, u_Cnt);
+    u_Cnt++;
+  }
+  p_Destination[u_Cnt] = '\0';
+  return u_Cnt;
+}
+
+uint32_t NMEA_u_FieldToFixed(const t_NMEA_Field *p_Field, uint8_t u_Decimals)
+{
+  uint32_t u_Value    = 0u;
+  uint32_t u_Cnt      = 0u;
+  uint8_t  u_Fraction = 0u;
+  uint8_t  u_Dot      = 0u;
+
+  for (u_Cnt = 0u; u_Cnt < p_Field -> u_Length; u_Cnt++)
+  {
+    uint8_t u_Char = NMEA_u_FieldChar(p_Field, u_Cnt);
+
+    if ((u_Char == '.') && (u_Dot == 0u))
+    {
+      u_Dot = 1u;
+    }
+    else if ((u_Char >= '0') && (u_Char <= '9'))
+    {
+      if (u_Dot == 1u)
+      {
+        if (u_Fraction == u_Decimals)
+        {
+          break;                                                     // Remaining fraction digits are truncated
+        }
+        u_Fraction++;
+      }
+      u_Value = (u_Value * 10u) + (uint32_t)(u_Char - '0');
+    }
+    else
+    {
+      break;
+    }
+  }
+  while (u_Fraction < u_Decimals)
+  {
+    u_Value *= 10u;
+    u_Fraction++;
+  }
+  return u_Value;
+}
+
+/// @brief Function used to store the position of a valid fix for the rest of the system
+///
+/// @pre Sentence must report a valid fix
+/// @post MSGM_FIX_OWN record holds the new position, the record is published without a lock
+/// @param const t_NMEA_Sentence *p_Sentence, uint8_t u_LatitudeIndex index of the latitude field
+///
+/// @return None
+///
+/// @globals NMEA_t_Info, NMEA_a_Position, MSGM_a_Fixes
+///
+/// @InOutCorelation Function copies latitude, its direction, longitude and its direction straight from the ring buffer
+///                  into NMEA_a_Position in "latitude,N,longitude,E" format. The text is parsed once into
+///                  micro-degrees and published with the time and quality of the fix, readers never parse text.
+/// @callsequence
+///   @startuml "v_StorePosition.png"
+///     title "Sequence diagram for function v_StorePosition"
+///     -> NMEA: v_StorePosition(...)
+///     NMEA++
+///       loop for four position fields
+///         NMEA -> NMEA: NMEA_u_SeekField(...)
+///         NMEA -> NMEA: NMEA_u_CopyField(...)
+///       end
+///       NMEA -> CALCM: CALCM_e_ParsePosition(p_Raw, ...)
+///       opt if position is valid
+///         NMEA -> MSGM: MSGM_v_PublishFix(MSGM_FIX_OWN, ...)
+///         NMEA -> FIXLOG: FIXLOG_v_Record(...)
+///       end
+///     <- NMEA
+///     NMEA--
+///   @enduml
+
+static void v_StorePosition(const t_NMEA_Sentence *p_Sentence, uint8_t u_LatitudeIndex);
+
+static void v_StorePosition(const t_NMEA_Sentence *p_Sentence, uint8_t u_LatitudeIndex)
+{
+  uint8_t                *p_Raw         = NMEA_a_Position;
+  t_NMEA_Field            t_Field;
+  t_MSGM_Fix              t_Fix         = {0};
+  uint32_t                u_Cnt         = 0u;
+  uint8_t                 u_Index       = 0u;
+
+  NMEA_v_FirstField(p_Sentence, &t_Field);
+  if ((NMEA_u_SeekField(&t_Field, (uint8_t)(u_LatitudeIndex + 3u)) == 0u) || (t_Field.u_Length == 0u))
+  {
+    return;                                                          // Longitude direction is missing, position is incomplete
+  }
+
+  // Text is used only by TSK_Com, other tasks read the published record
+  NMEA_v_FirstField(p_Sentence, &t_Field);
+  for (u_Index = 0u; u_Index < 4u; u_Index++)
+  {
+    (void)NMEA_u_SeekField(&t_Field, (uint8_t)(u_LatitudeIndex + u_Index));
+    if (u_Index != 0u)
+    {
+      p_Raw[u_Cnt++] = ',';
+    }
+    u_Cnt += NMEA_u_CopyField(&t_Field, &p_Raw[u_Cnt], (COORDINATES_BUFFER_LENGTH - (3u - u_Index)) - u_Cnt);  // Leaves room for the remaining separators
+  }
+  if (CALCM_e_ParsePosition(p_Raw, (uint8_t)u_Cnt, &t_Fix.i_Latitude, &t_Fix.i_Longitude) == CALCM_PARSE_OK)
+  {
+    t_Fix.u_Date       = NMEA_t_Info.u_Date;
+    t_Fix.u_Time       = NMEA_t_Info.u_Time;
+    t_Fix.u_Hdop       = NMEA_t_Info.u_Hdop;
+    t_Fix.u_Quality    = NMEA_t_Info.u_FixQuality;
+    t_Fix.u_Satellites = NMEA_t_Info.u_Satellites;
+    MSGM_v_PublishFix(MSGM_FIX_OWN, &t_Fix);                         // Readers retry when they overlap the write
+    FIXLOG_v_Record(&t_Fix);                                         // Flash is written later by TSK_Log
+  }
+}
+
+void NMEA_v_ExtractGGA(const t_NMEA_Sentence *p_Sentence)
+{
+  t_NMEA_Field t_Field;
+
+  NMEA_t_Info.u_FixQuality = 0u;                                     // No fix until this sentence reports one
+  NMEA_v_FirstField(p_Sentence, &t_Field);
+  if (NMEA_u_SeekField(&t_Field, 1u) == 1u)
+  {
+    NMEA_t_Info.u_Time = NMEA_u_FieldToFixed(&t_Field, 0u);
+  }
+  if (NMEA_u_SeekField(&t_Field, 6u) == 1u)
+  {
+    NMEA_t_Info.u_FixQuality = (uint8_t)NMEA_u_FieldToFixed(&t_Field, 0u);
+  }
+  if (NMEA_u_SeekField(&t_Field, 7u) == 1u)
+  {
+    NMEA_t_Info.u_Satellites = (uint8_t)NMEA_u_FieldToFixed(&t_Field, 0u);
+  }
+  if (NMEA_u_SeekField(&t_Field, 8u) == 1u)
+  {
+    NMEA_t_Info.u_Hdop = (uint16_t)NMEA_u_FieldToFixed(&t_Field, 2u);
+  }
+  if (NMEA_t_Info.u_FixQuality != 0u)
+  {
+    v_StorePosition(p_Sentence, 2u);
+  }
+}
+
+void NMEA_v_ExtractRMC(const t_NMEA_Sentence *p_Sentence)
+{
+  t_NMEA_Field t_Field;
+
+  NMEA_t_Info.u_Valid = 0u;                                          // No fix until this sentence reports one
+  NMEA_v_FirstField(p_Sentence, &t_Field);
+  if (NMEA_u_SeekField(&t_Field, 1u) == 1u)
+  {
+    NMEA_t_Info.u_Time = NMEA_u_FieldToFixed(&t_Field, 0u);
+  }
+  if (NMEA_u_SeekField(&t_Field, 2u) == 1u)
+  {
+    NMEA_t_Info.u_Valid = ((t_Field.u_Length != 0u) && (NMEA_u_FieldChar(&t_Field, 0u) == 'A')) ? 1u : 0u;
+  }
+  if (NMEA_u_SeekField(&t_Field, 7u) == 1u)
+  {
+    NMEA_t_Info.u_Speed = (uint16_t)NMEA_u_FieldToFixed(&t_Field, 2u);
+  }
+  if (NMEA_u_SeekField(&t_Field, 8u) == 1u)
+  {
+    NMEA_t_Info.u_Course = (uint16_t)NMEA_u_FieldToFixed(&t_Field, 1u);
+  }
+  if (NMEA_u_SeekField(&t_Field, 9u) == 1u)
+  {
+    NMEA_t_Info.u_Date = NMEA_u_FieldToFixed(&t_Field, 0u);
+  }
+  if (NMEA_t_Info.u_Valid == 1u)
+  {
+    v_StorePosition(p_Sentence, 3u);
+  }
+}
+
+void NMEA_v_ExtractGLL(const t_NMEA_Sentence *p_Sentence)
+{
+  t_NMEA_Field t_Field;
+
+  NMEA_t_Info.u_Valid = 0u;                                          // No fix until this sentence reports one
+  NMEA_v_FirstField(p_Sentence, &t_Field);
+  if (NMEA_u_SeekField(&t_Field, 5u) == 1u)
+  {
+    NMEA_t_Info.u_Time = NMEA_u_FieldToFixed(&t_Field, 0u);
+  }
+  if (NMEA_u_SeekField(&t_Field, 6u) == 1u)
+  {
+    NMEA_t_Info.u_Valid = ((t_Field.u_Length != 0u) && (NMEA_u_FieldChar(&t_Field, 0u) == 'A')) ? 1u : 0u;
+  }
+  if (NMEA_t_Info.u_Valid == 1u)
+  {
+    v_StorePosition(p_Sentence, 1u);
+  }
+}
+
+void NMEA_v_ExtractVTG(const t_NMEA_Sentence *p_Sentence)
+{
+  t_NMEA_Field t_Field;
+
+  NMEA_v_FirstField(p_Sentence, &t_Field);
+  if ((NMEA_u_SeekField(&t_Field, 1u) == 1u) && (t_Field.u_Length != 0u))
+  {
+    NMEA_t_Info.u_Course = (uint16_t)NMEA_u_FieldToFixed(&t_Field, 1u);
+  }
+  if ((NMEA_u_SeekField(&t_Field, 5u) == 1u) && (t_Field.u_Length != 0u))
+  {
+    NMEA_t_Info.u_Speed = (uint16_t)NMEA_u_FieldToFixed(&t_Field, 2u);
+  }
+}
+
+void NMEA_v_ExtractGSA(const t_NMEA_Sentence *p_Sentence)
+{
+  t_NMEA_Field t_Field;
+
+  NMEA_v_FirstField(p_Sentence, &t_Field);
+  if (NMEA_u_SeekField(&t_Field, 2u) == 1u)
+  {
+    NMEA_t_Info.u_FixMode = (uint8_t)NMEA_u_FieldToFixed(&t_Field, 0u);
+  }
+  if ((NMEA_u_SeekField(&t_Field, 16u) == 1u) && (t_Field.u_Length != 0u))
+  {
+    NMEA_t_Info.u_Hdop = (uint16_t)NMEA_u_FieldToFixed(&t_Field, 2u);
+  }
+}
+
+t_NMEA_Info * NMEA_p_GetInfo(void)
+{
+  return &NMEA_t_Info;
+}
+
+t_NMEA_Statistics * NMEA_p_GetStatistics(void)
+{
+  return &NMEA_t_Statistics;
+}
+
+boolean NMEA_b_Admit(const uint8_t *p_Address)
+{
+  uint16_t u_Index = u_FindHandler(p_Address);
+
+  if ((u_Index < NMEA_u_HandlersLength) && ((NMEA_u_Admitted & (1uL << u_Index)) != 0u))
+  {
+    return b_TRUE;
+  }
+  return b_FALSE;                                                    // GSV, TXT and proprietary sentences are never extracted
+}
+
+void NMEA_v_SetAdmitted(const uint8_t *p_SentenceId, boolean b_Admit)
+{
+  taskENTER_CRITICAL();                                              // Several tasks may change the set
+  for (uint16_t u_Cnt = 0u; u_Cnt < NMEA_u_HandlersLength; u_Cnt++)
+  {
+    const uint8_t *p_Id = NMEA_t_Handlers[u_Cnt].u_SentenceId;
+
+    if ((p_Id[0] == p_SentenceId[0]) && (p_Id[1] == p_SentenceId[1]) && (p_Id[2] == p_SentenceId[2]))
+    {
+      NMEA_u_Admitted = (b_Admit == b_TRUE) ? (NMEA_u_Admitted | (1uL << u_Cnt)) : (NMEA_u_Admitted & ~(1uL << u_Cnt));
+    }
+  }
+  taskEXIT_CRITICAL();
+}
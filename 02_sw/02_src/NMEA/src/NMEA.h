@@ -0,0 +1,346 @@
+/// @file NMEA.h
+/// @brief Header file used for framing NMEA sentences in place inside a ring buffer and extracting their fields
+/// @author Aleksandra Petrovic
+
+#ifndef NMEA_H_
+#define NMEA_H_
+
+#include <stdint.h>
+#include "RINGB.h"
+#include "MSGM.h"
+
+/// Maximum number of characters between '$' and '*' of a sentence (NMEA 0183 allows 82 characters in total)
+#define NMEA_MAX_SENTENCE_LENGTH (79u)
+/// Length of the address field (talker + sentence ID)
+#define NMEA_ADDRESS_LENGTH (5u)
+/// Length of the talker part of the address field
+#define NMEA_TALKER_LENGTH (2u)
+/// Value of the ingress set which admits every sentence of the dispatch table
+#define NMEA_ADMIT_ALL (0xFFFFFFFFuL)
+
+/// Structure used to describe a received sentence in place, without copying it out of the ring buffer
+typedef struct {
+  const t_RINGB_Ring * p_Ring;   ///< Ring buffer the sentence is stored in, '$' is the oldest byte
+  uint32_t             u_Length; ///< Number of characters between '$' and '*'
+} t_NMEA_Sentence;
+
+/// Structure used as a cursor over comma separated fields of a sentence
+typedef struct {
+  const t_NMEA_Sentence * p_Sentence; ///< Sentence the field belongs to
+  uint32_t                u_Offset;   ///< Offset of the first field character from the character after '$'
+  uint32_t                u_Length;   ///< Number of characters in the field
+  uint8_t                 u_Index;    ///< Index of the field, 0 is the address field
+} t_NMEA_Field;
+
+/// Function type of field extractors called for valid sentences
+typedef void (*t_NMEA_Extractor)(const t_NMEA_Sentence *p_Sentence);
+
+/// Structure used as an element of the dispatch table
+typedef struct {
+  const uint8_t *  u_Talker;     ///< Two characters of the talker or NMEA_ANY_TALKER
+  const uint8_t *  u_SentenceId; ///< Three characters of the sentence ID
+  t_NMEA_Extractor p_Extractor;  ///< Function called for the sentence
+} t_NMEA_Handler;
+
+/// Structure used for navigation data that is not part of the coordinates
+typedef struct {
+  uint32_t u_Time;        ///< UTC time as hhmmss
+  uint32_t u_Date;        ///< UTC date as ddmmyy
+  uint16_t u_Speed;       ///< Speed over ground in 0.01 knots
+  uint16_t u_Course;      ///< Course over ground in 0.1 degrees
+  uint16_t u_Hdop;        ///< Horizontal dilution of precision in 0.01
+  uint8_t  u_FixQuality;  ///< GGA fix quality, 0 means no fix
+  uint8_t  u_Satellites;  ///< Number of satellites in use
+  uint8_t  u_FixMode;     ///< GSA fix mode, 1 no fix, 2 2D, 3 3D
+  uint8_t  u_Valid;       ///< 1 if the last RMC/GLL status was 'A'
+} t_NMEA_Info;
+
+/// Structure used for framer statistics
+typedef struct {
+  uint32_t u_Sentences;      ///< Sentences with a correct checksum
+  uint32_t u_Dispatched;     ///< Correct sentences which had an extractor in the dispatch table
+  uint32_t u_ChecksumErrors; ///< Sentences rejected because of a wrong checksum
+  uint32_t u_FramingErrors;  ///< Sentences rejected because of a broken frame
+  uint32_t u_DroppedBytes;   ///< Bytes dropped outside of sentences or from rejected sentences
+} t_NMEA_Statistics;
+
+/// @brief Function used to frame, validate and dispatch all complete sentences stored in a ring buffer
+///
+/// @pre Ring buffer is written by the GPS receive interrupt, this function is its only reader
+/// @post Complete sentences are consumed, an incomplete one stays in the ring buffer until more data arrives
+/// @param t_RINGB_Ring *p_Ring
+///
+/// @return None
+///
+/// @globals Framer state (only one ring buffer can be framed), t_NMEA_Statistics
+///
+/// @InOutCorelation Function scans each byte once, computes the XOR checksum while scanning and calls extractors in place.
+/// @callsequence
+///   @startuml "NMEA_v_Process.png"
+///     title "Sequence diagram for function NMEA_v_Process"
+///     -> NMEA: NMEA_v_Process(...)
+///     NMEA++
+///     loop while there are unscanned bytes
+///       NMEA -> RINGB: RINGB_u_PeekAt(...)
+///       opt if waiting for '$'
+///         rnote over NMEA: Drop the byte unless it is '$'
+///       else else inside of a sentence
+///         rnote over NMEA: XOR the byte into the checksum until '*', reject on '$', CR, LF or too long sentence
+///       else else checksum characters
+///         opt if checksum matches
+///           NMEA -> NMEA: v_Dispatch(...)
+///         end
+///         NMEA -> RINGB: RINGB_u_Skip(...)
+///       end
+///     end
+///     <- NMEA
+///     NMEA--
+///   @enduml
+void NMEA_v_Process(t_RINGB_Ring *p_Ring);
+
+/// @brief Function used to position a field cursor on the address field of a sentence
+///
+/// @pre Sentence must be valid
+/// @post Cursor describes field 0
+/// @param const t_NMEA_Sentence *p_Sentence, t_NMEA_Field *p_Field
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Function finds the end of the first field.
+/// @callsequence
+///   @startuml "NMEA_v_FirstField.png"
+///     title "Sequence diagram for function NMEA_v_FirstField"
+///     -> NMEA: NMEA_v_FirstField(...)
+///     NMEA++
+///       loop until ',' or end of sentence
+///         NMEA -> RINGB: RINGB_u_PeekAt(...)
+///       end
+///     <- NMEA
+///     NMEA--
+///   @enduml
+void NMEA_v_FirstField(const t_NMEA_Sentence *p_Sentence, t_NMEA_Field *p_Field);
+
+/// @brief Function used to move a field cursor forward to the field with the parsed index
+///
+/// @pre Cursor must be positioned with NMEA_v_FirstField
+/// @post Cursor describes the requested field if it exists
+/// @param t_NMEA_Field *p_Field, uint8_t u_Index
+///
+/// @return uint8_t 1 if the field exists, 0 otherwise
+///
+/// @globals None
+///
+/// @InOutCorelation Function skips fields until the requested one is reached, it never moves backwards.
+/// @callsequence
+///   @startuml "NMEA_u_SeekField.png"
+///     title "Sequence diagram for function NMEA_u_SeekField"
+///     -> NMEA: NMEA_u_SeekField(...)
+///     NMEA++
+///       loop while the index of the cursor is smaller than the requested one
+///         rnote over NMEA: Move to the character after the next ',' and find the end of the field.
+///       end
+///     <- NMEA: Returns 1 if the field exists
+///     NMEA--
+///   @enduml
+uint8_t NMEA_u_SeekField(t_NMEA_Field *p_Field, uint8_t u_Index);
+
+/// @brief Function used to read a character of a field
+///
+/// @pre u_Position must be smaller than the length of the field
+/// @post None
+/// @param const t_NMEA_Field *p_Field, uint32_t u_Position
+///
+/// @return uint8_t character
+///
+/// @globals None
+///
+/// @InOutCorelation Function reads the character directly from the ring buffer.
+/// @callsequence
+///   @startuml "NMEA_u_FieldChar.png"
+///     title "Sequence diagram for function NMEA_u_FieldChar"
+///     -> NMEA: NMEA_u_FieldChar(...)
+///     NMEA++
+///       NMEA -> RINGB: RINGB_u_PeekAt(...)
+///     <- NMEA: Returns the character
+///     NMEA--
+///   @enduml
+uint8_t NMEA_u_FieldChar(const t_NMEA_Field *p_Field, uint32_t u_Position);
+
+/// @brief Function used to copy a field into its final destination as a NULL terminated string
+///
+/// @pre None
+/// @post Destination holds the field, cut to u_Size - 1 characters
+/// @param const t_NMEA_Field *p_Field, uint8_t *p_Destination, uint32_t u_Size
+///
+/// @return uint32_t number of copied characters
+///
+/// @globals None
+///
+/// @InOutCorelation Function copies the field out of the ring buffer and terminates it.
+/// @callsequence
+///   @startuml "NMEA_u_CopyField.png"
+///     title "Sequence diagram for function NMEA_u_CopyField"
+///     -> NMEA: NMEA_u_CopyField(...)
+///     NMEA++
+///       loop for each character of the field that fits
+///         NMEA -> RINGB: RINGB_u_PeekAt(...)
+///       end
+///     <- NMEA: Returns the number of copied characters
+///     NMEA--
+///   @enduml
+uint32_t NMEA_u_CopyField(const t_NMEA_Field *p_Field, uint8_t *p_Destination, uint32_t u_Size);
+
+/// @brief Function used to convert a decimal field into a fixed point number
+///
+/// @pre None
+/// @post None
+/// @param const t_NMEA_Field *p_Field, uint8_t u_Decimals number of fraction digits kept
+///
+/// @return uint32_t value multiplied by 10^u_Decimals, 0 for an empty field
+///
+/// @globals None
+///
+/// @InOutCorelation Function accumulates digits in one pass, extra fraction digits are truncated and missing ones padded.
+/// @callsequence
+///   @startuml "NMEA_u_FieldToFixed.png"
+///     title "Sequence diagram for function NMEA_u_FieldToFixed"
+///     -> NMEA: NMEA_u_FieldToFixed(...)
+///     NMEA++
+///       loop for each character of the field
+///         rnote over NMEA: Accumulates digits, counts fraction digits after '.'
+///       end
+///     <- NMEA: Returns the fixed point value
+///     NMEA--
+///   @enduml
+uint32_t NMEA_u_FieldToFixed(const t_NMEA_Field *p_Field, uint8_t u_Decimals);
+
+/// @brief Field extractors called from the dispatch table for GGA, RMC, GLL, VTG and GSA sentences
+///
+/// @pre Sentence checksum must be valid
+/// @post Position of a valid fix is published as MSGM_FIX_OWN, other data is stored into t_NMEA_Info
+/// @param const t_NMEA_Sentence *p_Sentence
+///
+/// @return None
+///
+/// @globals t_NMEA_Info, NMEA_a_Position, MSGM_a_Fixes
+///
+/// @InOutCorelation Functions walk the fields once with a cursor and write them directly to their destination.
+///                  GGA fix quality and RMC/GLL status start as no fix, a sentence without them never publishes a
+///                  position on the strength of an earlier sentence.
+/// @callsequence
+///   @startuml "NMEA_v_Extract.png"
+///     title "Sequence diagram for NMEA field extractors"
+///     -> NMEA: NMEA_v_ExtractGGA/RMC/GLL/VTG/GSA(...)
+///     NMEA++
+///       NMEA -> NMEA: NMEA_v_FirstField(...)
+///       loop for each needed field
+///         NMEA -> NMEA: NMEA_u_SeekField(...)
+///       end
+///       opt if sentence reports a valid fix
+///         rnote over NMEA: Latitude and longitude are copied to NMEA_a_Position and parsed.
+///         NMEA -> MSGM: MSGM_v_PublishFix(MSGM_FIX_OWN, ...)
+///       end
+///     <- NMEA
+///     NMEA--
+///   @enduml
+void NMEA_v_ExtractGGA(const t_NMEA_Sentence *p_Sentence);
+void NMEA_v_ExtractRMC(const t_NMEA_Sentence *p_Sentence);
+void NMEA_v_ExtractGLL(const t_NMEA_Sentence *p_Sentence);
+void NMEA_v_ExtractVTG(const t_NMEA_Sentence *p_Sentence);
+void NMEA_v_ExtractGSA(const t_NMEA_Sentence *p_Sentence);
+
+/// @brief Function used for getting navigation data that is not part of the coordinates
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return t_NMEA_Info * pointer to the navigation data
+///
+/// @globals t_NMEA_Info
+///
+/// @InOutCorelation Function returns a pointer to the data filled by the extractors.
+/// @callsequence
+///   @startuml "NMEA_p_GetInfo.png"
+///     title "Sequence diagram for function NMEA_p_GetInfo"
+///     -> NMEA: NMEA_p_GetInfo()
+///     NMEA++
+///     <- NMEA://Returns a t_NMEA_Info *//
+///     NMEA--
+///   @enduml
+t_NMEA_Info * NMEA_p_GetInfo(void);
+
+/// @brief Function used for getting framer statistics
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return t_NMEA_Statistics * pointer to the statistics
+///
+/// @globals t_NMEA_Statistics
+///
+/// @InOutCorelation Function returns a pointer to the counters updated by NMEA_v_Process.
+/// @callsequence
+///   @startuml "NMEA_p_GetStatistics.png"
+///     title "Sequence diagram for function NMEA_p_GetStatistics"
+///     -> NMEA: NMEA_p_GetStatistics()
+///     NMEA++
+///     <- NMEA://Returns a t_NMEA_Statistics *//
+///     NMEA--
+///   @enduml
+t_NMEA_Statistics * NMEA_p_GetStatistics(void);
+
+/// @brief Function used as the ingress filter of the GPS channel
+///
+/// @pre Called from the receive interrupt through MSGM_v_SetAdmission
+/// @post None
+/// @param const uint8_t *p_Address NMEA_ADDRESS_LENGTH characters following '$'
+///
+/// @return boolean b_TRUE if the sentence has an extractor which is admitted
+///
+/// @globals NMEA_t_Handlers, NMEA_u_Admitted
+///
+/// @InOutCorelation Admitted set is derived from the dispatch table, so a sentence which would only be dropped by
+///                  v_Dispatch never takes space in the ring buffer and is never scanned by NMEA_v_Process.
+/// @callsequence
+///   @startuml "NMEA_b_Admit.png"
+///     title "Sequence diagram for function NMEA_b_Admit"
+///     -> NMEA: NMEA_b_Admit(...)
+///     NMEA++
+///       NMEA -> NMEA: u_FindHandler(...)
+///     <- NMEA: Returns b_TRUE if the handler is admitted
+///     NMEA--
+///   @enduml
+boolean NMEA_b_Admit(const uint8_t *p_Address);
+
+/// @brief Function used to change at run time which sentences are admitted by the ingress filter
+///
+/// @pre Must be called from a task
+/// @post Sentences with the ID starting after the change are stored or filtered, for every talker
+/// @param const uint8_t *p_SentenceId three characters, boolean b_Admit
+///
+/// @return None
+///
+/// @globals NMEA_t_Handlers, NMEA_u_Admitted
+///
+/// @InOutCorelation Only IDs of the dispatch table can be admitted. The set is a single word which the receive
+///                  interrupt reads atomically.
+/// @callsequence
+///   @startuml "NMEA_v_SetAdmitted.png"
+///     title "Sequence diagram for function NMEA_v_SetAdmitted"
+///     -> NMEA: NMEA_v_SetAdmitted(...)
+///     NMEA++
+///       loop goes through the dispatch table
+///         opt if sentence ID matches
+///           rnote over NMEA: Set or clear the bit of the handler
+///         end
+///       end
+///     <- NMEA
+///     NMEA--
+///   @enduml
+void NMEA_v_SetAdmitted(const uint8_t *p_SentenceId, boolean b_Admit);
+
+#endif /* NMEA_H_ */
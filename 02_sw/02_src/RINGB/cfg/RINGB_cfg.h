@@ -0,0 +1,16 @@
+/// @file RINGB_cfg.h
+/// @brief Contains configuration data used for single-producer/single-consumer ring buffers
+/// @author Aleksandra Petrovic
+
+#ifndef RINGB_CFG_H_
+#define RINGB_CFG_H_
+
+#include "stm32f439xx.h"
+
+/// Size in bytes that producer and consumer indexes are kept apart so they never share a cache line
+#define RINGB_CACHE_LINE_SIZE (32u)
+
+/// Memory barrier placed between buffer accesses and index publication
+#define RINGB_MEMORY_BARRIER() __DMB()
+
+#endif /* RINGB_CFG_H_ */
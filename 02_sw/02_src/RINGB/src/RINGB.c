@@ -0,0 +1,131 @@
+/// @file RINGB.c
+/// @brief Main file used for lock-free single-producer/single-consumer ring buffers
+/// @author Aleksandra Petrovic
+
+#include "RINGB.h"
+#include <string.h>
+
+void RINGB_v_Init(t_RINGB_Ring *p_Ring, uint8_t *p_Storage, uint32_t u_Size)
+{
+  p_Ring -> u_Head   = 0u;
+  p_Ring -> u_Tail   = 0u;
+  p_Ring -> p_Buffer = p_Storage;
+  p_Ring -> u_Mask   = u_Size - 1u;                        // Size is a power of two so the mask replaces modulo
+}
+
+uint32_t RINGB_u_Count(const t_RINGB_Ring *p_Ring)
+{
+  // Free running indexes, unsigned subtraction is correct across the wrap
+  return p_Ring -> u_Head - p_Ring -> u_Tail;
+}
+
+uint32_t RINGB_u_Free(const t_RINGB_Ring *p_Ring)
+{
+  return (p_Ring -> u_Mask + 1u) - RINGB_u_Count(p_Ring);
+}
+
+uint8_t RINGB_u_Push(t_RINGB_Ring *p_Ring, uint8_t u_Data)
+{
+  uint32_t u_Head = p_Ring -> u_Head;
+
+  if ((u_Head - p_Ring -> u_Tail) > p_Ring -> u_Mask)     // Checks if the ring buffer is full
+  {
+    return 0u;
+  }
+
+  p_Ring -> p_Buffer[u_Head & p_Ring -> u_Mask] = u_Data;  // Store the data before it becomes visible
+  RINGB_MEMORY_BARRIER();
+  p_Ring -> u_Head = u_Head + 1u;                          // Publish the data to the consumer
+  return 1u;
+}
+
+uint32_t RINGB_u_PushN(t_RINGB_Ring *p_Ring, const uint8_t *p_Data, uint32_t u_Length)
+{
+  uint32_t u_Head  = p_Ring -> u_Head;
+  uint32_t u_Free  = (p_Ring -> u_Mask + 1u) - (u_Head - p_Ring -> u_Tail);
+  uint32_t u_Index = u_Head & p_Ring -> u_Mask;
+
+  if (u_Length > u_Free)
+  {
+    u_Length = u_Free;                                     // Store only as much as fits
+  }
+
+  // Copy up to the end of the storage, then wrap around to its beginning
+  uint32_t u_First = p_Ring -> u_Mask + 1u - u_Index;
+  if (u_First > u_Length)
+  {
+    u_First = u_Length;
+  }
+  memcpy(&p_Ring -> p_Buffer[u_Index], p_Data, u_First);
+  memcpy(p_Ring -> p_Buffer, &p_Data[u_First], u_Length - u_First);
+
+  RINGB_MEMORY_BARRIER();
+  p_Ring -> u_Head = u_Head + u_Length;                    // Publish the whole block at once
+  return u_Length;
+}
+
+uint8_t RINGB_u_Pop(t_RINGB_Ring *p_Ring, uint8_t *p_Data)
+{
+  uint32_t u_Tail = p_Ring -> u_Tail;
+
+  if (p_Ring -> u_Head == u_Tail)                          // Checks if the ring buffer is empty
+  {
+    return 0u;
+  }
+
+  RINGB_MEMORY_BARRIER();                                  // Read the data only after the head was observed
+  *p_Data = p_Ring -> p_Buffer[u_Tail & p_Ring -> u_Mask];
+  RINGB_MEMORY_BARRIER();
+  p_Ring -> u_Tail = u_Tail + 1u;                          // Give the slot back to the producer
+  return 1u;
+}
+
+uint32_t RINGB_u_Peek(const t_RINGB_Ring *p_Ring, uint8_t *p_Data, uint32_t u_Length)
+{
+  uint32_t u_Tail  = p_Ring -> u_Tail;
+  uint32_t u_Count = p_Ring -> u_Head - u_Tail;
+  uint32_t u_Index = u_Tail & p_Ring -> u_Mask;
+
+  if (u_Length > u_Count)
+  {
+    u_Length = u_Count;                                    // Copy only what is stored
+  }
+  RINGB_MEMORY_BARRIER();                                  // Read the data only after the head was observed
+
+  // Copy up to the end of the storage, then wrap around to its beginning
+  uint32_t u_First = p_Ring -> u_Mask + 1u - u_Index;
+  if (u_First > u_Length)
+  {
+    u_First = u_Length;
+  }
+  memcpy(p_Data, &p_Ring -> p_Buffer[u_Index], u_First);
+  memcpy(&p_Data[u_First], p_Ring -> p_Buffer, u_Length - u_First);
+  return u_Length;
+}
+
+uint32_t RINGB_u_PopN(t_RINGB_Ring *p_Ring, uint8_t *p_Data, uint32_t u_Length)
+{
+  u_Length = RINGB_u_Peek(p_Ring, p_Data, u_Length);
+  RINGB_MEMORY_BARRIER();
+  p_Ring -> u_Tail = p_Ring -> u_Tail + u_Length;          // Give the slots back to the producer
+  return u_Length;
+}
+
+uint8_t RINGB_u_PeekAt(const t_RINGB_Ring *p_Ring, uint32_t u_Offset)
+{
+  return p_Ring -> p_Buffer[(p_Ring -> u_Tail + u_Offset) & p_Ring -> u_Mask];
+}
+
+uint32_t RINGB_u_Skip(t_RINGB_Ring *p_Ring, uint32_t u_Length)
+{
+  uint32_t u_Tail  = p_Ring -> u_Tail;
+  uint32_t u_Count = p_Ring -> u_Head - u_Tail;
+
+  if (u_Length > u_Count)
+  {
+    u_Length = u_Count;                                    // Drop only what is stored
+  }
+  RINGB_MEMORY_BARRIER();
+  p_Ring -> u_Tail = u_Tail + u_Length;                    // Give the slots back to the producer
+  return u_Length;
+}
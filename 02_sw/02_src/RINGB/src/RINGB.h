@@ -0,0 +1,257 @@
+/// @file RINGB.h
+/// @brief Header file used for lock-free single-producer/single-consumer ring buffers
+/// @author Aleksandra Petrovic
+
+#ifndef RINGB_H_
+#define RINGB_H_
+
+#include <stdint.h>
+#include "RINGB_cfg.h"
+
+/// Checks at compile time that the size of a ring buffer is a power of two
+#define RINGB_IS_POWER_OF_TWO(x) (((x) != 0u) && (((x) & ((x) - 1u)) == 0u))
+
+/// Static initializer of a ring buffer that uses a_Storage of u_Size bytes (u_Size must be a power of two)
+#define RINGB_INIT(a_Storage, u_Size) { 0u, {0u}, 0u, {0u}, (a_Storage), ((u_Size) - 1u) }
+
+/// Structure used as a lock-free ring buffer with one writer (producer) and one reader (consumer)
+///
+/// Indexes run freely and are masked on access, so the number of stored bytes is always u_Head - u_Tail.
+/// Only the producer writes u_Head and only the consumer writes u_Tail.
+typedef struct {
+  volatile uint32_t u_Head;                                 ///< Index of the next slot to write, owned by the producer
+  uint8_t           a_HeadPad[RINGB_CACHE_LINE_SIZE - 4u];  ///< Keeps u_Tail on a different cache line
+  volatile uint32_t u_Tail;                                 ///< Index of the next slot to read, owned by the consumer
+  uint8_t           a_TailPad[RINGB_CACHE_LINE_SIZE - 4u];  ///< Keeps the buffer description on a different cache line
+  uint8_t *         p_Buffer;                               ///< Storage of the ring buffer
+  uint32_t          u_Mask;                                 ///< Size of the storage - 1
+} t_RINGB_Ring;
+
+/// @brief Function used to (re)initialize a ring buffer
+///
+/// @pre u_Size must be a power of two
+/// @post Ring buffer is empty and uses the parsed storage
+/// @param t_RINGB_Ring *p_Ring, uint8_t *p_Storage, uint32_t u_Size
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Function resets indexes and attaches the storage to the ring buffer.
+/// @callsequence
+///   @startuml "RINGB_v_Init.png"
+///     title "Sequence diagram for function RINGB_v_Init"
+///     -> RINGB: RINGB_v_Init(...)
+///     RINGB++
+///       rnote over RINGB: Resets indexes and stores the storage pointer and the mask.
+///     <- RINGB
+///     RINGB--
+///   @enduml
+void RINGB_v_Init(t_RINGB_Ring *p_Ring, uint8_t *p_Storage, uint32_t u_Size);
+
+/// @brief Function used to get the number of bytes stored in a ring buffer
+///
+/// @pre None
+/// @post None
+/// @param const t_RINGB_Ring *p_Ring
+///
+/// @return uint32_t number of stored bytes
+///
+/// @globals None
+///
+/// @InOutCorelation Function returns the difference between the write and the read index.
+/// @callsequence
+///   @startuml "RINGB_u_Count.png"
+///     title "Sequence diagram for function RINGB_u_Count"
+///     -> RINGB: RINGB_u_Count(...)
+///     RINGB++
+///     <- RINGB: Returns u_Head - u_Tail
+///     RINGB--
+///   @enduml
+uint32_t RINGB_u_Count(const t_RINGB_Ring *p_Ring);
+
+/// @brief Function used to get the number of free slots in a ring buffer
+///
+/// @pre None
+/// @post None
+/// @param const t_RINGB_Ring *p_Ring
+///
+/// @return uint32_t number of free slots
+///
+/// @globals None
+///
+/// @InOutCorelation Function returns the size of the ring buffer reduced by the number of stored bytes.
+/// @callsequence
+///   @startuml "RINGB_u_Free.png"
+///     title "Sequence diagram for function RINGB_u_Free"
+///     -> RINGB: RINGB_u_Free(...)
+///     RINGB++
+///     <- RINGB: Returns size - (u_Head - u_Tail)
+///     RINGB--
+///   @enduml
+uint32_t RINGB_u_Free(const t_RINGB_Ring *p_Ring);
+
+/// @brief Function used to write one byte into a ring buffer (producer side)
+///
+/// @pre None
+/// @post Byte is stored if there is a free slot
+/// @param t_RINGB_Ring *p_Ring, uint8_t u_Data
+///
+/// @return uint8_t 1 if the byte was stored, 0 if the ring buffer is full
+///
+/// @globals None
+///
+/// @InOutCorelation Function stores the byte and publishes the new write index after a memory barrier.
+/// @callsequence
+///   @startuml "RINGB_u_Push.png"
+///     title "Sequence diagram for function RINGB_u_Push"
+///     -> RINGB: RINGB_u_Push(...)
+///     RINGB++
+///       opt if ring buffer is full
+///         <- RINGB: Returns 0
+///       end
+///       rnote over RINGB: Stores the byte, memory barrier, publishes u_Head.
+///     <- RINGB: Returns 1
+///     RINGB--
+///   @enduml
+uint8_t RINGB_u_Push(t_RINGB_Ring *p_Ring, uint8_t u_Data);
+
+/// @brief Function used to write a block of bytes into a ring buffer (producer side)
+///
+/// @pre None
+/// @post As many bytes as fit are stored
+/// @param t_RINGB_Ring *p_Ring, const uint8_t *p_Data, uint32_t u_Length
+///
+/// @return uint32_t number of stored bytes
+///
+/// @globals None
+///
+/// @InOutCorelation Function copies the block in at most two parts and publishes the write index once.
+/// @callsequence
+///   @startuml "RINGB_u_PushN.png"
+///     title "Sequence diagram for function RINGB_u_PushN"
+///     -> RINGB: RINGB_u_PushN(...)
+///     RINGB++
+///       rnote over RINGB: Limits the length to the free space.
+///       rnote over RINGB: Copies up to the end of the storage and the rest from its beginning.
+///       rnote over RINGB: Memory barrier, publishes u_Head.
+///     <- RINGB: Returns the number of stored bytes
+///     RINGB--
+///   @enduml
+uint32_t RINGB_u_PushN(t_RINGB_Ring *p_Ring, const uint8_t *p_Data, uint32_t u_Length);
+
+/// @brief Function used to read one byte from a ring buffer (consumer side)
+///
+/// @pre None
+/// @post Byte is removed from the ring buffer if it was not empty
+/// @param t_RINGB_Ring *p_Ring, uint8_t *p_Data
+///
+/// @return uint8_t 1 if a byte was read, 0 if the ring buffer is empty
+///
+/// @globals None
+///
+/// @InOutCorelation Function reads the byte and publishes the new read index after a memory barrier.
+/// @callsequence
+///   @startuml "RINGB_u_Pop.png"
+///     title "Sequence diagram for function RINGB_u_Pop"
+///     -> RINGB: RINGB_u_Pop(...)
+///     RINGB++
+///       opt if ring buffer is empty
+///         <- RINGB: Returns 0
+///       end
+///       rnote over RINGB: Memory barrier, reads the byte, memory barrier, publishes u_Tail.
+///     <- RINGB: Returns 1
+///     RINGB--
+///   @enduml
+uint8_t RINGB_u_Pop(t_RINGB_Ring *p_Ring, uint8_t *p_Data);
+
+/// @brief Function used to read a block of bytes from a ring buffer (consumer side)
+///
+/// @pre None
+/// @post Read bytes are removed from the ring buffer
+/// @param t_RINGB_Ring *p_Ring, uint8_t *p_Data, uint32_t u_Length
+///
+/// @return uint32_t number of read bytes
+///
+/// @globals None
+///
+/// @InOutCorelation Function copies the block in at most two parts and publishes the read index once.
+/// @callsequence
+///   @startuml "RINGB_u_PopN.png"
+///     title "Sequence diagram for function RINGB_u_PopN"
+///     -> RINGB: RINGB_u_PopN(...)
+///     RINGB++
+///       RINGB -> RINGB: RINGB_u_Peek(...)
+///       rnote over RINGB: Memory barrier, publishes u_Tail.
+///     <- RINGB: Returns the number of read bytes
+///     RINGB--
+///   @enduml
+uint32_t RINGB_u_PopN(t_RINGB_Ring *p_Ring, uint8_t *p_Data, uint32_t u_Length);
+
+/// @brief Function used to copy bytes from a ring buffer without removing them (consumer side)
+///
+/// @pre None
+/// @post None
+/// @param const t_RINGB_Ring *p_Ring, uint8_t *p_Data, uint32_t u_Length
+///
+/// @return uint32_t number of copied bytes
+///
+/// @globals None
+///
+/// @InOutCorelation Function copies the oldest bytes in at most two parts and leaves the read index untouched.
+/// @callsequence
+///   @startuml "RINGB_u_Peek.png"
+///     title "Sequence diagram for function RINGB_u_Peek"
+///     -> RINGB: RINGB_u_Peek(...)
+///     RINGB++
+///       rnote over RINGB: Limits the length to the stored bytes, memory barrier.
+///       rnote over RINGB: Copies up to the end of the storage and the rest from its beginning.
+///     <- RINGB: Returns the number of copied bytes
+///     RINGB--
+///   @enduml
+uint32_t RINGB_u_Peek(const t_RINGB_Ring *p_Ring, uint8_t *p_Data, uint32_t u_Length);
+
+/// @brief Function used to read a stored byte in place without removing it (consumer side)
+///
+/// @pre u_Offset must be smaller than RINGB_u_Count()
+/// @post None
+/// @param const t_RINGB_Ring *p_Ring, uint32_t u_Offset distance from the oldest stored byte
+///
+/// @return uint8_t byte at the parsed offset
+///
+/// @globals None
+///
+/// @InOutCorelation Function masks the read index moved by the offset and returns the byte from the storage.
+/// @callsequence
+///   @startuml "RINGB_u_PeekAt.png"
+///     title "Sequence diagram for function RINGB_u_PeekAt"
+///     -> RINGB: RINGB_u_PeekAt(...)
+///     RINGB++
+///     <- RINGB: Returns p_Buffer[(u_Tail + u_Offset) & u_Mask]
+///     RINGB--
+///   @enduml
+uint8_t RINGB_u_PeekAt(const t_RINGB_Ring *p_Ring, uint32_t u_Offset);
+
+/// @brief Function used to drop stored bytes without reading them (consumer side)
+///
+/// @pre None
+/// @post Up to u_Length oldest bytes are removed from the ring buffer
+/// @param t_RINGB_Ring *p_Ring, uint32_t u_Length
+///
+/// @return uint32_t number of dropped bytes
+///
+/// @globals None
+///
+/// @InOutCorelation Function moves the read index forward and publishes it after a memory barrier.
+/// @callsequence
+///   @startuml "RINGB_u_Skip.png"
+///     title "Sequence diagram for function RINGB_u_Skip"
+///     -> RINGB: RINGB_u_Skip(...)
+///     RINGB++
+///       rnote over RINGB: Limits the length to the stored bytes, memory barrier, publishes u_Tail.
+///     <- RINGB: Returns the number of dropped bytes
+///     RINGB--
+///   @enduml
+uint32_t RINGB_u_Skip(t_RINGB_Ring *p_Ring, uint32_t u_Length);
+
+#endif /* RINGB_H_ */
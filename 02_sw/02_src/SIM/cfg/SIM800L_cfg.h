@@ -9,20 +9,62 @@
 
 /// Used to define number of words in a dictionary
 #define SIM800L_DICTIONARY_LENGTH 20u
-/// Used to define maximum length of SIM800L response
-#define SIM800L_RESPONSE_LENGTH 50u
+/// Characters of one SMS in the GSM 7-bit default alphabet
+#define SIM800L_SMS_LENGTH 160u
+/// Used to define maximum length of SIM800L response, the text of a received SMS is one line
+#define SIM800L_RESPONSE_LENGTH SIM800L_SMS_LENGTH
 /// Used to define the length of phone number
 #define SIM800L_NUMBER_LENGTH 12
 /// Used to define number of states SIM800L module can be in
 #define SIM800L_STATES 5u
-/// Used to define SIM800L message buffer length
-#define SIM800L_MESSAGE_BUFFER_LENGTH 300u
 /// Carriage Return in ASCII
 #define CARRIAGE_RETURN 13
 /// Line Feed in ASCII
 #define LINE_FEED 10
 /// ESC in ASCII
 #define ESC 27
+/// CTRL+Z in ASCII, ends the text of the SMS and sends it
+#define CTRL_Z 26
+/// Number of commands that can wait in the queue of the AT engine
+#define SIM800L_AT_QUEUE_LENGTH 12u
+/// Longest text of a queued command with its terminating zero, the text of a SMS is the longest one
+#define SIM800L_AT_TEXT_LENGTH (SIM800L_SMS_LENGTH + 1u)
+/// Time in milliseconds to wait for the response to a simple command
+#define SIM800L_AT_TIMEOUT_MS 1000u
+/// Number of times a simple command is sent again
+#define SIM800L_AT_RETRIES 2u
+/// Number of times AT is sent at start up until the module answers
+#define SIM800L_HANDSHAKE_RETRIES 10u
+/// Time in milliseconds to wait for the response to ATD
+#define SIM800L_ATD_TIMEOUT_MS 20000u
+/// Time in milliseconds to wait for the '>' prompt after AT+CMGS
+#define SIM800L_PROMPT_TIMEOUT_MS 5000u
+/// Time in milliseconds to wait for the SMS to be sent
+#define SIM800L_CMGS_TIMEOUT_MS 60000u
+/// Length of the buffers in which ATD, AT+CMGS and AT+CMGR commands are built
+#define SIM800L_COMMAND_LENGTH 50u
+/// Number which gets the coordinates when no known caller rang
+#define SIM800L_DEFAULT_RECIPIENT Aleksandra
+/// Only number whose SMS can change the table of authorised callers
+#define SIM800L_ADMIN_NUMBER "+381605074705"
+/// Start of an SMS which changes the table, "CALLR,ADD,number[,reply]", "CALLR,IGNORE,number" or "CALLR,DEL,number"
+#define SIM800L_PROVISION_PREFIX "CALLR,"
+/// Length of SIM800L_PROVISION_PREFIX
+#define SIM800L_PROVISION_PREFIX_LENGTH 6u
+/// Number of fields after SIM800L_PROVISION_PREFIX, the command, the number and the reply number
+#define SIM800L_PROVISION_FIELDS 3u
+/// Appended to a position restored from the fix log until the GPS reports a new fix
+#define SIM800L_STALE_MARKER ",STALE"
+/// Length of SIM800L_STALE_MARKER
+#define SIM800L_STALE_LENGTH 6u
+/// Length of SIM800L_STALE_MARKER followed by ",ddmmyy,hhmmss"
+#define SIM800L_STALE_DATED_LENGTH 20u
+/// SMS holds the position as text, "latitude,N,longitude,E" with the stale marker
+#define SIM800L_PAYLOAD_TEXT 0u
+/// SMS holds the own fix and the logged fixes before it packed by TRACK
+#define SIM800L_PAYLOAD_TRACK 1u
+/// Payload of the SMS with coordinates, a received SMS is read in both formats
+#define SIM800L_PAYLOAD SIM800L_PAYLOAD_TRACK
 
 // SIM800L states for different functions
 t_SIM_Function SIM800L_t_Functions[SIM800L_STATES] = {
@@ -43,7 +85,8 @@ t_SIM_Command SIM800L_t_Dictionary[SIM800L_DICTIONARY_LENGTH] = {
 		{ (uint8_t*)"AT+CNMI=1,2,0,0,0",	SIM, 		CNMI },
 		{ (uint8_t*)"ATH", 					SIM, 		ATH  },
 		{ (uint8_t*)"ATD+ ", 				SIM, 		ATD  },
-		{ (uint8_t*)"AT+CMGS=+", 			SIM, 		CMGS }
+		{ (uint8_t*)"AT+CMGS=+", 			SIM, 		CMGS },
+		{ (uint8_t*)"AT+CLIP=1", 			SIM, 		CLIPEN }
 };
 /// Used to determine the length of SIM800L_t_Dictionary array
 uint16_t SIM800L_u_DictionaryLength = sizeof(SIM800L_t_Dictionary) / sizeof(SIM800L_t_Dictionary[0]);
@@ -53,15 +96,22 @@ t_SIM_Response SIM800L_t_ResponseDictionary[SIM800L_DICTIONARY_LENGTH] = {
 		{ (uint8_t*)"OK", 			2,		SIM, 		OK 		   },   			//b_FALSE	},
 		{ (uint8_t*)"RING", 		4,		SIM, 		RING 	   }, 				//b_FALSE	},
 		{ (uint8_t*)"NO CARRIER", 	10,		SIM, 		NO_CARRIER },				//b_FALSE	},
-		{ (uint8_t*)"+CLIP: ",      7,		SIM,		CLIP	   }				//b_FALSE	}
+		{ (uint8_t*)"+CLIP: ",      7,		SIM,		CLIP	   },				//b_FALSE	},
+		{ (uint8_t*)"ERROR", 		5,		SIM, 		ERROR_RSP  },
+		{ (uint8_t*)"+CME ERROR",	10,		SIM, 		ERROR_RSP  },
+		{ (uint8_t*)"+CMS ERROR",	10,		SIM, 		ERROR_RSP  },
+		{ (uint8_t*)"+CMTI: ",		7,		SIM, 		CMTI 	   },
+		{ (uint8_t*)"+CMT: ",		6,		SIM, 		CMT 	   },
+		{ (uint8_t*)"+CMGR: ",		7,		SIM, 		CMGR 	   },
+		{ (uint8_t*)"> ",			2,		SIM, 		PROMPT 	   }
 };
 /// Used to determine the length of SIM800L_t_ResponseDictionary array
 uint16_t SIM800L_u_ResponseDictionaryLength = sizeof(SIM800L_t_ResponseDictionary) / sizeof(SIM800L_t_ResponseDictionary[0]);
 
-/// SIM800L dictionary of known callers
-t_SIM_KnownCaller SIM800L_t_CallerDictionary[SIM800L_DICTIONARY_LENGTH] = {
-		{ (uint8_t*)"+381605074705", 	Aleksandra, 	b_FALSE },
-		{ (uint8_t*)"+381611753295", 	SIM_module, 	b_FALSE }
+/// SIM800L dictionary of numbers called or sent messages to on its own, in the order of e_SIM_KnownCaller
+t_SIM_KnownCaller SIM800L_t_CallerDictionary[] = {
+		{ (uint8_t*)"+381605074705", 	Aleksandra },
+		{ (uint8_t*)"+381611753295", 	SIM_module }
 };
 /// USed to determine the length of SIM800L_t_CallerDictionary array
 uint16_t SIM800L_u_CallerDictionaryLength = sizeof(SIM800L_t_CallerDictionary) / sizeof(SIM800L_t_CallerDictionary[0]);
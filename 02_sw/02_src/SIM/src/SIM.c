@@ -4,15 +4,56 @@
 
 #include"MSGM.h"
 #include "SIM800L_cfg.h"
+#include "TIMEB.h"
+#include "CALLR.h"
+#include "FIXLOG.h"
+#include "CALCM.h"
+#include "TRACK.h"
+#include <string.h>
 
 /// Buffer where complex messages including phone numbers will be written to
-static uint8_t u_CoordBuf[COORDINATES_BUFFER_LENGTH] = {0};
+static uint8_t u_CoordBuf[SIM800L_SMS_LENGTH + 1u] = {0};
 /// Initial SIM function should be IdleFunction and it shouldn't be changed until SIM module activates for call/message operations
 static e_SIM_Function e_PreviosFunction = IdleFunction;
+/// Copy of the raw GPS message or the packed track taken when a call or a message starts
+static uint8_t SIM_a_Coordinates[SIM800L_SMS_LENGTH + 1u] = {0u};
+/// Position text with the dated stale marker fits into one SMS
+_Static_assert((CALCM_POSITION_TEXT_LENGTH + SIM800L_STALE_DATED_LENGTH) <= sizeof(SIM_a_Coordinates),
+               "Position text does not fit into SIM_a_Coordinates");
 /// Used for storing unprocessed coordinates received via UART3 from GPS module
-static uint8_t *p_Coordinates = {0};
+static uint8_t *p_Coordinates = SIM_a_Coordinates;
 /// Used to indicate if the semaphore should be released or the SIM functions are still executing
 static volatile boolean b_SemaphoreFlag = b_FALSE;
+/// Commands built in SIM800L_COMMAND_LENGTH buffers fit into a queue entry
+_Static_assert(SIM800L_COMMAND_LENGTH <= SIM800L_AT_TEXT_LENGTH, "Command does not fit into t_SIM_AtEntry");
+/// This struct is used for a command in the queue of the AT engine, which owns the text of the command
+typedef struct {
+	t_SIM_AtCommand t_Command;				///< Description of the command, p_Text points to a_Text
+	uint8_t a_Text[SIM800L_AT_TEXT_LENGTH];	///< Copy of the text of the command
+} t_SIM_AtEntry;
+
+/// Queue of the AT engine, the command at SIM_u_AtHead is the one being sent or waiting for a response
+static t_SIM_AtEntry SIM_a_AtQueue[SIM800L_AT_QUEUE_LENGTH];
+/// Index of the first command in the queue
+static uint8_t SIM_u_AtHead = 0u;
+/// Number of commands in the queue
+static uint8_t SIM_u_AtCount = 0u;
+/// Flag that indicates the command at the head of the queue has been sent and waits for a response
+static boolean SIM_b_AtWaiting = b_FALSE;
+/// HAL tick at which the command at the head of the queue times out
+static t_TIMEB_Deadline SIM_t_AtDeadline = {0u};
+/// Number of times the command at the head of the queue has been sent
+static uint8_t SIM_u_AtAttempts = 0u;
+/// Line being received from SIM800L
+static uint8_t SIM_a_Line[SIM800L_RESPONSE_LENGTH];
+/// Number of characters in SIM_a_Line
+static uint8_t SIM_u_LineLength = 0u;
+/// Flag that indicates the next line is the text of a SMS
+static boolean SIM_b_MessageText = b_FALSE;
+/// Flag that indicates the SMS whose text comes next was sent by SIM800L_ADMIN_NUMBER
+static boolean SIM_b_FromAdmin = b_FALSE;
+/// Number which gets the coordinates of the caller who rang, empty when the default number gets them
+static uint8_t SIM_a_ReplyNumber[CALLR_NUMBER_SIZE];
 
 /// @brief Function used for writing commands for SIM800L module into a buffer.
 ///
@@ -83,321 +124,987 @@ static void v_EndOfCommand()
   UARTM3_v_SendChar(LINE_FEED);
 }
 
-/// @brief Function used for sending commands for SIM800L module.
+/// @brief Function used for writing a six digit field of the fix log into SIM_a_Coordinates
 ///
-/// @pre SIM800L must be configured
-/// @post None
-/// @param e_Command e_SIM_Command
+/// @pre u_Index + 6 is less than the size of SIM_a_Coordinates
+/// @post Digits are written with leading zeros
+/// @param uint32_t u_Index position of the first digit, uint32_t u_Value ddmmyy or hhmmss
+///
+/// @return uint32_t position after the last digit
+///
+/// @globals SIM_a_Coordinates
+///
+/// @InOutCorelation None
+/// @callsequence
+///   @startuml "u_AppendDigits.png"
+///     title "Sequence diagram for function u_AppendDigits"
+///     -> SIM: u_AppendDigits(uint32_t u_Index, uint32_t u_Value)
+///     SIM++
+///     <- SIM: Returns position
+///     SIM--
+///   @enduml
+
+static uint32_t u_AppendDigits(uint32_t u_Index, uint32_t u_Value);
+
+static uint32_t u_AppendDigits(uint32_t u_Index, uint32_t u_Value)
+{
+  for(uint32_t u_Cnt = 6u; u_Cnt > 0u; u_Cnt--)
+  {
+    SIM_a_Coordinates[u_Index + u_Cnt - 1u] = (uint8_t)('0' + (u_Value % 10u));
+    u_Value /= 10u;
+  }
+  return u_Index + 6u;
+}
+
+/// @brief Function used for writing the own position or packing the track
+///
+/// @pre None
+/// @post p_Coordinates points to a copy which GPS parsing can not rewrite
+/// @param None
 ///
 /// @return None
 ///
-/// @globals None
+/// @globals SIM_a_Coordinates, p_Coordinates, MSGM_a_Fixes
 ///
-/// @InOutCorelation Function sends commands for SIM800L module.
+/// @InOutCorelation With SIM800L_PAYLOAD_TRACK the own fix and the logged fixes before it are packed by TRACK, which
+///                  carries the stale flag itself. Otherwise the own fix is read without a lock and written as text,
+///                  the call and the message use the copy afterwards. A position restored from the fix log is
+///                  followed by ",STALE,ddmmyy,hhmmss" with the UTC date and time of the restored fix record, or by
+///                  ",STALE" alone when the date is not known. Text is empty while there is no fix.
+/// @callsequence
+///   @startuml "v_TakeSnapshot.png"
+///     title "Sequence diagram for function v_TakeSnapshot"
+///     -> SIM: v_TakeSnapshot()
+///     SIM++
+///       opt if SIM800L_PAYLOAD is SIM800L_PAYLOAD_TRACK
+///         SIM -> TRACK: TRACK_u_Encode(SIM_a_Coordinates, ...)
+///         opt if there is a fix
+///           <- SIM
+///         end
+///       end
+///       SIM -> MSGM: MSGM_b_ReadFix(MSGM_FIX_OWN, ...)
+///       opt if there is a fix
+///         SIM -> CALCM: CALCM_u_FormatPosition(...)
+///         opt if FIXLOG_b_IsStale(...)
+///           SIM -> SIM: u_AppendDigits(...)
+///         end
+///       end
+///     SIM--
+///     <- SIM
+///   @enduml
+
+static void v_TakeSnapshot(void);
+
+static void v_TakeSnapshot()
+{
+  t_MSGM_Fix t_Fix;
+
+#if (SIM800L_PAYLOAD == SIM800L_PAYLOAD_TRACK)
+  // One SMS carries the track
+  if(TRACK_u_Encode(SIM_a_Coordinates, sizeof(SIM_a_Coordinates)) != 0u)
+  {
+    p_Coordinates = SIM_a_Coordinates;
+    return;
+  }
+#endif
+  SIM_a_Coordinates[0] = 0u;
+  // Position and its staleness come from one record, the writer never waits for this task
+  if(MSGM_b_ReadFix(MSGM_FIX_OWN, &t_Fix) == b_TRUE)
+  {
+    uint32_t u_Length = CALCM_u_FormatPosition(t_Fix.i_Latitude, t_Fix.i_Longitude, SIM_a_Coordinates);
+
+    if((FIXLOG_b_IsStale(&t_Fix) == b_TRUE) && (t_Fix.u_Date != 0u))
+    {
+      memcpy(&SIM_a_Coordinates[u_Length], SIM800L_STALE_MARKER ",", SIM800L_STALE_LENGTH + 1u);
+      u_Length += SIM800L_STALE_LENGTH + 1u;
+      u_Length = u_AppendDigits(u_Length, t_Fix.u_Date);
+      SIM_a_Coordinates[u_Length++] = ',';
+      u_Length = u_AppendDigits(u_Length, t_Fix.u_Time);
+      SIM_a_Coordinates[u_Length] = 0u;
+    }
+    else if(FIXLOG_b_IsStale(&t_Fix) == b_TRUE)
+    {
+      memcpy(&SIM_a_Coordinates[u_Length], SIM800L_STALE_MARKER, SIM800L_STALE_LENGTH + 1u);
+    }
+  }
+  p_Coordinates = SIM_a_Coordinates;
+}
+
+/// @brief Function used for queuing commands from the dictionary for SIM800L module.
+///
+/// @pre None
+/// @post Command is in the queue of the AT engine
+/// @param e_Command e_SIM_Command, uint32_t u_TimeoutMs, uint8_t u_Retries, t_SIM_AtCallback p_Callback
+///
+/// @return None
+///
+/// @globals SIM800L_t_Dictionary
+///
+/// @InOutCorelation Function finds the text of the command in the dictionary and queues it with OK as the expected
+///                  response.
 /// @callsequence
-///   @startuml "v_SendCommand.png"
-///     title "Sequence diagram for function v_SendCommand"
-///     -> SIM: v_SendCommand(e_Command e_SIM_Command)
+///   @startuml "v_QueueCommand.png"
+///     title "Sequence diagram for function v_QueueCommand"
+///     -> SIM: v_QueueCommand(e_Command e_SIM_Command, ...)
 ///     SIM++
 ///       loop Loop goes through dictionary of commands in order to find corresponding command to parsed one.
 ///         opt if parsed command matches an existing one
-///           UARTM -> SIM: UARTM3_v_SendString(SIM800L_Dictionary[u_Cnt].Config_Command)
+///           SIM -> SIM: SIM_b_AtSubmit(...)
 ///         end
 ///       end
-///       SIM -> SIM: v_EndOfCommand()
 ///     SIM--
 ///     <- SIM
 ///   @enduml
 
-static void v_SendCommand(e_Command e_SIM_Command);
+static void v_QueueCommand(e_Command e_SIM_Command, uint32_t u_TimeoutMs, uint8_t u_Retries, t_SIM_AtCallback p_Callback);
 
-static void v_SendCommand(e_Command e_SIM_Command)
+static void v_QueueCommand(e_Command e_SIM_Command, uint32_t u_TimeoutMs, uint8_t u_Retries, t_SIM_AtCallback p_Callback)
 {
-  uint8_t u_Cnt = 0;
-  // Used for exiting the loop when correct command is found
-  boolean b_CommandFound = b_FALSE;
   // Search the dictionary in order to find corresponding AT command
-  while((u_Cnt < SIM800L_u_DictionaryLength) && (b_CommandFound == b_FALSE))
+  for(uint8_t u_Cnt = 0; u_Cnt < SIM800L_u_DictionaryLength; u_Cnt++)
   {
-	// Check if parsed command matches any command in dictionary
-	if(SIM800L_t_Dictionary[u_Cnt].e_SIM800L_Command == e_SIM_Command)
+	if((SIM800L_t_Dictionary[u_Cnt].Config_Command != NULL) &&
+	   (SIM800L_t_Dictionary[u_Cnt].e_SIM800L_Command == e_SIM_Command))
 	{
-	  // If AT command is found, parse its text via UART
-	  UARTM3_v_SendString(SIM800L_t_Dictionary[u_Cnt].Config_Command);
-	  b_CommandFound = b_TRUE;
+	  t_SIM_AtCommand t_Command = {SIM800L_t_Dictionary[u_Cnt].Config_Command, CARRIAGE_RETURN, OK, u_TimeoutMs, u_Retries, p_Callback};
+	  (void)SIM_b_AtSubmit(&t_Command);
+	  break;
 	}
-	u_Cnt++;
   }
-  b_CommandFound = b_FALSE;
-  v_EndOfCommand();
 }
 
-void SIM_v_Setup()
+/// @brief Function used for removing all commands from the queue of the AT engine
+///
+/// @pre None
+/// @post Queue is empty, callbacks of removed commands are not called
+/// @param None
+///
+/// @return None
+///
+/// @globals SIM_a_AtQueue
+///
+/// @InOutCorelation Function is used when a command fails and the commands after it depend on it.
+/// @callsequence
+///   @startuml "v_AtFlush.png"
+///     title "Sequence diagram for function v_AtFlush"
+///     -> SIM: v_AtFlush()
+///     SIM++
+///       rnote over SIM: Queue is emptied.
+///     SIM--
+///     <- SIM
+///   @enduml
+
+static void v_AtFlush(void);
+
+static void v_AtFlush()
 {
-  uint8_t u_Cnt = 0;
+  SIM_u_AtCount = 0u;
+  SIM_b_AtWaiting = b_FALSE;
+}
+
+/// @brief Function used for sending the command at the head of the queue
+///
+/// @pre Queue must not be empty
+/// @post Command is sent and waits for a response
+/// @param None
+///
+/// @return None
+///
+/// @globals SIM_a_AtQueue, SIM_t_AtDeadline, SIM_u_AtAttempts
+///
+/// @InOutCorelation Function sends the text and its terminator via UART3 and sets the time of the timeout.
+/// @callsequence
+///   @startuml "v_AtSend.png"
+///     title "Sequence diagram for function v_AtSend"
+///     -> SIM: v_AtSend()
+///     SIM++
+///       UARTM -> SIM: UARTM3_v_SendString(p_Text)
+///       opt if terminator is CARRIAGE_RETURN
+///         SIM -> SIM: v_EndOfCommand()
+///       else else
+///         UARTM -> SIM: UARTM3_v_SendChar(u_Terminator)
+///       end
+///     SIM--
+///     <- SIM
+///   @enduml
+
+static void v_AtSend(void);
 
-  //e_SIM_Response e_Response = SIM_v_ReadResponse();
-  do
+static void v_AtSend()
+{
+  t_SIM_AtCommand *p_Command = &SIM_a_AtQueue[SIM_u_AtHead].t_Command;
+
+  UARTM3_v_SendString(p_Command -> p_Text);
+  if(p_Command -> u_Terminator == CARRIAGE_RETURN)
   {
-	// Re-send AT command to make sure that it gets the OK back
-    v_SendCommand(AT);
-    //e_Response = SIM_v_ReadResponse();
-    u_Cnt++;
+	v_EndOfCommand();
   }
-  // Once the handshake test is successful, OK message will be received
-  while(u_Cnt < 10);//(e_Response != OK && u_Cnt < 10);
+  else
+  {
+	UARTM3_v_SendChar(p_Command -> u_Terminator);
+  }
+  SIM_u_AtAttempts++;
+  SIM_b_AtWaiting = b_TRUE;
+  SIM_t_AtDeadline = TIMEB_t_DeadlineInUs(p_Command -> u_TimeoutMs * 1000u);
+}
+
+/// @brief Function used for finishing the command at the head of the queue
+///
+/// @pre Command must be waiting for a response
+/// @post Command is sent again or removed from the queue and its callback is called
+/// @param e_SIM_Response e_Response
+///
+/// @return None
+///
+/// @globals SIM_a_AtQueue
+///
+/// @InOutCorelation Expected response finishes the command. Otherwise the command is sent again while it has retries
+///                  left, NO CARRIER is final because repeating a call or a message does not help.
+/// @callsequence
+///   @startuml "v_AtFinish.png"
+///     title "Sequence diagram for function v_AtFinish"
+///     -> SIM: v_AtFinish(e_SIM_Response e_Response)
+///     SIM++
+///       opt if response is not expected and retries are left
+///         SIM -> SIM: v_AtSend()
+///       else else
+///         rnote over SIM: Command is removed from the queue.
+///         SIM -> SIM: p_Callback(e_Response)
+///       end
+///     SIM--
+///     <- SIM
+///   @enduml
+
+static void v_AtFinish(e_SIM_Response e_Response);
+
+static void v_AtFinish(e_SIM_Response e_Response)
+{
+  t_SIM_AtCommand t_Command = SIM_a_AtQueue[SIM_u_AtHead].t_Command;
+
+  if((e_Response != t_Command.e_Expected) && (e_Response != NO_CARRIER) && (SIM_u_AtAttempts <= t_Command.u_Retries))
+  {
+	v_AtSend();
+	return;
+  }
+  // Command is removed before the callback so the callback can queue new commands
+  SIM_u_AtHead = (uint8_t)((SIM_u_AtHead + 1u) % SIM800L_AT_QUEUE_LENGTH);
+  SIM_u_AtCount--;
+  SIM_u_AtAttempts = 0u;
+  SIM_b_AtWaiting = b_FALSE;
+  if(t_Command.p_Callback != NULL)
+  {
+	t_Command.p_Callback(e_Response);
+  }
+}
+
+/// @brief Function used for finding a line in the response dictionary
+///
+/// @pre Line must be received
+/// @post None
+/// @param None
+///
+/// @return e_SIM_Response NO_RSP if the line is not in the dictionary
+///
+/// @globals SIM_a_Line, SIM800L_t_ResponseDictionary
+///
+/// @InOutCorelation Function compares the beginning of the line with every response in the dictionary.
+/// @callsequence
+///   @startuml "e_MatchLine.png"
+///     title "Sequence diagram for function e_MatchLine"
+///     -> SIM: e_MatchLine()
+///     SIM++
+///       loop Goes through SIM800L_t_ResponseDictionary
+///         opt if the line starts with the response
+///           <- SIM://Returns e_Response of the response//
+///         end
+///       end
+///     <- SIM://Returns NO_RSP//
+///     SIM--
+///   @enduml
+
+static e_SIM_Response e_MatchLine(void);
+
+static e_SIM_Response e_MatchLine()
+{
+  for(uint8_t u_Cnt = 0; u_Cnt < SIM800L_u_ResponseDictionaryLength; u_Cnt++)
+  {
+	const t_SIM_Response *p_Response = &SIM800L_t_ResponseDictionary[u_Cnt];
+
+	if((p_Response -> u_ReceiveMessage != NULL) && (p_Response -> u_ResponseLength <= SIM_u_LineLength) &&
+	   (memcmp(SIM_a_Line, p_Response -> u_ReceiveMessage, p_Response -> u_ResponseLength) == 0))
+	{
+	  return p_Response -> e_Response;
+	}
+  }
+  return NO_RSP;
+}
+
+/// @brief Function used for finding a quoted field of the received line
+///
+/// @pre Line must be received
+/// @post None
+/// @param uint8_t u_Field 0 for the first quoted field, uint32_t *p_Length number of characters between the quotes
+///
+/// @return const uint8_t * first character of the field, NULL if the line has fewer quoted fields
+///
+/// @globals SIM_a_Line
+///
+/// @InOutCorelation Fields are the texts between pairs of '"' characters, +CLIP and +CMT carry the number in the
+///                  first one, +CMGR in the second one after the status of the SMS.
+/// @callsequence
+///   @startuml "p_QuotedField.png"
+///     title "Sequence diagram for function p_QuotedField"
+///     -> SIM: p_QuotedField(uint8_t u_Field, uint32_t *p_Length)
+///     SIM++
+///       loop until u_Field fields are skipped
+///         rnote over SIM: Next pair of '"' characters is found.
+///       end
+///     <- SIM://Returns field or NULL//
+///     SIM--
+///   @enduml
+
+static const uint8_t *p_QuotedField(uint8_t u_Field, uint32_t *p_Length);
+
+static const uint8_t *p_QuotedField(uint8_t u_Field, uint32_t *p_Length)
+{
+  const uint8_t *p_End = SIM_a_Line;
+
+  for(uint8_t u_Cnt = 0u; u_Cnt <= u_Field; u_Cnt++)
+  {
+	const uint8_t *p_Start = memchr(p_End, '"', (size_t)(&SIM_a_Line[SIM_u_LineLength] - p_End));
+
+	if(p_Start == NULL)
+	{
+	  return NULL;
+	}
+	p_Start++;
+	p_End = memchr(p_Start, '"', (size_t)(&SIM_a_Line[SIM_u_LineLength] - p_Start));
+	if(p_End == NULL)
+	{
+	  return NULL;
+	}
+	*p_Length = (uint32_t)(p_End - p_Start);
+	p_End++;
+	if(u_Cnt == u_Field)
+	{
+	  return p_Start;
+	}
+  }
+  return NULL;
+}
+
+/// @brief Function used for checking the number of the caller
+///
+/// @pre Line must start with +CLIP
+/// @post None
+/// @param None
+///
+/// @return const uint8_t * number which gets the coordinates, NULL if the caller is not known or is ignored
+///
+/// @globals SIM_a_Line
+///
+/// @InOutCorelation Number is the first quoted field, it is looked up in the table of authorised callers. Route of
+///                  the caller selects the number which gets the coordinates.
+/// @callsequence
+///   @startuml "p_KnownCallerCheck.png"
+///     title "Sequence diagram for function p_KnownCallerCheck"
+///     -> SIM: p_KnownCallerCheck()
+///     SIM++
+///       SIM -> SIM: p_QuotedField(0, ...)
+///       SIM -> CALLR: CALLR_p_Find(number, length)
+///       opt if caller is known
+///         SIM -> CALLR: CALLR_p_ReplyNumber(caller)
+///       end
+///     <- SIM://Returns number or NULL//
+///     SIM--
+///   @enduml
+
+static const uint8_t *p_KnownCallerCheck(void);
+
+static const uint8_t *p_KnownCallerCheck()
+{
+  uint32_t u_Length = 0u;
+  const uint8_t *p_Number = p_QuotedField(0u, &u_Length);
+  const t_CALLR_Caller *p_Caller = NULL;
+
+  if(p_Number == NULL)
+  {
+	return NULL;
+  }
+  p_Caller = CALLR_p_Find(p_Number, u_Length);
+  if(p_Caller == NULL)
+  {
+	return NULL;
+  }
+  return CALLR_p_ReplyNumber(p_Caller);
+}
+
+/// @brief Function used for checking if the SMS was sent by the administrator
+///
+/// @pre Line must start with +CMT or +CMGR
+/// @post None
+/// @param uint8_t u_Field quoted field which holds the number of the sender
+///
+/// @return boolean b_TRUE if the sender is SIM800L_ADMIN_NUMBER
+///
+/// @globals SIM_a_Line
+///
+/// @InOutCorelation Both numbers are normalised, so the network may report the sender in any accepted format.
+/// @callsequence
+///   @startuml "b_FromAdmin.png"
+///     title "Sequence diagram for function b_FromAdmin"
+///     -> SIM: b_FromAdmin(uint8_t u_Field)
+///     SIM++
+///       SIM -> SIM: p_QuotedField(u_Field, ...)
+///       SIM -> CALLR: CALLR_u_Normalize(sender, ...)
+///       SIM -> CALLR: CALLR_u_Normalize(SIM800L_ADMIN_NUMBER, ...)
+///     <- SIM://Returns b_TRUE if the numbers are equal//
+///     SIM--
+///   @enduml
+
+static boolean b_FromAdmin(uint8_t u_Field);
+
+static boolean b_FromAdmin(uint8_t u_Field)
+{
+  uint32_t u_Length = 0u;
+  const uint8_t *p_Sender = p_QuotedField(u_Field, &u_Length);
+  uint8_t a_Sender[CALLR_NUMBER_SIZE];
+  uint8_t a_Admin[CALLR_NUMBER_SIZE];
+
+  if((p_Sender == NULL) || (CALLR_u_Normalize(p_Sender, u_Length, a_Sender) == 0u) ||
+	 (CALLR_u_Normalize((const uint8_t *)SIM800L_ADMIN_NUMBER, sizeof(SIM800L_ADMIN_NUMBER) - 1u, a_Admin) == 0u))
+  {
+	return b_FALSE;
+  }
+  return (strcmp((const char *)a_Sender, (const char *)a_Admin) == 0) ? b_TRUE : b_FALSE;
+}
+
+/// @brief Function used for changing the table of authorised callers from the text of an SMS
+///
+/// @pre u_CoordBuf holds the text of an SMS of the administrator which starts with SIM800L_PROVISION_PREFIX
+/// @post Table is changed and saved in flash
+/// @param None
+///
+/// @return e_CALLR_Status result of the change or of the save, CALLR_ERROR_NUMBER for an unknown command
+///
+/// @globals u_CoordBuf
+///
+/// @InOutCorelation Fields after the prefix are split in place at ','. ADD with a reply number routes the
+///                  coordinates to it, without one back to the caller, IGNORE keeps the caller but ignores the call,
+///                  DEL removes the caller. The table is saved only when it was changed.
+/// @callsequence
+///   @startuml "e_Provision.png"
+///     title "Sequence diagram for function e_Provision"
+///     -> SIM: e_Provision()
+///     SIM++
+///       alt ADD or IGNORE
+///         SIM -> CALLR: CALLR_e_Add(...)
+///       else DEL
+///         SIM -> CALLR: CALLR_e_Remove(...)
+///       end
+///       opt if the table was changed
+///         SIM -> CALLR: CALLR_e_Save()
+///       end
+///     <- SIM://Returns e_CALLR_Status//
+///     SIM--
+///   @enduml
+
+static e_CALLR_Status e_Provision(void);
+
+static e_CALLR_Status e_Provision()
+{
+  uint8_t *a_Fields[SIM800L_PROVISION_FIELDS] = {NULL};
+  uint8_t *p_Text = &u_CoordBuf[SIM800L_PROVISION_PREFIX_LENGTH];
+  uint8_t u_Fields = 1u;
+  e_CALLR_Status e_Status = CALLR_ERROR_NUMBER;
+
+  a_Fields[0] = p_Text;
+  while((*p_Text != 0u) && (u_Fields < SIM800L_PROVISION_FIELDS))
+  {
+	if(*p_Text == ',')
+	{
+	  *p_Text = 0u;
+	  a_Fields[u_Fields++] = &p_Text[1];
+	}
+	p_Text++;
+  }
+  if(u_Fields < 2u)
+  {
+	return CALLR_ERROR_NUMBER;
+  }
+
+  if(strcmp((const char *)a_Fields[0], "ADD") == 0)
+  {
+	e_Status = CALLR_e_Add(a_Fields[1], (u_Fields == 3u) ? CALLR_ROUTE_NUMBER : CALLR_ROUTE_CALLER, a_Fields[2]);
+  }
+  else if((strcmp((const char *)a_Fields[0], "IGNORE") == 0) && (u_Fields == 2u))
+  {
+	e_Status = CALLR_e_Add(a_Fields[1], CALLR_ROUTE_NONE, NULL);
+  }
+  else if((strcmp((const char *)a_Fields[0], "DEL") == 0) && (u_Fields == 2u))
+  {
+	e_Status = CALLR_e_Remove(a_Fields[1]);
+  }
+  if(e_Status == CALLR_OK)
+  {
+	// TSK_SIM sleeps during the erase, FLASHM keeps it apart from the fix log
+	e_Status = CALLR_e_Save();
+  }
+  return e_Status;
+}
+
+/// @brief Function used for handling a received line
+///
+/// @pre Line must be received
+/// @post None
+/// @param None
+///
+/// @return None
+///
+/// @globals SIM_a_Line, SIM_b_MessageText, SIM_b_FromAdmin, u_CoordBuf, SIM800L_t_Functions, SIM_a_ReplyNumber
+///
+/// @InOutCorelation Text after +CMT or +CMGR is stored as received coordinates and set as the bearing target, unless
+///                  SIM800L_ADMIN_NUMBER sent it with SIM800L_PROVISION_PREFIX, then it changes the table of
+///                  authorised callers. +CMTI queues reading of the stored SMS. Known caller in +CLIP starts sending of coordinates when the SIM
+///                  module is idle. Final responses finish the command waiting for a response, lines which are not in
+///                  the dictionary (echo and information) are ignored.
+/// @callsequence
+///   @startuml "v_HandleLine.png"
+///     title "Sequence diagram for function v_HandleLine"
+///     -> SIM: v_HandleLine()
+///     SIM++
+///       opt if text of the SMS is expected
+///         rnote over SIM: Line is copied into u_CoordBuf.
+///         alt if the administrator sent a provisioning command
+///           SIM -> SIM: e_Provision()
+///         else else
+///           SIM -> CALCM: CALCM_e_SetTarget(u_CoordBuf, ...)
+///         end
+///       end
+///       SIM -> SIM: e_MatchLine()
+///       opt switch CMT or CMGR
+///         SIM -> SIM: b_FromAdmin(...)
+///         rnote over SIM: Next line is the text of the SMS.
+///       else else CMTI
+///         SIM -> SIM: SIM_b_AtSubmit(AT+CMGR=index)
+///       else else CLIP
+///         SIM -> SIM: p_KnownCallerCheck()
+///         opt if SIM module is idle
+///           rnote over SIM: Reply number is copied into SIM_a_ReplyNumber.
+///         end
+///       else else OK, ERROR, NO CARRIER or PROMPT
+///         SIM -> SIM: v_AtFinish(e_Response)
+///       end
+///     SIM--
+///     <- SIM
+///   @enduml
+
+static void v_HandleLine(void);
+
+static void v_HandleLine()
+{
+  e_SIM_Response e_Response = NO_RSP;
+
+  if(SIM_b_MessageText == b_TRUE)
+  {
+	SIM_b_MessageText = b_FALSE;
+	uint8_t u_Length = (SIM_u_LineLength < (sizeof(u_CoordBuf) - 1u)) ? SIM_u_LineLength : (uint8_t)(sizeof(u_CoordBuf) - 1u);
+	// Text is parsed once here, the bearing reads the published target
+	memcpy(u_CoordBuf, SIM_a_Line, u_Length);
+	u_CoordBuf[u_Length] = 0u;
+	if((SIM_b_FromAdmin == b_TRUE) &&
+	   (memcmp(u_CoordBuf, SIM800L_PROVISION_PREFIX, SIM800L_PROVISION_PREFIX_LENGTH) == 0))
+	{
+	  (void)e_Provision();
+	  // Command is not a position, nothing is reported as received coordinates
+	  u_CoordBuf[0] = 0u;
+	  return;
+	}
+	(void)CALCM_e_SetTarget(u_CoordBuf, sizeof(u_CoordBuf));
+	return;
+  }
+  e_Response = e_MatchLine();
+  switch(e_Response)
+  {
+	case CMT:
+	case CMGR:
+		// Sender is the first quoted field of +CMT, +CMGR starts with the status of the SMS
+		SIM_b_FromAdmin = b_FromAdmin((uint8_t)((e_Response == CMT) ? 0u : 1u));
+		SIM_b_MessageText = b_TRUE;
+		break;
+	case CMTI:
+	{
+		// Index of the stored SMS is after the last ','
+		const uint8_t *p_Index = memchr(SIM_a_Line, ',', SIM_u_LineLength);
+		if(p_Index != NULL)
+		{
+		  // Each notification queues its own read, the queue keeps a copy of the text
+		  uint8_t a_ReadCommand[SIM800L_COMMAND_LENGTH];
+		  uint8_t u_Cnt = v_WriteIntoBuffer(a_ReadCommand, 0u, (uint8_t *)"AT+CMGR=");
+		  p_Index++;
+		  while((p_Index < &SIM_a_Line[SIM_u_LineLength]) && (*p_Index >= '0') && (*p_Index <= '9') && (u_Cnt < (SIM800L_COMMAND_LENGTH - 1u)))
+		  {
+			a_ReadCommand[u_Cnt++] = *p_Index++;
+		  }
+		  a_ReadCommand[u_Cnt] = 0u;
+		  t_SIM_AtCommand t_Command = {a_ReadCommand, CARRIAGE_RETURN, OK, SIM800L_AT_TIMEOUT_MS, SIM800L_AT_RETRIES, NULL};
+		  (void)SIM_b_AtSubmit(&t_Command);
+		}
+		break;
+	}
+	case CLIP:
+	{
+		// Known caller gets the coordinates, the call is declined first
+		const uint8_t *p_Reply = p_KnownCallerCheck();
+		if((p_Reply != NULL) &&
+		   ((SIM_b_SwitchFunction(IdleFunction, EndCall) == b_TRUE) || (SIM_b_SwitchFunction(ReadMessage, EndCall) == b_TRUE)))
+		{
+		  // Copied because the table can change before the message is sent
+		  memcpy(SIM_a_ReplyNumber, p_Reply, sizeof(SIM_a_ReplyNumber));
+		  v_TakeSnapshot();
+		}
+		break;
+	}
+	case OK:
+	case ERROR_RSP:
+	case NO_CARRIER:
+	case PROMPT:
+		if(SIM_b_AtWaiting == b_TRUE)
+		{
+		  v_AtFinish(e_Response);
+		}
+		break;
+	default:
+		break;
+  }
+}
+
+boolean SIM_b_AtSubmit(const t_SIM_AtCommand *p_Command)
+{
+  // Search stops at the terminating zero, so a short text is not read past its end
+  const uint8_t *p_End = memchr(p_Command -> p_Text, 0, SIM800L_AT_TEXT_LENGTH);
+  t_SIM_AtEntry *p_Entry;
+
+  if((SIM_u_AtCount >= SIM800L_AT_QUEUE_LENGTH) || (p_End == NULL))
+  {
+	return b_FALSE;
+  }
+  p_Entry = &SIM_a_AtQueue[(SIM_u_AtHead + SIM_u_AtCount) % SIM800L_AT_QUEUE_LENGTH];
+  memcpy(p_Entry -> a_Text, p_Command -> p_Text, (size_t)(p_End - p_Command -> p_Text) + 1u);
+  p_Entry -> t_Command = *p_Command;
+  p_Entry -> t_Command.p_Text = p_Entry -> a_Text;
+  SIM_u_AtCount++;
+  return b_TRUE;
+}
+
+void SIM_v_AtProcess()
+{
+  // Split received bytes into lines, CR is ignored and LF ends the line
+  while(MSGM_b_CircularBufferIsEmpty(RING_BUFFER2) == b_FALSE)
+  {
+	uint8_t u_Data = MSGM_u_CircularBufferPop(RING_BUFFER2);
+
+	if(u_Data == LINE_FEED)
+	{
+	  if(SIM_u_LineLength != 0u)
+	  {
+		v_HandleLine();
+	  }
+	  SIM_u_LineLength = 0u;
+	}
+	else if(u_Data != CARRIAGE_RETURN)
+	{
+	  // Too long lines are cut, the beginning is enough for matching
+	  if(SIM_u_LineLength < SIM800L_RESPONSE_LENGTH)
+	  {
+		SIM_a_Line[SIM_u_LineLength++] = u_Data;
+	  }
+	  // Prompt for the text of the SMS is not followed by a line end
+	  if((SIM_u_LineLength == 2u) && (SIM_a_Line[0] == '>') && (SIM_a_Line[1] == ' '))
+	  {
+		v_HandleLine();
+		SIM_u_LineLength = 0u;
+	  }
+	}
+  }
+  if((SIM_b_AtWaiting == b_TRUE) && (TIMEB_b_DeadlineExpired(SIM_t_AtDeadline) == b_TRUE))
+  {
+	v_AtFinish(NO_RSP);
+  }
+  if((SIM_b_AtWaiting == b_FALSE) && (SIM_u_AtCount != 0u))
+  {
+	v_AtSend();
+  }
+}
+
+boolean SIM_b_AtIdle()
+{
+  return (SIM_u_AtCount == 0u) ? b_TRUE : b_FALSE;
+}
+
+/// @brief Function called when ATD is answered
+///
+/// @pre ATD command must be queued
+/// @post None
+/// @param e_SIM_Response e_Response
+///
+/// @return None
+///
+/// @globals SIM800L_t_Functions
+///
+/// @InOutCorelation Call is ended also when it failed, coordinates are sent in both cases.
+/// @callsequence
+///   @startuml "v_CallPlaced.png"
+///     title "Sequence diagram for function v_CallPlaced"
+///     -> SIM: v_CallPlaced(e_SIM_Response e_Response)
+///     SIM++
+///       rnote over SIM: Sets e_CurrentFunction as EndCall
+///     SIM--
+///     <- SIM
+///   @enduml
+
+static void v_CallPlaced(e_SIM_Response e_Response);
+
+static void v_CallPlaced(e_SIM_Response e_Response)
+{
+  (void)e_Response;
+  SIM800L_t_Functions -> e_CurrentFunction = EndCall;
+}
+
+/// @brief Function called when ATH is answered
+///
+/// @pre ATH command must be queued
+/// @post None
+/// @param e_SIM_Response e_Response
+///
+/// @return None
+///
+/// @globals SIM800L_t_Functions
+///
+/// @InOutCorelation Function starts sending of the coordinates.
+/// @callsequence
+///   @startuml "v_CallEnded.png"
+///     title "Sequence diagram for function v_CallEnded"
+///     -> SIM: v_CallEnded(e_SIM_Response e_Response)
+///     SIM++
+///       rnote over SIM: Sets e_CurrentFunction as SendMessage
+///     SIM--
+///     <- SIM
+///   @enduml
+
+static void v_CallEnded(e_SIM_Response e_Response);
+
+static void v_CallEnded(e_SIM_Response e_Response)
+{
+  (void)e_Response;
+  SIM800L_t_Functions -> e_CurrentFunction = SendMessage;
+}
+
+/// @brief Function called when AT+CMGS is answered
+///
+/// @pre AT+CMGS command must be queued
+/// @post None
+/// @param e_SIM_Response e_Response
+///
+/// @return None
+///
+/// @globals SIM800L_t_Functions
+///
+/// @InOutCorelation Without the prompt the text would be sent as a command, so the queue is emptied.
+/// @callsequence
+///   @startuml "v_MessagePrompt.png"
+///     title "Sequence diagram for function v_MessagePrompt"
+///     -> SIM: v_MessagePrompt(e_SIM_Response e_Response)
+///     SIM++
+///       opt if response is not the prompt
+///         SIM -> SIM: v_AtFlush()
+///         rnote over SIM: Sets e_CurrentFunction as ReadMessage
+///       end
+///     SIM--
+///     <- SIM
+///   @enduml
+
+static void v_MessagePrompt(e_SIM_Response e_Response);
+
+static void v_MessagePrompt(e_SIM_Response e_Response)
+{
+  if(e_Response != PROMPT)
+  {
+	v_AtFlush();
+	SIM800L_t_Functions -> e_CurrentFunction = ReadMessage;
+  }
+}
+
+/// @brief Function called when the text of the SMS is answered
+///
+/// @pre Text of the SMS must be queued
+/// @post None
+/// @param e_SIM_Response e_Response
+///
+/// @return None
+///
+/// @globals SIM800L_t_Functions
+///
+/// @InOutCorelation After the message has been sent, SIM is ready for the message to be read.
+/// @callsequence
+///   @startuml "v_MessageSent.png"
+///     title "Sequence diagram for function v_MessageSent"
+///     -> SIM: v_MessageSent(e_SIM_Response e_Response)
+///     SIM++
+///       rnote over SIM: Sets e_CurrentFunction as ReadMessage
+///     SIM--
+///     <- SIM
+///   @enduml
+
+static void v_MessageSent(e_SIM_Response e_Response);
+
+static void v_MessageSent(e_SIM_Response e_Response)
+{
+  (void)e_Response;
+  SIM800L_t_Functions -> e_CurrentFunction = ReadMessage;
+}
+
+void SIM_v_Setup()
+{
+  // Re-send AT command until the handshake test is successful and OK message is received
+  v_QueueCommand(AT, SIM800L_AT_TIMEOUT_MS, SIM800L_HANDSHAKE_RETRIES, NULL);
 
   // Signal quality test, value range is 0-31 , 31 is the best
-  v_SendCommand(CSQ);
+  v_QueueCommand(CSQ, SIM800L_AT_TIMEOUT_MS, SIM800L_AT_RETRIES, NULL);
 
   // Read SIM information to confirm whether the SIM is plugged
-  v_SendCommand(CCID);
+  v_QueueCommand(CCID, SIM800L_AT_TIMEOUT_MS, SIM800L_AT_RETRIES, NULL);
 
   // Check whether it has registered in the network
-  v_SendCommand(CREG);
+  v_QueueCommand(CREG, SIM800L_AT_TIMEOUT_MS, SIM800L_AT_RETRIES, NULL);
+
+  // Configuring TEXT mode and live SMS so the coordinates can be received
+  v_QueueCommand(CMGF, SIM800L_AT_TIMEOUT_MS, SIM800L_AT_RETRIES, NULL);
+  v_QueueCommand(CNMI, SIM800L_AT_TIMEOUT_MS, SIM800L_AT_RETRIES, NULL);
+
+  // Number of the caller is reported after RING
+  v_QueueCommand(CLIPEN, SIM800L_AT_TIMEOUT_MS, SIM800L_AT_RETRIES, NULL);
 }
 
 void SIM_v_ReceiveMessage()
 {
   // Once the handshake test is successful, OK message will be received
-  v_SendCommand(AT);
+  v_QueueCommand(AT, SIM800L_AT_TIMEOUT_MS, SIM800L_AT_RETRIES, NULL);
 
   // Configuring TEXT mode
-  v_SendCommand(CMGF);
+  v_QueueCommand(CMGF, SIM800L_AT_TIMEOUT_MS, SIM800L_AT_RETRIES, NULL);
 
   // AT Command to receive a live SMS
-  v_SendCommand(CNMI);
+  v_QueueCommand(CNMI, SIM800L_AT_TIMEOUT_MS, SIM800L_AT_RETRIES, NULL);
 }
 
 uint8_t * SIM_p_ReceiveCoordinates()
 {
-  // Read received message
-  SIM_v_ReceiveMessage();
-  // Store the content of the message and return its value
+  // Text of the last received message, live SMS are enabled in SIM_v_Setup
   return u_CoordBuf;
 }
 
 void SIM_v_EndCall()
 {
   // Used to end call
-  v_SendCommand(ATH);
+  v_QueueCommand(ATH, SIM800L_AT_TIMEOUT_MS, SIM800L_AT_RETRIES, v_CallEnded);
 }
 
 void SIM_v_CallNumber(uint8_t *u_Number)
 {
-  uint8_t u_Buffer[50u] = {0u};
   // Message used for configuring mode for making calls
-  uint8_t *u_NumCfg = (uint8_t *)("ATD+ ");
+  uint8_t *u_NumCfg = (uint8_t *)("ATD");
   uint8_t *u_CallCmd = (uint8_t *)(";");
   uint8_t u_Cnt = 0;
+  uint8_t a_CallCommand[SIM800L_COMMAND_LENGTH];
 
+  memset(a_CallCommand, 0, sizeof(a_CallCommand));
   // Goes through elements of calling configuration command and writes them into a temporary buffer and updates u_Cnt counter
-  u_Cnt = v_WriteIntoBuffer(u_Buffer, u_Cnt, u_NumCfg);
+  u_Cnt = v_WriteIntoBuffer(a_CallCommand, u_Cnt, u_NumCfg);
   // Adds number characters to the temporary buffer so the whole message will be sent via UART and updates u_Cnt counter
-  u_Cnt = v_WriteIntoBuffer(u_Buffer, u_Cnt, u_Number);
+  u_Cnt = v_WriteIntoBuffer(a_CallCommand, u_Cnt, u_Number);
   // ';' character is used to represent the end of call number command
-  u_Cnt = v_WriteIntoBuffer(u_Buffer, u_Cnt, u_CallCmd);
+  u_Cnt = v_WriteIntoBuffer(a_CallCommand, u_Cnt, u_CallCmd);
 
   // Once the handshake test is successful, OK message will be received
-  v_SendCommand(AT);
+  v_QueueCommand(AT, SIM800L_AT_TIMEOUT_MS, SIM800L_AT_RETRIES, NULL);
 
-  // Call the number
-  UARTM3_v_SendString(u_Buffer);
-  v_EndOfCommand();
+  // Call the number, OK is received when the call is set up
+  t_SIM_AtCommand t_Command = {a_CallCommand, CARRIAGE_RETURN, OK, SIM800L_ATD_TIMEOUT_MS, 0u, v_CallPlaced};
+  (void)SIM_b_AtSubmit(&t_Command);
 }
 
 void SIM_v_Call(e_SIM_KnownCaller e_Caller)
 {
-  uint8_t u_Cnt = 0;
-  boolean b_Flag = b_FALSE;
-  // Go through the dictionary until valid caller is reached
-  while(u_Cnt < SIM800L_u_CallerDictionaryLength && b_Flag == b_FALSE)
+  // Callers are listed in the order of e_SIM_KnownCaller
+  if((uint16_t)e_Caller < SIM800L_u_CallerDictionaryLength)
   {
-	// Compare parsed name to the names in the dictionary
-	if(e_Caller == SIM800L_t_CallerDictionary[u_Cnt].u_CallerName)
-	{
-	  // If correct name is found, call the number corresponding with that name
-	  SIM_v_CallNumber(SIM800L_t_CallerDictionary[u_Cnt].u_Number);
-	  b_Flag = b_TRUE;
-	}
-	u_Cnt++;
+	SIM_v_CallNumber(SIM800L_t_CallerDictionary[e_Caller].u_Number);
   }
 }
 
 void SIM_v_SendMessage(uint8_t *u_Message, uint8_t *u_Number)
 {
-  // Buffer used to store number and number configuration command
-  uint8_t u_Buffer[SIM800L_MESSAGE_BUFFER_LENGTH] = {0u};
-  uint8_t *u_NumCfg = (uint8_t*)"AT+CMGS=";
+  // Number configuration command
+  uint8_t *u_NumCfg = (uint8_t*)"AT+CMGS=\"";
   uint8_t u_Cnt = 0;
+  uint8_t a_NumberCommand[SIM800L_COMMAND_LENGTH];
 
+  // Text which does not fit into one SMS would be refused after the number, nothing is queued for it
+  if(memchr(u_Message, 0, SIM800L_AT_TEXT_LENGTH) == NULL)
+  {
+	return;
+  }
+  memset(a_NumberCommand, 0, sizeof(a_NumberCommand));
   // Goes through elements of sending message configuration command and writes them into a temporary buffer and updates u_Cnt counter
-  u_Cnt = v_WriteIntoBuffer(u_Buffer, u_Cnt, u_NumCfg);
+  u_Cnt = v_WriteIntoBuffer(a_NumberCommand, u_Cnt, u_NumCfg);
 
   // Adds number characters to the temporary buffer so the whole message will be sent via UART and updates u_Cnt counter
-  u_Cnt = v_WriteIntoBuffer(u_Buffer, u_Cnt, u_Number);
+  u_Cnt = v_WriteIntoBuffer(a_NumberCommand, u_Cnt, u_Number);
+  u_Cnt = v_WriteIntoBuffer(a_NumberCommand, u_Cnt, (uint8_t *)"\"");
 
   // Once the handshake test is successful, OK message will be received
-  v_SendCommand(AT);
+  v_QueueCommand(AT, SIM800L_AT_TIMEOUT_MS, SIM800L_AT_RETRIES, NULL);
 
   // Configuring TEXT mode
-  v_SendCommand(CMGF);
-
-  // Number to which the SMS should be sent
-  UARTM3_v_SendString(u_Buffer);
-  v_EndOfCommand();
+  v_QueueCommand(CMGF, SIM800L_AT_TIMEOUT_MS, SIM800L_AT_RETRIES, NULL);
 
-  // Sending text of the SMS
-  UARTM3_v_SendString(u_Message);
-  v_EndOfCommand();
+  // Number to which the SMS should be sent, text is sent after the '>' prompt
+  t_SIM_AtCommand t_Number = {a_NumberCommand, CARRIAGE_RETURN, PROMPT, SIM800L_PROMPT_TIMEOUT_MS, 0u, v_MessagePrompt};
+  (void)SIM_b_AtSubmit(&t_Number);
 
-  // ESC in ASCII - indicates the end of the transaction
-  UARTM3_v_SendChar(ESC);
-  v_EndOfCommand();
+  // Text of the SMS, CTRL+Z sends it and OK is received after +CMGS. Queue copies the text, so the raw message
+  // can be rewritten before the prompt arrives
+  t_SIM_AtCommand t_Text = {u_Message, CTRL_Z, OK, SIM800L_CMGS_TIMEOUT_MS, 0u, v_MessageSent};
+  (void)SIM_b_AtSubmit(&t_Text);
 }
 
 void SIM_v_SendCoordinates(e_SIM_KnownCaller e_Caller)
 {
-  uint8_t u_Cnt = 0;
-  boolean b_Flag = b_FALSE;
-  // Go through the dictionary until valid caller is reached
-  while(u_Cnt < SIM800L_u_CallerDictionaryLength && b_Flag == b_FALSE)
-  {
-    // Compare parsed name to the names in the dictionary
-    if(e_Caller == SIM800L_t_CallerDictionary[u_Cnt].u_CallerName)
-    {
- 	  b_Flag = b_TRUE;
- 	  // Send unprocessed coordinates to set number
- 	  SIM_v_SendMessage(p_Coordinates, SIM800L_t_CallerDictionary[u_Cnt].u_Number);
- 	}
-    u_Cnt++;
-  }
-  u_Cnt = 0;
-  // Empty SIM buffer first so the old data doesn't affect the new data
-  for(u_Cnt = 0; u_Cnt < COORDINATES_BUFFER_LENGTH; u_Cnt++)
+  // Callers are listed in the order of e_SIM_KnownCaller
+  if((uint16_t)e_Caller < SIM800L_u_CallerDictionaryLength)
   {
-	u_CoordBuf[u_Cnt] = 0u;
+	SIM_v_SendCoordinatesTo(SIM800L_t_CallerDictionary[e_Caller].u_Number);
   }
-  u_Cnt = 0;
-  // Store coordinates into buffer so they can be read
-  v_WriteIntoBuffer(u_CoordBuf, u_Cnt, p_Coordinates);
 }
 
-/*static e_SIM_Response v_ReadResponse(void);
-
-static e_SIM_Response v_ReadResponse()
+void SIM_v_SendCoordinatesTo(uint8_t *u_Number)
 {
-  uint8_t u_Buffer[SIM800L_RESPONSE_LENGTH] = {0u};
   uint8_t u_Cnt = 0;
-  uint8_t u_Cntr = 0;
-  uint8_t u_Counter = 0;
-  boolean b_DictionaryFlag = b_FALSE;
-  uint8_t u_TrueFlag = 0;
 
-  // Until NULL character is reached or number of characters reaches maximum length of the response, keep reading messages from UART2
-  while(UARTM2_u_GetChar() != 0 && u_Cnt < SIM800L_RESPONSE_LENGTH)
+  // Send unprocessed coordinates to set number
+  SIM_v_SendMessage(p_Coordinates, u_Number);
+  // Empty SIM buffer first so the old data doesn't affect the new data
+  for(u_Cnt = 0; u_Cnt < sizeof(u_CoordBuf); u_Cnt++)
   {
-    // Write into temporary buffer characters read from UART2
-	u_Buffer[u_Cnt] = UARTM2_u_GetChar();
-	u_Cnt++;
+	u_CoordBuf[u_Cnt] = 0u;
   }
-
-  // Reset the counter so it is used to go through the elements of response dictionary
   u_Cnt = 0;
-
-  // Goes through elements of SIM800L_ResponseDictionary
-  while(u_Cnt < SIM800L_u_ResponseDictionaryLength && b_DictionaryFlag == b_FALSE)
-  {
-	// Find the response in dictionary to check if it corresponds with received response
-    while(u_Counter < SIM800L_t_ResponseDictionary[u_Counter].u_ResponseLength)
-    {
-      // Goes through characters of a response in the dictionary
-      while(u_Cntr < SIM800L_t_ResponseDictionary[u_Counter].u_ReceiveMessage[u_Counter])
-      {
-        if(u_Buffer[u_Counter] == SIM800L_t_ResponseDictionary[u_Counter].u_ReceiveMessage[u_Cntr])
-        {
-	      // Set the flag to indicate that read response corresponds with a response in dictionary
-//	      SIM800L_ResponseDictionary[u_Counter].b_Flag = b_TRUE;
-	      b_DictionaryFlag = b_TRUE;
-	      u_TrueFlag = u_Counter;
-        }
-        else
-        {
-          // Read response doesn't correspond with any response in dictionary
-//          SIM800L_ResponseDictionary[u_Counter].b_Flag = b_FALSE;
-        }
-        u_Cntr++;
-      }
-      u_Counter++;
-    }
-    u_Cnt++;
-  }
-
-  if(b_DictionaryFlag == b_TRUE)
-  {
-    // If response from SIM corresponds with a response from dictionary, return its value
-	return SIM800L_t_ResponseDictionary[u_TrueFlag].e_Response;
-  }
-  else
-  {
-	// If response from SIM doesn't correspond with any of the predefined responses or there is no response at all, return no response
-	return NO_RSP;
-  }
+  // Store coordinates into buffer so they can be read
+  v_WriteIntoBuffer(u_CoordBuf, u_Cnt, p_Coordinates);
+  (void)CALCM_e_SetTarget(u_CoordBuf, sizeof(u_CoordBuf));
 }
 
-static boolean SIM_b_KnownCallerCheck(void);
-
-static boolean SIM_b_KnownCallerCheck()
-{
-  e_SIM_Response e_Rsp = v_ReadResponse();
-  boolean b_Flag = b_FALSE;
-  uint8_t u_Buffer[SIM800L_RESPONSE_LENGTH] = {0};
-  uint8_t u_Cnt = 0;
-  uint8_t u_DictionaryCounter = 0;
-
-  // After the CLIP response, number of the caller is read from terminal
-  if(e_Rsp == CLIP)
-  {
-	// Read the rest of the response to reach the number of the caller
-	while(UARTM2_u_GetChar() != 0 && u_Cnt < SIM800L_RESPONSE_LENGTH)
-	{
-	  // + character indicates beginning of the number
-	  if(UARTM2_u_GetChar() == '+')
-	  {
-		// " character indicates the end of the number portion of the response
-		while(UARTM2_u_GetChar() != '"' && u_Cnt < SIM800L_NUMBER_LENGTH)
-		{
-	      // Write into temporary buffer characters read from UART2
-	      u_Buffer[u_Cnt] = UARTM2_u_GetChar();
-	      u_Cnt++;
-	    }
-	  }
-	}
-	// Compare the content of the buffer to the numbers in the dictionary
-	while(u_DictionaryCounter < SIM800L_u_CallerDictionaryLength)
-	{
-      uint8_t u_Counter = 0;
-      // Until the end of the written data or set flag is reached, keep going through the array
-	  while(u_Counter < u_Cnt && b_Flag == b_FALSE)
-	  {
-		// Compare elements of the buffer to number characters in the dictionary
-	    if(u_Buffer[u_Counter] == SIM800L_t_CallerDictionary -> u_Number[u_Counter])
-	    {
-	      SIM800L_t_CallerDictionary[u_DictionaryCounter].b_KnownCaller = b_TRUE;
-		  b_Flag = b_TRUE;
-	    }
-	    else
-	    {
-	      SIM800L_t_CallerDictionary[u_DictionaryCounter].b_KnownCaller = b_FALSE;
-	    }
-	    u_Counter++;
-	  }
-	  u_DictionaryCounter++;
-	}
-  }
-  return b_Flag;
-}*/
-
 void SIM_v_StateMachine()
 {
   t_SIM_Function * t_func = SIM_p_Function();
@@ -415,54 +1122,36 @@ void SIM_v_StateMachine()
       case MakeCall:
     	  b_SemaphoreFlag = b_TRUE;
     	  // Stores coordinates so they won't be rewritten
-    	  p_Coordinates = MSGM_p_GetRawMessage();
-    	  // Make a call to a SIM card inserted into SIM module
+    	  v_TakeSnapshot();
+    	  // Make a call to a SIM card inserted into SIM module, EndCall is set when the module answers
   	      SIM_v_Call(SIM_module);
-  	      SIM800L_t_Functions -> e_CurrentFunction = EndCall;
 	      break;
 	  // Used when call should be ended
       case EndCall:
-/*    	  e_SIM_Response e_Response = v_ReadResponse();
-    	  // Wait for the ring and then reject the call
-    	  if(e_Response == RING)
-          {
-            // Check if the known caller made the call
-    	    boolean b_Check = SIM_b_KnownCallerCheck();
-    	    if(b_Check == b_TRUE)
-    	    {
-*/
-    	  // Decline the call and set flag to SendMessage in order to send raw message via SMS
+    	  b_SemaphoreFlag = b_TRUE;
+    	  // Decline the call, SendMessage is set when the module answers
     	  SIM_v_EndCall();
-    	  SIM800L_t_Functions -> e_CurrentFunction = SendMessage;
-/*    	    }
-    	    else
-    	    {
-    	      UARTM2_v_SendString((uint8_t*)"Unknown caller");
-    	    }
-          }*/
   	      break;
   	  // Used when message should be sent
       case SendMessage:
+      {
     	  b_SemaphoreFlag = b_TRUE;
-/*    	  // Loop goes through dictionary searching for the right caller in order to send him the coordinates
-    	  for(uint8_t u_Cnt = 0; u_Cnt < SIM800L_u_CallerDictionaryLength; u_Cnt++)
+    	  // Reply number of the caller who rang gets the coordinates, otherwise they are sent to the default number
+    	  if(SIM_a_ReplyNumber[0] != 0u)
     	  {
-    		if(SIM800L_t_CallerDictionary[u_Cnt].b_KnownCaller == b_TRUE)
-    		{
-    		  // Send coordinates to caller with set flag
-    		  SIM_v_SendCoordinates(SIM800L_t_CallerDictionary[u_Cnt].u_CallerName);
-    		  // Clear the flag
-    		  SIM800L_t_CallerDictionary[u_Cnt].b_KnownCaller = b_FALSE;
-    		}
+    		SIM_v_SendCoordinatesTo(SIM_a_ReplyNumber);
+    		SIM_a_ReplyNumber[0] = 0u;
+    	  }
+    	  else
+    	  {
+    		SIM_v_SendCoordinates(SIM800L_DEFAULT_RECIPIENT);
     	  }
-*/
-	      SIM_v_SendCoordinates(Aleksandra);
-	      // After the message has been sent, SIM is ready for the message to be read
-	      SIM800L_t_Functions -> e_CurrentFunction = ReadMessage;
 	      break;
+      }
 	  // Used when message should be read
       case ReadMessage:
     	  b_SemaphoreFlag = b_FALSE;
+    	  SIM_v_ReceiveMessage();
   	      break;
       default:
 	      break;
@@ -476,6 +1165,21 @@ t_SIM_Function * SIM_p_Function()
   return SIM800L_t_Functions;
 }
 
+boolean SIM_b_SwitchFunction(e_SIM_Function e_From, e_SIM_Function e_To)
+{
+  boolean b_Switched = b_FALSE;
+
+  // Only the compare and the store are protected, other tasks change the function too
+  taskENTER_CRITICAL();
+  if(SIM800L_t_Functions -> e_CurrentFunction == e_From)
+  {
+	SIM800L_t_Functions -> e_CurrentFunction = e_To;
+	b_Switched = b_TRUE;
+  }
+  taskEXIT_CRITICAL();
+  return b_Switched;
+}
+
 boolean SIM_b_GetFlag()
 {
   return b_SemaphoreFlag;
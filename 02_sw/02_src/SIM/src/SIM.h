@@ -31,7 +31,8 @@ typedef enum {
   ATH,		///< ATH command is used to decline a call
   ATA, 		///< ATH command is used to accept a call
   ATD,		///< ATD command is used to make a call
-  CMGS		///< CMGS command is used to send the message
+  CMGS,		///< CMGS command is used to send the message
+  CLIPEN	///< CLIP command is used to enable the caller identification after the RING
 } e_Command;
 
 /// This enum is used for different responses of SIM module
@@ -40,6 +41,11 @@ typedef enum {
 	RING,		///< Response when SIM is receiving a call
 	NO_CARRIER,	///< Response from SIM when it cannot make a call or send SMS
 	CLIP,		///< Response after the RING response that indicates which number is calling the SIM module
+	ERROR_RSP,	///< ERROR response from SIM module when the command failed
+	CMTI,		///< Response that indicates a new SMS is stored in the memory
+	CMT,		///< Response that precedes the text of a live SMS
+	CMGR,		///< Response that precedes the text of a SMS read from the memory
+	PROMPT,		///< '>' prompt after which the text of the SMS is sent
 	NO_RSP		///< Used when there is no response from SIM module
 } e_SIM_Response;
 
@@ -58,42 +64,56 @@ typedef struct {
 	e_Command e_SIM800L_Command;	///< Message of a buffer that signalizes proper AT command
 } t_SIM_Command;
 
-/// This enum is used for listing known callers
+/// Function called by the AT engine when a command is finished
+typedef void (*t_SIM_AtCallback)(e_SIM_Response e_Response);
+
+/// This struct is used for describing an AT command waiting in the queue of the AT engine
+typedef struct {
+	const uint8_t* p_Text;			///< Text of the command, copied into the queue by SIM_b_AtSubmit
+	uint8_t u_Terminator;			///< Character sent after the text, CARRIAGE_RETURN is sent as CR LF
+	e_SIM_Response e_Expected;		///< Response that finishes the command successfully
+	uint32_t u_TimeoutMs;			///< Time in milliseconds to wait for the response after each sending
+	uint8_t u_Retries;				///< Number of times the command is sent again after a timeout or ERROR
+	t_SIM_AtCallback p_Callback;	///< Called with the final response or NO_RSP after the last timeout, may be NULL
+} t_SIM_AtCommand;
+
+/// This enum is used for listing numbers the SIM module calls or sends messages to on its own
 typedef enum {
-	Aleksandra, 				///< Name of the first caller in dictionary
-	SIM_module					///< Name of the second caller in dictionary
+	Aleksandra, 				///< Name of the first number in dictionary
+	SIM_module					///< Name of the second number in dictionary
 } e_SIM_KnownCaller;
 
-/// This struct is used for checking if the caller is known
+/// This struct is used for the numbers the SIM module calls or sends messages to on its own, callers which may ring
+/// are kept by CALLR
 typedef struct {
 	uint8_t* u_Number;					///< Field used for number of the caller
 	e_SIM_KnownCaller u_CallerName;		///< Field used for caller's name
-	boolean b_KnownCaller;				///< Field used for indicating if the caller is known
 } t_SIM_KnownCaller;
 
 /// @brief Function used for setting up SIM800L module
 ///
 /// @pre UART must be configured
-/// @post SIM800L module is ready for sending and receiving texts and calls
+/// @post Set up commands are queued, they are sent by SIM_v_AtProcess
 /// @param None
 ///
 /// @return None
 ///
 /// @globals None
 ///
-/// @InOutCorelation Used for setting up SIM800L module.
+/// @InOutCorelation Used for setting up SIM800L module. AT is retried until the module answers with OK, after it
+///                  the status, text mode, live SMS and caller identification commands follow.
 /// @callsequence
 ///   @startuml "SIM_v_Setup.png"
 ///     title "Sequence diagram for function SIM_v_Setup"
 ///     -> SIM: SIM_v_Setup()
 ///     SIM++
-///       loop Re-send AT command to make sure to get the OK back.
-///         SIM -> SIM: v_SendCommand(AT)
-///       end
-///       SIM -> SIM: v_SendCommand(CSQ)
-///       SIM -> SIM: v_SendCommand(CCID)
-///       SIM -> SIM: v_SendCommand(CREG)
-///       rnote over SIM: Sends AT commands to set up SIM800L module.
+///       SIM -> SIM: v_QueueCommand(AT, ...)
+///       SIM -> SIM: v_QueueCommand(CSQ, ...)
+///       SIM -> SIM: v_QueueCommand(CCID, ...)
+///       SIM -> SIM: v_QueueCommand(CREG, ...)
+///       SIM -> SIM: v_QueueCommand(CMGF, ...)
+///       SIM -> SIM: v_QueueCommand(CNMI, ...)
+///       SIM -> SIM: v_QueueCommand(CLIPEN, ...)
 ///     <- SIM
 ///     SIM--
 ///   @enduml
@@ -116,9 +136,9 @@ void SIM_v_Setup(void);
 ///     title "Sequence diagram for function SIM_v_ReceiveMessage"
 ///     -> SIM: SIM_v_ReceiveMessage()
 ///     SIM++
-///       SIM -> SIM: v_SendCommand(AT)
-///       SIM -> SIM: v_SendCommand(CMGF)
-///       SIM -> SIM: v_SendCommand(CNMI)
+///       SIM -> SIM: v_QueueCommand(AT, ...)
+///       SIM -> SIM: v_QueueCommand(CMGF, ...)
+///       SIM -> SIM: v_QueueCommand(CNMI, ...)
 ///     <- SIM
 ///     SIM--
 ///   @enduml
@@ -131,17 +151,18 @@ void SIM_v_ReceiveMessage(void);
 /// @post None
 /// @param None
 ///
-/// @return static uint8_t u_CoordBuf[COORDINATES_BUFFER_LENGTH]
+/// @return static uint8_t u_CoordBuf[SIM800L_SMS_LENGTH + 1]
 ///
-/// @globals None
+/// @globals u_CoordBuf
 ///
-/// @InOutCorelation Function read coordinates via SIM800L module.
+/// @InOutCorelation Function returns the text of the last SMS, it is written by SIM_v_AtProcess when +CMT or +CMGR
+///                  is followed by the text, and by SIM_v_SendCoordinates. The text is a position or a track packed
+///                  by TRACK, CALCM_e_SetTarget reads both.
 /// @callsequence
 ///   @startuml "SIM_p_ReceiveCoordinates.png"
 ///     title "Sequence diagram for function SIM_p_ReceiveCoordinates"
 ///     -> SIM: SIM_p_ReceiveCoordinates()
 ///     SIM++
-///       SIM -> SIM: SIM_v_ReceiveMessage()
 ///     <- SIM://Returns a unit8_t * to a u_CoordBuf//
 ///     SIM--
 ///   @enduml
@@ -164,7 +185,8 @@ uint8_t * SIM_p_ReceiveCoordinates(void);
 ///     title "Sequence diagram for function SIM_v_EndCall"
 ///     -> SIM: SIM_v_EndCall()
 ///     SIM++
-///       SIM -> SIM: v_SendCommand(ATH)
+///       SIM -> SIM: v_QueueCommand(ATH, ..., v_CallEnded)
+///       rnote over SIM: SendMessage is set when the module answers.
 ///     <- SIM
 ///     SIM--
 ///   @enduml
@@ -193,10 +215,9 @@ void SIM_v_EndCall(void);
 ///       SIM -> SIM:  v_WriteIntoBuffer(u_Buffer, u_Cnt, u_Number)
 ///       rnote over SIM: Add ';' character for end of the command.
 ///       SIM -> SIM:  v_WriteIntoBuffer(u_Buffer, u_Cnt, u_CallCmd)
-///       SIM -> SIM: v_SendCommand(AT)
-///       UARTM -> SIM: UARTM3_v_SendString(u_Buffer)
-///       SIM -> SIM: v_EndOfCommand()
-///       rnote over SIM: Calls are made via SIM800L module and rejected after predetermined time frame.
+///       SIM -> SIM: v_QueueCommand(AT, ...)
+///       SIM -> SIM: SIM_b_AtSubmit(ATD command, ..., v_CallPlaced)
+///       rnote over SIM: EndCall is set when the module answers to ATD.
 ///     <- SIM
 ///     SIM--
 ///   @enduml
@@ -211,18 +232,17 @@ void SIM_v_CallNumber(uint8_t *u_Number);
 ///
 /// @return None
 ///
-/// @globals t_SIM_Command SIM800L_t_Dictionary[SIM800L_DICTIONARY_LENGTH]
+/// @globals SIM800L_t_CallerDictionary
 ///
-/// @InOutCorelation Function makes calls via SIM800L module.
+/// @InOutCorelation Function makes calls via SIM800L module. Numbers are listed in the order of e_SIM_KnownCaller so
+///                  e_Caller selects the entry directly.
 /// @callsequence
 ///   @startuml "SIM_v_Call.png"
 ///     title "Sequence diagram for function SIM_v_Call"
 ///     -> SIM: SIM_v_Call(e_SIM_KnownCaller e_Caller)
 ///     SIM++
-///       loop Goes through SIM800L_t_CallerDictionary elements in order to find known caller
-///         opt if known caller is found
-///           SIM -> SIM: SIM_v_CallNumber(SIM800L_t_CallerDictionary[u_Cnt].u_Number)
-///         end
+///       opt if e_Caller is in SIM800L_t_CallerDictionary
+///         SIM -> SIM: SIM_v_CallNumber(SIM800L_t_CallerDictionary[e_Caller].u_Number)
 ///       end
 ///     <- SIM
 ///     SIM--
@@ -240,7 +260,9 @@ void SIM_v_Call(e_SIM_KnownCaller e_Caller);
 ///
 /// @globals None
 ///
-/// @InOutCorelation Function sends messages via SIM800L module.
+/// @InOutCorelation Function sends messages via SIM800L module. Text is sent only after the '>' prompt, the queue
+///                  keeps copies of the number and the text, so several messages can wait in it. Text longer than
+///                  SIM800L_SMS_LENGTH is not sent.
 /// @callsequence
 ///   @startuml "SIM_v_SendMessage.png"
 ///     title "Sequence diagram for function SIM_v_SendMessage"
@@ -250,21 +272,18 @@ void SIM_v_Call(e_SIM_KnownCaller e_Caller);
 ///       SIM -> SIM: v_WriteIntoBuffer(u_Buffer, u_Cnt, u_NumCfg)
 ///       rnote over SIM: Number characters are also written into same buffer as the configuration message.
 ///       SIM -> SIM:  v_WriteIntoBuffer(u_Buffer, u_Cnt, u_Number)
-///       SIM -> SIM: v_SendCommand(AT)
-///       SIM -> SIM: v_SendCommand(CMGF)
-///       UARTM -> SIM: UARTM3_v_SendString(u_Buffer)
-///       SIM -> SIM: v_EndOfCommand()
-///       UARTM -> SIM: UARTM3_v_SendString(u_Message)
-///       SIM -> SIM: v_EndOfCommand()
-///       UARTM -> SIM: UARTM3_v_SendString(ESC)
-///       SIM -> SIM: v_EndOfCommand()
+///       SIM -> SIM: v_QueueCommand(AT, ...)
+///       SIM -> SIM: v_QueueCommand(CMGF, ...)
+///       SIM -> SIM: SIM_b_AtSubmit(CMGS command, PROMPT, v_MessagePrompt)
+///       SIM -> SIM: SIM_b_AtSubmit(text of the SMS ended with CTRL_Z, OK, v_MessageSent)
+///       rnote over SIM: ReadMessage is set when the module answers to the text.
 ///     <- SIM
 ///     SIM--
 ///   @enduml
 
 void SIM_v_SendMessage(uint8_t *u_Message, uint8_t *u_Number);
 
-/// @brief Function used for sending messages via SIM800L module
+/// @brief Function used for sending coordinates to a number from dictionary via SIM800L module
 ///
 /// @pre SIM800L must be configured
 /// @post None
@@ -272,27 +291,52 @@ void SIM_v_SendMessage(uint8_t *u_Message, uint8_t *u_Number);
 ///
 /// @return None
 ///
-/// @globals t_SIM_Command SIM800L_t_Dictionary[SIM800L_DICTIONARY_LENGTH]
+/// @globals SIM800L_t_CallerDictionary
 ///
-/// @InOutCorelation Function sends coordinates via SIM800L module.
+/// @InOutCorelation Numbers are listed in the order of e_SIM_KnownCaller so e_Caller selects the entry directly.
 /// @callsequence
 ///   @startuml "SIM_v_SendCoordinates.png"
 ///     title "Sequence diagram for function SIM_v_SendCoordinates"
 ///     -> SIM: SIM_v_SendCoordinates(e_SIM_KnownCaller e_Caller)
 ///     SIM++
-///       loop Goes through SIM800L_t_CallerDictionary in order to find the known caller
-///         SIM -> SIM: SIM_v_SendMessage(p_Coordinates, SIM800L_t_CallerDictionary[u_Cnt].u_Number)
-///         rnote over SIM: Coordinates are sent via SIM800L module to set number.
+///       opt if e_Caller is in SIM800L_t_CallerDictionary
+///         SIM -> SIM: SIM_v_SendCoordinatesTo(SIM800L_t_CallerDictionary[e_Caller].u_Number)
 ///       end
+///     <- SIM
+///     SIM--
+///   @enduml
+
+void SIM_v_SendCoordinates(e_SIM_KnownCaller e_Caller);
+
+/// @brief Function used for sending coordinates to a number via SIM800L module
+///
+/// @pre SIM800L must be configured
+/// @post None
+/// @param uint8_t *u_Number
+///
+/// @return None
+///
+/// @globals u_CoordBuf
+///
+/// @InOutCorelation Function sends coordinates via SIM800L module, the sent coordinates are also kept as received
+///                  ones and set as the bearing target.
+/// @callsequence
+///   @startuml "SIM_v_SendCoordinatesTo.png"
+///     title "Sequence diagram for function SIM_v_SendCoordinatesTo"
+///     -> SIM: SIM_v_SendCoordinatesTo(uint8_t *u_Number)
+///     SIM++
+///       SIM -> SIM: SIM_v_SendMessage(p_Coordinates, u_Number)
+///       rnote over SIM: Coordinates are sent via SIM800L module to set number.
 ///       loop Goes through elements of u_CoordBuf
 ///         rnote over SIM: Writes 0 values in all elements in order to clear the previous data
 ///       end
 ///       SIM -> SIM: v_WriteIntoBuffer(SIM_u_Buffer, u_Cnt, p_Coordinates)
+///       SIM -> CALCM: CALCM_e_SetTarget(u_CoordBuf, sizeof(u_CoordBuf))
 ///     <- SIM
 ///     SIM--
 ///   @enduml
 
-void SIM_v_SendCoordinates(e_SIM_KnownCaller e_Caller);
+void SIM_v_SendCoordinatesTo(uint8_t *u_Number);
 
 /// @brief Function used for parsing a pointer to a buffer where coordinates read from SIM800L are stored
 ///
@@ -316,17 +360,22 @@ void SIM_v_SendCoordinates(e_SIM_KnownCaller e_Caller);
 ///         opt switch IdleFunction
 ///           rnote over SIM: If other function are done, SIM waits in idle for new function.
 ///         else else MakeCall
-///           MSGM -> SIM: MSGM_p_GetRawMessage()
-///           rnote over SIM: Coordinates are stored in the moment when the button is pressed so they won't be rewritten
+///           SIM -> SIM: v_TakeSnapshot()
+///           rnote over SIM: Coordinates are copied in the moment when the button is pressed so they won't be rewritten
 ///           SIM -> SIM:  SIM_v_Call(SIM_module)
-///           rnote over SIM: Set e_CurrentFunction as EndCall
+///           rnote over SIM: Callback of ATD sets e_CurrentFunction as EndCall
 ///         else else EndCall
 ///           SIM -> SIM: SIM_v_EndCall()
-///           rnote over SIM: Set e_CurrentFunction as SendMessage
+///           rnote over SIM: Callback of ATH sets e_CurrentFunction as SendMessage
 ///         else else SendMessage
-///           SIM -> SIM: SIM_v_SendCoordinates(Aleksandra)
-///           rnote over SIM: Sets e_CurrentFunction as ReadMessage
+///           opt if a known caller rang
+///             SIM -> SIM: SIM_v_SendCoordinatesTo(SIM_a_ReplyNumber)
+///           else else
+///             SIM -> SIM: SIM_v_SendCoordinates(SIM800L_DEFAULT_RECIPIENT)
+///           end
+///           rnote over SIM: Callback of the SMS text sets e_CurrentFunction as ReadMessage
 ///         else else ReadMessage
+///           SIM -> SIM: SIM_v_ReceiveMessage()
 ///         else else default
 ///         end
 ///       end
@@ -337,6 +386,94 @@ void SIM_v_SendCoordinates(e_SIM_KnownCaller e_Caller);
 
 void SIM_v_StateMachine(void);
 
+/// @brief Function used for adding a command to the queue of the AT engine
+///
+/// @pre None
+/// @post Command is sent by SIM_v_AtProcess after all commands queued before it are finished
+/// @param const t_SIM_AtCommand *p_Command
+///
+/// @return boolean b_TRUE if the command is queued, b_FALSE if the queue is full or the text is longer than
+///         SIM800L_AT_TEXT_LENGTH - 1
+///
+/// @globals SIM_a_AtQueue
+///
+/// @InOutCorelation Function copies the command description and its text into the queue, so the caller can reuse
+///                  the text as soon as the function returns. Queue is used only by the task which calls
+///                  SIM_v_AtProcess, or before the scheduler is started.
+/// @callsequence
+///   @startuml "SIM_b_AtSubmit.png"
+///     title "Sequence diagram for function SIM_b_AtSubmit"
+///     -> SIM: SIM_b_AtSubmit(const t_SIM_AtCommand *p_Command)
+///     SIM++
+///       opt if queue is not full and the text fits
+///         rnote over SIM: Command and its text are copied to the tail of the queue.
+///       end
+///     <- SIM://Returns boolean//
+///     SIM--
+///   @enduml
+
+boolean SIM_b_AtSubmit(const t_SIM_AtCommand *p_Command);
+
+/// @brief Function used for running the AT engine
+///
+/// @pre UART3 must be configured
+/// @post Received lines are handled, finished commands have called their callbacks
+/// @param None
+///
+/// @return None
+///
+/// @globals SIM_a_AtQueue, SIM_a_Line, u_CoordBuf
+///
+/// @InOutCorelation Function never blocks. It splits bytes from the USART3 ring buffer into lines and matches every
+///                  line against SIM800L_t_ResponseDictionary. Expected response finishes the command at the head of
+///                  the queue, ERROR and timeout resend it until its retries are used. Unsolicited +CLIP, +CMTI and
+///                  +CMT responses are handled at any time. When no command is waiting for a response the next one
+///                  is sent.
+/// @callsequence
+///   @startuml "SIM_v_AtProcess.png"
+///     title "Sequence diagram for function SIM_v_AtProcess"
+///     -> SIM: SIM_v_AtProcess()
+///     SIM++
+///       loop while USART3 ring buffer is not empty
+///         MSGM -> SIM: MSGM_u_CircularBufferPop(RING_BUFFER2)
+///         opt if line is complete
+///           SIM -> SIM: v_HandleLine()
+///         end
+///       end
+///       opt if command timed out
+///         SIM -> SIM: v_AtFinish(NO_RSP)
+///       end
+///       opt if no command is waiting for a response
+///         SIM -> SIM: v_AtSend()
+///       end
+///     <- SIM
+///     SIM--
+///   @enduml
+
+void SIM_v_AtProcess(void);
+
+/// @brief Function used for checking if the AT engine has work
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return boolean b_TRUE if no command is queued or waiting for a response
+///
+/// @globals SIM_a_AtQueue
+///
+/// @InOutCorelation Function checks the number of commands in the queue.
+/// @callsequence
+///   @startuml "SIM_b_AtIdle.png"
+///     title "Sequence diagram for function SIM_b_AtIdle"
+///     -> SIM: SIM_b_AtIdle()
+///     SIM++
+///     <- SIM://Returns boolean//
+///     SIM--
+///   @enduml
+
+boolean SIM_b_AtIdle(void);
+
 /// @brief Function used for parsing a pointer to a buffer where coordinates read from SIM800L are stored
 ///
 /// @pre SIM800L must be configured
@@ -360,6 +497,32 @@ void SIM_v_StateMachine(void);
 
 t_SIM_Function * SIM_p_Function(void);
 
+/// @brief Function used for changing the function of SIM module from another task
+///
+/// @pre None
+/// @post e_CurrentFunction is e_To if it was e_From
+/// @param e_SIM_Function e_From, e_SIM_Function e_To
+///
+/// @return boolean b_TRUE if the function was changed
+///
+/// @globals t_SIM_Function SIM800L_t_Functions[SIM800L_STATES]
+///
+/// @InOutCorelation Compare and store are done in a critical section of a few instructions, so a change made by
+///                  the SIM task is never overwritten by a stale value.
+/// @callsequence
+///   @startuml "SIM_b_SwitchFunction.png"
+///     title "Sequence diagram for function SIM_b_SwitchFunction"
+///     -> SIM: SIM_b_SwitchFunction(e_SIM_Function e_From, e_SIM_Function e_To)
+///     SIM++
+///       opt if e_CurrentFunction is e_From
+///         rnote over SIM: e_CurrentFunction is set to e_To
+///       end
+///     <- SIM://Returns boolean//
+///     SIM--
+///   @enduml
+
+boolean SIM_b_SwitchFunction(e_SIM_Function e_From, e_SIM_Function e_To);
+
 /// @brief Function used for parsing semaphore flag value
 ///
 /// @pre None
@@ -0,0 +1,23 @@
+/// @file TIMEB_cfg.h
+/// @brief Contains configuration data used for the microsecond timebase
+/// @author Aleksandra Petrovic
+
+#ifndef TIMEB_CFG_H_
+#define TIMEB_CFG_H_
+
+#include "Registers.h"
+
+/// Enable TIM5 CLOCK
+#define APB1ENR_TIM5_CLOCK (1u << 3u)
+/// Prescaler of TIM5, timer clock of APB1 is 90 MHz so the counter ticks every microsecond
+#define TIMEB_TIM5_PRESCALER (90u - 1u)
+/// Auto-reload value of TIM5, the counter uses all 32 bits
+#define TIMEB_TIM5_RELOAD (0xFFFFFFFFu)
+/// Counter enable
+#define TIM_CR1_COUNTER_ENABLE (1u << 0u)
+/// Update generation, loads the prescaler immediately
+#define TIM_EGR_UPDATE (1u << 0u)
+/// Longest deadline in microseconds which is still compared correctly after the counter wraps
+#define TIMEB_MAX_DEADLINE_US (0x7FFFFFFFu)
+
+#endif /* TIMEB_CFG_H_ */
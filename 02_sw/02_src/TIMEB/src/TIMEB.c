@@ -0,0 +1,45 @@
+/// @file TIMEB.c
+/// @brief Main file used for the monotonic microsecond timebase and deadlines
+/// @author Aleksandra Petrovic
+
+#include "TIMEB.h"
+#include "TIMEB_cfg.h"
+
+void TIMEB_v_Init()
+{
+  REG32(RCC_APB1ENR) |= APB1ENR_TIM5_CLOCK;                        // Enable TIM5 CLOCK
+  REG32(TIM5_CR1) = 0x00u;                                         // Stop the counter while it is configured
+  REG32(TIM5_PSC) = TIMEB_TIM5_PRESCALER;                          // One tick per microsecond
+  REG32(TIM5_ARR) = TIMEB_TIM5_RELOAD;                             // Count through all 32 bits
+  REG32(TIM5_EGR) = TIM_EGR_UPDATE;                                // Load the prescaler now, not at the first overflow
+  REG32(TIM5_CNT) = 0u;
+  REG32(TIM5_CR1) = TIM_CR1_COUNTER_ENABLE;                        // Start counting
+}
+
+uint32_t TIMEB_u_NowUs()
+{
+  return REG32(TIM5_CNT);
+}
+
+t_TIMEB_Deadline TIMEB_t_DeadlineInUs(uint32_t u_Us)
+{
+  t_TIMEB_Deadline t_Deadline;
+
+  // Longer deadlines would look expired as soon as they are created
+  if(u_Us > TIMEB_MAX_DEADLINE_US)
+  {
+    u_Us = TIMEB_MAX_DEADLINE_US;
+  }
+  t_Deadline.u_Expiry = TIMEB_u_NowUs() + u_Us;
+  return t_Deadline;
+}
+
+boolean TIMEB_b_DeadlineExpired(t_TIMEB_Deadline t_Deadline)
+{
+  // Difference is taken modulo 2^32, it is negative while the deadline is in the future
+  if((int32_t)(TIMEB_u_NowUs() - t_Deadline.u_Expiry) >= 0)
+  {
+    return b_TRUE;
+  }
+  return b_FALSE;
+}
@@ -0,0 +1,109 @@
+/// @file TIMEB.h
+/// @brief Header file used for the monotonic microsecond timebase and deadlines
+/// @author Aleksandra Petrovic
+
+#ifndef TIMEB_H_
+#define TIMEB_H_
+
+#include "stm32f439xx.h"
+#include "MSGM.h"
+
+/// This structure is used to describe a point in time after which a wait is given up
+typedef struct {
+  uint32_t u_Expiry;  ///< Value of the microsecond counter at which the deadline expires
+} t_TIMEB_Deadline;
+
+/// @brief Function used for starting the microsecond timebase
+///
+/// @pre System clock must be configured
+/// @post TIM5 counts microseconds from 0
+/// @param None
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Function sets up TIM5 as a free running 32-bit up counter with one microsecond per tick.
+/// @callsequence
+///   @startuml "TIMEB_v_Init.png"
+///     title "Sequence diagram for function TIMEB_v_Init"
+///     -> TIMEB: TIMEB_v_Init()
+///     TIMEB++
+///       rnote over TIMEB: TIM5 clock is enabled, prescaler and reload are set and the counter is started.
+///     <- TIMEB
+///     TIMEB--
+///   @enduml
+
+void TIMEB_v_Init(void);
+
+/// @brief Function used for reading the current time
+///
+/// @pre TIMEB_v_Init must be done
+/// @post None
+/// @param None
+///
+/// @return uint32_t microseconds since TIMEB_v_Init, wraps after about 71 minutes
+///
+/// @globals None
+///
+/// @InOutCorelation Function reads TIM5 counter. Reading is a single load, so it can be used from any task or interrupt.
+/// @callsequence
+///   @startuml "TIMEB_u_NowUs.png"
+///     title "Sequence diagram for function TIMEB_u_NowUs"
+///     -> TIMEB: TIMEB_u_NowUs()
+///     TIMEB++
+///     <- TIMEB: Returns TIM5 counter
+///     TIMEB--
+///   @enduml
+
+uint32_t TIMEB_u_NowUs(void);
+
+/// @brief Function used for creating a deadline
+///
+/// @pre TIMEB_v_Init must be done
+/// @post None
+/// @param uint32_t u_Us time from now in microseconds, not longer than TIMEB_MAX_DEADLINE_US
+///
+/// @return t_TIMEB_Deadline
+///
+/// @globals None
+///
+/// @InOutCorelation Function adds u_Us to the current time. The deadline is kept by the caller, so waits of different
+///                  tasks and interrupts do not share any state.
+/// @callsequence
+///   @startuml "TIMEB_t_DeadlineInUs.png"
+///     title "Sequence diagram for function TIMEB_t_DeadlineInUs"
+///     -> TIMEB: TIMEB_t_DeadlineInUs(uint32_t u_Us)
+///     TIMEB++
+///       TIMEB -> TIMEB: TIMEB_u_NowUs()
+///     <- TIMEB: Returns t_TIMEB_Deadline
+///     TIMEB--
+///   @enduml
+
+t_TIMEB_Deadline TIMEB_t_DeadlineInUs(uint32_t u_Us);
+
+/// @brief Function used for checking a deadline
+///
+/// @pre Deadline must be created by TIMEB_t_DeadlineInUs
+/// @post None
+/// @param t_TIMEB_Deadline t_Deadline
+///
+/// @return boolean b_TRUE if the deadline has passed
+///
+/// @globals None
+///
+/// @InOutCorelation Function compares the current time with the deadline as a signed difference, so the result is
+///                  correct when the counter wraps between creating and checking the deadline.
+/// @callsequence
+///   @startuml "TIMEB_b_DeadlineExpired.png"
+///     title "Sequence diagram for function TIMEB_b_DeadlineExpired"
+///     -> TIMEB: TIMEB_b_DeadlineExpired(t_TIMEB_Deadline t_Deadline)
+///     TIMEB++
+///       TIMEB -> TIMEB: TIMEB_u_NowUs()
+///     <- TIMEB: Returns boolean
+///     TIMEB--
+///   @enduml
+
+boolean TIMEB_b_DeadlineExpired(t_TIMEB_Deadline t_Deadline);
+
+#endif /* TIMEB_H_ */
@@ -0,0 +1,48 @@
+/// @file TRACK_cfg.h
+/// @brief Contains configuration data used for the packed track sent in one SMS
+/// @author Aleksandra Petrovic
+
+#ifndef TRACK_CFG_H_
+#define TRACK_CFG_H_
+
+#include "TRACK.h"
+
+/// Characters of one SMS in the GSM 7-bit default alphabet
+#define TRACK_SMS_LENGTH (160u)
+/// Micro-degrees in one unit of a packed coordinate, 1e-5 degrees is about 1.1 m
+#define TRACK_UNIT_MICRODEGREES (10)
+/// Added to a latitude in units so the absolute field is never negative
+#define TRACK_LATITUDE_OFFSET (9000000)
+/// Added to a longitude in units so the absolute field is never negative
+#define TRACK_LONGITUDE_OFFSET (18000000)
+/// Days from 1 March 0000 to 1 January 2000, the start of the time used for deltas
+#define TRACK_EPOCH_DAYS (730425u)
+/// Seconds in one day
+#define TRACK_SECONDS_PER_DAY (86400u)
+
+/// Bits of one character, each one holds a digit of the 64 character alphabet
+#define TRACK_DIGIT_BITS (6u)
+/// Bits of the number of deltas
+#define TRACK_COUNT_BITS (4u)
+/// Bits of the stale flag
+#define TRACK_STALE_BITS (1u)
+/// Bits of the width of a coordinate delta and of a time delta
+#define TRACK_WIDTH_BITS (5u)
+/// Bits of the date as ddmmyy
+#define TRACK_DATE_BITS (19u)
+/// Bits of the time as seconds of the day
+#define TRACK_TIME_BITS (17u)
+/// Bits of the absolute latitude in units
+#define TRACK_LATITUDE_BITS (25u)
+/// Bits of the absolute longitude in units
+#define TRACK_LONGITUDE_BITS (26u)
+/// Bits in front of the deltas
+#define TRACK_HEADER_BITS (TRACK_COUNT_BITS + TRACK_STALE_BITS + (2u * TRACK_WIDTH_BITS) + TRACK_DATE_BITS + \
+                           TRACK_TIME_BITS + TRACK_LATITUDE_BITS + TRACK_LONGITUDE_BITS)
+
+/// Digit 62 of the alphabet, digits 0 to 61 are A-Z, a-z and 0-9
+#define TRACK_DIGIT_62 ('+')
+/// Digit 63 of the alphabet
+#define TRACK_DIGIT_63 ('/')
+
+#endif /* TRACK_CFG_H_ */
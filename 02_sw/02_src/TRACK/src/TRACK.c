@@ -0,0 +1,543 @@
+/// @file TRACK.c
+/// @brief Main file used for packing a track of fixes into the text of one SMS and unpacking it
+/// @author Aleksandra Petrovic
+
+#include "TRACK.h"
+#include "TRACK_cfg.h"
+#include "FIXLOG.h"
+
+_Static_assert(TRACK_MAX_FIXES == (1u << TRACK_COUNT_BITS), "Count of deltas covers every fix after the first");
+
+/// Fixes gathered by TRACK_u_Encode, kept off the stack of TSK_SIM
+static t_MSGM_Fix TRACK_a_Fixes[TRACK_MAX_FIXES];
+/// Record read from the fix log by TRACK_u_Encode
+static t_FIXLOG_Record TRACK_t_Record;
+
+/// @brief Function used for converting a date and time to seconds
+///
+/// @pre Date is 0 or a valid ddmmyy, time is a valid hhmmss
+/// @post None
+/// @param uint32_t u_Date, uint32_t u_Time
+///
+/// @return uint32_t seconds since 1 January 2000, seconds of the day when the date is 0
+///
+/// @globals None
+///
+/// @InOutCorelation Days since 1 March 0000 are counted with whole 400, 100 and 4 year cycles, the inverse of the
+///                  conversion in v_SetDateTime.
+/// @callsequence
+///   @startuml "u_Seconds.png"
+///     title "Sequence diagram for function u_Seconds"
+///     -> TRACK: u_Seconds(uint32_t u_Date, uint32_t u_Time)
+///     TRACK++
+///     <- TRACK:// Returns seconds//
+///     TRACK--
+///   @enduml
+
+static uint32_t u_Seconds(uint32_t u_Date, uint32_t u_Time);
+
+static uint32_t u_Seconds(uint32_t u_Date, uint32_t u_Time)
+{
+  uint32_t u_Day        = u_Date / 10000u;
+  uint32_t u_Month      = (u_Date / 100u) % 100u;
+  uint32_t u_Year       = 2000u + (u_Date % 100u) - ((u_Month <= 2u) ? 1u : 0u);
+  uint32_t u_MonthIndex = (u_Month > 2u) ? (u_Month - 3u) : (u_Month + 9u);    // 0 is March
+  uint32_t u_OfDay      = ((u_Time / 10000u) * 3600u) + (((u_Time / 100u) % 100u) * 60u) + (u_Time % 100u);
+
+  if (u_Date == 0u)
+  {
+    return u_OfDay;
+  }
+  uint32_t u_Days = (365u * u_Year) + (u_Year / 4u) - (u_Year / 100u) + (u_Year / 400u) +
+                    (((153u * u_MonthIndex) + 2u) / 5u) + u_Day - 1u - TRACK_EPOCH_DAYS;
+  return (u_Days * TRACK_SECONDS_PER_DAY) + u_OfDay;
+}
+
+/// @brief Function used for converting seconds to the date and time of a fix
+///
+/// @pre None
+/// @post p_Fix holds the time as hhmmss and the date as ddmmyy, or 0 when the track has no date
+/// @param t_MSGM_Fix *p_Fix, uint32_t u_Elapsed, boolean b_Dated
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Days since 1 March 0000 are turned into year, month and day with whole 400, 100 and 4 year
+///                  cycles, which needs no loop and no table.
+/// @callsequence
+///   @startuml "v_SetDateTime.png"
+///     title "Sequence diagram for function v_SetDateTime"
+///     -> TRACK: v_SetDateTime(t_MSGM_Fix *p_Fix, uint32_t u_Elapsed, boolean b_Dated)
+///     TRACK++
+///     <- TRACK
+///     TRACK--
+///   @enduml
+
+static void v_SetDateTime(t_MSGM_Fix *p_Fix, uint32_t u_Elapsed, boolean b_Dated);
+
+static void v_SetDateTime(t_MSGM_Fix *p_Fix, uint32_t u_Elapsed, boolean b_Dated)
+{
+  uint32_t u_Days       = (u_Elapsed / TRACK_SECONDS_PER_DAY) + TRACK_EPOCH_DAYS;
+  uint32_t u_Time       = u_Elapsed % TRACK_SECONDS_PER_DAY;
+  uint32_t u_Era        = u_Days / 146097u;
+  uint32_t u_DayOfEra   = u_Days - (u_Era * 146097u);
+  uint32_t u_YearOfEra  = (u_DayOfEra - (u_DayOfEra / 1460u) + (u_DayOfEra / 36524u) - (u_DayOfEra / 146096u)) / 365u;
+  uint32_t u_DayOfYear  = u_DayOfEra - ((365u * u_YearOfEra) + (u_YearOfEra / 4u) - (u_YearOfEra / 100u));
+  uint32_t u_MonthIndex = ((5u * u_DayOfYear) + 2u) / 153u;              // 0 is March
+  uint32_t u_Day        = u_DayOfYear - (((153u * u_MonthIndex) + 2u) / 5u) + 1u;
+  uint32_t u_Month      = (u_MonthIndex < 10u) ? (u_MonthIndex + 3u) : (u_MonthIndex - 9u);
+  uint32_t u_Year       = u_YearOfEra + (u_Era * 400u) + ((u_Month <= 2u) ? 1u : 0u);
+
+  p_Fix -> u_Time = ((u_Time / 3600u) * 10000u) + (((u_Time / 60u) % 60u) * 100u) + (u_Time % 60u);
+  p_Fix -> u_Date = (b_Dated == b_TRUE) ? ((u_Day * 10000u) + (u_Month * 100u) + (u_Year % 100u)) : 0u;
+}
+
+/// @brief Function used for converting micro-degrees to units of a packed coordinate
+///
+/// @pre None
+/// @post None
+/// @param int32_t i_MicroDegrees
+///
+/// @return int32_t units of TRACK_UNIT_MICRODEGREES rounded half away from 0
+///
+/// @globals None
+///
+/// @InOutCorelation None
+/// @callsequence
+///   @startuml "i_ToUnits.png"
+///     title "Sequence diagram for function i_ToUnits"
+///     -> TRACK: i_ToUnits(int32_t i_MicroDegrees)
+///     TRACK++
+///     <- TRACK:// Returns units//
+///     TRACK--
+///   @enduml
+
+static int32_t i_ToUnits(int32_t i_MicroDegrees);
+
+static int32_t i_ToUnits(int32_t i_MicroDegrees)
+{
+  int32_t i_Half = TRACK_UNIT_MICRODEGREES / 2;
+
+  return (i_MicroDegrees + ((i_MicroDegrees < 0) ? -i_Half : i_Half)) / TRACK_UNIT_MICRODEGREES;
+}
+
+/// @brief Function used for getting the number of bits a value needs
+///
+/// @pre None
+/// @post None
+/// @param uint32_t u_Value
+///
+/// @return uint8_t position of the highest set bit plus 1, 0 for 0
+///
+/// @globals None
+///
+/// @InOutCorelation None
+/// @callsequence
+///   @startuml "u_BitLength.png"
+///     title "Sequence diagram for function u_BitLength"
+///     -> TRACK: u_BitLength(uint32_t u_Value)
+///     TRACK++
+///     <- TRACK:// Returns width//
+///     TRACK--
+///   @enduml
+
+static uint8_t u_BitLength(uint32_t u_Value);
+
+static uint8_t u_BitLength(uint32_t u_Value)
+{
+  uint8_t u_Bits = 0u;
+
+  while (u_Value != 0u)
+  {
+    u_Value >>= 1u;
+    u_Bits++;
+  }
+  return u_Bits;
+}
+
+/// @brief Function used for getting the number of bits a signed value needs in two's complement
+///
+/// @pre None
+/// @post None
+/// @param int32_t i_Value
+///
+/// @return uint8_t width, 0 for 0 since a delta of 0 needs no bits when every delta is 0
+///
+/// @globals None
+///
+/// @InOutCorelation A negative value needs as many bits as its one's complement plus the sign bit.
+/// @callsequence
+///   @startuml "u_SignedWidth.png"
+///     title "Sequence diagram for function u_SignedWidth"
+///     -> TRACK: u_SignedWidth(int32_t i_Value)
+///     TRACK++
+///       TRACK -> TRACK: u_BitLength(...)
+///     <- TRACK:// Returns width//
+///     TRACK--
+///   @enduml
+
+static uint8_t u_SignedWidth(int32_t i_Value);
+
+static uint8_t u_SignedWidth(int32_t i_Value)
+{
+  if (i_Value == 0)
+  {
+    return 0u;
+  }
+  return (uint8_t)(u_BitLength((i_Value < 0) ? ~(uint32_t)i_Value : (uint32_t)i_Value) + 1u);
+}
+
+/// @brief Function used for appending a field to the bit stream
+///
+/// @pre Text has room for the field, u_Width is at most 32
+/// @post Every complete character is written to the text
+/// @param t_TRACK_Bits *p_Bits, uint32_t u_Value, uint8_t u_Width
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Bits above u_Width are dropped, so a negative delta is written in two's complement.
+/// @callsequence
+///   @startuml "v_Put.png"
+///     title "Sequence diagram for function v_Put"
+///     -> TRACK: v_Put(...)
+///     TRACK++
+///       loop while six bits are held
+///         rnote over TRACK: Digit is written as A-Z, a-z, 0-9, '+' or '/'.
+///       end
+///     <- TRACK
+///     TRACK--
+///   @enduml
+
+static void v_Put(t_TRACK_Bits *p_Bits, uint32_t u_Value, uint8_t u_Width);
+
+static void v_Put(t_TRACK_Bits *p_Bits, uint32_t u_Value, uint8_t u_Width)
+{
+  p_Bits -> u_Value = (p_Bits -> u_Value << u_Width) | ((uint64_t)u_Value & ((1ULL << u_Width) - 1u));
+  p_Bits -> u_Bits = (uint8_t)(p_Bits -> u_Bits + u_Width);
+  while (p_Bits -> u_Bits >= TRACK_DIGIT_BITS)
+  {
+    p_Bits -> u_Bits = (uint8_t)(p_Bits -> u_Bits - TRACK_DIGIT_BITS);
+    uint8_t u_Digit = (uint8_t)((p_Bits -> u_Value >> p_Bits -> u_Bits) & 0x3Fu);
+    p_Bits -> u_Value &= (1ULL << p_Bits -> u_Bits) - 1u;
+
+    if (u_Digit < 26u)
+    {
+      u_Digit = (uint8_t)('A' + u_Digit);
+    }
+    else if (u_Digit < 52u)
+    {
+      u_Digit = (uint8_t)('a' + (u_Digit - 26u));
+    }
+    else if (u_Digit < 62u)
+    {
+      u_Digit = (uint8_t)('0' + (u_Digit - 52u));
+    }
+    else
+    {
+      u_Digit = (u_Digit == 62u) ? TRACK_DIGIT_62 : TRACK_DIGIT_63;
+    }
+    p_Bits -> p_Write[p_Bits -> u_Index++] = u_Digit;
+  }
+}
+
+/// @brief Function used for taking a field from the bit stream
+///
+/// @pre u_Width is at most 32
+/// @post Bits of the field are consumed, on error e_Status is set and 0 is returned
+/// @param t_TRACK_Bits *p_Bits, uint8_t u_Width
+///
+/// @return uint32_t value of the field
+///
+/// @globals None
+///
+/// @InOutCorelation Characters are read only when the held bits do not cover the field, each one adds six bits.
+/// @callsequence
+///   @startuml "u_Get.png"
+///     title "Sequence diagram for function u_Get"
+///     -> TRACK: u_Get(...)
+///     TRACK++
+///       loop while fewer than u_Width bits are held
+///         opt if text ended
+///           <- TRACK:// Returns 0, CALCM_PARSE_INVALID_FORMAT is stored//
+///         else else if character is not in the alphabet
+///           <- TRACK:// Returns 0, CALCM_PARSE_INVALID_CHARACTER is stored//
+///         end
+///       end
+///     <- TRACK:// Returns the field//
+///     TRACK--
+///   @enduml
+
+static uint32_t u_Get(t_TRACK_Bits *p_Bits, uint8_t u_Width);
+
+static uint32_t u_Get(t_TRACK_Bits *p_Bits, uint8_t u_Width)
+{
+  while ((p_Bits -> e_Status == CALCM_PARSE_OK) && (p_Bits -> u_Bits < u_Width))
+  {
+    uint8_t  u_Char  = (p_Bits -> u_Index < p_Bits -> u_Limit) ? p_Bits -> p_Read[p_Bits -> u_Index] : 0u;
+    uint32_t u_Digit = 0u;
+
+    // Characters below the start of a range wrap around, so one comparison checks the whole range
+    if (((uint32_t)u_Char - (uint32_t)'A') < 26u)
+    {
+      u_Digit = (uint32_t)u_Char - (uint32_t)'A';
+    }
+    else if (((uint32_t)u_Char - (uint32_t)'a') < 26u)
+    {
+      u_Digit = (uint32_t)u_Char - (uint32_t)'a' + 26u;
+    }
+    else if (((uint32_t)u_Char - (uint32_t)'0') < 10u)
+    {
+      u_Digit = (uint32_t)u_Char - (uint32_t)'0' + 52u;
+    }
+    else if (u_Char == TRACK_DIGIT_62)
+    {
+      u_Digit = 62u;
+    }
+    else if (u_Char == TRACK_DIGIT_63)
+    {
+      u_Digit = 63u;
+    }
+    else
+    {
+      p_Bits -> e_Status = (u_Char == 0u) ? CALCM_PARSE_INVALID_FORMAT : CALCM_PARSE_INVALID_CHARACTER;
+      break;
+    }
+    p_Bits -> u_Value = (p_Bits -> u_Value << TRACK_DIGIT_BITS) | u_Digit;
+    p_Bits -> u_Bits = (uint8_t)(p_Bits -> u_Bits + TRACK_DIGIT_BITS);
+    p_Bits -> u_Index++;
+  }
+  if (p_Bits -> e_Status != CALCM_PARSE_OK)
+  {
+    return 0u;
+  }
+  p_Bits -> u_Bits = (uint8_t)(p_Bits -> u_Bits - u_Width);
+  uint32_t u_Field = (uint32_t)((p_Bits -> u_Value >> p_Bits -> u_Bits) & ((1ULL << u_Width) - 1u));
+  p_Bits -> u_Value &= (1ULL << p_Bits -> u_Bits) - 1u;
+  return u_Field;
+}
+
+/// @brief Function used for taking a signed field from the bit stream
+///
+/// @pre u_Width is at most 32
+/// @post Bits of the field are consumed
+/// @param t_TRACK_Bits *p_Bits, uint8_t u_Width
+///
+/// @return int32_t value of the field read in two's complement
+///
+/// @globals None
+///
+/// @InOutCorelation None
+/// @callsequence
+///   @startuml "i_GetSigned.png"
+///     title "Sequence diagram for function i_GetSigned"
+///     -> TRACK: i_GetSigned(...)
+///     TRACK++
+///       TRACK -> TRACK: u_Get(p_Bits, u_Width)
+///     <- TRACK:// Returns the field//
+///     TRACK--
+///   @enduml
+
+static int32_t i_GetSigned(t_TRACK_Bits *p_Bits, uint8_t u_Width);
+
+static int32_t i_GetSigned(t_TRACK_Bits *p_Bits, uint8_t u_Width)
+{
+  int64_t i_Field = (int64_t)u_Get(p_Bits, u_Width);
+
+  if ((u_Width != 0u) && ((i_Field >> (u_Width - 1u)) != 0))
+  {
+    i_Field -= (int64_t)(1ULL << u_Width);
+  }
+  return (int32_t)i_Field;
+}
+
+uint8_t TRACK_u_Pack(const t_MSGM_Fix *p_Fixes, uint8_t u_Count, boolean b_Stale, uint8_t *p_Text, uint16_t u_Size)
+{
+  t_TRACK_Bits t_Bits       = {0};
+  uint32_t     u_Limit      = (u_Size > TRACK_SMS_LENGTH) ? TRACK_SMS_LENGTH : ((u_Size != 0u) ? (u_Size - 1u) : 0u);
+  uint32_t     u_Newer      = 0u;
+  uint8_t      u_Deltas     = 0u;
+  uint8_t      u_DeltaWidth = 0u;
+  uint8_t      u_TimeWidth  = 0u;
+  boolean      b_Dated      = b_FALSE;
+
+  // Marker and the digits of the header must fit
+  if ((u_Count == 0u) || ((1u + ((TRACK_HEADER_BITS + TRACK_DIGIT_BITS - 1u) / TRACK_DIGIT_BITS)) > u_Limit))
+  {
+    return 0u;
+  }
+  b_Dated = (p_Fixes[0].u_Date != 0u) ? b_TRUE : b_FALSE;
+  u_Newer = u_Seconds(p_Fixes[0].u_Date, p_Fixes[0].u_Time);
+
+  // Widths only grow with each fix which is added, so the first fix which does not fit ends the track
+  for (uint8_t u_Cnt = 1u; (u_Cnt < u_Count) && (u_Cnt < TRACK_MAX_FIXES); u_Cnt++)
+  {
+    const t_MSGM_Fix *p_Newer = &p_Fixes[u_Cnt - 1u];
+    const t_MSGM_Fix *p_Older = &p_Fixes[u_Cnt];
+    uint32_t u_Older = u_Seconds(p_Older -> u_Date, p_Older -> u_Time);
+    uint8_t  u_Next  = u_DeltaWidth;
+    uint8_t  u_Time  = u_BitLength(u_Newer - u_Older);
+
+    if ((((p_Older -> u_Date != 0u) ? b_TRUE : b_FALSE) != b_Dated) || (u_Older >= u_Newer) || (u_Time > 31u))
+    {
+      break;
+    }
+    uint8_t u_Lat = u_SignedWidth(i_ToUnits(p_Older -> i_Latitude) - i_ToUnits(p_Newer -> i_Latitude));
+    uint8_t u_Lon = u_SignedWidth(i_ToUnits(p_Older -> i_Longitude) - i_ToUnits(p_Newer -> i_Longitude));
+    u_Next = (u_Lat > u_Next) ? u_Lat : u_Next;
+    u_Next = (u_Lon > u_Next) ? u_Lon : u_Next;
+    u_Time = (u_TimeWidth > u_Time) ? u_TimeWidth : u_Time;
+
+    uint32_t u_Bits = TRACK_HEADER_BITS + ((uint32_t)u_Cnt * (u_Time + (2u * u_Next)));
+    if ((1u + ((u_Bits + TRACK_DIGIT_BITS - 1u) / TRACK_DIGIT_BITS)) > u_Limit)
+    {
+      break;
+    }
+    u_DeltaWidth = u_Next;
+    u_TimeWidth = u_Time;
+    u_Deltas = u_Cnt;
+    u_Newer = u_Older;
+  }
+
+  t_Bits.p_Write = p_Text;
+  p_Text[t_Bits.u_Index++] = TRACK_MARKER;
+  v_Put(&t_Bits, u_Deltas, TRACK_COUNT_BITS);
+  v_Put(&t_Bits, (b_Stale == b_TRUE) ? 1u : 0u, TRACK_STALE_BITS);
+  v_Put(&t_Bits, u_DeltaWidth, TRACK_WIDTH_BITS);
+  v_Put(&t_Bits, u_TimeWidth, TRACK_WIDTH_BITS);
+  v_Put(&t_Bits, p_Fixes[0].u_Date, TRACK_DATE_BITS);
+  v_Put(&t_Bits, u_Seconds(p_Fixes[0].u_Date, p_Fixes[0].u_Time) % TRACK_SECONDS_PER_DAY, TRACK_TIME_BITS);
+  v_Put(&t_Bits, (uint32_t)(i_ToUnits(p_Fixes[0].i_Latitude) + TRACK_LATITUDE_OFFSET), TRACK_LATITUDE_BITS);
+  v_Put(&t_Bits, (uint32_t)(i_ToUnits(p_Fixes[0].i_Longitude) + TRACK_LONGITUDE_OFFSET), TRACK_LONGITUDE_BITS);
+  for (uint8_t u_Cnt = 1u; u_Cnt <= u_Deltas; u_Cnt++)
+  {
+    const t_MSGM_Fix *p_Newer = &p_Fixes[u_Cnt - 1u];
+    const t_MSGM_Fix *p_Older = &p_Fixes[u_Cnt];
+
+    v_Put(&t_Bits, u_Seconds(p_Newer -> u_Date, p_Newer -> u_Time) - u_Seconds(p_Older -> u_Date, p_Older -> u_Time),
+          u_TimeWidth);
+    v_Put(&t_Bits, (uint32_t)(i_ToUnits(p_Older -> i_Latitude) - i_ToUnits(p_Newer -> i_Latitude)), u_DeltaWidth);
+    v_Put(&t_Bits, (uint32_t)(i_ToUnits(p_Older -> i_Longitude) - i_ToUnits(p_Newer -> i_Longitude)), u_DeltaWidth);
+  }
+  if (t_Bits.u_Bits != 0u)
+  {
+    v_Put(&t_Bits, 0u, (uint8_t)(TRACK_DIGIT_BITS - t_Bits.u_Bits));   // Last character is filled with 0 bits
+  }
+  p_Text[t_Bits.u_Index] = '\0';
+  return t_Bits.u_Index;
+}
+
+uint8_t TRACK_u_Encode(uint8_t *p_Text, uint16_t u_Size)
+{
+  uint8_t u_Count = 1u;
+
+  // Staleness belongs to the record, so no lock is needed to read both
+  if (MSGM_b_ReadFix(MSGM_FIX_OWN, &TRACK_a_Fixes[0]) != b_TRUE)
+  {
+    return 0u;
+  }
+
+  for (uint16_t u_Age = 0u; (u_Count < TRACK_MAX_FIXES) && (FIXLOG_b_Get(u_Age, &TRACK_t_Record) == b_TRUE); u_Age++)
+  {
+    const t_MSGM_Fix *p_Newer = &TRACK_a_Fixes[u_Count - 1u];
+    t_MSGM_Fix       *p_Fix   = &TRACK_a_Fixes[u_Count];
+
+    *p_Fix = TRACK_t_Record.t_Fix;
+    // Latest record is usually the own fix itself
+    if (((p_Fix -> u_Date == 0u) == (p_Newer -> u_Date == 0u)) &&
+        (u_Seconds(p_Fix -> u_Date, p_Fix -> u_Time) >= u_Seconds(p_Newer -> u_Date, p_Newer -> u_Time)))
+    {
+      continue;
+    }
+    u_Count++;
+  }
+  return TRACK_u_Pack(TRACK_a_Fixes, u_Count, FIXLOG_b_IsStale(&TRACK_a_Fixes[0]), p_Text, u_Size);
+}
+
+e_CALCM_ParseStatus TRACK_e_Decode(const uint8_t *p_Text, uint8_t u_MaxIndex, t_MSGM_Fix *p_Fixes, uint8_t u_MaxFixes,
+                                   t_TRACK_Header *p_Header)
+{
+  t_TRACK_Bits t_Bits = {0};
+
+  if ((u_MaxIndex == 0u) || (p_Text[0] != TRACK_MARKER))
+  {
+    return CALCM_PARSE_INVALID_FORMAT;
+  }
+  t_Bits.p_Read = p_Text;
+  t_Bits.u_Index = 1u;
+  t_Bits.u_Limit = u_MaxIndex;
+  t_Bits.e_Status = CALCM_PARSE_OK;
+
+  uint8_t  u_Deltas     = (uint8_t)u_Get(&t_Bits, TRACK_COUNT_BITS);
+  boolean  b_Stale      = (u_Get(&t_Bits, TRACK_STALE_BITS) != 0u) ? b_TRUE : b_FALSE;
+  uint8_t  u_DeltaWidth = (uint8_t)u_Get(&t_Bits, TRACK_WIDTH_BITS);
+  uint8_t  u_TimeWidth  = (uint8_t)u_Get(&t_Bits, TRACK_WIDTH_BITS);
+  uint32_t u_Date       = u_Get(&t_Bits, TRACK_DATE_BITS);
+  uint32_t u_Time       = u_Get(&t_Bits, TRACK_TIME_BITS);
+  int32_t  i_Latitude   = (int32_t)u_Get(&t_Bits, TRACK_LATITUDE_BITS) - TRACK_LATITUDE_OFFSET;
+  int32_t  i_Longitude  = (int32_t)u_Get(&t_Bits, TRACK_LONGITUDE_BITS) - TRACK_LONGITUDE_OFFSET;
+  uint32_t u_Day        = u_Date / 10000u;
+  uint32_t u_Month      = (u_Date / 100u) % 100u;
+  boolean  b_Dated      = (u_Date != 0u) ? b_TRUE : b_FALSE;
+
+  if (t_Bits.e_Status != CALCM_PARSE_OK)
+  {
+    return t_Bits.e_Status;
+  }
+  if (((b_Dated == b_TRUE) && ((u_Day == 0u) || (u_Day > 31u) || (u_Month == 0u) || (u_Month > 12u))) ||
+      (u_Time >= TRACK_SECONDS_PER_DAY))
+  {
+    return CALCM_PARSE_OUT_OF_RANGE;
+  }
+  // Seconds of the day are turned into hhmmss so both fields go through the same conversion
+  uint32_t u_Elapsed = u_Seconds(u_Date, ((u_Time / 3600u) * 10000u) + (((u_Time / 60u) % 60u) * 100u) + (u_Time % 60u));
+
+  for (uint8_t u_Cnt = 0u; u_Cnt <= u_Deltas; u_Cnt++)
+  {
+    if (u_Cnt != 0u)
+    {
+      uint32_t u_Delta = u_Get(&t_Bits, u_TimeWidth);
+
+      i_Latitude += i_GetSigned(&t_Bits, u_DeltaWidth);
+      i_Longitude += i_GetSigned(&t_Bits, u_DeltaWidth);
+      if (t_Bits.e_Status != CALCM_PARSE_OK)
+      {
+        return t_Bits.e_Status;
+      }
+      if (u_Delta > u_Elapsed)
+      {
+        return CALCM_PARSE_OUT_OF_RANGE;
+      }
+      u_Elapsed -= u_Delta;
+    }
+    if ((i_Latitude > TRACK_LATITUDE_OFFSET) || (i_Latitude < -TRACK_LATITUDE_OFFSET) ||
+        (i_Longitude > TRACK_LONGITUDE_OFFSET) || (i_Longitude < -TRACK_LONGITUDE_OFFSET))
+    {
+      return CALCM_PARSE_OUT_OF_RANGE;
+    }
+    if (u_Cnt < u_MaxFixes)
+    {
+      t_MSGM_Fix *p_Fix = &p_Fixes[u_Cnt];
+
+      p_Fix -> i_Latitude = i_Latitude * TRACK_UNIT_MICRODEGREES;
+      p_Fix -> i_Longitude = i_Longitude * TRACK_UNIT_MICRODEGREES;
+      v_SetDateTime(p_Fix, u_Elapsed, b_Dated);
+      p_Fix -> u_Hdop = 0u;
+      p_Fix -> u_Quality = 0u;
+      p_Fix -> u_Satellites = 0u;
+      p_Fix -> u_Sequence = 0u;
+    }
+  }
+
+  // Track ends with the fill bits of the last character and the text ends with it
+  if ((t_Bits.u_Value != 0u) ||
+      ((t_Bits.u_Index < t_Bits.u_Limit) && (p_Text[t_Bits.u_Index] != '\0')))
+  {
+    return CALCM_PARSE_INVALID_FORMAT;
+  }
+  p_Header -> u_Count = (uint8_t)(u_Deltas + 1u);
+  p_Header -> b_Stale = b_Stale;
+  return CALCM_PARSE_OK;
+}
@@ -0,0 +1,139 @@
+/// @file TRACK.h
+/// @brief Header file used for packing a track of fixes into the text of one SMS and unpacking it
+/// @author Aleksandra Petrovic
+///
+/// The payload starts with TRACK_MARKER, which a position in "ddmm.mmmm,N,dddmm.mmmm,E" format never does. It holds
+/// the newest fix as absolute values and up to TRACK_MAX_FIXES - 1 older fixes as deltas to the fix before them. The
+/// deltas are written with the smallest width which fits all of them, so a slowly moving device gets the whole track
+/// into one SMS. Fields are packed into a bit stream which is written six bits per character with A-Z, a-z, 0-9,
+/// '+' and '/'. Every one of them is a single septet of the GSM 7-bit default alphabet, the characters base-91 adds
+/// are not in it or take two septets.
+///
+/// Bit stream, most significant bit first:
+///   count of deltas (4), stale (1), width of a coordinate delta W (5), width of a time delta T (5),
+///   date ddmmyy (19), seconds of the day (17), latitude + 90 degrees (25), longitude + 180 degrees (26),
+///   then for each delta: seconds to the older fix (T), latitude delta (W, signed), longitude delta (W, signed).
+/// Coordinates are in 1e-5 degrees, unused bits of the last character are 0.
+
+#ifndef TRACK_H_
+#define TRACK_H_
+
+#include <stdint.h>
+#include "MSGM.h"
+#include "CALCM.h"
+
+/// First character of a packed track
+#define TRACK_MARKER ('#')
+/// Number of fixes in a packed track, the absolute one and its deltas
+#define TRACK_MAX_FIXES (16u)
+
+/// This structure is used for the data of a packed track which is not a fix
+typedef struct
+{
+  uint8_t u_Count;                            ///< Number of fixes in the track
+  boolean b_Stale;                            ///< Newest fix was restored from the fix log and no new one arrived since
+} t_TRACK_Header;
+
+/// This structure is used for the bit stream of a packed track while it is written or read
+typedef struct
+{
+  uint8_t            *p_Write;                ///< Text written by v_Put, NULL while reading
+  const uint8_t      *p_Read;                 ///< Text read by u_Get, NULL while writing
+  uint8_t             u_Index;                ///< Position of the next character
+  uint8_t             u_Limit;                ///< Position at which reading stops
+  uint8_t             u_Bits;                 ///< Number of bits held in u_Value
+  uint64_t            u_Value;                ///< Bits which are not written or read yet
+  e_CALCM_ParseStatus e_Status;               ///< First error found while reading
+} t_TRACK_Bits;
+
+/// @brief Function used for packing fixes into the text of one SMS
+///
+/// @pre Fixes are ordered from the newest to the oldest
+/// @post p_Text holds the packed track followed by a NULL character
+/// @param const t_MSGM_Fix *p_Fixes, uint8_t u_Count number of fixes, boolean b_Stale,
+///        uint8_t *p_Text, uint16_t u_Size size of p_Text including the NULL character
+///
+/// @return uint8_t number of characters written, 0 when there is no fix or p_Text is too small
+///
+/// @globals None
+///
+/// @InOutCorelation Widths grow with each older fix which is added. Fixes are added while the track fits into
+///                  u_Size and TRACK_SMS_LENGTH, a fix which is not older than the one before it ends the track.
+/// @callsequence
+///   @startuml "TRACK_u_Pack.png"
+///     title "Sequence diagram for function TRACK_u_Pack"
+///     -> TRACK: TRACK_u_Pack(...)
+///     TRACK++
+///       loop for each older fix while the track fits
+///         rnote over TRACK: Widths of its deltas are taken into W and T.
+///       end
+///       TRACK -> TRACK: v_Put(...) for the header and the absolute fix
+///       loop for each delta
+///         TRACK -> TRACK: v_Put(...)
+///       end
+///     <- TRACK:// Returns the number of characters//
+///     TRACK--
+///   @enduml
+uint8_t TRACK_u_Pack(const t_MSGM_Fix *p_Fixes, uint8_t u_Count, boolean b_Stale, uint8_t *p_Text, uint16_t u_Size);
+
+/// @brief Function used for packing the own fix and the logged fixes before it
+///
+/// @pre Called from one task only
+/// @post p_Text holds the packed track followed by a NULL character
+/// @param uint8_t *p_Text, uint16_t u_Size size of p_Text including the NULL character
+///
+/// @return uint8_t number of characters written, 0 when there is no fix
+///
+/// @globals TRACK_a_Fixes, TRACK_t_Record
+///
+/// @InOutCorelation The own fix is read without a lock and is stale when it is the record restored at start up, so
+///                  the encoder never delays a new fix. Logged fixes which are not older than the fix before them are
+///                  skipped.
+/// @callsequence
+///   @startuml "TRACK_u_Encode.png"
+///     title "Sequence diagram for function TRACK_u_Encode"
+///     -> TRACK: TRACK_u_Encode(...)
+///     TRACK++
+///       TRACK -> MSGM: MSGM_b_ReadFix(MSGM_FIX_OWN, ...)
+///       loop while there are logged fixes and fewer than TRACK_MAX_FIXES
+///         TRACK -> FIXLOG: FIXLOG_b_Get(u_Age, ...)
+///       end
+///       TRACK -> FIXLOG: FIXLOG_b_IsStale(...)
+///       TRACK -> TRACK: TRACK_u_Pack(...)
+///     <- TRACK:// Returns the number of characters//
+///     TRACK--
+///   @enduml
+uint8_t TRACK_u_Encode(uint8_t *p_Text, uint16_t u_Size);
+
+/// @brief Function used for unpacking a track
+///
+/// @pre p_Text starts with TRACK_MARKER
+/// @post p_Fixes holds up to u_MaxFixes fixes from the newest to the oldest, they are valid only when
+///       CALCM_PARSE_OK is returned
+/// @param const uint8_t *p_Text, uint8_t u_MaxIndex position at which reading stops,
+///        t_MSGM_Fix *p_Fixes, uint8_t u_MaxFixes, t_TRACK_Header *p_Header
+///
+/// @return e_CALCM_ParseStatus status of unpacking
+///
+/// @globals None
+///
+/// @InOutCorelation The whole track is checked even when fewer fixes are stored. A character outside of the alphabet,
+///                  a text which ends early or goes on after the last delta and a fix outside of the valid ranges
+///                  are rejected.
+/// @callsequence
+///   @startuml "TRACK_e_Decode.png"
+///     title "Sequence diagram for function TRACK_e_Decode"
+///     -> TRACK: TRACK_e_Decode(...)
+///     TRACK++
+///       TRACK -> TRACK: u_Get(...) for the header and the absolute fix
+///       loop for each delta
+///         TRACK -> TRACK: u_Get(...)
+///         rnote over TRACK: Delta is applied and the fix is checked.
+///       end
+///     <- TRACK:// Returns e_CALCM_ParseStatus//
+///     TRACK--
+///   @enduml
+e_CALCM_ParseStatus TRACK_e_Decode(const uint8_t *p_Text, uint8_t u_MaxIndex, t_MSGM_Fix *p_Fixes, uint8_t u_MaxFixes,
+                                   t_TRACK_Header *p_Header);
+
+#endif /* TRACK_H_ */
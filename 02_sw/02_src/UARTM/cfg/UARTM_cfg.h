@@ -43,6 +43,10 @@
 #define BRR_BAUD_RATE_USART2 (15u << 0u)
 /// Configure PCLK1 Frequency at 45 MHz
 #define BRR_PCLK1_USART2 (292u << 4u)
+/// Frequency of PCLK1 which clocks USART2 and USART3
+#define UARTM_PCLK1_HZ (45000000u)
+/// Baud rate set by UARTM_v_Uart2Config, the rate at which the GPS module starts
+#define UARTM_GPS_DEFAULT_BAUD_RATE (9600u)
 /// Register address used for reset and clock control
 #define UARTM_RCC_GROUP (RCC)
 /// Register address used for toggling pin output
@@ -81,6 +85,57 @@
 #define CR1_RXNEIE_ENABLE (1u << 5u)
 /// Enable Transmit Interrupt
 #define CR1_TXEIE_ENABLE (1u << 7u)
+/// Enable Transmission Complete Interrupt
+#define CR1_TCIE_ENABLE (1u << 6u)
+/// Length of the transmit ring of each UART, one byte is always left free
+#define UARTM_TX_BUFFER_LENGTH (256u)
+/// Free bytes in a transmit ring which wake a task waiting for room
+#define UARTM_TX_WAKE_FREE (UARTM_TX_BUFFER_LENGTH / 4u)
+/// Longest time in ms a task waits for the transmit interrupt before it checks the ring again
+#define UARTM_TX_WAIT_MS (10u)
+/// Longest wait for a received character in microseconds
+#define UARTM_GETCHAR_TIMEOUT_US (300u)
+/// Forwarding of GPS data selected at start up, see e_UARTM_Forward
+#define UARTM_GPS_FORWARD_DEFAULT (UARTM_FORWARD_OFF)
 /// Turn on LED on a pin PA5
 #define ODR_LED_ON (1u << 14u)
+
+/// Receive mode in which every received byte raises an RXNE interrupt
+#define UARTM_RX_MODE_INTERRUPT (0u)
+/// Receive mode in which DMA fills a circular buffer and interrupts only on IDLE line, half and full transfer
+#define UARTM_RX_MODE_DMA (1u)
+#ifndef UARTM_RX_MODE
+/// Selected receive mode for USART2 and USART3, the host build can select either mode on the compiler command line
+#define UARTM_RX_MODE (UARTM_RX_MODE_DMA)
+#endif
+/// Length of the circular DMA receive buffer of each UART
+#define UARTM_DMA_RX_BUFFER_LENGTH (256u)
+/// NVIC priority of the receive interrupts, numerically not below configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY because they notify tasks
+#define UARTM_RX_IRQ_PRIORITY (6u)
+/// Enable DMA1 CLOCK
+#define AHB1ENR_DMA1_CLOCK (1u << 21u)
+/// Enable IDLE line interrupt
+#define CR1_IDLEIE_ENABLE (1u << 4u)
+/// Enable DMA for reception
+#define CR3_DMAR_ENABLE (1u << 6u)
+/// DMA stream enable
+#define DMA_SXCR_EN (1u << 0u)
+/// DMA direct mode error interrupt enable
+#define DMA_SXCR_DMEIE (1u << 1u)
+/// DMA transfer error interrupt enable
+#define DMA_SXCR_TEIE (1u << 2u)
+/// DMA half transfer interrupt enable
+#define DMA_SXCR_HTIE (1u << 3u)
+/// DMA transfer complete interrupt enable
+#define DMA_SXCR_TCIE (1u << 4u)
+/// DMA circular mode
+#define DMA_SXCR_CIRC (1u << 8u)
+/// DMA memory increment mode
+#define DMA_SXCR_MINC (1u << 10u)
+/// DMA channel 4 selected (USART2_RX on stream 5, USART3_RX on stream 1)
+#define DMA_SXCR_CHSEL_4 (4u << 25u)
+/// Flags of stream 1 in LISR/LIFCR and of stream 5 in HISR/HIFCR (FEIF, DMEIF, TEIF, HTIF, TCIF)
+#define DMA_STREAM_1_5_FLAGS (0x3Du << 6u)
+/// Error flags of stream 1 in LISR and of stream 5 in HISR (FEIF, DMEIF, TEIF), the stream has to be restarted
+#define DMA_STREAM_1_5_ERRORS (0x0Du << 6u)
 #endif /* UARTM_CFG_H_ */
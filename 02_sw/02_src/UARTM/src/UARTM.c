@@ -4,22 +4,676 @@
 
 #include "UARTM.h"
 #include "MSGM.h"
+#include "cmsis_os.h"
+#include "semphr.h"
 #include <stdio.h>
 #include <string.h>
-#include "tim.h"
+#include "TIMEB.h"
+#include "MONITOR.h"
 
 uint16_t       UARTM_u_index                  = 0u;
 static uint8_t UARTM_a_array[TEMP_BUFFER]     = {0u};
 uint8_t        UARTM_a_provera[BUFFER_LENGTH] = {0u};
 uint8_t        UARTM_u_data[BUFFER_LENGTH]    = {0u};
-static uint32_t       start_address;
-static uint32_t       max_delay = 300u;
-static uint32_t       max_time = 65536u;
-static uint32_t       delayed_value;
-static uint32_t       delayed_overflow_value;
+
+/// Structure used to describe one interrupt driven transmit channel
+typedef struct {
+  uint8_t            a_Data[UARTM_TX_BUFFER_LENGTH]; ///< Bytes waiting for transmission
+  volatile uint16_t  u_Head;                         ///< Index where the next byte is queued
+  volatile uint16_t  u_Tail;                         ///< Index of the next byte the interrupt sends
+  uint32_t           u_StatusRegister;               ///< Address of the UART status register
+  uint32_t           u_DataRegister;                 ///< Address of the UART data register
+  uint32_t           u_ControlRegister;              ///< Address of the UART control register 1
+  t_UARTM_TxCallback p_Callback;                     ///< Called when the ring is empty and the last byte is sent
+  SemaphoreHandle_t  t_Event;                        ///< Given by the interrupt to a task waiting for room or completion
+  volatile boolean   b_Waiting;                      ///< b_TRUE while a task waits for t_Event
+} t_UARTM_Tx;
+
+/// Transmit ring of USART2 (debug)
+static t_UARTM_Tx UARTM_t_Usart2Tx = {{0u}, 0u, 0u, USART2_SR, USART2_DR, USART2_CR1, NULL, NULL, b_FALSE};
+/// Transmit ring of USART3 (SIM800L)
+static t_UARTM_Tx UARTM_t_Usart3Tx = {{0u}, 0u, 0u, USART3_SR, USART3_DR, USART3_CR1, NULL, NULL, b_FALSE};
+/// Memory of the transmit event of USART2
+static StaticSemaphore_t UARTM_t_Usart2TxEventBuffer;
+/// Memory of the transmit event of USART3
+static StaticSemaphore_t UARTM_t_Usart3TxEventBuffer;
+/// Destination of the data received from the GPS
+static volatile e_UARTM_Forward UARTM_e_GpsForward = UARTM_GPS_FORWARD_DEFAULT;
+/// Number of GPS bytes dropped because the transmit ring was full
+static volatile uint32_t UARTM_u_ForwardDropped = 0u;
+/// Number of receive DMA streams restarted after a transfer, FIFO or direct mode error
+static volatile uint32_t UARTM_u_DmaRestarts = 0u;
+
+/// @brief Function used to queue as many bytes as fit into the transmit ring
+///
+/// @pre UART must be configured, caller must be in a critical section because tasks and the GPS receive interrupt
+///      can queue into the same ring
+/// @post Queued bytes are sent by the UART interrupt
+/// @param t_UARTM_Tx *p_Tx, const uint8_t *p_Data, uint16_t u_Length
+///
+/// @return uint16_t number of queued bytes
+///
+/// @globals None
+///
+/// @InOutCorelation Function copies the bytes in at most two blocks, moves the head and enables the TXE interrupt.
+/// @callsequence
+///   @startuml "u_TxWrite.png"
+///     title "Sequence diagram for function u_TxWrite"
+///     -> UARTM: u_TxWrite(t_UARTM_Tx *p_Tx, const uint8_t *p_Data, uint16_t u_Length)
+///     UARTM++
+///       rnote over UARTM: Free space is copied, head is moved and TXE interrupt is enabled.
+///     <- UARTM: Returns number of queued bytes
+///     UARTM--
+///   @enduml
+
+static uint16_t u_TxWrite(t_UARTM_Tx *p_Tx, const uint8_t *p_Data, uint16_t u_Length);
+
+static uint16_t u_TxWrite(t_UARTM_Tx *p_Tx, const uint8_t *p_Data, uint16_t u_Length)
+{
+  uint16_t u_Head  = p_Tx -> u_Head;
+  uint16_t u_Free  = (uint16_t)((p_Tx -> u_Tail + UARTM_TX_BUFFER_LENGTH - u_Head - 1u) % UARTM_TX_BUFFER_LENGTH);
+  uint16_t u_Count = (u_Length < u_Free) ? u_Length : u_Free;
+  uint16_t u_First = (uint16_t)(UARTM_TX_BUFFER_LENGTH - u_Head);
+
+  if (u_Count == 0u)
+  {
+    return 0u;
+  }
+  if (u_First > u_Count)
+  {
+    u_First = u_Count;
+  }
+  memcpy(&p_Tx -> a_Data[u_Head], p_Data, u_First);
+  memcpy(p_Tx -> a_Data, &p_Data[u_First], u_Count - u_First);
+  p_Tx -> u_Head = (uint16_t)((u_Head + u_Count) % UARTM_TX_BUFFER_LENGTH);
+  REG32(p_Tx -> u_ControlRegister) &= ~CR1_TCIE_ENABLE;            // Completion is reported after the new bytes
+  REG32(p_Tx -> u_ControlRegister) |= CR1_TXEIE_ENABLE;            // Interrupt when the data register is empty
+  return u_Count;
+}
+
+/// @brief Function used to send one queued byte without the interrupt
+///
+/// @pre Transmit ring must be full
+/// @post One byte is moved to the data register if it was empty
+/// @param t_UARTM_Tx *p_Tx
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Before the scheduler starts the UART interrupt is masked by FreeRTOS, so the caller moves the
+///                  bytes itself. Critical section keeps the interrupt from sending the same byte.
+/// @callsequence
+///   @startuml "v_TxPoll.png"
+///     title "Sequence diagram for function v_TxPoll"
+///     -> UARTM: v_TxPoll(t_UARTM_Tx *p_Tx)
+///     UARTM++
+///       opt if TXE is set and the ring is not empty
+///         rnote over UARTM: Byte at the tail is written to the data register.
+///       end
+///     <- UARTM
+///     UARTM--
+///   @enduml
+
+static void v_TxPoll(t_UARTM_Tx *p_Tx);
+
+static void v_TxPoll(t_UARTM_Tx *p_Tx)
+{
+  taskENTER_CRITICAL();
+  if ((REG32(p_Tx -> u_StatusRegister) & USART_SR_TXE) && (p_Tx -> u_Tail != p_Tx -> u_Head))
+  {
+    REG32(p_Tx -> u_DataRegister) = p_Tx -> a_Data[p_Tx -> u_Tail];
+    p_Tx -> u_Tail = (uint16_t)((p_Tx -> u_Tail + 1u) % UARTM_TX_BUFFER_LENGTH);
+  }
+  taskEXIT_CRITICAL();
+}
+
+/// @brief Function used to count the bytes which are not sent yet
+///
+/// @pre None
+/// @post None
+/// @param const t_UARTM_Tx *p_Tx
+///
+/// @return uint16_t bytes in the ring, 1 more while the last one is still in the shift register
+///
+/// @globals None
+///
+/// @InOutCorelation TXE or TC interrupt stays enabled until the last byte has left the shift register.
+/// @callsequence
+///   @startuml "u_TxPending.png"
+///     title "Sequence diagram for function u_TxPending"
+///     -> UARTM: u_TxPending(const t_UARTM_Tx *p_Tx)
+///     UARTM++
+///     <- UARTM: Returns number of bytes
+///     UARTM--
+///   @enduml
+
+static uint16_t u_TxPending(const t_UARTM_Tx *p_Tx);
+
+static uint16_t u_TxPending(const t_UARTM_Tx *p_Tx)
+{
+  uint16_t u_Queued = (uint16_t)((p_Tx -> u_Head + UARTM_TX_BUFFER_LENGTH - p_Tx -> u_Tail) % UARTM_TX_BUFFER_LENGTH);
+
+  if ((u_Queued == 0u) && ((REG32(p_Tx -> u_ControlRegister) & (CR1_TXEIE_ENABLE | CR1_TCIE_ENABLE)) != 0u))
+  {
+    u_Queued = 1u;
+  }
+  return u_Queued;
+}
+
+/// @brief Function used to wait for an event of the transmit interrupt
+///
+/// @pre Scheduler must be running, called from a task
+/// @post None
+/// @param t_UARTM_Tx *p_Tx, TickType_t u_Ticks longest wait
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Caller marks itself as waiting inside the critical section in which it found the condition
+///                  false, so the interrupt can not miss it. The interrupt gives t_Event when room is freed or the
+///                  last byte is sent, the caller checks its condition again either way.
+/// @callsequence
+///   @startuml "v_TxWait.png"
+///     title "Sequence diagram for function v_TxWait"
+///     -> UARTM: v_TxWait(t_UARTM_Tx *p_Tx, TickType_t u_Ticks)
+///     UARTM++
+///       UARTM -> FreeRTOS: xSemaphoreTake(p_Tx -> t_Event, u_Ticks)
+///     <- UARTM
+///     UARTM--
+///   @enduml
+
+static void v_TxWait(t_UARTM_Tx *p_Tx, TickType_t u_Ticks);
+
+static void v_TxWait(t_UARTM_Tx *p_Tx, TickType_t u_Ticks)
+{
+  (void)xSemaphoreTake(p_Tx -> t_Event, u_Ticks);                  // Timeout only bounds a missed wake up
+}
+
+/// @brief Function used to wake the task waiting for the transmit interrupt
+///
+/// @pre Called from the UART interrupt
+/// @post None
+/// @param t_UARTM_Tx *p_Tx
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation t_Event is given only while a task waits, so no stale event piles up.
+/// @callsequence
+///   @startuml "v_TxWakeFromISR.png"
+///     title "Sequence diagram for function v_TxWakeFromISR"
+///     -> UARTM: v_TxWakeFromISR(t_UARTM_Tx *p_Tx)
+///     UARTM++
+///       opt if a task waits
+///         UARTM -> FreeRTOS: xSemaphoreGiveFromISR(p_Tx -> t_Event, ...)
+///         UARTM -> FreeRTOS: portYIELD_FROM_ISR(...)
+///       end
+///     <- UARTM
+///     UARTM--
+///   @enduml
+
+static void v_TxWakeFromISR(t_UARTM_Tx *p_Tx);
+
+static void v_TxWakeFromISR(t_UARTM_Tx *p_Tx)
+{
+  BaseType_t x_HigherPriorityTaskWoken = pdFALSE;
+
+  if (p_Tx -> b_Waiting == b_TRUE)
+  {
+    p_Tx -> b_Waiting = b_FALSE;
+    (void)xSemaphoreGiveFromISR(p_Tx -> t_Event, &x_HigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(x_HigherPriorityTaskWoken);                 // Switch to the waiting task as soon as the interrupt returns
+  }
+}
+
+/// @brief Function used to queue a block of bytes for transmission
+///
+/// @pre UART must be configured
+/// @post All bytes are in the transmit ring
+/// @param t_UARTM_Tx *p_Tx, const uint8_t *p_Data, uint16_t u_Length
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Function returns as soon as the last byte is queued. While the ring is full a task sleeps until
+///                  the interrupt has freed UARTM_TX_WAKE_FREE bytes, before the scheduler starts the caller moves the
+///                  bytes itself because the UART interrupt is masked.
+/// @callsequence
+///   @startuml "v_TxSend.png"
+///     title "Sequence diagram for function v_TxSend"
+///     -> UARTM: v_TxSend(t_UARTM_Tx *p_Tx, const uint8_t *p_Data, uint16_t u_Length)
+///     UARTM++
+///     loop //until all bytes are queued//
+///       UARTM -> FreeRTOS: taskENTER_CRITICAL()
+///       UARTM -> UARTM: u_TxWrite(p_Tx, p_Data, u_Length)
+///       UARTM -> FreeRTOS: taskEXIT_CRITICAL()
+///       opt if nothing was queued
+///         alt if the scheduler is running
+///           UARTM -> UARTM: v_TxWait(p_Tx, ...)
+///         else else
+///           UARTM -> UARTM: v_TxPoll(p_Tx)
+///         end
+///       end
+///     end
+///     <- UARTM
+///     UARTM--
+///   @enduml
+
+static void v_TxSend(t_UARTM_Tx *p_Tx, const uint8_t *p_Data, uint16_t u_Length);
+
+static void v_TxSend(t_UARTM_Tx *p_Tx, const uint8_t *p_Data, uint16_t u_Length)
+{
+  boolean b_Block = ((p_Tx -> t_Event != NULL) && (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)) ? b_TRUE : b_FALSE;
+
+  while (u_Length > 0u)
+  {
+    uint16_t u_Count;
+
+    taskENTER_CRITICAL();
+    u_Count = u_TxWrite(p_Tx, p_Data, u_Length);
+    if ((u_Count == 0u) && (b_Block == b_TRUE))
+    {
+      p_Tx -> b_Waiting = b_TRUE;
+    }
+    taskEXIT_CRITICAL();
+    if (u_Count == 0u)
+    {
+      if (b_Block == b_TRUE)
+      {
+        v_TxWait(p_Tx, pdMS_TO_TICKS(UARTM_TX_WAIT_MS));           // Ring is full, sleep until the interrupt made room
+      }
+      else
+      {
+        v_TxPoll(p_Tx);                                            // Interrupt is masked, make room
+      }
+    }
+    p_Data   += u_Count;
+    u_Length -= u_Count;
+  }
+}
+
+/// @brief Function used to wait until the queued bytes are sent
+///
+/// @pre UART must be configured, called from a task
+/// @post None
+/// @param t_UARTM_Tx *p_Tx, uint32_t u_TimeoutMs
+///
+/// @return uint16_t number of bytes not sent when the timeout expired, 0 when all are sent
+///
+/// @globals None
+///
+/// @InOutCorelation Task sleeps on t_Event, which the interrupt gives when transmission of the last byte completes.
+/// @callsequence
+///   @startuml "u_TxWaitSent.png"
+///     title "Sequence diagram for function u_TxWaitSent"
+///     -> UARTM: u_TxWaitSent(t_UARTM_Tx *p_Tx, uint32_t u_TimeoutMs)
+///     UARTM++
+///       loop while bytes are pending and the timeout did not expire
+///         UARTM -> UARTM: u_TxPending(p_Tx)
+///         UARTM -> UARTM: v_TxWait(p_Tx, ...)
+///       end
+///     <- UARTM: Returns number of bytes not sent
+///     UARTM--
+///   @enduml
+
+static uint16_t u_TxWaitSent(t_UARTM_Tx *p_Tx, uint32_t u_TimeoutMs);
+
+static uint16_t u_TxWaitSent(t_UARTM_Tx *p_Tx, uint32_t u_TimeoutMs)
+{
+  TickType_t u_Ticks = pdMS_TO_TICKS(u_TimeoutMs);
+  TimeOut_t t_TimeOut;
+  uint16_t u_Pending = 0u;
+
+  if ((p_Tx -> t_Event == NULL) || (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING))
+  {
+    return u_TxPending(p_Tx);
+  }
+  vTaskSetTimeOutState(&t_TimeOut);
+  for (;;)
+  {
+    taskENTER_CRITICAL();
+    u_Pending = u_TxPending(p_Tx);
+    if (u_Pending != 0u)
+    {
+      p_Tx -> b_Waiting = b_TRUE;
+    }
+    taskEXIT_CRITICAL();
+    if ((u_Pending == 0u) || (xTaskCheckForTimeOut(&t_TimeOut, &u_Ticks) == pdTRUE))
+    {
+      return u_Pending;
+    }
+    v_TxWait(p_Tx, u_Ticks);
+  }
+}
+
+/// @brief Function used to serve the transmit part of a UART interrupt
+///
+/// @pre Called from the UART interrupt
+/// @post Next byte is in the data register, or completion is reported
+/// @param t_UARTM_Tx *p_Tx
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation When the data register is empty the next byte is written. After the last one the TXE interrupt is
+///                  replaced by transmission complete, which calls the callback. A waiting task is woken when
+///                  UARTM_TX_WAKE_FREE bytes are free or the last byte is sent.
+/// @callsequence
+///   @startuml "v_TxInterrupt.png"
+///     title "Sequence diagram for function v_TxInterrupt"
+///     -> UARTM: v_TxInterrupt(t_UARTM_Tx *p_Tx)
+///     UARTM++
+///       opt if TXE interrupt is enabled and TXE is set
+///         rnote over UARTM: Next byte is sent, or TXE interrupt is swapped for TC interrupt.
+///         opt if UARTM_TX_WAKE_FREE bytes are free
+///           UARTM -> UARTM: v_TxWakeFromISR(p_Tx)
+///         end
+///       end
+///       opt if TC interrupt is enabled and TC is set
+///         UARTM -> UARTM: p_Tx -> p_Callback()
+///         UARTM -> UARTM: v_TxWakeFromISR(p_Tx)
+///       end
+///     <- UARTM
+///     UARTM--
+///   @enduml
+
+static void v_TxInterrupt(t_UARTM_Tx *p_Tx);
+
+static void v_TxInterrupt(t_UARTM_Tx *p_Tx)
+{
+  uint32_t u_Status  = REG32(p_Tx -> u_StatusRegister);
+  uint32_t u_Control = REG32(p_Tx -> u_ControlRegister);
+
+  if ((u_Control & CR1_TXEIE_ENABLE) && (u_Status & USART_SR_TXE))
+  {
+    if (p_Tx -> u_Tail != p_Tx -> u_Head)
+    {
+      REG32(p_Tx -> u_DataRegister) = p_Tx -> a_Data[p_Tx -> u_Tail];
+      p_Tx -> u_Tail = (uint16_t)((p_Tx -> u_Tail + 1u) % UARTM_TX_BUFFER_LENGTH);
+      if ((UARTM_TX_BUFFER_LENGTH - u_TxPending(p_Tx)) >= UARTM_TX_WAKE_FREE)
+      {
+        v_TxWakeFromISR(p_Tx);                                     // Sender gets room for a block, not for every byte
+      }
+    }
+    else
+    {
+      REG32(p_Tx -> u_ControlRegister) = (u_Control & ~CR1_TXEIE_ENABLE) | CR1_TCIE_ENABLE;
+    }
+  }
+  else if ((u_Control & CR1_TCIE_ENABLE) && (u_Status & USART_SR_TC))
+  {
+    REG32(p_Tx -> u_ControlRegister) = u_Control & ~CR1_TCIE_ENABLE;
+    if (p_Tx -> p_Callback != NULL)
+    {
+      p_Tx -> p_Callback();
+    }
+    v_TxWakeFromISR(p_Tx);
+  }
+}
+
+/// @brief Function used to forward received GPS data to the selected port
+///
+/// @pre Called from a receive interrupt of USART2
+/// @post Data is queued for transmission or counted as dropped
+/// @param const uint8_t *p_Data, uint16_t u_Length
+///
+/// @return None
+///
+/// @globals UARTM_e_GpsForward, UARTM_u_ForwardDropped
+///
+/// @InOutCorelation Function queues the data in the transmit ring of the selected port without waiting. Bytes which
+///                  do not fit are dropped.
+/// @callsequence
+///   @startuml "v_ForwardFromISR.png"
+///     title "Sequence diagram for function v_ForwardFromISR"
+///     -> UARTM: v_ForwardFromISR(const uint8_t *p_Data, uint16_t u_Length)
+///     UARTM++
+///       opt if forwarding is on
+///         UARTM -> FreeRTOS: taskENTER_CRITICAL_FROM_ISR()
+///         UARTM -> UARTM: u_TxWrite(...)
+///         UARTM -> FreeRTOS: taskEXIT_CRITICAL_FROM_ISR(...)
+///       end
+///     <- UARTM
+///     UARTM--
+///   @enduml
+
+static void v_ForwardFromISR(const uint8_t *p_Data, uint16_t u_Length);
+
+static void v_ForwardFromISR(const uint8_t *p_Data, uint16_t u_Length)
+{
+  t_UARTM_Tx *p_Tx;
+  UBaseType_t u_Saved;
+
+  if (UARTM_e_GpsForward == UARTM_FORWARD_DEBUG)
+  {
+    p_Tx = &UARTM_t_Usart2Tx;
+  }
+  else if (UARTM_e_GpsForward == UARTM_FORWARD_SIM)
+  {
+    p_Tx = &UARTM_t_Usart3Tx;
+  }
+  else
+  {
+    return;
+  }
+  u_Saved = taskENTER_CRITICAL_FROM_ISR();
+  UARTM_u_ForwardDropped += (uint32_t)(u_Length - u_TxWrite(p_Tx, p_Data, u_Length));
+  taskEXIT_CRITICAL_FROM_ISR(u_Saved);
+}
+
+#if (UARTM_RX_MODE == UARTM_RX_MODE_DMA)
+/// Structure used to describe one DMA receive channel
+typedef struct {
+  uint8_t *     p_Buffer;        ///< Circular buffer the DMA stream writes into
+  uint32_t      u_StreamCR;      ///< Address of the stream configuration register
+  uint32_t      u_StreamNDTR;    ///< Address of the stream number of data register
+  uint32_t      u_StreamPAR;     ///< Address of the stream peripheral address register
+  uint32_t      u_StreamM0AR;    ///< Address of the stream memory address register
+  uint32_t      u_DataRegister;  ///< Address of the UART data register
+  uint16_t      u_LastPosition;  ///< Position in the buffer up to which the data was handed over
+  e_RingBuffers e_RingBuffer;    ///< Ring buffer which receives the data
+  boolean       b_Forward;       ///< b_TRUE if the data is also forwarded according to UARTM_e_GpsForward
+} t_UARTM_DmaRx;
+
+/// Circular buffer filled by DMA1 Stream5 from USART2
+static uint8_t UARTM_a_Usart2DmaBuffer[UARTM_DMA_RX_BUFFER_LENGTH] = {0u};
+/// Circular buffer filled by DMA1 Stream1 from USART3
+static uint8_t UARTM_a_Usart3DmaBuffer[UARTM_DMA_RX_BUFFER_LENGTH] = {0u};
+
+/// Receive channel of USART2 (GPS)
+static t_UARTM_DmaRx UARTM_t_Usart2DmaRx =
+{
+  UARTM_a_Usart2DmaBuffer, DMA1_S5CR, DMA1_S5NDTR, DMA1_S5PAR, DMA1_S5M0AR, USART2_DR, 0u, RING_BUFFER1, b_TRUE
+};
+
+/// Receive channel of USART3 (SIM800L)
+static t_UARTM_DmaRx UARTM_t_Usart3DmaRx =
+{
+  UARTM_a_Usart3DmaBuffer, DMA1_S1CR, DMA1_S1NDTR, DMA1_S1PAR, DMA1_S1M0AR, USART3_DR, 0u, RING_BUFFER2, b_FALSE
+};
+
+/// @brief Function used to configure a DMA stream for circular reception from a UART
+///
+/// @pre DMA1 clock must be enabled
+/// @post DMA stream is enabled and writes received bytes into the channel buffer
+/// @param t_UARTM_DmaRx *p_Rx
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Function sets up stream registers for peripheral to memory circular transfer.
+/// @callsequence
+///   @startuml "v_DmaRxConfigure.png"
+///     title "Sequence diagram for function v_DmaRxConfigure"
+///     -> UARTM: v_DmaRxConfigure(t_UARTM_DmaRx *p_Rx)
+///     UARTM++
+///       rnote over UARTM: Disables the stream, sets addresses, length and mode and enables it again.
+///     <- UARTM
+///     UARTM--
+///   @enduml
+
+static void v_DmaRxConfigure(t_UARTM_DmaRx *p_Rx);
+
+static void v_DmaRxConfigure(t_UARTM_DmaRx *p_Rx)
+{
+  // Stream must be disabled before it can be configured
+  REG32(p_Rx -> u_StreamCR) &= ~DMA_SXCR_EN;
+  while (REG32(p_Rx -> u_StreamCR) & DMA_SXCR_EN)
+  {
+                                                                   // Wait until the stream is really disabled
+  }
+  REG32(p_Rx -> u_StreamPAR)  = p_Rx -> u_DataRegister;            // Source is the UART data register
+  REG32(p_Rx -> u_StreamM0AR) = (uint32_t)(uintptr_t)p_Rx -> p_Buffer; // Destination is the circular buffer
+  REG32(p_Rx -> u_StreamNDTR) = UARTM_DMA_RX_BUFFER_LENGTH;        // Number of bytes until the buffer wraps
+  p_Rx -> u_LastPosition = 0u;
+
+  // Channel 4, byte to byte, memory increment, circular, peripheral to memory, HT/TC/TE/DME interrupts
+  REG32(p_Rx -> u_StreamCR) = DMA_SXCR_CHSEL_4 | DMA_SXCR_MINC | DMA_SXCR_CIRC |
+                              DMA_SXCR_HTIE | DMA_SXCR_TCIE | DMA_SXCR_TEIE | DMA_SXCR_DMEIE;
+  REG32(p_Rx -> u_StreamCR) |= DMA_SXCR_EN;                        // Enable the stream
+}
+
+/// @brief Function used to hand over newly received bytes from the DMA buffer to the ring buffer
+///
+/// @pre DMA stream must be configured
+/// @post All bytes written by DMA since the last call are stored in the ring buffer
+/// @param t_UARTM_DmaRx *p_Rx
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Function compares DMA write position with the last read position and copies the difference in blocks.
+/// @callsequence
+///   @startuml "v_DmaRxProcess.png"
+///     title "Sequence diagram for function v_DmaRxProcess"
+///     -> UARTM: v_DmaRxProcess(t_UARTM_DmaRx *p_Rx)
+///     UARTM++
+///       opt if DMA position moved forward
+///         UARTM -> UARTM: v_DmaRxBlock(...)
+///       else else DMA position wrapped around
+///         UARTM -> UARTM: v_DmaRxBlock(...) for the tail of the buffer
+///         UARTM -> UARTM: v_DmaRxBlock(...) for the head of the buffer
+///       end
+///     <- UARTM
+///     UARTM--
+///   @enduml
+
+static void v_DmaRxProcess(t_UARTM_DmaRx *p_Rx);
+
+/// @brief Function used to hand over one contiguous block of the DMA buffer
+///
+/// @pre Called from v_DmaRxProcess
+/// @post Block is in the ring buffer and forwarded if the channel is forwarded
+/// @param t_UARTM_DmaRx *p_Rx, const uint8_t *p_Data, uint16_t u_Length
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Function pushes the block to the ring buffer of the channel and forwards GPS data.
+/// @callsequence
+///   @startuml "v_DmaRxBlock.png"
+///     title "Sequence diagram for function v_DmaRxBlock"
+///     -> UARTM: v_DmaRxBlock(t_UARTM_DmaRx *p_Rx, const uint8_t *p_Data, uint16_t u_Length)
+///     UARTM++
+///       UARTM -> MSGM: MSGM_u_CircularBufferPushBlock(...)
+///       opt if channel is forwarded
+///         UARTM -> UARTM: v_ForwardFromISR(p_Data, u_Length)
+///       end
+///     <- UARTM
+///     UARTM--
+///   @enduml
+
+static void v_DmaRxBlock(t_UARTM_DmaRx *p_Rx, const uint8_t *p_Data, uint16_t u_Length);
+
+static void v_DmaRxBlock(t_UARTM_DmaRx *p_Rx, const uint8_t *p_Data, uint16_t u_Length)
+{
+  MSGM_u_CircularBufferPushBlock(p_Rx -> e_RingBuffer, p_Data, u_Length);
+  if (p_Rx -> b_Forward == b_TRUE)
+  {
+    v_ForwardFromISR(p_Data, u_Length);
+  }
+}
+
+static void v_DmaRxProcess(t_UARTM_DmaRx *p_Rx)
+{
+  // Position in the buffer where DMA will write the next byte
+  uint16_t u_Position = (uint16_t)(UARTM_DMA_RX_BUFFER_LENGTH - REG32(p_Rx -> u_StreamNDTR));
+
+  if (u_Position == UARTM_DMA_RX_BUFFER_LENGTH)
+  {
+    u_Position = 0u;                                               // NDTR has just been reloaded
+  }
+
+  if (u_Position > p_Rx -> u_LastPosition)
+  {
+    v_DmaRxBlock(p_Rx, &p_Rx -> p_Buffer[p_Rx -> u_LastPosition], (uint16_t)(u_Position - p_Rx -> u_LastPosition));
+  }
+  else if (u_Position < p_Rx -> u_LastPosition)
+  {
+    // DMA wrapped around, hand over the end of the buffer first and then its beginning
+    v_DmaRxBlock(p_Rx, &p_Rx -> p_Buffer[p_Rx -> u_LastPosition],
+                 (uint16_t)(UARTM_DMA_RX_BUFFER_LENGTH - p_Rx -> u_LastPosition));
+    if (u_Position > 0u)
+    {
+      v_DmaRxBlock(p_Rx, p_Rx -> p_Buffer, u_Position);
+    }
+  }
+  p_Rx -> u_LastPosition = u_Position;
+}
+
+/// @brief Function used to handle the flags of a DMA receive stream
+///
+/// @pre Called from the stream interrupt with the flags already cleared
+/// @post Received bytes are handed over, after an error the stream receives again from the start of its buffer
+/// @param t_UARTM_DmaRx *p_Rx, uint32_t u_Flags flags of the stream read from LISR or HISR
+///
+/// @return None
+///
+/// @globals UARTM_u_DmaRestarts
+///
+/// @InOutCorelation A transfer error clears EN of the stream, so reception would stop. Bytes written before the
+///                  error are handed over first, then the stream is configured again, which reloads NDTR, resets
+///                  the last position and sets EN. A byte waiting in DR is taken by the stream once it is enabled.
+/// @callsequence
+///   @startuml "v_DmaRxService.png"
+///     title "Sequence diagram for function v_DmaRxService"
+///     -> UARTM: v_DmaRxService(t_UARTM_DmaRx *p_Rx, uint32_t u_Flags)
+///     UARTM++
+///       UARTM -> UARTM: v_DmaRxProcess(p_Rx)
+///       opt if TEIF, FEIF or DMEIF is set
+///         UARTM -> UARTM: v_DmaRxConfigure(p_Rx)
+///       end
+///     <- UARTM
+///     UARTM--
+///   @enduml
+
+static void v_DmaRxService(t_UARTM_DmaRx *p_Rx, uint32_t u_Flags);
+
+static void v_DmaRxService(t_UARTM_DmaRx *p_Rx, uint32_t u_Flags)
+{
+  v_DmaRxProcess(p_Rx);
+  if ((u_Flags & DMA_STREAM_1_5_ERRORS) != 0u)
+  {
+    v_DmaRxConfigure(p_Rx);                                        // Reload NDTR, reset the position and set EN again
+    UARTM_u_DmaRestarts++;
+  }
+}
+#endif
 
 void UARTM_v_Uart3Config()
 {
+  if (UARTM_t_Usart3Tx.t_Event == NULL)
+  {
+    UARTM_t_Usart3Tx.t_Event = xSemaphoreCreateBinaryStatic(&UARTM_t_Usart3TxEventBuffer);
+  }
   // 1. Enable the UART CLOCK and GPIO CLOCK
   REG32(RCC_APB1ENR) |= APB1ENR_UART3_CLOCK;                       // Enable UART3 CLOCK
   REG32(RCC_AHB1ENR) |= AHB1ENR_GPIOD_CLOCK;                       // Enable GPIOD CLOCK
@@ -47,15 +701,33 @@ void UARTM_v_Uart3Config()
   REG32(USART3_CR1) |= CR1_RECEIVER_ENABLE;                        // RE=1... Enable the Receiver
   REG32(USART3_CR1) |= CR1_TRANSMITTER_ENABLE;                     // TE=1... Enable the Receiver
 
+#if (UARTM_RX_MODE == UARTM_RX_MODE_DMA)
+  // 7. Let DMA1 Stream1 receive the data and interrupt only on IDLE line
+  REG32(RCC_AHB1ENR) |= AHB1ENR_DMA1_CLOCK;                        // Enable DMA1 CLOCK
+  v_DmaRxConfigure(&UARTM_t_Usart3DmaRx);
+  REG32(USART3_CR3) |= CR3_DMAR_ENABLE;                            // Enable DMA receiver
+  REG32(USART3_CR1) |= CR1_IDLEIE_ENABLE;                          // Enable IDLE line interrupt
+  NVIC_SetPriority(DMA1_Stream1_IRQn, UARTM_RX_IRQ_PRIORITY);
+  NVIC_SetPriority(USART3_IRQn, UARTM_RX_IRQ_PRIORITY);
+  NVIC_EnableIRQ(DMA1_Stream1_IRQn);                               // Enable Global interrupt for DMA1 Stream1
+  NVIC_EnableIRQ(USART3_IRQn);                                     // Enable Global interrupt for USART3
+#else
 //   7. Enable Interrupt routine for receiving
   REG32(USART2_CR1) |= CR1_RXNEIE_ENABLE;                          // Enable RX interrupt
   REG32(USART3_CR1) |= CR1_RXNEIE_ENABLE;                          // Enable RX interrupt
+  NVIC_SetPriority(USART2_IRQn, UARTM_RX_IRQ_PRIORITY);
+  NVIC_SetPriority(USART3_IRQn, UARTM_RX_IRQ_PRIORITY);
   NVIC_EnableIRQ(USART2_IRQn);                                     // Enable Global interrupt for USART2
   NVIC_EnableIRQ(USART3_IRQn);                                     // Enable Global interrupt for USART3
+#endif
 }
 
 void UARTM_v_Uart2Config()
 {
+  if (UARTM_t_Usart2Tx.t_Event == NULL)
+  {
+    UARTM_t_Usart2Tx.t_Event = xSemaphoreCreateBinaryStatic(&UARTM_t_Usart2TxEventBuffer);
+  }
   // 1. Enable the UART CLOCK and GPIO CLOCK
   REG32(RCC_APB1ENR) |= APB1ENR_UART2_CLOCK;                       // Enable UART2 CLOCK
   REG32(RCC_AHB1ENR) |= AHB1ENR_GPIOD_CLOCK;                       // Enable GPIOD CLOCK
@@ -85,144 +757,186 @@ void UARTM_v_Uart2Config()
   REG32(USART2_CR1) |= CR1_RECEIVER_ENABLE;                        // RE=1... Enable the Receiver
   REG32(USART2_CR1) |= CR1_TRANSMITTER_ENABLE;                     // TE=1... Enable the Receiver
 
+#if (UARTM_RX_MODE == UARTM_RX_MODE_DMA)
+  // 7. Let DMA1 Stream5 receive the data and interrupt only on IDLE line
+  REG32(RCC_AHB1ENR) |= AHB1ENR_DMA1_CLOCK;                        // Enable DMA1 CLOCK
+  v_DmaRxConfigure(&UARTM_t_Usart2DmaRx);
+  REG32(USART2_CR3) |= CR3_DMAR_ENABLE;                            // Enable DMA receiver
+  REG32(USART2_CR1) |= CR1_IDLEIE_ENABLE;                          // Enable IDLE line interrupt
+  NVIC_SetPriority(DMA1_Stream5_IRQn, UARTM_RX_IRQ_PRIORITY);
+  NVIC_SetPriority(USART2_IRQn, UARTM_RX_IRQ_PRIORITY);
+  NVIC_EnableIRQ(DMA1_Stream5_IRQn);                               // Enable Global interrupt for DMA1 Stream5
+  NVIC_EnableIRQ(USART2_IRQn);                                     // Enable Global interrupt for USART2
+#else
   // 7. Enable Interrupt routine for receiving
   REG32(USART2_CR1) |= CR1_RXNEIE_ENABLE;                          // Enable RX interrupt
+  NVIC_SetPriority(USART2_IRQn, UARTM_RX_IRQ_PRIORITY);
   NVIC_EnableIRQ(USART2_IRQn);                                     // Enable Global interrupt for USART2
+#endif
+}
+
+void UARTM2_v_SetBaudRate(uint32_t u_BaudRate)
+{
+  REG32(USART2_BRR) = (UARTM_PCLK1_HZ + (u_BaudRate / 2u)) / u_BaudRate;  // Mantissa and fraction in one value
 }
 
 void UARTM2_v_SendChar(uint8_t u_character)
 {
-	REG32(USART2_DR) = u_character;                                  // Load the data into DR register
-	while (!(REG32(USART2_SR) & (USART_SR_TC)))
-	{
-                                                                   // Wait for TC to SET.. This indicates that the data has been transmitted
-	}
+  v_TxSend(&UARTM_t_Usart2Tx, &u_character, 1u);                   // Queue the character, the interrupt sends it
 }
 
 void UARTM3_v_SendChar(uint8_t u_character)
 {
-	REG32(USART3_DR) = u_character;                                  // Load the data into DR register
-	while (!(REG32(USART3_SR) & (USART_SR_TC)))
-	{
-                                                                   // Wait for TC to SET.. This indicates that the data has been transmitted
-	}
+  v_TxSend(&UARTM_t_Usart3Tx, &u_character, 1u);                   // Queue the character, the interrupt sends it
 }
 
-void UARTM2_v_SendString(uint8_t *u_string)
+void UARTM2_v_SendString(const uint8_t *u_string)
 {
-  while (*u_string != 0)                                           // Move through every character until null character is reached
-  {
-    UARTM2_v_SendChar(*u_string);                                   // Send character by character calling UARTM_v_SendChar function
-    u_string++;                                                    // Increment u_string parameter until end of string is reached
-  }
+  v_TxSend(&UARTM_t_Usart2Tx, u_string, (uint16_t)strlen((const char *)u_string));
 }
 
-void UARTM3_v_SendString(uint8_t *u_string)
+void UARTM3_v_SendString(const uint8_t *u_string)
 {
-  while (*u_string != 0)                                           // Move through every character until null character is reached
-  {
-    UARTM3_v_SendChar(*u_string);                                   // Send character by character calling UARTM_v_SendChar function
-    u_string++;                                                    // Increment u_string parameter until end of string is reached
-  }
+  v_TxSend(&UARTM_t_Usart3Tx, u_string, (uint16_t)strlen((const char *)u_string));
+}
+
+void UARTM2_v_SendBlock(const uint8_t *p_Data, uint16_t u_Length)
+{
+  v_TxSend(&UARTM_t_Usart2Tx, p_Data, u_Length);
+}
+
+void UARTM3_v_SendBlock(const uint8_t *p_Data, uint16_t u_Length)
+{
+  v_TxSend(&UARTM_t_Usart3Tx, p_Data, u_Length);
+}
+
+void UARTM_v_SetGpsForward(e_UARTM_Forward e_Forward)
+{
+  UARTM_e_GpsForward = e_Forward;
+}
+
+uint32_t UARTM_u_GetForwardDropped()
+{
+  return UARTM_u_ForwardDropped;
+}
+
+uint32_t UARTM_u_GetDmaRestarts()
+{
+  return UARTM_u_DmaRestarts;
+}
+
+void UARTM2_v_SetTxCallback(t_UARTM_TxCallback p_Callback)
+{
+  UARTM_t_Usart2Tx.p_Callback = p_Callback;
+}
+
+void UARTM3_v_SetTxCallback(t_UARTM_TxCallback p_Callback)
+{
+  UARTM_t_Usart3Tx.p_Callback = p_Callback;
+}
+
+uint16_t UARTM2_u_WaitSent(uint32_t u_TimeoutMs)
+{
+  return u_TxWaitSent(&UARTM_t_Usart2Tx, u_TimeoutMs);
+}
+
+uint16_t UARTM3_u_WaitSent(uint32_t u_TimeoutMs)
+{
+  return u_TxWaitSent(&UARTM_t_Usart3Tx, u_TimeoutMs);
 }
 
 uint8_t UARTM2_u_GetChar()
 {
-	start_address = __HAL_TIM_GET_COUNTER(&htim10);
-	delayed_value = start_address + max_delay;
-	delayed_overflow_value = max_time - start_address + max_delay;
+  t_TIMEB_Deadline t_Deadline = TIMEB_t_DeadlineInUs(UARTM_GETCHAR_TIMEOUT_US);
 
-	uint8_t u_temp;
-  	if (start_address <= max_time - max_delay)
-  	{
-  		while (!((REG32(USART2_SR) & USART_SR_RXNE) || (__HAL_TIM_GET_COUNTER(&htim10) >= delayed_value)))
-  		{
-                                                                   // Wait until the character is ready in USART3 buffer
-  		}
-    }
-  else
+  while (!(REG32(USART2_SR) & USART_SR_RXNE) && (TIMEB_b_DeadlineExpired(t_Deadline) == b_FALSE))
   {
-	  while (!((REG32(USART2_SR) & USART_SR_RXNE) || (__HAL_TIM_GET_COUNTER(&htim10) >= delayed_overflow_value)))
-
-	  {
-	                                                                    // Wait until the character is ready in USART3 buffer
-	  }
+                                                                   // Wait until the character is ready in USART2 buffer
   }
-  u_temp = (uint8_t) REG32(USART2_DR);                             // Transfer data from DR register to temporary variable
-  return u_temp;                                                   // Return the content of a register
+  return (uint8_t)REG32(USART2_DR);                                // Return the content of a register
 }
 
 uint8_t UARTM3_u_GetChar()
 {
-	start_address = __HAL_TIM_GET_COUNTER(&htim10);
-	delayed_value = start_address + max_delay;
-	delayed_overflow_value = max_time - start_address + max_delay;
+  t_TIMEB_Deadline t_Deadline = TIMEB_t_DeadlineInUs(UARTM_GETCHAR_TIMEOUT_US);
 
-	uint8_t u_temp;
+  while (!(REG32(USART3_SR) & USART_SR_RXNE) && (TIMEB_b_DeadlineExpired(t_Deadline) == b_FALSE))
+  {
+                                                                   // Wait until the character is ready in USART3 buffer
+  }
+  return (uint8_t)REG32(USART3_DR);                                // Return the content of a register
+}
 
-  	  if (start_address <= max_time - max_delay)
-  	  {
-  		  while (!((REG32(USART3_SR) & USART_SR_RXNE) || (__HAL_TIM_GET_COUNTER(&htim10) >= delayed_value)))
-   	  {
-                                                                    // Wait until the character is ready in USART3 buffer
-   	  }
-     }
-  	  else
-  	  {
-  		  while (!((REG32(USART3_SR) & USART_SR_RXNE) || (__HAL_TIM_GET_COUNTER(&htim10) >= delayed_overflow_value)))
-  		  {
- 	                                                                    // Wait until the character is ready in USART3 buffer
-  		  }
-   }
+#if (UARTM_RX_MODE == UARTM_RX_MODE_DMA)
+void USART3_IRQHandler(void)
+{
+  uint32_t u_Start = MONITOR_u_IsrEnter();
+  // Check if interrupt happened because the line went idle after a burst of data
+  if (REG32(USART3_SR) & USART_SR_IDLE)
+  {
+    (void)REG32(USART3_DR);                                         // Reading SR and then DR clears the IDLE flag
+    v_DmaRxProcess(&UARTM_t_Usart3DmaRx);
+  }
+  v_TxInterrupt(&UARTM_t_Usart3Tx);
+  MONITOR_v_IsrExit(MONITOR_ISR_USART3, u_Start);
+}
 
-  u_temp = (uint8_t) REG32(USART3_DR);                             // Transfer data from DR register to temporary variable
-  return u_temp;                                                   // Return the content of a register
+void USART2_IRQHandler(void)
+{
+  uint32_t u_Start = MONITOR_u_IsrEnter();
+  // Check if interrupt happened because the line went idle after a burst of data
+  if (REG32(USART2_SR) & USART_SR_IDLE)
+  {
+    (void)REG32(USART2_DR);                                         // Reading SR and then DR clears the IDLE flag
+    v_DmaRxProcess(&UARTM_t_Usart2DmaRx);
+  }
+  v_TxInterrupt(&UARTM_t_Usart2Tx);
+  MONITOR_v_IsrExit(MONITOR_ISR_USART2, u_Start);
 }
 
+void DMA1_Stream1_IRQHandler(void)
+{
+  // Half transfer, transfer complete or error on USART3 receive stream
+  uint32_t u_Flags = REG32(DMA1_LISR) & DMA_STREAM_1_5_FLAGS;
+  REG32(DMA1_LIFCR) = u_Flags;                                      // Clear all flags of stream 1
+  v_DmaRxService(&UARTM_t_Usart3DmaRx, u_Flags);
+}
+
+void DMA1_Stream5_IRQHandler(void)
+{
+  // Half transfer, transfer complete or error on USART2 receive stream
+  uint32_t u_Flags = REG32(DMA1_HISR) & DMA_STREAM_1_5_FLAGS;
+  REG32(DMA1_HIFCR) = u_Flags;                                      // Clear all flags of stream 5
+  v_DmaRxService(&UARTM_t_Usart2DmaRx, u_Flags);
+}
+#else
 void USART3_IRQHandler(void)
 {
+  uint32_t u_Start = MONITOR_u_IsrEnter();
   // Check if interrupt happened because of RXNEIE register
   if (REG32(USART3_SR) & USART_SR_RXNE)                             // If RX register is not empty
   {
-    start_address = __HAL_TIM_GET_COUNTER(&htim10);
-    delayed_value = start_address + max_delay;
-    delayed_overflow_value = max_time - start_address + max_delay;
-    uint8_t u_temp = (uint8_t)REG32(USART3_DR);                             // Fetch the data received
-   if (start_address <= max_time - max_delay)
-   {
-    while (!((REG32(USART3_SR) & USART_SR_TXE) || (__HAL_TIM_GET_COUNTER(&htim10) >= delayed_value)));
-   }
-   else
-   {
-     while (!((REG32(USART3_SR) & USART_SR_TXE) || (__HAL_TIM_GET_COUNTER(&htim10) >= delayed_overflow_value)));
-   }
-    MSGM_u_CircularBufferPush(RING_BUFFER1, u_temp);
+    MSGM_u_CircularBufferPush(RING_BUFFER2, (uint8_t)REG32(USART3_DR));
   }
+  v_TxInterrupt(&UARTM_t_Usart3Tx);
+  MONITOR_v_IsrExit(MONITOR_ISR_USART3, u_Start);
 }
 
 void USART2_IRQHandler()
 {
-  start_address = __HAL_TIM_GET_COUNTER(&htim10);
-  delayed_value = start_address + max_delay;
-  delayed_overflow_value = max_time - start_address + max_delay;
+  uint32_t u_Start = MONITOR_u_IsrEnter();
   // Check if interrupt happened because of RXNEIE register
   if (REG32(USART2_SR) & USART_SR_RXNE)                             // If RX register is not empty
   {
     uint8_t u_temp = (uint8_t)REG32(USART2_DR);                    // Fetch the data received from USART2
 
-    if (start_address <= max_time - max_delay)
-    {
-     while (!((REG32(USART2_SR) & USART_SR_TXE) || (__HAL_TIM_GET_COUNTER(&htim10) >= delayed_value)));
-    }
-    else
-    {
-      while (!((REG32(USART2_SR) & USART_SR_TXE) || (__HAL_TIM_GET_COUNTER(&htim10) >= delayed_overflow_value)));
-    }
-    REG32(USART2_DR) = u_temp;
-    REG32(USART3_DR) = u_temp;                                      // Send the data temporary variable to USART3
     MSGM_u_CircularBufferPush(RING_BUFFER1, u_temp);                // Push the data to the ring buffer for storage
+    v_ForwardFromISR(&u_temp, 1u);                                  // Echo is queued, the transmit interrupt sends it
   }
+  v_TxInterrupt(&UARTM_t_Usart2Tx);
+  MONITOR_v_IsrExit(MONITOR_ISR_USART2, u_Start);
 }
+#endif
 
 void UARTM_v_ClearBuffer()
 {
@@ -7,33 +7,180 @@
 
 #include "UARTM_cfg.h"
 
+/// Function called from the UART interrupt when all queued bytes have left the transmitter
+typedef void (*t_UARTM_TxCallback)(void);
+
+/// Destination of the data received from the GPS
+typedef enum {
+  UARTM_FORWARD_OFF,    ///< GPS data is only parsed
+  UARTM_FORWARD_DEBUG,  ///< GPS data is also sent back on USART2 (debug port)
+  UARTM_FORWARD_SIM     ///< GPS data is also sent to USART3 (SIM800L)
+} e_UARTM_Forward;
 
 /// @brief Function used to transmit a string using UART protocol
 ///
 /// @pre UART must be configured
-/// @post Sending a string of characters through serial monitor
-/// @param uint8_t* u_string
+/// @post String is queued, it is sent by the UART interrupt
+/// @param const uint8_t* u_string null terminated string
 ///
 /// @return None
 ///
-/// @globals t_RingBuffer structure which is used as a ring buffer
+/// @globals UARTM_t_Usart2Tx, UARTM_t_Usart3Tx transmit rings
 ///
-/// @InOutCorelation Function writes the data from interrupt routine to the ring buffer
+/// @InOutCorelation Function copies the string into the transmit ring of the UART and returns. Caller sleeps only
+///                  while the ring is full, the string can be reused as soon as the function returns.
 /// @callsequence
 ///   @startuml "UARTM_v_SendString.png"
 ///     title "Sequence diagram for function UARTM_v_SendString"
-///     -> UARTM: UARTM_v_SendString()
+///     -> UARTM: UARTM_v_SendString(const uint8_t* u_string)
 ///     UARTM++
-///     loop //loop that loads input characters into a buffer//
-///       rnote over UARTM: fetches character by character while moving through buffer
-///           UARTM -> UARTM: UARTM_v_GetChar()
-///              rnote over UARTM: Function that gets character and loads it into a buffer
-///           <- UARTM:// Returns a 32-bit value that represents the character from UART data buffer//
-///           UARTM--
+///     loop //until the whole string is queued//
+///       UARTM -> UARTM: u_TxWrite(...)
+///       opt if transmit ring is full
+///         UARTM -> UARTM: v_TxWait(...) or v_TxPoll(...) before the scheduler starts
+///       end
 ///     end
+///     <- UARTM
+///     UARTM--
+///   @enduml
+void UARTM2_v_SendString (const uint8_t* u_string);
+void UARTM3_v_SendString (const uint8_t* u_string);
+
+/// @brief Function used to transmit a block of binary data using UART protocol
+///
+/// @pre UART must be configured
+/// @post Block is queued, it is sent by the UART interrupt
+/// @param const uint8_t* p_Data, uint16_t u_Length
+///
+/// @return None
+///
+/// @globals UARTM_t_Usart2Tx, UARTM_t_Usart3Tx transmit rings
+///
+/// @InOutCorelation Function is the same as UARTM_v_SendString, but the data may contain zero bytes.
+/// @callsequence
+///   @startuml "UARTM_v_SendBlock.png"
+///     title "Sequence diagram for function UARTM_v_SendBlock"
+///     -> UARTM: UARTM_v_SendBlock(const uint8_t* p_Data, uint16_t u_Length)
+///     UARTM++
+///       UARTM -> UARTM: v_TxSend(..., p_Data, u_Length)
+///     <- UARTM
+///     UARTM--
+///   @enduml
+void UARTM2_v_SendBlock (const uint8_t* p_Data, uint16_t u_Length);
+void UARTM3_v_SendBlock (const uint8_t* p_Data, uint16_t u_Length);
+
+/// @brief Function used to register the transmit completion notification
+///
+/// @pre None
+/// @post p_Callback is called each time the transmit ring of the UART becomes empty
+/// @param t_UARTM_TxCallback p_Callback function called from the interrupt, NULL disables the notification
+///
+/// @return None
+///
+/// @globals UARTM_t_Usart2Tx, UARTM_t_Usart3Tx transmit rings
+///
+/// @InOutCorelation Callback is called from the UART interrupt after transmission complete of the last queued byte,
+///                  so it may only use FreeRTOS functions ending with FromISR.
+/// @callsequence
+///   @startuml "UARTM_v_SetTxCallback.png"
+///     title "Sequence diagram for function UARTM_v_SetTxCallback"
+///     -> UARTM: UARTM_v_SetTxCallback(t_UARTM_TxCallback p_Callback)
+///     UARTM++
+///       rnote over UARTM: Callback is stored in the transmit ring.
+///     <- UARTM
+///     UARTM--
 ///   @enduml
-void UARTM2_v_SendString (uint8_t* u_string);
-void UARTM3_v_SendString (uint8_t* u_string);
+void UARTM2_v_SetTxCallback(t_UARTM_TxCallback p_Callback);
+void UARTM3_v_SetTxCallback(t_UARTM_TxCallback p_Callback);
+
+/// @brief Function used to wait until the queued bytes are sent
+///
+/// @pre UART must be configured, called from a task
+/// @post None
+/// @param uint32_t u_TimeoutMs longest wait
+///
+/// @return uint16_t number of bytes not sent when the timeout expired, 0 when the last byte has left the UART
+///
+/// @globals UARTM_t_Usart2Tx, UARTM_t_Usart3Tx transmit rings
+///
+/// @InOutCorelation Task sleeps until the transmission complete interrupt of the last queued byte wakes it, other
+///                  tasks keep running. Before the scheduler starts the function only reports the pending bytes.
+/// @callsequence
+///   @startuml "UARTM_u_WaitSent.png"
+///     title "Sequence diagram for function UARTM_u_WaitSent"
+///     -> UARTM: UARTM_u_WaitSent(uint32_t u_TimeoutMs)
+///     UARTM++
+///       UARTM -> UARTM: u_TxWaitSent(..., u_TimeoutMs)
+///     <- UARTM: Returns number of bytes not sent
+///     UARTM--
+///   @enduml
+uint16_t UARTM2_u_WaitSent(uint32_t u_TimeoutMs);
+uint16_t UARTM3_u_WaitSent(uint32_t u_TimeoutMs);
+
+/// @brief Function used to select where the GPS data is forwarded
+///
+/// @pre None
+/// @post Data received from USART2 after the call is forwarded to the selected port
+/// @param e_UARTM_Forward e_Forward
+///
+/// @return None
+///
+/// @globals UARTM_e_GpsForward
+///
+/// @InOutCorelation Receive interrupt copies GPS data into the transmit ring of the selected port. When the ring is
+///                  full the data is dropped and counted, parsing of the GPS data is never delayed.
+/// @callsequence
+///   @startuml "UARTM_v_SetGpsForward.png"
+///     title "Sequence diagram for function UARTM_v_SetGpsForward"
+///     -> UARTM: UARTM_v_SetGpsForward(e_UARTM_Forward e_Forward)
+///     UARTM++
+///       rnote over UARTM: Destination is stored, it is read by the receive interrupt.
+///     <- UARTM
+///     UARTM--
+///   @enduml
+void UARTM_v_SetGpsForward(e_UARTM_Forward e_Forward);
+
+/// @brief Function used to read the number of GPS bytes which could not be forwarded
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return uint32_t number of dropped bytes
+///
+/// @globals UARTM_u_ForwardDropped
+///
+/// @InOutCorelation Function returns the counter of bytes dropped because the transmit ring was full.
+/// @callsequence
+///   @startuml "UARTM_u_GetForwardDropped.png"
+///     title "Sequence diagram for function UARTM_u_GetForwardDropped"
+///     -> UARTM: UARTM_u_GetForwardDropped()
+///     UARTM++
+///     <- UARTM: Returns UARTM_u_ForwardDropped
+///     UARTM--
+///   @enduml
+uint32_t UARTM_u_GetForwardDropped(void);
+
+/// @brief Function used to read the number of receive DMA streams restarted after an error
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return uint32_t number of restarts, always 0 in UARTM_RX_MODE_INTERRUPT
+///
+/// @globals UARTM_u_DmaRestarts
+///
+/// @InOutCorelation Function returns the counter of streams restarted because TEIF, FEIF or DMEIF was set.
+/// @callsequence
+///   @startuml "UARTM_u_GetDmaRestarts.png"
+///     title "Sequence diagram for function UARTM_u_GetDmaRestarts"
+///     -> UARTM: UARTM_u_GetDmaRestarts()
+///     UARTM++
+///     <- UARTM: Returns UARTM_u_DmaRestarts
+///     UARTM--
+///   @enduml
+uint32_t UARTM_u_GetDmaRestarts(void);
 
 /// @brief Function used to receive a character using UART protocol
 ///
@@ -140,24 +287,45 @@ void UARTM_v_ClearBuffer();
 ///   @enduml
 void UARTM_v_Uart2Config();
 
+/// @brief Function used to change the baud rate of USART2
+///
+/// @pre UARTM_v_Uart2Config must be done, nothing may be in transmission
+/// @post USART2 sends and receives at u_BaudRate
+/// @param uint32_t u_BaudRate
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation With 16 times oversampling BRR holds PCLK1 / u_BaudRate in 1/16 steps, the value is rounded.
+/// @callsequence
+///   @startuml "UARTM2_v_SetBaudRate.png"
+///     title "Sequence diagram for function UARTM2_v_SetBaudRate"
+///     -> UARTM: UARTM2_v_SetBaudRate(uint32_t u_BaudRate)
+///     UARTM++
+///       rnote over UARTM: USART2_BRR is written.
+///     <- UARTM
+///     UARTM--
+///   @enduml
+void UARTM2_v_SetBaudRate(uint32_t u_BaudRate);
+
 /// @brief Function used to transmit a character using UART protocol
 ///
 /// @pre UART must be configured
-/// @post Sending character through serial monitor
+/// @post Character is queued, it is sent by the UART interrupt
 /// @param uint8_t u_character
 ///
 /// @return None
 ///
-/// @globals None
+/// @globals UARTM_t_Usart2Tx, UARTM_t_Usart3Tx transmit rings
 ///
-/// @InOutCorelation Function sends character through serial monitor.
+/// @InOutCorelation Function puts the character into the transmit ring of the UART and returns.
 /// @callsequence
 ///@startuml "UARTM_v_SendChar.png"
 ///  title "Sequence diagram for function UARTM_v_SendChar"
 ///  UARTM++
-///    -> UARTM: UARTM_v_SendChar()
-///      loop // Wait for TC register to SET.. This indicates that the data has been transmitted //
-///      end
+///    -> UARTM: UARTM_v_SendChar(uint8_t u_character)
+///      UARTM -> UARTM: v_TxSend(..., &u_character, 1u)
 ///    <- UARTM
 ///  UARTM--
 ///@enduml
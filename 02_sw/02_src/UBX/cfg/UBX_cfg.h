@@ -0,0 +1,67 @@
+/// @file UBX_cfg.h
+/// @brief Contains configuration data used for the UBX binary protocol of the GPS module
+/// @author Aleksandra Petrovic
+
+#ifndef UBX_CFG_H_
+#define UBX_CFG_H_
+
+#include "UBX.h"
+
+/// Baud rate used once the module is switched to UBX output
+#define UBX_BAUD_RATE (38400u)
+/// Time between two measurements in milliseconds, 5 Hz
+#define UBX_MEASUREMENT_PERIOD_MS (200u)
+/// Time given to the module to send the configuration at the default baud rate and to apply it
+#define UBX_SETTLE_MS (100u)
+/// Time after the switch within which a valid frame must arrive, otherwise NMEA is used again
+#define UBX_CONFIRM_MS (3000u)
+/// Stored bytes which wake TSK_Com, the smallest frame. With DMA reception it is woken once per burst
+#define UBX_NOTIFY_THRESHOLD (UBX_HEADER_LENGTH + UBX_CHECKSUM_LENGTH)
+
+/// NAV-SOL flags bit set when the fix is valid
+#define UBX_SOL_FLAG_FIX_OK (0x01u)
+/// NAV-SOL flags bit set for a differential fix
+#define UBX_SOL_FLAG_DIFF (0x02u)
+/// NAV-TIMEUTC valid bit set when UTC is known, the receiver has the leap seconds from the almanac
+#define UBX_TIMEUTC_VALID_UTC (0x04u)
+
+/// Writes a 16-bit value as two little endian payload bytes
+#define UBX_U16(x) (uint8_t)((x) & 0xFFu), (uint8_t)(((x) >> 8u) & 0xFFu)
+/// Writes a 32-bit value as four little endian payload bytes
+#define UBX_U32(x) UBX_U16((x) & 0xFFFFu), UBX_U16(((x) >> 16u) & 0xFFFFu)
+
+/// CFG-MSG: NAV-POSLLH once per solution on the current port
+const uint8_t UBX_a_MsgPosllh[] = { UBX_CLASS_NAV, UBX_ID_NAV_POSLLH, 1u };
+/// CFG-MSG: NAV-SOL once per solution on the current port
+const uint8_t UBX_a_MsgSol[] = { UBX_CLASS_NAV, UBX_ID_NAV_SOL, 1u };
+/// CFG-MSG: NAV-TIMEUTC once per solution on the current port
+const uint8_t UBX_a_MsgTimeUtc[] = { UBX_CLASS_NAV, UBX_ID_NAV_TIMEUTC, 1u };
+/// CFG-RATE: measurement period, one solution per measurement, aligned to GPS time
+const uint8_t UBX_a_Rate[] = { UBX_U16(UBX_MEASUREMENT_PERIOD_MS), UBX_U16(1u), UBX_U16(1u) };
+/// CFG-PRT: UART1 8N1 at UBX_BAUD_RATE, UBX and NMEA accepted, only UBX sent
+const uint8_t UBX_a_Port[] = {
+    1u, 0u, UBX_U16(0u), UBX_U32(0x000008D0u), UBX_U32(UBX_BAUD_RATE), UBX_U16(0x0003u), UBX_U16(0x0001u),
+    UBX_U16(0u), UBX_U16(0u)
+};
+
+/// Messages sent by UBX_v_Start in order, CFG-PRT must stay last since it changes the baud rate
+const t_UBX_Command UBX_t_Startup[] = {
+    { UBX_CLASS_CFG, UBX_ID_CFG_MSG,  UBX_a_MsgPosllh,  sizeof(UBX_a_MsgPosllh)  },
+    { UBX_CLASS_CFG, UBX_ID_CFG_MSG,  UBX_a_MsgSol,     sizeof(UBX_a_MsgSol)     },
+    { UBX_CLASS_CFG, UBX_ID_CFG_MSG,  UBX_a_MsgTimeUtc, sizeof(UBX_a_MsgTimeUtc) },
+    { UBX_CLASS_CFG, UBX_ID_CFG_RATE, UBX_a_Rate,       sizeof(UBX_a_Rate)       },
+    { UBX_CLASS_CFG, UBX_ID_CFG_PRT,  UBX_a_Port,       sizeof(UBX_a_Port)       }
+};
+/// Used to determine the length of UBX_t_Startup array
+const uint16_t UBX_u_StartupLength = sizeof(UBX_t_Startup) / sizeof(UBX_t_Startup[0]);
+
+/// Table used to dispatch valid frames to decoders by class, ID and payload length
+const t_UBX_Handler UBX_t_Handlers[] = {
+    { UBX_CLASS_NAV, UBX_ID_NAV_SOL,     UBX_NAV_SOL_LENGTH,     UBX_v_DecodeNavSol     },
+    { UBX_CLASS_NAV, UBX_ID_NAV_TIMEUTC, UBX_NAV_TIMEUTC_LENGTH, UBX_v_DecodeNavTimeUtc },
+    { UBX_CLASS_NAV, UBX_ID_NAV_POSLLH,  UBX_NAV_POSLLH_LENGTH,  UBX_v_DecodeNavPosllh  }
+};
+/// Used to determine the length of UBX_t_Handlers array
+const uint16_t UBX_u_HandlersLength = sizeof(UBX_t_Handlers) / sizeof(UBX_t_Handlers[0]);
+
+#endif /* UBX_CFG_H_ */
@@ -0,0 +1,299 @@
+/// @file UBX.c
+/// @brief Main file used for switching the GPS module to the UBX binary protocol and decoding its frames
+/// @author Aleksandra Petrovic
+
+#include "UBX.h"
+#include "UBX_cfg.h"
+#include "NMEA.h"
+#include "UARTM.h"
+#include "TIMEB.h"
+#include "FIXLOG.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+static volatile boolean  UBX_b_Active          = b_FALSE;   // NMEA is parsed until the module is switched
+static boolean           UBX_b_Confirmed       = b_FALSE;   // Set by the first valid frame after the switch
+static boolean           UBX_b_FixOk           = b_FALSE;   // Fix flag of the last NAV-SOL, NAV-POSLLH carries none
+static t_TIMEB_Deadline  UBX_t_ConfirmDeadline = {0u};      // Time by which a valid frame must arrive
+static t_UBX_Statistics  UBX_t_Statistics      = {0u};      // Framer counters
+static uint32_t          UBX_a_Payload[(UBX_MAX_PAYLOAD_LENGTH + 3u) / 4u];  // Payload of the current frame, word aligned
+
+/// @brief Function used to build a frame and queue it for USART2
+///
+/// @pre UARTM_v_Uart2Config must be done
+/// @post Frame is in the transmit ring of USART2
+/// @param const t_UBX_Command *p_Command
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Function puts sync characters, class, ID and length before the payload and CK_A and CK_B after it.
+/// @callsequence
+///   @startuml "v_Send.png"
+///     title "Sequence diagram for function v_Send"
+///     -> UBX: v_Send(const t_UBX_Command *p_Command)
+///     UBX++
+///       rnote over UBX: Frame is built and the Fletcher checksum is computed from the class on.
+///       UBX -> UARTM: UARTM2_v_SendBlock(...)
+///     <- UBX
+///     UBX--
+///   @enduml
+
+static void v_Send(const t_UBX_Command *p_Command);
+
+static void v_Send(const t_UBX_Command *p_Command)
+{
+  uint8_t  a_Frame[UBX_HEADER_LENGTH + UBX_MAX_PAYLOAD_LENGTH + UBX_CHECKSUM_LENGTH];
+  uint16_t u_Length = 0u;
+  uint8_t  u_CkA    = 0u;
+  uint8_t  u_CkB    = 0u;
+
+  if (p_Command -> u_Length > UBX_MAX_PAYLOAD_LENGTH)
+  {
+    return;
+  }
+  a_Frame[u_Length++] = UBX_SYNC_CHAR_1;
+  a_Frame[u_Length++] = UBX_SYNC_CHAR_2;
+  a_Frame[u_Length++] = p_Command -> u_Class;
+  a_Frame[u_Length++] = p_Command -> u_Id;
+  a_Frame[u_Length++] = (uint8_t)(p_Command -> u_Length & 0xFFu);
+  a_Frame[u_Length++] = (uint8_t)(p_Command -> u_Length >> 8u);
+  for (uint16_t u_Cnt = 0u; u_Cnt < p_Command -> u_Length; u_Cnt++)
+  {
+    a_Frame[u_Length++] = p_Command -> p_Payload[u_Cnt];
+  }
+  for (uint16_t u_Cnt = 2u; u_Cnt < u_Length; u_Cnt++)               // Sync characters are not checked
+  {
+    u_CkA = (uint8_t)(u_CkA + a_Frame[u_Cnt]);
+    u_CkB = (uint8_t)(u_CkB + u_CkA);
+  }
+  a_Frame[u_Length++] = u_CkA;
+  a_Frame[u_Length++] = u_CkB;
+  UARTM2_v_SendBlock(a_Frame, u_Length);
+}
+
+/// @brief Function used to read a little endian value of a payload
+///
+/// @pre u_Offset + u_Size must be within the payload
+/// @post None
+/// @param const uint8_t *p_Payload, uint8_t u_Offset, uint8_t u_Size 1, 2 or 4
+///
+/// @return uint32_t value, signed fields are cast by the caller
+///
+/// @globals None
+///
+/// @InOutCorelation Bytes are combined one by one, so the result does not depend on the alignment of the field.
+/// @callsequence
+///   @startuml "u_Read.png"
+///     title "Sequence diagram for function u_Read"
+///     -> UBX: u_Read(const uint8_t *p_Payload, uint8_t u_Offset, uint8_t u_Size)
+///     UBX++
+///     <- UBX: Returns value
+///     UBX--
+///   @enduml
+
+static uint32_t u_Read(const uint8_t *p_Payload, uint8_t u_Offset, uint8_t u_Size);
+
+static uint32_t u_Read(const uint8_t *p_Payload, uint8_t u_Offset, uint8_t u_Size)
+{
+  uint32_t u_Value = 0u;
+
+  while (u_Size > 0u)
+  {
+    u_Size--;
+    u_Value = (u_Value << 8u) | p_Payload[u_Offset + u_Size];
+  }
+  return u_Value;
+}
+
+/// @brief Function used to give up UBX when the module never answered in it
+///
+/// @pre Called from UBX_v_Process
+/// @post NMEA is parsed at the default baud rate again
+/// @param None
+///
+/// @return None
+///
+/// @globals UBX_b_Active
+///
+/// @InOutCorelation A module which is not a u-blox receiver ignores the configuration and keeps sending NMEA at the
+///                  default baud rate.
+/// @callsequence
+///   @startuml "v_Fallback.png"
+///     title "Sequence diagram for function v_Fallback"
+///     -> UBX: v_Fallback()
+///     UBX++
+///       UBX -> UARTM: UARTM2_v_SetBaudRate(UARTM_GPS_DEFAULT_BAUD_RATE)
+///       UBX -> MSGM: MSGM_v_SetNotifyThreshold(RING_BUFFER1, MSGM_GPS_NOTIFY_THRESHOLD)
+///       UBX -> MSGM: MSGM_v_SetAdmission(RING_BUFFER1, NMEA_b_Admit)
+///     <- UBX
+///     UBX--
+///   @enduml
+
+static void v_Fallback(void);
+
+static void v_Fallback(void)
+{
+  UARTM2_v_SetBaudRate(UARTM_GPS_DEFAULT_BAUD_RATE);
+  MSGM_v_SetNotifyThreshold(RING_BUFFER1, MSGM_GPS_NOTIFY_THRESHOLD);
+  MSGM_v_SetAdmission(RING_BUFFER1, NMEA_b_Admit);
+  UBX_b_Active = b_FALSE;
+}
+
+void UBX_v_Start(void)
+{
+  for (uint16_t u_Cnt = 0u; u_Cnt < UBX_u_StartupLength; u_Cnt++)
+  {
+    v_Send(&UBX_t_Startup[u_Cnt]);
+  }
+  vTaskDelay(pdMS_TO_TICKS(UBX_SETTLE_MS));                          // CFG-PRT has left and the module has switched
+  UARTM2_v_SetBaudRate(UBX_BAUD_RATE);
+  MSGM_v_SetNotifyThreshold(RING_BUFFER1, UBX_NOTIFY_THRESHOLD);
+  MSGM_v_SetAdmission(RING_BUFFER1, NULL);                           // Binary frames have no address field
+  UBX_b_FixOk = b_FALSE;
+  UBX_b_Confirmed = b_FALSE;
+  UBX_t_ConfirmDeadline = TIMEB_t_DeadlineInUs(UBX_CONFIRM_MS * 1000u);
+  UBX_b_Active = b_TRUE;
+}
+
+boolean UBX_b_IsActive(void)
+{
+  return UBX_b_Active;
+}
+
+void UBX_v_Process(t_RINGB_Ring *p_Ring)
+{
+  uint8_t  *p_Payload = (uint8_t *)UBX_a_Payload;
+  uint32_t  u_Count   = RINGB_u_Count(p_Ring);                       // Snapshot, bytes arriving meanwhile are handled on the next wake up
+
+  while (u_Count >= UBX_HEADER_LENGTH)
+  {
+    if ((RINGB_u_PeekAt(p_Ring, 0u) != UBX_SYNC_CHAR_1) || (RINGB_u_PeekAt(p_Ring, 1u) != UBX_SYNC_CHAR_2))
+    {
+      u_Count -= RINGB_u_Skip(p_Ring, 1u);                           // Also drops NMEA sent before the switch
+      UBX_t_Statistics.u_DroppedBytes++;
+      continue;
+    }
+
+    uint8_t  u_Class  = RINGB_u_PeekAt(p_Ring, 2u);
+    uint8_t  u_Id     = RINGB_u_PeekAt(p_Ring, 3u);
+    uint16_t u_Length = (uint16_t)(RINGB_u_PeekAt(p_Ring, 4u) | ((uint16_t)RINGB_u_PeekAt(p_Ring, 5u) << 8u));
+    uint8_t  u_CkA    = 0u;
+    uint8_t  u_CkB    = 0u;
+
+    if (u_Length > UBX_MAX_PAYLOAD_LENGTH)
+    {
+      UBX_t_Statistics.u_FramingErrors++;                            // Sync characters were payload bytes, hunt again
+      u_Count -= RINGB_u_Skip(p_Ring, 1u);
+      continue;
+    }
+    if (u_Count < (uint32_t)(UBX_HEADER_LENGTH + u_Length + UBX_CHECKSUM_LENGTH))
+    {
+      break;                                                         // Rest of the frame has not arrived yet
+    }
+
+    for (uint32_t u_Cnt = 2u; u_Cnt < UBX_HEADER_LENGTH; u_Cnt++)
+    {
+      u_CkA = (uint8_t)(u_CkA + RINGB_u_PeekAt(p_Ring, u_Cnt));
+      u_CkB = (uint8_t)(u_CkB + u_CkA);
+    }
+    for (uint32_t u_Cnt = 0u; u_Cnt < u_Length; u_Cnt++)
+    {
+      p_Payload[u_Cnt] = RINGB_u_PeekAt(p_Ring, UBX_HEADER_LENGTH + u_Cnt);          // Checksum is computed while copying
+      u_CkA = (uint8_t)(u_CkA + p_Payload[u_Cnt]);
+      u_CkB = (uint8_t)(u_CkB + u_CkA);
+    }
+
+    if ((RINGB_u_PeekAt(p_Ring, UBX_HEADER_LENGTH + u_Length) != u_CkA) ||
+        (RINGB_u_PeekAt(p_Ring, UBX_HEADER_LENGTH + u_Length + 1u) != u_CkB))
+    {
+      UBX_t_Statistics.u_ChecksumErrors++;
+      u_Count -= RINGB_u_Skip(p_Ring, 1u);                           // A real frame may start inside the rejected one
+      continue;
+    }
+
+    UBX_t_Statistics.u_Frames++;
+    UBX_b_Confirmed = b_TRUE;
+    for (uint16_t u_Cnt = 0u; u_Cnt < UBX_u_HandlersLength; u_Cnt++)
+    {
+      const t_UBX_Handler *p_Handler = &UBX_t_Handlers[u_Cnt];
+
+      if ((p_Handler -> u_Class == u_Class) && (p_Handler -> u_Id == u_Id) && (p_Handler -> u_Length == u_Length))
+      {
+        UBX_t_Statistics.u_Dispatched++;
+        p_Handler -> p_Decoder(p_Payload);
+        break;
+      }
+    }
+    u_Count -= RINGB_u_Skip(p_Ring, UBX_HEADER_LENGTH + u_Length + UBX_CHECKSUM_LENGTH);  // Release the whole frame at once
+  }
+
+  if ((UBX_b_Confirmed == b_FALSE) && (TIMEB_b_DeadlineExpired(UBX_t_ConfirmDeadline) == b_TRUE))
+  {
+    v_Fallback();
+  }
+}
+
+void UBX_v_DecodeNavSol(const uint8_t *p_Payload)
+{
+  t_NMEA_Info *p_Info  = NMEA_p_GetInfo();
+  uint8_t      u_Fix   = (uint8_t)u_Read(p_Payload, 10u, 1u);
+  uint8_t      u_Flags = (uint8_t)u_Read(p_Payload, 11u, 1u);
+
+  UBX_b_FixOk = (((u_Flags & UBX_SOL_FLAG_FIX_OK) != 0u) && (u_Fix >= 2u) && (u_Fix <= 4u)) ? b_TRUE : b_FALSE;
+  p_Info -> u_FixMode = ((u_Fix == 2u) || (u_Fix == 3u)) ? u_Fix : 1u;               // GSA meaning, dead reckoning is no fix
+  p_Info -> u_FixQuality = (UBX_b_FixOk == b_FALSE) ? 0u : (((u_Flags & UBX_SOL_FLAG_DIFF) != 0u) ? 2u : 1u);
+  p_Info -> u_Valid = (UBX_b_FixOk == b_TRUE) ? 1u : 0u;
+  p_Info -> u_Hdop = (uint16_t)u_Read(p_Payload, 44u, 2u);           // PDOP, NAV-SOL has no HDOP
+  p_Info -> u_Satellites = (uint8_t)u_Read(p_Payload, 47u, 1u);
+}
+
+void UBX_v_DecodeNavTimeUtc(const uint8_t *p_Payload)
+{
+  t_NMEA_Info *p_Info   = NMEA_p_GetInfo();
+  uint32_t     u_Year   = u_Read(p_Payload, 12u, 2u);
+  uint32_t     u_Month  = u_Read(p_Payload, 14u, 1u);
+  uint32_t     u_Day    = u_Read(p_Payload, 15u, 1u);
+  uint32_t     u_Hour   = u_Read(p_Payload, 16u, 1u);
+  uint32_t     u_Minute = u_Read(p_Payload, 17u, 1u);
+  uint32_t     u_Second = u_Read(p_Payload, 18u, 1u);                // 60 during a leap second
+  uint8_t      u_Valid  = (uint8_t)u_Read(p_Payload, 19u, 1u);
+
+  if ((u_Valid & UBX_TIMEUTC_VALID_UTC) == 0u)
+  {
+    return;                                                          // Leap seconds are not known yet, UTC would be off by them
+  }
+  p_Info -> u_Time = (u_Hour * 10000u) + (u_Minute * 100u) + u_Second;
+  p_Info -> u_Date = (u_Day * 10000u) + (u_Month * 100u) + (u_Year % 100u);
+}
+
+void UBX_v_DecodeNavPosllh(const uint8_t *p_Payload)
+{
+  const t_NMEA_Info *p_Info      = NMEA_p_GetInfo();
+  int32_t            i_Longitude = (int32_t)u_Read(p_Payload, 4u, 4u);
+  int32_t            i_Latitude  = (int32_t)u_Read(p_Payload, 8u, 4u);
+  t_MSGM_Fix         t_Fix       = {0};
+
+  if (UBX_b_FixOk == b_FALSE)
+  {
+    return;                                                          // Position of a solution without a fix
+  }
+
+  // 1e-7 degrees are rounded to micro-degrees, the binary position is published without going through text
+  t_Fix.i_Latitude   = (i_Latitude + ((i_Latitude < 0) ? -5 : 5)) / 10;
+  t_Fix.i_Longitude  = (i_Longitude + ((i_Longitude < 0) ? -5 : 5)) / 10;
+  t_Fix.u_Date       = p_Info -> u_Date;
+  t_Fix.u_Time       = p_Info -> u_Time;
+  t_Fix.u_Hdop       = p_Info -> u_Hdop;
+  t_Fix.u_Quality    = p_Info -> u_FixQuality;
+  t_Fix.u_Satellites = p_Info -> u_Satellites;
+
+  MSGM_v_PublishFix(MSGM_FIX_OWN, &t_Fix);                           // Readers retry when they overlap the write
+  FIXLOG_v_Record(&t_Fix);
+}
+
+t_UBX_Statistics * UBX_p_GetStatistics(void)
+{
+  return &UBX_t_Statistics;
+}
@@ -0,0 +1,221 @@
+/// @file UBX.h
+/// @brief Header file used for switching the GPS module to the UBX binary protocol and decoding its frames
+/// @author Aleksandra Petrovic
+///
+/// At start up the NEO-6M is configured with UBX-CFG-MSG, UBX-CFG-RATE and UBX-CFG-PRT to send only NAV-POSLLH,
+/// NAV-SOL and NAV-TIMEUTC at a higher baud and update rate. A frame is checked with its Fletcher checksum and decoded at fixed
+/// offsets of its payload, so the work per fix does not depend on the content. When no valid frame arrives within
+/// UBX_CONFIRM_MS the module is taken to be something else and NMEA parsing is used again.
+
+#ifndef UBX_H_
+#define UBX_H_
+
+#include <stdint.h>
+#include "RINGB.h"
+#include "MSGM.h"
+
+/// First sync character of a frame
+#define UBX_SYNC_CHAR_1 (0xB5u)
+/// Second sync character of a frame
+#define UBX_SYNC_CHAR_2 (0x62u)
+/// Number of bytes before the payload: two sync characters, class, ID and a 16-bit length
+#define UBX_HEADER_LENGTH (6u)
+/// Number of bytes after the payload: CK_A and CK_B
+#define UBX_CHECKSUM_LENGTH (2u)
+/// Largest payload which is decoded, longer frames are not expected once the module is configured
+#define UBX_MAX_PAYLOAD_LENGTH (64u)
+
+/// Class of navigation results
+#define UBX_CLASS_NAV (0x01u)
+/// Class of configuration messages
+#define UBX_CLASS_CFG (0x06u)
+/// ID of NAV-POSLLH, geodetic position
+#define UBX_ID_NAV_POSLLH (0x02u)
+/// ID of NAV-SOL, navigation solution
+#define UBX_ID_NAV_SOL (0x06u)
+/// ID of NAV-TIMEUTC, UTC time and date
+#define UBX_ID_NAV_TIMEUTC (0x21u)
+/// ID of CFG-PRT, port configuration
+#define UBX_ID_CFG_PRT (0x00u)
+/// ID of CFG-MSG, message rate
+#define UBX_ID_CFG_MSG (0x01u)
+/// ID of CFG-RATE, measurement rate
+#define UBX_ID_CFG_RATE (0x08u)
+/// Payload length of NAV-POSLLH
+#define UBX_NAV_POSLLH_LENGTH (28u)
+/// Payload length of NAV-SOL
+#define UBX_NAV_SOL_LENGTH (52u)
+/// Payload length of NAV-TIMEUTC
+#define UBX_NAV_TIMEUTC_LENGTH (20u)
+
+/// Function type of decoders called for valid frames
+typedef void (*t_UBX_Decoder)(const uint8_t *p_Payload);
+
+/// Structure used as an element of the dispatch table
+typedef struct {
+  uint8_t       u_Class;    ///< Class of the frame
+  uint8_t       u_Id;       ///< ID of the frame
+  uint16_t      u_Length;   ///< Payload length, a frame of another length is not decoded
+  t_UBX_Decoder p_Decoder;  ///< Function called with the payload
+} t_UBX_Handler;
+
+/// Structure used as an element of the start up sequence
+typedef struct {
+  uint8_t         u_Class;    ///< Class of the message
+  uint8_t         u_Id;       ///< ID of the message
+  const uint8_t * p_Payload;  ///< Payload in little endian order
+  uint16_t        u_Length;   ///< Payload length
+} t_UBX_Command;
+
+/// Structure used for framer statistics
+typedef struct {
+  uint32_t u_Frames;         ///< Frames with a correct checksum
+  uint32_t u_Dispatched;     ///< Correct frames which had a decoder in the dispatch table
+  uint32_t u_ChecksumErrors; ///< Frames rejected because of a wrong checksum
+  uint32_t u_FramingErrors;  ///< Frames rejected because of a length above UBX_MAX_PAYLOAD_LENGTH
+  uint32_t u_DroppedBytes;   ///< Bytes dropped outside of frames
+} t_UBX_Statistics;
+
+/// @brief Function used to switch the GPS module to UBX output
+///
+/// @pre Called from TSK_Com before its loop, UARTM_v_Uart2Config must be done
+/// @post UBX_b_IsActive returns b_TRUE, USART2 runs at UBX_BAUD_RATE
+/// @param None
+///
+/// @return None
+///
+/// @globals UBX_b_Active, UBX_b_Confirmed, UBX_t_ConfirmDeadline
+///
+/// @InOutCorelation Messages of UBX_t_Startup are sent at the default baud rate, CFG-PRT last since it changes the
+///                  rate. After UBX_SETTLE_MS USART2 follows the module and the GPS channel wakes TSK_Com by count
+///                  and stores every byte, since binary frames have no end byte and no address field.
+/// @callsequence
+///   @startuml "UBX_v_Start.png"
+///     title "Sequence diagram for function UBX_v_Start"
+///     -> UBX: UBX_v_Start()
+///     UBX++
+///       loop for each message of UBX_t_Startup
+///         UBX -> UBX: v_Send(...)
+///       end
+///       UBX -> FreeRTOS: vTaskDelay(UBX_SETTLE_MS)
+///       UBX -> UARTM: UARTM2_v_SetBaudRate(UBX_BAUD_RATE)
+///       UBX -> MSGM: MSGM_v_SetNotifyThreshold(RING_BUFFER1, UBX_NOTIFY_THRESHOLD)
+///       UBX -> MSGM: MSGM_v_SetAdmission(RING_BUFFER1, NULL)
+///       UBX -> TIMEB: TIMEB_t_DeadlineInUs(UBX_CONFIRM_MS * 1000)
+///     <- UBX
+///     UBX--
+///   @enduml
+void UBX_v_Start(void);
+
+/// @brief Function used to check which framer reads the GPS channel
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return boolean b_TRUE while UBX frames are expected
+///
+/// @globals UBX_b_Active
+///
+/// @InOutCorelation None
+/// @callsequence
+///   @startuml "UBX_b_IsActive.png"
+///     title "Sequence diagram for function UBX_b_IsActive"
+///     -> UBX: UBX_b_IsActive()
+///     UBX++
+///     <- UBX: Returns UBX_b_Active
+///     UBX--
+///   @enduml
+boolean UBX_b_IsActive(void);
+
+/// @brief Function used to frame, validate and dispatch all complete frames stored in a ring buffer
+///
+/// @pre Ring buffer is written by the GPS receive interrupt, this function is its only reader
+/// @post Complete frames are consumed, an incomplete one stays in the ring buffer until more data arrives
+/// @param t_RINGB_Ring *p_Ring
+///
+/// @return None
+///
+/// @globals UBX_t_Statistics, UBX_a_Payload, UBX_b_Confirmed
+///
+/// @InOutCorelation A frame is taken only when all of its bytes are stored. The checksum is computed while the
+///                  payload is copied into an aligned buffer, the decoder is selected by class, ID and length. When
+///                  no frame was valid before the confirmation deadline NMEA is used again.
+/// @callsequence
+///   @startuml "UBX_v_Process.png"
+///     title "Sequence diagram for function UBX_v_Process"
+///     -> UBX: UBX_v_Process(...)
+///     UBX++
+///     loop while a header is stored
+///       opt if sync characters are missing
+///         rnote over UBX: Drop one byte
+///       else else whole frame is stored
+///         UBX -> RINGB: RINGB_u_PeekAt(...)
+///         rnote over UBX: Copy the payload, compute CK_A and CK_B
+///         opt if checksum matches
+///           UBX -> UBX: p_Decoder(...) from UBX_t_Handlers
+///         end
+///         UBX -> RINGB: RINGB_u_Skip(...)
+///       end
+///     end
+///     opt if not confirmed and deadline expired
+///       UBX -> UBX: v_Fallback()
+///     end
+///     <- UBX
+///     UBX--
+///   @enduml
+void UBX_v_Process(t_RINGB_Ring *p_Ring);
+
+/// @brief Decoders called from the dispatch table for NAV-SOL, NAV-TIMEUTC and NAV-POSLLH
+///
+/// @pre Frame checksum and length must be valid
+/// @post NAV-SOL and NAV-TIMEUTC update t_NMEA_Info, NAV-POSLLH of a valid fix is published as MSGM_FIX_OWN and
+///       handed to FIXLOG
+/// @param const uint8_t *p_Payload
+///
+/// @return None
+///
+/// @globals t_NMEA_Info, MSGM_a_Fixes
+///
+/// @InOutCorelation Fields are read at fixed offsets. UTC time and date are taken from NAV-TIMEUTC once the receiver
+///                  knows the leap seconds, so they stay right when a leap second is added. The position is
+///                  rounded to micro-degrees for the fix record, FIXLOG logs the same record with both protocols.
+/// @callsequence
+///   @startuml "UBX_v_Decode.png"
+///     title "Sequence diagram for UBX decoders"
+///     -> UBX: UBX_v_DecodeNavSol/NavTimeUtc/NavPosllh(...)
+///     UBX++
+///       UBX -> NMEA: NMEA_p_GetInfo()
+///       opt if NAV-POSLLH and fix is valid
+///         UBX -> MSGM: MSGM_v_PublishFix(MSGM_FIX_OWN, ...)
+///         UBX -> FIXLOG: FIXLOG_v_Record(...)
+///       end
+///     <- UBX
+///     UBX--
+///   @enduml
+void UBX_v_DecodeNavSol(const uint8_t *p_Payload);
+void UBX_v_DecodeNavTimeUtc(const uint8_t *p_Payload);
+void UBX_v_DecodeNavPosllh(const uint8_t *p_Payload);
+
+/// @brief Function used to get the framer statistics
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return t_UBX_Statistics * pointer to the statistics
+///
+/// @globals UBX_t_Statistics
+///
+/// @InOutCorelation None
+/// @callsequence
+///   @startuml "UBX_p_GetStatistics.png"
+///     title "Sequence diagram for function UBX_p_GetStatistics"
+///     -> UBX: UBX_p_GetStatistics()
+///     UBX++
+///     <- UBX: Returns &UBX_t_Statistics
+///     UBX--
+///   @enduml
+t_UBX_Statistics * UBX_p_GetStatistics(void);
+
+#endif /* UBX_H_ */
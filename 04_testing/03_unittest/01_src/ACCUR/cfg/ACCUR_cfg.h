@@ -0,0 +1,25 @@
+/// @file ACCUR_cfg.h
+/// @brief Contains configuration data used for the bearing accuracy test of the host build
+/// @author Aleksandra Petrovic
+
+#ifndef ACCUR_CFG_H_
+#define ACCUR_CFG_H_
+
+#include "CALCM.h"
+
+/// Default distance between two grid points on each axis in micro-degrees
+#define ACCUR_DEFAULT_STEP (1000000)
+/// Smallest distance between two grid points in micro-degrees, about 2 * 10^8 points at 0.25 degrees
+#define ACCUR_MIN_STEP (250000)
+/// Shift of the grid in micro-degrees, so points are not only whole degrees and the poles are left out
+#define ACCUR_GRID_OFFSET (12345)
+/// Largest distance in longitude CALCM_u_CalculateBearing passes to the kernels, in micro-degrees
+#define ACCUR_MAX_DISTANCE (360000000)
+/// Default largest accepted error of the FLOAT and Q31 kernels in degrees, the bearing is used in whole degrees
+#define ACCUR_DEFAULT_LIMIT (0.0019)
+/// Length of the reference bearing vector below which the bearing is not defined (points closer than about 6 km)
+#define ACCUR_MIN_LENGTH (0.001)
+/// Number of measured kernels
+#define ACCUR_KERNEL_COUNT (3u)
+
+#endif /* ACCUR_CFG_H_ */
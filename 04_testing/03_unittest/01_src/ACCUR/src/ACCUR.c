@@ -0,0 +1,317 @@
+/// @file ACCUR.c
+/// @brief Main file used for the bearing accuracy test of the host build
+/// @author Aleksandra Petrovic
+
+#include "ACCUR.h"
+#include "ACCUR_cfg.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+/// Results of one kernel
+typedef struct {
+  const char     *p_Name;         ///< Name printed in the report
+  uint8_t         u_Kernel;       ///< CALCM_KERNEL_DOUBLE, CALCM_KERNEL_FLOAT or CALCM_KERNEL_Q31
+  double          f_Worst;        ///< Largest error against the DOUBLE kernel in degrees
+  int32_t         a_Worst[3];     ///< Grid point of the largest error in micro-degrees
+  uint64_t        u_OffByOne;     ///< Points whose whole-degree bearing differs from the DOUBLE kernel
+  uint64_t        u_TimeNs;       ///< Host time of all calls over the grid
+  uint64_t        u_Cycles;       ///< Time stamp counter ticks of all calls over the grid, 0 when not available
+} t_ACCUR_Kernel;
+
+/// Measured kernels, the DOUBLE kernel is the reference and comes first
+static t_ACCUR_Kernel ACCUR_a_Kernel[ACCUR_KERNEL_COUNT] = {
+  { "double", CALCM_KERNEL_DOUBLE, 0.0, {0, 0, 0}, 0u, 0u, 0u },
+  { "float",  CALCM_KERNEL_FLOAT,  0.0, {0, 0, 0}, 0u, 0u, 0u },
+  { "q31",    CALCM_KERNEL_Q31,    0.0, {0, 0, 0}, 0u, 0u, 0u }
+};
+
+/// Sum of all timed bearings, keeps the compiler from removing the calls
+static volatile double ACCUR_f_Sink = 0.0;
+
+/// @brief Function used for reading the host clock
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return uint64_t monotonic time in ns
+///
+/// @globals None
+///
+/// @InOutCorelation Function reads CLOCK_MONOTONIC for the time per call.
+/// @callsequence
+///   @startuml "u_NowNs.png"
+///     title "Sequence diagram for function u_NowNs"
+///     -> ACCUR: u_NowNs()
+///     ACCUR++
+///       ACCUR -> Linux: clock_gettime(CLOCK_MONOTONIC)
+///     <- ACCUR: Returns time
+///     ACCUR--
+///   @enduml
+
+static uint64_t u_NowNs(void);
+
+static uint64_t u_NowNs(void)
+{
+  struct timespec t_Time;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &t_Time);
+  return ((uint64_t)t_Time.tv_sec * 1000000000ULL) + (uint64_t)t_Time.tv_nsec;
+}
+
+/// @brief Function used for reading the cycle counter of the host
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return uint64_t time stamp counter, 0 on hosts without one
+///
+/// @globals None
+///
+/// @InOutCorelation Function reads the x86 time stamp counter, which counts at the nominal core clock.
+/// @callsequence
+///   @startuml "u_NowCycles.png"
+///     title "Sequence diagram for function u_NowCycles"
+///     -> ACCUR: u_NowCycles()
+///     ACCUR++
+///     <- ACCUR: Returns cycles
+///     ACCUR--
+///   @enduml
+
+static uint64_t u_NowCycles(void);
+
+static uint64_t u_NowCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  // x86intrin.h cannot be included after the CMSIS headers, which define __I
+  return (uint64_t)__builtin_ia32_rdtsc();
+#else
+  return 0u;
+#endif
+}
+
+/// @brief Function used for the whole-degree bearing CALCM_u_CalculateBearing returns
+///
+/// @pre None
+/// @post None
+/// @param double f_Bearing bearing in degrees in [-180, 180]
+///
+/// @return uint16_t bearing in [0, 360)
+///
+/// @globals None
+///
+/// @InOutCorelation Negative bearing is moved to the same direction in [0, 360) and the fraction is cut off.
+/// @callsequence
+///   @startuml "u_WholeDegrees.png"
+///     title "Sequence diagram for function u_WholeDegrees"
+///     -> ACCUR: u_WholeDegrees(double f_Bearing)
+///     ACCUR++
+///     <- ACCUR: Returns bearing
+///     ACCUR--
+///   @enduml
+
+static uint16_t u_WholeDegrees(double f_Bearing);
+
+static uint16_t u_WholeDegrees(double f_Bearing)
+{
+  if(f_Bearing < 0.0)
+  {
+    f_Bearing += FULL_CIRCLE;
+  }
+  return (uint16_t)((uint16_t)f_Bearing % FULL_CIRCLE);
+}
+
+/// @brief Function used for checking if the bearing of a grid point is defined
+///
+/// @pre None
+/// @post None
+/// @param int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance in micro-degrees
+///
+/// @return uint8_t 1 when the bearing vector is long enough for a direction
+///
+/// @globals None
+///
+/// @InOutCorelation Both points close together or a starting point close to a pole leave a vector of rounding
+///                  errors, whose direction no kernel can get right.
+/// @callsequence
+///   @startuml "u_IsDefined.png"
+///     title "Sequence diagram for function u_IsDefined"
+///     -> ACCUR: u_IsDefined(...)
+///     ACCUR++
+///     <- ACCUR: Returns uint8_t
+///     ACCUR--
+///   @enduml
+
+static uint8_t u_IsDefined(int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance);
+
+static uint8_t u_IsDefined(int32_t i_StartingLatitude, int32_t i_CarLatitude, int32_t i_Distance)
+{
+  double f_Start = RADIANS_CONVERTOR((double)i_StartingLatitude / CALCM_MICRODEGREES);
+  double f_Car = RADIANS_CONVERTOR((double)i_CarLatitude / CALCM_MICRODEGREES);
+  double f_Distance = RADIANS_CONVERTOR((double)i_Distance / CALCM_MICRODEGREES);
+  double f_x = cos(f_Start) * sin(f_Distance);
+  double f_y = cos(f_Car) * sin(f_Start) - sin(f_Car) * cos(f_Start) * cos(f_Distance);
+
+  return (hypot(f_x, f_y) >= ACCUR_MIN_LENGTH) ? 1u : 0u;
+}
+
+/// @brief Function used for timing one kernel over the grid
+///
+/// @pre None
+/// @post u_TimeNs and u_Cycles of the kernel are set
+/// @param t_ACCUR_Kernel *p_Kernel, int32_t i_Step grid step in micro-degrees
+///
+/// @return uint64_t number of calls
+///
+/// @globals ACCUR_f_Sink
+///
+/// @InOutCorelation Function calls the kernel for every grid point, defined or not, without any other work in the loop.
+/// @callsequence
+///   @startuml "u_Time.png"
+///     title "Sequence diagram for function u_Time"
+///     -> ACCUR: u_Time(t_ACCUR_Kernel *p_Kernel, int32_t i_Step)
+///     ACCUR++
+///       ACCUR -> ACCUR: u_NowNs(), u_NowCycles()
+///       loop for each grid point
+///         ACCUR -> CALCM: CALCM_d_BearingKernel(p_Kernel -> u_Kernel, ...)
+///       end
+///       ACCUR -> ACCUR: u_NowNs(), u_NowCycles()
+///     <- ACCUR: Returns calls
+///     ACCUR--
+///   @enduml
+
+static uint64_t u_Time(t_ACCUR_Kernel *p_Kernel, int32_t i_Step);
+
+static uint64_t u_Time(t_ACCUR_Kernel *p_Kernel, int32_t i_Step)
+{
+  uint64_t u_Calls = 0u;
+  double f_Sum = 0.0;
+  uint64_t u_StartNs = u_NowNs();
+  uint64_t u_StartCycles = u_NowCycles();
+
+  for(int32_t i_Start = (LATITUDE_LOW_RANGE * (int32_t)CALCM_MICRODEGREES) + ACCUR_GRID_OFFSET;
+      i_Start < (LATITUDE_HIGH_RANGE * (int32_t)CALCM_MICRODEGREES); i_Start += i_Step)
+  {
+    for(int32_t i_Car = (LATITUDE_LOW_RANGE * (int32_t)CALCM_MICRODEGREES) + ACCUR_GRID_OFFSET;
+        i_Car < (LATITUDE_HIGH_RANGE * (int32_t)CALCM_MICRODEGREES); i_Car += i_Step)
+    {
+      for(int32_t i_Distance = ACCUR_GRID_OFFSET; i_Distance < ACCUR_MAX_DISTANCE; i_Distance += i_Step)
+      {
+        f_Sum += CALCM_d_BearingKernel(p_Kernel -> u_Kernel, i_Start, i_Car, i_Distance);
+        u_Calls++;
+      }
+    }
+  }
+  p_Kernel -> u_Cycles = u_NowCycles() - u_StartCycles;
+  p_Kernel -> u_TimeNs = u_NowNs() - u_StartNs;
+  ACCUR_f_Sink += f_Sum;
+  return u_Calls;
+}
+
+int ACCUR_i_Run(int i_Argc, char **p_Argv)
+{
+  int32_t i_Step = ACCUR_DEFAULT_STEP;
+  double f_Limit = ACCUR_DEFAULT_LIMIT;
+  uint64_t u_Points = 0u;
+  uint64_t u_Undefined = 0u;
+  uint8_t u_Passed = 1u;
+  int i_Option = 0;
+
+  optind = 1;
+  while((i_Option = getopt(i_Argc, p_Argv, "s:l:")) != -1)
+  {
+    switch(i_Option)
+    {
+    case 's':
+      i_Step = (int32_t)strtol(optarg, NULL, 0);
+      break;
+    case 'l':
+      f_Limit = strtod(optarg, NULL);
+      break;
+    default:
+      fprintf(stderr, "usage: accur [-s grid step in micro-degrees] [-l largest error in degrees]\n");
+      return 1;
+    }
+  }
+  if(i_Step < ACCUR_MIN_STEP)
+  {
+    fprintf(stderr, "accur: -s must be at least %d micro-degrees\n", ACCUR_MIN_STEP);
+    return 1;
+  }
+
+  // Error pass, every kernel is compared with the DOUBLE kernel at the same point
+  for(int32_t i_Start = (LATITUDE_LOW_RANGE * (int32_t)CALCM_MICRODEGREES) + ACCUR_GRID_OFFSET;
+      i_Start < (LATITUDE_HIGH_RANGE * (int32_t)CALCM_MICRODEGREES); i_Start += i_Step)
+  {
+    for(int32_t i_Car = (LATITUDE_LOW_RANGE * (int32_t)CALCM_MICRODEGREES) + ACCUR_GRID_OFFSET;
+        i_Car < (LATITUDE_HIGH_RANGE * (int32_t)CALCM_MICRODEGREES); i_Car += i_Step)
+    {
+      for(int32_t i_Distance = ACCUR_GRID_OFFSET; i_Distance < ACCUR_MAX_DISTANCE; i_Distance += i_Step)
+      {
+        u_Points++;
+        if(u_IsDefined(i_Start, i_Car, i_Distance) == 0u)
+        {
+          u_Undefined++;
+          continue;
+        }
+        double f_Reference = CALCM_d_BearingKernel(ACCUR_a_Kernel[0].u_Kernel, i_Start, i_Car, i_Distance);
+
+        for(uint32_t u_Cnt = 1u; u_Cnt < ACCUR_KERNEL_COUNT; u_Cnt++)
+        {
+          t_ACCUR_Kernel *p_Kernel = &ACCUR_a_Kernel[u_Cnt];
+          double f_Bearing = CALCM_d_BearingKernel(p_Kernel -> u_Kernel, i_Start, i_Car, i_Distance);
+          double f_Error = fabs(f_Bearing - f_Reference);
+
+          // -180 and 180 degrees are the same direction
+          if(f_Error > (FULL_CIRCLE / 2))
+          {
+            f_Error = FULL_CIRCLE - f_Error;
+          }
+          if(f_Error > p_Kernel -> f_Worst)
+          {
+            p_Kernel -> f_Worst = f_Error;
+            p_Kernel -> a_Worst[0] = i_Start;
+            p_Kernel -> a_Worst[1] = i_Car;
+            p_Kernel -> a_Worst[2] = i_Distance;
+          }
+          if(u_WholeDegrees(f_Bearing) != u_WholeDegrees(f_Reference))
+          {
+            p_Kernel -> u_OffByOne++;
+          }
+        }
+      }
+    }
+  }
+  for(uint32_t u_Cnt = 0u; u_Cnt < ACCUR_KERNEL_COUNT; u_Cnt++)
+  {
+    (void)u_Time(&ACCUR_a_Kernel[u_Cnt], i_Step);
+  }
+
+  printf("grid                step %.6f deg, %llu points, %llu without a defined bearing\n",
+         (double)i_Step / CALCM_MICRODEGREES, (unsigned long long)u_Points, (unsigned long long)u_Undefined);
+  for(uint32_t u_Cnt = 0u; u_Cnt < ACCUR_KERNEL_COUNT; u_Cnt++)
+  {
+    t_ACCUR_Kernel *p_Kernel = &ACCUR_a_Kernel[u_Cnt];
+
+    if(u_Cnt == 0u)
+    {
+      printf("%-8s reference, %.1f ns/call, %.1f cycles/call\n", p_Kernel -> p_Name,
+             (double)p_Kernel -> u_TimeNs / (double)u_Points, (double)p_Kernel -> u_Cycles / (double)u_Points);
+      continue;
+    }
+    printf("%-8s worst %.6f deg at (%.6f, %.6f, %.6f), %llu whole degrees differ, %.1f ns/call, %.1f cycles/call\n",
+           p_Kernel -> p_Name, p_Kernel -> f_Worst, (double)p_Kernel -> a_Worst[0] / CALCM_MICRODEGREES,
+           (double)p_Kernel -> a_Worst[1] / CALCM_MICRODEGREES, (double)p_Kernel -> a_Worst[2] / CALCM_MICRODEGREES,
+           (unsigned long long)p_Kernel -> u_OffByOne, (double)p_Kernel -> u_TimeNs / (double)u_Points,
+           (double)p_Kernel -> u_Cycles / (double)u_Points);
+    if(p_Kernel -> f_Worst > f_Limit)
+    {
+      u_Passed = 0u;
+    }
+  }
+  printf("%s worst case error within %.6f deg\n", (u_Passed == 1u) ? "PASS" : "FAIL", f_Limit);
+  return (u_Passed == 1u) ? 0 : 1;
+}
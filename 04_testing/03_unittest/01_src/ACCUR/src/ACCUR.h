@@ -0,0 +1,47 @@
+/// @file ACCUR.h
+/// @brief Header file used for the bearing accuracy test of the host build
+/// @author Aleksandra Petrovic
+///
+/// The DOUBLE, FLOAT and Q31 bearing kernels of CALCM are called for every point of a global grid of starting
+/// latitude, target latitude and distance in longitude, with the arguments converted from micro-degrees as
+/// CALCM_u_CalculateBearing converts them. The worst case error of the FLOAT and Q31 kernels against the DOUBLE
+/// kernel and the number of points whose whole-degree bearing differs are reported, then each kernel is timed over
+/// the grid. Time per call is given in ns and in cycles of the time stamp counter on x86 hosts; cycles on the
+/// target need a run on the STM32F439.
+
+#ifndef ACCUR_H_
+#define ACCUR_H_
+
+/// @brief Function used for running the accuracy test from the command line of the host binary
+///
+/// @pre None
+/// @post Results are printed
+/// @param int i_Argc, char **p_Argv options after "accur":
+///        -s grid step in micro-degrees, -l largest accepted error in degrees
+///
+/// @return int 0 when the FLOAT and Q31 kernels are within the limit, 1 otherwise or for wrong options
+///
+/// @globals ACCUR_a_Kernel
+///
+/// @InOutCorelation Function walks the grid once for the errors and once per kernel for the time.
+/// @callsequence
+///   @startuml "ACCUR_i_Run.png"
+///     title "Sequence diagram for function ACCUR_i_Run"
+///     -> ACCUR: ACCUR_i_Run(int i_Argc, char **p_Argv)
+///     ACCUR++
+///       loop for each grid point
+///         ACCUR -> CALCM: CALCM_d_BearingKernel(CALCM_KERNEL_DOUBLE, ...)
+///         ACCUR -> CALCM: CALCM_d_BearingKernel(CALCM_KERNEL_FLOAT, ...)
+///         ACCUR -> CALCM: CALCM_d_BearingKernel(CALCM_KERNEL_Q31, ...)
+///       end
+///       loop for each kernel
+///         ACCUR -> ACCUR: u_Time(...)
+///       end
+///       ACCUR -> Linux: printf()
+///     <- ACCUR: Returns status
+///     ACCUR--
+///   @enduml
+
+int ACCUR_i_Run(int i_Argc, char **p_Argv);
+
+#endif /* ACCUR_H_ */
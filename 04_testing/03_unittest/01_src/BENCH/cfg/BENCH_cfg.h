@@ -0,0 +1,38 @@
+/// @file BENCH_cfg.h
+/// @brief Contains configuration data used for the NMEA replay benchmark of the host build
+/// @author Aleksandra Petrovic
+
+#ifndef BENCH_CFG_H_
+#define BENCH_CFG_H_
+
+#include "main.h"
+#include "MSGM.h"
+
+/// Default byte rate of the GPS line, NEO-6M sends at 9600 baud (10 bits per byte)
+#define BENCH_DEFAULT_RATE (960u)
+/// Default length of the synthetic log in seconds, NEO-6M sends one burst of sentences per second
+#define BENCH_DEFAULT_SECONDS (600u)
+/// Default time TSK_Com needs to start running after it was notified, in us
+#define BENCH_DEFAULT_WAKE_US (0u)
+/// Default number of times the log is replayed
+#define BENCH_DEFAULT_REPEAT (1u)
+/// Period after which TSK_Com runs without a notification, in us
+#define BENCH_CONSUMER_PERIOD_US ((uint64_t)PERIOD_TSK_COM * 1000u)
+/// Number of stored bytes after which the receive interrupt notifies TSK_Com
+#define BENCH_NOTIFY_THRESHOLD (MSGM_GPS_NOTIFY_THRESHOLD)
+/// Character at which the receive interrupt notifies TSK_Com
+#define BENCH_SENTENCE_END (MSGM_SENTENCE_END)
+
+/// Number of latency samples kept for the percentiles, later samples are counted but not stored
+#define BENCH_LATENCY_SAMPLES (1u << 20u)
+/// Length of one synthetic sentence including '$', checksum and CR LF
+#define BENCH_SENTENCE_LENGTH (96u)
+
+/// Latitude of the first synthetic fix in micro-minutes (44 deg 48.000000 min N)
+#define BENCH_START_LATITUDE (2688000000LL)
+/// Longitude of the first synthetic fix in micro-minutes (20 deg 27.000000 min E)
+#define BENCH_START_LONGITUDE (1227000000LL)
+/// Movement of the synthetic fix per second in micro-minutes, about 20 m
+#define BENCH_STEP (10800LL)
+
+#endif /* BENCH_CFG_H_ */
@@ -0,0 +1,595 @@
+/// @file BENCH.c
+/// @brief Main file used for the NMEA replay benchmark of the MSGM to CALCM pipeline
+/// @author Aleksandra Petrovic
+
+#include "BENCH.h"
+#include "BENCH_cfg.h"
+#include "MSGM.h"
+#include "NMEA.h"
+#include "CALCM.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+/// Options of a benchmark run
+typedef struct {
+  const char *p_Log;        ///< Log file, NULL for the synthetic log
+  const char *p_Json;       ///< JSON results file, NULL when not written
+  uint32_t    u_Seconds;    ///< Length of the synthetic log in seconds
+  uint32_t    u_Rate;       ///< Byte rate of the GPS line, 0 when the bytes arrive back to back
+  uint32_t    u_WakeUs;     ///< Time TSK_Com needs to start running after it was notified
+  uint32_t    u_Repeat;     ///< Number of replays of the log
+  uint32_t    u_AdmitAll;   ///< 1 when the ingress filter of the GPS channel is turned off
+} t_BENCH_Options;
+
+/// Result of the last run
+static t_BENCH_Result BENCH_t_Result;
+/// Parse-to-bearing latencies of the run in ns
+static uint64_t BENCH_a_Latency[BENCH_LATENCY_SAMPLES];
+/// Number of latency samples, can be above BENCH_LATENCY_SAMPLES
+static uint64_t BENCH_u_LatencyCount = 0u;
+
+/// @brief Function used for reading the host clock
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return uint64_t monotonic time in ns
+///
+/// @globals None
+///
+/// @InOutCorelation Function reads CLOCK_MONOTONIC, processing time is measured on the host and not simulated.
+/// @callsequence
+///   @startuml "u_NowNs.png"
+///     title "Sequence diagram for function u_NowNs"
+///     -> BENCH: u_NowNs()
+///     BENCH++
+///       BENCH -> Linux: clock_gettime(CLOCK_MONOTONIC)
+///     <- BENCH: Returns time
+///     BENCH--
+///   @enduml
+
+static uint64_t u_NowNs(void);
+
+static uint64_t u_NowNs(void)
+{
+  struct timespec t_Time;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &t_Time);
+  return ((uint64_t)t_Time.tv_sec * 1000000000ULL) + (uint64_t)t_Time.tv_nsec;
+}
+
+/// @brief Function used for appending one sentence with its checksum to the synthetic log
+///
+/// @pre p_Body is the text between '$' and '*'
+/// @post Sentence and CR LF are written at p_Log[u_Length]
+/// @param uint8_t *p_Log, uint32_t u_Length, const char *p_Body
+///
+/// @return uint32_t length of the log after the sentence
+///
+/// @globals None
+///
+/// @InOutCorelation Function XORs the body into the checksum the way NEO-6M does and frames the sentence.
+/// @callsequence
+///   @startuml "u_AppendSentence.png"
+///     title "Sequence diagram for function u_AppendSentence"
+///     -> BENCH: u_AppendSentence(uint8_t *p_Log, uint32_t u_Length, const char *p_Body)
+///     BENCH++
+///       loop for each character of the body
+///         rnote over BENCH: XOR the character into the checksum
+///       end
+///       rnote over BENCH: Write $body*checksum CR LF
+///     <- BENCH: Returns new length
+///     BENCH--
+///   @enduml
+
+static uint32_t u_AppendSentence(uint8_t *p_Log, uint32_t u_Length, const char *p_Body);
+
+static uint32_t u_AppendSentence(uint8_t *p_Log, uint32_t u_Length, const char *p_Body)
+{
+  uint8_t u_Checksum = 0u;
+
+  for(const char *p_Char = p_Body; *p_Char != '\0'; p_Char++)
+  {
+    u_Checksum ^= (uint8_t)*p_Char;
+  }
+  return u_Length + (uint32_t)snprintf((char *)&p_Log[u_Length], BENCH_SENTENCE_LENGTH, "$%s*%02X\r\n", p_Body,
+                                       (unsigned int)u_Checksum);
+}
+
+/// @brief Function used for generating a synthetic NEO-6M log
+///
+/// @pre p_Log has room for BENCH_SENTENCE_LENGTH bytes per sentence
+/// @post Log holds u_Seconds bursts of RMC, VTG, GGA, GSA, three GSV and GLL
+/// @param uint8_t *p_Log, uint32_t u_Seconds
+///
+/// @return uint32_t length of the log
+///
+/// @globals None
+///
+/// @InOutCorelation Every burst is what NEO-6M sends each second with its default configuration, the position moves
+///                  north east by BENCH_STEP per second so every fix is different.
+/// @callsequence
+///   @startuml "u_Synthesize.png"
+///     title "Sequence diagram for function u_Synthesize"
+///     -> BENCH: u_Synthesize(uint8_t *p_Log, uint32_t u_Seconds)
+///     BENCH++
+///       loop for each second
+///         rnote over BENCH: Format time and position
+///         BENCH -> BENCH: u_AppendSentence(...) for each sentence of the burst
+///       end
+///     <- BENCH: Returns length
+///     BENCH--
+///   @enduml
+
+static uint32_t u_Synthesize(uint8_t *p_Log, uint32_t u_Seconds);
+
+static uint32_t u_Synthesize(uint8_t *p_Log, uint32_t u_Seconds)
+{
+  char a_Body[BENCH_SENTENCE_LENGTH];
+  char a_Latitude[16u];
+  char a_Longitude[16u];
+  char a_Time[16u];
+  uint32_t u_Length = 0u;
+
+  for(uint32_t u_Second = 0u; u_Second < u_Seconds; u_Second++)
+  {
+    int64_t i_Latitude = BENCH_START_LATITUDE + ((int64_t)u_Second * BENCH_STEP);
+    int64_t i_Longitude = BENCH_START_LONGITUDE + ((int64_t)u_Second * BENCH_STEP);
+    uint32_t u_Clock = (12u * 3600u) + u_Second;
+
+    // ddmm.mmmmm and dddmm.mmmmm, micro-minutes are cut to the five decimals NEO-6M sends
+    (void)snprintf(a_Latitude, sizeof(a_Latitude), "%02u%02u.%05u", (unsigned int)(i_Latitude / 60000000LL),
+                   (unsigned int)((i_Latitude % 60000000LL) / 1000000LL), (unsigned int)((i_Latitude % 1000000LL) / 10LL));
+    (void)snprintf(a_Longitude, sizeof(a_Longitude), "%03u%02u.%05u", (unsigned int)(i_Longitude / 60000000LL),
+                   (unsigned int)((i_Longitude % 60000000LL) / 1000000LL), (unsigned int)((i_Longitude % 1000000LL) / 10LL));
+    (void)snprintf(a_Time, sizeof(a_Time), "%02u%02u%02u.00", (unsigned int)((u_Clock / 3600u) % 24u),
+                   (unsigned int)((u_Clock / 60u) % 60u), (unsigned int)(u_Clock % 60u));
+
+    (void)snprintf(a_Body, sizeof(a_Body), "GPRMC,%s,A,%s,N,%s,E,0.052,45.00,161026,,,A", a_Time, a_Latitude, a_Longitude);
+    u_Length = u_AppendSentence(p_Log, u_Length, a_Body);
+    u_Length = u_AppendSentence(p_Log, u_Length, "GPVTG,45.00,T,,M,0.052,N,0.096,K,A");
+    (void)snprintf(a_Body, sizeof(a_Body), "GPGGA,%s,%s,N,%s,E,1,08,1.01,117.2,M,40.1,M,,", a_Time, a_Latitude, a_Longitude);
+    u_Length = u_AppendSentence(p_Log, u_Length, a_Body);
+    u_Length = u_AppendSentence(p_Log, u_Length, "GPGSA,A,3,10,07,05,02,29,04,08,13,,,,,1.72,1.01,1.38");
+    u_Length = u_AppendSentence(p_Log, u_Length, "GPGSV,3,1,11,10,63,137,17,07,61,098,15,05,59,290,20,08,54,157,30");
+    u_Length = u_AppendSentence(p_Log, u_Length, "GPGSV,3,2,11,02,39,223,19,13,28,070,17,26,23,252,,04,14,186,14");
+    u_Length = u_AppendSentence(p_Log, u_Length, "GPGSV,3,3,11,29,09,301,24,16,09,020,,36,,,");
+    (void)snprintf(a_Body, sizeof(a_Body), "GPGLL,%s,N,%s,E,%s,A,A", a_Latitude, a_Longitude, a_Time);
+    u_Length = u_AppendSentence(p_Log, u_Length, a_Body);
+  }
+  return u_Length;
+}
+
+/// @brief Function used for reading a recorded log
+///
+/// @pre None
+/// @post *p_Length holds the length of the log
+/// @param const char *p_Path, uint32_t *p_Length
+///
+/// @return uint8_t * log allocated on the heap, NULL when the file cannot be read
+///
+/// @globals None
+///
+/// @InOutCorelation Function reads the whole file, bytes are replayed exactly as they were recorded.
+/// @callsequence
+///   @startuml "p_ReadLog.png"
+///     title "Sequence diagram for function p_ReadLog"
+///     -> BENCH: p_ReadLog(const char *p_Path, uint32_t *p_Length)
+///     BENCH++
+///       BENCH -> Linux: fopen(), fread(), fclose()
+///     <- BENCH: Returns log
+///     BENCH--
+///   @enduml
+
+static uint8_t * p_ReadLog(const char *p_Path, uint32_t *p_Length);
+
+static uint8_t * p_ReadLog(const char *p_Path, uint32_t *p_Length)
+{
+  FILE *p_File = fopen(p_Path, "rb");
+  uint8_t *p_Log = NULL;
+  long i_Size = 0;
+
+  if(p_File == NULL)
+  {
+    return NULL;
+  }
+  if((fseek(p_File, 0, SEEK_END) == 0) && ((i_Size = ftell(p_File)) > 0) && (fseek(p_File, 0, SEEK_SET) == 0))
+  {
+    p_Log = malloc((size_t)i_Size);
+    if((p_Log != NULL) && (fread(p_Log, 1u, (size_t)i_Size, p_File) != (size_t)i_Size))
+    {
+      free(p_Log);
+      p_Log = NULL;
+    }
+  }
+  (void)fclose(p_File);
+  *p_Length = (uint32_t)i_Size;
+  return p_Log;
+}
+
+/// @brief Function used for one run of TSK_Com followed by the bearing calculation
+///
+/// @pre Bytes due until now are pushed into RING_BUFFER1
+/// @post Complete sentences are consumed, a latency sample is stored when a bearing was calculated
+/// @param None
+///
+/// @return None
+///
+/// @globals BENCH_t_Result, BENCH_a_Latency, BENCH_u_LatencyCount
+///
+/// @InOutCorelation Function measures the host time of MSGM_v_StateMachine and, when a sentence was dispatched and a
+///                  position is known, of setting the position as the target the way SIM does and of
+///                  CALCM_u_CalculateBearing.
+/// @callsequence
+///   @startuml "v_Consume.png"
+///     title "Sequence diagram for function v_Consume"
+///     -> BENCH: v_Consume()
+///     BENCH++
+///       BENCH -> MSGM: MSGM_v_StateMachine()
+///       opt if a sentence was dispatched and the position is known
+///         BENCH -> MSGM: MSGM_b_ReadFix(MSGM_FIX_OWN, ...)
+///         BENCH -> CALCM: CALCM_u_FormatPosition(...)
+///         BENCH -> CALCM: CALCM_e_SetTarget(...)
+///         BENCH -> CALCM: CALCM_u_CalculateBearing()
+///         rnote over BENCH: Latency sample is stored
+///       end
+///     <- BENCH
+///     BENCH--
+///   @enduml
+
+static void v_Consume(void);
+
+static void v_Consume(void)
+{
+  uint32_t u_Dispatched = NMEA_p_GetStatistics() -> u_Dispatched;
+  uint64_t u_Start = u_NowNs();
+  uint8_t a_Text[CALCM_POSITION_TEXT_LENGTH];
+  t_MSGM_Fix t_Fix;
+
+  MSGM_v_StateMachine();
+  if((NMEA_p_GetStatistics() -> u_Dispatched != u_Dispatched) && (MSGM_b_ReadFix(MSGM_FIX_OWN, &t_Fix) == b_TRUE))
+  {
+    // Client receives the text SIM_v_SendCoordinates sends and sets it as the target, as SIM does for a received SMS
+    (void)CALCM_u_FormatPosition(t_Fix.i_Latitude, t_Fix.i_Longitude, a_Text);
+    (void)CALCM_e_SetTarget(a_Text, sizeof(a_Text));
+    BENCH_t_Result.u_LastBearing = CALCM_u_CalculateBearing();
+    if(CALCM_e_GetParseStatus() != CALCM_PARSE_OK)
+    {
+      BENCH_t_Result.u_ParseErrors++;
+    }
+    BENCH_t_Result.u_Bearings++;
+
+    uint64_t u_Latency = u_NowNs() - u_Start;
+    if(BENCH_u_LatencyCount < BENCH_LATENCY_SAMPLES)
+    {
+      BENCH_a_Latency[BENCH_u_LatencyCount] = u_Latency;
+    }
+    BENCH_u_LatencyCount++;
+  }
+  BENCH_t_Result.u_ProcessNs += u_NowNs() - u_Start;
+  BENCH_t_Result.u_Wakes++;
+}
+
+/// @brief Function used for replaying a log once
+///
+/// @pre u_StartUs is the simulated time the first byte arrives
+/// @post Every byte was offered to the ring buffer, the consumer ran for every due wake up
+/// @param const uint8_t *p_Log, uint32_t u_Length, const t_BENCH_Options *p_Options, uint64_t u_StartUs,
+///        uint64_t *p_NextRunUs simulated time of the next timeout of TSK_Com, kept between replays
+///
+/// @return uint64_t simulated time after the last byte
+///
+/// @globals BENCH_t_Result
+///
+/// @InOutCorelation Byte i arrives at u_StartUs + i / rate. Before a byte is pushed, the consumer runs for every wake
+///                  up due until its arrival, either the notification of USART2_IRQHandler delayed by the wake
+///                  latency or the PERIOD_TSK_COM timeout. Without a rate the consumer runs at the notification.
+/// @callsequence
+///   @startuml "u_Replay.png"
+///     title "Sequence diagram for function u_Replay"
+///     -> BENCH: u_Replay(...)
+///     BENCH++
+///       loop for each byte
+///         loop while notification or timeout is due before the byte arrives
+///           BENCH -> BENCH: v_Consume()
+///         end
+///         BENCH -> MSGM: MSGM_u_CircularBufferPush(RING_BUFFER1, ...)
+///         opt if stored byte is MSGM_SENTENCE_END or MSGM_GPS_NOTIFY_THRESHOLD bytes were stored
+///           rnote over BENCH: Notification is due after the wake latency
+///         end
+///       end
+///     <- BENCH: Returns time
+///     BENCH--
+///   @enduml
+
+static uint64_t u_Replay(const uint8_t *p_Log, uint32_t u_Length, const t_BENCH_Options *p_Options, uint64_t u_StartUs,
+                         uint64_t *p_NextRunUs);
+
+static uint64_t u_Replay(const uint8_t *p_Log, uint32_t u_Length, const t_BENCH_Options *p_Options, uint64_t u_StartUs,
+                         uint64_t *p_NextRunUs)
+{
+  uint64_t u_NotifyUs = UINT64_MAX;
+  uint64_t u_ArrivalUs = u_StartUs;
+  uint32_t u_Pending = 0u;
+
+  for(uint32_t u_Cnt = 0u; u_Cnt < u_Length; u_Cnt++)
+  {
+    if(p_Options -> u_Rate != 0u)
+    {
+      u_ArrivalUs = u_StartUs + (((uint64_t)u_Cnt * 1000000ULL) / p_Options -> u_Rate);
+      // Wake ups due before this byte, the notification wins when both are due
+      while(((u_NotifyUs < *p_NextRunUs) ? u_NotifyUs : *p_NextRunUs) <= u_ArrivalUs)
+      {
+        uint64_t u_WakeUs = (u_NotifyUs < *p_NextRunUs) ? u_NotifyUs : *p_NextRunUs;
+        v_Consume();
+        u_NotifyUs = UINT64_MAX;
+        u_Pending = 0u;
+        *p_NextRunUs = u_WakeUs + BENCH_CONSUMER_PERIOD_US;
+      }
+    }
+    else if(u_NotifyUs != UINT64_MAX)
+    {
+      v_Consume();
+      u_NotifyUs = UINT64_MAX;
+      u_Pending = 0u;
+    }
+
+    uint8_t u_Stored = MSGM_u_CircularBufferPush(RING_BUFFER1, p_Log[u_Cnt]);   // 0 when filtered or dropped
+    BENCH_t_Result.u_Bytes++;
+    u_Pending += u_Stored;
+    // Same rule as v_NotifyConsumer, bytes stored since the last run stand in for the fill level of the ring buffer
+    if((u_NotifyUs == UINT64_MAX) &&
+       (((u_Stored != 0u) && (p_Log[u_Cnt] == BENCH_SENTENCE_END)) || (u_Pending >= BENCH_NOTIFY_THRESHOLD)))
+    {
+      u_NotifyUs = u_ArrivalUs + p_Options -> u_WakeUs;
+    }
+  }
+  return (p_Options -> u_Rate != 0u) ? (u_StartUs + (((uint64_t)u_Length * 1000000ULL) / p_Options -> u_Rate)) : u_StartUs;
+}
+
+/// @brief Function used for ordering latency samples
+///
+/// @pre None
+/// @post None
+/// @param const void *p_Left, const void *p_Right
+///
+/// @return int negative, zero or positive as for qsort
+///
+/// @globals None
+///
+/// @InOutCorelation Function compares two uint64_t values without overflow.
+/// @callsequence
+///   @startuml "i_CompareLatency.png"
+///     title "Sequence diagram for function i_CompareLatency"
+///     -> BENCH: i_CompareLatency(const void *p_Left, const void *p_Right)
+///     BENCH++
+///     <- BENCH: Returns order
+///     BENCH--
+///   @enduml
+
+static int i_CompareLatency(const void *p_Left, const void *p_Right);
+
+static int i_CompareLatency(const void *p_Left, const void *p_Right)
+{
+  uint64_t u_Left = *(const uint64_t *)p_Left;
+  uint64_t u_Right = *(const uint64_t *)p_Right;
+
+  return (u_Left > u_Right) - (u_Left < u_Right);
+}
+
+/// @brief Function used for reading a percentile of the sorted latency samples
+///
+/// @pre BENCH_a_Latency is sorted
+/// @post None
+/// @param uint64_t u_Count number of stored samples, uint32_t u_Percent
+///
+/// @return uint64_t latency in ns, 0 without samples
+///
+/// @globals BENCH_a_Latency
+///
+/// @InOutCorelation Function uses the nearest rank method.
+/// @callsequence
+///   @startuml "u_Percentile.png"
+///     title "Sequence diagram for function u_Percentile"
+///     -> BENCH: u_Percentile(uint64_t u_Count, uint32_t u_Percent)
+///     BENCH++
+///     <- BENCH: Returns latency
+///     BENCH--
+///   @enduml
+
+static uint64_t u_Percentile(uint64_t u_Count, uint32_t u_Percent);
+
+static uint64_t u_Percentile(uint64_t u_Count, uint32_t u_Percent)
+{
+  if(u_Count == 0u)
+  {
+    return 0u;
+  }
+  uint64_t u_Rank = ((u_Count * u_Percent) + 99u) / 100u;
+  return BENCH_a_Latency[(u_Rank == 0u) ? 0u : (u_Rank - 1u)];
+}
+
+/// @brief Function used for printing the result and writing the JSON file
+///
+/// @pre Replay is finished
+/// @post Result is on stdout, JSON file is written when requested
+/// @param const t_BENCH_Options *p_Options
+///
+/// @return int 0, 1 when the JSON file cannot be written
+///
+/// @globals BENCH_t_Result, BENCH_a_Latency, BENCH_u_LatencyCount
+///
+/// @InOutCorelation Function sorts the latency samples, fills the percentiles and prints throughput in sentences per
+///                  host second and per simulated second.
+/// @callsequence
+///   @startuml "i_Report.png"
+///     title "Sequence diagram for function i_Report"
+///     -> BENCH: i_Report(const t_BENCH_Options *p_Options)
+///     BENCH++
+///       BENCH -> Linux: qsort(BENCH_a_Latency)
+///       BENCH -> Linux: printf(), fprintf(JSON)
+///     <- BENCH: Returns status
+///     BENCH--
+///   @enduml
+
+static int i_Report(const t_BENCH_Options *p_Options);
+
+static int i_Report(const t_BENCH_Options *p_Options)
+{
+  t_NMEA_Statistics *p_Statistics = NMEA_p_GetStatistics();
+  uint64_t u_Stored = (BENCH_u_LatencyCount < BENCH_LATENCY_SAMPLES) ? BENCH_u_LatencyCount : BENCH_LATENCY_SAMPLES;
+  double f_Processed = 0.0;
+  double f_Offered = 0.0;
+
+  BENCH_t_Result.u_Dropped = MSGM_u_Dropped(RING_BUFFER1);
+  BENCH_t_Result.u_Filtered = MSGM_u_Filtered(RING_BUFFER1);
+  BENCH_t_Result.u_Sentences = p_Statistics -> u_Sentences;
+  BENCH_t_Result.u_ChecksumErrors = p_Statistics -> u_ChecksumErrors;
+  BENCH_t_Result.u_FramingErrors = p_Statistics -> u_FramingErrors;
+  qsort(BENCH_a_Latency, (size_t)u_Stored, sizeof(BENCH_a_Latency[0]), i_CompareLatency);
+  BENCH_t_Result.u_LatencyP50 = u_Percentile(u_Stored, 50u);
+  BENCH_t_Result.u_LatencyP90 = u_Percentile(u_Stored, 90u);
+  BENCH_t_Result.u_LatencyP99 = u_Percentile(u_Stored, 99u);
+  BENCH_t_Result.u_LatencyMax = (u_Stored != 0u) ? BENCH_a_Latency[u_Stored - 1u] : 0u;
+  if(BENCH_t_Result.u_ProcessNs != 0u)
+  {
+    f_Processed = ((double)BENCH_t_Result.u_Sentences * 1e9) / (double)BENCH_t_Result.u_ProcessNs;
+  }
+  if(BENCH_t_Result.u_SimulatedUs != 0u)
+  {
+    f_Offered = ((double)BENCH_t_Result.u_Sentences * 1e6) / (double)BENCH_t_Result.u_SimulatedUs;
+  }
+
+  printf("log                 %s\n", (p_Options -> p_Log != NULL) ? p_Options -> p_Log : "synthetic");
+  printf("rate                %u B/s, wake %u us, %u replays, %s\n", (unsigned int)p_Options -> u_Rate,
+         (unsigned int)p_Options -> u_WakeUs, (unsigned int)p_Options -> u_Repeat,
+         (p_Options -> u_AdmitAll != 0u) ? "every sentence stored" : "extracted sentences stored");
+  printf("bytes               %llu offered, %llu filtered, %llu dropped\n", (unsigned long long)BENCH_t_Result.u_Bytes,
+         (unsigned long long)BENCH_t_Result.u_Filtered, (unsigned long long)BENCH_t_Result.u_Dropped);
+  printf("sentences           %u valid, %u checksum errors, %u framing errors\n", (unsigned int)BENCH_t_Result.u_Sentences,
+         (unsigned int)BENCH_t_Result.u_ChecksumErrors, (unsigned int)BENCH_t_Result.u_FramingErrors);
+  printf("consumer            %llu wakes, %llu bearings, %llu rejected, last bearing %u\n",
+         (unsigned long long)BENCH_t_Result.u_Wakes, (unsigned long long)BENCH_t_Result.u_Bearings,
+         (unsigned long long)BENCH_t_Result.u_ParseErrors, (unsigned int)BENCH_t_Result.u_LastBearing);
+  printf("throughput          %.0f sentences/s processed, %.2f sentences/s offered\n", f_Processed, f_Offered);
+  printf("latency [ns]        p50 %llu, p90 %llu, p99 %llu, max %llu\n", (unsigned long long)BENCH_t_Result.u_LatencyP50,
+         (unsigned long long)BENCH_t_Result.u_LatencyP90, (unsigned long long)BENCH_t_Result.u_LatencyP99,
+         (unsigned long long)BENCH_t_Result.u_LatencyMax);
+
+  if(p_Options -> p_Json == NULL)
+  {
+    return 0;
+  }
+  FILE *p_File = fopen(p_Options -> p_Json, "w");
+  if(p_File == NULL)
+  {
+    fprintf(stderr, "bench: cannot write %s\n", p_Options -> p_Json);
+    return 1;
+  }
+  fprintf(p_File, "{\n");
+  fprintf(p_File, "  \"log\": \"%s\",\n", (p_Options -> p_Log != NULL) ? p_Options -> p_Log : "synthetic");
+  fprintf(p_File, "  \"rate_bytes_per_s\": %u,\n", (unsigned int)p_Options -> u_Rate);
+  fprintf(p_File, "  \"wake_us\": %u,\n", (unsigned int)p_Options -> u_WakeUs);
+  fprintf(p_File, "  \"repeat\": %u,\n", (unsigned int)p_Options -> u_Repeat);
+  fprintf(p_File, "  \"admit_all\": %u,\n", (unsigned int)p_Options -> u_AdmitAll);
+  fprintf(p_File, "  \"bytes\": %llu,\n", (unsigned long long)BENCH_t_Result.u_Bytes);
+  fprintf(p_File, "  \"filtered_bytes\": %llu,\n", (unsigned long long)BENCH_t_Result.u_Filtered);
+  fprintf(p_File, "  \"dropped_bytes\": %llu,\n", (unsigned long long)BENCH_t_Result.u_Dropped);
+  fprintf(p_File, "  \"sentences\": %u,\n", (unsigned int)BENCH_t_Result.u_Sentences);
+  fprintf(p_File, "  \"checksum_errors\": %u,\n", (unsigned int)BENCH_t_Result.u_ChecksumErrors);
+  fprintf(p_File, "  \"framing_errors\": %u,\n", (unsigned int)BENCH_t_Result.u_FramingErrors);
+  fprintf(p_File, "  \"wakes\": %llu,\n", (unsigned long long)BENCH_t_Result.u_Wakes);
+  fprintf(p_File, "  \"bearings\": %llu,\n", (unsigned long long)BENCH_t_Result.u_Bearings);
+  fprintf(p_File, "  \"rejected_positions\": %llu,\n", (unsigned long long)BENCH_t_Result.u_ParseErrors);
+  fprintf(p_File, "  \"last_bearing\": %u,\n", (unsigned int)BENCH_t_Result.u_LastBearing);
+  fprintf(p_File, "  \"simulated_us\": %llu,\n", (unsigned long long)BENCH_t_Result.u_SimulatedUs);
+  fprintf(p_File, "  \"process_ns\": %llu,\n", (unsigned long long)BENCH_t_Result.u_ProcessNs);
+  fprintf(p_File, "  \"sentences_per_s_processed\": %.1f,\n", f_Processed);
+  fprintf(p_File, "  \"sentences_per_s_offered\": %.3f,\n", f_Offered);
+  fprintf(p_File, "  \"latency_ns\": {\"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"max\": %llu, \"samples\": %llu}\n",
+          (unsigned long long)BENCH_t_Result.u_LatencyP50, (unsigned long long)BENCH_t_Result.u_LatencyP90,
+          (unsigned long long)BENCH_t_Result.u_LatencyP99, (unsigned long long)BENCH_t_Result.u_LatencyMax,
+          (unsigned long long)BENCH_u_LatencyCount);
+  fprintf(p_File, "}\n");
+  (void)fclose(p_File);
+  return 0;
+}
+
+int BENCH_i_Run(int i_Argc, char **p_Argv)
+{
+  t_BENCH_Options t_Options = { NULL, NULL, BENCH_DEFAULT_SECONDS, BENCH_DEFAULT_RATE, BENCH_DEFAULT_WAKE_US,
+                                BENCH_DEFAULT_REPEAT, 0u };
+  uint8_t *p_Log = NULL;
+  uint32_t u_Length = 0u;
+  uint64_t u_NowUs = 0u;
+  uint64_t u_NextRunUs = BENCH_CONSUMER_PERIOD_US;
+  int i_Option = 0;
+
+  optind = 1;
+  while((i_Option = getopt(i_Argc, p_Argv, "i:s:r:w:n:j:a")) != -1)
+  {
+    switch(i_Option)
+    {
+    case 'i':
+      t_Options.p_Log = optarg;
+      break;
+    case 's':
+      t_Options.u_Seconds = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 'r':
+      t_Options.u_Rate = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 'w':
+      t_Options.u_WakeUs = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 'n':
+      t_Options.u_Repeat = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 'j':
+      t_Options.p_Json = optarg;
+      break;
+    case 'a':
+      t_Options.u_AdmitAll = 1u;
+      break;
+    default:
+      fprintf(stderr, "usage: bench [-i log] [-s seconds] [-r bytes/s] [-w wake us] [-n replays] [-j results.json] [-a]\n");
+      return 1;
+    }
+  }
+
+  if(t_Options.p_Log != NULL)
+  {
+    p_Log = p_ReadLog(t_Options.p_Log, &u_Length);
+  }
+  else
+  {
+    p_Log = malloc((size_t)t_Options.u_Seconds * 8u * BENCH_SENTENCE_LENGTH);
+    if(p_Log != NULL)
+    {
+      u_Length = u_Synthesize(p_Log, t_Options.u_Seconds);
+    }
+  }
+  if(p_Log == NULL)
+  {
+    fprintf(stderr, "bench: cannot load %s\n", (t_Options.p_Log != NULL) ? t_Options.p_Log : "synthetic log");
+    return 1;
+  }
+
+  if(t_Options.u_AdmitAll != 0u)
+  {
+    MSGM_v_SetAdmission(RING_BUFFER1, NULL);
+  }
+  for(uint32_t u_Cnt = 0u; u_Cnt < t_Options.u_Repeat; u_Cnt++)
+  {
+    u_NowUs = u_Replay(p_Log, u_Length, &t_Options, u_NowUs, &u_NextRunUs);
+  }
+  // Last notification or timeout drains what is left
+  v_Consume();
+  BENCH_t_Result.u_SimulatedUs = u_NowUs;
+  free(p_Log);
+
+  return i_Report(&t_Options);
+}
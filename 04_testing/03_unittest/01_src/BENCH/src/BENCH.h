@@ -0,0 +1,73 @@
+/// @file BENCH.h
+/// @brief Header file used for the NMEA replay benchmark of the MSGM to CALCM pipeline
+/// @author Aleksandra Petrovic
+///
+/// A recorded or synthetic NEO-6M log is replayed in simulated time. Bytes arrive at the configured rate and are
+/// pushed with MSGM_u_CircularBufferPush as USART2_IRQHandler does. TSK_Com is woken by the same rule the receive
+/// interrupt uses (sentence end or MSGM_GPS_NOTIFY_THRESHOLD, PERIOD_TSK_COM otherwise) and runs MSGM_v_StateMachine.
+/// When a sentence was dispatched the position is handed to the SIM receive buffer as the SMS text would be, and
+/// CALCM_u_CalculateBearing is called. Processing time is measured on the host clock.
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+
+/// Results of one benchmark run
+typedef struct {
+  uint64_t u_Bytes;             ///< Bytes offered to the ring buffer
+  uint64_t u_Dropped;           ///< Bytes lost because the ring buffer was full
+  uint64_t u_Filtered;          ///< Bytes of sentences the ingress filter did not admit
+  uint64_t u_Wakes;             ///< Runs of the consumer
+  uint64_t u_Bearings;          ///< Bearings calculated
+  uint64_t u_ParseErrors;       ///< Bearings for which CALCM did not accept the position
+  uint64_t u_SimulatedUs;       ///< Length of the replay in simulated time
+  uint64_t u_ProcessNs;         ///< Host time spent in the consumer
+  uint32_t u_Sentences;         ///< Sentences with a correct checksum
+  uint32_t u_ChecksumErrors;    ///< Sentences rejected because of a wrong checksum
+  uint32_t u_FramingErrors;     ///< Sentences rejected because of a broken frame
+  uint16_t u_LastBearing;       ///< Last calculated bearing
+  uint64_t u_LatencyP50;        ///< Median parse-to-bearing latency in ns
+  uint64_t u_LatencyP90;        ///< 90th percentile of the latency in ns
+  uint64_t u_LatencyP99;        ///< 99th percentile of the latency in ns
+  uint64_t u_LatencyMax;        ///< Largest latency in ns
+} t_BENCH_Result;
+
+/// @brief Function used for running the benchmark from the command line of the host binary
+///
+/// @pre SIMR_v_Init must be done, scheduler is not started
+/// @post Results are printed and written to the JSON file when one is given
+/// @param int i_Argc, char **p_Argv options after "bench":
+///        -i log file (synthetic log when missing), -s seconds of synthetic log, -r byte rate (0 unthrottled),
+///        -w wake latency of TSK_Com in us, -n number of replays, -j JSON results file, -a store every sentence
+///        instead of only those NMEA extracts
+///
+/// @return int 0 when the run finished, 1 for wrong options or a log which cannot be read
+///
+/// @globals BENCH_t_Result
+///
+/// @InOutCorelation Function reads the options, loads or generates the log, replays it and reports the result.
+/// @callsequence
+///   @startuml "BENCH_i_Run.png"
+///     title "Sequence diagram for function BENCH_i_Run"
+///     -> BENCH: BENCH_i_Run(int i_Argc, char **p_Argv)
+///     BENCH++
+///       opt if log file is given
+///         BENCH -> Linux: fopen(), fread()
+///       else else
+///         BENCH -> BENCH: u_Synthesize(...)
+///       end
+///       loop for each byte of each replay
+///         BENCH -> MSGM: MSGM_u_CircularBufferPush(RING_BUFFER1, ...)
+///         opt if consumer is due
+///           BENCH -> BENCH: v_Consume()
+///         end
+///       end
+///       BENCH -> BENCH: v_Report(...)
+///     <- BENCH: Returns status
+///     BENCH--
+///   @enduml
+
+int BENCH_i_Run(int i_Argc, char **p_Argv);
+
+#endif /* BENCH_H_ */
@@ -0,0 +1,27 @@
+/// @file FUZZ_cfg.h
+/// @brief Contains configuration data used for the coordinate parser fuzz test of the host build
+/// @author Aleksandra Petrovic
+
+#ifndef FUZZ_CFG_H_
+#define FUZZ_CFG_H_
+
+#include "CALCM.h"
+
+/// Default number of generated fields
+#define FUZZ_DEFAULT_FIELDS (4000000u)
+/// Default share of invalid fields in percent
+#define FUZZ_DEFAULT_INVALID (50u)
+/// Default seed of the field generator
+#define FUZZ_DEFAULT_SEED (0x2545F491u)
+/// Number of fields generated, checked and then timed at once
+#define FUZZ_BATCH (4096u)
+/// Longest generated field, it fits into the COORDINATES_LENGTH bytes the old parser was given
+#define FUZZ_MAX_FIELD (COORDINATES_LENGTH - 1u)
+/// Size of a field buffer, the old parser reads and clears past COORDINATES_LENGTH when a field is empty or has no dot
+#define FUZZ_FIELD_BUFFER (2u * COORDINATES_LENGTH)
+/// Largest number of fraction digits of minutes in a generated field, digits after the sixth are below the resolution
+#define FUZZ_MAX_FRACTION_DIGITS (8u)
+/// Largest difference between the old and the new parser for a valid field in degrees, one micro-degree
+#define FUZZ_TOLERANCE (1e-6)
+
+#endif /* FUZZ_CFG_H_ */
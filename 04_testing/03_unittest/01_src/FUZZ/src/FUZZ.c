@@ -0,0 +1,609 @@
+/// @file FUZZ.c
+/// @brief Main file used for the coordinate parser fuzz test of the host build
+/// @author Aleksandra Petrovic
+
+#include "FUZZ.h"
+#include "FUZZ_cfg.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/// Generated field with the result CALCM_e_ParseCoordinate must give for it
+typedef struct {
+  uint8_t             a_Text[FUZZ_FIELD_BUFFER];  ///< Field followed by NULL characters
+  uint32_t            u_Limit;                    ///< Largest value in degrees, 90 for latitude and 180 for longitude
+  e_CALCM_ParseStatus e_Expected;                 ///< Expected status
+  int32_t             i_Expected;                 ///< Expected micro-degrees when the field is valid
+} t_FUZZ_Field;
+
+/// Results of a run
+typedef struct {
+  uint64_t u_Valid;           ///< Valid fields
+  uint64_t u_Invalid;         ///< Invalid fields
+  uint64_t u_NewRejected;     ///< Valid fields CALCM_e_ParseCoordinate rejected
+  uint64_t u_NewWrong;        ///< Valid fields CALCM_e_ParseCoordinate parsed to a wrong value
+  uint64_t u_NewAccepted;     ///< Invalid fields CALCM_e_ParseCoordinate accepted
+  uint64_t u_NewStatus;       ///< Invalid fields CALCM_e_ParseCoordinate rejected with another status
+  uint64_t u_OldDiffer;       ///< Valid fields v_ConvertToNumbers parsed more than FUZZ_TOLERANCE away
+  uint64_t u_OldAccepted;     ///< Invalid fields v_ConvertToNumbers returned a value other than 0 for
+  uint64_t u_NewNs;           ///< Host time spent in CALCM_e_ParseCoordinate
+  uint64_t u_OldNs;           ///< Host time spent in v_ConvertToNumbers
+} t_FUZZ_Result;
+
+/// Fields of the current batch
+static t_FUZZ_Field FUZZ_a_Field[FUZZ_BATCH];
+/// Sum of all timed results, keeps the compiler from removing the calls
+static volatile double FUZZ_f_Sink = 0.0;
+
+/// @brief Function used to convert longitude and latitude from characters to numbers
+///
+/// Parser of CALCM before CALCM_e_ParseCoordinate, copied from commit 282abbc. Only u_Buffer is longer: for a field
+/// without a dot the original wrote past its COORDINATES_LENGTH bytes.
+///
+/// @pre MSGM state machine reads and processes data read from GPS module
+/// @post Bearing calculation
+/// @param uint8_t *aTempBuffer, double f_LowLimit, double f_HighLimit
+/// @return double f_Num
+///
+/// @globals None
+///
+/// @InOutCorelation Function converts characters to double number values.
+/// @callsequence
+///   @startuml "v_ConvertToNumbers.png"
+///     title "Sequence diagram for function v_ConvertToNumbers"
+///     -> CALCM: v_ConvertToNumbers(uint8_t *u_TempBuffer, double f_LowLimit, double f_HighLimit)
+///     CALCM++
+///       loop Used to skip zero values.
+///         rnote over CALCM: Increment index until non zero value is reached.
+///       end
+///       loop Searches for dot character because of the message format.
+///         rnote over CALCM: Length counter increments for each passing trough the loop to determine the length of whole number.
+///       end
+///       loop Goes through the temporary buffer and checks if read elements are number characters using ASCII table.
+///         opt if elements are inside the range from '0' to '9'
+///           rnote over CALCM: Correct elements are converted into number values.
+///           loop Until u_Length reaches 1 decrease its value
+///           rnote over CALCM: Multiply each element with correct multiplication of 10 and add it to value that will be returned.
+///           end
+///         else else
+///           rnote over CALCM: Incorrect elements are deleted by writing 0 values to their places.
+///       end
+///       rnote over CALCM: Dot characters is written into temporary buffer and index is incremented to skip to fractioned part.
+///       loop Goes through the remaining elements to read fraction part of the coordinates.
+///         opt If read values are corresponding with ASCII values for digits, convert them to numbers.
+///           rnote over CALCM: Derive each element with correct multiplication of 10 and add it to value that will be returned.
+///         else else If incorrect data occurred, all written data gets deleted.
+///         end
+///       end
+///       opt if number is not inside the correct range
+///         loop Go through elements of temporary buffer
+///           rnote over CALCM: Write 0s into each buffer element.
+///          end
+///       end
+///     <- CALCM:// Returns a double value of coordinates.//
+///     CALCM--
+///   @enduml
+
+static double v_ConvertToNumbers(uint8_t *u_TempBuffer, double f_LowLimit, double f_HighLimit);
+
+static double v_ConvertToNumbers(uint8_t *u_TempBuffer, double f_LowLimit, double f_HighLimit)
+{
+  double f_Num = 0;
+  // Used for going through u_TempBuffer array
+  uint8_t u_Index = 0u;
+  // Used to store whole number part
+  uint8_t u_Buffer[FUZZ_FIELD_BUFFER];
+  // Variable used to determine length of whole number part
+  uint8_t u_Length = 0u;
+  uint8_t u_TmpCntr = 0u;
+
+  // Until non zero value is reached or index reaches the last element, keep going through the array
+  while((u_TempBuffer[u_Index] == 0) && (u_Index != COORDINATES_LENGTH))
+  {
+    u_Index++;
+  }
+  // Index of first non zero character
+  uint8_t u_Start = u_Index;
+
+  // . character represents the end of whole digit part of the coordinate
+  while(u_TempBuffer[u_Index] != '.' && (u_Index != COORDINATES_LENGTH))
+  {
+	u_Buffer[u_TmpCntr] = u_TempBuffer[u_Index];
+	u_TmpCntr++;
+	u_Index++;
+	u_Length++;
+  }
+  // Write a . character into a buffer
+  u_Buffer[u_TmpCntr] = u_TempBuffer[u_Index];
+  // Increment u_TmpCntr so u_FractionStart gets its right value
+  u_TmpCntr++;
+  // Index of last whole number digit
+  uint8_t u_FractionStart = u_TmpCntr;
+  // Used to store length value so when it decreases it can be read again
+  uint8_t u_LenTmp = u_Length;
+  // Number of elements for fraction part of coordinates
+  uint8_t u_NumofRemainigElements = COORDINATES_LENGTH - u_Length - 1;
+  uint8_t u_Cnt = 0u;
+  // Start from first non zero character and go through all the elements before '.' character
+  while(u_Start < u_Index && u_Cnt < u_TmpCntr - 1)
+  {
+	double u_Tmp = (double)u_Buffer[u_Cnt];
+	// ASCII range for 0-9 digits
+	if(u_Tmp >= '0' && u_Tmp <= '9')
+	{
+      // ASCII value for 0, used to convert character to number
+	  u_Tmp -= '0';
+	  while(u_Length != 1)
+	  {
+	    // u_Length is used to realize 10^u_Length
+	    u_Tmp *= 10;
+		u_Length--;
+	  }
+	  // Derivation with 100 needs to be done because of the format of the number that is read from GPS module
+	  u_Tmp /= DERIVATION_CONST;
+	  // Add u_Tmp number to f_Num which will be returned
+	  f_Num += u_Tmp;
+	}
+	else
+	{
+      // In case of incorrect data format clear all the elements
+	  u_Length = 0u;
+	  for(uint8_t u_Count = 0; u_Count < u_FractionStart; u_Count++)
+	  {
+		u_Buffer[u_Count] = 0;
+	  }
+	}
+	u_Start++;
+	// u_LenTmp needs to be decremented so next passing through loop will provide lesser length for 10^u_Length
+	u_LenTmp--;
+	u_Length = u_LenTmp;
+	u_Cnt++;
+  }
+
+  u_Cnt = 0u;
+  // When array reaches '.' character, skip to fraction part
+  u_Index++;
+  // Values need to be derived by position compared to . character multiplied by derivation format constant
+  double u_Deriv = 10 * DERIVATION_CONST;
+  // Loop goes through remaining elements in longitude/latitude buffer
+  while((u_Cnt < u_NumofRemainigElements) && (u_TempBuffer[u_Index] != 0))
+  {
+	double u_Tmp = (double)u_TempBuffer[u_Index];
+	if(u_Tmp >= '0' && u_Tmp <= '9')
+	{
+	  u_Tmp -= '0';
+	  u_Tmp /= u_Deriv;
+	  // Add each digit of fractioned part to the number
+	  f_Num += u_Tmp;
+	}
+	// Multiply derivation variable so each next element gets derived 10 times more
+	u_Deriv *= 10;
+	u_Index++;
+	u_Cnt++;
+  }
+  // Check if calculated number is inside the range for longitude/latitude
+  if(!(f_Num >= f_LowLimit && f_Num <= f_HighLimit))
+  {
+	// Clear everything if non number values appear
+	f_Num = 0;
+	for(uint8_t u_Count = 0u; u_Count < u_Index; u_Count++)
+	{
+	  u_Buffer[u_Count] = 0u;
+	}
+  }
+  return f_Num;
+}
+
+/// @brief Function used for reading the host clock
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return uint64_t monotonic time in ns
+///
+/// @globals None
+///
+/// @InOutCorelation Function reads CLOCK_MONOTONIC for the time per field.
+/// @callsequence
+///   @startuml "u_NowNs.png"
+///     title "Sequence diagram for function u_NowNs"
+///     -> FUZZ: u_NowNs()
+///     FUZZ++
+///       FUZZ -> Linux: clock_gettime(CLOCK_MONOTONIC)
+///     <- FUZZ: Returns time
+///     FUZZ--
+///   @enduml
+
+static uint64_t u_NowNs(void);
+
+static uint64_t u_NowNs(void)
+{
+  struct timespec t_Time;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &t_Time);
+  return ((uint64_t)t_Time.tv_sec * 1000000000ULL) + (uint64_t)t_Time.tv_nsec;
+}
+
+/// @brief Function used for drawing the next number of the field generator
+///
+/// @pre None
+/// @post Generator state is advanced
+/// @param uint32_t *p_State generator state, uint32_t u_Range number of possible results
+///
+/// @return uint32_t number from 0 to u_Range - 1
+///
+/// @globals None
+///
+/// @InOutCorelation Function steps a 32 bit xorshift generator, so a seed always gives the same fields.
+/// @callsequence
+///   @startuml "u_Random.png"
+///     title "Sequence diagram for function u_Random"
+///     -> FUZZ: u_Random(uint32_t *p_State, uint32_t u_Range)
+///     FUZZ++
+///     <- FUZZ: Returns number
+///     FUZZ--
+///   @enduml
+
+static uint32_t u_Random(uint32_t *p_State, uint32_t u_Range);
+
+static uint32_t u_Random(uint32_t *p_State, uint32_t u_Range)
+{
+  *p_State ^= *p_State << 13u;
+  *p_State ^= *p_State >> 17u;
+  *p_State ^= *p_State << 5u;
+  return *p_State % u_Range;
+}
+
+/// @brief Function used for generating one field
+///
+/// @pre None
+/// @post Field text, limit and expected result are written
+/// @param t_FUZZ_Field *p_Field, uint32_t *p_State generator state, uint32_t u_Invalid share of invalid fields in percent
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Function draws a latitude or longitude in ddmm.mmmm or dddmm.mmmm format with 1 to
+///                  FUZZ_MAX_FRACTION_DIGITS digits of minute fraction. An invalid field gets one defect, which
+///                  decides the expected status.
+/// @callsequence
+///   @startuml "v_Generate.png"
+///     title "Sequence diagram for function v_Generate"
+///     -> FUZZ: v_Generate(t_FUZZ_Field *p_Field, uint32_t *p_State, uint32_t u_Invalid)
+///     FUZZ++
+///       FUZZ -> FUZZ: u_Random(...)
+///       opt if field is invalid
+///         rnote over FUZZ: Apply one defect and set the expected status.
+///       end
+///     <- FUZZ: Returns
+///     FUZZ--
+///   @enduml
+
+static void v_Generate(t_FUZZ_Field *p_Field, uint32_t *p_State, uint32_t u_Invalid);
+
+static void v_Generate(t_FUZZ_Field *p_Field, uint32_t *p_State, uint32_t u_Invalid)
+{
+  uint8_t u_Longitude = (uint8_t)u_Random(p_State, 2u);
+  uint32_t u_DegreeDigits = (u_Longitude == 1u) ? 3u : 2u;
+  uint32_t u_Degrees = 0u;
+  uint32_t u_Minutes = 0u;
+  uint32_t u_FractionDigits = 1u + u_Random(p_State, FUZZ_MAX_FRACTION_DIGITS);
+  uint32_t u_Fraction = 0u;
+  uint32_t u_Character = 0u;
+  char a_Fraction[FUZZ_MAX_FRACTION_DIGITS + 1u];
+  char *p_Text = (char *)p_Field -> a_Text;
+  int i_Length = 0;
+
+  memset(p_Field -> a_Text, 0, sizeof(p_Field -> a_Text));
+  p_Field -> u_Limit = (u_Longitude == 1u) ? LONGITUDE_HIGH_RANGE : LATITUDE_HIGH_RANGE;
+  u_Degrees = u_Random(p_State, p_Field -> u_Limit + 1u);
+  // Limit itself is only valid with zero minutes
+  u_Minutes = (u_Degrees == p_Field -> u_Limit) ? 0u : u_Random(p_State, CALCM_MINUTES_PER_DEGREE);
+  for(uint32_t u_Cnt = 0u; u_Cnt < u_FractionDigits; u_Cnt++)
+  {
+    uint32_t u_Digit = (u_Degrees == p_Field -> u_Limit) ? 0u : u_Random(p_State, 10u);
+
+    a_Fraction[u_Cnt] = (char)('0' + u_Digit);
+    if(u_Cnt < CALCM_MINUTE_FRACTION_DIGITS)
+    {
+      u_Fraction = u_Fraction * 10u + u_Digit;
+    }
+  }
+  a_Fraction[u_FractionDigits] = '\0';
+  for(uint32_t u_Cnt = u_FractionDigits; u_Cnt < CALCM_MINUTE_FRACTION_DIGITS; u_Cnt++)
+  {
+    u_Fraction *= 10u;
+  }
+  p_Field -> e_Expected = CALCM_PARSE_OK;
+  p_Field -> i_Expected = (int32_t)(u_Degrees * CALCM_MICRODEGREES +
+                          (u_Minutes * CALCM_MICRODEGREES + u_Fraction + CALCM_MINUTES_PER_DEGREE / 2u) / CALCM_MINUTES_PER_DEGREE);
+
+  if(u_Random(p_State, 100u) >= u_Invalid)
+  {
+    (void)snprintf(p_Text, FUZZ_MAX_FIELD + 1u, "%0*u%02u.%s", (int)u_DegreeDigits, (unsigned int)u_Degrees,
+                   (unsigned int)u_Minutes, a_Fraction);
+    return;
+  }
+
+  switch(u_Random(p_State, 8u))
+  {
+  case 0u:
+    // Character which is neither a digit, a dot nor a field end
+    i_Length = snprintf(p_Text, FUZZ_MAX_FIELD + 1u, "%0*u%02u.%s", (int)u_DegreeDigits, (unsigned int)u_Degrees,
+                        (unsigned int)u_Minutes, a_Fraction);
+    do
+    {
+      u_Character = 1u + u_Random(p_State, 255u);
+    } while(((u_Character >= (uint32_t)'0') && (u_Character <= (uint32_t)'9')) || (u_Character == (uint32_t)'.') ||
+            (u_Character == (uint32_t)','));
+    p_Text[u_Random(p_State, (uint32_t)i_Length)] = (char)u_Character;
+    p_Field -> e_Expected = CALCM_PARSE_INVALID_CHARACTER;
+    break;
+  case 1u:
+    // No dot
+    (void)snprintf(p_Text, FUZZ_MAX_FIELD + 1u, "%0*u%02u%s", (int)u_DegreeDigits, (unsigned int)u_Degrees,
+                   (unsigned int)u_Minutes, a_Fraction);
+    p_Field -> e_Expected = CALCM_PARSE_INVALID_FORMAT;
+    break;
+  case 2u:
+    // Second dot among the fraction digits
+    (void)snprintf(p_Text, FUZZ_MAX_FIELD + 1u, "%0*u%02u.%s.", (int)u_DegreeDigits, (unsigned int)u_Degrees,
+                   (unsigned int)u_Minutes, a_Fraction);
+    p_Field -> e_Expected = CALCM_PARSE_INVALID_CHARACTER;
+    break;
+  case 3u:
+    // Nothing between the commas
+    p_Field -> e_Expected = CALCM_PARSE_EMPTY;
+    break;
+  case 4u:
+    // Minutes from 60 to 99
+    (void)snprintf(p_Text, FUZZ_MAX_FIELD + 1u, "%0*u%02u.%s", (int)u_DegreeDigits, (unsigned int)u_Degrees,
+                   (unsigned int)(CALCM_MINUTES_PER_DEGREE + u_Random(p_State, DERIVATION_CONST - CALCM_MINUTES_PER_DEGREE)),
+                   a_Fraction);
+    p_Field -> e_Expected = CALCM_PARSE_OUT_OF_RANGE;
+    break;
+  case 5u:
+    // Degrees above the limit up to the largest number of degree digits
+    u_Degrees = p_Field -> u_Limit + 1u + u_Random(p_State, ((u_Longitude == 1u) ? 999u : 99u) - p_Field -> u_Limit);
+    (void)snprintf(p_Text, FUZZ_MAX_FIELD + 1u, "%0*u%02u.%s", (int)u_DegreeDigits, (unsigned int)u_Degrees,
+                   (unsigned int)u_Minutes, a_Fraction);
+    p_Field -> e_Expected = CALCM_PARSE_OUT_OF_RANGE;
+    break;
+  case 6u:
+    // One or two digits before the dot
+    (void)snprintf(p_Text, FUZZ_MAX_FIELD + 1u, "%0*u.%s", (int)(1u + u_Random(p_State, 2u)),
+                   (unsigned int)(u_Minutes % 10u), a_Fraction);
+    p_Field -> e_Expected = CALCM_PARSE_INVALID_FORMAT;
+    break;
+  default:
+    // Six to eight digits before the dot
+    (void)snprintf(p_Text, FUZZ_MAX_FIELD + 1u, "%0*u%02u.%s", (int)(4u + u_Random(p_State, 3u)),
+                   (unsigned int)u_Degrees, (unsigned int)u_Minutes, a_Fraction);
+    p_Field -> e_Expected = CALCM_PARSE_INVALID_FORMAT;
+    break;
+  }
+}
+
+/// @brief Function used for converting the result of the old parser to micro-degrees
+///
+/// @pre None
+/// @post None
+/// @param double f_Number result of v_ConvertToNumbers, ddmm.mmmm / 100
+///
+/// @return double degrees
+///
+/// @globals None
+///
+/// @InOutCorelation Whole part are degrees and the fraction times 100 are minutes.
+/// @callsequence
+///   @startuml "f_OldToDegrees.png"
+///     title "Sequence diagram for function f_OldToDegrees"
+///     -> FUZZ: f_OldToDegrees(double f_Number)
+///     FUZZ++
+///     <- FUZZ: Returns degrees
+///     FUZZ--
+///   @enduml
+
+static double f_OldToDegrees(double f_Number);
+
+static double f_OldToDegrees(double f_Number)
+{
+  double f_Degrees = floor(f_Number);
+
+  return f_Degrees + ((f_Number - f_Degrees) * DERIVATION_CONST) / CALCM_MINUTES_PER_DEGREE;
+}
+
+/// @brief Function used for checking both parsers on a batch
+///
+/// @pre Batch is generated
+/// @post Counters of the result are advanced
+/// @param uint32_t u_Count fields in the batch, t_FUZZ_Result *p_Result
+///
+/// @return None
+///
+/// @globals FUZZ_a_Field
+///
+/// @InOutCorelation CALCM_e_ParseCoordinate must give the expected status and value. The old parser is only
+///                  compared: a valid field should give the same position, an invalid one should give 0.
+/// @callsequence
+///   @startuml "v_Check.png"
+///     title "Sequence diagram for function v_Check"
+///     -> FUZZ: v_Check(uint32_t u_Count, t_FUZZ_Result *p_Result)
+///     FUZZ++
+///       loop for each field
+///         FUZZ -> CALCM: CALCM_e_ParseCoordinate(...)
+///         FUZZ -> FUZZ: v_ConvertToNumbers(...), f_OldToDegrees(...)
+///       end
+///     <- FUZZ: Returns
+///     FUZZ--
+///   @enduml
+
+static void v_Check(uint32_t u_Count, t_FUZZ_Result *p_Result);
+
+static void v_Check(uint32_t u_Count, t_FUZZ_Result *p_Result)
+{
+  for(uint32_t u_Cnt = 0u; u_Cnt < u_Count; u_Cnt++)
+  {
+    t_FUZZ_Field *p_Field = &FUZZ_a_Field[u_Cnt];
+    uint8_t u_Index = 0u;
+    int32_t i_MicroDegrees = 0;
+    e_CALCM_ParseStatus e_Status = CALCM_e_ParseCoordinate(p_Field -> a_Text, &u_Index, COORDINATES_LENGTH,
+                                                           p_Field -> u_Limit, &i_MicroDegrees);
+    double f_Old = v_ConvertToNumbers(p_Field -> a_Text, -(double)p_Field -> u_Limit, (double)p_Field -> u_Limit);
+
+    if(p_Field -> e_Expected == CALCM_PARSE_OK)
+    {
+      p_Result -> u_Valid++;
+      if(e_Status != CALCM_PARSE_OK)
+      {
+        p_Result -> u_NewRejected++;
+      }
+      else if(i_MicroDegrees != p_Field -> i_Expected)
+      {
+        p_Result -> u_NewWrong++;
+      }
+      if(fabs(f_OldToDegrees(f_Old) - ((double)p_Field -> i_Expected / CALCM_MICRODEGREES)) > FUZZ_TOLERANCE)
+      {
+        p_Result -> u_OldDiffer++;
+      }
+    }
+    else
+    {
+      p_Result -> u_Invalid++;
+      if(e_Status == CALCM_PARSE_OK)
+      {
+        p_Result -> u_NewAccepted++;
+      }
+      else if(e_Status != p_Field -> e_Expected)
+      {
+        p_Result -> u_NewStatus++;
+      }
+      if(fabs(f_Old) > 0.0)
+      {
+        p_Result -> u_OldAccepted++;
+      }
+    }
+  }
+}
+
+/// @brief Function used for timing both parsers on a batch
+///
+/// @pre Batch is generated
+/// @post u_NewNs and u_OldNs of the result are advanced
+/// @param uint32_t u_Count fields in the batch, t_FUZZ_Result *p_Result
+///
+/// @return None
+///
+/// @globals FUZZ_a_Field, FUZZ_f_Sink
+///
+/// @InOutCorelation Each parser runs over the whole batch with nothing else in the loop.
+/// @callsequence
+///   @startuml "v_Time.png"
+///     title "Sequence diagram for function v_Time"
+///     -> FUZZ: v_Time(uint32_t u_Count, t_FUZZ_Result *p_Result)
+///     FUZZ++
+///       loop for each field
+///         FUZZ -> CALCM: CALCM_e_ParseCoordinate(...)
+///       end
+///       loop for each field
+///         FUZZ -> FUZZ: v_ConvertToNumbers(...)
+///       end
+///     <- FUZZ: Returns
+///     FUZZ--
+///   @enduml
+
+static void v_Time(uint32_t u_Count, t_FUZZ_Result *p_Result);
+
+static void v_Time(uint32_t u_Count, t_FUZZ_Result *p_Result)
+{
+  double f_Sum = 0.0;
+  uint64_t u_Start = u_NowNs();
+
+  for(uint32_t u_Cnt = 0u; u_Cnt < u_Count; u_Cnt++)
+  {
+    uint8_t u_Index = 0u;
+    int32_t i_MicroDegrees = 0;
+
+    f_Sum += (double)CALCM_e_ParseCoordinate(FUZZ_a_Field[u_Cnt].a_Text, &u_Index, COORDINATES_LENGTH,
+                                             FUZZ_a_Field[u_Cnt].u_Limit, &i_MicroDegrees) + (double)i_MicroDegrees;
+  }
+  p_Result -> u_NewNs += u_NowNs() - u_Start;
+
+  u_Start = u_NowNs();
+  for(uint32_t u_Cnt = 0u; u_Cnt < u_Count; u_Cnt++)
+  {
+    f_Sum += v_ConvertToNumbers(FUZZ_a_Field[u_Cnt].a_Text, -(double)FUZZ_a_Field[u_Cnt].u_Limit,
+                                (double)FUZZ_a_Field[u_Cnt].u_Limit);
+  }
+  p_Result -> u_OldNs += u_NowNs() - u_Start;
+  FUZZ_f_Sink += f_Sum;
+}
+
+int FUZZ_i_Run(int i_Argc, char **p_Argv)
+{
+  static t_FUZZ_Result t_Result;
+  uint32_t u_Fields = FUZZ_DEFAULT_FIELDS;
+  uint32_t u_Invalid = FUZZ_DEFAULT_INVALID;
+  uint32_t u_State = FUZZ_DEFAULT_SEED;
+  uint8_t u_Passed = 0u;
+  int i_Option = 0;
+
+  optind = 1;
+  while((i_Option = getopt(i_Argc, p_Argv, "n:i:s:")) != -1)
+  {
+    switch(i_Option)
+    {
+    case 'n':
+      u_Fields = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 'i':
+      u_Invalid = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 's':
+      u_State = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    default:
+      fprintf(stderr, "usage: fuzz [-n fields] [-i invalid percent] [-s seed]\n");
+      return 1;
+    }
+  }
+  if((u_Invalid > 100u) || (u_State == 0u))
+  {
+    fprintf(stderr, "fuzz: -i must be up to 100 and -s must not be 0\n");
+    return 1;
+  }
+
+  memset(&t_Result, 0, sizeof(t_Result));
+  for(uint32_t u_Done = 0u; u_Done < u_Fields; )
+  {
+    uint32_t u_Count = ((u_Fields - u_Done) < FUZZ_BATCH) ? (u_Fields - u_Done) : FUZZ_BATCH;
+
+    for(uint32_t u_Cnt = 0u; u_Cnt < u_Count; u_Cnt++)
+    {
+      v_Generate(&FUZZ_a_Field[u_Cnt], &u_State, u_Invalid);
+    }
+    v_Check(u_Count, &t_Result);
+    v_Time(u_Count, &t_Result);
+    u_Done += u_Count;
+  }
+
+  u_Passed = ((t_Result.u_NewRejected == 0u) && (t_Result.u_NewWrong == 0u) && (t_Result.u_NewAccepted == 0u) &&
+              (t_Result.u_NewStatus == 0u)) ? 1u : 0u;
+  printf("fields              %llu valid, %llu invalid\n", (unsigned long long)t_Result.u_Valid,
+         (unsigned long long)t_Result.u_Invalid);
+  printf("new parser          %llu valid rejected, %llu valid wrong, %llu invalid accepted, %llu wrong status\n",
+         (unsigned long long)t_Result.u_NewRejected, (unsigned long long)t_Result.u_NewWrong,
+         (unsigned long long)t_Result.u_NewAccepted, (unsigned long long)t_Result.u_NewStatus);
+  printf("old parser          %llu valid off by more than 1 micro-degree, %llu invalid not returned as 0\n",
+         (unsigned long long)t_Result.u_OldDiffer, (unsigned long long)t_Result.u_OldAccepted);
+  printf("time [ns/field]     new %.1f, old %.1f\n",
+         (u_Fields != 0u) ? (double)t_Result.u_NewNs / (double)u_Fields : 0.0,
+         (u_Fields != 0u) ? (double)t_Result.u_OldNs / (double)u_Fields : 0.0);
+  printf("%s\n", (u_Passed == 1u) ? "PASS" : "FAIL");
+  return (u_Passed == 1u) ? 0 : 1;
+}
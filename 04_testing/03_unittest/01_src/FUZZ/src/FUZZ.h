@@ -0,0 +1,47 @@
+/// @file FUZZ.h
+/// @brief Header file used for the coordinate parser fuzz test of the host build
+/// @author Aleksandra Petrovic
+///
+/// Random latitude and longitude fields are parsed by CALCM_e_ParseCoordinate and by v_ConvertToNumbers, the
+/// parser CALCM used before it. Valid fields are made from a random position, so the expected micro-degrees are
+/// known. Invalid fields are valid ones with one defect (a foreign character, a missing or second dot, too few or
+/// too many digits before the dot, minutes or degrees out of range, nothing at all), so the expected status is
+/// known too. The old parser returns ddmm.mmmm / 100, its result is converted to degrees before the comparison.
+/// Both parsers are timed on the same fields.
+
+#ifndef FUZZ_H_
+#define FUZZ_H_
+
+/// @brief Function used for running the fuzz test from the command line of the host binary
+///
+/// @pre None
+/// @post Results are printed
+/// @param int i_Argc, char **p_Argv options after "fuzz":
+///        -n number of fields, -i share of invalid fields in percent, -s seed of the field generator
+///
+/// @return int 0 when CALCM_e_ParseCoordinate gave the expected result for every field, 1 otherwise or for wrong
+///         options
+///
+/// @globals None
+///
+/// @InOutCorelation Function generates the fields in batches, checks both parsers on a batch and then times them
+///                  on it.
+/// @callsequence
+///   @startuml "FUZZ_i_Run.png"
+///     title "Sequence diagram for function FUZZ_i_Run"
+///     -> FUZZ: FUZZ_i_Run(int i_Argc, char **p_Argv)
+///     FUZZ++
+///       loop for each batch
+///         FUZZ -> FUZZ: v_Generate(...)
+///         FUZZ -> FUZZ: v_Check(...)
+///         FUZZ -> CALCM: CALCM_e_ParseCoordinate(...) for each field, timed
+///         FUZZ -> FUZZ: v_ConvertToNumbers(...) for each field, timed
+///       end
+///       FUZZ -> Linux: printf()
+///     <- FUZZ: Returns status
+///     FUZZ--
+///   @enduml
+
+int FUZZ_i_Run(int i_Argc, char **p_Argv);
+
+#endif /* FUZZ_H_ */
@@ -0,0 +1,67 @@
+/// @file FreeRTOSConfig.h
+/// @brief FreeRTOS configuration of the host build, it follows Core/Inc/FreeRTOSConfig.h for the POSIX port
+/// @author Aleksandra Petrovic
+///
+/// Kernel behaviour the modules rely on (tick rate, priorities, static allocation, mutexes, timers, task
+/// notifications, run time statistics) is the same as on the target. Cortex-M interrupt priority settings and
+/// tickless idle have no meaning on the POSIX port and are left out.
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <stdint.h>
+
+void HOST_v_AssertCalled(const char *p_File, uint32_t u_Line);
+void SIMR_v_SwitchedOut(void);
+void MONITOR_v_Init(void);
+uint32_t MONITOR_u_RunTimeCounter(void);
+
+#define configUSE_PREEMPTION                     1
+#define configSUPPORT_STATIC_ALLOCATION          1
+#define configSUPPORT_DYNAMIC_ALLOCATION         1
+#define configUSE_IDLE_HOOK                      0
+#define configUSE_TICKLESS_IDLE                  0
+#define configUSE_TICK_HOOK                      0
+#define configCPU_CLOCK_HZ                       ((unsigned long)180000000)
+#define configTICK_RATE_HZ                       ((TickType_t)1000)
+#define configMAX_PRIORITIES                     ( 7 )
+/* Task stacks are used as pthread stacks, so they cannot be smaller than PTHREAD_STACK_MIN */
+#define configMINIMAL_STACK_SIZE                 ((unsigned short)4096)
+#define configTOTAL_HEAP_SIZE                    ((size_t)(1024 * 1024))
+#define configMAX_TASK_NAME_LEN                  ( 16 )
+#define configUSE_16_BIT_TICKS                   0
+#define configUSE_MUTEXES                        1
+#define configQUEUE_REGISTRY_SIZE                8
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION  0
+#define configUSE_TIMERS                         1
+#define configTIMER_TASK_PRIORITY                ( 6 )
+#define configTIMER_QUEUE_LENGTH                 4
+#define configTIMER_TASK_STACK_DEPTH             configMINIMAL_STACK_SIZE
+#define configMESSAGE_BUFFER_LENGTH_TYPE         size_t
+#define configUSE_CO_ROUTINES                    0
+#define configMAX_CO_ROUTINE_PRIORITIES          ( 2 )
+
+#define INCLUDE_vTaskPrioritySet             1
+#define INCLUDE_uxTaskPriorityGet            1
+#define INCLUDE_vTaskDelete                  1
+#define INCLUDE_vTaskCleanUpResources        0
+#define INCLUDE_vTaskSuspend                 1
+#define INCLUDE_vTaskDelayUntil              1
+#define INCLUDE_vTaskDelay                   1
+#define INCLUDE_xTaskGetSchedulerState       1
+#define INCLUDE_xTaskGetCurrentTaskHandle    1
+#define INCLUDE_uxTaskGetStackHighWaterMark  1
+#define INCLUDE_xTaskGetIdleTaskHandle       1
+
+/* Run time statistics use the simulated TIM5 of TIMEB, as on the target */
+#define configGENERATE_RUN_TIME_STATS        1
+#define configUSE_TRACE_FACILITY             1
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() MONITOR_v_Init()
+#define portGET_RUN_TIME_COUNTER_VALUE()         MONITOR_u_RunTimeCounter()
+
+/* Pending register reads of a task take effect before another task runs */
+#define traceTASK_SWITCHED_OUT()             SIMR_v_SwitchedOut()
+
+#define configASSERT( x ) if ((x) == 0) {HOST_v_AssertCalled(__FILE__, __LINE__);}
+
+#endif /* FREERTOS_CONFIG_H */
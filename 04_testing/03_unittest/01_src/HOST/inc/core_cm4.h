@@ -0,0 +1,214 @@
+/// @file core_cm4.h
+/// @brief Host replacement of the CMSIS Cortex-M4 core header, used only by the host build
+/// @author Aleksandra Petrovic
+///
+/// stm32f439xx.h includes this file instead of Drivers/CMSIS/Include/core_cm4.h because the host include directory
+/// is searched first. Device definitions stay the real ones, only the core intrinsics and NVIC functions are
+/// redirected to the simulated peripheral layer (SIMR).
+
+#ifndef HOST_CORE_CM4_H_
+#define HOST_CORE_CM4_H_
+
+#include <stdint.h>
+
+/// Read only register
+#define __I   volatile const
+/// Write only register
+#define __O   volatile
+/// Read and write register
+#define __IO  volatile
+/// Read only structure member
+#define __IM  volatile const
+/// Write only structure member
+#define __OM  volatile
+/// Read and write structure member
+#define __IOM volatile
+
+#ifndef __STATIC_INLINE
+/// Static inline function
+#define __STATIC_INLINE static inline
+#endif
+#ifndef __STATIC_FORCEINLINE
+/// Static inline function which is always inlined
+#define __STATIC_FORCEINLINE static inline __attribute__((always_inline))
+#endif
+#ifndef __ASM
+/// Inline assembly
+#define __ASM __asm
+#endif
+#ifndef __WEAK
+/// Weak symbol
+#define __WEAK __attribute__((weak))
+#endif
+#ifndef __PACKED
+/// Packed structure
+#define __PACKED __attribute__((packed))
+#endif
+#ifndef __ALIGNED
+/// Aligned object
+#define __ALIGNED(x) __attribute__((aligned(x)))
+#endif
+#ifndef __NO_RETURN
+/// Function which does not return
+#define __NO_RETURN __attribute__((__noreturn__))
+#endif
+#ifndef __USED
+/// Object kept by the linker
+#define __USED __attribute__((used))
+#endif
+
+/// Core debug base address, DEMCR is at offset 0xFC
+#define CoreDebug_BASE (0xE000EDF0UL)
+/// DWT base address
+#define DWT_BASE (0xE0001000UL)
+/// SysTick base address
+#define SysTick_BASE (0xE000E010UL)
+/// NVIC base address
+#define NVIC_BASE (0xE000E100UL)
+/// System control block base address
+#define SCB_BASE (0xE000ED00UL)
+
+/// SysTick control and status register enable bit, used by HAL headers
+#define SysTick_CTRL_ENABLE_Msk (1UL << 0U)
+/// SysTick interrupt enable bit, used by HAL headers
+#define SysTick_CTRL_TICKINT_Msk (1UL << 1U)
+
+// Provided by SIMR, the interrupt number is passed as int32_t so this header does not depend on IRQn_Type
+uint32_t SIMR_u_GetPrimask(void);
+void SIMR_v_SetPrimask(uint32_t u_Primask);
+void SIMR_v_NvicEnable(int32_t i_Irq, uint32_t u_Enable);
+void SIMR_v_NvicSetPriority(int32_t i_Irq, uint32_t u_Priority);
+uint32_t SIMR_u_NvicGetPriority(int32_t i_Irq);
+void SIMR_v_NvicSetPending(int32_t i_Irq, uint32_t u_Pending);
+uint32_t SIMR_u_NvicGetPending(int32_t i_Irq);
+uint32_t SIMR_u_GetIpsr(void);
+
+/// No operation
+__STATIC_FORCEINLINE void __NOP(void)
+{
+}
+
+/// Wait for interrupt, the host thread only gives up the processor
+__STATIC_FORCEINLINE void __WFI(void)
+{
+}
+
+/// Wait for event
+__STATIC_FORCEINLINE void __WFE(void)
+{
+}
+
+/// Send event
+__STATIC_FORCEINLINE void __SEV(void)
+{
+}
+
+/// Instruction synchronization barrier
+__STATIC_FORCEINLINE void __ISB(void)
+{
+  __sync_synchronize();
+}
+
+/// Data synchronization barrier
+__STATIC_FORCEINLINE void __DSB(void)
+{
+  __sync_synchronize();
+}
+
+/// Data memory barrier
+__STATIC_FORCEINLINE void __DMB(void)
+{
+  __sync_synchronize();
+}
+
+/// Count leading zeros, returns 32 for 0 like the CLZ instruction
+__STATIC_FORCEINLINE uint8_t __CLZ(uint32_t u_Value)
+{
+  return (u_Value == 0u) ? 32u : (uint8_t)__builtin_clz(u_Value);
+}
+
+/// Reverse byte order
+__STATIC_FORCEINLINE uint32_t __REV(uint32_t u_Value)
+{
+  return __builtin_bswap32(u_Value);
+}
+
+/// Read PRIMASK
+__STATIC_FORCEINLINE uint32_t __get_PRIMASK(void)
+{
+  return SIMR_u_GetPrimask();
+}
+
+/// Write PRIMASK
+__STATIC_FORCEINLINE void __set_PRIMASK(uint32_t u_Primask)
+{
+  SIMR_v_SetPrimask(u_Primask);
+}
+
+/// Disable interrupts by setting PRIMASK
+__STATIC_FORCEINLINE void __disable_irq(void)
+{
+  SIMR_v_SetPrimask(1u);
+}
+
+/// Enable interrupts by clearing PRIMASK
+__STATIC_FORCEINLINE void __enable_irq(void)
+{
+  SIMR_v_SetPrimask(0u);
+}
+
+/// Read IPSR, non-zero while a simulated interrupt handler runs
+__STATIC_FORCEINLINE uint32_t __get_IPSR(void)
+{
+  return SIMR_u_GetIpsr();
+}
+
+/// Enable an interrupt in the simulated NVIC
+__STATIC_INLINE void NVIC_EnableIRQ(int32_t i_Irq)
+{
+  SIMR_v_NvicEnable(i_Irq, 1u);
+}
+
+/// Disable an interrupt in the simulated NVIC
+__STATIC_INLINE void NVIC_DisableIRQ(int32_t i_Irq)
+{
+  SIMR_v_NvicEnable(i_Irq, 0u);
+}
+
+/// Set priority of an interrupt in the simulated NVIC
+__STATIC_INLINE void NVIC_SetPriority(int32_t i_Irq, uint32_t u_Priority)
+{
+  SIMR_v_NvicSetPriority(i_Irq, u_Priority);
+}
+
+/// Read priority of an interrupt from the simulated NVIC
+__STATIC_INLINE uint32_t NVIC_GetPriority(int32_t i_Irq)
+{
+  return SIMR_u_NvicGetPriority(i_Irq);
+}
+
+/// Set pending bit of an interrupt in the simulated NVIC
+__STATIC_INLINE void NVIC_SetPendingIRQ(int32_t i_Irq)
+{
+  SIMR_v_NvicSetPending(i_Irq, 1u);
+}
+
+/// Clear pending bit of an interrupt in the simulated NVIC
+__STATIC_INLINE void NVIC_ClearPendingIRQ(int32_t i_Irq)
+{
+  SIMR_v_NvicSetPending(i_Irq, 0u);
+}
+
+/// Read pending bit of an interrupt from the simulated NVIC
+__STATIC_INLINE uint32_t NVIC_GetPendingIRQ(int32_t i_Irq)
+{
+  return SIMR_u_NvicGetPending(i_Irq);
+}
+
+/// Priority grouping is not simulated, all priorities are preemption priorities
+__STATIC_INLINE void NVIC_SetPriorityGrouping(uint32_t u_Group)
+{
+  (void)u_Group;
+}
+
+#endif /* HOST_CORE_CM4_H_ */
@@ -0,0 +1,10 @@
+/// @file freertos.h
+/// @brief Host build only, modules include "freertos.h" which resolves to FreeRTOS.h only on case insensitive file systems
+/// @author Aleksandra Petrovic
+
+#ifndef HOST_FREERTOS_H_
+#define HOST_FREERTOS_H_
+
+#include "FreeRTOS.h"
+
+#endif /* HOST_FREERTOS_H_ */
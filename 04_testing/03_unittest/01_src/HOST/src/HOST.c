@@ -0,0 +1,433 @@
+/// @file HOST.c
+/// @brief Main file used for the start up code and HAL replacements of the host build
+/// @author Aleksandra Petrovic
+///
+/// Start up follows Core/Src/main.c with the simulated register file in place of the hardware, then a smoke test
+/// task drives USART2, USART3, I2C1 and IWDG through the modules. The process exits with 0 when every check passed.
+/// Started as "APPL_host bench [options]" it runs the NMEA replay benchmark (BENCH) instead, started as
+/// "APPL_host rxeq [options]" it runs the receive path equivalence test (RXEQ), started as
+/// "APPL_host stress [options]" it runs the ring buffer stress test (STRESS), started as
+/// "APPL_host accur [options]" it runs the bearing accuracy test (ACCUR) and started as
+/// "APPL_host fuzz [options]" it runs the coordinate parser fuzz test (FUZZ).
+
+#include "HOST.h"
+#include "SIMR.h"
+#include "task.h"
+#include "stm32f4xx_hal.h"
+#include "UARTM.h"
+#include "MSGM.h"
+#include "I2C.h"
+#include "MCP23017.h"
+#include "WDTIM.h"
+#include "TIMEB.h"
+#include "FLASHM.h"
+#include "CALLR.h"
+#include "SIM.h"
+#include "FIXLOG.h"
+#include "NMEA.h"
+#include "UBX.h"
+#include "BENCH.h"
+#include "ACCUR.h"
+#include "FUZZ.h"
+#include "RXEQ.h"
+#include "STRESS.h"
+#include "TRACK_cfg.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/// Simulated MCP23017 on I2C1
+static t_SIMR_I2cDevice HOST_t_Expander;
+/// Number of failed checks
+static uint32_t HOST_u_Failures = 0u;
+/// Memory of the smoke test task
+static StaticTask_t HOST_t_TestBuffer;
+/// Stack of the smoke test task
+static StackType_t HOST_a_TestStack[HOST_TEST_STACK_DEPTH];
+/// Memory of the idle task
+static StaticTask_t HOST_t_IdleBuffer;
+/// Stack of the idle task
+static StackType_t HOST_a_IdleStack[configMINIMAL_STACK_SIZE];
+/// Memory of the timer service task
+static StaticTask_t HOST_t_TimerBuffer;
+/// Stack of the timer service task
+static StackType_t HOST_a_TimerStack[configTIMER_TASK_STACK_DEPTH];
+
+/// @brief Function used for recording the result of one check
+///
+/// @pre None
+/// @post Failure is counted and printed
+/// @param uint8_t u_Passed 1 when the check passed, const char *p_Name
+///
+/// @return None
+///
+/// @globals HOST_u_Failures
+///
+/// @InOutCorelation Every check prints one line, so a failing run shows which model or module misbehaved.
+/// @callsequence
+///   @startuml "v_Check.png"
+///     title "Sequence diagram for function v_Check"
+///     -> HOST: v_Check(uint8_t u_Passed, const char *p_Name)
+///     HOST++
+///     <- HOST
+///     HOST--
+///   @enduml
+
+static void v_Check(uint8_t u_Passed, const char *p_Name);
+
+static void v_Check(uint8_t u_Passed, const char *p_Name)
+{
+  if(u_Passed == 0u)
+  {
+    HOST_u_Failures++;
+  }
+  printf("%s %s\n", (u_Passed == 1u) ? "PASS" : "FAIL", p_Name);
+}
+
+/// @brief Function used for the smoke test task
+///
+/// @pre Scheduler and interrupt dispatcher are running
+/// @post Process exits with the test result
+/// @param void *p_Argument not used
+///
+/// @return None
+///
+/// @globals HOST_t_Expander
+///
+/// @InOutCorelation A string sent on USART2 must leave the shift register unchanged, a block longer than the ring
+///                  must be sent whole before UARTM2_u_WaitSent returns, bytes arriving on USART3 must reach the ring
+///                  buffer through the receive interrupt, a GPIOB write must reach the expander, a short button
+///                  press must not be lost, a caller added to the table must be found again after it is saved and
+///                  loaded from flash, only an SMS of the administrator may change the table, each queued AT
+///                  command must keep its own text, a logged fix must be restored as a stale position, a GGA
+///                  sentence without fix quality must not publish its position, NAV-TIMEUTC must keep the leap
+///                  second and the watchdog must expire only when it is not reloaded.
+/// @callsequence
+///   @startuml "v_TestTask.png"
+///     title "Sequence diagram for function v_TestTask"
+///     -> HOST: v_TestTask(void *p_Argument)
+///     HOST++
+///       HOST -> UARTM: UARTM2_v_SendString(...)
+///       HOST -> SIMR: SIMR_u_UsartTake(SIMR_USART2, ...)
+///       HOST -> UARTM: UARTM2_v_SendBlock(...), UARTM2_u_WaitSent(HOST_SEND_TIMEOUT_MS)
+///       HOST -> SIMR: SIMR_u_UsartTake(SIMR_USART2, ...)
+///       HOST -> SIMR: SIMR_u_UsartInject(SIMR_USART3, ...)
+///       HOST -> MSGM: MSGM_u_CircularBufferPop(RING_BUFFER2)
+///       HOST -> MCP23017: MCP23017_e_WriteBlock(MCP23017_GPIOB, ...)
+///       HOST -> SIMR: SIMR_v_ExtiTrigger(1)
+///       HOST -> MCP23017: MCP23017_v_ProcessButton(...), MCP23017_b_GetButtonEvent(...)
+///       HOST -> CALLR: CALLR_p_Find(), CALLR_e_Add(), CALLR_e_Save(), CALLR_v_Init()
+///       HOST -> SIMR: SIMR_u_UsartInject(SIMR_USART3, ...)
+///       HOST -> SIM: SIM_v_AtProcess()
+///       HOST -> SIMR: SIMR_u_UsartInject(SIMR_USART3, ...), SIMR_u_UsartTake(SIMR_USART3, ...)
+///       HOST -> SIM: SIM_v_AtProcess()
+///       HOST -> FIXLOG: FIXLOG_v_Record(), FIXLOG_v_Service(), FIXLOG_v_Init(), FIXLOG_b_Get()
+///       HOST -> NMEA: NMEA_v_Process(...)
+///       HOST -> UBX: UBX_v_DecodeNavTimeUtc(...)
+///       HOST -> WDTIM: WDTIM_v_Configure(), WDTIM_v_Start(), WDTIM_v_Reload()
+///       HOST -> SIMR: SIMR_u_WatchdogResets()
+///       HOST -> Linux: exit()
+///     HOST--
+///   @enduml
+
+static void v_TestTask(void *p_Argument);
+
+static void v_TestTask(void *p_Argument)
+{
+  static const uint8_t a_Sent[] = "AT+CMGF=1\r\n";
+  static const uint8_t a_Received[] = "+CMTI: \"SM\",1\r\n";
+  uint8_t a_Buffer[64u];
+  uint32_t u_Count = 0u;
+  uint8_t u_Value = 0xA5u;
+
+  (void)p_Argument;
+
+  // USART2 transmit path: ring, TXE interrupt, shift register
+  UARTM2_v_SendString(a_Sent);
+  vTaskDelay(pdMS_TO_TICKS(HOST_SETTLE_MS));
+  u_Count = SIMR_u_UsartTake(SIMR_USART2, a_Buffer, sizeof(a_Buffer));
+  v_Check(((u_Count == (sizeof(a_Sent) - 1u)) && (memcmp(a_Buffer, a_Sent, u_Count) == 0)) ? 1u : 0u, "USART2 transmit");
+
+  // USART2 block longer than the ring: sender sleeps until the interrupt makes room, then until the last byte is sent
+  {
+    static uint8_t a_Block[(2u * UARTM_TX_BUFFER_LENGTH) + 17u];
+    static uint8_t a_Taken[sizeof(a_Block)];
+    uint32_t u_Index;
+
+    for(u_Index = 0u; u_Index < sizeof(a_Block); u_Index++)
+    {
+      a_Block[u_Index] = (uint8_t)(u_Index * 7u);
+    }
+    UARTM2_v_SendBlock(a_Block, (uint16_t)sizeof(a_Block));
+    u_Index = UARTM2_u_WaitSent(HOST_SEND_TIMEOUT_MS);
+    u_Count = SIMR_u_UsartTake(SIMR_USART2, a_Taken, sizeof(a_Taken));
+    v_Check(((u_Index == 0u) && (u_Count == sizeof(a_Block)) && (memcmp(a_Taken, a_Block, u_Count) == 0)) ? 1u : 0u,
+            "USART2 transmit wait");
+  }
+
+  // USART3 receive path: RXNE interrupt, MSGM ring buffer
+  (void)SIMR_u_UsartInject(SIMR_USART3, a_Received, sizeof(a_Received) - 1u);
+  vTaskDelay(pdMS_TO_TICKS(HOST_SETTLE_MS));
+  u_Count = 0u;
+  while((MSGM_b_CircularBufferIsEmpty(RING_BUFFER2) == b_FALSE) && (u_Count < sizeof(a_Buffer)))
+  {
+    a_Buffer[u_Count] = MSGM_u_CircularBufferPop(RING_BUFFER2);
+    u_Count++;
+  }
+  v_Check(((u_Count == (sizeof(a_Received) - 1u)) && (memcmp(a_Buffer, a_Received, u_Count) == 0) &&
+           (SIMR_u_UsartOverruns(SIMR_USART3) == 0u)) ? 1u : 0u, "USART3 receive");
+
+  // I2C1 from a task: the transfer blocks until the event interrupt completes it
+  v_Check((MCP23017_e_WriteBlock(MCP23017_GPIOB, &u_Value, 1u) == I2C_OK) &&
+          (HOST_t_Expander.a_Registers[MCP23017_GPIOB] == u_Value) ? 1u : 0u, "I2C1 write from task");
+
+  // MCP23017 button: a press released before the pins settle is published as a press and a release
+  {
+    t_MCP23017_ButtonEvent t_Press = {0};
+    t_MCP23017_ButtonEvent t_Release = {0};
+
+    HOST_t_Expander.a_Registers[MCP23017_INTCAPA] = 0xFEu;
+    HOST_t_Expander.a_Registers[MCP23017_GPIOA] = 0xFFu;
+    SIMR_v_ExtiTrigger(1u);
+    MCP23017_v_ProcessButton(pdMS_TO_TICKS(HOST_SETTLE_MS));
+    MCP23017_v_ProcessButton(pdMS_TO_TICKS(HOST_SETTLE_MS));
+    v_Check(((MCP23017_b_GetButtonEvent(&t_Press, 0u) == b_TRUE) && (t_Press.e_Action == MCP23017_BUTTON_PRESS) &&
+             (t_Press.u_Pins == 0x01u) && (MCP23017_b_GetButtonEvent(&t_Release, 0u) == b_TRUE) &&
+             (t_Release.e_Action == MCP23017_BUTTON_RELEASE) && (t_Release.u_Pins == 0x01u)) ? 1u : 0u,
+            "MCP23017 short press");
+  }
+
+  // CALLR: national form of a default caller is found, a routed caller survives a save and a reload
+  v_Check((CALLR_p_Find((const uint8_t *)"060 507-4705", 12u) != NULL) ? 1u : 0u, "CALLR national number");
+  v_Check(((CALLR_e_Add((const uint8_t *)"0044 7700 900123", CALLR_ROUTE_NUMBER, (const uint8_t *)"0605074705") == CALLR_OK) &&
+           (CALLR_e_Save() == CALLR_OK)) ? 1u : 0u, "CALLR save");
+  CALLR_v_Init();
+  FIXLOG_v_Init();
+  {
+    const t_CALLR_Caller *p_Caller = CALLR_p_Find((const uint8_t *)"+447700900123", 13u);
+    v_Check(((CALLR_u_Count() == 3u) && (p_Caller != NULL) &&
+             (strcmp((const char *)CALLR_p_ReplyNumber(p_Caller), "+381605074705") == 0)) ? 1u : 0u, "CALLR reload");
+  }
+
+  // CALLR over SMS: only the administrator can change the table, the change survives a reload
+  {
+    static const uint8_t a_Stranger[] = "+CMT: \"+15550100\",\"\",\"26/10/17,12:00:00+08\"\r\nCALLR,ADD,+15550100\r\n";
+    static const uint8_t a_Admin[] = "+CMT: \"060 507 4705\",\"\",\"26/10/17,12:00:01+08\"\r\nCALLR,DEL,+447700900123\r\n";
+
+    (void)SIMR_u_UsartInject(SIMR_USART3, a_Stranger, sizeof(a_Stranger) - 1u);
+    (void)SIMR_u_UsartInject(SIMR_USART3, a_Admin, sizeof(a_Admin) - 1u);
+    vTaskDelay(pdMS_TO_TICKS(HOST_SETTLE_MS));
+    SIM_v_AtProcess();
+    CALLR_v_Init();
+    v_Check(((CALLR_u_Count() == 2u) && (CALLR_p_Find((const uint8_t *)"+15550100", 9u) == NULL) &&
+             (CALLR_p_Find((const uint8_t *)"+447700900123", 13u) == NULL)) ? 1u : 0u, "CALLR provisioning SMS");
+  }
+
+  // AT queue: two SMS notifications in a row queue two reads, each with its own index
+  {
+    static const uint8_t a_Notify[] = "+CMTI: \"SM\",4\r\n+CMTI: \"SM\",5\r\n";
+    static const uint8_t a_Ok[] = "OK\r\n";
+    uint8_t a_First[32u];
+    uint32_t u_First;
+
+    (void)SIMR_u_UsartTake(SIMR_USART3, a_Buffer, sizeof(a_Buffer));
+    (void)SIMR_u_UsartInject(SIMR_USART3, a_Notify, sizeof(a_Notify) - 1u);
+    vTaskDelay(pdMS_TO_TICKS(HOST_SETTLE_MS));
+    SIM_v_AtProcess();
+    vTaskDelay(pdMS_TO_TICKS(HOST_SETTLE_MS));
+    u_First = SIMR_u_UsartTake(SIMR_USART3, a_First, sizeof(a_First));
+    (void)SIMR_u_UsartInject(SIMR_USART3, a_Ok, sizeof(a_Ok) - 1u);
+    vTaskDelay(pdMS_TO_TICKS(HOST_SETTLE_MS));
+    SIM_v_AtProcess();
+    vTaskDelay(pdMS_TO_TICKS(HOST_SETTLE_MS));
+    u_Count = SIMR_u_UsartTake(SIMR_USART3, a_Buffer, sizeof(a_Buffer));
+    (void)SIMR_u_UsartInject(SIMR_USART3, a_Ok, sizeof(a_Ok) - 1u);
+    vTaskDelay(pdMS_TO_TICKS(HOST_SETTLE_MS));
+    SIM_v_AtProcess();
+    v_Check(((u_First == 11u) && (memcmp(a_First, "AT+CMGR=4\r\n", 11u) == 0) &&
+             (u_Count == 11u) && (memcmp(a_Buffer, "AT+CMGR=5\r\n", 11u) == 0)) ? 1u : 0u, "SIM queued reads");
+  }
+
+  // FIXLOG: a logged fix is restored as the position at the next start up and marked stale
+  {
+    static const t_MSGM_Fix t_Logged = { 44852057, 20459463, 170326u, 123456u, 95u, 1u, 7u, 0u };
+    t_FIXLOG_Record t_Record;
+    t_MSGM_Fix t_Fix;
+
+    FIXLOG_v_Record(&t_Logged);
+    FIXLOG_v_Service();
+    FIXLOG_v_Init();
+    v_Check(((MSGM_b_ReadFix(MSGM_FIX_OWN, &t_Fix) == b_TRUE) && (FIXLOG_b_IsStale(&t_Fix) == b_TRUE) &&
+             (FIXLOG_b_Get(0u, &t_Record) == b_TRUE) && (t_Record.t_Fix.i_Latitude == t_Logged.i_Latitude) &&
+             (t_Fix.i_Latitude == 44852057) && (t_Fix.i_Longitude == 20459463) && (t_Fix.u_Time == 123456u) &&
+             (t_Fix.u_Satellites == 7u)) ? 1u : 0u, "FIXLOG restore");
+  }
+
+  // TRACK: a full track fits into one SMS and is unpacked across midnight to the same fixes
+  {
+    static t_MSGM_Fix a_Fixes[TRACK_MAX_FIXES];
+    static t_MSGM_Fix a_Unpacked[TRACK_MAX_FIXES];
+    static uint8_t a_Text[TRACK_SMS_LENGTH + 1u];
+    t_TRACK_Header t_Header = {0};
+    uint8_t u_Same = 1u;
+
+    for(uint8_t u_Cnt = 0u; u_Cnt < TRACK_MAX_FIXES; u_Cnt++)
+    {
+      uint32_t u_Seconds = 86400u + 90u - (u_Cnt * 100u);
+
+      a_Fixes[u_Cnt].i_Latitude = 44852050 - ((int32_t)u_Cnt * 370);
+      a_Fixes[u_Cnt].i_Longitude = -20459460 + ((int32_t)u_Cnt * 510);
+      a_Fixes[u_Cnt].u_Date = (u_Seconds >= 86400u) ? 10124u : 311223u;
+      u_Seconds %= 86400u;
+      a_Fixes[u_Cnt].u_Time = ((u_Seconds / 3600u) * 10000u) + (((u_Seconds / 60u) % 60u) * 100u) + (u_Seconds % 60u);
+    }
+    uint8_t u_Length = TRACK_u_Pack(a_Fixes, TRACK_MAX_FIXES, b_TRUE, a_Text, sizeof(a_Text));
+    e_CALCM_ParseStatus e_Status = TRACK_e_Decode(a_Text, sizeof(a_Text), a_Unpacked, TRACK_MAX_FIXES, &t_Header);
+    for(uint8_t u_Cnt = 0u; u_Cnt < TRACK_MAX_FIXES; u_Cnt++)
+    {
+      if((a_Unpacked[u_Cnt].i_Latitude != a_Fixes[u_Cnt].i_Latitude) ||
+         (a_Unpacked[u_Cnt].i_Longitude != a_Fixes[u_Cnt].i_Longitude) ||
+         (a_Unpacked[u_Cnt].u_Date != a_Fixes[u_Cnt].u_Date) || (a_Unpacked[u_Cnt].u_Time != a_Fixes[u_Cnt].u_Time))
+      {
+        u_Same = 0u;
+      }
+    }
+    v_Check(((u_Length != 0u) && (u_Length <= TRACK_SMS_LENGTH) && (e_Status == CALCM_PARSE_OK) &&
+             (t_Header.u_Count == TRACK_MAX_FIXES) && (t_Header.b_Stale == b_TRUE) && (u_Same == 1u)) ? 1u : 0u,
+            "TRACK round trip");
+  }
+
+  // NMEA: a GGA sentence cut before the fix quality does not publish its position with the quality of the last one
+  {
+    static const uint8_t a_Sentences[] =
+      "$GPGGA,120000.00,4452.00000,N,02027.00000,E,1,08,1.01,117.2,M,40.1,M,,*57\r\n"
+      "$GPGGA,120001.00,4500.00000,N,02100.00000,E*6F\r\n";
+    static uint8_t a_Storage[256u];
+    t_RINGB_Ring t_Ring;
+    t_MSGM_Fix t_Fix;
+
+    RINGB_v_Init(&t_Ring, a_Storage, sizeof(a_Storage));
+    (void)RINGB_u_PushN(&t_Ring, a_Sentences, sizeof(a_Sentences) - 1u);
+    NMEA_v_Process(&t_Ring);
+    v_Check(((MSGM_b_ReadFix(MSGM_FIX_OWN, &t_Fix) == b_TRUE) && (t_Fix.i_Latitude == 44866667) &&
+             (t_Fix.u_Time == 120000u) && (NMEA_p_GetInfo() -> u_FixQuality == 0u)) ? 1u : 0u,
+            "NMEA fix quality reset");
+  }
+
+  // UBX: NAV-TIMEUTC sets the time and date only once the receiver knows UTC, a leap second is kept
+  {
+    static uint8_t a_TimeUtc[UBX_NAV_TIMEUTC_LENGTH] = {
+      0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0xE1u, 0x07u, 12u, 31u, 23u, 59u, 60u, 0x03u
+    };
+    t_NMEA_Info *p_Info = NMEA_p_GetInfo();
+    uint32_t u_Unknown = 0u;
+
+    p_Info -> u_Time = 0u;
+    p_Info -> u_Date = 0u;
+    UBX_v_DecodeNavTimeUtc(a_TimeUtc);
+    u_Unknown = p_Info -> u_Time + p_Info -> u_Date;
+    a_TimeUtc[19u] = 0x07u;
+    UBX_v_DecodeNavTimeUtc(a_TimeUtc);
+    v_Check(((u_Unknown == 0u) && (p_Info -> u_Time == 235960u) && (p_Info -> u_Date == 311217u)) ? 1u : 0u,
+            "UBX leap second");
+  }
+
+  // IWDG: reloaded in time it never expires, left alone it does
+  WDTIM_v_Configure(HOST_IWDG_PR, HOST_IWDG_RLR);
+  WDTIM_v_Start();
+  for(uint32_t u_Cnt = 0u; u_Cnt < HOST_IWDG_FEED_COUNT; u_Cnt++)
+  {
+    vTaskDelay(pdMS_TO_TICKS(HOST_IWDG_FEED_MS));
+    WDTIM_v_Reload();
+  }
+  v_Check((SIMR_u_WatchdogResets() == 0u) ? 1u : 0u, "IWDG reloaded");
+  vTaskDelay(pdMS_TO_TICKS(HOST_SETTLE_MS));
+  v_Check((SIMR_u_WatchdogResets() != 0u) ? 1u : 0u, "IWDG expired");
+
+  printf("%s\n", (HOST_u_Failures == 0u) ? "HOST PASSED" : "HOST FAILED");
+  exit((HOST_u_Failures == 0u) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+  GPIOx -> ODR ^= GPIO_Pin;
+}
+
+void HOST_v_AssertCalled(const char *p_File, uint32_t u_Line)
+{
+  fprintf(stderr, "configASSERT failed at %s:%u\n", p_File, (unsigned int)u_Line);
+  abort();
+}
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer,
+                                   uint32_t *pulIdleTaskStackSize)
+{
+  *ppxIdleTaskTCBBuffer = &HOST_t_IdleBuffer;
+  *ppxIdleTaskStackBuffer = HOST_a_IdleStack;
+  *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer,
+                                    uint32_t *pulTimerTaskStackSize)
+{
+  *ppxTimerTaskTCBBuffer = &HOST_t_TimerBuffer;
+  *ppxTimerTaskStackBuffer = HOST_a_TimerStack;
+  *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+
+int main(int i_Argc, char **p_Argv)
+{
+  SIMR_v_Init();
+
+  // Benchmark runs without the scheduler, it plays the receive interrupt and TSK_Com itself
+  if((i_Argc > 1) && (strcmp(p_Argv[1], "bench") == 0))
+  {
+    return BENCH_i_Run(i_Argc - 1, &p_Argv[1]);
+  }
+  // Accuracy test calls the bearing kernels directly
+  if((i_Argc > 1) && (strcmp(p_Argv[1], "accur") == 0))
+  {
+    return ACCUR_i_Run(i_Argc - 1, &p_Argv[1]);
+  }
+  // Fuzz test compares CALCM_e_ParseCoordinate with the parser it replaced
+  if((i_Argc > 1) && (strcmp(p_Argv[1], "fuzz") == 0))
+  {
+    return FUZZ_i_Run(i_Argc - 1, &p_Argv[1]);
+  }
+  // Equivalence test configures the USARTs itself and drives the models by polling
+  if((i_Argc > 1) && (strcmp(p_Argv[1], "rxeq") == 0))
+  {
+    return RXEQ_i_Run(i_Argc - 1, &p_Argv[1]);
+  }
+  // Stress test only needs RINGB and two threads of its own
+  if((i_Argc > 1) && (strcmp(p_Argv[1], "stress") == 0))
+  {
+    return STRESS_i_Run(i_Argc - 1, &p_Argv[1]);
+  }
+
+  // Same order as Core/Src/main.c
+  UARTM_v_Uart2Config();
+  UARTM_v_Uart3Config();
+  I2C_v_Configure();
+  MCP23017_v_EXTI1_Configuration();
+  TIMEB_v_Init();
+  FLASHM_v_Init();
+  CALLR_v_Init();
+  FIXLOG_v_Init();
+
+  // Expander answers at its address with the buttons released, I2C transfers before the scheduler are completed by polling
+  HOST_t_Expander.u_Address = MCP23017_ADDRESS;
+  HOST_t_Expander.a_Registers[MCP23017_GPIOA] = 0xFFu;
+  SIMR_v_I2cAttach(&HOST_t_Expander);
+  MCP23017_v_Init();
+  v_Check(((HOST_t_Expander.a_Registers[MCP23017_IOCONA] != 0u) && (HOST_t_Expander.u_Writes > MCP23017_IOCONA) &&
+           (HOST_t_Expander.u_Reads == 1u)) ? 1u : 0u, "I2C1 expander init before scheduler");
+
+  SIMR_v_StartDispatcher(HOST_DISPATCHER_PRIORITY);
+  (void)xTaskCreateStatic(v_TestTask, "HOST", HOST_TEST_STACK_DEPTH, NULL, HOST_TEST_PRIORITY, HOST_a_TestStack,
+                          &HOST_t_TestBuffer);
+  vTaskStartScheduler();
+
+  // Only reached when the scheduler could not start
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,52 @@
+/// @file HOST.h
+/// @brief Header file used for the start up code and HAL replacements of the host build
+/// @author Aleksandra Petrovic
+
+#ifndef HOST_H_
+#define HOST_H_
+
+#include "FreeRTOS.h"
+
+/// Priority of the interrupt dispatcher, above every application task as interrupts are on the target
+#define HOST_DISPATCHER_PRIORITY (configMAX_PRIORITIES - 1u)
+/// Priority of the smoke test task
+#define HOST_TEST_PRIORITY (2u)
+/// Stack depth of the smoke test task
+#define HOST_TEST_STACK_DEPTH (configMINIMAL_STACK_SIZE)
+/// Time given to the models to send or receive a short frame, in ms
+#define HOST_SETTLE_MS (50u)
+/// Longest wait in ms for a block of USART2 to leave the shift register
+#define HOST_SEND_TIMEOUT_MS (2000u)
+/// IWDG prescaler used by the smoke test (divider 4)
+#define HOST_IWDG_PR (0u)
+/// IWDG reload used by the smoke test, the counter reaches zero after 32 ms
+#define HOST_IWDG_RLR (0xFFu)
+/// Period at which the smoke test reloads the watchdog, in ms
+#define HOST_IWDG_FEED_MS (10u)
+/// Number of reloads done by the smoke test
+#define HOST_IWDG_FEED_COUNT (20u)
+
+/// @brief Function called by configASSERT when a kernel assertion fails
+///
+/// @pre None
+/// @post Process is aborted
+/// @param const char *p_File, uint32_t u_Line location of the failed assertion
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation On the target a failed assertion stops the core in an endless loop, on the host the location is
+///                  printed and the process is aborted so the failure is visible to the caller of the host binary.
+/// @callsequence
+///   @startuml "HOST_v_AssertCalled.png"
+///     title "Sequence diagram for function HOST_v_AssertCalled"
+///     -> HOST: HOST_v_AssertCalled(const char *p_File, uint32_t u_Line)
+///     HOST++
+///       HOST -> Linux: abort()
+///     HOST--
+///   @enduml
+
+void HOST_v_AssertCalled(const char *p_File, uint32_t u_Line);
+
+#endif /* HOST_H_ */
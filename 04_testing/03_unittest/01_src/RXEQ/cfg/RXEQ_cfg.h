@@ -0,0 +1,31 @@
+/// @file RXEQ_cfg.h
+/// @brief Contains configuration data used for the receive path equivalence test of the host build
+/// @author Aleksandra Petrovic
+
+#ifndef RXEQ_CFG_H_
+#define RXEQ_CFG_H_
+
+#include "UARTM.h"
+
+/// Default number of bytes sent on each USART
+#define RXEQ_DEFAULT_LENGTH (16384u)
+/// Default number of received bytes between two transfer errors of the receive stream, 0 for none
+#define RXEQ_DEFAULT_ERROR_PERIOD (1000u)
+/// Largest number of bytes sent on each USART
+#define RXEQ_MAX_LENGTH (1u << 20u)
+/// Baud rate of both USARTs during the test, USART2 is raised from 9600 so the test runs in seconds
+#define RXEQ_BAUD_RATE (115200u)
+/// Bytes handed to the USART model at once, about 5 ms of the line
+#define RXEQ_CHUNK_LENGTH (64u)
+/// Time without a new byte in the ring buffer after which the line is taken as drained, in ns
+#define RXEQ_QUIET_NS (100000000ULL)
+/// Seed of the generated byte stream, both builds send the same bytes
+#define RXEQ_SEED (0x1D872B41u)
+/// Longest payload of a generated sentence between the address and '*'
+#define RXEQ_PAYLOAD_LENGTH (70u)
+/// Longest run of random bytes between generated sentences
+#define RXEQ_NOISE_LENGTH (40u)
+/// Last bytes of the stream, a sentence the GPS filter drops leaves it in its start state for the next run
+#define RXEQ_TAIL "$GPTXT*00\r\n"
+
+#endif /* RXEQ_CFG_H_ */
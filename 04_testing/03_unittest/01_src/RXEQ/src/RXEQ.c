@@ -0,0 +1,376 @@
+/// @file RXEQ.c
+/// @brief Main file used for the receive path equivalence test of the host build
+/// @author Aleksandra Petrovic
+
+#include "RXEQ.h"
+#include "RXEQ_cfg.h"
+#include "SIMR.h"
+#include "MSGM.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/// One USART of the test and the ring buffer its receive path fills
+typedef struct {
+  const char    *p_Name;        ///< Name used in the report
+  e_SIMR_Usart   e_Port;        ///< Modelled USART
+  e_RingBuffers  e_Ring;        ///< Ring buffer filled by the receive path
+} t_RXEQ_Port;
+
+/// Ports in the order they are tested and dumped
+static const t_RXEQ_Port RXEQ_a_Ports[] = {
+  {"USART3", SIMR_USART3, RING_BUFFER2},
+  {"USART2", SIMR_USART2, RING_BUFFER1}
+};
+
+/// Addresses of the generated sentences, extracted and filtered ones
+static const char * const RXEQ_a_Addresses[] = {"GPRMC", "GPGGA", "GPGSA", "GPGSV", "GPTXT", "GPGLL", "PUBX,"};
+
+/// State of the stream generator
+static uint32_t RXEQ_u_Random = RXEQ_SEED;
+
+/// @brief Function used for reading the host clock
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return uint64_t monotonic time in ns
+///
+/// @globals None
+///
+/// @InOutCorelation Function reads CLOCK_MONOTONIC, the USART models advance with the same clock.
+/// @callsequence
+///   @startuml "u_NowNs.png"
+///     title "Sequence diagram for function u_NowNs"
+///     -> RXEQ: u_NowNs()
+///     RXEQ++
+///       RXEQ -> Linux: clock_gettime(CLOCK_MONOTONIC)
+///     <- RXEQ: Returns time
+///     RXEQ--
+///   @enduml
+
+static uint64_t u_NowNs(void);
+
+static uint64_t u_NowNs(void)
+{
+  struct timespec t_Time;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &t_Time);
+  return ((uint64_t)t_Time.tv_sec * 1000000000ULL) + (uint64_t)t_Time.tv_nsec;
+}
+
+/// @brief Function used for drawing the next number of the stream generator
+///
+/// @pre None
+/// @post Generator state is advanced
+/// @param uint32_t u_Range number of possible results
+///
+/// @return uint32_t number from 0 to u_Range - 1
+///
+/// @globals RXEQ_u_Random
+///
+/// @InOutCorelation Function steps a 32 bit xorshift generator, so every build generates the same stream.
+/// @callsequence
+///   @startuml "u_Random.png"
+///     title "Sequence diagram for function u_Random"
+///     -> RXEQ: u_Random(uint32_t u_Range)
+///     RXEQ++
+///     <- RXEQ: Returns number
+///     RXEQ--
+///   @enduml
+
+static uint32_t u_Random(uint32_t u_Range);
+
+static uint32_t u_Random(uint32_t u_Range)
+{
+  RXEQ_u_Random ^= RXEQ_u_Random << 13u;
+  RXEQ_u_Random ^= RXEQ_u_Random >> 17u;
+  RXEQ_u_Random ^= RXEQ_u_Random << 5u;
+  return RXEQ_u_Random % u_Range;
+}
+
+/// @brief Function used for generating the byte stream sent on a USART
+///
+/// @pre None
+/// @post p_Stream holds u_Length bytes ending with RXEQ_TAIL
+/// @param uint8_t *p_Stream, uint32_t u_Length at least the length of RXEQ_TAIL
+///
+/// @return None
+///
+/// @globals RXEQ_a_Addresses
+///
+/// @InOutCorelation Sentences with admitted and filtered addresses alternate with runs of random bytes, which also
+///                  contain '$', '*' and line ends, so the filter of the GPS channel sees cut and broken sentences.
+///                  The filtered sentence at the end leaves the filter in its start state for the next run.
+/// @callsequence
+///   @startuml "v_Generate.png"
+///     title "Sequence diagram for function v_Generate"
+///     -> RXEQ: v_Generate(uint8_t *p_Stream, uint32_t u_Length)
+///     RXEQ++
+///       loop until the stream is full
+///         RXEQ -> RXEQ: u_Random(...)
+///       end
+///     <- RXEQ
+///     RXEQ--
+///   @enduml
+
+static void v_Generate(uint8_t *p_Stream, uint32_t u_Length);
+
+static void v_Generate(uint8_t *p_Stream, uint32_t u_Length)
+{
+  uint8_t  a_Piece[1u + 5u + RXEQ_PAYLOAD_LENGTH + 5u];
+  uint32_t u_Offset = 0u;
+  uint32_t u_Body = u_Length - (uint32_t)(sizeof(RXEQ_TAIL) - 1u);
+
+  while(u_Offset < u_Body)
+  {
+    uint32_t u_Piece = 0u;
+
+    if(u_Random(4u) != 0u)
+    {
+      const char *p_Address = RXEQ_a_Addresses[u_Random(sizeof(RXEQ_a_Addresses) / sizeof(RXEQ_a_Addresses[0]))];
+      uint32_t u_Payload = u_Random(RXEQ_PAYLOAD_LENGTH);
+
+      a_Piece[u_Piece++] = MSGM_SENTENCE_START;
+      memcpy(&a_Piece[u_Piece], p_Address, 5u);
+      u_Piece += 5u;
+      for(uint32_t u_Cnt = 0u; u_Cnt < u_Payload; u_Cnt++)
+      {
+        a_Piece[u_Piece++] = (uint8_t)(',' + u_Random('Z' - ',' + 1u));
+      }
+      a_Piece[u_Piece++] = MSGM_SENTENCE_END;
+      a_Piece[u_Piece++] = (uint8_t)('0' + u_Random(10u));
+      a_Piece[u_Piece++] = (uint8_t)('A' + u_Random(6u));
+      a_Piece[u_Piece++] = '\r';
+      a_Piece[u_Piece++] = MSGM_LINE_END;
+    }
+    else
+    {
+      uint32_t u_Noise = 1u + u_Random(RXEQ_NOISE_LENGTH);
+
+      for(uint32_t u_Cnt = 0u; u_Cnt < u_Noise; u_Cnt++)
+      {
+        a_Piece[u_Piece++] = (uint8_t)u_Random(256u);
+      }
+    }
+    if(u_Piece > (u_Body - u_Offset))
+    {
+      u_Piece = u_Body - u_Offset;
+    }
+    memcpy(&p_Stream[u_Offset], a_Piece, u_Piece);
+    u_Offset += u_Piece;
+  }
+  memcpy(&p_Stream[u_Body], RXEQ_TAIL, sizeof(RXEQ_TAIL) - 1u);
+}
+
+/// @brief Function used for sending the stream on a USART and collecting what reaches its ring buffer
+///
+/// @pre USART is configured, scheduler is not started
+/// @post Line is drained, p_Errors holds the number of transfer errors given to the receive stream
+/// @param const t_RXEQ_Port *p_Port, const uint8_t *p_Stream, uint32_t u_Length, uint32_t u_ErrorPeriod,
+///        uint8_t *p_Received, uint32_t *p_Errors
+///
+/// @return uint32_t number of collected bytes, at most u_Length
+///
+/// @globals None
+///
+/// @InOutCorelation Stream is handed to the model in chunks while the models run and the ring buffer is emptied,
+///                  so neither the queue of the model nor the ring buffer fills up. In UARTM_RX_MODE_DMA the receive
+///                  stream gets a transfer error every u_ErrorPeriod collected bytes.
+/// @callsequence
+///   @startuml "u_Receive.png"
+///     title "Sequence diagram for function u_Receive"
+///     -> RXEQ: u_Receive(...)
+///     RXEQ++
+///       loop until the stream is sent and the line is quiet
+///         RXEQ -> SIMR: SIMR_u_UsartInject(...)
+///         opt if an error is due
+///           RXEQ -> SIMR: SIMR_v_DmaError(...)
+///         end
+///         RXEQ -> SIMR: SIMR_v_Run()
+///         RXEQ -> MSGM: MSGM_u_CircularBufferPop(...)
+///       end
+///     <- RXEQ: Returns number of bytes
+///     RXEQ--
+///   @enduml
+
+static uint32_t u_Receive(const t_RXEQ_Port *p_Port, const uint8_t *p_Stream, uint32_t u_Length, uint32_t u_ErrorPeriod,
+                          uint8_t *p_Received, uint32_t *p_Errors);
+
+static uint32_t u_Receive(const t_RXEQ_Port *p_Port, const uint8_t *p_Stream, uint32_t u_Length, uint32_t u_ErrorPeriod,
+                          uint8_t *p_Received, uint32_t *p_Errors)
+{
+  uint32_t u_Sent = 0u;
+  uint32_t u_Count = 0u;
+  uint32_t u_NextError = u_ErrorPeriod;
+  uint64_t u_LastNs = u_NowNs();
+
+  *p_Errors = 0u;
+  for(;;)
+  {
+    uint64_t u_Now = u_NowNs();
+
+    if(u_Sent < u_Length)
+    {
+      uint32_t u_Chunk = ((u_Length - u_Sent) < RXEQ_CHUNK_LENGTH) ? (u_Length - u_Sent) : RXEQ_CHUNK_LENGTH;
+      u_Sent += SIMR_u_UsartInject(p_Port -> e_Port, &p_Stream[u_Sent], u_Chunk);
+      u_LastNs = u_Now;
+    }
+    if((UARTM_RX_MODE == UARTM_RX_MODE_DMA) && (u_ErrorPeriod != 0u) && (u_Count >= u_NextError))
+    {
+      SIMR_v_DmaError(p_Port -> e_Port);                          // Interrupt path has no stream which could fail
+      (*p_Errors)++;
+      u_NextError += u_ErrorPeriod;
+    }
+    SIMR_v_Run();
+    while((MSGM_b_CircularBufferIsEmpty(p_Port -> e_Ring) == b_FALSE) && (u_Count < u_Length))
+    {
+      p_Received[u_Count] = MSGM_u_CircularBufferPop(p_Port -> e_Ring);
+      u_Count++;
+      u_LastNs = u_Now;
+    }
+    if((u_Sent == u_Length) && ((u_Now - u_LastNs) > RXEQ_QUIET_NS))
+    {
+      return u_Count;
+    }
+  }
+}
+
+/// @brief Function used for making the bytes the interrupt path stores for a stream
+///
+/// @pre Line of the port is drained, filter of the ring buffer is in its start state
+/// @post Filter of the ring buffer is back in its start state
+/// @param const t_RXEQ_Port *p_Port, const uint8_t *p_Stream, uint32_t u_Length, uint8_t *p_Expected
+///
+/// @return uint32_t number of bytes the interrupt path stores
+///
+/// @globals None
+///
+/// @InOutCorelation Every byte is pushed with MSGM_u_CircularBufferPush and taken out at once, as the receive
+///                  interrupt of UARTM_RX_MODE_INTERRUPT does for a consumer which keeps up.
+/// @callsequence
+///   @startuml "u_Reference.png"
+///     title "Sequence diagram for function u_Reference"
+///     -> RXEQ: u_Reference(...)
+///     RXEQ++
+///       loop for each byte
+///         RXEQ -> MSGM: MSGM_u_CircularBufferPush(...)
+///         RXEQ -> MSGM: MSGM_u_CircularBufferPop(...)
+///       end
+///     <- RXEQ: Returns number of bytes
+///     RXEQ--
+///   @enduml
+
+static uint32_t u_Reference(const t_RXEQ_Port *p_Port, const uint8_t *p_Stream, uint32_t u_Length, uint8_t *p_Expected);
+
+static uint32_t u_Reference(const t_RXEQ_Port *p_Port, const uint8_t *p_Stream, uint32_t u_Length, uint8_t *p_Expected)
+{
+  uint32_t u_Count = 0u;
+
+  for(uint32_t u_Cnt = 0u; u_Cnt < u_Length; u_Cnt++)
+  {
+    (void)MSGM_u_CircularBufferPush(p_Port -> e_Ring, p_Stream[u_Cnt]);
+    while(MSGM_b_CircularBufferIsEmpty(p_Port -> e_Ring) == b_FALSE)
+    {
+      p_Expected[u_Count] = MSGM_u_CircularBufferPop(p_Port -> e_Ring);
+      u_Count++;
+    }
+  }
+  return u_Count;
+}
+
+int RXEQ_i_Run(int i_Argc, char **p_Argv)
+{
+  const char *p_Dump = NULL;
+  uint32_t u_Length = RXEQ_DEFAULT_LENGTH;
+  uint32_t u_ErrorPeriod = RXEQ_DEFAULT_ERROR_PERIOD;
+  uint8_t *p_Stream = NULL;
+  uint8_t *p_Received = NULL;
+  uint8_t *p_Expected = NULL;
+  FILE *p_File = NULL;
+  uint32_t u_Failures = 0u;
+  int i_Option = 0;
+
+  optind = 1;
+  while((i_Option = getopt(i_Argc, p_Argv, "n:e:o:")) != -1)
+  {
+    switch(i_Option)
+    {
+    case 'n':
+      u_Length = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 'e':
+      u_ErrorPeriod = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 'o':
+      p_Dump = optarg;
+      break;
+    default:
+      fprintf(stderr, "usage: rxeq [-n bytes] [-e error period] [-o dump]\n");
+      return 1;
+    }
+  }
+  if((u_Length < sizeof(RXEQ_TAIL)) || (u_Length > RXEQ_MAX_LENGTH))
+  {
+    fprintf(stderr, "rxeq: -n must be %u to %u\n", (unsigned int)sizeof(RXEQ_TAIL), (unsigned int)RXEQ_MAX_LENGTH);
+    return 1;
+  }
+
+  p_Stream = malloc(u_Length);
+  p_Received = malloc((size_t)u_Length * (sizeof(RXEQ_a_Ports) / sizeof(RXEQ_a_Ports[0])));
+  p_Expected = malloc(u_Length);
+  if((p_Stream == NULL) || (p_Received == NULL) || (p_Expected == NULL) ||
+     ((p_Dump != NULL) && ((p_File = fopen(p_Dump, "wb")) == NULL)))
+  {
+    fprintf(stderr, "rxeq: cannot allocate the streams or open %s\n", (p_Dump != NULL) ? p_Dump : "the dump");
+    free(p_Stream);
+    free(p_Received);
+    free(p_Expected);
+    return 1;
+  }
+
+  // Same order as Core/Src/main.c, then USART2 runs at the rate of USART3
+  UARTM_v_Uart2Config();
+  UARTM_v_Uart3Config();
+  UARTM2_v_SetBaudRate(RXEQ_BAUD_RATE);
+  v_Generate(p_Stream, u_Length);
+
+  for(uint8_t u_Cnt = 0u; u_Cnt < (uint8_t)(sizeof(RXEQ_a_Ports) / sizeof(RXEQ_a_Ports[0])); u_Cnt++)
+  {
+    const t_RXEQ_Port *p_Port = &RXEQ_a_Ports[u_Cnt];
+    uint8_t *p_Collected = &p_Received[(size_t)u_Cnt * u_Length];
+    uint32_t u_Restarts = UARTM_u_GetDmaRestarts();
+    uint32_t u_Errors = 0u;
+    uint32_t u_Count = u_Receive(p_Port, p_Stream, u_Length, u_ErrorPeriod, p_Collected, &u_Errors);
+    uint32_t u_ExpectedCount = u_Reference(p_Port, p_Stream, u_Length, p_Expected);
+    uint8_t u_Passed = ((u_Count == u_ExpectedCount) && (memcmp(p_Collected, p_Expected, u_Count) == 0) &&
+                        (SIMR_u_UsartOverruns(p_Port -> e_Port) == 0u) && (MSGM_u_Dropped(p_Port -> e_Ring) == 0u) &&
+                        ((UARTM_u_GetDmaRestarts() - u_Restarts) == u_Errors)) ? 1u : 0u;
+
+    printf("%s %s %s: %u of %u bytes stored, %u expected, %u overruns, %u dropped, %u stream errors, %u restarts\n",
+           (u_Passed == 1u) ? "PASS" : "FAIL", (UARTM_RX_MODE == UARTM_RX_MODE_DMA) ? "dma" : "interrupt",
+           p_Port -> p_Name, (unsigned int)u_Count, (unsigned int)u_Length, (unsigned int)u_ExpectedCount,
+           (unsigned int)SIMR_u_UsartOverruns(p_Port -> e_Port), (unsigned int)MSGM_u_Dropped(p_Port -> e_Ring),
+           (unsigned int)u_Errors, (unsigned int)(UARTM_u_GetDmaRestarts() - u_Restarts));
+    if(u_Passed == 0u)
+    {
+      u_Failures++;
+    }
+    if((p_File != NULL) && (fwrite(p_Collected, 1u, u_Count, p_File) != u_Count))
+    {
+      u_Failures++;
+    }
+  }
+
+  if(p_File != NULL)
+  {
+    u_Failures += (fclose(p_File) == 0) ? 0u : 1u;
+  }
+  free(p_Stream);
+  free(p_Received);
+  free(p_Expected);
+  return (u_Failures == 0u) ? 0 : 1;
+}
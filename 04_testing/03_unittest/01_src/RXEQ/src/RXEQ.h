@@ -0,0 +1,50 @@
+/// @file RXEQ.h
+/// @brief Header file used for the receive path equivalence test of the host build
+/// @author Aleksandra Petrovic
+///
+/// A generated stream of NMEA sentences and random bytes is sent on USART3 and then on USART2 through the USART
+/// models, the bytes which reach RING_BUFFER2 and RING_BUFFER1 are collected. In UARTM_RX_MODE_DMA the receive
+/// stream is failed with a transfer error every few hundred bytes, so the recovery of the DMA1 stream interrupts is
+/// part of the path. Each run compares the collected bytes with the bytes the interrupt path stores, which are made
+/// by pushing the stream one byte at a time as USART2_IRQHandler and USART3_IRQHandler do. The host_rxeq make
+/// target also compares the dump of a DMA build with the dump of an interrupt build byte by byte.
+
+#ifndef RXEQ_H_
+#define RXEQ_H_
+
+/// @brief Function used for running the equivalence test from the command line of the host binary
+///
+/// @pre SIMR_v_Init must be done, scheduler is not started, USARTs are not configured
+/// @post Result is printed, received bytes of USART3 followed by those of USART2 are written to the dump file
+/// @param int i_Argc, char **p_Argv options after "rxeq":
+///        -n bytes sent on each USART, -e received bytes between transfer errors of the receive stream (0 none,
+///        only used in UARTM_RX_MODE_DMA), -o dump file
+///
+/// @return int 0 when both USARTs received what the interrupt path stores without overrun, drop or missed restart,
+///         1 otherwise or for wrong options
+///
+/// @globals None
+///
+/// @InOutCorelation Function configures USART2 and USART3 as main.c does, sends the stream on each of them while
+///                  it calls SIMR_v_Run and empties the ring buffer, and checks the result.
+/// @callsequence
+///   @startuml "RXEQ_i_Run.png"
+///     title "Sequence diagram for function RXEQ_i_Run"
+///     -> RXEQ: RXEQ_i_Run(int i_Argc, char **p_Argv)
+///     RXEQ++
+///       RXEQ -> UARTM: UARTM_v_Uart2Config(), UARTM_v_Uart3Config(), UARTM2_v_SetBaudRate(RXEQ_BAUD_RATE)
+///       RXEQ -> RXEQ: v_Generate(...)
+///       loop for USART3 and USART2
+///         RXEQ -> RXEQ: u_Receive(...)
+///         RXEQ -> RXEQ: u_Reference(...)
+///       end
+///       opt if dump file is given
+///         RXEQ -> Linux: fopen(), fwrite()
+///       end
+///     <- RXEQ: Returns status
+///     RXEQ--
+///   @enduml
+
+int RXEQ_i_Run(int i_Argc, char **p_Argv);
+
+#endif /* RXEQ_H_ */
@@ -0,0 +1,64 @@
+/// @file SIMR_cfg.h
+/// @brief Contains configuration data used for the simulated peripheral registers of the host build
+/// @author Aleksandra Petrovic
+
+#ifndef SIMR_CFG_H_
+#define SIMR_CFG_H_
+
+#include "stm32f439xx.h"
+#include "Registers.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/// Start of the peripheral region mapped at its target address (APB1, APB2, AHB1)
+#define SIMR_PERIPH_BASE (0x40000000UL)
+/// Size of the mapped peripheral region
+#define SIMR_PERIPH_SIZE (0x00080000UL)
+/// Start of the core peripheral region mapped at its target address (DWT, NVIC, SCB, CoreDebug)
+#define SIMR_CORE_BASE (0xE0000000UL)
+/// Size of the mapped core peripheral region
+#define SIMR_CORE_SIZE (0x00100000UL)
+/// Start of the flash region mapped at its target address, sectors 21 to 23 which hold data
+#define SIMR_FLASH_BASE (0x081A0000UL)
+/// Size of the mapped flash region
+#define SIMR_FLASH_SIZE (0x00060000UL)
+/// First sector in SIMR_FLASH_BASE, sectors from 17 on are 128 KB
+#define SIMR_FLASH_FIRST_SECTOR (21u)
+/// Size of a sector in the mapped flash region
+#define SIMR_FLASH_SECTOR_SIZE (0x00020000UL)
+/// First key which unlocks FLASH_CR
+#define SIMR_FLASH_KEY1 (0x45670123UL)
+/// Second key which unlocks FLASH_CR
+#define SIMR_FLASH_KEY2 (0xCDEF89ABUL)
+
+/// Core clock used for the DWT cycle counter
+#define SIMR_CORE_CLOCK_HZ (180000000ULL)
+/// Clock of APB1 timers (TIM5)
+#define SIMR_APB1_TIMER_CLOCK_HZ (90000000ULL)
+/// Clock of APB1 peripherals, BRR of USART2 and USART3 is computed for it
+#define SIMR_PCLK1_HZ (45000000ULL)
+/// Clock of the independent watchdog
+#define SIMR_LSI_HZ (32000ULL)
+
+/// Bits on the line per byte (start, 8 data, stop)
+#define SIMR_USART_FRAME_BITS (10ULL)
+/// Length of the queue of bytes waiting to be received and of the capture of transmitted bytes, per USART
+#define SIMR_USART_BUFFER_LENGTH (4096u)
+/// Upper half of DR while software has not written it, a store of a data byte always changes the value
+#define SIMR_DR_MARK (0x5A5A0000UL)
+
+/// Number of I2C devices which can be attached to the simulated I2C1 bus
+#define SIMR_I2C_DEVICE_COUNT (4u)
+
+/// Number of interrupt lines of the simulated NVIC (STM32F439)
+#define SIMR_IRQ_COUNT (91u)
+/// Number of execution contexts (tasks, start up code) whose last register read can be pending
+#define SIMR_CONTEXT_COUNT (16u)
+/// Most interrupts taken in one run, stops a handler which never clears its source
+#define SIMR_DISPATCH_LIMIT (256u)
+/// Period of the interrupt dispatcher task in ticks
+#define SIMR_DISPATCH_PERIOD_TICKS (1u)
+/// Stack depth of the interrupt dispatcher task
+#define SIMR_DISPATCH_STACK_DEPTH (configMINIMAL_STACK_SIZE)
+
+#endif /* SIMR_CFG_H_ */
@@ -0,0 +1,1975 @@
+/// @file SIMR.c
+/// @brief Main file used for the simulated peripheral registers of the host build
+/// @author Aleksandra Petrovic
+
+#include "SIMR_cfg.h"
+#include <sys/mman.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef MAP_FIXED_NOREPLACE
+/// Older C libraries do not define it, the mapped address is checked anyway
+#define MAP_FIXED_NOREPLACE (0x100000)
+#endif
+
+/// Access to a mapped register without going through the models
+#define SIMR_RAW(address) (*((volatile uint32_t *)(uintptr_t)(address)))
+/// rc_w0 error flags of I2C SR1 (BERR, ARLO, AF, OVR, PECERR, TIMEOUT, SMBALERT)
+#define SIMR_I2C_SR1_ERRORS (I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF | I2C_SR1_OVR | I2C_SR1_PECERR | \
+                             I2C_SR1_TIMEOUT | I2C_SR1_SMBALERT)
+/// rc_w0 flags of USART SR
+#define SIMR_USART_SR_RCW0 (USART_SR_RXNE | USART_SR_TC | USART_SR_LBD | USART_SR_CTS)
+/// Flags of stream 1 in LISR, stream 5 has the same bits in HISR
+#define SIMR_DMA_STREAM_FLAGS (DMA_LISR_FEIF1 | DMA_LISR_DMEIF1 | DMA_LISR_TEIF1 | DMA_LISR_HTIF1 | DMA_LISR_TCIF1)
+
+/// Model of one DMA1 stream in peripheral to memory mode, the peripheral is the USART which owns it
+typedef struct {
+  uint32_t u_CrAddress;                         ///< Address of SxCR
+  uint32_t u_NdtrAddress;                       ///< Address of SxNDTR
+  uint32_t u_M0arAddress;                       ///< Address of SxM0AR
+  uint32_t u_IsrAddress;                        ///< Address of LISR or HISR
+  uint32_t u_IfcrAddress;                       ///< Address of LIFCR or HIFCR
+  int32_t  i_Irq;                               ///< Interrupt line
+  uint32_t u_CrShadow;                          ///< Value published in SxCR
+  uint32_t u_NdtrShadow;                        ///< Value published in SxNDTR
+  uint32_t u_Reload;                            ///< SxNDTR when the stream was enabled, used again in circular mode
+  uint32_t u_Flags;                             ///< Flags published in the stream bits of LISR or HISR
+} t_SIMR_DmaStream;
+
+/// Model of one USART
+typedef struct {
+  uint32_t u_SrAddress;                         ///< Address of SR
+  uint32_t u_DrAddress;                         ///< Address of DR
+  uint32_t u_BrrAddress;                        ///< Address of BRR
+  uint32_t u_Cr1Address;                        ///< Address of CR1
+  uint32_t u_Cr3Address;                        ///< Address of CR3
+  int32_t  i_Irq;                               ///< Interrupt line
+  t_SIMR_DmaStream *p_Dma;                      ///< Stream which serves the receive requests when DMAR is set
+  uint32_t u_Sr;                                ///< Status flags published in SR
+  uint32_t u_DrShadow;                          ///< Value published in DR
+  uint8_t  u_Rdr;                               ///< Received byte
+  uint8_t  u_Tdr;                               ///< Byte waiting for the shift register
+  uint8_t  b_TdrFull;                           ///< 1 when u_Tdr holds a byte
+  uint8_t  b_Shifting;                          ///< 1 while a byte is on the TX line
+  uint8_t  u_Shift;                             ///< Byte on the TX line
+  uint8_t  b_IdlePending;                       ///< 1 when IDLE is set after the current frame
+  uint64_t u_TxDoneNs;                          ///< Time the byte on the TX line is sent
+  uint64_t u_RxDueNs;                           ///< Time the next queued byte is received
+  uint64_t u_IdleDueNs;                         ///< Time the RX line is detected idle
+  uint8_t  a_Rx[SIMR_USART_BUFFER_LENGTH];      ///< Bytes waiting to be received
+  uint32_t u_RxHead;                            ///< Index where the next byte is queued
+  uint32_t u_RxTail;                            ///< Index of the next byte to receive
+  uint8_t  a_Tx[SIMR_USART_BUFFER_LENGTH];      ///< Transmitted bytes
+  uint32_t u_TxHead;                            ///< Index where the next transmitted byte is stored
+  uint32_t u_TxTail;                            ///< Index of the oldest transmitted byte
+  uint32_t u_Overruns;                          ///< Bytes lost because RXNE was set
+} t_SIMR_Usart;
+
+/// Bus states of the I2C1 model
+typedef enum {
+  SIMR_I2C_IDLE,      ///< Bus is free
+  SIMR_I2C_START,     ///< START was generated, address byte is expected
+  SIMR_I2C_ADDRESS,   ///< Address byte is on the bus
+  SIMR_I2C_TRANSMIT,  ///< Master transmits to the device
+  SIMR_I2C_RECEIVE,   ///< Master receives from the device
+  SIMR_I2C_NACKED     ///< Address was not acknowledged, bus is held until STOP
+} e_SIMR_I2cState;
+
+/// Model of I2C1 in master mode
+typedef struct {
+  e_SIMR_I2cState e_State;                            ///< Bus state
+  uint32_t u_Sr1;                                     ///< Flags published in SR1
+  uint32_t u_Sr2;                                     ///< Flags published in SR2
+  uint32_t u_Cr1Shadow;                               ///< Value published in CR1
+  uint32_t u_DrShadow;                                ///< Value published in DR
+  uint8_t  u_Dr;                                      ///< Received byte
+  uint8_t  u_Address;                                 ///< Address byte written after START
+  uint8_t  u_TxData;                                  ///< Data byte waiting to be sent
+  uint8_t  b_TxPending;                               ///< 1 when u_TxData is not sent yet
+  uint8_t  b_LastByte;                                ///< 1 when the last received byte was not acknowledged
+  uint8_t  b_StopPending;                             ///< 1 when STOP follows the byte being received
+  t_SIMR_I2cDevice *p_Device;                         ///< Addressed device
+  t_SIMR_I2cDevice *a_Devices[SIMR_I2C_DEVICE_COUNT]; ///< Attached devices
+  uint8_t  u_DeviceCount;                             ///< Number of attached devices
+} t_SIMR_I2c;
+
+/// Model of the independent watchdog
+typedef struct {
+  uint8_t  b_Started;       ///< 1 after 0xCCCC was written
+  uint8_t  b_Unlocked;      ///< 1 after 0x5555 was written, PR and RLR can be changed
+  uint32_t u_PrShadow;      ///< Value published in PR
+  uint32_t u_RlrShadow;     ///< Value published in RLR
+  uint64_t u_ReloadNs;      ///< Time the counter was last reloaded
+  uint32_t u_Resets;        ///< Number of times the counter reached zero
+} t_SIMR_Iwdg;
+
+/// Model of a free running counter (TIM5 CNT, DWT CYCCNT)
+typedef struct {
+  uint8_t  b_Running;       ///< 1 while the counter counts
+  uint32_t u_Shadow;        ///< Value published in the counter register
+  uint32_t u_Base;          ///< Counter value at u_BaseNs
+  uint64_t u_BaseNs;        ///< Time the counter was started or written
+  uint64_t u_Hz;            ///< Counting frequency
+} t_SIMR_Counter;
+
+/// Model of the flash interface, programming stores go to the mapped flash directly
+typedef struct {
+  uint8_t  b_Key1;          ///< 1 after the first key was written to KEYR
+  uint32_t u_CrShadow;      ///< Value published in CR
+  uint32_t u_Erases;        ///< Number of sector erases
+} t_SIMR_Flash;
+
+/// Register read of one execution context whose side effect is not applied yet
+typedef struct {
+  void    *p_Key;           ///< Task handle, NULL before the scheduler starts
+  uint32_t u_Address;       ///< Register, 0 when nothing is pending
+} t_SIMR_Context;
+
+/// Interrupt handler which can be called by the dispatcher
+typedef struct {
+  int32_t i_Irq;            ///< Interrupt line
+  void (*p_Handler)(void);  ///< Handler defined by a module
+} t_SIMR_Vector;
+
+void USART2_IRQHandler(void);
+void USART3_IRQHandler(void);
+void I2C1_EV_IRQHandler(void);
+void I2C1_ER_IRQHandler(void);
+void EXTI1_IRQHandler(void);
+// Defined by UARTM only when it receives through DMA, like the weak defaults of the startup file on the target
+void DMA1_Stream1_IRQHandler(void) __attribute__((weak));
+void DMA1_Stream5_IRQHandler(void) __attribute__((weak));
+
+/// Handlers of the modelled interrupt sources, a NULL handler is never called
+static const t_SIMR_Vector SIMR_a_Vectors[] = {
+  {DMA1_Stream1_IRQn, DMA1_Stream1_IRQHandler},
+  {DMA1_Stream5_IRQn, DMA1_Stream5_IRQHandler},
+  {USART2_IRQn,   USART2_IRQHandler},
+  {USART3_IRQn,   USART3_IRQHandler},
+  {I2C1_EV_IRQn,  I2C1_EV_IRQHandler},
+  {I2C1_ER_IRQn,  I2C1_ER_IRQHandler},
+  {EXTI1_IRQn,    EXTI1_IRQHandler}
+};
+
+/// Models of USART2 and USART3
+static t_SIMR_Usart SIMR_a_Usart[SIMR_USART_COUNT];
+/// Models of the receive streams of USART2 (DMA1 Stream5) and USART3 (DMA1 Stream1)
+static t_SIMR_DmaStream SIMR_a_Dma[SIMR_USART_COUNT];
+/// Model of I2C1
+static t_SIMR_I2c SIMR_t_I2c;
+/// Model of IWDG
+static t_SIMR_Iwdg SIMR_t_Iwdg;
+/// Model of the flash interface
+static t_SIMR_Flash SIMR_t_Flash;
+/// Model of TIM5 counter
+static t_SIMR_Counter SIMR_t_Tim5;
+/// Model of DWT cycle counter
+static t_SIMR_Counter SIMR_t_Cyccnt;
+/// Pending register reads
+static t_SIMR_Context SIMR_a_Contexts[SIMR_CONTEXT_COUNT];
+/// Enable bits of the simulated NVIC
+static uint8_t SIMR_a_NvicEnabled[SIMR_IRQ_COUNT];
+/// Software pending bits of the simulated NVIC
+static uint8_t SIMR_a_NvicPending[SIMR_IRQ_COUNT];
+/// Priorities of the simulated NVIC
+static uint8_t SIMR_a_NvicPriority[SIMR_IRQ_COUNT];
+/// Simulated PRIMASK
+static volatile uint32_t SIMR_u_Primask = 0u;
+/// 1 when setting PRIMASK entered a FreeRTOS critical section
+static uint8_t SIMR_b_PrimaskCritical = 0u;
+/// Exception number of the running handler, 0 in thread mode
+static volatile uint32_t SIMR_u_Ipsr = 0u;
+/// 1 while SIMR_v_Run is active
+static uint8_t SIMR_b_Running = 0u;
+/// Depth of nested v_Lock sections
+static uint32_t SIMR_u_LockNesting = 0u;
+/// Signal mask restored by the outermost v_Unlock
+static sigset_t SIMR_t_SavedSignals;
+/// 1 after the register file is mapped
+static uint8_t SIMR_b_Mapped = 0u;
+/// Interrupt dispatcher task
+static TaskHandle_t SIMR_t_Dispatcher = NULL;
+/// Memory of the dispatcher task
+static StaticTask_t SIMR_t_DispatcherBuffer;
+/// Stack of the dispatcher task
+static StackType_t SIMR_a_DispatcherStack[SIMR_DISPATCH_STACK_DEPTH];
+
+/// @brief Function used for reading the host monotonic clock
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return uint64_t nanoseconds
+///
+/// @globals None
+///
+/// @InOutCorelation Models advance with wall clock time, so baud rates and timeouts behave as on the target.
+/// @callsequence
+///   @startuml "u_NowNs.png"
+///     title "Sequence diagram for function u_NowNs"
+///     -> SIMR: u_NowNs()
+///     SIMR++
+///     <- SIMR: Returns CLOCK_MONOTONIC in nanoseconds
+///     SIMR--
+///   @enduml
+
+static uint64_t u_NowNs(void);
+
+static uint64_t u_NowNs(void)
+{
+  struct timespec t_Now;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &t_Now);
+  return ((uint64_t)t_Now.tv_sec * 1000000000ULL) + (uint64_t)t_Now.tv_nsec;
+}
+
+/// @brief Function used for checking if the scheduler was started
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return uint8_t 1 when FreeRTOS is running or suspended
+///
+/// @globals None
+///
+/// @InOutCorelation Critical sections and task handles are only used after the scheduler starts.
+/// @callsequence
+///   @startuml "u_Started.png"
+///     title "Sequence diagram for function u_Started"
+///     -> SIMR: u_Started()
+///     SIMR++
+///       SIMR -> FreeRTOS: xTaskGetSchedulerState()
+///     <- SIMR: Returns uint8_t
+///     SIMR--
+///   @enduml
+
+static uint8_t u_Started(void);
+
+static uint8_t u_Started(void)
+{
+  return (uint8_t)((xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) ? 0u : 1u);
+}
+
+/// @brief Function used for locking the models
+///
+/// @pre None
+/// @post Signals of the calling thread are blocked until the matching v_Unlock
+/// @param None
+///
+/// @return None
+///
+/// @globals SIMR_u_LockNesting, SIMR_t_SavedSignals
+///
+/// @InOutCorelation The POSIX port delivers the tick as a signal, blocking it keeps the running task from being
+///                  switched out while it updates the models. Unlike taskENTER_CRITICAL it can also be used by the
+///                  kernel itself, run time statistics read the cycle counter during a context switch.
+/// @callsequence
+///   @startuml "v_Lock.png"
+///     title "Sequence diagram for function v_Lock"
+///     -> SIMR: v_Lock()
+///     SIMR++
+///       SIMR -> Linux: pthread_sigmask(SIG_BLOCK, ...)
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+static void v_Lock(void);
+
+static void v_Lock(void)
+{
+  sigset_t t_All;
+  sigset_t t_Previous;
+
+  (void)sigfillset(&t_All);
+  (void)pthread_sigmask(SIG_BLOCK, &t_All, &t_Previous);
+  if(SIMR_u_LockNesting == 0u)
+  {
+    SIMR_t_SavedSignals = t_Previous;
+  }
+  SIMR_u_LockNesting++;
+}
+
+/// @brief Function used for unlocking the models
+///
+/// @pre v_Lock must be called before
+/// @post Signal mask of the outermost v_Lock is restored
+/// @param None
+///
+/// @return None
+///
+/// @globals SIMR_u_LockNesting, SIMR_t_SavedSignals
+///
+/// @InOutCorelation Function ends the section started by v_Lock, nested sections keep the signals blocked.
+/// @callsequence
+///   @startuml "v_Unlock.png"
+///     title "Sequence diagram for function v_Unlock"
+///     -> SIMR: v_Unlock()
+///     SIMR++
+///       opt if outermost section
+///         SIMR -> Linux: pthread_sigmask(SIG_SETMASK, ...)
+///       end
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+static void v_Unlock(void);
+
+static void v_Unlock(void)
+{
+  SIMR_u_LockNesting--;
+  if(SIMR_u_LockNesting == 0u)
+  {
+    (void)pthread_sigmask(SIG_SETMASK, &SIMR_t_SavedSignals, NULL);
+  }
+}
+
+/// @brief Function used for mapping a region of the register file
+///
+/// @pre None
+/// @post Region is readable and writable at its target address
+/// @param uintptr_t u_Base, size_t u_Size
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Function maps anonymous zeroed memory at the exact address, the process exits when it is taken.
+/// @callsequence
+///   @startuml "v_Map.png"
+///     title "Sequence diagram for function v_Map"
+///     -> SIMR: v_Map(uintptr_t u_Base, size_t u_Size)
+///     SIMR++
+///       SIMR -> Linux: mmap(u_Base, u_Size, ...)
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+static void v_Map(uintptr_t u_Base, size_t u_Size);
+
+static void v_Map(uintptr_t u_Base, size_t u_Size)
+{
+  void *p_Region = mmap((void *)u_Base, u_Size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+  if(p_Region != (void *)u_Base)
+  {
+    fprintf(stderr, "SIMR: cannot map registers at 0x%08lX\n", (unsigned long)u_Base);
+    exit(EXIT_FAILURE);
+  }
+}
+
+/// @brief Function used for computing the time of one USART frame
+///
+/// @pre None
+/// @post None
+/// @param const t_SIMR_Usart *p_Usart
+///
+/// @return uint64_t nanoseconds per byte, 0 when BRR is not set
+///
+/// @globals None
+///
+/// @InOutCorelation With 16 times oversampling baud rate is PCLK1 / BRR.
+/// @callsequence
+///   @startuml "u_FrameNs.png"
+///     title "Sequence diagram for function u_FrameNs"
+///     -> SIMR: u_FrameNs(const t_SIMR_Usart *p_Usart)
+///     SIMR++
+///     <- SIMR: Returns frame time
+///     SIMR--
+///   @enduml
+
+static uint64_t u_FrameNs(const t_SIMR_Usart *p_Usart);
+
+static uint64_t u_FrameNs(const t_SIMR_Usart *p_Usart)
+{
+  uint64_t u_Brr = SIMR_RAW(p_Usart -> u_BrrAddress) & 0xFFFFu;
+
+  return (SIMR_USART_FRAME_BITS * 1000000000ULL * u_Brr) / SIMR_PCLK1_HZ;
+}
+
+/// @brief Function used for publishing SR and DR of a USART
+///
+/// @pre None
+/// @post Registers hold the model values
+/// @param t_SIMR_Usart *p_Usart
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation DR gets SIMR_DR_MARK in its upper half, so a store of a data byte is always a change.
+/// @callsequence
+///   @startuml "v_UsartPublish.png"
+///     title "Sequence diagram for function v_UsartPublish"
+///     -> SIMR: v_UsartPublish(t_SIMR_Usart *p_Usart)
+///     SIMR++
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+static void v_UsartPublish(t_SIMR_Usart *p_Usart);
+
+static void v_UsartPublish(t_SIMR_Usart *p_Usart)
+{
+  SIMR_RAW(p_Usart -> u_SrAddress) = p_Usart -> u_Sr;
+  p_Usart -> u_DrShadow = SIMR_DR_MARK | p_Usart -> u_Rdr;
+  SIMR_RAW(p_Usart -> u_DrAddress) = p_Usart -> u_DrShadow;
+}
+
+/// @brief Function used for handling stores to SR and DR of a USART
+///
+/// @pre Called with the models locked
+/// @post A written byte is in the shift register or waits in TDR, cleared flags are cleared
+/// @param t_SIMR_Usart *p_Usart, uint64_t u_Now
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Writing DR clears TC, the byte goes to the shift register at once when the line is free,
+///                  otherwise TXE stays cleared until the shift register is free. Writing 0 to RXNE or TC clears it.
+/// @callsequence
+///   @startuml "v_UsartDetect.png"
+///     title "Sequence diagram for function v_UsartDetect"
+///     -> SIMR: v_UsartDetect(t_SIMR_Usart *p_Usart, uint64_t u_Now)
+///     SIMR++
+///       opt if DR differs from the published value
+///         rnote over SIMR: Byte is transmitted.
+///       end
+///       opt if SR differs from the published value
+///         rnote over SIMR: rc_w0 flags written with 0 are cleared.
+///       end
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+static void v_UsartDetect(t_SIMR_Usart *p_Usart, uint64_t u_Now);
+
+static void v_UsartDetect(t_SIMR_Usart *p_Usart, uint64_t u_Now)
+{
+  uint32_t u_Dr = SIMR_RAW(p_Usart -> u_DrAddress);
+  uint32_t u_Sr = SIMR_RAW(p_Usart -> u_SrAddress);
+
+  if(u_Sr != p_Usart -> u_Sr)
+  {
+    p_Usart -> u_Sr &= (u_Sr | ~(uint32_t)SIMR_USART_SR_RCW0);
+  }
+  if(u_Dr != p_Usart -> u_DrShadow)
+  {
+    if((SIMR_RAW(p_Usart -> u_Cr1Address) & USART_CR1_TE) != 0u)
+    {
+      p_Usart -> u_Sr &= ~(uint32_t)USART_SR_TC;
+      if(p_Usart -> b_Shifting == 0u)
+      {
+        p_Usart -> u_Shift = (uint8_t)u_Dr;
+        p_Usart -> b_Shifting = 1u;
+        p_Usart -> u_TxDoneNs = u_Now + u_FrameNs(p_Usart);
+        p_Usart -> u_Sr |= USART_SR_TXE;
+      }
+      else
+      {
+        p_Usart -> u_Tdr = (uint8_t)u_Dr;
+        p_Usart -> b_TdrFull = 1u;
+        p_Usart -> u_Sr &= ~(uint32_t)USART_SR_TXE;
+      }
+    }
+  }
+  v_UsartPublish(p_Usart);
+}
+
+/// @brief Function used for the side effect of reading DR of a USART
+///
+/// @pre Called with the models locked
+/// @post RXNE, IDLE and ORE are cleared
+/// @param t_SIMR_Usart *p_Usart
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Reading DR empties the receive register, after a read of SR it also clears IDLE and ORE.
+/// @callsequence
+///   @startuml "v_UsartRead.png"
+///     title "Sequence diagram for function v_UsartRead"
+///     -> SIMR: v_UsartRead(t_SIMR_Usart *p_Usart)
+///     SIMR++
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+static void v_UsartRead(t_SIMR_Usart *p_Usart);
+
+static void v_UsartRead(t_SIMR_Usart *p_Usart)
+{
+  p_Usart -> u_Sr &= ~(uint32_t)(USART_SR_RXNE | USART_SR_IDLE | USART_SR_ORE);
+  v_UsartPublish(p_Usart);
+}
+
+/// @brief Function used for publishing SxCR, SxNDTR and the flags of a DMA stream
+///
+/// @pre None
+/// @post Registers hold the model values
+/// @param t_SIMR_DmaStream *p_Dma
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Only the stream bits of the shared LISR or HISR are replaced, the clear register reads as 0.
+/// @callsequence
+///   @startuml "v_DmaPublish.png"
+///     title "Sequence diagram for function v_DmaPublish"
+///     -> SIMR: v_DmaPublish(t_SIMR_DmaStream *p_Dma)
+///     SIMR++
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+static void v_DmaPublish(t_SIMR_DmaStream *p_Dma);
+
+static void v_DmaPublish(t_SIMR_DmaStream *p_Dma)
+{
+  SIMR_RAW(p_Dma -> u_CrAddress) = p_Dma -> u_CrShadow;
+  SIMR_RAW(p_Dma -> u_NdtrAddress) = p_Dma -> u_NdtrShadow;
+  SIMR_RAW(p_Dma -> u_IsrAddress) = (SIMR_RAW(p_Dma -> u_IsrAddress) & ~(uint32_t)SIMR_DMA_STREAM_FLAGS) | p_Dma -> u_Flags;
+  SIMR_RAW(p_Dma -> u_IfcrAddress) = 0u;
+}
+
+/// @brief Function used for moving one received byte to memory through a DMA stream
+///
+/// @pre Called with the models locked, the stream is enabled
+/// @post Byte is in memory, SxNDTR is decremented and HTIF or TCIF is set when half or all of the data is moved
+/// @param t_SIMR_DmaStream *p_Dma, uint8_t u_Byte
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation SxM0AR is a host address, the host build is linked without PIE so static buffers are below 4 GB.
+///                  The memory address increments with every byte. When SxNDTR reaches 0 it is reloaded in circular
+///                  mode, otherwise the stream is disabled.
+/// @callsequence
+///   @startuml "v_DmaTransfer.png"
+///     title "Sequence diagram for function v_DmaTransfer"
+///     -> SIMR: v_DmaTransfer(t_SIMR_DmaStream *p_Dma, uint8_t u_Byte)
+///     SIMR++
+///       rnote over SIMR: Byte is stored at SxM0AR plus the number of bytes moved.
+///       opt if SxNDTR reached 0
+///         rnote over SIMR: TCIF is set, SxNDTR is reloaded or EN is cleared.
+///       end
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+static void v_DmaTransfer(t_SIMR_DmaStream *p_Dma, uint8_t u_Byte);
+
+static void v_DmaTransfer(t_SIMR_DmaStream *p_Dma, uint8_t u_Byte)
+{
+  uint32_t u_Index = p_Dma -> u_Reload - p_Dma -> u_NdtrShadow;
+
+  *((volatile uint8_t *)(uintptr_t)(SIMR_RAW(p_Dma -> u_M0arAddress) + u_Index)) = u_Byte;
+  p_Dma -> u_NdtrShadow--;
+  if(p_Dma -> u_NdtrShadow == (p_Dma -> u_Reload / 2u))
+  {
+    p_Dma -> u_Flags |= DMA_LISR_HTIF1;
+  }
+  if(p_Dma -> u_NdtrShadow == 0u)
+  {
+    p_Dma -> u_Flags |= DMA_LISR_TCIF1;
+    if((p_Dma -> u_CrShadow & DMA_SxCR_CIRC) != 0u)
+    {
+      p_Dma -> u_NdtrShadow = p_Dma -> u_Reload;
+    }
+    else
+    {
+      p_Dma -> u_CrShadow &= ~(uint32_t)DMA_SxCR_EN;
+    }
+  }
+  v_DmaPublish(p_Dma);
+}
+
+/// @brief Function used for handling stores to the registers of the receive stream of a USART
+///
+/// @pre Called with the models locked
+/// @post Cleared flags are cleared, the stream is enabled or disabled as written
+/// @param t_SIMR_Usart *p_Usart
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation SxNDTR and the configuration in SxCR can only be written while the stream is disabled, then
+///                  only EN can be cleared. Writing 1 to a bit of the clear register clears the flag. When EN is set
+///                  SxNDTR is latched for circular mode and a byte waiting in DR is moved at once, as the receive
+///                  request of the USART stays active until DR is read.
+/// @callsequence
+///   @startuml "v_DmaDetect.png"
+///     title "Sequence diagram for function v_DmaDetect"
+///     -> SIMR: v_DmaDetect(t_SIMR_Usart *p_Usart)
+///     SIMR++
+///       opt if EN was set while RXNE and DMAR are set
+///         SIMR -> SIMR: v_DmaTransfer(...)
+///       end
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+static void v_DmaDetect(t_SIMR_Usart *p_Usart);
+
+static void v_DmaDetect(t_SIMR_Usart *p_Usart)
+{
+  t_SIMR_DmaStream *p_Dma = p_Usart -> p_Dma;
+  uint32_t u_Cr = SIMR_RAW(p_Dma -> u_CrAddress);
+
+  p_Dma -> u_Flags &= ~(SIMR_RAW(p_Dma -> u_IfcrAddress) & SIMR_DMA_STREAM_FLAGS);
+  if((p_Dma -> u_CrShadow & DMA_SxCR_EN) == 0u)
+  {
+    p_Dma -> u_NdtrShadow = SIMR_RAW(p_Dma -> u_NdtrAddress) & 0xFFFFu;
+    p_Dma -> u_CrShadow = u_Cr;
+    if((u_Cr & DMA_SxCR_EN) != 0u)
+    {
+      p_Dma -> u_Reload = p_Dma -> u_NdtrShadow;
+      if(((SIMR_RAW(p_Usart -> u_Cr3Address) & USART_CR3_DMAR) != 0u) && ((p_Usart -> u_Sr & USART_SR_RXNE) != 0u) &&
+         (p_Dma -> u_Reload != 0u))
+      {
+        p_Usart -> u_Sr &= ~(uint32_t)USART_SR_RXNE;
+        v_UsartPublish(p_Usart);
+        v_DmaTransfer(p_Dma, p_Usart -> u_Rdr);
+      }
+    }
+  }
+  else if((u_Cr & DMA_SxCR_EN) == 0u)
+  {
+    p_Dma -> u_CrShadow &= ~(uint32_t)DMA_SxCR_EN;
+  }
+  v_DmaPublish(p_Dma);
+}
+
+/// @brief Function used for checking if a DMA stream requests its interrupt
+///
+/// @pre None
+/// @post None
+/// @param const t_SIMR_DmaStream *p_Dma
+///
+/// @return uint8_t 1 when an enabled flag is set
+///
+/// @globals None
+///
+/// @InOutCorelation TCIE covers TCIF, HTIE covers HTIF, TEIE covers TEIF and DMEIE covers DMEIF. FEIE is in SxFCR,
+///                  which is not modelled, so FEIF never requests the interrupt.
+/// @callsequence
+///   @startuml "u_DmaRequest.png"
+///     title "Sequence diagram for function u_DmaRequest"
+///     -> SIMR: u_DmaRequest(const t_SIMR_DmaStream *p_Dma)
+///     SIMR++
+///     <- SIMR: Returns uint8_t
+///     SIMR--
+///   @enduml
+
+static uint8_t u_DmaRequest(const t_SIMR_DmaStream *p_Dma);
+
+static uint8_t u_DmaRequest(const t_SIMR_DmaStream *p_Dma)
+{
+  uint32_t u_Cr = p_Dma -> u_CrShadow;
+  uint32_t u_Enabled = 0u;
+
+  u_Enabled |= ((u_Cr & DMA_SxCR_TCIE) != 0u) ? DMA_LISR_TCIF1 : 0u;
+  u_Enabled |= ((u_Cr & DMA_SxCR_HTIE) != 0u) ? DMA_LISR_HTIF1 : 0u;
+  u_Enabled |= ((u_Cr & DMA_SxCR_TEIE) != 0u) ? DMA_LISR_TEIF1 : 0u;
+  u_Enabled |= ((u_Cr & DMA_SxCR_DMEIE) != 0u) ? DMA_LISR_DMEIF1 : 0u;
+  return ((p_Dma -> u_Flags & u_Enabled) != 0u) ? 1u : 0u;
+}
+
+/// @brief Function used for advancing a USART by one event
+///
+/// @pre Called with the models locked
+/// @post At most one byte was sent or received
+/// @param t_SIMR_Usart *p_Usart, uint64_t u_Now
+///
+/// @return uint8_t 1 when something happened
+///
+/// @globals None
+///
+/// @InOutCorelation A byte whose frame ended leaves the shift register, TDR is moved in or TC is set. A queued byte
+///                  whose frame ended is received, with DMAR set and the stream enabled it goes to memory, otherwise
+///                  it is lost with ORE when RXNE is still set. One frame after the last byte IDLE is set.
+/// @callsequence
+///   @startuml "u_UsartAdvance.png"
+///     title "Sequence diagram for function u_UsartAdvance"
+///     -> SIMR: u_UsartAdvance(t_SIMR_Usart *p_Usart, uint64_t u_Now)
+///     SIMR++
+///       alt if a transmitted frame ended
+///         rnote over SIMR: Byte is captured, TXE or TC is set.
+///       else if a received frame ended
+///         SIMR -> SIMR: v_DmaTransfer(...) when DMAR is set and the stream is enabled
+///         rnote over SIMR: Otherwise RXNE is set or ORE on overrun.
+///       else if line went idle
+///         rnote over SIMR: IDLE is set.
+///       end
+///     <- SIMR: Returns uint8_t
+///     SIMR--
+///   @enduml
+
+static uint8_t u_UsartAdvance(t_SIMR_Usart *p_Usart, uint64_t u_Now);
+
+static uint8_t u_UsartAdvance(t_SIMR_Usart *p_Usart, uint64_t u_Now)
+{
+  uint32_t u_Cr1 = SIMR_RAW(p_Usart -> u_Cr1Address);
+
+  if((u_Cr1 & USART_CR1_UE) == 0u)
+  {
+    return 0u;
+  }
+  if((p_Usart -> b_Shifting == 1u) && (u_Now >= p_Usart -> u_TxDoneNs))
+  {
+    if(((p_Usart -> u_TxHead + 1u) % SIMR_USART_BUFFER_LENGTH) != p_Usart -> u_TxTail)
+    {
+      p_Usart -> a_Tx[p_Usart -> u_TxHead] = p_Usart -> u_Shift;
+      p_Usart -> u_TxHead = (p_Usart -> u_TxHead + 1u) % SIMR_USART_BUFFER_LENGTH;
+    }
+    if(p_Usart -> b_TdrFull == 1u)
+    {
+      p_Usart -> u_Shift = p_Usart -> u_Tdr;
+      p_Usart -> b_TdrFull = 0u;
+      p_Usart -> u_TxDoneNs += u_FrameNs(p_Usart);
+      p_Usart -> u_Sr |= USART_SR_TXE;
+    }
+    else
+    {
+      p_Usart -> b_Shifting = 0u;
+      p_Usart -> u_Sr |= USART_SR_TC;
+    }
+    v_UsartPublish(p_Usart);
+    return 1u;
+  }
+  if(((u_Cr1 & USART_CR1_RE) != 0u) && (p_Usart -> u_RxTail != p_Usart -> u_RxHead) && (u_Now >= p_Usart -> u_RxDueNs))
+  {
+    uint8_t u_Byte = p_Usart -> a_Rx[p_Usart -> u_RxTail];
+
+    p_Usart -> u_RxTail = (p_Usart -> u_RxTail + 1u) % SIMR_USART_BUFFER_LENGTH;
+    if(((SIMR_RAW(p_Usart -> u_Cr3Address) & USART_CR3_DMAR) != 0u) && ((p_Usart -> u_Sr & USART_SR_RXNE) == 0u) &&
+       ((p_Usart -> p_Dma -> u_CrShadow & DMA_SxCR_EN) != 0u))
+    {
+      v_DmaTransfer(p_Usart -> p_Dma, u_Byte);
+    }
+    else if((p_Usart -> u_Sr & USART_SR_RXNE) != 0u)
+    {
+      p_Usart -> u_Sr |= USART_SR_ORE;
+      p_Usart -> u_Overruns++;
+    }
+    else
+    {
+      p_Usart -> u_Rdr = u_Byte;
+      p_Usart -> u_Sr |= USART_SR_RXNE;
+    }
+    p_Usart -> u_RxDueNs += u_FrameNs(p_Usart);
+    if(p_Usart -> u_RxTail == p_Usart -> u_RxHead)
+    {
+      p_Usart -> b_IdlePending = 1u;
+      p_Usart -> u_IdleDueNs = p_Usart -> u_RxDueNs;
+    }
+    v_UsartPublish(p_Usart);
+    return 1u;
+  }
+  if((p_Usart -> b_IdlePending == 1u) && (u_Now >= p_Usart -> u_IdleDueNs))
+  {
+    p_Usart -> b_IdlePending = 0u;
+    p_Usart -> u_Sr |= USART_SR_IDLE;
+    v_UsartPublish(p_Usart);
+    return 1u;
+  }
+  return 0u;
+}
+
+/// @brief Function used for checking if a USART requests its interrupt
+///
+/// @pre None
+/// @post None
+/// @param const t_SIMR_Usart *p_Usart
+///
+/// @return uint8_t 1 when an enabled flag is set
+///
+/// @globals None
+///
+/// @InOutCorelation RXNEIE covers RXNE and ORE, TXEIE covers TXE, TCIE covers TC and IDLEIE covers IDLE.
+/// @callsequence
+///   @startuml "u_UsartRequest.png"
+///     title "Sequence diagram for function u_UsartRequest"
+///     -> SIMR: u_UsartRequest(const t_SIMR_Usart *p_Usart)
+///     SIMR++
+///     <- SIMR: Returns uint8_t
+///     SIMR--
+///   @enduml
+
+static uint8_t u_UsartRequest(const t_SIMR_Usart *p_Usart);
+
+static uint8_t u_UsartRequest(const t_SIMR_Usart *p_Usart)
+{
+  uint32_t u_Cr1 = SIMR_RAW(p_Usart -> u_Cr1Address);
+  uint32_t u_Sr  = p_Usart -> u_Sr;
+
+  if((u_Cr1 & USART_CR1_UE) == 0u)
+  {
+    return 0u;
+  }
+  if((((u_Cr1 & USART_CR1_RXNEIE) != 0u) && ((u_Sr & (USART_SR_RXNE | USART_SR_ORE)) != 0u)) ||
+     (((u_Cr1 & USART_CR1_TXEIE) != 0u) && ((u_Sr & USART_SR_TXE) != 0u)) ||
+     (((u_Cr1 & USART_CR1_TCIE) != 0u) && ((u_Sr & USART_SR_TC) != 0u)) ||
+     (((u_Cr1 & USART_CR1_IDLEIE) != 0u) && ((u_Sr & USART_SR_IDLE) != 0u)))
+  {
+    return 1u;
+  }
+  return 0u;
+}
+
+/// @brief Function used for publishing SR1, SR2, CR1 and DR of I2C1
+///
+/// @pre None
+/// @post Registers hold the model values
+/// @param None
+///
+/// @return None
+///
+/// @globals SIMR_t_I2c
+///
+/// @InOutCorelation CR1 is published too, START and STOP are cleared by the model once they are done.
+/// @callsequence
+///   @startuml "v_I2cPublish.png"
+///     title "Sequence diagram for function v_I2cPublish"
+///     -> SIMR: v_I2cPublish()
+///     SIMR++
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+static void v_I2cPublish(void);
+
+static void v_I2cPublish(void)
+{
+  SIMR_RAW(I2C1_SR1) = SIMR_t_I2c.u_Sr1;
+  SIMR_RAW(I2C1_SR2) = SIMR_t_I2c.u_Sr2;
+  SIMR_RAW(I2C1_CR1) = SIMR_t_I2c.u_Cr1Shadow;
+  SIMR_t_I2c.u_DrShadow = SIMR_DR_MARK | SIMR_t_I2c.u_Dr;
+  SIMR_RAW(I2C1_DR) = SIMR_t_I2c.u_DrShadow;
+}
+
+/// @brief Function used for releasing the I2C1 bus after STOP
+///
+/// @pre Called with the models locked
+/// @post Bus is free, STOP bit is cleared
+/// @param None
+///
+/// @return None
+///
+/// @globals SIMR_t_I2c
+///
+/// @InOutCorelation MSL, BUSY and TRA are cleared, a received byte which was not read stays in DR.
+/// @callsequence
+///   @startuml "v_I2cRelease.png"
+///     title "Sequence diagram for function v_I2cRelease"
+///     -> SIMR: v_I2cRelease()
+///     SIMR++
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+static void v_I2cRelease(void);
+
+static void v_I2cRelease(void)
+{
+  SIMR_t_I2c.e_State = SIMR_I2C_IDLE;
+  SIMR_t_I2c.p_Device = NULL;
+  SIMR_t_I2c.b_TxPending = 0u;
+  SIMR_t_I2c.b_StopPending = 0u;
+  SIMR_t_I2c.u_Sr1 &= ~(uint32_t)(I2C_SR1_SB | I2C_SR1_ADDR | I2C_SR1_TXE | I2C_SR1_BTF);
+  SIMR_t_I2c.u_Sr2 = 0u;
+  SIMR_t_I2c.u_Cr1Shadow &= ~(uint32_t)I2C_CR1_STOP;
+}
+
+/// @brief Function used for handling stores to CR1, SR1 and DR of I2C1
+///
+/// @pre Called with the models locked
+/// @post START, STOP, software reset, cleared errors and written bytes have taken effect
+/// @param None
+///
+/// @return None
+///
+/// @globals SIMR_t_I2c
+///
+/// @InOutCorelation START sets SB, also as a repeated start. STOP releases the bus at once unless a byte is being
+///                  received, then it follows that byte. The byte after SB is the address, later bytes are data.
+/// @callsequence
+///   @startuml "v_I2cDetect.png"
+///     title "Sequence diagram for function v_I2cDetect"
+///     -> SIMR: v_I2cDetect()
+///     SIMR++
+///       opt if CR1 differs from the published value
+///         rnote over SIMR: Reset, START and STOP are handled.
+///       end
+///       opt if SR1 differs from the published value
+///         rnote over SIMR: Error flags written with 0 are cleared.
+///       end
+///       opt if DR differs from the published value
+///         rnote over SIMR: Address or data byte is taken.
+///       end
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+static void v_I2cDetect(void);
+
+static void v_I2cDetect(void)
+{
+  uint32_t u_Cr1 = SIMR_RAW(I2C1_CR1);
+  uint32_t u_Sr1 = SIMR_RAW(I2C1_SR1);
+  uint32_t u_Dr  = SIMR_RAW(I2C1_DR);
+
+  if(u_Cr1 != SIMR_t_I2c.u_Cr1Shadow)
+  {
+    SIMR_t_I2c.u_Cr1Shadow = u_Cr1;
+    if(((u_Cr1 & I2C_CR1_PE) == 0u) || ((u_Cr1 & I2C_CR1_SWRST) != 0u))
+    {
+      v_I2cRelease();
+      SIMR_t_I2c.u_Sr1 = 0u;
+      SIMR_t_I2c.u_Cr1Shadow &= ~(uint32_t)(I2C_CR1_START | I2C_CR1_STOP);
+    }
+    else
+    {
+      if((u_Cr1 & I2C_CR1_START) != 0u)
+      {
+        SIMR_t_I2c.e_State = SIMR_I2C_START;
+        SIMR_t_I2c.b_TxPending = 0u;
+        SIMR_t_I2c.u_Sr1 &= ~(uint32_t)(I2C_SR1_ADDR | I2C_SR1_TXE | I2C_SR1_BTF);
+        SIMR_t_I2c.u_Sr1 |= I2C_SR1_SB;
+        SIMR_t_I2c.u_Sr2 |= I2C_SR2_MSL | I2C_SR2_BUSY;
+        SIMR_t_I2c.u_Cr1Shadow &= ~(uint32_t)I2C_CR1_START;
+      }
+      if((u_Cr1 & I2C_CR1_STOP) != 0u)
+      {
+        if((SIMR_t_I2c.e_State == SIMR_I2C_RECEIVE) && (SIMR_t_I2c.b_LastByte == 0u))
+        {
+          SIMR_t_I2c.b_StopPending = 1u;
+        }
+        else
+        {
+          v_I2cRelease();
+        }
+      }
+    }
+  }
+  if(u_Sr1 != SIMR_t_I2c.u_Sr1)
+  {
+    SIMR_t_I2c.u_Sr1 &= (u_Sr1 | ~(uint32_t)SIMR_I2C_SR1_ERRORS);
+  }
+  if(u_Dr != SIMR_t_I2c.u_DrShadow)
+  {
+    if((SIMR_t_I2c.e_State == SIMR_I2C_START) && ((SIMR_t_I2c.u_Sr1 & I2C_SR1_SB) != 0u))
+    {
+      SIMR_t_I2c.u_Address = (uint8_t)u_Dr;
+      SIMR_t_I2c.u_Sr1 &= ~(uint32_t)I2C_SR1_SB;
+      SIMR_t_I2c.e_State = SIMR_I2C_ADDRESS;
+    }
+    else if(SIMR_t_I2c.e_State == SIMR_I2C_TRANSMIT)
+    {
+      SIMR_t_I2c.u_TxData = (uint8_t)u_Dr;
+      SIMR_t_I2c.b_TxPending = 1u;
+      SIMR_t_I2c.u_Sr1 &= ~(uint32_t)(I2C_SR1_TXE | I2C_SR1_BTF);
+    }
+  }
+  v_I2cPublish();
+}
+
+/// @brief Function used for advancing I2C1 by one bus event
+///
+/// @pre Called with the models locked
+/// @post At most one address or data byte was transferred
+/// @param None
+///
+/// @return uint8_t 1 when something happened
+///
+/// @globals SIMR_t_I2c
+///
+/// @InOutCorelation The address is acknowledged by an attached device (ADDR) or not (AF). After ADDR is cleared a
+///                  written byte goes to the device and sets TXE and BTF, or a byte is read from the device and sets
+///                  RXNE once DR is empty. A byte received with ACK cleared is the last one and a pending STOP follows.
+/// @callsequence
+///   @startuml "u_I2cAdvance.png"
+///     title "Sequence diagram for function u_I2cAdvance"
+///     -> SIMR: u_I2cAdvance()
+///     SIMR++
+///       alt if address byte is on the bus
+///         rnote over SIMR: ADDR or AF is set.
+///       else if data byte waits to be sent
+///         rnote over SIMR: Device register is written, TXE and BTF are set.
+///       else if receiving and DR is empty
+///         rnote over SIMR: Device register is read, RXNE is set.
+///       end
+///     <- SIMR: Returns uint8_t
+///     SIMR--
+///   @enduml
+
+static uint8_t u_I2cAdvance(void);
+
+static uint8_t u_I2cAdvance(void)
+{
+  t_SIMR_I2cDevice *p_Device = SIMR_t_I2c.p_Device;
+
+  if(SIMR_t_I2c.e_State == SIMR_I2C_ADDRESS)
+  {
+    SIMR_t_I2c.p_Device = NULL;
+    for(uint8_t u_Cnt = 0u; u_Cnt < SIMR_t_I2c.u_DeviceCount; u_Cnt++)
+    {
+      if(SIMR_t_I2c.a_Devices[u_Cnt] -> u_Address == (SIMR_t_I2c.u_Address >> 1u))
+      {
+        SIMR_t_I2c.p_Device = SIMR_t_I2c.a_Devices[u_Cnt];
+      }
+    }
+    if(SIMR_t_I2c.p_Device == NULL)
+    {
+      SIMR_t_I2c.e_State = SIMR_I2C_NACKED;
+      SIMR_t_I2c.u_Sr1 |= I2C_SR1_AF;
+    }
+    else if((SIMR_t_I2c.u_Address & 1u) != 0u)
+    {
+      SIMR_t_I2c.e_State = SIMR_I2C_RECEIVE;
+      SIMR_t_I2c.b_LastByte = 0u;
+      SIMR_t_I2c.u_Sr1 |= I2C_SR1_ADDR;
+      SIMR_t_I2c.u_Sr2 &= ~(uint32_t)I2C_SR2_TRA;
+    }
+    else
+    {
+      SIMR_t_I2c.e_State = SIMR_I2C_TRANSMIT;
+      SIMR_t_I2c.p_Device -> b_PointerSet = 0u;
+      SIMR_t_I2c.u_Sr1 |= I2C_SR1_ADDR;
+      SIMR_t_I2c.u_Sr2 |= I2C_SR2_TRA;
+    }
+    v_I2cPublish();
+    return 1u;
+  }
+  if((SIMR_t_I2c.u_Sr1 & I2C_SR1_ADDR) != 0u)
+  {
+    return 0u;
+  }
+  if((SIMR_t_I2c.e_State == SIMR_I2C_TRANSMIT) && (SIMR_t_I2c.b_TxPending == 1u))
+  {
+    if(p_Device -> b_PointerSet == 0u)
+    {
+      p_Device -> u_Pointer = SIMR_t_I2c.u_TxData;
+      p_Device -> b_PointerSet = 1u;
+    }
+    else
+    {
+      p_Device -> a_Registers[p_Device -> u_Pointer] = SIMR_t_I2c.u_TxData;
+      p_Device -> u_Pointer++;
+      p_Device -> u_Writes++;
+    }
+    SIMR_t_I2c.b_TxPending = 0u;
+    SIMR_t_I2c.u_Sr1 |= I2C_SR1_TXE | I2C_SR1_BTF;
+    v_I2cPublish();
+    return 1u;
+  }
+  if((SIMR_t_I2c.e_State == SIMR_I2C_RECEIVE) && (SIMR_t_I2c.b_LastByte == 0u) &&
+     ((SIMR_t_I2c.u_Sr1 & I2C_SR1_RXNE) == 0u))
+  {
+    SIMR_t_I2c.u_Dr = p_Device -> a_Registers[p_Device -> u_Pointer];
+    p_Device -> u_Pointer++;
+    p_Device -> u_Reads++;
+    SIMR_t_I2c.u_Sr1 |= I2C_SR1_RXNE;
+    if((SIMR_t_I2c.u_Cr1Shadow & I2C_CR1_ACK) == 0u)
+    {
+      SIMR_t_I2c.b_LastByte = 1u;
+      if(SIMR_t_I2c.b_StopPending == 1u)
+      {
+        v_I2cRelease();
+      }
+    }
+    v_I2cPublish();
+    return 1u;
+  }
+  return 0u;
+}
+
+/// @brief Function used for checking if I2C1 requests its event interrupt
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return uint8_t 1 when an event is enabled and set
+///
+/// @globals SIMR_t_I2c
+///
+/// @InOutCorelation ITEVTEN covers SB, ADDR and BTF, TXE and RXNE also need ITBUFEN.
+/// @callsequence
+///   @startuml "u_I2cEventRequest.png"
+///     title "Sequence diagram for function u_I2cEventRequest"
+///     -> SIMR: u_I2cEventRequest()
+///     SIMR++
+///     <- SIMR: Returns uint8_t
+///     SIMR--
+///   @enduml
+
+static uint8_t u_I2cEventRequest(void);
+
+static uint8_t u_I2cEventRequest(void)
+{
+  uint32_t u_Cr2 = SIMR_RAW(I2C1_CR2);
+  uint32_t u_Sr1 = SIMR_t_I2c.u_Sr1;
+
+  if((u_Cr2 & I2C_CR2_ITEVTEN) == 0u)
+  {
+    return 0u;
+  }
+  if(((u_Sr1 & (I2C_SR1_SB | I2C_SR1_ADDR | I2C_SR1_BTF)) != 0u) ||
+     (((u_Cr2 & I2C_CR2_ITBUFEN) != 0u) && ((u_Sr1 & (I2C_SR1_TXE | I2C_SR1_RXNE)) != 0u)))
+  {
+    return 1u;
+  }
+  return 0u;
+}
+
+/// @brief Function used for handling stores to the IWDG registers
+///
+/// @pre Called with the models locked
+/// @post Keys have taken effect, KR reads as 0
+/// @param uint64_t u_Now
+///
+/// @return None
+///
+/// @globals SIMR_t_Iwdg
+///
+/// @InOutCorelation 0x5555 unlocks PR and RLR, 0xAAAA reloads the counter, 0xCCCC starts the watchdog. Writes to PR
+///                  and RLR without the unlock key are ignored.
+/// @callsequence
+///   @startuml "v_IwdgDetect.png"
+///     title "Sequence diagram for function v_IwdgDetect"
+///     -> SIMR: v_IwdgDetect(uint64_t u_Now)
+///     SIMR++
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+static void v_IwdgDetect(uint64_t u_Now);
+
+static void v_IwdgDetect(uint64_t u_Now)
+{
+  uint32_t u_Key = SIMR_RAW(IWDG_KR) & 0xFFFFu;
+
+  if(SIMR_RAW(IWDG_PR) != SIMR_t_Iwdg.u_PrShadow)
+  {
+    if(SIMR_t_Iwdg.b_Unlocked == 1u)
+    {
+      SIMR_t_Iwdg.u_PrShadow = SIMR_RAW(IWDG_PR) & 0x7u;
+    }
+    SIMR_RAW(IWDG_PR) = SIMR_t_Iwdg.u_PrShadow;
+  }
+  if(SIMR_RAW(IWDG_RLR) != SIMR_t_Iwdg.u_RlrShadow)
+  {
+    if(SIMR_t_Iwdg.b_Unlocked == 1u)
+    {
+      SIMR_t_Iwdg.u_RlrShadow = SIMR_RAW(IWDG_RLR) & 0xFFFu;
+    }
+    SIMR_RAW(IWDG_RLR) = SIMR_t_Iwdg.u_RlrShadow;
+  }
+  if(u_Key == 0x5555u)
+  {
+    SIMR_t_Iwdg.b_Unlocked = 1u;
+  }
+  else if(u_Key == 0xAAAAu)
+  {
+    SIMR_t_Iwdg.b_Unlocked = 0u;
+    SIMR_t_Iwdg.u_ReloadNs = u_Now;
+  }
+  else if(u_Key == 0xCCCCu)
+  {
+    SIMR_t_Iwdg.b_Started = 1u;
+    SIMR_t_Iwdg.u_ReloadNs = u_Now;
+  }
+  SIMR_RAW(IWDG_KR) = 0u;
+}
+
+/// @brief Function used for handling stores to the flash interface registers
+///
+/// @pre Called with the models locked
+/// @post Keys and erases have taken effect, KEYR and SR read as 0
+/// @param None
+///
+/// @return None
+///
+/// @globals SIMR_t_Flash
+///
+/// @InOutCorelation KEY1 followed by KEY2 clears LOCK, any other value in KEYR keeps CR locked. Stores to a locked CR
+///                  are ignored apart from LOCK. STRT with SER erases a sector of the mapped region to 0xFF at once,
+///                  so BSY is never seen set. Erase of a sector outside the mapped region is ignored.
+/// @callsequence
+///   @startuml "v_FlashDetect.png"
+///     title "Sequence diagram for function v_FlashDetect"
+///     -> SIMR: v_FlashDetect()
+///     SIMR++
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+static void v_FlashDetect(void);
+
+static void v_FlashDetect(void)
+{
+  uint32_t u_Key = SIMR_RAW(FLASH_KEYR);
+  uint32_t u_Cr = SIMR_RAW(FLASH_CR);
+
+  if(u_Key != 0u)
+  {
+    if((u_Key == SIMR_FLASH_KEY2) && (SIMR_t_Flash.b_Key1 == 1u))
+    {
+      SIMR_t_Flash.u_CrShadow &= ~(uint32_t)FLASH_CR_LOCK;
+    }
+    SIMR_t_Flash.b_Key1 = (u_Key == SIMR_FLASH_KEY1) ? 1u : 0u;
+    SIMR_RAW(FLASH_KEYR) = 0u;
+  }
+  if(u_Cr != SIMR_t_Flash.u_CrShadow)
+  {
+    if((SIMR_t_Flash.u_CrShadow & FLASH_CR_LOCK) == 0u)
+    {
+      SIMR_t_Flash.u_CrShadow = u_Cr;
+    }
+    else
+    {
+      SIMR_t_Flash.u_CrShadow |= (u_Cr & FLASH_CR_LOCK);
+    }
+    if((SIMR_t_Flash.u_CrShadow & (FLASH_CR_STRT | FLASH_CR_SER)) == (FLASH_CR_STRT | FLASH_CR_SER))
+    {
+      uint32_t u_Snb = (SIMR_t_Flash.u_CrShadow & FLASH_CR_SNB_Msk) >> FLASH_CR_SNB_Pos;
+      // Bank 2 sectors have bit 4 set and are numbered from 12
+      uint32_t u_Sector = ((u_Snb & 0x10u) != 0u) ? (12u + (u_Snb & 0xFu)) : u_Snb;
+
+      if((u_Sector >= SIMR_FLASH_FIRST_SECTOR) &&
+         ((u_Sector - SIMR_FLASH_FIRST_SECTOR) < (SIMR_FLASH_SIZE / SIMR_FLASH_SECTOR_SIZE)))
+      {
+        memset((void *)(uintptr_t)(SIMR_FLASH_BASE + ((u_Sector - SIMR_FLASH_FIRST_SECTOR) * SIMR_FLASH_SECTOR_SIZE)),
+               0xFF, SIMR_FLASH_SECTOR_SIZE);
+        SIMR_t_Flash.u_Erases++;
+      }
+      SIMR_t_Flash.u_CrShadow &= ~(uint32_t)FLASH_CR_STRT;
+    }
+    SIMR_RAW(FLASH_CR) = SIMR_t_Flash.u_CrShadow;
+  }
+  SIMR_RAW(FLASH_SR) = 0u;
+}
+
+/// @brief Function used for advancing the IWDG counter
+///
+/// @pre Called with the models locked
+/// @post Expiry is counted and the counter is reloaded
+/// @param uint64_t u_Now
+///
+/// @return uint8_t 1 when the counter reached zero
+///
+/// @globals SIMR_t_Iwdg
+///
+/// @InOutCorelation Counter runs at LSI / (4 << PR) from RLR to zero.
+/// @callsequence
+///   @startuml "u_IwdgAdvance.png"
+///     title "Sequence diagram for function u_IwdgAdvance"
+///     -> SIMR: u_IwdgAdvance(uint64_t u_Now)
+///     SIMR++
+///     <- SIMR: Returns uint8_t
+///     SIMR--
+///   @enduml
+
+static uint8_t u_IwdgAdvance(uint64_t u_Now);
+
+static uint8_t u_IwdgAdvance(uint64_t u_Now)
+{
+  uint64_t u_TimeoutNs = (1000000000ULL * (4ULL << SIMR_t_Iwdg.u_PrShadow) * (SIMR_t_Iwdg.u_RlrShadow + 1ULL)) / SIMR_LSI_HZ;
+
+  if((SIMR_t_Iwdg.b_Started == 1u) && ((u_Now - SIMR_t_Iwdg.u_ReloadNs) >= u_TimeoutNs))
+  {
+    SIMR_t_Iwdg.u_Resets++;
+    SIMR_t_Iwdg.u_ReloadNs = u_Now;
+    return 1u;
+  }
+  return 0u;
+}
+
+/// @brief Function used for following start, stop and writes of a counter
+///
+/// @pre Called with the models locked
+/// @post Counter base matches the register
+/// @param t_SIMR_Counter *p_Counter, uint32_t u_Address, uint8_t b_Enable, uint64_t u_Hz, uint64_t u_Now
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation A written value becomes the new base. Frequency is taken when the counter starts, so a prescaler
+///                  set before the counter is enabled is used like after an update event.
+/// @callsequence
+///   @startuml "v_CounterDetect.png"
+///     title "Sequence diagram for function v_CounterDetect"
+///     -> SIMR: v_CounterDetect(...)
+///     SIMR++
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+static void v_CounterDetect(t_SIMR_Counter *p_Counter, uint32_t u_Address, uint8_t b_Enable, uint64_t u_Hz, uint64_t u_Now);
+
+static void v_CounterDetect(t_SIMR_Counter *p_Counter, uint32_t u_Address, uint8_t b_Enable, uint64_t u_Hz, uint64_t u_Now)
+{
+  if(SIMR_RAW(u_Address) != p_Counter -> u_Shadow)
+  {
+    p_Counter -> u_Shadow = SIMR_RAW(u_Address);
+    p_Counter -> u_Base = p_Counter -> u_Shadow;
+    p_Counter -> u_BaseNs = u_Now;
+  }
+  if((b_Enable == 1u) && (p_Counter -> b_Running == 0u))
+  {
+    p_Counter -> b_Running = 1u;
+    p_Counter -> u_Hz = u_Hz;
+    p_Counter -> u_Base = p_Counter -> u_Shadow;
+    p_Counter -> u_BaseNs = u_Now;
+  }
+  else if((b_Enable == 0u) && (p_Counter -> b_Running == 1u))
+  {
+    p_Counter -> b_Running = 0u;
+  }
+}
+
+/// @brief Function used for publishing the current value of a counter
+///
+/// @pre Called with the models locked
+/// @post Register holds the counter value
+/// @param t_SIMR_Counter *p_Counter, uint32_t u_Address, uint64_t u_Now
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Value is the base plus elapsed time at the counter frequency, truncated to 32 bits like the
+///                  free running hardware counter.
+/// @callsequence
+///   @startuml "v_CounterPublish.png"
+///     title "Sequence diagram for function v_CounterPublish"
+///     -> SIMR: v_CounterPublish(t_SIMR_Counter *p_Counter, uint32_t u_Address, uint64_t u_Now)
+///     SIMR++
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+static void v_CounterPublish(t_SIMR_Counter *p_Counter, uint32_t u_Address, uint64_t u_Now);
+
+static void v_CounterPublish(t_SIMR_Counter *p_Counter, uint32_t u_Address, uint64_t u_Now)
+{
+  if(p_Counter -> b_Running == 1u)
+  {
+    uint64_t u_Ticks = ((u_Now - p_Counter -> u_BaseNs) * p_Counter -> u_Hz) / 1000000000ULL;
+    p_Counter -> u_Shadow = (uint32_t)(p_Counter -> u_Base + u_Ticks);
+    SIMR_RAW(u_Address) = p_Counter -> u_Shadow;
+  }
+}
+
+/// @brief Function used for detecting stores to all modelled registers
+///
+/// @pre Called with the models locked
+/// @post Every store since the last call has taken effect
+/// @param uint64_t u_Now
+///
+/// @return None
+///
+/// @globals SIMR_a_Usart, SIMR_a_Dma, SIMR_t_Flash, SIMR_t_Tim5, SIMR_t_Cyccnt
+///
+/// @InOutCorelation Function compares each modelled register with the value its model published.
+/// @callsequence
+///   @startuml "v_DetectWrites.png"
+///     title "Sequence diagram for function v_DetectWrites"
+///     -> SIMR: v_DetectWrites(uint64_t u_Now)
+///     SIMR++
+///       SIMR -> SIMR: v_UsartDetect(...)
+///       SIMR -> SIMR: v_DmaDetect(...)
+///       SIMR -> SIMR: v_I2cDetect()
+///       SIMR -> SIMR: v_IwdgDetect(u_Now)
+///       SIMR -> SIMR: v_FlashDetect()
+///       SIMR -> SIMR: v_CounterDetect(...)
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+static void v_DetectWrites(uint64_t u_Now);
+
+static void v_DetectWrites(uint64_t u_Now)
+{
+  uint64_t u_Tim5Hz = SIMR_APB1_TIMER_CLOCK_HZ / ((SIMR_RAW(TIM5_PSC) & 0xFFFFu) + 1ULL);
+
+  for(uint8_t u_Cnt = 0u; u_Cnt < (uint8_t)SIMR_USART_COUNT; u_Cnt++)
+  {
+    v_UsartDetect(&SIMR_a_Usart[u_Cnt], u_Now);
+    v_DmaDetect(&SIMR_a_Usart[u_Cnt]);
+  }
+  v_I2cDetect();
+  v_IwdgDetect(u_Now);
+  v_FlashDetect();
+  v_CounterDetect(&SIMR_t_Tim5, TIM5_CNT, (uint8_t)(SIMR_RAW(TIM5_CR1) & TIM_CR1_CEN), u_Tim5Hz, u_Now);
+  v_CounterDetect(&SIMR_t_Cyccnt, DWT_CYCCNT, (uint8_t)(SIMR_RAW(DWT_CTRL) & 1u), SIMR_CORE_CLOCK_HZ, u_Now);
+}
+
+/// @brief Function used for finding the pending read slot of the calling context
+///
+/// @pre Called with the models locked
+/// @post None
+/// @param None
+///
+/// @return t_SIMR_Context * slot of the running task, NULL when all slots are taken
+///
+/// @globals SIMR_a_Contexts
+///
+/// @InOutCorelation Tasks are told apart by their handle, code before the scheduler starts uses the NULL handle.
+/// @callsequence
+///   @startuml "p_GetContext.png"
+///     title "Sequence diagram for function p_GetContext"
+///     -> SIMR: p_GetContext()
+///     SIMR++
+///     <- SIMR: Returns slot
+///     SIMR--
+///   @enduml
+
+static t_SIMR_Context * p_GetContext(void);
+
+static t_SIMR_Context * p_GetContext(void)
+{
+  void *p_Key = (u_Started() == 1u) ? (void *)xTaskGetCurrentTaskHandle() : NULL;
+  t_SIMR_Context *p_Free = NULL;
+
+  for(uint8_t u_Cnt = 0u; u_Cnt < SIMR_CONTEXT_COUNT; u_Cnt++)
+  {
+    if(SIMR_a_Contexts[u_Cnt].p_Key == p_Key)
+    {
+      return &SIMR_a_Contexts[u_Cnt];
+    }
+    if((p_Free == NULL) && (SIMR_a_Contexts[u_Cnt].u_Address == 0u))
+    {
+      p_Free = &SIMR_a_Contexts[u_Cnt];
+    }
+  }
+  if(p_Free != NULL)
+  {
+    p_Free -> p_Key = p_Key;
+  }
+  return p_Free;
+}
+
+/// @brief Function used for applying the side effect of the last read of a context
+///
+/// @pre Called with the models locked
+/// @post Nothing is pending for the context
+/// @param t_SIMR_Context *p_Context
+///
+/// @return None
+///
+/// @globals SIMR_a_Usart, SIMR_t_I2c
+///
+/// @InOutCorelation When the register no longer holds the published value the access was a store and it is left to
+///                  the store detection. Otherwise a DR read empties the receive register and an SR2 read clears ADDR.
+/// @callsequence
+///   @startuml "v_SettleRead.png"
+///     title "Sequence diagram for function v_SettleRead"
+///     -> SIMR: v_SettleRead(t_SIMR_Context *p_Context)
+///     SIMR++
+///       alt if USART DR was read
+///         SIMR -> SIMR: v_UsartRead(...)
+///       else if I2C1 DR was read
+///         rnote over SIMR: RXNE and BTF are cleared.
+///       else if I2C1 SR2 was read
+///         rnote over SIMR: ADDR is cleared, TXE is set when transmitting.
+///       end
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+static void v_SettleRead(t_SIMR_Context *p_Context);
+
+static void v_SettleRead(t_SIMR_Context *p_Context)
+{
+  uint32_t u_Address;
+
+  if((p_Context == NULL) || (p_Context -> u_Address == 0u))
+  {
+    return;
+  }
+  u_Address = p_Context -> u_Address;
+  p_Context -> u_Address = 0u;
+
+  for(uint8_t u_Cnt = 0u; u_Cnt < (uint8_t)SIMR_USART_COUNT; u_Cnt++)
+  {
+    t_SIMR_Usart *p_Usart = &SIMR_a_Usart[u_Cnt];
+    if((u_Address == p_Usart -> u_DrAddress) && (SIMR_RAW(u_Address) == p_Usart -> u_DrShadow))
+    {
+      v_UsartRead(p_Usart);
+    }
+  }
+  if((u_Address == I2C1_DR) && (SIMR_RAW(u_Address) == SIMR_t_I2c.u_DrShadow))
+  {
+    SIMR_t_I2c.u_Sr1 &= ~(uint32_t)(I2C_SR1_RXNE | I2C_SR1_BTF);
+    v_I2cPublish();
+  }
+  else if((u_Address == I2C1_SR2) && ((SIMR_t_I2c.u_Sr1 & I2C_SR1_ADDR) != 0u))
+  {
+    SIMR_t_I2c.u_Sr1 &= ~(uint32_t)I2C_SR1_ADDR;
+    if(SIMR_t_I2c.e_State == SIMR_I2C_TRANSMIT)
+    {
+      SIMR_t_I2c.u_Sr1 |= I2C_SR1_TXE;
+    }
+    v_I2cPublish();
+  }
+}
+
+/// @brief Function used for checking if an interrupt line requests service
+///
+/// @pre None
+/// @post None
+/// @param int32_t i_Irq
+///
+/// @return uint8_t 1 when the peripheral flags or the software pending bit request the interrupt
+///
+/// @globals SIMR_a_Usart, SIMR_a_Dma, SIMR_t_I2c, SIMR_a_NvicPending
+///
+/// @InOutCorelation EXTI1 is pending while its bit is set in both EXTI->PR and EXTI->IMR.
+/// @callsequence
+///   @startuml "u_Request.png"
+///     title "Sequence diagram for function u_Request"
+///     -> SIMR: u_Request(int32_t i_Irq)
+///     SIMR++
+///     <- SIMR: Returns uint8_t
+///     SIMR--
+///   @enduml
+
+static uint8_t u_Request(int32_t i_Irq);
+
+static uint8_t u_Request(int32_t i_Irq)
+{
+  uint8_t u_Pending = SIMR_a_NvicPending[i_Irq];
+
+  switch(i_Irq)
+  {
+    case DMA1_Stream1_IRQn:
+      u_Pending |= u_DmaRequest(&SIMR_a_Dma[SIMR_USART3]);
+      break;
+    case DMA1_Stream5_IRQn:
+      u_Pending |= u_DmaRequest(&SIMR_a_Dma[SIMR_USART2]);
+      break;
+    case USART2_IRQn:
+      u_Pending |= u_UsartRequest(&SIMR_a_Usart[SIMR_USART2]);
+      break;
+    case USART3_IRQn:
+      u_Pending |= u_UsartRequest(&SIMR_a_Usart[SIMR_USART3]);
+      break;
+    case I2C1_EV_IRQn:
+      u_Pending |= u_I2cEventRequest();
+      break;
+    case I2C1_ER_IRQn:
+      u_Pending |= (((SIMR_RAW(I2C1_CR2) & I2C_CR2_ITERREN) != 0u) && ((SIMR_t_I2c.u_Sr1 & SIMR_I2C_SR1_ERRORS) != 0u)) ? 1u : 0u;
+      break;
+    case EXTI1_IRQn:
+      u_Pending |= ((SIMR_RAW(EXTI_IMR) & SIMR_RAW(EXTI_PR) & (1u << 1u)) != 0u) ? 1u : 0u;
+      break;
+    default:
+      break;
+  }
+  return u_Pending;
+}
+
+/// @brief Function used for calling the handler of the most urgent pending interrupt
+///
+/// @pre Called with the models locked, PRIMASK is clear
+/// @post Handler ran once and its last read took effect
+/// @param t_SIMR_Context *p_Context context of the caller, the handler accesses registers in it
+///
+/// @return uint8_t 1 when a handler was called
+///
+/// @globals SIMR_a_Vectors, SIMR_a_NvicEnabled, SIMR_a_NvicPriority, SIMR_u_Ipsr
+///
+/// @InOutCorelation The enabled and requesting line with the lowest priority number wins, equal priorities go by
+///                  line number as in the NVIC.
+/// @callsequence
+///   @startuml "u_Dispatch.png"
+///     title "Sequence diagram for function u_Dispatch"
+///     -> SIMR: u_Dispatch(t_SIMR_Context *p_Context)
+///     SIMR++
+///       opt if an interrupt is pending
+///         SIMR -> Module: IRQHandler()
+///         SIMR -> SIMR: v_SettleRead(p_Context)
+///       end
+///     <- SIMR: Returns uint8_t
+///     SIMR--
+///   @enduml
+
+static uint8_t u_Dispatch(t_SIMR_Context *p_Context);
+
+static uint8_t u_Dispatch(t_SIMR_Context *p_Context)
+{
+  const t_SIMR_Vector *p_Selected = NULL;
+
+  for(uint8_t u_Cnt = 0u; u_Cnt < (uint8_t)(sizeof(SIMR_a_Vectors) / sizeof(SIMR_a_Vectors[0])); u_Cnt++)
+  {
+    const t_SIMR_Vector *p_Vector = &SIMR_a_Vectors[u_Cnt];
+    if((p_Vector -> p_Handler != NULL) && (SIMR_a_NvicEnabled[p_Vector -> i_Irq] == 1u) &&
+       (u_Request(p_Vector -> i_Irq) == 1u) &&
+       ((p_Selected == NULL) || (SIMR_a_NvicPriority[p_Vector -> i_Irq] < SIMR_a_NvicPriority[p_Selected -> i_Irq]) ||
+        ((SIMR_a_NvicPriority[p_Vector -> i_Irq] == SIMR_a_NvicPriority[p_Selected -> i_Irq]) && (p_Vector -> i_Irq < p_Selected -> i_Irq))))
+    {
+      p_Selected = p_Vector;
+    }
+  }
+  if(p_Selected == NULL)
+  {
+    return 0u;
+  }
+  SIMR_a_NvicPending[p_Selected -> i_Irq] = 0u;
+  SIMR_u_Ipsr = (uint32_t)(p_Selected -> i_Irq + 16);
+  p_Selected -> p_Handler();
+  SIMR_u_Ipsr = 0u;
+  v_SettleRead(p_Context);
+  return 1u;
+}
+
+/// @brief Function used for the interrupt dispatcher task
+///
+/// @pre Created by SIMR_v_StartDispatcher
+/// @post None
+/// @param void *p_Argument not used
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Every SIMR_DISPATCH_PERIOD_TICKS the scheduler is suspended and SIMR_v_Run is called, a task
+///                  woken by a handler runs when the scheduler is resumed.
+/// @callsequence
+///   @startuml "v_Dispatcher.png"
+///     title "Sequence diagram for function v_Dispatcher"
+///     -> SIMR: v_Dispatcher(void *p_Argument)
+///     SIMR++
+///       loop forever
+///         SIMR -> FreeRTOS: vTaskDelay(SIMR_DISPATCH_PERIOD_TICKS)
+///         SIMR -> FreeRTOS: vTaskSuspendAll()
+///         SIMR -> SIMR: SIMR_v_Run()
+///         SIMR -> FreeRTOS: xTaskResumeAll()
+///       end
+///     SIMR--
+///   @enduml
+
+static void v_Dispatcher(void *p_Argument);
+
+static void v_Dispatcher(void *p_Argument)
+{
+  (void)p_Argument;
+
+  for(;;)
+  {
+    vTaskDelay(SIMR_DISPATCH_PERIOD_TICKS);
+    vTaskSuspendAll();
+    SIMR_v_Run();
+    (void)xTaskResumeAll();
+  }
+}
+
+void SIMR_v_Init(void)
+{
+  if(SIMR_b_Mapped == 0u)
+  {
+    v_Map(SIMR_PERIPH_BASE, SIMR_PERIPH_SIZE);
+    v_Map(SIMR_CORE_BASE, SIMR_CORE_SIZE);
+    v_Map(SIMR_FLASH_BASE, SIMR_FLASH_SIZE);
+    // Flash comes erased, a reset afterwards keeps its contents
+    memset((void *)(uintptr_t)SIMR_FLASH_BASE, 0xFF, SIMR_FLASH_SIZE);
+    SIMR_b_Mapped = 1u;
+  }
+  else
+  {
+    memset((void *)(uintptr_t)SIMR_PERIPH_BASE, 0, SIMR_PERIPH_SIZE);
+    memset((void *)(uintptr_t)SIMR_CORE_BASE, 0, SIMR_CORE_SIZE);
+  }
+  memset(SIMR_a_Usart, 0, sizeof(SIMR_a_Usart));
+  memset(SIMR_a_Dma, 0, sizeof(SIMR_a_Dma));
+  memset(&SIMR_t_I2c, 0, sizeof(SIMR_t_I2c));
+  memset(&SIMR_t_Iwdg, 0, sizeof(SIMR_t_Iwdg));
+  memset(&SIMR_t_Flash, 0, sizeof(SIMR_t_Flash));
+  memset(&SIMR_t_Tim5, 0, sizeof(SIMR_t_Tim5));
+  memset(&SIMR_t_Cyccnt, 0, sizeof(SIMR_t_Cyccnt));
+  memset(SIMR_a_Contexts, 0, sizeof(SIMR_a_Contexts));
+  memset(SIMR_a_NvicEnabled, 0, sizeof(SIMR_a_NvicEnabled));
+  memset(SIMR_a_NvicPending, 0, sizeof(SIMR_a_NvicPending));
+  memset(SIMR_a_NvicPriority, 0, sizeof(SIMR_a_NvicPriority));
+
+  SIMR_a_Dma[SIMR_USART2] = (t_SIMR_DmaStream){.u_CrAddress = DMA1_S5CR, .u_NdtrAddress = DMA1_S5NDTR,
+                                               .u_M0arAddress = DMA1_S5M0AR, .u_IsrAddress = DMA1_HISR,
+                                               .u_IfcrAddress = DMA1_HIFCR, .i_Irq = DMA1_Stream5_IRQn};
+  SIMR_a_Dma[SIMR_USART3] = (t_SIMR_DmaStream){.u_CrAddress = DMA1_S1CR, .u_NdtrAddress = DMA1_S1NDTR,
+                                               .u_M0arAddress = DMA1_S1M0AR, .u_IsrAddress = DMA1_LISR,
+                                               .u_IfcrAddress = DMA1_LIFCR, .i_Irq = DMA1_Stream1_IRQn};
+  SIMR_a_Usart[SIMR_USART2] = (t_SIMR_Usart){.u_SrAddress = USART2_SR, .u_DrAddress = USART2_DR,
+                                              .u_BrrAddress = USART2_BRR, .u_Cr1Address = USART2_CR1,
+                                              .u_Cr3Address = USART2_CR3, .i_Irq = USART2_IRQn,
+                                              .p_Dma = &SIMR_a_Dma[SIMR_USART2], .u_Sr = USART_SR_TXE | USART_SR_TC};
+  SIMR_a_Usart[SIMR_USART3] = (t_SIMR_Usart){.u_SrAddress = USART3_SR, .u_DrAddress = USART3_DR,
+                                              .u_BrrAddress = USART3_BRR, .u_Cr1Address = USART3_CR1,
+                                              .u_Cr3Address = USART3_CR3, .i_Irq = USART3_IRQn,
+                                              .p_Dma = &SIMR_a_Dma[SIMR_USART3], .u_Sr = USART_SR_TXE | USART_SR_TC};
+  for(uint8_t u_Cnt = 0u; u_Cnt < (uint8_t)SIMR_USART_COUNT; u_Cnt++)
+  {
+    v_UsartPublish(&SIMR_a_Usart[u_Cnt]);
+    v_DmaPublish(&SIMR_a_Dma[u_Cnt]);
+  }
+  v_I2cPublish();
+  SIMR_t_Iwdg.u_RlrShadow = 0xFFFu;
+  SIMR_RAW(IWDG_RLR) = SIMR_t_Iwdg.u_RlrShadow;
+  SIMR_t_Flash.u_CrShadow = FLASH_CR_LOCK;
+  SIMR_RAW(FLASH_CR) = SIMR_t_Flash.u_CrShadow;
+}
+
+void SIMR_v_StartDispatcher(uint32_t u_Priority)
+{
+  SIMR_t_Dispatcher = xTaskCreateStatic(v_Dispatcher, "SIMR", SIMR_DISPATCH_STACK_DEPTH, NULL, (UBaseType_t)u_Priority,
+                                        SIMR_a_DispatcherStack, &SIMR_t_DispatcherBuffer);
+}
+
+volatile uint32_t * SIMR_p_Access(uint32_t u_Address)
+{
+  uint64_t u_Now = u_NowNs();
+  t_SIMR_Context *p_Context;
+
+  v_Lock();
+  p_Context = p_GetContext();
+  v_SettleRead(p_Context);
+  v_DetectWrites(u_Now);
+  if((u_Started() == 0u) && (SIMR_u_Ipsr == 0u) && (SIMR_b_Running == 0u))
+  {
+    // Nothing else can call the handlers before the scheduler starts, polling code drives the models
+    SIMR_v_Run();
+  }
+  if(u_Address == TIM5_CNT)
+  {
+    v_CounterPublish(&SIMR_t_Tim5, u_Address, u_Now);
+  }
+  else if(u_Address == DWT_CYCCNT)
+  {
+    v_CounterPublish(&SIMR_t_Cyccnt, u_Address, u_Now);
+  }
+  else if((p_Context != NULL) && ((u_Address == USART2_DR) || (u_Address == USART3_DR) ||
+                                  (u_Address == I2C1_DR) || (u_Address == I2C1_SR2)))
+  {
+    p_Context -> u_Address = u_Address;
+  }
+  v_Unlock();
+  return (volatile uint32_t *)(uintptr_t)u_Address;
+}
+
+void SIMR_v_Run(void)
+{
+  t_SIMR_Context *p_Context;
+  uint32_t u_Count = 0u;
+  uint8_t  u_Busy  = 1u;
+
+  if(SIMR_b_Running == 1u)
+  {
+    return;
+  }
+  v_Lock();
+  SIMR_b_Running = 1u;
+  p_Context = p_GetContext();
+  v_SettleRead(p_Context);
+  while((u_Busy == 1u) && (u_Count < SIMR_DISPATCH_LIMIT))
+  {
+    uint64_t u_Now = u_NowNs();
+
+    v_DetectWrites(u_Now);
+    u_Busy = 0u;
+    for(uint8_t u_Cnt = 0u; u_Cnt < (uint8_t)SIMR_USART_COUNT; u_Cnt++)
+    {
+      u_Busy |= u_UsartAdvance(&SIMR_a_Usart[u_Cnt], u_Now);
+    }
+    u_Busy |= u_I2cAdvance();
+    u_Busy |= u_IwdgAdvance(u_Now);
+    if(SIMR_u_Primask == 0u)
+    {
+      u_Busy |= u_Dispatch(p_Context);
+    }
+    u_Count++;
+  }
+  SIMR_b_Running = 0u;
+  v_Unlock();
+}
+
+void SIMR_v_SwitchedOut(void)
+{
+  t_SIMR_Context *p_Context;
+
+  if(SIMR_b_Mapped == 0u)
+  {
+    return;
+  }
+  p_Context = p_GetContext();
+  v_SettleRead(p_Context);
+}
+
+uint32_t SIMR_u_UsartInject(e_SIMR_Usart e_Port, const uint8_t *p_Data, uint32_t u_Length)
+{
+  t_SIMR_Usart *p_Usart = &SIMR_a_Usart[e_Port];
+  uint32_t u_Count = 0u;
+
+  v_Lock();
+  if(p_Usart -> u_RxTail == p_Usart -> u_RxHead)
+  {
+    // First byte of a burst arrives one frame from now
+    p_Usart -> u_RxDueNs = u_NowNs() + u_FrameNs(p_Usart);
+    p_Usart -> b_IdlePending = 0u;
+  }
+  while((u_Count < u_Length) && (((p_Usart -> u_RxHead + 1u) % SIMR_USART_BUFFER_LENGTH) != p_Usart -> u_RxTail))
+  {
+    p_Usart -> a_Rx[p_Usart -> u_RxHead] = p_Data[u_Count];
+    p_Usart -> u_RxHead = (p_Usart -> u_RxHead + 1u) % SIMR_USART_BUFFER_LENGTH;
+    u_Count++;
+  }
+  v_Unlock();
+  return u_Count;
+}
+
+uint32_t SIMR_u_UsartTake(e_SIMR_Usart e_Port, uint8_t *p_Data, uint32_t u_Size)
+{
+  t_SIMR_Usart *p_Usart = &SIMR_a_Usart[e_Port];
+  uint32_t u_Count = 0u;
+
+  v_Lock();
+  while((u_Count < u_Size) && (p_Usart -> u_TxTail != p_Usart -> u_TxHead))
+  {
+    p_Data[u_Count] = p_Usart -> a_Tx[p_Usart -> u_TxTail];
+    p_Usart -> u_TxTail = (p_Usart -> u_TxTail + 1u) % SIMR_USART_BUFFER_LENGTH;
+    u_Count++;
+  }
+  v_Unlock();
+  return u_Count;
+}
+
+uint32_t SIMR_u_UsartOverruns(e_SIMR_Usart e_Port)
+{
+  return SIMR_a_Usart[e_Port].u_Overruns;
+}
+
+void SIMR_v_DmaError(e_SIMR_Usart e_Port)
+{
+  t_SIMR_DmaStream *p_Dma = &SIMR_a_Dma[e_Port];
+
+  v_Lock();
+  if((p_Dma -> u_CrShadow & DMA_SxCR_EN) != 0u)
+  {
+    p_Dma -> u_Flags |= DMA_LISR_TEIF1;
+    p_Dma -> u_CrShadow &= ~(uint32_t)DMA_SxCR_EN;
+    v_DmaPublish(p_Dma);
+  }
+  v_Unlock();
+}
+
+void SIMR_v_I2cAttach(t_SIMR_I2cDevice *p_Device)
+{
+  v_Lock();
+  if(SIMR_t_I2c.u_DeviceCount < SIMR_I2C_DEVICE_COUNT)
+  {
+    SIMR_t_I2c.a_Devices[SIMR_t_I2c.u_DeviceCount] = p_Device;
+    SIMR_t_I2c.u_DeviceCount++;
+  }
+  v_Unlock();
+}
+
+void SIMR_v_ExtiTrigger(uint32_t u_Line)
+{
+  uint32_t u_Mask = 1u << u_Line;
+
+  v_Lock();
+  if(((SIMR_RAW(EXTI_FTSR) | SIMR_RAW(EXTI_RTSR)) & u_Mask) != 0u)
+  {
+    SIMR_RAW(EXTI_PR) |= u_Mask;
+  }
+  v_Unlock();
+}
+
+uint32_t SIMR_u_WatchdogResets(void)
+{
+  return SIMR_t_Iwdg.u_Resets;
+}
+
+uint32_t SIMR_u_GetPrimask(void)
+{
+  return SIMR_u_Primask;
+}
+
+void SIMR_v_SetPrimask(uint32_t u_Primask)
+{
+  if((u_Primask != 0u) && (SIMR_u_Primask == 0u))
+  {
+    SIMR_u_Primask = 1u;
+    // Masked interrupts must also keep the tick from switching tasks
+    if(u_Started() == 1u)
+    {
+      taskENTER_CRITICAL();
+      SIMR_b_PrimaskCritical = 1u;
+    }
+  }
+  else if((u_Primask == 0u) && (SIMR_u_Primask != 0u))
+  {
+    SIMR_u_Primask = 0u;
+    if(SIMR_b_PrimaskCritical == 1u)
+    {
+      SIMR_b_PrimaskCritical = 0u;
+      taskEXIT_CRITICAL();
+    }
+    else if((SIMR_u_Ipsr == 0u) && (SIMR_b_Running == 0u) && (SIMR_b_Mapped == 1u))
+    {
+      // Interrupts which became pending while masked are taken at once
+      SIMR_v_Run();
+    }
+  }
+}
+
+void SIMR_v_NvicEnable(int32_t i_Irq, uint32_t u_Enable)
+{
+  if((i_Irq >= 0) && (i_Irq < (int32_t)SIMR_IRQ_COUNT))
+  {
+    SIMR_a_NvicEnabled[i_Irq] = (u_Enable != 0u) ? 1u : 0u;
+  }
+}
+
+void SIMR_v_NvicSetPriority(int32_t i_Irq, uint32_t u_Priority)
+{
+  if((i_Irq >= 0) && (i_Irq < (int32_t)SIMR_IRQ_COUNT))
+  {
+    SIMR_a_NvicPriority[i_Irq] = (uint8_t)u_Priority;
+  }
+}
+
+uint32_t SIMR_u_NvicGetPriority(int32_t i_Irq)
+{
+  return ((i_Irq >= 0) && (i_Irq < (int32_t)SIMR_IRQ_COUNT)) ? SIMR_a_NvicPriority[i_Irq] : 0u;
+}
+
+void SIMR_v_NvicSetPending(int32_t i_Irq, uint32_t u_Pending)
+{
+  if((i_Irq >= 0) && (i_Irq < (int32_t)SIMR_IRQ_COUNT))
+  {
+    SIMR_a_NvicPending[i_Irq] = (u_Pending != 0u) ? 1u : 0u;
+  }
+}
+
+uint32_t SIMR_u_NvicGetPending(int32_t i_Irq)
+{
+  return (((i_Irq >= 0) && (i_Irq < (int32_t)SIMR_IRQ_COUNT)) ? u_Request(i_Irq) : 0u);
+}
+
+uint32_t SIMR_u_GetIpsr(void)
+{
+  return SIMR_u_Ipsr;
+}
@@ -0,0 +1,328 @@
+/// @file SIMR.h
+/// @brief Header file used for the simulated peripheral registers of the host build
+/// @author Aleksandra Petrovic
+///
+/// Registers.h redirects REG32 to SIMR_p_Access when HOST_BUILD is defined. The peripheral and core regions are
+/// mapped at their target addresses, so CMSIS structures (SYSCFG->EXTICR, GPIOB->ODR) and REG32 share the same
+/// register file. USART2, USART3, their DMA1 receive streams (5 and 1), I2C1, IWDG, TIM5 and the DWT cycle counter
+/// have behavioural models, every other register is plain memory.
+///
+/// A store to a modelled register is seen when the value differs from the one the model published, DR of a USART
+/// carries SIMR_DR_MARK in its upper half so every data byte is a change. A load with a side effect (USART DR,
+/// I2C1 DR, I2C1 SR2) is taken into account at the next register access of the same task or when the task is
+/// switched out. Interrupt handlers are called by a dispatcher task with the scheduler suspended, before the
+/// scheduler starts they are called from the register accesses of the polling code.
+
+#ifndef SIMR_H_
+#define SIMR_H_
+
+#include <stdint.h>
+
+/// Number of registers of a device on the simulated I2C bus
+#define SIMR_I2C_REGISTER_COUNT (256u)
+
+/// USARTs with a behavioural model
+typedef enum {
+  SIMR_USART2,      ///< NEO-6M
+  SIMR_USART3,      ///< SIM800L
+  SIMR_USART_COUNT  ///< Number of modelled USARTs
+} e_SIMR_Usart;
+
+/// Device on the simulated I2C1 bus, the first byte of a write selects the register and the pointer increments
+/// after every byte, like MCP23017 with IOCON.SEQOP = 0
+typedef struct {
+  uint8_t u_Address;                                  ///< 7-bit slave address
+  uint8_t u_Pointer;                                  ///< Register used by the next data byte
+  uint8_t b_PointerSet;                               ///< 1 when the register byte of the current write was received
+  uint8_t a_Registers[SIMR_I2C_REGISTER_COUNT];       ///< Register values
+  uint32_t u_Writes;                                  ///< Data bytes written to registers
+  uint32_t u_Reads;                                   ///< Data bytes read from registers
+} t_SIMR_I2cDevice;
+
+/// @brief Function used for mapping the register file and resetting the models
+///
+/// @pre Must be called before any module touches a register
+/// @post Peripheral and core regions are zero, models are in their reset state
+/// @param None
+///
+/// @return None
+///
+/// @globals SIMR_a_Usart, SIMR_a_Dma, SIMR_t_I2c, SIMR_t_Iwdg, SIMR_t_Flash
+///
+/// @InOutCorelation Function maps anonymous memory at the target addresses of the peripheral and core regions and
+///                  publishes the reset values of the modelled registers. The process exits when the addresses are
+///                  not free. Data sectors of flash are mapped erased the first time and keep their contents after.
+/// @callsequence
+///   @startuml "SIMR_v_Init.png"
+///     title "Sequence diagram for function SIMR_v_Init"
+///     -> SIMR: SIMR_v_Init()
+///     SIMR++
+///       rnote over SIMR: mmap peripheral, core and flash data regions at their target addresses.
+///       rnote over SIMR: Reset values of SR registers are published.
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+void SIMR_v_Init(void);
+
+/// @brief Function used for creating the interrupt dispatcher task
+///
+/// @pre SIMR_v_Init must be done, scheduler is not started
+/// @post Interrupt handlers are called every SIMR_DISPATCH_PERIOD_TICKS once the scheduler runs
+/// @param uint32_t u_Priority priority of the dispatcher, it should be above every application task
+///
+/// @return None
+///
+/// @globals SIMR_t_Dispatcher
+///
+/// @InOutCorelation Function creates a static task which advances the models and calls pending handlers with the
+///                  scheduler suspended, so a handler is never interrupted by a task, as on the target.
+/// @callsequence
+///   @startuml "SIMR_v_StartDispatcher.png"
+///     title "Sequence diagram for function SIMR_v_StartDispatcher"
+///     -> SIMR: SIMR_v_StartDispatcher(uint32_t u_Priority)
+///     SIMR++
+///       SIMR -> FreeRTOS: xTaskCreateStatic(v_Dispatcher, ...)
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+void SIMR_v_StartDispatcher(uint32_t u_Priority);
+
+/// @brief Function used for accessing a register, REG32 expands to a dereference of its result
+///
+/// @pre SIMR_v_Init must be done
+/// @post Earlier accesses of the caller have taken effect, the model value of the register is published
+/// @param uint32_t u_Address target address of the register
+///
+/// @return volatile uint32_t * host address of the register, equal to the target address
+///
+/// @globals SIMR_a_Contexts
+///
+/// @InOutCorelation Function takes the pending read of the calling context into account, detects stores to modelled
+///                  registers, refreshes counters and remembers the access when a load of it has a side effect.
+///                  Before the scheduler starts the models are also advanced and pending handlers are called.
+/// @callsequence
+///   @startuml "SIMR_p_Access.png"
+///     title "Sequence diagram for function SIMR_p_Access"
+///     -> SIMR: SIMR_p_Access(uint32_t u_Address)
+///     SIMR++
+///       SIMR -> SIMR: v_SettleRead(context)
+///       SIMR -> SIMR: v_DetectWrites()
+///       opt if scheduler is not started
+///         SIMR -> SIMR: v_Run()
+///       end
+///       rnote over SIMR: Counter registers are refreshed, side-effect loads are remembered.
+///     <- SIMR: Returns register address
+///     SIMR--
+///   @enduml
+
+volatile uint32_t * SIMR_p_Access(uint32_t u_Address);
+
+/// @brief Function used for advancing the models and calling pending interrupt handlers
+///
+/// @pre SIMR_v_Init must be done, must not be called from a simulated handler
+/// @post Events due until now have happened, no enabled interrupt is pending unless PRIMASK is set
+/// @param None
+///
+/// @return None
+///
+/// @globals SIMR_a_Usart, SIMR_a_Dma, SIMR_t_I2c, SIMR_t_Iwdg, SIMR_a_Nvic
+///
+/// @InOutCorelation Function alternates between advancing the models by one event and calling the handler of the
+///                  pending interrupt with the lowest priority number, so a handler sees one byte at a time.
+/// @callsequence
+///   @startuml "SIMR_v_Run.png"
+///     title "Sequence diagram for function SIMR_v_Run"
+///     -> SIMR: SIMR_v_Run()
+///     SIMR++
+///       loop until nothing is due and nothing is pending
+///         SIMR -> SIMR: v_Advance()
+///         SIMR -> SIMR: handler of the pending interrupt
+///       end
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+void SIMR_v_Run(void);
+
+/// @brief Function used for settling the pending read of the task which is switched out
+///
+/// @pre Called by traceTASK_SWITCHED_OUT
+/// @post Side effect of the last load of the task has taken place
+/// @param None
+///
+/// @return None
+///
+/// @globals SIMR_a_Contexts
+///
+/// @InOutCorelation Function lets a byte read by a task be removed from DR before another task or a handler runs.
+/// @callsequence
+///   @startuml "SIMR_v_SwitchedOut.png"
+///     title "Sequence diagram for function SIMR_v_SwitchedOut"
+///     -> SIMR: SIMR_v_SwitchedOut()
+///     SIMR++
+///       SIMR -> SIMR: v_SettleRead(current task)
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+void SIMR_v_SwitchedOut(void);
+
+/// @brief Function used for queueing bytes which arrive on the RX line of a USART
+///
+/// @pre SIMR_v_Init must be done
+/// @post Bytes are received one frame time apart at the baud rate set in BRR
+/// @param e_SIMR_Usart e_Port, const uint8_t *p_Data, uint32_t u_Length
+///
+/// @return uint32_t number of bytes queued, less than u_Length when the queue is full
+///
+/// @globals SIMR_a_Usart
+///
+/// @InOutCorelation Function appends the bytes to the RX queue of the port. A byte which arrives while RXNE is still
+///                  set is lost and ORE is set.
+/// @callsequence
+///   @startuml "SIMR_u_UsartInject.png"
+///     title "Sequence diagram for function SIMR_u_UsartInject"
+///     -> SIMR: SIMR_u_UsartInject(e_SIMR_Usart e_Port, const uint8_t *p_Data, uint32_t u_Length)
+///     SIMR++
+///     <- SIMR: Returns number of queued bytes
+///     SIMR--
+///   @enduml
+
+uint32_t SIMR_u_UsartInject(e_SIMR_Usart e_Port, const uint8_t *p_Data, uint32_t u_Length);
+
+/// @brief Function used for taking the bytes a USART has transmitted
+///
+/// @pre SIMR_v_Init must be done
+/// @post Returned bytes are removed from the capture
+/// @param e_SIMR_Usart e_Port, uint8_t *p_Data, uint32_t u_Size
+///
+/// @return uint32_t number of bytes copied
+///
+/// @globals SIMR_a_Usart
+///
+/// @InOutCorelation Function copies bytes which left the shift register, oldest first.
+/// @callsequence
+///   @startuml "SIMR_u_UsartTake.png"
+///     title "Sequence diagram for function SIMR_u_UsartTake"
+///     -> SIMR: SIMR_u_UsartTake(e_SIMR_Usart e_Port, uint8_t *p_Data, uint32_t u_Size)
+///     SIMR++
+///     <- SIMR: Returns number of bytes
+///     SIMR--
+///   @enduml
+
+uint32_t SIMR_u_UsartTake(e_SIMR_Usart e_Port, uint8_t *p_Data, uint32_t u_Size);
+
+/// @brief Function used for reading the number of received bytes lost to overrun
+///
+/// @pre SIMR_v_Init must be done
+/// @post None
+/// @param e_SIMR_Usart e_Port
+///
+/// @return uint32_t bytes lost because RXNE was still set
+///
+/// @globals SIMR_a_Usart
+///
+/// @InOutCorelation Function returns the overrun counter of the port.
+/// @callsequence
+///   @startuml "SIMR_u_UsartOverruns.png"
+///     title "Sequence diagram for function SIMR_u_UsartOverruns"
+///     -> SIMR: SIMR_u_UsartOverruns(e_SIMR_Usart e_Port)
+///     SIMR++
+///     <- SIMR: Returns counter
+///     SIMR--
+///   @enduml
+
+uint32_t SIMR_u_UsartOverruns(e_SIMR_Usart e_Port);
+
+/// @brief Function used for failing the receive DMA stream of a USART with a transfer error
+///
+/// @pre SIMR_v_Init must be done
+/// @post TEIF of the stream is set and EN is cleared, when the stream was enabled
+/// @param e_SIMR_Usart e_Port USART whose stream fails (USART2 on DMA1 Stream5, USART3 on DMA1 Stream1)
+///
+/// @return None
+///
+/// @globals SIMR_a_Dma
+///
+/// @InOutCorelation Function does what the hardware does after a bus error, the stream stops and a byte received
+///                  afterwards waits in DR until software enables the stream again.
+/// @callsequence
+///   @startuml "SIMR_v_DmaError.png"
+///     title "Sequence diagram for function SIMR_v_DmaError"
+///     -> SIMR: SIMR_v_DmaError(e_SIMR_Usart e_Port)
+///     SIMR++
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+void SIMR_v_DmaError(e_SIMR_Usart e_Port);
+
+/// @brief Function used for attaching a device to the simulated I2C1 bus
+///
+/// @pre SIMR_v_Init must be done
+/// @post Device acknowledges its address
+/// @param t_SIMR_I2cDevice *p_Device device which stays valid while the bus is used
+///
+/// @return None
+///
+/// @globals SIMR_t_I2c
+///
+/// @InOutCorelation Function adds the device to the bus, an address without a device is not acknowledged and AF is set.
+/// @callsequence
+///   @startuml "SIMR_v_I2cAttach.png"
+///     title "Sequence diagram for function SIMR_v_I2cAttach"
+///     -> SIMR: SIMR_v_I2cAttach(t_SIMR_I2cDevice *p_Device)
+///     SIMR++
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+void SIMR_v_I2cAttach(t_SIMR_I2cDevice *p_Device);
+
+/// @brief Function used for signalling an edge on an EXTI line
+///
+/// @pre SIMR_v_Init must be done
+/// @post Pending bit of the line is set when falling or rising trigger of the line is enabled
+/// @param uint32_t u_Line EXTI line 0 to 22
+///
+/// @return None
+///
+/// @globals None
+///
+/// @InOutCorelation Function sets the bit in EXTI->PR, the handler runs when the line is not masked in EXTI->IMR.
+/// @callsequence
+///   @startuml "SIMR_v_ExtiTrigger.png"
+///     title "Sequence diagram for function SIMR_v_ExtiTrigger"
+///     -> SIMR: SIMR_v_ExtiTrigger(uint32_t u_Line)
+///     SIMR++
+///     <- SIMR
+///     SIMR--
+///   @enduml
+
+void SIMR_v_ExtiTrigger(uint32_t u_Line);
+
+/// @brief Function used for reading the number of resets the watchdog would have caused
+///
+/// @pre SIMR_v_Init must be done
+/// @post None
+/// @param None
+///
+/// @return uint32_t number of times the IWDG counter reached zero
+///
+/// @globals SIMR_t_Iwdg
+///
+/// @InOutCorelation The host process is not reset, the counter is reloaded and the event is counted.
+/// @callsequence
+///   @startuml "SIMR_u_WatchdogResets.png"
+///     title "Sequence diagram for function SIMR_u_WatchdogResets"
+///     -> SIMR: SIMR_u_WatchdogResets()
+///     SIMR++
+///     <- SIMR: Returns counter
+///     SIMR--
+///   @enduml
+
+uint32_t SIMR_u_WatchdogResets(void);
+
+#endif /* SIMR_H_ */
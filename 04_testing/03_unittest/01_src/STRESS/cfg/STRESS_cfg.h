@@ -0,0 +1,23 @@
+/// @file STRESS_cfg.h
+/// @brief Contains configuration data used for the ring buffer stress test of the host build
+/// @author Aleksandra Petrovic
+
+#ifndef STRESS_CFG_H_
+#define STRESS_CFG_H_
+
+#include "RINGB.h"
+
+/// Default number of bytes sent from the producer to the consumer thread
+#define STRESS_DEFAULT_BYTES (100000000u)
+/// Default size of the ring buffer, small so it wraps and runs full all the time
+#define STRESS_DEFAULT_SIZE (64u)
+/// Largest size of the ring buffer
+#define STRESS_MAX_SIZE (1u << 16u)
+/// Largest block written or read at once, blocks are cut to what fits or what is stored
+#define STRESS_MAX_BLOCK (96u)
+/// Seed of the producer generator, the consumer generator is seeded differently so their patterns differ
+#define STRESS_SEED (0x6C078965u)
+/// Multiplier which spreads the stream position over the byte written at it (Knuth's golden ratio hash)
+#define STRESS_HASH (2654435761u)
+
+#endif /* STRESS_CFG_H_ */
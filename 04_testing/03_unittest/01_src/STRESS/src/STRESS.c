@@ -0,0 +1,385 @@
+/// @file STRESS.c
+/// @brief Main file used for the ring buffer stress test of the host build
+/// @author Aleksandra Petrovic
+
+#include "STRESS.h"
+#include "STRESS_cfg.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+/// State shared by the threads of one run
+typedef struct {
+  t_RINGB_Ring      t_Ring;         ///< Ring buffer under test
+  uint32_t          u_Bytes;        ///< Bytes sent through the ring buffer
+  volatile uint32_t b_Stop;         ///< Set by the consumer on the first mismatch, stops the producer
+  uint32_t          u_Received;     ///< Bytes the consumer checked
+  uint32_t          u_Mismatch;     ///< Stream position of the first wrong byte, u_Bytes when there was none
+  uint32_t          u_Got;          ///< Byte read at u_Mismatch
+  uint32_t          u_BadCount;     ///< Times RINGB_u_Count was above the size
+  uint64_t          u_Full;         ///< Writes which found the ring buffer full
+  uint64_t          u_Empty;        ///< Reads which found the ring buffer empty
+} t_STRESS_Run;
+
+/// @brief Function used for reading the host clock
+///
+/// @pre None
+/// @post None
+/// @param None
+///
+/// @return uint64_t monotonic time in ns
+///
+/// @globals None
+///
+/// @InOutCorelation Function reads CLOCK_MONOTONIC for the throughput of the run.
+/// @callsequence
+///   @startuml "u_NowNs.png"
+///     title "Sequence diagram for function u_NowNs"
+///     -> STRESS: u_NowNs()
+///     STRESS++
+///       STRESS -> Linux: clock_gettime(CLOCK_MONOTONIC)
+///     <- STRESS: Returns time
+///     STRESS--
+///   @enduml
+
+static uint64_t u_NowNs(void);
+
+static uint64_t u_NowNs(void)
+{
+  struct timespec t_Time;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &t_Time);
+  return ((uint64_t)t_Time.tv_sec * 1000000000ULL) + (uint64_t)t_Time.tv_nsec;
+}
+
+/// @brief Function used for drawing the next number of a thread generator
+///
+/// @pre None
+/// @post Generator state is advanced
+/// @param uint32_t *p_State generator of the calling thread, uint32_t u_Range number of possible results
+///
+/// @return uint32_t number from 0 to u_Range - 1
+///
+/// @globals None
+///
+/// @InOutCorelation Function steps a 32 bit xorshift generator, each thread has its own state.
+/// @callsequence
+///   @startuml "u_Random.png"
+///     title "Sequence diagram for function u_Random"
+///     -> STRESS: u_Random(uint32_t *p_State, uint32_t u_Range)
+///     STRESS++
+///     <- STRESS: Returns number
+///     STRESS--
+///   @enduml
+
+static uint32_t u_Random(uint32_t *p_State, uint32_t u_Range);
+
+static uint32_t u_Random(uint32_t *p_State, uint32_t u_Range)
+{
+  *p_State ^= *p_State << 13u;
+  *p_State ^= *p_State >> 17u;
+  *p_State ^= *p_State << 5u;
+  return *p_State % u_Range;
+}
+
+/// @brief Function used for the byte written at a stream position
+///
+/// @pre None
+/// @post None
+/// @param uint32_t u_Position
+///
+/// @return uint8_t byte of the stream
+///
+/// @globals None
+///
+/// @InOutCorelation Top byte of a multiplicative hash, neighbouring positions get unrelated bytes so a shifted
+///                  stream does not match for long.
+/// @callsequence
+///   @startuml "u_Expected.png"
+///     title "Sequence diagram for function u_Expected"
+///     -> STRESS: u_Expected(uint32_t u_Position)
+///     STRESS++
+///     <- STRESS: Returns byte
+///     STRESS--
+///   @enduml
+
+static uint8_t u_Expected(uint32_t u_Position);
+
+static uint8_t u_Expected(uint32_t u_Position)
+{
+  return (uint8_t)((u_Position * STRESS_HASH) >> 24u);
+}
+
+/// @brief Function used for checking bytes the consumer read
+///
+/// @pre Called by the consumer thread
+/// @post u_Received is advanced by u_Length, the first mismatch is recorded and stops the run
+/// @param t_STRESS_Run *p_Run, const uint8_t *p_Data, uint32_t u_Length
+///
+/// @return uint8_t 1 when all bytes were expected
+///
+/// @globals None
+///
+/// @InOutCorelation Function compares each byte with the byte of its stream position.
+/// @callsequence
+///   @startuml "u_Check.png"
+///     title "Sequence diagram for function u_Check"
+///     -> STRESS: u_Check(t_STRESS_Run *p_Run, const uint8_t *p_Data, uint32_t u_Length)
+///     STRESS++
+///       STRESS -> STRESS: u_Expected(...)
+///     <- STRESS: Returns uint8_t
+///     STRESS--
+///   @enduml
+
+static uint8_t u_Check(t_STRESS_Run *p_Run, const uint8_t *p_Data, uint32_t u_Length);
+
+static uint8_t u_Check(t_STRESS_Run *p_Run, const uint8_t *p_Data, uint32_t u_Length)
+{
+  for(uint32_t u_Cnt = 0u; u_Cnt < u_Length; u_Cnt++)
+  {
+    if(p_Data[u_Cnt] != u_Expected(p_Run -> u_Received))
+    {
+      p_Run -> u_Mismatch = p_Run -> u_Received;
+      p_Run -> u_Got = p_Data[u_Cnt];
+      p_Run -> b_Stop = 1u;
+      return 0u;
+    }
+    p_Run -> u_Received++;
+  }
+  return 1u;
+}
+
+/// @brief Function used for the producer thread
+///
+/// @pre Ring buffer is initialized and empty
+/// @post Whole stream was written or the consumer stopped the run
+/// @param void *p_Argument t_STRESS_Run of the run
+///
+/// @return void * NULL
+///
+/// @globals None
+///
+/// @InOutCorelation Producer writes single bytes or blocks of random length, a block which does not fit is written
+///                  partly. When nothing fits the thread yields, so the test also runs on a single core.
+/// @callsequence
+///   @startuml "p_Producer.png"
+///     title "Sequence diagram for function p_Producer"
+///     -> STRESS: p_Producer(void *p_Argument)
+///     STRESS++
+///       loop until the stream is written
+///         alt single byte
+///           STRESS -> RINGB: RINGB_u_Push(...)
+///         else block
+///           STRESS -> RINGB: RINGB_u_PushN(...)
+///         end
+///       end
+///     <- STRESS: Returns NULL
+///     STRESS--
+///   @enduml
+
+static void * p_Producer(void *p_Argument);
+
+static void * p_Producer(void *p_Argument)
+{
+  t_STRESS_Run *p_Run = (t_STRESS_Run *)p_Argument;
+  uint8_t a_Block[STRESS_MAX_BLOCK];
+  uint32_t u_State = STRESS_SEED;
+  uint32_t u_Sent = 0u;
+
+  while((u_Sent < p_Run -> u_Bytes) && (p_Run -> b_Stop == 0u))
+  {
+    uint32_t u_Stored;
+
+    if(u_Random(&u_State, 2u) == 0u)
+    {
+      u_Stored = RINGB_u_Push(&p_Run -> t_Ring, u_Expected(u_Sent));
+    }
+    else
+    {
+      uint32_t u_Length = 1u + u_Random(&u_State, STRESS_MAX_BLOCK);
+
+      if(u_Length > (p_Run -> u_Bytes - u_Sent))
+      {
+        u_Length = p_Run -> u_Bytes - u_Sent;
+      }
+      for(uint32_t u_Cnt = 0u; u_Cnt < u_Length; u_Cnt++)
+      {
+        a_Block[u_Cnt] = u_Expected(u_Sent + u_Cnt);
+      }
+      u_Stored = RINGB_u_PushN(&p_Run -> t_Ring, a_Block, u_Length);
+    }
+    u_Sent += u_Stored;
+    if(u_Stored == 0u)
+    {
+      p_Run -> u_Full++;
+      (void)sched_yield();
+    }
+  }
+  return NULL;
+}
+
+/// @brief Function used for the consumer thread
+///
+/// @pre Ring buffer is initialized
+/// @post Whole stream was checked or the first mismatch is recorded
+/// @param void *p_Argument t_STRESS_Run of the run
+///
+/// @return void * NULL
+///
+/// @globals None
+///
+/// @InOutCorelation Consumer reads in one of four ways picked at random. RINGB_u_PeekAt checks a byte in the middle
+///                  of what is stored before the oldest byte is popped. RINGB_u_Count is never above the size.
+/// @callsequence
+///   @startuml "p_Consumer.png"
+///     title "Sequence diagram for function p_Consumer"
+///     -> STRESS: p_Consumer(void *p_Argument)
+///     STRESS++
+///       loop until the stream is checked or a byte is wrong
+///         alt single byte
+///           STRESS -> RINGB: RINGB_u_Pop(...)
+///         else block
+///           STRESS -> RINGB: RINGB_u_PopN(...)
+///         else block in place
+///           STRESS -> RINGB: RINGB_u_Peek(...), RINGB_u_Skip(...)
+///         else byte at an offset
+///           STRESS -> RINGB: RINGB_u_Count(...), RINGB_u_PeekAt(...), RINGB_u_Pop(...)
+///         end
+///         STRESS -> STRESS: u_Check(...)
+///       end
+///     <- STRESS: Returns NULL
+///     STRESS--
+///   @enduml
+
+static void * p_Consumer(void *p_Argument);
+
+static void * p_Consumer(void *p_Argument)
+{
+  t_STRESS_Run *p_Run = (t_STRESS_Run *)p_Argument;
+  uint8_t a_Block[STRESS_MAX_BLOCK];
+  uint32_t u_State = ~STRESS_SEED;
+
+  while((p_Run -> u_Received < p_Run -> u_Bytes) && (p_Run -> b_Stop == 0u))
+  {
+    uint32_t u_Length = 1u + u_Random(&u_State, STRESS_MAX_BLOCK);
+    uint32_t u_Count = 0u;
+    uint8_t u_Passed = 1u;
+
+    switch(u_Random(&u_State, 4u))
+    {
+    case 0u:
+      u_Count = RINGB_u_Pop(&p_Run -> t_Ring, a_Block);
+      u_Passed = u_Check(p_Run, a_Block, u_Count);
+      break;
+    case 1u:
+      u_Count = RINGB_u_PopN(&p_Run -> t_Ring, a_Block, u_Length);
+      u_Passed = u_Check(p_Run, a_Block, u_Count);
+      break;
+    case 2u:
+      u_Count = RINGB_u_Peek(&p_Run -> t_Ring, a_Block, u_Length);
+      u_Passed = u_Check(p_Run, a_Block, u_Count);
+      if((u_Passed == 1u) && (RINGB_u_Skip(&p_Run -> t_Ring, u_Count) != u_Count))
+      {
+        p_Run -> u_BadCount++;
+      }
+      break;
+    default:
+      u_Count = RINGB_u_Count(&p_Run -> t_Ring);
+      if(u_Count > (p_Run -> t_Ring.u_Mask + 1u))
+      {
+        p_Run -> u_BadCount++;
+      }
+      else if(u_Count != 0u)
+      {
+        uint32_t u_Offset = u_Random(&u_State, u_Count);
+
+        a_Block[0] = RINGB_u_PeekAt(&p_Run -> t_Ring, u_Offset);
+        if(a_Block[0] != u_Expected(p_Run -> u_Received + u_Offset))
+        {
+          p_Run -> u_Mismatch = p_Run -> u_Received + u_Offset;
+          p_Run -> u_Got = a_Block[0];
+          p_Run -> b_Stop = 1u;
+        }
+        else
+        {
+          u_Count = RINGB_u_Pop(&p_Run -> t_Ring, a_Block);
+          u_Passed = u_Check(p_Run, a_Block, u_Count);
+        }
+      }
+      break;
+    }
+    if((u_Passed == 1u) && (u_Count == 0u))
+    {
+      p_Run -> u_Empty++;
+      (void)sched_yield();
+    }
+  }
+  return NULL;
+}
+
+int STRESS_i_Run(int i_Argc, char **p_Argv)
+{
+  static t_STRESS_Run t_Run;
+  uint32_t u_Size = STRESS_DEFAULT_SIZE;
+  uint8_t *p_Storage = NULL;
+  pthread_t t_Producer;
+  pthread_t t_Consumer;
+  uint64_t u_StartNs = 0u;
+  uint64_t u_ElapsedNs = 0u;
+  uint8_t u_Passed = 0u;
+  int i_Option = 0;
+
+  t_Run.u_Bytes = STRESS_DEFAULT_BYTES;
+  optind = 1;
+  while((i_Option = getopt(i_Argc, p_Argv, "n:s:")) != -1)
+  {
+    switch(i_Option)
+    {
+    case 'n':
+      t_Run.u_Bytes = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 's':
+      u_Size = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    default:
+      fprintf(stderr, "usage: stress [-n bytes] [-s ring size]\n");
+      return 1;
+    }
+  }
+  if((RINGB_IS_POWER_OF_TWO(u_Size) == 0) || (u_Size > STRESS_MAX_SIZE) ||
+     ((p_Storage = malloc(u_Size)) == NULL))
+  {
+    fprintf(stderr, "stress: -s must be a power of two up to %u\n", (unsigned int)STRESS_MAX_SIZE);
+    return 1;
+  }
+
+  RINGB_v_Init(&t_Run.t_Ring, p_Storage, u_Size);
+  t_Run.u_Mismatch = t_Run.u_Bytes;
+  u_StartNs = u_NowNs();
+  if((pthread_create(&t_Producer, NULL, p_Producer, &t_Run) != 0) ||
+     (pthread_create(&t_Consumer, NULL, p_Consumer, &t_Run) != 0))
+  {
+    fprintf(stderr, "stress: cannot start the threads\n");
+    exit(EXIT_FAILURE);
+  }
+  (void)pthread_join(t_Producer, NULL);
+  (void)pthread_join(t_Consumer, NULL);
+  u_ElapsedNs = u_NowNs() - u_StartNs;
+  free(p_Storage);
+
+  u_Passed = ((t_Run.b_Stop == 0u) && (t_Run.u_Received == t_Run.u_Bytes) && (t_Run.u_BadCount == 0u) &&
+              (t_Run.t_Ring.u_Head == t_Run.t_Ring.u_Tail)) ? 1u : 0u;
+  printf("%s RINGB %u bytes through %u slots: %u received in order, %u count errors, %llu full, %llu empty, %.1f MB/s\n",
+         (u_Passed == 1u) ? "PASS" : "FAIL", (unsigned int)t_Run.u_Bytes, (unsigned int)u_Size,
+         (unsigned int)t_Run.u_Received, (unsigned int)t_Run.u_BadCount, (unsigned long long)t_Run.u_Full,
+         (unsigned long long)t_Run.u_Empty, (u_ElapsedNs != 0u) ? ((double)t_Run.u_Bytes * 1000.0) / (double)u_ElapsedNs : 0.0);
+  if(t_Run.b_Stop != 0u)
+  {
+    printf("first wrong byte at %u: 0x%02X instead of 0x%02X\n", (unsigned int)t_Run.u_Mismatch,
+           (unsigned int)t_Run.u_Got, (unsigned int)u_Expected(t_Run.u_Mismatch));
+  }
+  return (u_Passed == 1u) ? 0 : 1;
+}
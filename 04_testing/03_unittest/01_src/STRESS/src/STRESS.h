@@ -0,0 +1,41 @@
+/// @file STRESS.h
+/// @brief Header file used for the ring buffer stress test of the host build
+/// @author Aleksandra Petrovic
+///
+/// A producer and a consumer pthread share one RINGB ring buffer, as the receive interrupt and TSK_Com do on the
+/// target. The producer writes the stream with RINGB_u_Push and RINGB_u_PushN, the consumer reads it with
+/// RINGB_u_Pop, RINGB_u_PopN, RINGB_u_Peek with RINGB_u_Skip and RINGB_u_PeekAt, each time picked at random with
+/// random block lengths. The byte at every stream position is a hash of the position, so a lost, repeated or
+/// reordered byte shows as a mismatch at the position where it happened.
+
+#ifndef STRESS_H_
+#define STRESS_H_
+
+/// @brief Function used for running the stress test from the command line of the host binary
+///
+/// @pre Scheduler is not started
+/// @post Result is printed
+/// @param int i_Argc, char **p_Argv options after "stress":
+///        -n bytes sent through the ring buffer, -s size of the ring buffer (power of two)
+///
+/// @return int 0 when every byte arrived once and in order, 1 otherwise or for wrong options
+///
+/// @globals None
+///
+/// @InOutCorelation Function starts the producer and the consumer thread, waits for both and reports the first
+///                  mismatch, the number of times the ring was found full or empty and the throughput.
+/// @callsequence
+///   @startuml "STRESS_i_Run.png"
+///     title "Sequence diagram for function STRESS_i_Run"
+///     -> STRESS: STRESS_i_Run(int i_Argc, char **p_Argv)
+///     STRESS++
+///       STRESS -> RINGB: RINGB_v_Init(...)
+///       STRESS -> Linux: pthread_create(p_Producer), pthread_create(p_Consumer)
+///       STRESS -> Linux: pthread_join(), pthread_join()
+///     <- STRESS: Returns status
+///     STRESS--
+///   @enduml
+
+int STRESS_i_Run(int i_Argc, char **p_Argv);
+
+#endif /* STRESS_H_ */